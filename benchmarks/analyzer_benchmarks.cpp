@@ -0,0 +1,175 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "benchmark_common.hpp"
+#include "../src/analyzer/dump_analyzer.hpp"
+
+using namespace mcp;
+
+namespace {
+
+constexpr size_t kMinDumpSize = 1024 * 1024;
+constexpr size_t kPageSize = 4096;
+
+/**
+ * @brief Deterministic dump with the mix of content the analyzer looks for
+ *
+ * Each page is code-like filler, ASCII or UTF-16 strings, random (packed)
+ * bytes, or filler carrying a NOP sled and embedded URLs; the same seed
+ * gives the same bytes on every run, so results stay comparable.
+ */
+MemoryDump MakeSyntheticDump(size_t size) {
+    MemoryDump dump;
+    dump.base_address = 0x140000000;
+    dump.module_name = "synthetic.bin";
+    dump.data.resize(size);
+    dump.size = size;
+
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+    auto next = [&state]() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+    static const char* const kWords[] = {"kernel32.dll", "CreateRemoteThread", "VirtualAllocEx",
+                                         "http://update.example.com/payload", "cmd.exe /c",
+                                         "SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Run"};
+
+    for (size_t page = 0; page < size; page += kPageSize) {
+        uint8_t* out = dump.data.data() + page;
+        const size_t length = std::min(kPageSize, size - page);
+        const uint64_t kind = next() % 8;
+        if (kind == 0) {
+            for (size_t i = 0; i < length; i += 8) {
+                const uint64_t word = next();
+                std::memcpy(out + i, &word, std::min<size_t>(8, length - i));
+            }
+            continue;
+        }
+
+        // Skewed towards a few opcodes, like real code
+        for (size_t i = 0; i < length; ++i) {
+            const uint64_t r = next();
+            out[i] = static_cast<uint8_t>((r & 3) == 0 ? r >> 8 : 0x48 + ((r >> 8) & 7));
+        }
+        if (kind <= 2) {
+            // Strings, ASCII or UTF-16LE
+            const bool wide = kind == 2;
+            for (size_t i = 0; i + 128 < length; i += 160) {
+                const char* word = kWords[next() % (sizeof(kWords) / sizeof(kWords[0]))];
+                const size_t count = std::strlen(word);
+                for (size_t c = 0; c < count; ++c) {
+                    if (wide) {
+                        out[i + c * 2] = static_cast<uint8_t>(word[c]);
+                        out[i + c * 2 + 1] = 0;
+                    } else {
+                        out[i + c] = static_cast<uint8_t>(word[c]);
+                    }
+                }
+            }
+        } else if (kind == 3) {
+            std::memset(out + 256, 0x90, 64);
+            std::memcpy(out + 512, kWords[3], std::strlen(kWords[3]));
+        }
+    }
+    return dump;
+}
+
+// Built once at the largest registered size; smaller runs take a prefix of it
+std::unique_ptr<MemoryDump> g_dump;
+std::once_flag g_dump_once;
+size_t g_dump_size = kMinDumpSize;
+
+MemoryView DumpOfSize(size_t size) {
+    std::call_once(g_dump_once, []() { g_dump = std::make_unique<MemoryDump>(MakeSyntheticDump(g_dump_size)); });
+    return MemoryView::Of(*g_dump).Subview(0, size);
+}
+
+std::vector<uint8_t> Bytes(const std::string& text) {
+    return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+// The built-in patterns are too short to pass their confidence threshold, so
+// a few that the synthetic dump contains keep the matcher busy
+std::unique_ptr<DumpAnalyzer> MakeAnalyzer() {
+    auto analyzer = std::make_unique<DumpAnalyzer>(nullptr);
+    analyzer->AddCustomPattern("malware_remote_thread_import", Bytes("CreateRemoteThread"), "Injection import");
+    analyzer->AddCustomPattern("malware_alloc_import", Bytes("VirtualAllocEx"), "Injection import");
+    analyzer->AddCustomPattern("payload_url", Bytes("http://update.example.com"), "Download URL");
+    auto masked = ByteSignature::Parse("48 8B ?? 24 [2-6] 48 89 4C 24 08 E8");
+    if (masked.IsSuccess()) {
+        analyzer->AddCustomPattern("malware_masked_prologue", masked.Value(), "Masked signature with a jump");
+    }
+    return analyzer;
+}
+
+DumpAnalyzer& Analyzer() {
+    static std::unique_ptr<DumpAnalyzer> analyzer = MakeAnalyzer();
+    return *analyzer;
+}
+
+template<typename Fn>
+void RunOverDump(benchmark::State& state, Fn&& analyze) {
+    const MemoryView view = DumpOfSize(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto result = analyze(view);
+        if (!result.IsSuccess()) {
+            state.SkipWithError(result.Error().c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * view.size));
+}
+
+void BM_FindMalwareSignatures(benchmark::State& state) {
+    RunOverDump(state, [](const MemoryView& view) { return Analyzer().FindMalwareSignatures(view); });
+}
+
+void BM_AnalyzePatterns(benchmark::State& state) {
+    RunOverDump(state, [](const MemoryView& view) { return Analyzer().AnalyzePatterns(view); });
+}
+
+void BM_ExtractStrings(benchmark::State& state) {
+    RunOverDump(state, [](const MemoryView& view) { return Analyzer().ExtractStrings(view, true); });
+}
+
+void BM_PerformFullAnalysis(benchmark::State& state) {
+    RunOverDump(state, [](const MemoryView& view) { return Analyzer().PerformFullAnalysis(view); });
+}
+
+} // anonymous namespace
+
+namespace mcp {
+namespace bench {
+
+void RegisterDumpBenchmarks(size_t max_dump_size) {
+    g_dump_size = std::max(max_dump_size, kMinDumpSize);
+    const struct {
+        const char* name;
+        void (*fn)(benchmark::State&);
+    } kBenchmarks[] = {
+        {"BM_FindMalwareSignatures", BM_FindMalwareSignatures},
+        {"BM_AnalyzePatterns", BM_AnalyzePatterns},
+        {"BM_ExtractStrings", BM_ExtractStrings},
+        {"BM_PerformFullAnalysis", BM_PerformFullAnalysis},
+    };
+    for (const auto& entry : kBenchmarks) {
+        auto* registered = benchmark::RegisterBenchmark(entry.name, entry.fn);
+        size_t size = kMinDumpSize;
+        for (; size < g_dump_size; size *= 16) {
+            registered->Arg(static_cast<int64_t>(size));
+        }
+        registered->Arg(static_cast<int64_t>(g_dump_size));
+        registered->Unit(benchmark::kMillisecond)->UseRealTime();
+    }
+}
+
+} // namespace bench
+} // namespace mcp
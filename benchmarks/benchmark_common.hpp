@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+namespace mcp {
+namespace bench {
+
+// Default upper bound for the synthetic dump sizes; --dump_max_mb raises it to 1 GB
+constexpr size_t kDefaultMaxDumpMb = 256;
+
+/**
+ * @brief Register the analyzer benchmarks for dumps of 1 MB up to max_dump_size bytes
+ *
+ * Sizes grow by 16x and end at max_dump_size; registered at run time so a
+ * default run stays short.
+ */
+void RegisterDumpBenchmarks(size_t max_dump_size);
+
+} // namespace bench
+} // namespace mcp
@@ -0,0 +1,34 @@
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "benchmark_common.hpp"
+
+// Same as BENCHMARK_MAIN(), plus --dump_max_mb=N for the analyzer sizes
+int main(int argc, char** argv) {
+    size_t max_dump_mb = mcp::bench::kDefaultMaxDumpMb;
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        constexpr const char* kFlag = "--dump_max_mb=";
+        if (std::strncmp(argv[i], kFlag, std::strlen(kFlag)) == 0) {
+            max_dump_mb = std::strtoull(argv[i] + std::strlen(kFlag), nullptr, 10);
+            if (max_dump_mb == 0) {
+                std::cerr << "--dump_max_mb must be at least 1" << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        argv[kept++] = argv[i];
+    }
+    argc = kept;
+
+    mcp::bench::RegisterDumpBenchmarks(max_dump_mb * 1024 * 1024);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mcp/hex_codec.hpp"
+#include "../src/x64dbg/bridge_transport.hpp"
+#include "../src/x64dbg/compact_event.hpp"
+#include "../src/x64dbg/x64dbg_bridge.hpp"
+
+using namespace mcp;
+
+namespace {
+
+// Stands in for the debugger: accepts every frame and never replies, so only the event path does work
+class NullTransport : public IBridgeTransport {
+public:
+    Result<void> Send(const uint8_t*, size_t) override { return Result<void>::Success(); }
+
+    Result<size_t> Receive(uint8_t*, size_t) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        closed_cv_.wait(lock, [this] { return closed_; });
+        return Result<size_t>::Success(0);
+    }
+
+    void Close() override {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        closed_cv_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable closed_cv_;
+    bool closed_ = false;
+};
+
+struct EventBench {
+    std::unique_ptr<X64DbgBridge> bridge;
+    std::atomic<uint64_t> handled{0};
+    CompactDebugEvent event;
+};
+
+// Connected bridge with a live dispatch thread; legacy also registers a DebugEvent handler
+std::unique_ptr<EventBench> MakeEventBench(bool legacy) {
+    auto bench = std::make_unique<EventBench>();
+    bench->bridge = std::make_unique<X64DbgBridge>(nullptr);
+    bench->bridge->SetConnectionMode(X64DbgBridge::ConnectionMode::TCP);
+    bench->bridge->SetTransport(std::make_unique<NullTransport>());
+    bench->bridge->SetEventQueueOptions(4096, X64DbgBridge::EventOverflowPolicy::BLOCK);
+
+    EventBench* raw = bench.get();
+    if (legacy) {
+        bench->bridge->RegisterEventHandler([raw](const DebugEvent&) { raw->handled.fetch_add(1, std::memory_order_relaxed); });
+    } else {
+        bench->bridge->RegisterCompactEventHandler(
+            [raw](const CompactDebugEvent&) { raw->handled.fetch_add(1, std::memory_order_relaxed); });
+    }
+    bench->bridge->Connect();
+
+    EventStringTable& strings = bench->bridge->GetEventStrings();
+    bench->event.type = DebugEvent::Type::BREAKPOINT_HIT;
+    bench->event.process_id = 4242;
+    bench->event.module_id = strings.Intern("target.exe");
+    bench->event.description_id = strings.Intern("Breakpoint hit");
+    bench->event.AddMetadata(strings.Intern("hit_count"), 1);
+    return bench;
+}
+
+EventBench& SharedEventBench(bool legacy) {
+    static std::unique_ptr<EventBench> compact = MakeEventBench(false);
+    static std::unique_ptr<EventBench> with_legacy = MakeEventBench(true);
+    return legacy ? *with_legacy : *compact;
+}
+
+bool WaitForDispatched(const X64DbgBridge& bridge, uint64_t count) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (bridge.GetEventQueueStats().dispatched < count) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+// Post and dispatch in batches of range(0); timed until the handler saw every event
+void RunEventDispatch(benchmark::State& state, bool legacy) {
+    EventBench& bench = SharedEventBench(legacy);
+    const auto batch = static_cast<uint64_t>(state.range(0));
+    CompactDebugEvent event = bench.event;
+    event.thread_id = static_cast<uint32_t>(state.thread_index());
+
+    for (auto _ : state) {
+        const uint64_t target = bench.bridge->GetEventQueueStats().posted + batch;
+        for (uint64_t i = 0; i < batch; ++i) {
+            event.address = 0x401000 + i;
+            event.timestamp_ns = CompactDebugEvent::Now();
+            bench.bridge->PostEvent(event);
+        }
+        if (!WaitForDispatched(*bench.bridge, target)) {
+            state.SkipWithError("Event dispatch stalled");
+            break;
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batch));
+}
+
+void BM_BridgeDispatchCompact(benchmark::State& state) {
+    RunEventDispatch(state, false);
+}
+BENCHMARK(BM_BridgeDispatchCompact)->Arg(1)->Arg(64)->Arg(1024)->Threads(1)->Threads(4)->UseRealTime();
+
+// Same events, but a DebugEvent is rebuilt for the legacy handler
+void BM_BridgeDispatchLegacy(benchmark::State& state) {
+    RunEventDispatch(state, true);
+}
+BENCHMARK(BM_BridgeDispatchLegacy)->Arg(1)->Arg(64)->Arg(1024)->Threads(1)->Threads(4)->UseRealTime();
+
+std::vector<uint8_t> MakeBytes(size_t size) {
+    std::vector<uint8_t> bytes(size);
+    for (size_t i = 0; i < size; ++i) {
+        bytes[i] = static_cast<uint8_t>(i * 131 + (i >> 8));
+    }
+    return bytes;
+}
+
+// Decoding a memory reply, which is what ParseHexData does for every read
+void BM_HexDecode(benchmark::State& state) {
+    const auto bytes = MakeBytes(static_cast<size_t>(state.range(0)));
+    HexFormat format;
+    format.separator = state.range(1) ? ' ' : '\0';
+    const std::string text = HexEncode(bytes, format);
+    std::vector<uint8_t> out(HexDecodedCapacity(text.size()));
+    for (auto _ : state) {
+        auto decoded = HexDecode(text, out.data(), out.size());
+        benchmark::DoNotOptimize(decoded);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes.size()));
+}
+BENCHMARK(BM_HexDecode)->ArgsProduct({{64, 4096, 64 * 1024, 1024 * 1024}, {0, 1}})->ArgNames({"bytes", "spaced"});
+
+void BM_HexEncode(benchmark::State& state) {
+    const auto bytes = MakeBytes(static_cast<size_t>(state.range(0)));
+    std::string text(HexEncodedSize(bytes.size()), '\0');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(HexEncode(bytes.data(), bytes.size(), &text[0]));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes.size()));
+}
+BENCHMARK(BM_HexEncode)->Arg(64)->Arg(4096)->Arg(64 * 1024)->Arg(1024 * 1024);
+
+} // anonymous namespace
@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "../src/logger/logger.hpp"
+
+using namespace mcp;
+
+namespace {
+
+// One logger per overflow policy, shared by every thread of a run
+Logger& SharedLogger(const std::string& policy) {
+    static std::mutex mutex;
+    static std::map<std::string, std::unique_ptr<Logger>> loggers;
+    const std::lock_guard<std::mutex> lock(mutex);
+    auto& logger = loggers[policy];
+    if (!logger) {
+        LogConfig config;
+        config.output_path =
+            (std::filesystem::temp_directory_path() / ("mcp_bench_logger_" + policy + ".log")).string();
+        config.console_output = false;
+        config.max_file_size_mb = 64;
+        config.max_files = 1;
+        config.overflow_policy = policy;
+        std::filesystem::remove(config.output_path);
+        logger = std::make_unique<Logger>(config);
+    }
+    return *logger;
+}
+
+void RunLogContention(benchmark::State& state, const std::string& policy) {
+    Logger& logger = SharedLogger(policy);
+    const auto before = logger.GetQueueStats();
+    const std::string message = "Breakpoint hit at 0x401000 on thread " + std::to_string(state.thread_index());
+    for (auto _ : state) {
+        logger.Log(ILogger::LOG_INFO, message);
+    }
+    logger.Flush();
+
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        // Covers every thread of the run, since they share the logger
+        const auto after = logger.GetQueueStats();
+        state.counters["dropped"] = static_cast<double>(after.dropped - before.dropped);
+        state.counters["blocked"] = static_cast<double>(after.blocked - before.blocked);
+    }
+}
+
+// Producers never wait; the cost of a full queue shows up as drops
+void BM_LoggerLogDropNewest(benchmark::State& state) {
+    RunLogContention(state, "drop_newest");
+}
+BENCHMARK(BM_LoggerLogDropNewest)->ThreadRange(1, 8)->UseRealTime();
+
+// Producers wait for the log thread, so this tracks the write-out rate
+void BM_LoggerLogBlock(benchmark::State& state) {
+    RunLogContention(state, "block");
+}
+BENCHMARK(BM_LoggerLogBlock)->ThreadRange(1, 8)->UseRealTime();
+
+} // anonymous namespace
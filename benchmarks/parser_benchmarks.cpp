@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include "../src/parser/sexpr_parser.hpp"
+
+using namespace mcp;
+
+namespace {
+
+// A breakpoint condition of the kind evaluated on every hit
+const std::string kCondition = "(if (= (+ rax 8) (* rbx 2)) (list rip \"hit\" 1) (list rip \"miss\" 0))";
+
+// (list (+ 0 1) "item-0" sym-0 (+ 1 1) ...) with count elements of each kind
+std::string MakeListExpression(size_t count) {
+    std::string expr = "(list";
+    for (size_t i = 0; i < count; ++i) {
+        const std::string n = std::to_string(i);
+        expr += " (+ " + n + " 1) \"item-" + n + "\" sym-" + n;
+    }
+    expr += ")";
+    return expr;
+}
+
+void RegisterRegisters(SExprParser& parser) {
+    SExpression value;
+    value.value = int64_t{0x10};
+    parser.RegisterVariable("rax", value);
+    value.value = int64_t{0xc};
+    parser.RegisterVariable("rbx", value);
+    value.value = int64_t{0x401000};
+    parser.RegisterVariable("rip", value);
+}
+
+void BM_SExprParse(benchmark::State& state) {
+    SExprParser parser;
+    const std::string expr = MakeListExpression(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto parsed = parser.Parse(expr);
+        benchmark::DoNotOptimize(parsed);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * expr.size()));
+}
+BENCHMARK(BM_SExprParse)->RangeMultiplier(8)->Range(8, 2048);
+
+void BM_SExprParseDocument(benchmark::State& state) {
+    SExprParser parser;
+    const std::string expr = MakeListExpression(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto document = parser.ParseDocument(expr);
+        benchmark::DoNotOptimize(document);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * expr.size()));
+}
+BENCHMARK(BM_SExprParseDocument)->RangeMultiplier(8)->Range(8, 2048);
+
+void BM_SExprEvaluate(benchmark::State& state) {
+    SExprParser parser;
+    RegisterRegisters(parser);
+    auto parsed = parser.Parse(kCondition);
+    if (!parsed.IsSuccess()) {
+        state.SkipWithError(parsed.Error().c_str());
+        return;
+    }
+    for (auto _ : state) {
+        auto value = parser.Evaluate(parsed.Value());
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(BM_SExprEvaluate);
+
+void BM_SExprEvaluateCompiled(benchmark::State& state) {
+    SExprParser parser;
+    RegisterRegisters(parser);
+    for (auto _ : state) {
+        auto value = parser.EvaluateCompiled(kCondition);
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(BM_SExprEvaluateCompiled);
+
+// Parse and evaluate from source each time, as a one-off REPL line would
+void BM_SExprParseAndEvaluate(benchmark::State& state) {
+    SExprParser parser;
+    RegisterRegisters(parser);
+    for (auto _ : state) {
+        auto parsed = parser.Parse(kCondition);
+        auto value = parser.Evaluate(parsed.Value());
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(BM_SExprParseAndEvaluate);
+
+} // anonymous namespace
@@ -24,6 +24,24 @@ public:
     /// @return A std::future containing a Result<LLMResponse>. The result will
     ///         contain either the successful response or an error.
     virtual std::future<Result<LLMResponse>> SendRequest(const LLMRequest& request) = 0;
+
+    /// @brief Sends a request and waits for the response on the calling thread.
+    /// The default waits on SendRequest(); providers that can run inline override it.
+    virtual Result<LLMResponse> SendRequestSync(const LLMRequest& request) {
+        return SendRequest(request).get();
+    }
+
+    /// @brief Sends a request and hands the completion to on_chunk as it is generated.
+    /// Runs on the calling thread. When on_chunk returns false the stream stops and
+    /// the result holds what arrived so far. The default delivers the whole
+    /// response as a single chunk.
+    virtual Result<LLMResponse> SendRequestStreaming(const LLMRequest& request, const LLMStreamCallback& on_chunk) {
+        auto result = SendRequestSync(request);
+        if (result.IsSuccess() && on_chunk && !result.Value().content.empty()) {
+            on_chunk(result.Value().content);
+        }
+        return result;
+    }
     
     /// @brief Sets the API key for the provider.
     /// @param api_key The API key to use for authentication.
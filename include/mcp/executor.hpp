@@ -0,0 +1,277 @@
+#pragma once
+
+#include "mcp/interfaces.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mcp {
+
+/**
+ * @brief One-shot list of callbacks run by whoever completes a Promise
+ */
+class CompletionSignal {
+public:
+    // Runs callback at once when the signal already fired, otherwise on the firing thread
+    void OnFire(std::function<void()> callback) {
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            if (!fired_) {
+                callbacks_.push_back(std::move(callback));
+                return;
+            }
+        }
+        callback();
+    }
+
+    void Fire() {
+        std::vector<std::function<void()>> callbacks;
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            if (fired_) {
+                return;
+            }
+            fired_ = true;
+            callbacks.swap(callbacks_);
+        }
+        for (auto& callback : callbacks) {
+            callback();
+        }
+    }
+
+    bool Fired() const {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        return fired_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    bool fired_ = false;
+    std::vector<std::function<void()>> callbacks_;
+};
+
+/**
+ * @brief std::future that also tells Then() when its Promise completes
+ *
+ * Converts to a plain std::future (dropping the signal), so it can be
+ * stored or returned wherever one was expected.
+ */
+template<typename T>
+class Future {
+public:
+    Future() = default;
+    Future(std::future<T> future, std::shared_ptr<CompletionSignal> signal)
+        : future_(std::move(future)), signal_(std::move(signal)) {}
+
+    T get() { return future_.get(); }
+    bool valid() const { return future_.valid(); }
+    void wait() const { future_.wait(); }
+    template<typename Rep, typename Period>
+    std::future_status wait_for(const std::chrono::duration<Rep, Period>& timeout) const {
+        return future_.wait_for(timeout);
+    }
+
+    operator std::future<T>() && { return std::move(future_); }
+    const std::shared_ptr<CompletionSignal>& Signal() const { return signal_; }
+
+private:
+    std::future<T> future_;
+    std::shared_ptr<CompletionSignal> signal_;
+};
+
+/**
+ * @brief std::promise that fires its futures' signal once satisfied
+ *
+ * A promise destroyed unsatisfied stores std::future_errc::broken_promise
+ * and fires as well, so a continuation never waits forever.
+ */
+template<typename T>
+class Promise {
+public:
+    Promise() : signal_(std::make_shared<CompletionSignal>()) {}
+    Promise(Promise&&) noexcept = default;
+    Promise& operator=(Promise&&) = delete;
+    Promise(const Promise&) = delete;
+    Promise& operator=(const Promise&) = delete;
+
+    ~Promise() {
+        if (signal_ && !signal_->Fired()) {
+            promise_ = std::promise<T>();  // Abandons the shared state, which stores broken_promise
+            signal_->Fire();
+        }
+    }
+
+    Future<T> get_future() { return Future<T>(promise_.get_future(), signal_); }
+
+    template<typename... Value>
+    void set_value(Value&&... value) {
+        promise_.set_value(std::forward<Value>(value)...);
+        signal_->Fire();
+    }
+
+    void set_exception(std::exception_ptr exception) {
+        promise_.set_exception(std::move(exception));
+        signal_->Fire();
+    }
+
+private:
+    std::promise<T> promise_;
+    std::shared_ptr<CompletionSignal> signal_;
+};
+
+namespace executor_detail {
+
+template<typename Value, typename Func>
+void Fulfil(Promise<Value>& promise, Func& func) {
+    try {
+        if constexpr (std::is_void_v<Value>) {
+            func();
+            promise.set_value();
+        } else {
+            promise.set_value(func());
+        }
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+    }
+}
+
+} // namespace executor_detail
+
+/**
+ * @brief Run func on the executor and hand back its result
+ *
+ * When the executor refuses the task (it is shutting down) func runs on
+ * the calling thread instead, so the future is always satisfied. The
+ * returned Future completes its Then() continuations from the worker
+ * that ran func.
+ */
+template<typename Func>
+auto Submit(ITaskExecutor& executor, Func&& func) -> Future<std::invoke_result_t<std::decay_t<Func>>> {
+    using Value = std::invoke_result_t<std::decay_t<Func>>;
+    struct State {
+        Promise<Value> promise;
+        std::decay_t<Func> func;
+    };
+    auto state = std::make_shared<State>(State{Promise<Value>(), std::forward<Func>(func)});
+    auto future = state->promise.get_future();
+    if (!executor.Post([state]() { executor_detail::Fulfil(state->promise, state->func); })) {
+        executor_detail::Fulfil(state->promise, state->func);
+    }
+    return future;
+}
+
+/**
+ * @brief Continue on the executor once future is ready, posted by whoever completes it
+ *
+ * Nothing polls: the thread that satisfies the Promise posts the
+ * continuation. When the executor is gone or refuses it by then, the
+ * continuation runs on that thread instead. continuation receives the
+ * ready future, so get() returns at once and rethrows whatever the
+ * producer stored. Returns false for a future without a Promise behind it.
+ */
+template<typename T, typename Continuation>
+bool Then(const std::shared_ptr<ITaskExecutor>& executor, Future<T> future, Continuation&& continuation) {
+    if (!future.valid() || !future.Signal()) {
+        return false;
+    }
+    auto signal = future.Signal();
+    auto pending = std::make_shared<std::future<T>>(std::move(future));
+    auto run = std::make_shared<std::decay_t<Continuation>>(std::forward<Continuation>(continuation));
+    std::weak_ptr<ITaskExecutor> weak = executor;
+    signal->OnFire([weak, pending, run]() {
+        auto task = [pending, run]() { (*run)(std::move(*pending)); };
+        auto target = weak.lock();
+        if (!target || !target->Post(task)) {
+            task();
+        }
+    });
+    return true;
+}
+
+/**
+ * @brief Continue on the executor once a plain std::future is ready
+ *
+ * A std::future cannot report completion, so the executor checks it with
+ * PostWhen; prefer the Future overload, which has no such delay. A future
+ * that is already ready is continued at once. Returns false, without
+ * running continuation, when the executor refused it or future is
+ * deferred: a deferred future only runs when waited on, so no readiness
+ * check would ever see it finish.
+ */
+template<typename T, typename Continuation>
+bool Then(ITaskExecutor& executor, std::future<T> future, Continuation&& continuation) {
+    if (!future.valid()) {
+        return false;
+    }
+    const auto status = future.wait_for(std::chrono::seconds(0));
+    if (status == std::future_status::deferred) {
+        return false;
+    }
+    auto pending = std::make_shared<std::future<T>>(std::move(future));
+    auto task = [pending, continuation = std::forward<Continuation>(continuation)]() mutable {
+        continuation(std::move(*pending));
+    };
+    if (status == std::future_status::ready) {
+        return executor.Post(std::move(task));
+    }
+    return executor.PostWhen(
+        [pending]() { return pending->wait_for(std::chrono::seconds(0)) == std::future_status::ready; },
+        std::move(task));
+}
+
+/**
+ * @brief Call body(i) for every i below count, spread over up to max_parallel threads
+ *
+ * The calling thread takes part, so this finishes even when every worker
+ * is busy or the executor refuses the helpers. Helpers that start after
+ * the last index was claimed return without touching body. Blocks until
+ * every body call has returned; body must not throw.
+ */
+template<typename Body>
+void ParallelFor(ITaskExecutor& executor, size_t count, size_t max_parallel, Body&& body) {
+    struct State {
+        size_t count = 0;
+        std::function<void(size_t)> body;
+        std::atomic<size_t> next{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+        size_t done = 0;
+    };
+
+    auto state = std::make_shared<State>();
+    state->count = count;
+    state->body = std::forward<Body>(body);
+    const auto run = [state]() {
+        for (size_t index = state->next++; index < state->count; index = state->next++) {
+            state->body(index);
+            const std::lock_guard<std::mutex> lock(state->mutex);
+            if (++state->done == state->count) {
+                state->finished.notify_all();
+            }
+        }
+    };
+
+    const size_t helpers = std::min(std::max<size_t>(max_parallel, 1), count);
+    for (size_t i = 1; i < helpers; ++i) {
+        if (!executor.Post(run)) {
+            break;
+        }
+    }
+    run();
+
+    // Only claimed indices are waited for, and those are already running
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state]() { return state->done == state->count; });
+}
+
+} // namespace mcp
@@ -0,0 +1,248 @@
+#pragma once
+
+#include "interfaces.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MCP_HEX_SSE2 1
+#endif
+
+namespace mcp {
+
+/**
+ * @brief Output options for HexEncode
+ *
+ * separator, when non-zero, is written between bytes (never after the last).
+ */
+struct HexFormat {
+    bool uppercase = false;
+    char separator = '\0';
+};
+
+namespace hex_detail {
+
+// Two output characters per byte value, looked up instead of formatted
+struct EncodeTable {
+    std::array<char, 512> lower;
+    std::array<char, 512> upper;
+
+    EncodeTable() : lower(), upper() {
+        static const char kLower[] = "0123456789abcdef";
+        static const char kUpper[] = "0123456789ABCDEF";
+        for (size_t b = 0; b < 256; ++b) {
+            lower[2 * b] = kLower[b >> 4];
+            lower[2 * b + 1] = kLower[b & 0x0F];
+            upper[2 * b] = kUpper[b >> 4];
+            upper[2 * b + 1] = kUpper[b & 0x0F];
+        }
+    }
+};
+
+// Nibble value of each character, 0xFF for anything that is not a hex digit
+struct DecodeTable {
+    std::array<uint8_t, 256> nibble;
+
+    DecodeTable() : nibble() {
+        nibble.fill(0xFF);
+        for (int c = 0; c < 10; ++c) {
+            nibble['0' + c] = static_cast<uint8_t>(c);
+        }
+        for (int c = 0; c < 6; ++c) {
+            nibble['a' + c] = static_cast<uint8_t>(10 + c);
+            nibble['A' + c] = static_cast<uint8_t>(10 + c);
+        }
+    }
+};
+
+inline const EncodeTable& GetEncodeTable() {
+    static const EncodeTable table;
+    return table;
+}
+
+inline const DecodeTable& GetDecodeTable() {
+    static const DecodeTable table;
+    return table;
+}
+
+inline bool IsHexSeparator(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+#ifdef MCP_HEX_SSE2
+// 16 bytes -> 32 characters
+inline void EncodeBlock(const uint8_t* data, char* out, bool uppercase) {
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    const __m128i low_mask = _mm_set1_epi8(0x0F);
+    const __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), low_mask);
+    const __m128i low = _mm_and_si128(bytes, low_mask);
+
+    // n + '0', plus the gap up to 'a' (or 'A') for n > 9
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i gap = _mm_set1_epi8(uppercase ? 'A' - '0' - 10 : 'a' - '0' - 10);
+    const __m128i high_chars = _mm_add_epi8(_mm_add_epi8(high, zero), _mm_and_si128(_mm_cmpgt_epi8(high, nine), gap));
+    const __m128i low_chars = _mm_add_epi8(_mm_add_epi8(low, zero), _mm_and_si128(_mm_cmpgt_epi8(low, nine), gap));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(high_chars, low_chars));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(high_chars, low_chars));
+}
+
+// 16 characters -> 8 byte values in the low half of each 16-bit lane; false if any is not a digit
+inline bool DecodeHalfBlock(const char* text, __m128i& values) {
+    const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+    const __m128i minus_one = _mm_set1_epi8(-1);
+
+    const __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    const __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(digit, minus_one), _mm_cmplt_epi8(digit, _mm_set1_epi8(10)));
+    const __m128i alpha = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    const __m128i is_alpha = _mm_and_si128(_mm_cmpgt_epi8(alpha, minus_one), _mm_cmplt_epi8(alpha, _mm_set1_epi8(6)));
+    if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha)) != 0xFFFF) {
+        return false;
+    }
+
+    const __m128i nibbles = _mm_or_si128(_mm_and_si128(is_digit, digit),
+                                         _mm_and_si128(is_alpha, _mm_add_epi8(alpha, _mm_set1_epi8(10))));
+    // Little-endian lanes: the first character of each pair is the low byte
+    const __m128i high = _mm_and_si128(nibbles, _mm_set1_epi16(0x00FF));
+    const __m128i low = _mm_srli_epi16(nibbles, 8);
+    values = _mm_or_si128(_mm_slli_epi16(high, 4), low);
+    return true;
+}
+
+// 32 characters -> 16 bytes
+inline bool DecodeBlock(const char* text, uint8_t* out) {
+    __m128i first;
+    __m128i second;
+    if (!DecodeHalfBlock(text, first) || !DecodeHalfBlock(text + 16, second)) {
+        return false;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(first, second));
+    return true;
+}
+#endif
+
+} // namespace hex_detail
+
+constexpr size_t HexEncodedSize(size_t size, char separator = '\0') {
+    return size == 0 ? 0 : (separator != '\0' ? size * 3 - 1 : size * 2);
+}
+
+/**
+ * @brief Encode size bytes into out, which must hold HexEncodedSize() characters
+ *
+ * No terminator is written. Returns the number of characters written.
+ */
+inline size_t HexEncode(const uint8_t* data, size_t size, char* out, HexFormat format = {}) {
+    const auto& table = hex_detail::GetEncodeTable();
+    const char* pairs = format.uppercase ? table.upper.data() : table.lower.data();
+    char* cursor = out;
+
+    if (format.separator == '\0') {
+        size_t i = 0;
+#ifdef MCP_HEX_SSE2
+        for (; i + 16 <= size; i += 16, cursor += 32) {
+            hex_detail::EncodeBlock(data + i, cursor, format.uppercase);
+        }
+#endif
+        for (; i < size; ++i, cursor += 2) {
+            std::memcpy(cursor, pairs + 2 * data[i], 2);
+        }
+        return static_cast<size_t>(cursor - out);
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+        if (i != 0) {
+            *cursor++ = format.separator;
+        }
+        std::memcpy(cursor, pairs + 2 * data[i], 2);
+        cursor += 2;
+    }
+    return static_cast<size_t>(cursor - out);
+}
+
+inline std::string HexEncode(const uint8_t* data, size_t size, HexFormat format = {}) {
+    std::string text(HexEncodedSize(size, format.separator), '\0');
+    HexEncode(data, size, &text[0], format);
+    return text;
+}
+
+inline std::string HexEncode(const std::vector<uint8_t>& bytes, HexFormat format = {}) {
+    return HexEncode(bytes.data(), bytes.size(), format);
+}
+
+// Upper bound on the bytes HexDecode can produce from length characters
+constexpr size_t HexDecodedCapacity(size_t length) {
+    return length / 2;
+}
+
+/**
+ * @brief Decode hex digits into out without throwing
+ *
+ * Digits may be upper or lower case; whitespace is accepted between bytes
+ * but not inside one. Fails on any other character, on an odd trailing
+ * digit, or when more than capacity bytes would be written. Returns the
+ * number of bytes written.
+ */
+inline Result<size_t> HexDecode(std::string_view text, uint8_t* out, size_t capacity) {
+    const auto& nibble = hex_detail::GetDecodeTable().nibble;
+    const char* cursor = text.data();
+    const char* const end = cursor + text.size();
+    size_t written = 0;
+    size_t scalar_steps = 0;  // After a block fails (separators), stay scalar for a while
+
+    while (cursor != end) {
+#ifdef MCP_HEX_SSE2
+        // Runs of 32 bare digits, the common case for unseparated dumps
+        if (scalar_steps == 0) {
+            while (end - cursor >= 32 && capacity - written >= 16 && hex_detail::DecodeBlock(cursor, out + written)) {
+                cursor += 32;
+                written += 16;
+            }
+            if (cursor == end) {
+                break;
+            }
+            scalar_steps = 16;
+        }
+        --scalar_steps;
+#endif
+        if (hex_detail::IsHexSeparator(*cursor)) {
+            ++cursor;
+            continue;
+        }
+        if (end - cursor < 2) {
+            return Result<size_t>::Error("Odd number of hex digits");
+        }
+        const uint8_t high = nibble[static_cast<uint8_t>(cursor[0])];
+        const uint8_t low = nibble[static_cast<uint8_t>(cursor[1])];
+        if (high == 0xFF || low == 0xFF) {
+            return Result<size_t>::Error("Invalid hex character at offset " +
+                                         std::to_string(cursor - text.data() + (high == 0xFF ? 0 : 1)));
+        }
+        if (written == capacity) {
+            return Result<size_t>::Error("Hex output buffer too small");
+        }
+        out[written++] = static_cast<uint8_t>((high << 4) | low);
+        cursor += 2;
+    }
+
+    return Result<size_t>::Success(written);
+}
+
+inline Result<std::vector<uint8_t>> HexDecode(std::string_view text) {
+    std::vector<uint8_t> bytes(HexDecodedCapacity(text.size()));
+    auto decoded = HexDecode(text, bytes.data(), bytes.size());
+    if (!decoded.IsSuccess()) {
+        return Result<std::vector<uint8_t>>::Error(decoded.Error());
+    }
+    bytes.resize(decoded.Value());
+    return Result<std::vector<uint8_t>>::Success(std::move(bytes));
+}
+
+} // namespace mcp
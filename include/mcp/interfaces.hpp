@@ -16,9 +16,14 @@ struct LLMRequest;
 struct LLMResponse;
 struct DebugEvent;
 struct MemoryDump;
+struct MemoryView;
+struct MemoryRange;
 struct SExpression;
 struct Config;
 
+// Receives each piece of a streamed completion; return false to stop the stream
+using LLMStreamCallback = std::function<bool(const std::string& chunk)>;
+
 // Result type for error handling
 template<typename T>
 class Result {
@@ -47,6 +52,14 @@ public:
         return value_;
     }
     
+    // Move the value out (large buffers); the Result keeps a moved-from T
+    T TakeValue() {
+        if (IsError()) {
+            throw std::runtime_error("Attempting to access TakeValue() on error Result: " + *error_);
+        }
+        return std::move(value_);
+    }
+    
     // БЕЗОПАСНЫЙ доступ к ошибке
     const std::string& Error() const {
         if (IsSuccess()) {
@@ -108,6 +121,9 @@ public:
     
     virtual std::future<Result<LLMResponse>> SendRequest(const LLMRequest& request) = 0;
     virtual Result<LLMResponse> SendRequestSync(const LLMRequest& request) = 0;
+    // on_chunk may run on a worker thread; the future holds the whole completion
+    virtual std::future<Result<LLMResponse>> SendRequestStreaming(const LLMRequest& request,
+                                                                  LLMStreamCallback on_chunk) = 0;
     virtual Result<void> SetAPIKey(const std::string& provider, const std::string& key) = 0;
     virtual std::vector<std::string> GetSupportedProviders() const = 0;
     virtual Result<void> ValidateConnection(const std::string& provider) = 0;
@@ -123,6 +139,8 @@ public:
     virtual Result<std::string> ExecuteCommand(const std::string& command) = 0;
     virtual Result<std::string> GetDisassembly(uintptr_t address) = 0;
     virtual Result<MemoryDump> ReadMemory(uintptr_t address, size_t size) = 0;
+    // Views in request order, all sharing one buffer; a view is short where its range is unreadable
+    virtual Result<std::vector<MemoryView>> ReadMemoryBatch(const std::vector<MemoryRange>& ranges) = 0;
     virtual Result<void> SetBreakpoint(uintptr_t address) = 0;
     virtual void RegisterEventHandler(std::function<void(const DebugEvent&)> handler) = 0;
     virtual bool IsConnected() const = 0;
@@ -152,7 +170,10 @@ public:
     virtual Result<void> SetDefaults() = 0;
     virtual Result<std::string> GetValue(const std::string& key) = 0;
     virtual Result<void> SetValue(const std::string& key, const std::string& value) = 0;
+    // Deprecated: the reference may not outlive later reloads; use GetSnapshot()
     virtual const Config& GetConfig() const = 0;
+    // Immutable and never null; readers take no lock
+    virtual std::shared_ptr<const Config> GetSnapshot() const = 0;
 };
 
 // Logger Interface
@@ -194,6 +215,11 @@ public:
     virtual Result<std::vector<std::string>> AnalyzePatterns(const MemoryDump& dump) = 0;
     virtual Result<std::vector<std::string>> FindStrings(const MemoryDump& dump) = 0;
     virtual Result<std::unordered_map<std::string, std::string>> ExtractMetadata(const MemoryDump& dump) = 0;
+    
+    // Zero-copy variants for bytes owned elsewhere (mapped files, shared bridge buffers)
+    virtual Result<std::vector<std::string>> AnalyzePatterns(const MemoryView& dump) = 0;
+    virtual Result<std::vector<std::string>> FindStrings(const MemoryView& dump) = 0;
+    virtual Result<std::unordered_map<std::string, std::string>> ExtractMetadata(const MemoryView& dump) = 0;
 };
 
 // Security Manager Interface
@@ -208,6 +234,19 @@ public:
     virtual bool ValidateAPIKey(const std::string& key) const = 0;
 };
 
+// Task Executor Interface - Shared pool for short CPU-bound work
+class ITaskExecutor {
+public:
+    using Task = std::function<void()>;
+    virtual ~ITaskExecutor() = default;
+    
+    // False once the executor is shutting down; the task is then not run
+    virtual bool Post(Task task) = 0;
+    // Runs task on the pool once ready() turns true; ready is polled off the pool and must not block
+    virtual bool PostWhen(std::function<bool()> ready, Task task) = 0;
+    virtual size_t GetWorkerCount() const = 0;
+};
+
 // Core Engine Interface - Orchestrates all modules
 class ICoreEngine {
 public:
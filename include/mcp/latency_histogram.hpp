@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace mcp {
+
+struct LatencySummary {
+    uint64_t count = 0;
+    uint64_t total_ns = 0;
+    uint64_t p50_ns = 0;
+    uint64_t p99_ns = 0;
+    uint64_t max_ns = 0;
+};
+
+/**
+ * @brief Lock-free log-linear histogram of durations in nanoseconds
+ *
+ * Each power of two is split into eight linear buckets, so percentiles are
+ * accurate to within 12.5% at any scale. Record() is a handful of relaxed
+ * atomic adds and never blocks; Summarize() may run concurrently and sees
+ * a slightly torn picture, which is fine for monitoring.
+ */
+class LatencyHistogram {
+public:
+    void Record(uint64_t nanoseconds) {
+        buckets_[BucketOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+        total_.fetch_add(nanoseconds, std::memory_order_relaxed);
+        uint64_t seen = max_.load(std::memory_order_relaxed);
+        while (nanoseconds > seen &&
+               !max_.compare_exchange_weak(seen, nanoseconds, std::memory_order_relaxed)) {
+            // seen was refreshed by the failed exchange
+        }
+    }
+
+    LatencySummary Summarize() const {
+        std::array<uint64_t, kBuckets> counts;
+        uint64_t count = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            counts[i] = buckets_[i].load(std::memory_order_relaxed);
+            count += counts[i];
+        }
+
+        LatencySummary summary;
+        summary.count = count;
+        summary.total_ns = total_.load(std::memory_order_relaxed);
+        summary.max_ns = max_.load(std::memory_order_relaxed);
+        if (count == 0) {
+            return summary;
+        }
+        summary.p50_ns = std::min(Percentile(counts, count, 50), summary.max_ns);
+        summary.p99_ns = std::min(Percentile(counts, count, 99), summary.max_ns);
+        return summary;
+    }
+
+    void Reset() {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        total_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t kSubBits = 3;
+    static constexpr size_t kSub = size_t{1} << kSubBits;
+    static constexpr size_t kBuckets = (64 - kSubBits + 1) * kSub;
+
+    static size_t BucketOf(uint64_t value) {
+        if (value < kSub) {
+            return static_cast<size_t>(value);
+        }
+        size_t exponent = 63;
+        while ((value >> exponent) == 0) {
+            --exponent;
+        }
+        const size_t sub = static_cast<size_t>(value >> (exponent - kSubBits)) & (kSub - 1);
+        return (exponent - kSubBits + 1) * kSub + sub;
+    }
+
+    // Largest value that lands in bucket index
+    static uint64_t UpperBound(size_t index) {
+        if (index < kSub) {
+            return index;
+        }
+        const size_t exponent = index / kSub + kSubBits - 1;
+        const uint64_t sub = index % kSub;
+        const uint64_t low = (uint64_t{1} << exponent) | (sub << (exponent - kSubBits));
+        return low + (uint64_t{1} << (exponent - kSubBits)) - 1;
+    }
+
+    static uint64_t Percentile(const std::array<uint64_t, kBuckets>& counts, uint64_t count, unsigned percent) {
+        const uint64_t rank = (count * percent + 99) / 100;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return UpperBound(i);
+            }
+        }
+        return UpperBound(kBuckets - 1);
+    }
+
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> total_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+/**
+ * @brief Records the lifetime of the scope into a histogram
+ */
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyHistogram& histogram)
+        : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+
+    ~ScopedLatency() {
+        histogram_.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_).count()));
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyHistogram& histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace mcp
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace mcp {
+
+/**
+ * @brief Non-owning view of dump bytes
+ *
+ * Points at memory that lives elsewhere: a MemoryDump, a mapped dump file,
+ * a bridge buffer. owner optionally keeps that storage alive for as long as
+ * the view (or any copy or subview of it) exists; views created with Of()
+ * leave it empty and must not outlive the dump they point into.
+ */
+struct MemoryView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    uintptr_t base_address = 0;
+    std::string module_name;
+    std::shared_ptr<const void> owner;
+
+    MemoryView() = default;
+    MemoryView(const uint8_t* view_data, size_t view_size, uintptr_t base,
+               std::string module = "", std::shared_ptr<const void> storage = nullptr)
+        : data(view_data), size(view_size), base_address(base),
+          module_name(std::move(module)), owner(std::move(storage)) {}
+
+    // Borrow a dump's payload without copying it
+    static MemoryView Of(const MemoryDump& dump) {
+        return MemoryView(dump.data.data(), dump.data.size(), dump.base_address, dump.module_name);
+    }
+
+    // View that shares ownership of the dump it points into
+    static MemoryView Share(std::shared_ptr<const MemoryDump> dump) {
+        MemoryView view = Of(*dump);
+        view.owner = std::move(dump);
+        return view;
+    }
+
+    bool empty() const { return size == 0; }
+    const uint8_t* begin() const { return data; }
+    const uint8_t* end() const { return data + size; }
+    uint8_t operator[](size_t index) const { return data[index]; }
+
+    /**
+     * @brief Bytes [offset, offset + length) of this view, clamped to its end
+     */
+    MemoryView Subview(size_t offset, size_t length) const {
+        if (offset > size) {
+            offset = size;
+        }
+        if (length > size - offset) {
+            length = size - offset;
+        }
+        return MemoryView(data + offset, length, base_address + offset, module_name, owner);
+    }
+
+    /**
+     * @brief Owning copy, for APIs that still need a MemoryDump
+     */
+    MemoryDump ToDump() const {
+        MemoryDump dump;
+        dump.base_address = base_address;
+        dump.data.assign(data, data + size);
+        dump.size = size;
+        dump.module_name = module_name;
+        return dump;
+    }
+};
+
+} // namespace mcp
@@ -6,9 +6,23 @@
 #include <optional>
 #include <chrono>
 #include <variant>
+#include <atomic>
+#include <memory>
 
 namespace mcp {
 
+// Copies share one flag, so a caller keeps a copy to cancel a request it handed off
+class CancellationToken {
+public:
+    CancellationToken() : cancelled_(std::make_shared<std::atomic<bool>>(false)) {}
+    void Cancel() const { cancelled_->store(true, std::memory_order_release); }
+    bool IsCancelled() const { return cancelled_->load(std::memory_order_acquire); }
+    bool SameAs(const CancellationToken& other) const { return cancelled_ == other.cancelled_; }
+
+private:
+    std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
 // LLM Request/Response structures
 struct LLMRequest {
     std::string provider;           // "claude", "gpt", "gemini"
@@ -19,6 +33,8 @@ struct LLMRequest {
     double temperature = 0.7;
     int max_tokens = 1024;
     std::optional<std::string> system_prompt;
+    int priority = 0;                // Higher runs first when requests queue up
+    CancellationToken cancellation;
 };
 
 struct LLMResponse {
@@ -63,6 +79,12 @@ struct MemoryDump {
     std::chrono::system_clock::time_point timestamp;
 };
 
+// One [address, address + size) span of debuggee memory
+struct MemoryRange {
+    uintptr_t address = 0;
+    size_t size = 0;
+};
+
 // S-Expression structures
 struct SExpression {
     using Value = std::variant<
@@ -99,6 +121,10 @@ struct APIConfig {
     int timeout_ms = 30000;
     int max_retries = 3;
     bool validate_ssl = true;
+    size_t pool_size = 4;        // Keep-alive connections per host
+    int keep_alive_ms = 60000;   // Idle connections are closed after this
+    int requests_per_minute = 0; // 0 learns the quota from rate-limit headers
+    int tokens_per_minute = 0;
 };
 
 struct DebugConfig {
@@ -106,7 +132,14 @@ struct DebugConfig {
     std::vector<std::string> plugin_paths;
     bool auto_connect = true;
     int connection_timeout_ms = 5000;
+    std::string tcp_host = "127.0.0.1";  // Debugger end of the TCP connection mode
+    int tcp_port = 27042;
     std::vector<std::string> startup_commands;
+    size_t memory_cache_pages = 256;  // 4 KB pages of debuggee memory, 0 disables the cache
+    size_t event_queue_capacity = 4096;
+    std::string event_overflow_policy = "block";  // "block", "drop_oldest" or "coalesce"
+    int stats_export_interval_ms = 0;  // 0 disables the periodic bridge stats export
+    std::string stats_export_path;     // JSON lines are appended here
 };
 
 struct LogConfig {
@@ -119,6 +152,9 @@ struct LogConfig {
     size_t max_file_size_mb = 100;
     int max_files = 10;
     std::string format = "[{timestamp}] [{level}] {message}";
+    size_t queue_capacity = 8192;                 // Entries buffered for the log thread; fixed at construction
+    std::string overflow_policy = "drop_newest";  // "block", "drop_oldest" or "drop_newest"
+    std::string trace_path;                       // Binary trace of dumps and events; empty keeps them in the text log
 };
 
 // Operators for LogConfig::Level enum
@@ -131,19 +167,44 @@ inline bool operator>=(LogConfig::Level lhs, LogConfig::Level rhs) {
 }
 
 struct SecurityConfig {
-    std::string encryption_key_path;
+    std::string encryption_key_path;     // Keeps the data key across sessions; created on first use
     std::string credential_store_path;
     bool require_api_key_validation = true;
     bool encrypt_credentials = true;
     int key_rotation_days = 90;
+    int credential_cache_seconds = 60;   // Decrypted credentials kept in locked memory; 0 = decrypt every time
+};
+
+struct AnalysisConfig {
+    int worker_threads = 0;          // 0 = one per hardware thread, 1 = always serial
+    size_t chunk_size_kb = 4096;     // Dumps larger than one chunk are analyzed in parallel
+    size_t entropy_window = 4096;    // 0 disables the entropy profile
+    size_t entropy_step = 1024;
+    double high_entropy_threshold = 7.2; // Bits per byte; windows above it become regions
+    std::string pattern_database;          // Extra text signatures; empty loads only the built-in set
+    std::string compiled_pattern_database; // Compiled cache of pattern_database; empty parses every time
+};
+
+struct LLMConfig {
+    bool response_cache = true;
+    size_t cache_entries = 512;            // In-memory tier
+    int cache_ttl_seconds = 86400;         // 0 keeps responses until evicted
+    std::string cache_directory;           // Encrypted on-disk tier shared across sessions; empty disables it
+    size_t cache_disk_mb = 256;            // Oldest files are evicted above this; 0 = unbounded
+    bool failover = false;                 // Retry quota and overload failures on the next provider
+    size_t context_tokens = 6000;          // Budget for a request's context items; 0 sends them all
+    int response_tokens = 1024;            // Answer length for requests that do not set one
 };
 
 struct Config {
     std::unordered_map<std::string, APIConfig> api_configs;
+    LLMConfig llm_config;
     DebugConfig debug_config;
     LogConfig log_config;
     SecurityConfig security_config;
+    AnalysisConfig analysis_config;
     std::unordered_map<std::string, std::string> custom_settings;
+    int hot_reload_interval_ms = 0;      // Re-read the config file when it changes; 0 = never
 };
 
 // Analysis results
@@ -164,9 +225,21 @@ struct StringMatch {
     bool is_wide = false;
 };
 
+// Sliding-window Shannon entropy, one byte per window: value * 8 / 255 bits per byte
+struct EntropyProfile {
+    static constexpr double kScale = 255.0 / 8.0;
+
+    size_t window_size = 0;
+    size_t step = 0;  // Window i covers [i * step, i * step + window_size)
+    std::vector<uint8_t> values;
+
+    double EntropyAt(size_t index) const { return values[index] / kScale; }
+};
+
 struct AnalysisResult {
     std::vector<PatternMatch> patterns;
     std::vector<StringMatch> strings;
+    EntropyProfile entropy;
     std::unordered_map<std::string, std::string> metadata;
     std::chrono::system_clock::time_point timestamp;
 };
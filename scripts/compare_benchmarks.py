@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""
+MCP Debugger Benchmark Comparison
+
+Compares a Google Benchmark JSON run (mcp_benchmarks --benchmark_out=...
+--benchmark_out_format=json) against a stored baseline and exits non-zero
+when any benchmark got slower than the allowed threshold. With --update the
+results replace the baseline instead.
+"""
+
+import argparse
+import json
+import shutil
+import sys
+from pathlib import Path
+from typing import Dict, Optional
+
+TIME_UNITS_NS = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+
+
+def load_times(path: Path, metric: str) -> Dict[str, float]:
+    """Benchmark name -> time per iteration in nanoseconds
+
+    Repeated runs are reduced to their median when the file has aggregates,
+    and averaged otherwise.
+    """
+    with open(path, 'r', encoding='utf-8') as f:
+        data = json.load(f)
+
+    medians: Dict[str, float] = {}
+    runs: Dict[str, list] = {}
+    for entry in data.get('benchmarks', []):
+        if entry.get('error_occurred'):
+            continue
+        name = entry.get('run_name', entry['name'])
+        value = entry[metric] * TIME_UNITS_NS[entry.get('time_unit', 'ns')]
+        if entry.get('run_type') == 'aggregate':
+            if entry.get('aggregate_name') == 'median':
+                medians[name] = value
+        else:
+            runs.setdefault(name, []).append(value)
+
+    times = {name: sum(values) / len(values) for name, values in runs.items()}
+    times.update(medians)
+    return times
+
+
+def format_ns(value: float) -> str:
+    for unit in ('s', 'ms', 'us'):
+        if value >= TIME_UNITS_NS[unit]:
+            return f"{value / TIME_UNITS_NS[unit]:.3f} {unit}"
+    return f"{value:.1f} ns"
+
+
+def compare(baseline: Dict[str, float], results: Dict[str, float], threshold: float,
+            filter_text: Optional[str]) -> int:
+    regressions = 0
+    width = max((len(name) for name in results), default=20)
+    print(f"{'Benchmark':<{width}}  {'Baseline':>12}  {'Current':>12}  {'Change':>8}")
+    for name in sorted(results):
+        if filter_text and filter_text not in name:
+            continue
+        current = results[name]
+        if name not in baseline:
+            print(f"{name:<{width}}  {'-':>12}  {format_ns(current):>12}  {'new':>8}")
+            continue
+        old = baseline[name]
+        change = (current - old) / old * 100.0 if old > 0 else 0.0
+        regressed = change > threshold
+        regressions += regressed
+        marker = '  REGRESSION' if regressed else ''
+        print(f"{name:<{width}}  {format_ns(old):>12}  {format_ns(current):>12}  {change:>+7.1f}%{marker}")
+
+    missing = sorted(set(baseline) - set(results))
+    if missing and not filter_text:
+        print(f"\n{len(missing)} baseline benchmark(s) not in this run: {', '.join(missing)}")
+
+    if regressions:
+        print(f"\n{regressions} benchmark(s) slower than the baseline by more than {threshold:.1f}%")
+    else:
+        print(f"\nNo regressions above {threshold:.1f}%")
+    return 1 if regressions else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='MCP Debugger Benchmark Comparison')
+    parser.add_argument('baseline', type=Path, help='Stored baseline JSON')
+    parser.add_argument('results', type=Path, help='JSON written by mcp_benchmarks')
+    parser.add_argument('--threshold', type=float, default=10.0,
+                        help='Percent slowdown that counts as a regression (default: 10)')
+    parser.add_argument('--metric', choices=['real_time', 'cpu_time'], default='real_time')
+    parser.add_argument('--filter', help='Only compare benchmarks whose name contains this text')
+    parser.add_argument('--update', action='store_true', help='Replace the baseline with the results')
+    args = parser.parse_args()
+
+    if not args.results.exists():
+        print(f"Results not found: {args.results}", file=sys.stderr)
+        return 2
+
+    if args.update:
+        args.baseline.parent.mkdir(parents=True, exist_ok=True)
+        shutil.copyfile(args.results, args.baseline)
+        print(f"Baseline updated: {args.baseline}")
+        return 0
+
+    if not args.baseline.exists():
+        print(f"Baseline not found: {args.baseline} (record one with --update)", file=sys.stderr)
+        return 2
+
+    return compare(load_times(args.baseline, args.metric), load_times(args.results, args.metric),
+                   args.threshold, args.filter)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
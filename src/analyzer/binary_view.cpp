@@ -0,0 +1,463 @@
+#include "binary_view.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace mcp {
+
+namespace {
+
+// Little-endian reads; callers bound-check offset + sizeof(T) <= size first
+template<typename T>
+T Load(const uint8_t* data, size_t offset) {
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+bool InBounds(size_t size, size_t offset, size_t length) {
+    return offset <= size && length <= size - offset;
+}
+
+constexpr size_t kMaxImportDescriptors = 4096;
+constexpr size_t kMaxThunksPerModule = 65536;
+constexpr size_t kMaxExports = 1 << 20;
+constexpr size_t kMaxNameLength = 4096;
+
+constexpr size_t kDirectoryExport = 0;
+constexpr size_t kDirectoryImport = 1;
+
+} // anonymous namespace
+
+Result<PeView> PeView::Parse(const MemoryView& dump, Layout layout) {
+    const uint8_t* data = dump.data;
+    const size_t size = dump.size;
+
+    if (size < 0x40 || data[0] != 'M' || data[1] != 'Z') {
+        return Result<PeView>::Error("Missing DOS header");
+    }
+
+    const size_t nt_offset = Load<uint32_t>(data, 0x3C);
+    if (!InBounds(size, nt_offset, 24) || std::memcmp(data + nt_offset, "PE\0\0", 4) != 0) {
+        return Result<PeView>::Error("Missing PE signature");
+    }
+
+    PeView view;
+    view.data_ = data;
+    view.size_ = size;
+    view.layout_ = layout;
+    view.nt_offset_ = nt_offset;
+    view.optional_offset_ = nt_offset + 24;
+    view.section_count_ = Load<uint16_t>(data, nt_offset + 6);
+
+    const size_t optional_size = Load<uint16_t>(data, nt_offset + 20);
+    if (optional_size < 2 || !InBounds(size, view.optional_offset_, optional_size)) {
+        return Result<PeView>::Error("Truncated optional header");
+    }
+
+    const uint16_t magic = Load<uint16_t>(data, view.optional_offset_);
+    if (magic == 0x20B) {
+        view.is_64_ = true;
+    } else if (magic != 0x10B) {
+        return Result<PeView>::Error("Unknown optional header magic");
+    }
+
+    const size_t directories_field = view.is_64_ ? 108 : 92;
+    if (optional_size < directories_field + 4) {
+        return Result<PeView>::Error("Truncated optional header");
+    }
+    const size_t directory_room = (optional_size - directories_field - 4) / 8;
+    view.directory_count_ = static_cast<uint32_t>(
+        std::min<size_t>(Load<uint32_t>(data, view.optional_offset_ + directories_field), directory_room));
+
+    view.section_offset_ = view.optional_offset_ + optional_size;
+    if (!InBounds(size, view.section_offset_, view.section_count_ * 40)) {
+        return Result<PeView>::Error("Truncated section table");
+    }
+
+    return Result<PeView>::Success(view);
+}
+
+uint16_t PeView::GetMachine() const {
+    return Load<uint16_t>(data_, nt_offset_ + 4);
+}
+
+uint64_t PeView::GetImageBase() const {
+    return is_64_ ? Load<uint64_t>(data_, optional_offset_ + 24) : Load<uint32_t>(data_, optional_offset_ + 28);
+}
+
+uint32_t PeView::GetEntryPointRva() const {
+    return Load<uint32_t>(data_, optional_offset_ + 16);
+}
+
+uint32_t PeView::GetSizeOfImage() const {
+    return Load<uint32_t>(data_, optional_offset_ + 56);
+}
+
+PeSectionHeader PeView::GetSection(size_t index) const {
+    const size_t offset = section_offset_ + index * 40;
+    const char* name = reinterpret_cast<const char*>(data_ + offset);
+
+    PeSectionHeader section;
+    section.name = std::string_view(name, strnlen(name, 8));
+    section.virtual_size = Load<uint32_t>(data_, offset + 8);
+    section.virtual_address = Load<uint32_t>(data_, offset + 12);
+    section.raw_size = Load<uint32_t>(data_, offset + 16);
+    section.raw_offset = Load<uint32_t>(data_, offset + 20);
+    section.characteristics = Load<uint32_t>(data_, offset + 36);
+    return section;
+}
+
+bool PeView::GetDataDirectory(size_t index, uint32_t& rva, uint32_t& size) const {
+    if (index >= directory_count_) {
+        return false;
+    }
+    const size_t offset = optional_offset_ + (is_64_ ? 112 : 96) + index * 8;
+    rva = Load<uint32_t>(data_, offset);
+    size = Load<uint32_t>(data_, offset + 4);
+    return rva != 0;
+}
+
+bool PeView::RvaToOffset(uint32_t rva, size_t& offset) const {
+    if (layout_ == Layout::kImage) {
+        offset = rva;
+        return rva < size_;
+    }
+
+    for (size_t i = 0; i < section_count_; ++i) {
+        const PeSectionHeader section = GetSection(i);
+        const uint32_t span = std::max(section.virtual_size, section.raw_size);
+        if (rva >= section.virtual_address && rva - section.virtual_address < span) {
+            const uint32_t delta = rva - section.virtual_address;
+            if (delta >= section.raw_size) {
+                return false; // Zero-fill tail, not present in the file
+            }
+            offset = static_cast<size_t>(section.raw_offset) + delta;
+            return offset < size_;
+        }
+    }
+
+    // Headers are mapped 1:1
+    offset = rva;
+    return section_count_ == 0 ? rva < size_ : rva < GetSection(0).raw_offset && rva < size_;
+}
+
+std::string_view PeView::CStringAtRva(uint32_t rva) const {
+    size_t offset = 0;
+    if (!RvaToOffset(rva, offset)) {
+        return {};
+    }
+    const char* text = reinterpret_cast<const char*>(data_ + offset);
+    return std::string_view(text, strnlen(text, std::min(size_ - offset, kMaxNameLength)));
+}
+
+void PeView::ForEachImport(const std::function<void(const PeImportEntry&)>& callback) const {
+    uint32_t directory_rva = 0;
+    uint32_t directory_size = 0;
+    if (!GetDataDirectory(kDirectoryImport, directory_rva, directory_size)) {
+        return;
+    }
+
+    const size_t thunk_size = is_64_ ? 8 : 4;
+    const uint64_t ordinal_flag = is_64_ ? (1ull << 63) : (1ull << 31);
+
+    for (size_t d = 0; d < kMaxImportDescriptors; ++d) {
+        size_t descriptor = 0;
+        if (!RvaToOffset(directory_rva + static_cast<uint32_t>(d * 20), descriptor) ||
+            !InBounds(size_, descriptor, 20)) {
+            return;
+        }
+
+        const uint32_t lookup_rva = Load<uint32_t>(data_, descriptor);
+        const uint32_t name_rva = Load<uint32_t>(data_, descriptor + 12);
+        const uint32_t iat_rva = Load<uint32_t>(data_, descriptor + 16);
+        if (name_rva == 0 && iat_rva == 0) {
+            return; // Null terminator descriptor
+        }
+
+        PeImportEntry entry;
+        entry.module = CStringAtRva(name_rva);
+
+        // Bound images overwrite the IAT, so prefer the original lookup table
+        const uint32_t table_rva = lookup_rva != 0 ? lookup_rva : iat_rva;
+        for (size_t t = 0; t < kMaxThunksPerModule; ++t) {
+            size_t thunk = 0;
+            if (!RvaToOffset(table_rva + static_cast<uint32_t>(t * thunk_size), thunk) ||
+                !InBounds(size_, thunk, thunk_size)) {
+                break;
+            }
+            const uint64_t value = is_64_ ? Load<uint64_t>(data_, thunk) : Load<uint32_t>(data_, thunk);
+            if (value == 0) {
+                break;
+            }
+
+            entry.thunk_rva = iat_rva + static_cast<uint32_t>(t * thunk_size);
+            entry.by_ordinal = (value & ordinal_flag) != 0;
+            if (entry.by_ordinal) {
+                entry.ordinal_or_hint = static_cast<uint16_t>(value & 0xFFFF);
+                entry.function = {};
+            } else {
+                const uint32_t hint_rva = static_cast<uint32_t>(value & 0x7FFFFFFF);
+                size_t hint = 0;
+                if (!RvaToOffset(hint_rva, hint) || !InBounds(size_, hint, 2)) {
+                    continue;
+                }
+                entry.ordinal_or_hint = Load<uint16_t>(data_, hint);
+                entry.function = CStringAtRva(hint_rva + 2);
+            }
+            callback(entry);
+        }
+    }
+}
+
+void PeView::ForEachExport(const std::function<void(const PeExportEntry&)>& callback) const {
+    uint32_t directory_rva = 0;
+    uint32_t directory_size = 0;
+    size_t directory = 0;
+    if (!GetDataDirectory(kDirectoryExport, directory_rva, directory_size) ||
+        !RvaToOffset(directory_rva, directory) || !InBounds(size_, directory, 40)) {
+        return;
+    }
+
+    const uint32_t ordinal_base = Load<uint32_t>(data_, directory + 16);
+    const size_t function_count = std::min<size_t>(Load<uint32_t>(data_, directory + 20), kMaxExports);
+    const size_t name_count = std::min<size_t>(Load<uint32_t>(data_, directory + 24), function_count);
+    size_t functions = 0;
+    size_t names = 0;
+    size_t ordinals = 0;
+    if (!RvaToOffset(Load<uint32_t>(data_, directory + 28), functions) ||
+        !InBounds(size_, functions, function_count * 4)) {
+        return;
+    }
+    const bool has_names = name_count != 0 &&
+                           RvaToOffset(Load<uint32_t>(data_, directory + 32), names) &&
+                           RvaToOffset(Load<uint32_t>(data_, directory + 36), ordinals) &&
+                           InBounds(size_, names, name_count * 4) &&
+                           InBounds(size_, ordinals, name_count * 2);
+
+    // Named exports first, then the ones only reachable by ordinal
+    std::vector<bool> named(function_count, false);
+    if (has_names) {
+        for (size_t i = 0; i < name_count; ++i) {
+            const uint16_t index = Load<uint16_t>(data_, ordinals + i * 2);
+            if (index >= function_count) {
+                continue;
+            }
+            named[index] = true;
+
+            PeExportEntry entry;
+            entry.name = CStringAtRva(Load<uint32_t>(data_, names + i * 4));
+            entry.ordinal = static_cast<uint16_t>(ordinal_base + index);
+            entry.rva = Load<uint32_t>(data_, functions + index * 4);
+            callback(entry);
+        }
+    }
+
+    for (size_t index = 0; index < function_count; ++index) {
+        const uint32_t rva = Load<uint32_t>(data_, functions + index * 4);
+        if (named[index] || rva == 0) {
+            continue;
+        }
+        PeExportEntry entry;
+        entry.ordinal = static_cast<uint16_t>(ordinal_base + index);
+        entry.rva = rva;
+        callback(entry);
+    }
+}
+
+Result<ElfView> ElfView::Parse(const MemoryView& dump) {
+    const uint8_t* data = dump.data;
+    const size_t size = dump.size;
+
+    if (size < 52 || data[0] != 0x7F || data[1] != 'E' || data[2] != 'L' || data[3] != 'F') {
+        return Result<ElfView>::Error("Missing ELF header");
+    }
+    if (data[5] != 1) {
+        return Result<ElfView>::Error("Big-endian ELF is not supported");
+    }
+
+    ElfView view;
+    view.data_ = data;
+    view.size_ = size;
+    if (data[4] == 2) {
+        view.is_64_ = true;
+        if (size < 64) {
+            return Result<ElfView>::Error("Truncated ELF header");
+        }
+    } else if (data[4] != 1) {
+        return Result<ElfView>::Error("Unknown ELF class");
+    }
+
+    const uint64_t section_offset = view.is_64_ ? Load<uint64_t>(data, 40) : Load<uint32_t>(data, 32);
+    const size_t entry_size = Load<uint16_t>(data, view.is_64_ ? 58 : 46);
+    const size_t count = Load<uint16_t>(data, view.is_64_ ? 60 : 48);
+    const size_t names_index = Load<uint16_t>(data, view.is_64_ ? 62 : 50);
+
+    // The section table is optional; keep the view without it when it is missing
+    const size_t minimum_entry = view.is_64_ ? 64 : 40;
+    if (section_offset != 0 && entry_size >= minimum_entry && section_offset <= size &&
+        InBounds(size, static_cast<size_t>(section_offset), count * entry_size)) {
+        view.section_offset_ = static_cast<size_t>(section_offset);
+        view.section_entry_size_ = entry_size;
+        view.section_count_ = count;
+
+        if (names_index < count) {
+            const ElfSectionHeader names = view.ReadSection(names_index);
+            if (InBounds(size, names.offset, names.size)) {
+                view.names_offset_ = static_cast<size_t>(names.offset);
+                view.names_size_ = static_cast<size_t>(names.size);
+            }
+        }
+    }
+
+    return Result<ElfView>::Success(view);
+}
+
+uint16_t ElfView::GetType() const {
+    return Load<uint16_t>(data_, 16);
+}
+
+uint16_t ElfView::GetMachine() const {
+    return Load<uint16_t>(data_, 18);
+}
+
+uint64_t ElfView::GetEntryPoint() const {
+    return is_64_ ? Load<uint64_t>(data_, 24) : Load<uint32_t>(data_, 24);
+}
+
+size_t ElfView::GetProgramHeaderCount() const {
+    return Load<uint16_t>(data_, is_64_ ? 56 : 44);
+}
+
+ElfSectionHeader ElfView::ReadSection(size_t index) const {
+    const size_t offset = section_offset_ + index * section_entry_size_;
+
+    ElfSectionHeader section;
+    const uint32_t name = Load<uint32_t>(data_, offset);
+    section.type = Load<uint32_t>(data_, offset + 4);
+    if (is_64_) {
+        section.flags = Load<uint64_t>(data_, offset + 8);
+        section.address = Load<uint64_t>(data_, offset + 16);
+        section.offset = Load<uint64_t>(data_, offset + 24);
+        section.size = Load<uint64_t>(data_, offset + 32);
+        section.link = Load<uint32_t>(data_, offset + 40);
+        section.entry_size = Load<uint64_t>(data_, offset + 56);
+    } else {
+        section.flags = Load<uint32_t>(data_, offset + 8);
+        section.address = Load<uint32_t>(data_, offset + 12);
+        section.offset = Load<uint32_t>(data_, offset + 16);
+        section.size = Load<uint32_t>(data_, offset + 20);
+        section.link = Load<uint32_t>(data_, offset + 24);
+        section.entry_size = Load<uint32_t>(data_, offset + 36);
+    }
+    section.name = CStringAt(names_offset_, names_size_, name);
+    return section;
+}
+
+ElfSectionHeader ElfView::GetSection(size_t index) const {
+    return ReadSection(index);
+}
+
+std::string_view ElfView::CStringAt(size_t table_offset, size_t table_size, size_t index) const {
+    if (index >= table_size) {
+        return {};
+    }
+    const char* text = reinterpret_cast<const char*>(data_ + table_offset + index);
+    return std::string_view(text, strnlen(text, std::min(table_size - index, kMaxNameLength)));
+}
+
+void ElfView::ForEachSymbol(const std::function<void(const ElfSymbol&)>& callback) const {
+    const size_t symbol_size = is_64_ ? 24 : 16;
+
+    for (size_t s = 0; s < section_count_; ++s) {
+        const ElfSectionHeader table = ReadSection(s);
+        if ((table.type != kSymbolTable && table.type != kDynamicSymbols) ||
+            !InBounds(size_, table.offset, table.size) || table.link >= section_count_) {
+            continue;
+        }
+        const ElfSectionHeader strings = ReadSection(table.link);
+        if (!InBounds(size_, strings.offset, strings.size)) {
+            continue;
+        }
+
+        const size_t count = static_cast<size_t>(table.size) / symbol_size;
+        for (size_t i = 1; i < count; ++i) { // Entry 0 is the reserved null symbol
+            const size_t offset = static_cast<size_t>(table.offset) + i * symbol_size;
+
+            ElfSymbol symbol;
+            const uint32_t name = Load<uint32_t>(data_, offset);
+            if (is_64_) {
+                symbol.info = data_[offset + 4];
+                symbol.section_index = Load<uint16_t>(data_, offset + 6);
+                symbol.value = Load<uint64_t>(data_, offset + 8);
+                symbol.size = Load<uint64_t>(data_, offset + 16);
+            } else {
+                symbol.value = Load<uint32_t>(data_, offset + 4);
+                symbol.size = Load<uint32_t>(data_, offset + 8);
+                symbol.info = data_[offset + 12];
+                symbol.section_index = Load<uint16_t>(data_, offset + 14);
+            }
+            symbol.name = CStringAt(static_cast<size_t>(strings.offset), static_cast<size_t>(strings.size), name);
+            callback(symbol);
+        }
+    }
+}
+
+Result<BinaryModuleInfo> BinaryModuleInfo::Build(const MemoryView& dump) {
+    BinaryModuleInfo info;
+
+    if (dump.size >= 2 && dump.data[0] == 'M' && dump.data[1] == 'Z') {
+        auto pe_result = PeView::Parse(dump);
+        if (!pe_result.IsSuccess()) {
+            return Result<BinaryModuleInfo>::Error(pe_result.Error());
+        }
+        const PeView& pe = pe_result.Value();
+
+        info.format = "PE";
+        info.is_64 = pe.Is64();
+        info.machine = pe.GetMachine();
+        info.image_base = pe.GetImageBase();
+        info.entry_point = pe.GetEntryPointRva();
+
+        info.sections.reserve(pe.GetSectionCount());
+        for (size_t i = 0; i < pe.GetSectionCount(); ++i) {
+            const PeSectionHeader section = pe.GetSection(i);
+            info.sections.push_back({std::string(section.name), section.virtual_address,
+                                     section.virtual_size, section.characteristics});
+        }
+        pe.ForEachImport([&](const PeImportEntry& entry) {
+            info.imports.push_back({std::string(entry.module), std::string(entry.function),
+                                    entry.thunk_rva, entry.ordinal_or_hint});
+        });
+        pe.ForEachExport([&](const PeExportEntry& entry) {
+            info.exports.push_back({std::string(), std::string(entry.name), entry.rva, entry.ordinal});
+        });
+        return Result<BinaryModuleInfo>::Success(std::move(info));
+    }
+
+    auto elf_result = ElfView::Parse(dump);
+    if (!elf_result.IsSuccess()) {
+        return Result<BinaryModuleInfo>::Error(elf_result.Error());
+    }
+    const ElfView& elf = elf_result.Value();
+
+    info.format = "ELF";
+    info.is_64 = elf.Is64();
+    info.machine = elf.GetMachine();
+    info.entry_point = elf.GetEntryPoint();
+
+    info.sections.reserve(elf.GetSectionCount());
+    for (size_t i = 0; i < elf.GetSectionCount(); ++i) {
+        const ElfSectionHeader section = elf.GetSection(i);
+        info.sections.push_back({std::string(section.name), section.address, section.size, section.flags});
+    }
+    elf.ForEachSymbol([&](const ElfSymbol& symbol) {
+        if (symbol.section_index == 0 || symbol.name.empty()) {
+            info.imports.push_back({std::string(), std::string(symbol.name), symbol.value, 0});
+        } else {
+            info.exports.push_back({std::string(), std::string(symbol.name), symbol.value, 0});
+        }
+    });
+    return Result<BinaryModuleInfo>::Success(std::move(info));
+}
+
+} // namespace mcp
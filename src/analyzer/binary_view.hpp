@@ -0,0 +1,171 @@
+#pragma once
+
+#include "mcp/interfaces.hpp"
+#include "mcp/memory_view.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mcp {
+
+struct PeSectionHeader {
+    std::string_view name;  // Up to 8 bytes, not NUL-terminated
+    uint32_t virtual_address = 0;
+    uint32_t virtual_size = 0;
+    uint32_t raw_offset = 0;
+    uint32_t raw_size = 0;
+    uint32_t characteristics = 0;
+};
+
+struct PeImportEntry {
+    std::string_view module;
+    std::string_view function;  // Empty for imports by ordinal
+    uint16_t ordinal_or_hint = 0;
+    bool by_ordinal = false;
+    uint32_t thunk_rva = 0;     // IAT slot
+};
+
+struct PeExportEntry {
+    std::string_view name;  // Empty for exports by ordinal only
+    uint16_t ordinal = 0;
+    uint32_t rva = 0;
+};
+
+/**
+ * @brief Zero-allocation view of a PE image
+ *
+ * Parse() validates the DOS/NT headers and the section table and records
+ * their offsets; nothing else is read until asked. Names are returned as
+ * string_views into the dump, so the dump must outlive any entry handed to
+ * a callback. Dumps read from a live process use the image layout (RVA ==
+ * offset), files on disk the file layout.
+ */
+class PeView {
+public:
+    enum class Layout { kImage, kFile };
+
+    PeView() = default;
+
+    static Result<PeView> Parse(const MemoryView& dump, Layout layout = Layout::kImage);
+
+    bool Is64() const { return is_64_; }
+    uint16_t GetMachine() const;
+    uint64_t GetImageBase() const;
+    uint32_t GetEntryPointRva() const;
+    uint32_t GetSizeOfImage() const;
+    size_t GetSectionCount() const { return section_count_; }
+    PeSectionHeader GetSection(size_t index) const;
+
+    bool GetDataDirectory(size_t index, uint32_t& rva, uint32_t& size) const;
+    bool RvaToOffset(uint32_t rva, size_t& offset) const;
+
+    void ForEachImport(const std::function<void(const PeImportEntry&)>& callback) const;
+    void ForEachExport(const std::function<void(const PeExportEntry&)>& callback) const;
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    Layout layout_ = Layout::kImage;
+    size_t nt_offset_ = 0;
+    size_t optional_offset_ = 0;
+    size_t section_offset_ = 0;
+    size_t section_count_ = 0;
+    uint32_t directory_count_ = 0;
+    bool is_64_ = false;
+
+    std::string_view CStringAtRva(uint32_t rva) const;
+};
+
+struct ElfSectionHeader {
+    std::string_view name;
+    uint32_t type = 0;
+    uint64_t flags = 0;
+    uint64_t address = 0;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    uint32_t link = 0;
+    uint64_t entry_size = 0;
+};
+
+struct ElfSymbol {
+    std::string_view name;
+    uint64_t value = 0;
+    uint64_t size = 0;
+    uint8_t info = 0;
+    uint16_t section_index = 0;
+};
+
+/**
+ * @brief Zero-allocation view of a little-endian ELF file
+ *
+ * Section headers are optional at run time (loaded segments usually do not
+ * carry them); GetSectionCount() is 0 when the table lies outside the dump.
+ */
+class ElfView {
+public:
+    static constexpr uint32_t kSymbolTable = 2;   // SHT_SYMTAB
+    static constexpr uint32_t kDynamicSymbols = 11; // SHT_DYNSYM
+
+    ElfView() = default;
+
+    static Result<ElfView> Parse(const MemoryView& dump);
+
+    bool Is64() const { return is_64_; }
+    uint16_t GetType() const;
+    uint16_t GetMachine() const;
+    uint64_t GetEntryPoint() const;
+    size_t GetProgramHeaderCount() const;
+    size_t GetSectionCount() const { return section_count_; }
+    ElfSectionHeader GetSection(size_t index) const;
+
+    // Symbols of every SHT_SYMTAB and SHT_DYNSYM section, in table order
+    void ForEachSymbol(const std::function<void(const ElfSymbol&)>& callback) const;
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool is_64_ = false;
+    size_t section_offset_ = 0;
+    size_t section_entry_size_ = 0;
+    size_t section_count_ = 0;
+    size_t names_offset_ = 0;  // Section name string table
+    size_t names_size_ = 0;
+
+    ElfSectionHeader ReadSection(size_t index) const;
+    std::string_view CStringAt(size_t table_offset, size_t table_size, size_t index) const;
+};
+
+struct BinarySection {
+    std::string name;
+    uint64_t address = 0;
+    uint64_t size = 0;
+    uint64_t flags = 0;
+};
+
+struct BinarySymbol {
+    std::string module;  // Importing DLL for PE imports, empty otherwise
+    std::string name;
+    uint64_t address = 0;  // Export RVA, IAT slot RVA or ELF symbol value
+    uint16_t ordinal = 0;
+};
+
+/**
+ * @brief Typed tables of one module, built once from a PeView or ElfView
+ */
+struct BinaryModuleInfo {
+    std::string format;  // "PE" or "ELF"
+    bool is_64 = false;
+    uint16_t machine = 0;
+    uint64_t image_base = 0;
+    uint64_t entry_point = 0;
+    std::vector<BinarySection> sections;
+    std::vector<BinarySymbol> imports;
+    std::vector<BinarySymbol> exports;  // ELF: defined symbols
+
+    static Result<BinaryModuleInfo> Build(const MemoryView& dump);
+};
+
+} // namespace mcp
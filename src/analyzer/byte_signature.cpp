@@ -0,0 +1,235 @@
+#include "byte_signature.hpp"
+#include <cctype>
+#include <cstdio>
+
+namespace mcp {
+
+namespace {
+
+int HexDigitValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool ParseJumpBound(const std::string& text, size_t& value) {
+    if (text.empty() || text.size() > 6) {
+        return false;
+    }
+    value = 0;
+    for (char c : text) {
+        if (!std::isdigit(static_cast<unsigned char>(c))) {
+            return false;
+        }
+        value = value * 10 + static_cast<size_t>(c - '0');
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+ByteSignature::ByteSignature(const std::vector<uint8_t>& bytes) {
+    if (!bytes.empty()) {
+        Piece piece;
+        piece.values = bytes;
+        piece.masks.assign(bytes.size(), 0xFF);
+        pieces_.push_back(std::move(piece));
+    }
+}
+
+ByteSignature::ByteSignature(const std::vector<uint8_t>& values, const std::vector<uint8_t>& masks) {
+    if (values.empty()) {
+        return;
+    }
+
+    Piece piece;
+    piece.values.reserve(values.size());
+    piece.masks.reserve(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        const uint8_t mask = i < masks.size() ? masks[i] : 0xFF; // Missing mask entries are exact
+        piece.values.push_back(values[i] & mask);
+        piece.masks.push_back(mask);
+    }
+    pieces_.push_back(std::move(piece));
+}
+
+Result<ByteSignature> ByteSignature::Parse(const std::string& text) {
+    ByteSignature signature;
+    Piece current;
+    size_t pending_min = 0;
+    size_t pending_max = 0;
+    bool jump_pending = false;
+
+    size_t i = 0;
+    while (i < text.size()) {
+        const char c = text[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+            continue;
+        }
+
+        if (c == '[') {
+            const size_t close = text.find(']', i);
+            if (close == std::string::npos) {
+                return Result<ByteSignature>::Error("Unterminated jump in signature");
+            }
+            if (current.values.empty() || jump_pending) {
+                return Result<ByteSignature>::Error("Jump must follow a byte in signature");
+            }
+
+            const std::string range = text.substr(i + 1, close - i - 1);
+            const size_t dash = range.find('-');
+            size_t min_gap = 0;
+            size_t max_gap = 0;
+            const bool valid = dash == std::string::npos
+                ? ParseJumpBound(range, min_gap) && ParseJumpBound(range, max_gap)
+                : ParseJumpBound(range.substr(0, dash), min_gap) && ParseJumpBound(range.substr(dash + 1), max_gap);
+            if (!valid || min_gap > max_gap || max_gap > kMaxJump) {
+                return Result<ByteSignature>::Error("Invalid jump range in signature: [" + range + "]");
+            }
+
+            signature.pieces_.push_back(std::move(current));
+            current = Piece();
+            pending_min = min_gap;
+            pending_max = max_gap;
+            jump_pending = true;
+            i = close + 1;
+            continue;
+        }
+
+        if (i + 1 >= text.size()) {
+            return Result<ByteSignature>::Error("Truncated byte in signature");
+        }
+
+        const char high = text[i];
+        const char low = text[i + 1];
+        uint8_t value = 0;
+        uint8_t mask = 0;
+
+        if (high != '?') {
+            const int digit = HexDigitValue(high);
+            if (digit < 0) {
+                return Result<ByteSignature>::Error(std::string("Invalid character in signature: ") + high);
+            }
+            value |= static_cast<uint8_t>(digit << 4);
+            mask |= 0xF0;
+        }
+        if (low != '?') {
+            const int digit = HexDigitValue(low);
+            if (digit < 0) {
+                return Result<ByteSignature>::Error(std::string("Invalid character in signature: ") + low);
+            }
+            value |= static_cast<uint8_t>(digit);
+            mask |= 0x0F;
+        }
+
+        if (jump_pending) {
+            current.min_gap = pending_min;
+            current.max_gap = pending_max;
+            jump_pending = false;
+        }
+        current.values.push_back(value);
+        current.masks.push_back(mask);
+        i += 2;
+    }
+
+    if (jump_pending) {
+        return Result<ByteSignature>::Error("Signature cannot end with a jump");
+    }
+    if (current.values.empty()) {
+        return Result<ByteSignature>::Error("Empty signature");
+    }
+
+    signature.pieces_.push_back(std::move(current));
+    return Result<ByteSignature>::Success(std::move(signature));
+}
+
+Result<ByteSignature> ByteSignature::FromPieces(std::vector<Piece> pieces) {
+    if (pieces.empty()) {
+        return Result<ByteSignature>::Error("Empty signature");
+    }
+    for (size_t p = 0; p < pieces.size(); ++p) {
+        const Piece& piece = pieces[p];
+        if (piece.values.empty() || piece.masks.size() != piece.values.size()) {
+            return Result<ByteSignature>::Error("Invalid piece in signature");
+        }
+        if (piece.min_gap > piece.max_gap || piece.max_gap > kMaxJump || (p == 0 && piece.max_gap != 0)) {
+            return Result<ByteSignature>::Error("Invalid jump range in signature");
+        }
+        for (size_t i = 0; i < piece.values.size(); ++i) {
+            if ((piece.values[i] & ~piece.masks[i]) != 0) {
+                return Result<ByteSignature>::Error("Masked bits set in signature");
+            }
+        }
+    }
+
+    ByteSignature signature;
+    signature.pieces_ = std::move(pieces);
+    return Result<ByteSignature>::Success(std::move(signature));
+}
+
+bool ByteSignature::IsExact() const {
+    if (pieces_.size() != 1) {
+        return false;
+    }
+    for (uint8_t mask : pieces_[0].masks) {
+        if (mask != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t ByteSignature::GetElementCount() const {
+    size_t count = 0;
+    for (const auto& piece : pieces_) {
+        count += piece.values.size();
+    }
+    return count;
+}
+
+size_t ByteSignature::GetMinLength() const {
+    size_t length = 0;
+    for (const auto& piece : pieces_) {
+        length += piece.min_gap + piece.values.size();
+    }
+    return length;
+}
+
+size_t ByteSignature::GetMaxLength() const {
+    size_t length = 0;
+    for (const auto& piece : pieces_) {
+        length += piece.max_gap + piece.values.size();
+    }
+    return length;
+}
+
+std::string ByteSignature::ToString() const {
+    static const char kDigits[] = "0123456789ABCDEF";
+    std::string text;
+
+    for (const auto& piece : pieces_) {
+        if (piece.max_gap != 0) {
+            char jump[32];
+            if (piece.min_gap == piece.max_gap) {
+                std::snprintf(jump, sizeof(jump), "[%zu] ", piece.min_gap);
+            } else {
+                std::snprintf(jump, sizeof(jump), "[%zu-%zu] ", piece.min_gap, piece.max_gap);
+            }
+            text += jump;
+        }
+        for (size_t i = 0; i < piece.values.size(); ++i) {
+            text += (piece.masks[i] & 0xF0) ? kDigits[piece.values[i] >> 4] : '?';
+            text += (piece.masks[i] & 0x0F) ? kDigits[piece.values[i] & 0x0F] : '?';
+            text += ' ';
+        }
+    }
+
+    if (!text.empty()) {
+        text.pop_back();
+    }
+    return text;
+}
+
+} // namespace mcp
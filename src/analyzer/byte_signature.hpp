@@ -0,0 +1,60 @@
+#pragma once
+
+#include "mcp/interfaces.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mcp {
+
+/**
+ * @brief Byte signature with masked bytes and bounded jumps
+ *
+ * A signature is a sequence of fixed-length pieces. Each byte in a piece
+ * matches when (byte & mask) == value, so 0xFF is an exact byte, 0xF0 keeps
+ * only the high nibble and 0x00 is a wildcard. Consecutive pieces are
+ * separated by a jump of [min_gap, max_gap] arbitrary bytes.
+ *
+ * Text form (as used in pattern databases):
+ *   "6A 04 68 ?? 1? 00 00 [2-6] E8"
+ *   - "4D"    exact byte
+ *   - "??"    any byte
+ *   - "4?"    high nibble 4, any low nibble ("?D" is the converse)
+ *   - "[n]"   exactly n arbitrary bytes
+ *   - "[n-m]" between n and m arbitrary bytes
+ */
+class ByteSignature {
+public:
+    static constexpr size_t kMaxJump = 4096;
+
+    struct Piece {
+        std::vector<uint8_t> values;
+        std::vector<uint8_t> masks;
+        size_t min_gap = 0;  // Jump preceding this piece (always 0 for the first one)
+        size_t max_gap = 0;
+    };
+
+    ByteSignature() = default;
+    explicit ByteSignature(const std::vector<uint8_t>& bytes);
+    ByteSignature(const std::vector<uint8_t>& values, const std::vector<uint8_t>& masks);
+
+    static Result<ByteSignature> Parse(const std::string& text);
+
+    // Rebuilds a signature from GetPieces() output, e.g. when read back from a file
+    static Result<ByteSignature> FromPieces(std::vector<Piece> pieces);
+
+    const std::vector<Piece>& GetPieces() const { return pieces_; }
+    bool IsEmpty() const { return pieces_.empty(); }
+    bool IsExact() const;
+    size_t GetElementCount() const;
+    size_t GetMinLength() const;
+    size_t GetMaxLength() const;
+
+    std::string ToString() const;
+
+private:
+    std::vector<Piece> pieces_;
+};
+
+} // namespace mcp
@@ -1,12 +1,117 @@
 #include "dump_analyzer.hpp"
+#include "mcp/executor.hpp"
+#include "mcp/hex_codec.hpp"
 #include <algorithm>
+#include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <regex>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <tuple>
+#include <thread>
 
 namespace mcp {
 
+namespace {
+
+std::string TrimField(const std::string& field) {
+    const auto begin = field.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    const auto end = field.find_last_not_of(" \t\r");
+    return field.substr(begin, end - begin + 1);
+}
+
+constexpr size_t kSnapshotPageSize = 4096;
+
+uint64_t HashPage(const uint8_t* data, size_t size) {
+    uint64_t hash = 0x9E3779B97F4A7C15ull ^ size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 32;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ data[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+// Sort [begin, end) ranges and join the ones that overlap or touch
+void MergeRanges(std::vector<std::pair<size_t, size_t>>& ranges) {
+    std::sort(ranges.begin(), ranges.end());
+    size_t out = 0;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        if (out > 0 && ranges[i].first <= ranges[out - 1].second) {
+            ranges[out - 1].second = std::max(ranges[out - 1].second, ranges[i].second);
+        } else {
+            ranges[out++] = ranges[i];
+        }
+    }
+    ranges.resize(out);
+}
+
+void DiffPatterns(const std::vector<PatternMatch>& before, const std::vector<PatternMatch>& after,
+                  std::vector<PatternMatch>& removed, std::vector<PatternMatch>& added) {
+    auto key = [](const PatternMatch* m) { return std::tie(m->address, m->size, m->pattern_name, m->description); };
+    auto sorted = [&](const std::vector<PatternMatch>& matches) {
+        std::vector<const PatternMatch*> order;
+        order.reserve(matches.size());
+        for (const auto& match : matches) {
+            order.push_back(&match);
+        }
+        std::sort(order.begin(), order.end(), [&](const PatternMatch* a, const PatternMatch* b) {
+            return key(a) < key(b);
+        });
+        return order;
+    };
+
+    const auto old_order = sorted(before);
+    const auto new_order = sorted(after);
+    size_t o = 0;
+    size_t n = 0;
+    while (o < old_order.size() || n < new_order.size()) {
+        if (n == new_order.size() || (o < old_order.size() && key(old_order[o]) < key(new_order[n]))) {
+            removed.push_back(*old_order[o++]);
+        } else if (o == old_order.size() || key(new_order[n]) < key(old_order[o])) {
+            added.push_back(*new_order[n++]);
+        } else {
+            ++o;
+            ++n;
+        }
+    }
+}
+
+// Both sides in the order BuildStringMatches() produces: address, then ASCII before wide
+template<typename OldIterator, typename NewIterator>
+void DiffStrings(OldIterator old_begin, OldIterator old_end, NewIterator new_begin, NewIterator new_end,
+                 std::vector<StringMatch>& removed, std::vector<StringMatch>& added) {
+    auto before = [](const StringMatch& a, const StringMatch& b) {
+        return a.address != b.address ? a.address < b.address : a.is_wide < b.is_wide;
+    };
+    while (old_begin != old_end || new_begin != new_end) {
+        if (new_begin == new_end || (old_begin != old_end && before(*old_begin, *new_begin))) {
+            removed.push_back(*old_begin++);
+        } else if (old_begin == old_end || before(*new_begin, *old_begin)) {
+            added.push_back(*new_begin++);
+        } else {
+            if (old_begin->value != new_begin->value) {
+                removed.push_back(*old_begin);
+                added.push_back(*new_begin);
+            }
+            ++old_begin;
+            ++new_begin;
+        }
+    }
+}
+
+} // anonymous namespace
+
 DumpAnalyzer::DumpAnalyzer(std::shared_ptr<ILogger> logger) 
     : logger_(logger) {
     
@@ -25,6 +130,10 @@ DumpAnalyzer::~DumpAnalyzer() {
 }
 
 Result<std::vector<std::string>> DumpAnalyzer::AnalyzePatterns(const MemoryDump& dump) {
+    return AnalyzePatterns(MemoryView::Of(dump));
+}
+
+Result<std::vector<std::string>> DumpAnalyzer::AnalyzePatterns(const MemoryView& dump) {
     auto pattern_result = SearchPatterns(dump);
     if (!pattern_result.IsSuccess()) {
         return Result<std::vector<std::string>>::Error(pattern_result.Error());
@@ -42,6 +151,10 @@ Result<std::vector<std::string>> DumpAnalyzer::AnalyzePatterns(const MemoryDump&
 }
 
 Result<std::vector<std::string>> DumpAnalyzer::FindStrings(const MemoryDump& dump) {
+    return FindStrings(MemoryView::Of(dump));
+}
+
+Result<std::vector<std::string>> DumpAnalyzer::FindStrings(const MemoryView& dump) {
     auto string_result = ExtractStrings(dump);
     if (!string_result.IsSuccess()) {
         return Result<std::vector<std::string>>::Error(string_result.Error());
@@ -58,15 +171,30 @@ Result<std::vector<std::string>> DumpAnalyzer::FindStrings(const MemoryDump& dum
 }
 
 Result<std::unordered_map<std::string, std::string>> DumpAnalyzer::ExtractMetadata(const MemoryDump& dump) {
+    return ExtractMetadata(MemoryView::Of(dump));
+}
+
+Result<std::unordered_map<std::string, std::string>> DumpAnalyzer::ExtractMetadata(const MemoryView& dump) {
+    ByteHistogram histogram{};
+    CountBytes(dump.data, dump.size, histogram);
+    return ExtractMetadata(dump, histogram);
+}
+
+Result<std::unordered_map<std::string, std::string>> DumpAnalyzer::ExtractMetadata(const MemoryView& dump,
+                                                                                   const ByteHistogram& histogram) {
     std::unordered_map<std::string, std::string> metadata;
     
-    // Basic metadata
-    metadata["size"] = std::to_string(dump.size);
+    // Basic metadata; the histogram covers the whole dump even when dump is only its head
+    uint64_t total_size = 0;
+    for (uint64_t count : histogram) {
+        total_size += count;
+    }
+    metadata["size"] = std::to_string(total_size);
     metadata["base_address"] = "0x" + std::to_string(dump.base_address);
     metadata["module"] = dump.module_name;
     
     // Detect file format based on magic bytes
-    if (dump.data.size() >= 2) {
+    if (dump.size >= 2) {
         if (dump.data[0] == 'M' && dump.data[1] == 'Z') {
             metadata["format"] = "PE";
             auto pe_metadata = ExtractPEMetadata(dump);
@@ -75,7 +203,7 @@ Result<std::unordered_map<std::string, std::string>> DumpAnalyzer::ExtractMetada
                     metadata["pe_" + metadata_pair.first] = metadata_pair.second;
                 }
             }
-        } else if (dump.data.size() >= 4 && 
+        } else if (dump.size >= 4 && 
                    dump.data[0] == 0x7F && dump.data[1] == 'E' && 
                    dump.data[2] == 'L' && dump.data[3] == 'F') {
             metadata["format"] = "ELF";
@@ -91,7 +219,7 @@ Result<std::unordered_map<std::string, std::string>> DumpAnalyzer::ExtractMetada
     }
     
     // Add generic analysis results
-    auto generic_metadata = ExtractGenericMetadata(dump);
+    auto generic_metadata = ExtractGenericMetadata(histogram);
     if (generic_metadata.IsSuccess()) {
         for (const auto& metadata_pair : generic_metadata.Value()) {
             metadata[metadata_pair.first] = metadata_pair.second;
@@ -102,6 +230,10 @@ Result<std::unordered_map<std::string, std::string>> DumpAnalyzer::ExtractMetada
 }
 
 Result<std::vector<PatternMatch>> DumpAnalyzer::FindMalwareSignatures(const MemoryDump& dump) {
+    return FindMalwareSignatures(MemoryView::Of(dump));
+}
+
+Result<std::vector<PatternMatch>> DumpAnalyzer::FindMalwareSignatures(const MemoryView& dump) {
     std::vector<PatternMatch> malware_matches;
     
     auto all_matches_result = SearchPatterns(dump);
@@ -122,36 +254,30 @@ Result<std::vector<PatternMatch>> DumpAnalyzer::FindMalwareSignatures(const Memo
 }
 
 Result<std::vector<StringMatch>> DumpAnalyzer::ExtractStrings(const MemoryDump& dump, bool include_wide) {
-    std::vector<StringMatch> all_strings;
-    
-    // Extract ASCII strings
-    auto ascii_result = FindAsciiStrings(dump);
-    if (ascii_result.IsSuccess()) {
-        for (auto& str_match : ascii_result.Value()) {
-            all_strings.push_back(str_match);
-        }
-    }
-    
-    // Extract Unicode strings if requested
-    if (include_wide) {
-        auto unicode_result = FindUnicodeStrings(dump);
-        if (unicode_result.IsSuccess()) {
-            for (auto& str_match : unicode_result.Value()) {
-                all_strings.push_back(str_match);
-            }
-        }
-    }
-    
-    // Sort by address
-    std::sort(all_strings.begin(), all_strings.end(), 
-              [](const StringMatch& a, const StringMatch& b) {
-                  return a.address < b.address;
-              });
-    
-    return Result<std::vector<StringMatch>>::Success(all_strings);
+    return ExtractStrings(MemoryView::Of(dump), include_wide);
+}
+
+Result<std::vector<StringMatch>> DumpAnalyzer::ExtractStrings(const MemoryView& dump, bool include_wide) {
+    // ASCII and UTF-16LE runs come out of one fused pass over the dump
+    StringRunScanner scanner(4, true, include_wide);
+    scanner.Scan(dump.data, dump.size);
+    scanner.Finish();
+
+    return Result<std::vector<StringMatch>>::Success(
+        BuildStringMatches(dump, scanner.GetAsciiRuns(), scanner.GetWideRuns()));
 }
 
 Result<AnalysisResult> DumpAnalyzer::PerformFullAnalysis(const MemoryDump& dump) {
+    return PerformFullAnalysis(MemoryView::Of(dump));
+}
+
+Result<AnalysisResult> DumpAnalyzer::PerformFullAnalysis(const MemoryView& dump) {
+    const size_t worker_count = GetWorkerThreadCount();
+    const size_t chunk_size = chunk_size_.load();
+    if (worker_count > 1 && dump.size > chunk_size) {
+        return PerformParallelAnalysis(dump, worker_count, chunk_size);
+    }
+
     AnalysisResult result;
     result.timestamp = std::chrono::system_clock::now();
     
@@ -173,6 +299,8 @@ Result<AnalysisResult> DumpAnalyzer::PerformFullAnalysis(const MemoryDump& dump)
         result.metadata = metadata_result.Value();
     }
     
+    AnalyzeEntropy(dump, result);
+    
     if (logger_) {
         logger_->LogFormatted(ILogger::Level::INFO, 
                             "Full analysis completed: %zu patterns, %zu strings", 
@@ -182,15 +310,758 @@ Result<AnalysisResult> DumpAnalyzer::PerformFullAnalysis(const MemoryDump& dump)
     return Result<AnalysisResult>::Success(result);
 }
 
+Result<AnalysisResult> DumpAnalyzer::PerformParallelAnalysis(const MemoryView& dump, size_t worker_count,
+                                                             size_t chunk_size) {
+    AnalysisResult result;
+    result.timestamp = std::chrono::system_clock::now();
+
+    const auto compiled = GetCompiledPatterns();
+    const ChunkResult merged = ScanChunks(*compiled, dump, worker_count, chunk_size);
+
+    result.patterns = BuildPatternMatches(*compiled, dump.base_address, merged.pattern_hits);
+    result.strings = BuildStringMatches(dump, merged.ascii_runs, merged.wide_runs);
+
+    auto metadata_result = ExtractMetadata(dump, merged.histogram);
+    if (metadata_result.IsSuccess()) {
+        result.metadata = metadata_result.Value();
+    }
+
+    AnalyzeEntropy(dump, result);
+
+    if (logger_) {
+        const size_t chunk_count = (dump.size + chunk_size - 1) / chunk_size;
+        logger_->LogFormatted(ILogger::Level::INFO,
+                            "Full analysis completed: %zu patterns, %zu strings (%zu chunks, %zu workers)",
+                            result.patterns.size(), result.strings.size(), chunk_count,
+                            std::min(worker_count, chunk_count));
+    }
+
+    return Result<AnalysisResult>::Success(std::move(result));
+}
+
+DumpAnalyzer::ChunkResult DumpAnalyzer::ScanChunks(const CompiledPatternSet& compiled, const MemoryView& dump,
+                                                   size_t worker_count, size_t chunk_size) const {
+    const size_t size = dump.size;
+    const size_t chunk_count = std::max<size_t>(1, (size + chunk_size - 1) / chunk_size);
+    worker_count = std::max<size_t>(1, std::min(worker_count, chunk_count));
+
+    // Workers pull chunk indices until none are left; each chunk owns the
+    // patterns and strings that start inside it
+    std::vector<ChunkResult> chunks(chunk_count);
+    const auto scan_chunk = [&](size_t index) {
+        const size_t begin = std::min(size, index * chunk_size);
+        AnalyzeChunk(compiled, dump, begin, std::min(size, begin + chunk_size), chunks[index]);
+    };
+
+    if (auto executor = executor_.lock()) {
+        ParallelFor(*executor, chunk_count, worker_count, scan_chunk);
+    } else {
+        std::atomic<size_t> next_chunk{0};
+        auto worker = [&]() {
+            for (size_t index = next_chunk++; index < chunk_count; index = next_chunk++) {
+                scan_chunk(index);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(worker_count - 1);
+        for (size_t t = 1; t < worker_count; ++t) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // Chunks are concatenated in address order, which is exactly the order
+    // the serial scan produces them in
+    if (chunk_count == 1) {
+        return std::move(chunks[0]);
+    }
+    ChunkResult merged;
+    for (const auto& chunk : chunks) {
+        merged.pattern_hits.insert(merged.pattern_hits.end(), chunk.pattern_hits.begin(), chunk.pattern_hits.end());
+        merged.ascii_runs.insert(merged.ascii_runs.end(), chunk.ascii_runs.begin(), chunk.ascii_runs.end());
+        merged.wide_runs.insert(merged.wide_runs.end(), chunk.wide_runs.begin(), chunk.wide_runs.end());
+        for (size_t b = 0; b < merged.histogram.size(); ++b) {
+            merged.histogram[b] += chunk.histogram[b];
+        }
+    }
+    return merged;
+}
+
+void DumpAnalyzer::AnalyzeChunk(const CompiledPatternSet& compiled, const MemoryView& dump,
+                                size_t begin, size_t end, ChunkResult& result) const {
+    const uint8_t* data = dump.data;
+    const size_t size = dump.size;
+
+    // Verification reads past end by up to the longest signature span
+    compiled.matcher.FindMatches(data, size, begin, end, [&](size_t index, size_t offset, size_t length) {
+        result.pattern_hits.push_back({offset, index, length});
+    });
+
+    // Strings: scan the chunk, then keep going past its end until every run
+    // that started inside the chunk has closed
+    StringRunScanner scanner(4, true, true);
+    scanner.Scan(data + begin, end - begin);
+    size_t position = end;
+    while (scanner.GetOpenRunStart() < end - begin && position < size) {
+        const size_t step = std::min<size_t>(4096, size - position);
+        scanner.Scan(data + position, step);
+        position += step;
+    }
+    if (position == size) {
+        scanner.Finish();
+    }
+
+    // A run already open at the chunk start belongs to the previous chunk
+    const bool ascii_continues = begin > 0 && StringRunScanner::IsPrintable(data[begin - 1]);
+    const bool wide_continues = begin >= 2 && StringRunScanner::IsPrintable(data[begin - 2]) && data[begin - 1] == 0;
+
+    for (const auto& run : scanner.GetAsciiRuns()) {
+        if (run.offset >= end - begin || (run.offset == 0 && ascii_continues)) {
+            continue;
+        }
+        result.ascii_runs.push_back({begin + run.offset, run.length, false});
+    }
+    for (const auto& run : scanner.GetWideRuns()) {
+        if (run.offset >= end - begin || (run.offset == 0 && wide_continues)) {
+            continue;
+        }
+        result.wide_runs.push_back({begin + run.offset, run.length, true});
+    }
+
+    CountBytes(data + begin, end - begin, result.histogram);
+}
+
+Result<DumpAnalyzer::StreamSummary> DumpAnalyzer::AnalyzeStream(IDumpChunkSource& source,
+                                                                const StreamCallbacks& callbacks) {
+    // Enough of the dump start for magic-byte format detection
+    constexpr size_t kHeaderBytes = 4096;
+
+    const auto compiled = GetCompiledPatterns();
+    const size_t chunk_size = chunk_size_.load();
+    const size_t max_span = compiled->matcher.GetMaxSpan();
+    const uintptr_t base_address = source.GetBaseAddress();
+
+    StreamSummary summary;
+    ByteHistogram histogram{};
+    std::vector<uint8_t> header;
+
+    // window holds stream bytes [window_start, window_start + window.size())
+    std::vector<uint8_t> window;
+    size_t window_start = 0;
+
+    // Pattern matches starting before pattern_from have been reported
+    size_t pattern_from = 0;
+    std::vector<size_t> next_allowed(compiled->entries.size(), 0);
+    std::vector<PatternHit> hits;
+
+    // Completed runs wait here until no open run can start before them
+    StringRunScanner scanner(4, true, true);
+    std::vector<StringRun> ascii_pending;
+    std::vector<StringRun> wide_pending;
+
+    const size_t entropy_window = entropy_window_.load();
+    std::unique_ptr<EntropyMap> entropy;
+    if (entropy_window != 0) {
+        entropy.reset(new EntropyMap(entropy_window, entropy_step_.load(), high_entropy_threshold_.load()));
+    }
+    auto emit_entropy_regions = [&]() {
+        for (const auto& region : entropy->GetRegions()) {
+            if (callbacks.on_pattern) {
+                callbacks.on_pattern(MakeEntropyMatch(base_address, region));
+            }
+            ++summary.pattern_count;
+        }
+        entropy->ClearRegions();
+    };
+
+    auto emit_strings = [&](size_t limit) {
+        size_t a = 0;
+        size_t w = 0;
+        for (;;) {
+            const bool has_ascii = a < ascii_pending.size() && ascii_pending[a].offset < limit;
+            const bool has_wide = w < wide_pending.size() && wide_pending[w].offset < limit;
+            if (!has_ascii && !has_wide) {
+                break;
+            }
+            const bool take_ascii = has_ascii && (!has_wide || ascii_pending[a].offset <= wide_pending[w].offset);
+            const StringRun& run = take_ascii ? ascii_pending[a++] : wide_pending[w++];
+            if (callbacks.on_string) {
+                callbacks.on_string(MakeStringMatch(base_address + run.offset,
+                                                    window.data() + (run.offset - window_start), run));
+            }
+            ++summary.string_count;
+        }
+        ascii_pending.erase(ascii_pending.begin(), ascii_pending.begin() + static_cast<std::ptrdiff_t>(a));
+        wide_pending.erase(wide_pending.begin(), wide_pending.begin() + static_cast<std::ptrdiff_t>(w));
+    };
+
+    bool at_end = false;
+    while (!at_end) {
+        const size_t old_size = window.size();
+        window.resize(old_size + chunk_size);
+        auto read_result = source.Read(window.data() + old_size, chunk_size);
+        if (!read_result.IsSuccess()) {
+            return Result<StreamSummary>::Error("Stream read failed at offset " +
+                                                std::to_string(summary.bytes_processed) + ": " + read_result.Error());
+        }
+
+        const size_t read = read_result.Value();
+        window.resize(old_size + read);
+        at_end = read == 0;
+
+        CountBytes(window.data() + old_size, read, histogram);
+        if (entropy) {
+            entropy->Feed(window.data() + old_size, read);
+            if (at_end) {
+                entropy->Finish();
+            }
+            emit_entropy_regions();
+        }
+        if (header.size() < kHeaderBytes) {
+            const size_t take = std::min(read, kHeaderBytes - header.size());
+            header.insert(header.end(), window.begin() + static_cast<std::ptrdiff_t>(old_size),
+                          window.begin() + static_cast<std::ptrdiff_t>(old_size + take));
+        }
+        summary.bytes_processed += read;
+
+        const size_t window_end = window_start + window.size();
+
+        // A signature starting at s is decided once [s, s + max span) is in the window
+        size_t pattern_to = window_end;
+        if (!at_end) {
+            pattern_to = window_end >= max_span ? std::min(window_end, window_end + 1 - max_span) : 0;
+        }
+        if (pattern_to > pattern_from) {
+            hits.clear();
+            compiled->matcher.FindMatches(window.data(), window.size(),
+                                          pattern_from - window_start, pattern_to - window_start,
+                                          [&](size_t index, size_t offset, size_t length) {
+                                              hits.push_back({window_start + offset, index, length});
+                                          });
+            for (const auto& match : BuildPatternMatches(*compiled, base_address, hits, next_allowed)) {
+                if (callbacks.on_pattern) {
+                    callbacks.on_pattern(match);
+                }
+                ++summary.pattern_count;
+            }
+            pattern_from = pattern_to;
+        }
+
+        // The scanner takes even-sized pieces until the last one; an odd byte waits a round
+        const size_t scanned = scanner.GetPosition();
+        const size_t scan_to = at_end ? window_end : scanned + ((window_end - scanned) & ~static_cast<size_t>(1));
+        scanner.Scan(window.data() + (scanned - window_start), scan_to - scanned);
+        if (at_end) {
+            scanner.Finish();
+        }
+        ascii_pending.insert(ascii_pending.end(), scanner.GetAsciiRuns().begin(), scanner.GetAsciiRuns().end());
+        wide_pending.insert(wide_pending.end(), scanner.GetWideRuns().begin(), scanner.GetWideRuns().end());
+        scanner.ClearRuns();
+        emit_strings(at_end ? window_end : scanner.GetOpenRunStart());
+
+        // Drop bytes no pending signature, open string or held-back odd byte still needs
+        const size_t keep_from = std::min(pattern_from, scanner.GetOpenRunStart());
+        window.erase(window.begin(), window.begin() + static_cast<std::ptrdiff_t>(keep_from - window_start));
+        window_start = keep_from;
+    }
+
+    if (entropy) {
+        summary.entropy = entropy->TakeProfile();
+    }
+
+    const MemoryView header_view(header.data(), header.size(), base_address, source.GetName());
+    auto metadata_result = ExtractMetadata(header_view, histogram);
+    if (metadata_result.IsSuccess()) {
+        summary.metadata = metadata_result.Value();
+    }
+
+    if (logger_) {
+        logger_->LogFormatted(ILogger::Level::INFO,
+                            "Stream analysis completed: %zu bytes, %zu patterns, %zu strings",
+                            summary.bytes_processed, summary.pattern_count, summary.string_count);
+    }
+
+    return Result<StreamSummary>::Success(std::move(summary));
+}
+
+Result<DumpAnalyzer::AnalysisDiff> DumpAnalyzer::AnalyzeIncremental(const MemoryView& dump) {
+    const auto compiled = GetCompiledPatterns();
+
+    // Take the snapshot out while working so other regions are not blocked
+    RegionSnapshot snapshot;
+    {
+        const std::lock_guard<std::mutex> lock(snapshots_mutex_);
+        auto it = snapshots_.find(dump.base_address);
+        if (it != snapshots_.end()) {
+            snapshot = std::move(it->second);
+            snapshots_.erase(it);
+        }
+    }
+
+    AnalysisDiff diff;
+    diff.pages_total = (dump.size + kSnapshotPageSize - 1) / kSnapshotPageSize;
+
+    const bool reusable = !snapshot.page_hashes.empty() && snapshot.size == dump.size &&
+                          snapshot.compiled == compiled &&
+                          snapshot.entropy_window == entropy_window_.load() &&
+                          snapshot.entropy_step == entropy_step_.load() &&
+                          snapshot.entropy_threshold == high_entropy_threshold_.load();
+
+    std::vector<uint64_t> hashes = HashPages(dump);
+    std::vector<std::pair<size_t, size_t>> changed;
+    if (reusable) {
+        for (size_t page = 0; page < hashes.size(); ++page) {
+            if (hashes[page] == snapshot.page_hashes[page]) {
+                continue;
+            }
+            const size_t begin = page * kSnapshotPageSize;
+            const size_t end = std::min(dump.size, begin + kSnapshotPageSize);
+            if (!changed.empty() && changed.back().second == begin) {
+                changed.back().second = end;
+            } else {
+                changed.emplace_back(begin, end);
+            }
+            ++diff.pages_changed;
+        }
+    }
+
+    // Past half the pages a plain scan is cheaper than patching
+    if (!reusable || diff.pages_changed * 2 > diff.pages_total) {
+        AnalyzeFromScratch(dump, compiled, snapshot, diff);
+        diff.pages_changed = reusable ? diff.pages_changed : diff.pages_total;
+    } else if (!changed.empty()) {
+        // A signature may start up to its span before a changed byte; the
+        // window edges are then moved to bytes no string run can cross
+        const size_t margin = compiled->matcher.GetMaxSpan();
+        const uint8_t* data = dump.data;
+        std::vector<std::pair<size_t, size_t>> windows;
+        for (const auto& range : changed) {
+            size_t begin = (range.first > margin ? range.first - margin : 0) & ~static_cast<size_t>(1);
+            while (begin > 0 && StringRunScanner::IsPrintable(data[begin])) {
+                begin -= 2;
+            }
+            size_t end = std::min(dump.size, (range.second + margin + 1) & ~static_cast<size_t>(1));
+            while (end < dump.size && StringRunScanner::IsPrintable(data[end])) {
+                end = std::min(dump.size, end + 2);
+            }
+            windows.emplace_back(begin, end);
+        }
+        MergeRanges(windows);
+
+        for (const auto& window : windows) {
+            RescanRange(dump, snapshot, window.first, window.second, diff);
+            diff.bytes_rescanned += window.second - window.first;
+        }
+
+        UpdateEntropy(dump, snapshot, changed);
+
+        auto patterns = BuildPatternMatches(*compiled, dump.base_address, snapshot.pattern_hits);
+        MergeEntropyMatches(dump.base_address, snapshot.entropy_regions, patterns);
+        DiffPatterns(snapshot.patterns, patterns, diff.removed_patterns, diff.added_patterns);
+        snapshot.patterns = std::move(patterns);
+    }
+    snapshot.page_hashes = std::move(hashes);
+
+    for (const auto& range : changed) {
+        diff.changed_ranges.emplace_back(dump.base_address + range.first, range.second - range.first);
+    }
+
+    ByteHistogram histogram{};
+    CountBytes(dump.data, dump.size, histogram);
+    auto metadata_result = ExtractMetadata(dump, histogram);
+    if (metadata_result.IsSuccess()) {
+        diff.result.metadata = metadata_result.TakeValue();
+    }
+    diff.result.patterns = snapshot.patterns;
+    diff.result.strings = snapshot.strings;
+    diff.result.entropy = snapshot.entropy;
+    diff.result.timestamp = std::chrono::system_clock::now();
+
+    if (logger_) {
+        logger_->LogFormatted(ILogger::Level::DEBUG,
+                            "Incremental analysis of 0x%llx: %zu of %zu pages changed, %zu bytes rescanned%s",
+                            static_cast<unsigned long long>(dump.base_address), diff.pages_changed,
+                            diff.pages_total, diff.bytes_rescanned, diff.full_rescan ? " (full)" : "");
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(snapshots_mutex_);
+        snapshots_[dump.base_address] = std::move(snapshot);
+    }
+    return Result<AnalysisDiff>::Success(std::move(diff));
+}
+
+void DumpAnalyzer::ForgetSnapshot(uintptr_t base_address) {
+    const std::lock_guard<std::mutex> lock(snapshots_mutex_);
+    snapshots_.erase(base_address);
+}
+
+void DumpAnalyzer::ClearSnapshots() {
+    const std::lock_guard<std::mutex> lock(snapshots_mutex_);
+    snapshots_.clear();
+}
+
+void DumpAnalyzer::AnalyzeFromScratch(const MemoryView& dump, const std::shared_ptr<const CompiledPatternSet>& compiled,
+                                      RegionSnapshot& snapshot, AnalysisDiff& diff) const {
+    ChunkResult merged = ScanChunks(*compiled, dump, GetWorkerThreadCount(), chunk_size_.load());
+
+    RegionSnapshot fresh;
+    fresh.size = dump.size;
+    fresh.compiled = compiled;
+    fresh.entropy_window = entropy_window_.load();
+    fresh.entropy_step = entropy_step_.load();
+    fresh.entropy_threshold = high_entropy_threshold_.load();
+    fresh.patterns = BuildPatternMatches(*compiled, dump.base_address, merged.pattern_hits);
+    fresh.pattern_hits = std::move(merged.pattern_hits);
+    fresh.strings = BuildStringMatches(dump, merged.ascii_runs, merged.wide_runs);
+
+    if (fresh.entropy_window != 0) {
+        EntropyMap entropy(fresh.entropy_window, fresh.entropy_step, fresh.entropy_threshold);
+        entropy.Feed(dump.data, dump.size);
+        entropy.Finish();
+        fresh.entropy = entropy.TakeProfile();
+        fresh.entropy_regions = entropy.GetRegions();
+        MergeEntropyMatches(dump.base_address, fresh.entropy_regions, fresh.patterns);
+    }
+
+    // Without an earlier snapshot of the same region there is nothing to diff against
+    if (!snapshot.page_hashes.empty()) {
+        DiffPatterns(snapshot.patterns, fresh.patterns, diff.removed_patterns, diff.added_patterns);
+        DiffStrings(snapshot.strings.cbegin(), snapshot.strings.cend(), fresh.strings.cbegin(), fresh.strings.cend(),
+                    diff.removed_strings, diff.added_strings);
+    }
+
+    snapshot = std::move(fresh);
+    diff.full_rescan = true;
+    diff.bytes_rescanned = dump.size;
+}
+
+void DumpAnalyzer::RescanRange(const MemoryView& dump, RegionSnapshot& snapshot, size_t begin, size_t end,
+                               AnalysisDiff& diff) const {
+    ChunkResult chunk;
+    AnalyzeChunk(*snapshot.compiled, dump, begin, end, chunk);
+
+    // Hits starting in the window are replaced; the order of each pattern's
+    // hits is kept because the window splits every list at the same offsets
+    std::vector<PatternHit> hits;
+    hits.reserve(snapshot.pattern_hits.size() + chunk.pattern_hits.size());
+    for (const auto& hit : snapshot.pattern_hits) {
+        if (hit.offset < begin) {
+            hits.push_back(hit);
+        }
+    }
+    hits.insert(hits.end(), chunk.pattern_hits.begin(), chunk.pattern_hits.end());
+    for (const auto& hit : snapshot.pattern_hits) {
+        if (hit.offset >= end) {
+            hits.push_back(hit);
+        }
+    }
+    snapshot.pattern_hits = std::move(hits);
+
+    // No string crosses the window edges, so old strings are either wholly inside or untouched
+    auto by_address = [](const StringMatch& match, uintptr_t address) { return match.address < address; };
+    auto& strings = snapshot.strings;
+    const auto first = std::lower_bound(strings.begin(), strings.end(), dump.base_address + begin, by_address);
+    const auto last = std::lower_bound(first, strings.end(), dump.base_address + end, by_address);
+
+    std::vector<StringMatch> found = BuildStringMatches(dump, chunk.ascii_runs, chunk.wide_runs);
+    DiffStrings(std::make_move_iterator(first), std::make_move_iterator(last), found.cbegin(), found.cend(),
+                diff.removed_strings, diff.added_strings);
+    const auto position = strings.erase(first, last);
+    strings.insert(position, std::make_move_iterator(found.begin()), std::make_move_iterator(found.end()));
+}
+
+void DumpAnalyzer::UpdateEntropy(const MemoryView& dump, RegionSnapshot& snapshot,
+                                 const std::vector<std::pair<size_t, size_t>>& changed) const {
+    auto& values = snapshot.entropy.values;
+    if (snapshot.entropy_window == 0 || values.empty()) {
+        return;
+    }
+    const size_t window = snapshot.entropy.window_size;
+    const size_t step = snapshot.entropy.step;
+
+    // Window i covers [i * step, i * step + window); collect the ones touching a changed byte
+    std::vector<std::pair<size_t, size_t>> ranges;
+    for (const auto& range : changed) {
+        const size_t first = range.first < window ? 0 : (range.first - window) / step + 1;
+        const size_t last = std::min(values.size(), (range.second + step - 1) / step);
+        if (first < last) {
+            ranges.emplace_back(first, last);
+        }
+    }
+
+    // A region touching a recomputed window may grow, shrink or split, so it
+    // is recomputed whole; beyond it the windows are unchanged and below threshold
+    auto& regions = snapshot.entropy_regions;
+    for (auto& range : ranges) {
+        for (const auto& region : regions) {
+            const size_t first = region.offset / step;
+            const size_t last = (region.offset + region.length - window) / step + 1;
+            if (last >= range.first && first <= range.second) {
+                range.first = std::min(range.first, first);
+                range.second = std::max(range.second, last);
+            }
+        }
+        range.second = std::min(range.second, values.size());
+    }
+    MergeRanges(ranges);
+
+    for (const auto& range : ranges) {
+        const size_t begin = range.first * step;
+        EntropyMap entropy(window, step, snapshot.entropy_threshold);
+        entropy.Feed(dump.data + begin, (range.second - 1) * step + window - begin);
+        entropy.Finish();
+
+        const auto& recomputed = entropy.GetProfile().values;
+        std::copy(recomputed.begin(), recomputed.end(), values.begin() + static_cast<std::ptrdiff_t>(range.first));
+
+        auto by_offset = [](const EntropyRegion& region, size_t offset) { return region.offset < offset; };
+        const auto first = std::lower_bound(regions.begin(), regions.end(), begin, by_offset);
+        const auto last = std::lower_bound(first, regions.end(), range.second * step, by_offset);
+        auto position = regions.erase(first, last);
+        for (EntropyRegion region : entropy.GetRegions()) {
+            region.offset += begin;
+            position = regions.insert(position, region) + 1;
+        }
+    }
+}
+
+std::vector<uint64_t> DumpAnalyzer::HashPages(const MemoryView& dump) {
+    std::vector<uint64_t> hashes((dump.size + kSnapshotPageSize - 1) / kSnapshotPageSize);
+    for (size_t page = 0; page < hashes.size(); ++page) {
+        const size_t begin = page * kSnapshotPageSize;
+        hashes[page] = HashPage(dump.data + begin, std::min(kSnapshotPageSize, dump.size - begin));
+    }
+    return hashes;
+}
+
+void DumpAnalyzer::AnalyzeEntropy(const MemoryView& dump, AnalysisResult& result) const {
+    const size_t window_size = entropy_window_.load();
+    if (window_size == 0) {
+        return;
+    }
+
+    EntropyMap entropy(window_size, entropy_step_.load(), high_entropy_threshold_.load());
+    entropy.Feed(dump.data, dump.size);
+    entropy.Finish();
+    result.entropy = entropy.TakeProfile();
+    MergeEntropyMatches(dump.base_address, entropy.GetRegions(), result.patterns);
+}
+
+void DumpAnalyzer::MergeEntropyMatches(uintptr_t base_address, const std::vector<EntropyRegion>& regions,
+                                       std::vector<PatternMatch>& patterns) const {
+    // Regions join the signature matches in address order, after any match at the same address
+    const size_t signature_count = patterns.size();
+    for (const auto& region : regions) {
+        patterns.push_back(MakeEntropyMatch(base_address, region));
+    }
+    std::inplace_merge(patterns.begin(),
+                       patterns.begin() + static_cast<std::ptrdiff_t>(signature_count),
+                       patterns.end(),
+                       [](const PatternMatch& a, const PatternMatch& b) { return a.address < b.address; });
+}
+
+PatternMatch DumpAnalyzer::MakeEntropyMatch(uintptr_t base_address, const EntropyRegion& region) const {
+    char description[96];
+    std::snprintf(description, sizeof(description), "High entropy region (mean %.2f, peak %.2f bits/byte)",
+                  region.mean_entropy, region.peak_entropy);
+
+    PatternMatch match;
+    match.address = base_address + region.offset;
+    match.size = region.length;
+    match.pattern_name = "high_entropy_region";
+    match.description = description;
+    match.confidence = std::min(1.0, region.mean_entropy / 8.0);
+    match.metadata["mean_entropy"] = std::to_string(region.mean_entropy);
+    match.metadata["peak_entropy"] = std::to_string(region.peak_entropy);
+    return match;
+}
+
+EntropyProfile DumpAnalyzer::ComputeEntropyProfile(const MemoryView& dump, size_t window_size, size_t step) const {
+    EntropyMap entropy(window_size, step, 8.1); // Threshold above the maximum: profile only
+    entropy.Feed(dump.data, dump.size);
+    return entropy.TakeProfile();
+}
+
+void DumpAnalyzer::SetAnalysisConfig(const AnalysisConfig& config) {
+    worker_threads_ = config.worker_threads > 0 ? static_cast<size_t>(config.worker_threads) : 0;
+    // Chunks stay a multiple of 64 bytes so UTF-16 pairs never straddle a chunk start
+    const size_t chunk_size = std::max<size_t>(config.chunk_size_kb, 64) * 1024;
+    chunk_size_ = chunk_size - chunk_size % 64;
+    entropy_window_ = config.entropy_window;
+    entropy_step_ = config.entropy_step;
+    high_entropy_threshold_ = config.high_entropy_threshold;
+}
+
+size_t DumpAnalyzer::GetWorkerThreadCount() const {
+    const size_t configured = worker_threads_.load();
+    if (configured != 0) {
+        return configured;
+    }
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+void DumpAnalyzer::SetTaskExecutor(std::weak_ptr<ITaskExecutor> executor) {
+    executor_ = std::move(executor);
+}
+
+void DumpAnalyzer::LoadPatternDatabase(const std::string& pattern_file) {
+    std::ifstream file(pattern_file);
+    if (!file.is_open()) {
+        if (logger_) {
+            logger_->LogFormatted(ILogger::Level::ERROR, "Cannot open pattern database: %s", pattern_file.c_str());
+        }
+        return;
+    }
+
+    std::vector<Pattern> loaded = ParsePatternDatabase(file, pattern_file);
+
+    {
+        const std::lock_guard<std::mutex> lock(patterns_mutex_);
+        patterns_.insert(patterns_.end(),
+                         std::make_move_iterator(loaded.begin()),
+                         std::make_move_iterator(loaded.end()));
+        compiled_patterns_.reset();
+    }
+
+    if (logger_) {
+        logger_->LogFormatted(ILogger::Level::INFO, "Loaded %zu patterns from %s",
+                            loaded.size(), pattern_file.c_str());
+    }
+}
+
+void DumpAnalyzer::LoadPatternDatabase(const std::string& pattern_file, const std::string& compiled_file) {
+    std::ifstream file(pattern_file, std::ios::binary);
+    if (!file.is_open()) {
+        if (logger_) {
+            logger_->LogFormatted(ILogger::Level::ERROR, "Cannot open pattern database: %s", pattern_file.c_str());
+        }
+        return;
+    }
+    std::ostringstream text;
+    text << file.rdbuf();
+    const std::string source = text.str();
+
+    const std::lock_guard<std::mutex> lock(patterns_mutex_);
+    const size_t base_count = patterns_.size();
+    const uint64_t fingerprint = CompiledPatternDatabase::Fingerprint(patterns_, source);
+
+    auto cached = CompiledPatternDatabase::Open(compiled_file, fingerprint);
+    if (cached.IsSuccess()) {
+        // The cache holds the base patterns too, so it replaces the whole set
+        auto contents = cached.TakeValue();
+        patterns_ = std::move(contents.patterns);
+        compiled_patterns_ = CompilePatterns(&contents.anchors);
+        if (logger_) {
+            logger_->LogFormatted(ILogger::Level::INFO, "Loaded %zu patterns from %s (compiled, %s)",
+                                patterns_.size() - std::min(base_count, patterns_.size()),
+                                pattern_file.c_str(), compiled_file.c_str());
+        }
+        return;
+    }
+    if (logger_) {
+        logger_->LogFormatted(ILogger::Level::DEBUG, "Rebuilding pattern cache: %s", cached.Error().c_str());
+    }
+
+    std::istringstream input(source);
+    std::vector<Pattern> loaded = ParsePatternDatabase(input, pattern_file);
+    patterns_.insert(patterns_.end(),
+                     std::make_move_iterator(loaded.begin()),
+                     std::make_move_iterator(loaded.end()));
+    compiled_patterns_ = CompilePatterns(nullptr);
+
+    auto written = CompiledPatternDatabase::Write(compiled_file, fingerprint, patterns_,
+                                                  compiled_patterns_->matcher.GetAnchors());
+    if (!written.IsSuccess() && logger_) {
+        logger_->LogFormatted(ILogger::Level::WARN, "%s", written.Error().c_str());
+    }
+    if (logger_) {
+        logger_->LogFormatted(ILogger::Level::INFO, "Loaded %zu patterns from %s",
+                            loaded.size(), pattern_file.c_str());
+    }
+}
+
+std::vector<DumpAnalyzer::Pattern> DumpAnalyzer::ParsePatternDatabase(std::istream& input,
+                                                                      const std::string& pattern_file) const {
+    // One pattern per line: name|signature|description. Blank lines and '#' comments are ignored.
+    // Signatures use the ByteSignature text form, e.g. "6A 04 68 ?? 1? 00 00 [2-6] E8".
+    std::vector<Pattern> loaded;
+    std::string line;
+    size_t line_number = 0;
+
+    while (std::getline(input, line)) {
+        ++line_number;
+        const std::string trimmed = TrimField(line);
+        if (trimmed.empty() || trimmed[0] == '#') {
+            continue;
+        }
+
+        const auto first_separator = trimmed.find('|');
+        const auto second_separator = first_separator == std::string::npos
+                                          ? std::string::npos
+                                          : trimmed.find('|', first_separator + 1);
+
+        Pattern pattern;
+        pattern.name = TrimField(trimmed.substr(0, first_separator));
+        if (first_separator == std::string::npos || pattern.name.empty()) {
+            if (logger_) {
+                logger_->LogFormatted(ILogger::Level::WARN, "Skipping malformed pattern at %s:%zu",
+                                    pattern_file.c_str(), line_number);
+            }
+            continue;
+        }
+
+        auto signature = ByteSignature::Parse(
+            trimmed.substr(first_separator + 1, second_separator - first_separator - 1));
+        if (signature.IsError()) {
+            if (logger_) {
+                logger_->LogFormatted(ILogger::Level::WARN, "Skipping pattern '%s' at %s:%zu: %s",
+                                    pattern.name.c_str(), pattern_file.c_str(), line_number,
+                                    signature.Error().c_str());
+            }
+            continue;
+        }
+        pattern.signature = signature.Value();
+
+        if (second_separator != std::string::npos) {
+            pattern.description = TrimField(trimmed.substr(second_separator + 1));
+        }
+        pattern.confidence_threshold = 0.9; // Same threshold as other custom patterns
+        loaded.push_back(std::move(pattern));
+    }
+
+    return loaded;
+}
+
 void DumpAnalyzer::AddCustomPattern(const std::string& name, const std::vector<uint8_t>& pattern, 
                                    const std::string& description) {
+    AddCustomPattern(name, ByteSignature(pattern), description);
+}
+
+void DumpAnalyzer::AddCustomPattern(const std::string& name, const ByteSignature& signature,
+                                   const std::string& description) {
+    if (signature.IsEmpty()) {
+        if (logger_) {
+            logger_->LogFormatted(ILogger::Level::WARN, "Ignoring empty custom pattern: %s", name.c_str());
+        }
+        return;
+    }
+
     Pattern custom_pattern;
     custom_pattern.name = name;
-    custom_pattern.bytes = pattern;
+    custom_pattern.signature = signature;
     custom_pattern.description = description;
     custom_pattern.confidence_threshold = 0.9; // Higher threshold for custom patterns
     
-    patterns_.push_back(custom_pattern);
+    {
+        const std::lock_guard<std::mutex> lock(patterns_mutex_);
+        patterns_.push_back(std::move(custom_pattern));
+        compiled_patterns_.reset();
+    }
     
     if (logger_) {
         logger_->LogFormatted(ILogger::Level::DEBUG, "Added custom pattern: %s", name.c_str());
@@ -198,218 +1069,338 @@ void DumpAnalyzer::AddCustomPattern(const std::string& name, const std::vector<u
 }
 
 size_t DumpAnalyzer::GetPatternCount() const {
+    const std::lock_guard<std::mutex> lock(patterns_mutex_);
     return patterns_.size();
 }
 
-Result<std::vector<StringMatch>> DumpAnalyzer::FindAsciiStrings(const MemoryDump& dump, size_t min_length) {
+Result<std::vector<StringMatch>> DumpAnalyzer::FindAsciiStrings(const MemoryView& dump, size_t min_length) {
+    StringRunScanner scanner(min_length, true, false);
+    scanner.Scan(dump.data, dump.size);
+    scanner.Finish();
+
     std::vector<StringMatch> strings;
+    strings.reserve(scanner.GetAsciiRuns().size());
+    for (const auto& run : scanner.GetAsciiRuns()) {
+        strings.push_back(MakeStringMatch(dump, run));
+    }
     
-    std::string current_string;
-    uintptr_t string_start = 0;
-    
-    for (size_t i = 0; i < dump.data.size(); ++i) {
-        uint8_t byte = dump.data[i];
-        
-        if (IsValidAsciiChar(byte)) {
-            if (current_string.empty()) {
-                string_start = dump.base_address + i;
-            }
-            current_string += static_cast<char>(byte);
-        } else {
-            if (current_string.length() >= min_length) {
-                StringMatch match;
-                match.address = string_start;
-                match.value = current_string;
-                match.encoding = "ASCII";
-                match.length = current_string.length();
-                match.is_wide = false;
-                
-                strings.push_back(match);
-            }
-            current_string.clear();
-        }
+    return Result<std::vector<StringMatch>>::Success(std::move(strings));
+}
+
+Result<std::vector<StringMatch>> DumpAnalyzer::FindUnicodeStrings(const MemoryView& dump, size_t min_length) {
+    StringRunScanner scanner(min_length, false, true);
+    scanner.Scan(dump.data, dump.size);
+    scanner.Finish();
+
+    std::vector<StringMatch> strings;
+    strings.reserve(scanner.GetWideRuns().size());
+    for (const auto& run : scanner.GetWideRuns()) {
+        strings.push_back(MakeStringMatch(dump, run));
     }
     
-    // Handle string at end of data
-    if (current_string.length() >= min_length) {
-        StringMatch match;
-        match.address = string_start;
-        match.value = current_string;
+    return Result<std::vector<StringMatch>>::Success(std::move(strings));
+}
+
+StringMatch DumpAnalyzer::MakeStringMatch(const MemoryView& dump, const StringRun& run) const {
+    return MakeStringMatch(dump.base_address + run.offset, dump.data + run.offset, run);
+}
+
+StringMatch DumpAnalyzer::MakeStringMatch(uintptr_t address, const uint8_t* source, const StringRun& run) const {
+    StringMatch match;
+    match.address = address;
+    match.is_wide = run.is_wide;
+
+    if (run.is_wide) {
+        // Only the low byte of each character is kept; the high byte is zero by construction
+        match.value.resize(run.length);
+        for (size_t i = 0; i < run.length; ++i) {
+            match.value[i] = static_cast<char>(source[i * 2]);
+        }
+        match.encoding = "Unicode";
+        match.length = run.length * 2; // Byte length
+    } else {
+        match.value.assign(reinterpret_cast<const char*>(source), run.length);
         match.encoding = "ASCII";
-        match.length = current_string.length();
-        match.is_wide = false;
-        
-        strings.push_back(match);
+        match.length = run.length;
     }
     
-    return Result<std::vector<StringMatch>>::Success(strings);
+    return match;
 }
 
-Result<std::vector<StringMatch>> DumpAnalyzer::FindUnicodeStrings(const MemoryDump& dump, size_t min_length) {
-    std::vector<StringMatch> strings;
-    
-    std::string current_string;
-    uintptr_t string_start = 0;
+Result<std::vector<PatternMatch>> DumpAnalyzer::SearchPatterns(const MemoryView& dump) {
+    const auto compiled = GetCompiledPatterns();
+
+    // One pass over the dump for all patterns
+    std::vector<PatternHit> hits;
+    compiled->matcher.FindMatches(dump.data, dump.size, 0, dump.size,
+                                  [&](size_t index, size_t offset, size_t length) {
+                                      hits.push_back({offset, index, length});
+                                  });
     
-    for (size_t i = 0; i < dump.data.size() - 1; i += 2) {
-        uint16_t wide_char = *reinterpret_cast<const uint16_t*>(&dump.data[i]);
-        
-        if (IsValidUnicodeChar(wide_char) && wide_char < 256) {
-            if (current_string.empty()) {
-                string_start = dump.base_address + i;
-            }
-            current_string += static_cast<char>(wide_char & 0xFF);
-        } else {
-            if (current_string.length() >= min_length) {
-                StringMatch match;
-                match.address = string_start;
-                match.value = current_string;
-                match.encoding = "Unicode";
-                match.length = current_string.length() * 2; // Byte length
-                match.is_wide = true;
-                
-                strings.push_back(match);
-            }
-            current_string.clear();
+    return Result<std::vector<PatternMatch>>::Success(BuildPatternMatches(*compiled, dump.base_address, hits));
+}
+
+std::vector<PatternMatch> DumpAnalyzer::BuildPatternMatches(const CompiledPatternSet& compiled, uintptr_t base_address,
+                                                            const std::vector<PatternHit>& hits) const {
+    std::vector<size_t> next_allowed(compiled.entries.size(), 0);
+    return BuildPatternMatches(compiled, base_address, hits, next_allowed);
+}
+
+std::vector<PatternMatch> DumpAnalyzer::BuildPatternMatches(const CompiledPatternSet& compiled, uintptr_t base_address,
+                                                            const std::vector<PatternHit>& hits,
+                                                            std::vector<size_t>& next_allowed) const {
+    const auto& entries = compiled.entries;
+
+    // Matches of the same pattern never overlap: after a hit the next one may
+    // only start past its last byte
+    std::vector<PatternHit> accepted;
+    accepted.reserve(hits.size());
+    for (const auto& hit : hits) {
+        if (hit.offset >= next_allowed[hit.index]) {
+            next_allowed[hit.index] = hit.offset + hit.length;
+            accepted.push_back(hit);
         }
     }
-    
-    return Result<std::vector<StringMatch>>::Success(strings);
-}
 
-Result<std::vector<PatternMatch>> DumpAnalyzer::SearchPatterns(const MemoryDump& dump) {
+    // Report in address order; ties keep pattern registration order
+    std::sort(accepted.begin(), accepted.end(), [](const PatternHit& a, const PatternHit& b) {
+        return a.offset != b.offset ? a.offset < b.offset : a.index < b.index;
+    });
+
     std::vector<PatternMatch> matches;
-    
+    matches.reserve(accepted.size());
+    for (const auto& hit : accepted) {
+        const auto& entry = entries[hit.index];
+
+        PatternMatch match;
+        match.address = base_address + hit.offset;
+        match.size = hit.length;
+        match.pattern_name = entry.name;
+        match.description = entry.description;
+        match.confidence = entry.confidence;
+        matches.push_back(std::move(match));
+    }
+
+    return matches;
+}
+
+std::vector<StringMatch> DumpAnalyzer::BuildStringMatches(const MemoryView& dump,
+                                                          const std::vector<StringRun>& ascii_runs,
+                                                          const std::vector<StringRun>& wide_runs) const {
+    // Both lists are already in address order; merge instead of sorting
+    std::vector<StringMatch> strings;
+    strings.reserve(ascii_runs.size() + wide_runs.size());
+
+    size_t a = 0;
+    size_t w = 0;
+    while (a < ascii_runs.size() || w < wide_runs.size()) {
+        const bool take_ascii = w == wide_runs.size() ||
+                                (a < ascii_runs.size() && ascii_runs[a].offset <= wide_runs[w].offset);
+        strings.push_back(MakeStringMatch(dump, take_ascii ? ascii_runs[a++] : wide_runs[w++]));
+    }
+
+    return strings;
+}
+
+std::shared_ptr<const DumpAnalyzer::CompiledPatternSet> DumpAnalyzer::GetCompiledPatterns() {
+    const std::lock_guard<std::mutex> lock(patterns_mutex_);
+    if (!compiled_patterns_) {
+        compiled_patterns_ = CompilePatterns(nullptr);
+    }
+    return compiled_patterns_;
+}
+
+std::shared_ptr<const DumpAnalyzer::CompiledPatternSet>
+DumpAnalyzer::CompilePatterns(const MultiPatternMatcher* cached_anchors) const {
+    // Called with patterns_mutex_ held.
+    // Confidence depends only on the pattern, so patterns that can never reach
+    // their threshold are left out of the automaton altogether
+    std::vector<CompiledPatternSet::Entry> entries;
+    std::vector<ByteSignature> signatures;
     for (const auto& pattern : patterns_) {
-        // Simple pattern search
-        for (size_t i = 0; i <= dump.data.size() - pattern.bytes.size(); ++i) {
-            bool match_found = true;
-            
-            for (size_t j = 0; j < pattern.bytes.size(); ++j) {
-                if (dump.data[i + j] != pattern.bytes[j]) {
-                    match_found = false;
-                    break;
-                }
-            }
-            
-            if (match_found) {
-                double confidence = CalculatePatternConfidence(pattern, dump, i);
-                
-                if (confidence >= pattern.confidence_threshold) {
-                    PatternMatch match;
-                    match.address = dump.base_address + i;
-                    match.size = pattern.bytes.size();
-                    match.pattern_name = pattern.name;
-                    match.description = pattern.description;
-                    match.confidence = confidence;
-                    
-                    matches.push_back(match);
-                }
-                
-                // Skip ahead to avoid overlapping matches
-                i += pattern.bytes.size() - 1;
-            }
+        const double confidence = CalculatePatternConfidence(pattern);
+        if (confidence < pattern.confidence_threshold) {
+            continue;
         }
+        entries.push_back({pattern.name, pattern.description, confidence});
+        signatures.push_back(pattern.signature);
     }
-    
-    return Result<std::vector<PatternMatch>>::Success(matches);
+
+    auto compiled = cached_anchors
+        ? std::make_shared<const CompiledPatternSet>(std::move(entries), signatures, *cached_anchors)
+        : std::make_shared<const CompiledPatternSet>(std::move(entries), signatures);
+
+    if (logger_) {
+        logger_->LogFormatted(ILogger::Level::DEBUG,
+                            "Compiled %zu of %zu patterns into %zu matcher states (%zu unanchored)",
+                            compiled->entries.size(), patterns_.size(),
+                            compiled->matcher.GetStateCount(),
+                            compiled->matcher.GetUnanchoredCount());
+    }
+
+    return compiled;
 }
 
-double DumpAnalyzer::CalculatePatternConfidence(const Pattern& pattern, const MemoryDump& /* dump */, size_t /* offset */) {
+double DumpAnalyzer::CalculatePatternConfidence(const Pattern& pattern) const {
     // Simple confidence calculation based on pattern rarity
     double base_confidence = 0.8;
     
-    // Longer patterns get higher confidence
-    if (pattern.bytes.size() > 8) {
+    // Longer patterns get higher confidence (jumps do not count)
+    const size_t element_count = pattern.signature.GetElementCount();
+    if (element_count > 8) {
         base_confidence += 0.1;
     }
     
-    // Patterns with common bytes get lower confidence
+    // Patterns with common bytes get lower confidence; masked bytes count as common
     size_t common_bytes = 0;
-    for (uint8_t byte : pattern.bytes) {
-        if (byte == 0x00 || byte == 0xFF || byte == 0x90) { // NOP, null, etc.
-            common_bytes++;
+    for (const auto& piece : pattern.signature.GetPieces()) {
+        for (size_t i = 0; i < piece.values.size(); ++i) {
+            const uint8_t byte = piece.values[i];
+            if (piece.masks[i] != 0xFF ||
+                byte == 0x00 || byte == 0xFF || byte == 0x90) { // NOP, null, etc.
+                common_bytes++;
+            }
         }
     }
     
-    if (common_bytes > pattern.bytes.size() / 2) {
+    if (common_bytes > element_count / 2) {
         base_confidence -= 0.2;
     }
     
     return std::max(0.0, std::min(1.0, base_confidence));
 }
 
-Result<std::unordered_map<std::string, std::string>> DumpAnalyzer::ExtractPEMetadata(const MemoryDump& dump) {
+Result<std::shared_ptr<const BinaryModuleInfo>> DumpAnalyzer::GetModuleInfo(const MemoryView& dump) {
+    // FNV-1a over the headers; a module reloaded at the same base with other contents misses
+    uint64_t fingerprint = 1469598103934665603ull;
+    const size_t fingerprint_size = std::min<size_t>(dump.size, 4096);
+    for (size_t i = 0; i < fingerprint_size; ++i) {
+        fingerprint = (fingerprint ^ dump.data[i]) * 1099511628211ull;
+    }
+
+    const std::string key = dump.module_name + ":" + std::to_string(dump.base_address);
+    {
+        const std::lock_guard<std::mutex> lock(module_cache_mutex_);
+        auto it = module_cache_.find(key);
+        if (it != module_cache_.end() && it->second.size == dump.size && it->second.fingerprint == fingerprint) {
+            return Result<std::shared_ptr<const BinaryModuleInfo>>::Success(it->second.info);
+        }
+    }
+
+    // Parse outside the lock; two racing misses build the same tables and the last one wins
+    auto info_result = BinaryModuleInfo::Build(dump);
+    if (!info_result.IsSuccess()) {
+        return Result<std::shared_ptr<const BinaryModuleInfo>>::Error(info_result.Error());
+    }
+    auto info = std::make_shared<const BinaryModuleInfo>(info_result.TakeValue());
+
+    const std::lock_guard<std::mutex> lock(module_cache_mutex_);
+    module_cache_[key] = ModuleCacheEntry{dump.size, fingerprint, info};
+    return Result<std::shared_ptr<const BinaryModuleInfo>>::Success(std::move(info));
+}
+
+void DumpAnalyzer::ClearModuleCache() {
+    const std::lock_guard<std::mutex> lock(module_cache_mutex_);
+    module_cache_.clear();
+}
+
+Result<std::unordered_map<std::string, std::string>> DumpAnalyzer::ExtractPEMetadata(const MemoryView& dump) {
     std::unordered_map<std::string, std::string> metadata;
     
-    if (dump.data.size() < 64) {
+    if (dump.size < 64) {
         return Result<std::unordered_map<std::string, std::string>>::Error("Data too small for PE analysis");
     }
     
-    // Basic PE header analysis (stub implementation)
     metadata["signature"] = "MZ";
     metadata["type"] = "PE";
+
+    auto info_result = GetModuleInfo(dump);
+    if (!info_result.IsSuccess()) {
+        metadata["error"] = info_result.Error();
+        return Result<std::unordered_map<std::string, std::string>>::Success(std::move(metadata));
+    }
+    const BinaryModuleInfo& info = *info_result.Value();
+
+    char buffer[32];
+    metadata["type"] = info.is_64 ? "PE32+" : "PE32";
+    std::snprintf(buffer, sizeof(buffer), "0x%04x", info.machine);
+    metadata["machine"] = buffer;
+    std::snprintf(buffer, sizeof(buffer), "0x%llx", static_cast<unsigned long long>(info.image_base));
+    metadata["image_base"] = buffer;
+    std::snprintf(buffer, sizeof(buffer), "0x%llx", static_cast<unsigned long long>(info.entry_point));
+    metadata["entry_point"] = buffer;
+    metadata["sections"] = std::to_string(info.sections.size());
+    metadata["imports"] = std::to_string(info.imports.size());
+    metadata["exports"] = std::to_string(info.exports.size());
     
     return Result<std::unordered_map<std::string, std::string>>::Success(std::move(metadata)); // ОПТИМИЗАЦИЯ: move
 }
 
-Result<std::unordered_map<std::string, std::string>> DumpAnalyzer::ExtractELFMetadata(const MemoryDump& dump) {
+Result<std::unordered_map<std::string, std::string>> DumpAnalyzer::ExtractELFMetadata(const MemoryView& dump) {
     std::unordered_map<std::string, std::string> metadata;
     
-    if (dump.data.size() < 16) {
+    if (dump.size < 16) {
         return Result<std::unordered_map<std::string, std::string>>::Error("Data too small for ELF analysis");
     }
     
-    // Basic ELF header analysis (stub implementation)
     metadata["signature"] = "ELF";
     metadata["type"] = "ELF";
+
+    auto info_result = GetModuleInfo(dump);
+    if (!info_result.IsSuccess()) {
+        metadata["error"] = info_result.Error();
+        return Result<std::unordered_map<std::string, std::string>>::Success(std::move(metadata));
+    }
+    const BinaryModuleInfo& info = *info_result.Value();
+
+    char buffer[32];
+    metadata["type"] = info.is_64 ? "ELF64" : "ELF32";
+    std::snprintf(buffer, sizeof(buffer), "0x%04x", info.machine);
+    metadata["machine"] = buffer;
+    std::snprintf(buffer, sizeof(buffer), "0x%llx", static_cast<unsigned long long>(info.entry_point));
+    metadata["entry_point"] = buffer;
+    metadata["sections"] = std::to_string(info.sections.size());
+    metadata["symbols"] = std::to_string(info.imports.size() + info.exports.size());
     
     return Result<std::unordered_map<std::string, std::string>>::Success(std::move(metadata)); // ОПТИМИЗАЦИЯ: move
 }
 
-Result<std::unordered_map<std::string, std::string>> DumpAnalyzer::ExtractGenericMetadata(const MemoryDump& dump) {
+Result<std::unordered_map<std::string, std::string>> DumpAnalyzer::ExtractGenericMetadata(const ByteHistogram& histogram) {
     std::unordered_map<std::string, std::string> metadata;
     
-    // Calculate entropy
-    std::vector<size_t> byte_counts(256, 0);
-    for (uint8_t byte : dump.data) {
-        byte_counts[byte]++;
+    uint64_t total = 0;
+    for (uint64_t count : histogram) {
+        total += count;
+    }
+    if (total == 0) {
+        return Result<std::unordered_map<std::string, std::string>>::Success(std::move(metadata));
     }
     
-    double entropy = 0.0;
-    for (size_t count : byte_counts) {
-        if (count > 0) {
-            double probability = static_cast<double>(count) / dump.data.size();
-            entropy -= probability * (std::log(probability) / std::log(2.0));
+    // Calculate entropy: H = log2(N) - sum(c * log2(c)) / N
+    double weighted = 0.0;
+    for (uint64_t count : histogram) {
+        if (count > 1) {
+            weighted += static_cast<double>(count) * std::log2(static_cast<double>(count));
         }
     }
+    const double entropy = std::max(0.0, std::log2(static_cast<double>(total)) - weighted / total);
     
     metadata["entropy"] = std::to_string(entropy);
     
     // Count null bytes
-    size_t null_bytes = byte_counts[0];
-    metadata["null_byte_percentage"] = std::to_string((null_bytes * 100.0) / dump.data.size());
+    metadata["null_byte_percentage"] = std::to_string((histogram[0] * 100.0) / total);
     
     return Result<std::unordered_map<std::string, std::string>>::Success(std::move(metadata)); // ОПТИМИЗАЦИЯ: move
 }
 
-bool DumpAnalyzer::IsValidAsciiChar(uint8_t c) const {
-    return (c >= 32 && c <= 126) || c == '\t' || c == '\n' || c == '\r';
-}
-
-bool DumpAnalyzer::IsValidUnicodeChar(uint16_t c) const {
-    return c > 0 && c < 256 && IsValidAsciiChar(static_cast<uint8_t>(c));
+void DumpAnalyzer::CountBytes(const uint8_t* data, size_t size, ByteHistogram& histogram) {
+    for (size_t i = 0; i < size; ++i) {
+        histogram[data[i]]++;
+    }
 }
 
 std::string DumpAnalyzer::BytesToHex(const std::vector<uint8_t>& bytes) const {
-    std::ostringstream hex_stream;
-    hex_stream << std::hex << std::setfill('0');
-    
-    for (uint8_t byte : bytes) {
-        hex_stream << std::setw(2) << static_cast<int>(byte);
-    }
-    
-    return hex_stream.str();
+    return HexEncode(bytes);
 }
 
 void DumpAnalyzer::LoadBuiltinPatterns() {
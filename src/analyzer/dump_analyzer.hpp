@@ -1,8 +1,21 @@
 #pragma once
 
 #include "mcp/interfaces.hpp"
+#include "mcp/memory_view.hpp"
 #include "mcp/types.hpp"
+#include "binary_view.hpp"
+#include "byte_signature.hpp"
+#include "dump_source.hpp"
+#include "entropy_map.hpp"
+#include "pattern_database.hpp"
+#include "pattern_matcher.hpp"
+#include "string_scanner.hpp"
+#include <array>
+#include <atomic>
+#include <functional>
+#include <istream>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -20,44 +33,241 @@ public:
     Result<std::vector<std::string>> AnalyzePatterns(const MemoryDump& dump) override;
     Result<std::vector<std::string>> FindStrings(const MemoryDump& dump) override;
     Result<std::unordered_map<std::string, std::string>> ExtractMetadata(const MemoryDump& dump) override;
+    Result<std::vector<std::string>> AnalyzePatterns(const MemoryView& dump) override;
+    Result<std::vector<std::string>> FindStrings(const MemoryView& dump) override;
+    Result<std::unordered_map<std::string, std::string>> ExtractMetadata(const MemoryView& dump) override;
 
     // Extended functionality
     Result<std::vector<PatternMatch>> FindMalwareSignatures(const MemoryDump& dump);
     Result<std::vector<StringMatch>> ExtractStrings(const MemoryDump& dump, bool include_wide = true);
     Result<AnalysisResult> PerformFullAnalysis(const MemoryDump& dump);
+
+    // Zero-copy variants over bytes owned elsewhere (mapped dump files, shared buffers)
+    Result<std::vector<PatternMatch>> FindMalwareSignatures(const MemoryView& dump);
+    Result<std::vector<StringMatch>> ExtractStrings(const MemoryView& dump, bool include_wide = true);
+    Result<AnalysisResult> PerformFullAnalysis(const MemoryView& dump);
     
     // Pattern management
     void LoadPatternDatabase(const std::string& pattern_file);
+
+    /**
+     * @brief Load a pattern database through a compiled cache
+     *
+     * Maps compiled_file when it was built from this text on top of the
+     * patterns already present; otherwise parses the text as above and
+     * rewrites the cache for the next load.
+     */
+    void LoadPatternDatabase(const std::string& pattern_file, const std::string& compiled_file);
     void AddCustomPattern(const std::string& name, const std::vector<uint8_t>& pattern, const std::string& description);
+    void AddCustomPattern(const std::string& name, const ByteSignature& signature, const std::string& description);
     size_t GetPatternCount() const;
 
+    // Parallel analysis
+    void SetAnalysisConfig(const AnalysisConfig& config);
+    size_t GetWorkerThreadCount() const;
+    // Chunk scans run on the shared executor when one is set; set before use
+    void SetTaskExecutor(std::weak_ptr<ITaskExecutor> executor);
+
+    // Entropy profile over windows of any size (e.g. 256 B for small packed stubs)
+    EntropyProfile ComputeEntropyProfile(const MemoryView& dump, size_t window_size, size_t step) const;
+
+    /**
+     * @brief Parsed PE/ELF tables of the module in dump
+     *
+     * Results are cached per module name and base address; an entry is reused
+     * while the dump size and a fingerprint of its headers are unchanged, so
+     * repeated metadata queries on the same module do not re-walk the import
+     * and export tables.
+     */
+    Result<std::shared_ptr<const BinaryModuleInfo>> GetModuleInfo(const MemoryView& dump);
+    void ClearModuleCache();
+
+    // Incremental re-analysis
+    struct AnalysisDiff {
+        AnalysisResult result;                                 // Same as PerformFullAnalysis() would return
+        bool full_rescan = false;                              // No usable snapshot of this region
+        size_t pages_total = 0;
+        size_t pages_changed = 0;
+        size_t bytes_rescanned = 0;
+        std::vector<std::pair<uintptr_t, size_t>> changed_ranges; // Runs of changed pages
+        std::vector<PatternMatch> added_patterns;
+        std::vector<PatternMatch> removed_patterns;
+        std::vector<StringMatch> added_strings;
+        std::vector<StringMatch> removed_strings;
+    };
+
+    /**
+     * @brief Analyze dump, re-scanning only the pages changed since the last call for its base address
+     *
+     * The first call for a region, or one whose size, patterns or entropy
+     * settings changed, falls back to a full scan. Later calls compare 4 KB
+     * page hashes with the stored snapshot and re-scan the changed pages plus
+     * the margin a signature, string or entropy window can reach across; the
+     * rest of the previous results is reused. The byte histogram for metadata
+     * is always recounted, which costs one pass without any matching.
+     */
+    Result<AnalysisDiff> AnalyzeIncremental(const MemoryView& dump);
+    void ForgetSnapshot(uintptr_t base_address);
+    void ClearSnapshots();
+
+    // Streaming analysis
+    struct StreamCallbacks {
+        std::function<void(const PatternMatch&)> on_pattern;
+        std::function<void(const StringMatch&)> on_string;
+    };
+
+    struct StreamSummary {
+        size_t bytes_processed = 0;
+        size_t pattern_count = 0;
+        size_t string_count = 0;
+        EntropyProfile entropy;
+        std::unordered_map<std::string, std::string> metadata;
+    };
+
+    /**
+     * @brief Analyze a dump read chunk by chunk from source
+     *
+     * Matches are reported through the callbacks as soon as they are final,
+     * in the same order PerformFullAnalysis() returns them. High-entropy
+     * regions go to on_pattern when the region ends, so they may follow
+     * signature matches at higher addresses. Only one chunk
+     * (analysis_config.chunk_size_kb) plus the overlap still needed by an
+     * unfinished signature or string is held in memory at a time.
+     */
+    Result<StreamSummary> AnalyzeStream(IDumpChunkSource& source, const StreamCallbacks& callbacks);
+
 private:
-    struct Pattern {
-        std::string name;
-        std::vector<uint8_t> bytes;
-        std::string description;
-        double confidence_threshold = 0.8;
+    using Pattern = PatternDefinition;
+
+    // Immutable snapshot of the reportable patterns, compiled into one matcher
+    struct CompiledPatternSet {
+        struct Entry {
+            std::string name;
+            std::string description;
+            double confidence;
+        };
+
+        CompiledPatternSet(std::vector<Entry> pattern_entries,
+                           const std::vector<ByteSignature>& signatures)
+            : entries(std::move(pattern_entries)), matcher(signatures) {}
+
+        CompiledPatternSet(std::vector<Entry> pattern_entries,
+                           const std::vector<ByteSignature>& signatures,
+                           MultiPatternMatcher anchors)
+            : entries(std::move(pattern_entries)), matcher(signatures, std::move(anchors)) {}
+
+        std::vector<Entry> entries;
+        SignatureMatcher matcher;
     };
 
     std::shared_ptr<ILogger> logger_;
+    std::weak_ptr<ITaskExecutor> executor_;  // Owned by the core engine
     std::vector<Pattern> patterns_;
+    mutable std::mutex patterns_mutex_;
+    std::shared_ptr<const CompiledPatternSet> compiled_patterns_; // Reset whenever patterns_ changes
+
+    struct ModuleCacheEntry {
+        size_t size;
+        uint64_t fingerprint;
+        std::shared_ptr<const BinaryModuleInfo> info;
+    };
+
+    std::unordered_map<std::string, ModuleCacheEntry> module_cache_; // module_name + ":" + base
+    std::mutex module_cache_mutex_;
+
+    // Unfiltered pattern match; lists keep each pattern's hits in offset order
+    struct PatternHit {
+        size_t offset;
+        size_t index;
+        size_t length;
+    };
+
+    // State kept between AnalyzeIncremental() calls for one base address
+    struct RegionSnapshot {
+        size_t size = 0;
+        std::shared_ptr<const CompiledPatternSet> compiled;
+        size_t entropy_window = 0;
+        size_t entropy_step = 0;
+        double entropy_threshold = 0.0;
+        std::vector<uint64_t> page_hashes;
+        std::vector<PatternHit> pattern_hits;                  // Before the non-overlap filter
+        std::vector<PatternMatch> patterns;                    // As last reported, entropy regions included
+        std::vector<StringMatch> strings;
+        EntropyProfile entropy;
+        std::vector<EntropyRegion> entropy_regions;
+    };
+
+    std::unordered_map<uintptr_t, RegionSnapshot> snapshots_;
+    std::mutex snapshots_mutex_;
+
+    std::atomic<size_t> worker_threads_{0};               // 0 = hardware concurrency
+    std::atomic<size_t> chunk_size_{4 * 1024 * 1024};
+    std::atomic<size_t> entropy_window_{4096};             // 0 = no entropy profile
+    std::atomic<size_t> entropy_step_{1024};
+    std::atomic<double> high_entropy_threshold_{7.2};
+
+    using ByteHistogram = std::array<uint64_t, 256>;
+
+    // Everything one worker finds in its chunk, offsets relative to the dump
+    struct ChunkResult {
+        std::vector<PatternHit> pattern_hits;
+        std::vector<StringRun> ascii_runs;
+        std::vector<StringRun> wide_runs;
+        ByteHistogram histogram{};
+    };
     
     // String extraction
-    Result<std::vector<StringMatch>> FindAsciiStrings(const MemoryDump& dump, size_t min_length = 4);
-    Result<std::vector<StringMatch>> FindUnicodeStrings(const MemoryDump& dump, size_t min_length = 4);
+    Result<std::vector<StringMatch>> FindAsciiStrings(const MemoryView& dump, size_t min_length = 4);
+    Result<std::vector<StringMatch>> FindUnicodeStrings(const MemoryView& dump, size_t min_length = 4);
+    StringMatch MakeStringMatch(const MemoryView& dump, const StringRun& run) const;
+    StringMatch MakeStringMatch(uintptr_t address, const uint8_t* source, const StringRun& run) const;
     
     // Pattern matching
-    Result<std::vector<PatternMatch>> SearchPatterns(const MemoryDump& dump);
-    double CalculatePatternConfidence(const Pattern& pattern, const MemoryDump& dump, size_t offset);
+    Result<std::vector<PatternMatch>> SearchPatterns(const MemoryView& dump);
+    std::shared_ptr<const CompiledPatternSet> GetCompiledPatterns();
+    std::shared_ptr<const CompiledPatternSet> CompilePatterns(const MultiPatternMatcher* cached_anchors) const;
+    std::vector<Pattern> ParsePatternDatabase(std::istream& input, const std::string& pattern_file) const;
+    std::vector<PatternMatch> BuildPatternMatches(const CompiledPatternSet& compiled, uintptr_t base_address,
+                                                  const std::vector<PatternHit>& hits) const;
+    std::vector<PatternMatch> BuildPatternMatches(const CompiledPatternSet& compiled, uintptr_t base_address,
+                                                  const std::vector<PatternHit>& hits,
+                                                  std::vector<size_t>& next_allowed) const;
+    std::vector<StringMatch> BuildStringMatches(const MemoryView& dump,
+                                                const std::vector<StringRun>& ascii_runs,
+                                                const std::vector<StringRun>& wide_runs) const;
+    double CalculatePatternConfidence(const Pattern& pattern) const;
+
+    // Entropy analysis
+    void AnalyzeEntropy(const MemoryView& dump, AnalysisResult& result) const;
+    void MergeEntropyMatches(uintptr_t base_address, const std::vector<EntropyRegion>& regions,
+                             std::vector<PatternMatch>& patterns) const;
+    PatternMatch MakeEntropyMatch(uintptr_t base_address, const EntropyRegion& region) const;
+
+    // Parallel analysis
+    Result<AnalysisResult> PerformParallelAnalysis(const MemoryView& dump, size_t worker_count, size_t chunk_size);
+    void AnalyzeChunk(const CompiledPatternSet& compiled, const MemoryView& dump,
+                      size_t begin, size_t end, ChunkResult& result) const;
+    ChunkResult ScanChunks(const CompiledPatternSet& compiled, const MemoryView& dump,
+                           size_t worker_count, size_t chunk_size) const;
+
+    // Incremental analysis
+    void AnalyzeFromScratch(const MemoryView& dump, const std::shared_ptr<const CompiledPatternSet>& compiled,
+                            RegionSnapshot& snapshot, AnalysisDiff& diff) const;
+    void RescanRange(const MemoryView& dump, RegionSnapshot& snapshot, size_t begin, size_t end,
+                     AnalysisDiff& diff) const;
+    void UpdateEntropy(const MemoryView& dump, RegionSnapshot& snapshot,
+                       const std::vector<std::pair<size_t, size_t>>& changed) const;
+    static std::vector<uint64_t> HashPages(const MemoryView& dump);
     
     // Metadata extraction
-    Result<std::unordered_map<std::string, std::string>> ExtractPEMetadata(const MemoryDump& dump);
-    Result<std::unordered_map<std::string, std::string>> ExtractELFMetadata(const MemoryDump& dump);
-    Result<std::unordered_map<std::string, std::string>> ExtractGenericMetadata(const MemoryDump& dump);
+    Result<std::unordered_map<std::string, std::string>> ExtractPEMetadata(const MemoryView& dump);
+    Result<std::unordered_map<std::string, std::string>> ExtractELFMetadata(const MemoryView& dump);
+    Result<std::unordered_map<std::string, std::string>> ExtractGenericMetadata(const ByteHistogram& histogram);
+    Result<std::unordered_map<std::string, std::string>> ExtractMetadata(const MemoryView& dump,
+                                                                         const ByteHistogram& histogram);
+    static void CountBytes(const uint8_t* data, size_t size, ByteHistogram& histogram);
     
     // Utility methods
-    bool IsValidAsciiChar(uint8_t c) const;
-    bool IsValidUnicodeChar(uint16_t c) const;
     std::string BytesToHex(const std::vector<uint8_t>& bytes) const;
     
     // Built-in patterns
@@ -0,0 +1,183 @@
+#include "dump_file.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace mcp {
+
+namespace {
+
+constexpr char kMagic[8] = {'M', 'C', 'P', 'D', 'U', 'M', 'P', '\0'};
+constexpr uint32_t kVersion = 1;
+constexpr uint64_t kPayloadAlignment = 4096;
+constexpr size_t kMaxModuleName = 96;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t region_count;
+    uint64_t table_offset;
+    uint64_t reserved[5];
+};
+
+struct RegionRecord {
+    uint64_t base_address;
+    uint64_t size;
+    uint64_t payload_offset;
+    uint32_t protection;
+    uint32_t name_length;
+    char module_name[kMaxModuleName];
+};
+
+static_assert(sizeof(FileHeader) == 64, "Dump file header layout changed");
+static_assert(sizeof(RegionRecord) == 128, "Dump file region record layout changed");
+
+uint64_t AlignUp(uint64_t value) {
+    return (value + kPayloadAlignment - 1) & ~(kPayloadAlignment - 1);
+}
+
+} // anonymous namespace
+
+void DumpFileWriter::AddRegion(const MemoryView& region, uint32_t protection) {
+    regions_.push_back({region, protection});
+}
+
+Result<void> DumpFileWriter::Write(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return Result<void>::Error("Cannot create dump file: " + path);
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.region_count = static_cast<uint32_t>(regions_.size());
+    header.table_offset = sizeof(FileHeader);
+
+    // Lay out the payloads first so the table can be written in one go
+    std::vector<RegionRecord> records(regions_.size());
+    uint64_t offset = AlignUp(sizeof(FileHeader) + records.size() * sizeof(RegionRecord));
+    for (size_t i = 0; i < regions_.size(); ++i) {
+        const auto& region = regions_[i];
+        RegionRecord& record = records[i];
+        record.base_address = region.view.base_address;
+        record.size = region.view.size;
+        record.payload_offset = offset;
+        record.protection = region.protection;
+        record.name_length = static_cast<uint32_t>(std::min(region.view.module_name.size(), kMaxModuleName));
+        std::memcpy(record.module_name, region.view.module_name.data(), record.name_length);
+        offset = AlignUp(offset + region.view.size);
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(records.data()),
+               static_cast<std::streamsize>(records.size() * sizeof(RegionRecord)));
+
+    const std::vector<char> padding(kPayloadAlignment, 0);
+    for (size_t i = 0; i < regions_.size(); ++i) {
+        const uint64_t position = static_cast<uint64_t>(file.tellp());
+        file.write(padding.data(), static_cast<std::streamsize>(records[i].payload_offset - position));
+        file.write(reinterpret_cast<const char*>(regions_[i].view.data),
+                   static_cast<std::streamsize>(regions_[i].view.size));
+    }
+
+    if (!file.good()) {
+        return Result<void>::Error("Failed to write dump file: " + path);
+    }
+    return Result<void>::Success();
+}
+
+MappedDumpFile::MappedDumpFile(const std::string& path)
+    : path_(path) {
+}
+
+MappedDumpFile::~MappedDumpFile() = default;
+
+Result<std::shared_ptr<MappedDumpFile>> MappedDumpFile::Open(const std::string& path) {
+    std::shared_ptr<MappedDumpFile> file(new MappedDumpFile(path));
+
+    auto map_result = MappedFile::Open(path);
+    if (!map_result.IsSuccess()) {
+        return Result<std::shared_ptr<MappedDumpFile>>::Error(map_result.Error());
+    }
+    file->file_ = map_result.TakeValue();
+    file->mapping_ = file->file_->GetData();
+    file->mapping_size_ = file->file_->GetSize();
+
+    auto index_result = file->ParseIndex();
+    if (!index_result.IsSuccess()) {
+        return Result<std::shared_ptr<MappedDumpFile>>::Error(index_result.Error());
+    }
+
+    return Result<std::shared_ptr<MappedDumpFile>>::Success(std::move(file));
+}
+
+Result<void> MappedDumpFile::ParseIndex() {
+    if (mapping_size_ < sizeof(FileHeader)) {
+        return Result<void>::Error("Not a dump file (too small): " + path_);
+    }
+
+    FileHeader header;
+    std::memcpy(&header, mapping_, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        return Result<void>::Error("Not a dump file (bad magic): " + path_);
+    }
+    if (header.version != kVersion) {
+        return Result<void>::Error("Unsupported dump file version " + std::to_string(header.version) + ": " + path_);
+    }
+
+    const uint64_t table_size = static_cast<uint64_t>(header.region_count) * sizeof(RegionRecord);
+    if (header.table_offset > mapping_size_ || table_size > mapping_size_ - header.table_offset) {
+        return Result<void>::Error("Truncated region table in dump file: " + path_);
+    }
+
+    regions_.reserve(header.region_count);
+    payload_offsets_.reserve(header.region_count);
+    for (uint32_t i = 0; i < header.region_count; ++i) {
+        RegionRecord record;
+        std::memcpy(&record, mapping_ + header.table_offset + i * sizeof(RegionRecord), sizeof(record));
+
+        if (record.payload_offset > mapping_size_ || record.size > mapping_size_ - record.payload_offset ||
+            record.name_length > kMaxModuleName) {
+            return Result<void>::Error("Corrupt region " + std::to_string(i) + " in dump file: " + path_);
+        }
+
+        DumpFileRegion region;
+        region.base_address = static_cast<uintptr_t>(record.base_address);
+        region.size = static_cast<size_t>(record.size);
+        region.protection = record.protection;
+        region.module_name.assign(record.module_name, record.name_length);
+        regions_.push_back(std::move(region));
+        payload_offsets_.push_back(record.payload_offset);
+    }
+
+    return Result<void>::Success();
+}
+
+Result<MemoryView> MappedDumpFile::GetRegion(size_t index) const {
+    if (index >= regions_.size()) {
+        return Result<MemoryView>::Error("Region index out of range: " + std::to_string(index));
+    }
+
+    const auto& region = regions_[index];
+    return Result<MemoryView>::Success(MemoryView(mapping_ + payload_offsets_[index], region.size,
+                                                  region.base_address, region.module_name,
+                                                  shared_from_this()));
+}
+
+Result<MemoryView> MappedDumpFile::FindRegion(uintptr_t address) const {
+    for (size_t i = 0; i < regions_.size(); ++i) {
+        const auto& region = regions_[i];
+        if (address >= region.base_address && address - region.base_address < region.size) {
+            return GetRegion(i);
+        }
+    }
+
+    char message[64];
+    std::snprintf(message, sizeof(message), "No region contains address 0x%llx",
+                  static_cast<unsigned long long>(address));
+    return Result<MemoryView>::Error(message);
+}
+
+} // namespace mcp
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "mcp/interfaces.hpp"
+#include "mcp/memory_view.hpp"
+#include "mapped_file.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mcp {
+
+/**
+ * @brief One entry of a dump file's region index
+ */
+struct DumpFileRegion {
+    uintptr_t base_address = 0;
+    size_t size = 0;
+    uint32_t protection = 0;  // Platform protection flags as captured (PAGE_* on Windows)
+    std::string module_name;
+};
+
+/**
+ * @brief Writes regions into the on-disk dump container
+ *
+ * Layout (little-endian):
+ *   - 64-byte header: magic "MCPDUMP\0", version, region count, table offset
+ *   - region table: one 128-byte record per region (base, size, payload
+ *     offset, protection, module name)
+ *   - payloads, each starting on a 4 KB boundary so they can be mapped and
+ *     paged in independently
+ */
+class DumpFileWriter {
+public:
+    void AddRegion(const MemoryView& region, uint32_t protection = 0);
+    Result<void> Write(const std::string& path) const;
+
+    size_t GetRegionCount() const { return regions_.size(); }
+
+private:
+    struct PendingRegion {
+        MemoryView view;
+        uint32_t protection;
+    };
+
+    std::vector<PendingRegion> regions_;
+};
+
+/**
+ * @brief Read-only memory mapping of a dump container
+ *
+ * Only the header and region table are read on Open(); payload pages are
+ * faulted in by the OS when a region view is first touched. Views returned
+ * by GetRegion() keep the mapping alive, so the file object itself may be
+ * dropped while they are still being analyzed.
+ */
+class MappedDumpFile : public std::enable_shared_from_this<MappedDumpFile> {
+public:
+    static Result<std::shared_ptr<MappedDumpFile>> Open(const std::string& path);
+    ~MappedDumpFile();
+
+    MappedDumpFile(const MappedDumpFile&) = delete;
+    MappedDumpFile& operator=(const MappedDumpFile&) = delete;
+
+    const std::string& GetPath() const { return path_; }
+    const std::vector<DumpFileRegion>& GetRegions() const { return regions_; }
+    size_t GetRegionCount() const { return regions_.size(); }
+
+    Result<MemoryView> GetRegion(size_t index) const;
+
+    /**
+     * @brief Region containing address
+     */
+    Result<MemoryView> FindRegion(uintptr_t address) const;
+
+private:
+    explicit MappedDumpFile(const std::string& path);
+
+    Result<void> ParseIndex();
+
+    std::string path_;
+    std::shared_ptr<const MappedFile> file_;
+    const uint8_t* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+
+    std::vector<DumpFileRegion> regions_;
+    std::vector<uint64_t> payload_offsets_;
+};
+
+} // namespace mcp
@@ -0,0 +1,70 @@
+#include "dump_source.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace mcp {
+
+FileDumpSource::FileDumpSource(const std::string& path, uintptr_t base_address)
+    : path_(path), base_address_(base_address) {
+}
+
+Result<void> FileDumpSource::Open() {
+    file_.open(path_, std::ios::binary);
+    if (!file_.is_open()) {
+        return Result<void>::Error("Cannot open dump file: " + path_);
+    }
+    return Result<void>::Success();
+}
+
+Result<size_t> FileDumpSource::Read(uint8_t* buffer, size_t capacity) {
+    if (!file_.is_open()) {
+        return Result<size_t>::Error("Dump file not open: " + path_);
+    }
+
+    file_.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(capacity));
+    if (file_.bad()) {
+        return Result<size_t>::Error("Failed to read dump file: " + path_);
+    }
+    return Result<size_t>::Success(static_cast<size_t>(file_.gcount()));
+}
+
+BufferDumpSource::BufferDumpSource(const MemoryDump& dump)
+    : dump_(dump) {
+}
+
+Result<size_t> BufferDumpSource::Read(uint8_t* buffer, size_t capacity) {
+    const size_t count = std::min(capacity, dump_.data.size() - position_);
+    if (count > 0) {
+        std::memcpy(buffer, dump_.data.data() + position_, count);
+        position_ += count;
+    }
+    return Result<size_t>::Success(count);
+}
+
+BridgeDumpSource::BridgeDumpSource(std::shared_ptr<IX64DbgBridge> bridge, uintptr_t address, size_t size)
+    : bridge_(std::move(bridge)), address_(address), size_(size) {
+}
+
+Result<size_t> BridgeDumpSource::Read(uint8_t* buffer, size_t capacity) {
+    if (!bridge_) {
+        return Result<size_t>::Error("No debug bridge for memory source");
+    }
+
+    const size_t count = std::min(capacity, size_ - position_);
+    if (count == 0) {
+        return Result<size_t>::Success(0);
+    }
+
+    auto memory = bridge_->ReadMemory(address_ + position_, count);
+    if (!memory.IsSuccess()) {
+        return Result<size_t>::Error(memory.Error());
+    }
+
+    const auto& data = memory.Value().data;
+    const size_t copied = std::min(count, data.size());
+    std::memcpy(buffer, data.data(), copied);
+    position_ += copied;
+    return Result<size_t>::Success(copied);
+}
+
+} // namespace mcp
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "mcp/interfaces.hpp"
+#include "mcp/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace mcp {
+
+/**
+ * @brief Sequential source of dump bytes for streaming analysis
+ *
+ * Read() fills the buffer with the next bytes of the dump and returns how
+ * many were written; 0 marks the end. Sources may return fewer bytes than
+ * requested at any time (a socket, a partially readable region).
+ */
+class IDumpChunkSource {
+public:
+    virtual ~IDumpChunkSource() = default;
+
+    virtual Result<size_t> Read(uint8_t* buffer, size_t capacity) = 0;
+    virtual uintptr_t GetBaseAddress() const = 0;
+    virtual std::string GetName() const = 0;
+};
+
+/**
+ * @brief Streams a dump file from disk
+ */
+class FileDumpSource : public IDumpChunkSource {
+public:
+    FileDumpSource(const std::string& path, uintptr_t base_address);
+
+    Result<void> Open();
+
+    Result<size_t> Read(uint8_t* buffer, size_t capacity) override;
+    uintptr_t GetBaseAddress() const override { return base_address_; }
+    std::string GetName() const override { return path_; }
+
+private:
+    std::string path_;
+    uintptr_t base_address_;
+    std::ifstream file_;
+};
+
+/**
+ * @brief Streams a dump that is already in memory (tests, small regions)
+ */
+class BufferDumpSource : public IDumpChunkSource {
+public:
+    explicit BufferDumpSource(const MemoryDump& dump);
+
+    Result<size_t> Read(uint8_t* buffer, size_t capacity) override;
+    uintptr_t GetBaseAddress() const override { return dump_.base_address; }
+    std::string GetName() const override { return dump_.module_name; }
+
+private:
+    const MemoryDump& dump_;
+    size_t position_ = 0;
+};
+
+/**
+ * @brief Streams a region of the debuggee through the bridge, one read per chunk
+ */
+class BridgeDumpSource : public IDumpChunkSource {
+public:
+    BridgeDumpSource(std::shared_ptr<IX64DbgBridge> bridge, uintptr_t address, size_t size);
+
+    Result<size_t> Read(uint8_t* buffer, size_t capacity) override;
+    uintptr_t GetBaseAddress() const override { return address_; }
+    std::string GetName() const override { return "debuggee"; }
+
+private:
+    std::shared_ptr<IX64DbgBridge> bridge_;
+    uintptr_t address_;
+    size_t size_;
+    size_t position_ = 0;
+};
+
+} // namespace mcp
@@ -0,0 +1,85 @@
+#include "entropy_map.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace mcp {
+
+namespace {
+
+double XLog2X(size_t count) {
+    return count == 0 ? 0.0 : static_cast<double>(count) * std::log2(static_cast<double>(count));
+}
+
+} // anonymous namespace
+
+EntropyMap::EntropyMap(size_t window_size, size_t step, double threshold)
+    : window_size_(std::max<size_t>(window_size, 2)),
+      step_(std::max<size_t>(step, 1)),
+      threshold_(threshold),
+      log_window_(std::log2(static_cast<double>(window_size_))),
+      gain_(window_size_),
+      ring_(window_size_),
+      next_emit_(window_size_) {
+    for (size_t c = 0; c < window_size_; ++c) {
+        gain_[c] = XLog2X(c + 1) - XLog2X(c);
+    }
+    profile_.window_size = window_size_;
+    profile_.step = step_;
+}
+
+void EntropyMap::Feed(const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        const size_t slot = position_ % window_size_;
+        if (position_ >= window_size_) {
+            const uint8_t leaving = ring_[slot];
+            sum_ -= gain_[--counts_[leaving]];
+        }
+        const uint8_t entering = data[i];
+        sum_ += gain_[counts_[entering]++];
+        ring_[slot] = entering;
+        ++position_;
+
+        if (position_ == next_emit_) {
+            EmitWindow(position_ - window_size_);
+            next_emit_ += step_;
+        }
+    }
+}
+
+void EntropyMap::EmitWindow(size_t start) {
+    const double entropy = std::max(0.0, log_window_ - sum_ / static_cast<double>(window_size_));
+    const long quantized = std::lround(entropy * EntropyProfile::kScale);
+    profile_.values.push_back(static_cast<uint8_t>(std::min<long>(quantized, 255)));
+
+    if (entropy < threshold_) {
+        CloseRegion();
+        return;
+    }
+
+    if (!region_open_) {
+        region_open_ = true;
+        region_start_ = start;
+        region_windows_ = 0;
+        region_sum_ = 0.0;
+        region_peak_ = 0.0;
+    }
+    region_end_ = start + window_size_;
+    ++region_windows_;
+    region_sum_ += entropy;
+    region_peak_ = std::max(region_peak_, entropy);
+}
+
+void EntropyMap::CloseRegion() {
+    if (!region_open_) {
+        return;
+    }
+    regions_.push_back({region_start_, region_end_ - region_start_,
+                        region_sum_ / static_cast<double>(region_windows_), region_peak_});
+    region_open_ = false;
+}
+
+void EntropyMap::Finish() {
+    CloseRegion();
+}
+
+} // namespace mcp
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "mcp/types.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace mcp {
+
+/**
+ * @brief Run of consecutive windows above the entropy threshold
+ */
+struct EntropyRegion {
+    size_t offset;       // Start of the first window, relative to the stream
+    size_t length;       // Up to the end of the last window
+    double mean_entropy;
+    double peak_entropy;
+};
+
+/**
+ * @brief Incremental sliding-window entropy profile
+ *
+ * Keeps the byte histogram of the current window and the running sum of
+ * c*log2(c) over it. Each byte entering or leaving the window changes one
+ * count, so the sum is patched with a precomputed delta table instead of
+ * re-evaluating 256 logarithms per window: H = log2(W) - sum / W.
+ *
+ * Data may be fed in pieces of any size; the last window_size bytes are
+ * kept in a ring so memory does not grow with the stream.
+ */
+class EntropyMap {
+public:
+    EntropyMap(size_t window_size, size_t step, double threshold);
+
+    void Feed(const uint8_t* data, size_t size);
+
+    /**
+     * @brief Close a region still open at the end of the stream
+     */
+    void Finish();
+
+    const EntropyProfile& GetProfile() const { return profile_; }
+    EntropyProfile TakeProfile() { return std::move(profile_); }
+
+    // Completed regions in offset order
+    const std::vector<EntropyRegion>& GetRegions() const { return regions_; }
+    void ClearRegions() { regions_.clear(); }
+
+private:
+    size_t window_size_;
+    size_t step_;
+    double threshold_;
+    double log_window_;
+
+    std::vector<double> gain_;  // gain_[c] = (c+1)log2(c+1) - c*log2(c)
+    std::vector<uint8_t> ring_;
+    std::array<uint32_t, 256> counts_{};
+    double sum_ = 0.0;
+    size_t position_ = 0;
+    size_t next_emit_;
+
+    bool region_open_ = false;
+    size_t region_start_ = 0;
+    size_t region_end_ = 0;
+    size_t region_windows_ = 0;
+    double region_sum_ = 0.0;
+    double region_peak_ = 0.0;
+
+    EntropyProfile profile_;
+    std::vector<EntropyRegion> regions_;
+
+    void EmitWindow(size_t start);
+    void CloseRegion();
+};
+
+} // namespace mcp
@@ -0,0 +1,111 @@
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mcp {
+
+MappedFile::~MappedFile() {
+    Unmap();
+}
+
+Result<std::shared_ptr<const MappedFile>> MappedFile::Open(const std::string& path) {
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    auto map_result = file->Map(path);
+    if (!map_result.IsSuccess()) {
+        return Result<std::shared_ptr<const MappedFile>>::Error(map_result.Error());
+    }
+    return Result<std::shared_ptr<const MappedFile>>::Success(std::move(file));
+}
+
+#ifdef _WIN32
+Result<void> MappedFile::Map(const std::string& path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return Result<void>::Error("Cannot open file: " + path);
+    }
+    file_handle_ = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        return Result<void>::Error("Cannot stat file: " + path);
+    }
+    size_ = static_cast<size_t>(size.QuadPart);
+    if (size_ == 0) {
+        return Result<void>::Success(); // Empty files cannot be mapped
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        return Result<void>::Error("Cannot map file: " + path);
+    }
+    mapping_handle_ = mapping;
+
+    data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr) {
+        return Result<void>::Error("Cannot map file: " + path);
+    }
+    return Result<void>::Success();
+}
+
+void MappedFile::Unmap() {
+    if (data_) {
+        UnmapViewOfFile(data_);
+        data_ = nullptr;
+    }
+    if (mapping_handle_) {
+        CloseHandle(static_cast<HANDLE>(mapping_handle_));
+        mapping_handle_ = nullptr;
+    }
+    if (file_handle_) {
+        CloseHandle(static_cast<HANDLE>(file_handle_));
+        file_handle_ = nullptr;
+    }
+}
+#else
+Result<void> MappedFile::Map(const std::string& path) {
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        return Result<void>::Error("Cannot open file: " + path);
+    }
+
+    struct stat info;
+    if (::fstat(fd_, &info) != 0) {
+        return Result<void>::Error("Cannot stat file: " + path);
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ == 0) {
+        return Result<void>::Success(); // mmap() rejects empty files
+    }
+
+    void* address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (address == MAP_FAILED) {
+        return Result<void>::Error("Cannot map file: " + path);
+    }
+    data_ = static_cast<const uint8_t*>(address);
+    return Result<void>::Success();
+}
+
+void MappedFile::Unmap() {
+    if (data_) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+        data_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+#endif
+
+} // namespace mcp
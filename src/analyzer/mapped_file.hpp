@@ -0,0 +1,44 @@
+#pragma once
+
+#include "mcp/interfaces.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace mcp {
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ *
+ * Pages are faulted in by the OS when first touched. Anything that points
+ * into the mapping holds the shared_ptr, so the mapping outlives its readers.
+ */
+class MappedFile {
+public:
+    static Result<std::shared_ptr<const MappedFile>> Open(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* GetData() const { return data_; }
+    size_t GetSize() const { return size_; }
+
+private:
+    MappedFile() = default;
+
+    Result<void> Map(const std::string& path);
+    void Unmap();
+
+    const uint8_t* data_ = nullptr;  // Null for an empty file
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+    void* mapping_handle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+} // namespace mcp
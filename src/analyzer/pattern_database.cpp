@@ -0,0 +1,257 @@
+#include "pattern_database.hpp"
+#include "mapped_file.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace mcp {
+
+namespace {
+
+constexpr char kMagic[8] = {'M', 'C', 'P', 'P', 'A', 'T', 'D', 'B'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kByteOrderMark = 0x01020304u;  // Caches are not portable across endianness
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t pattern_count;
+    uint32_t reserved;
+    uint64_t fingerprint;
+    uint64_t records_offset;
+    uint64_t records_size;
+    uint64_t matcher_offset;
+    uint64_t matcher_size;
+};
+
+static_assert(sizeof(FileHeader) == 64, "Pattern database header layout changed");
+
+void PutU32(std::vector<uint8_t>& out, uint32_t value) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(value));
+}
+
+void PutBytes(std::vector<uint8_t>& out, const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+// Record layout: name length, description length, piece count, threshold,
+// name, description, then per piece its length, gap bounds, values and masks
+void EncodeRecords(const std::vector<PatternDefinition>& patterns, std::vector<uint8_t>& out) {
+    for (const auto& pattern : patterns) {
+        const auto& pieces = pattern.signature.GetPieces();
+        PutU32(out, static_cast<uint32_t>(pattern.name.size()));
+        PutU32(out, static_cast<uint32_t>(pattern.description.size()));
+        PutU32(out, static_cast<uint32_t>(pieces.size()));
+        PutBytes(out, &pattern.confidence_threshold, sizeof(double));
+        PutBytes(out, pattern.name.data(), pattern.name.size());
+        PutBytes(out, pattern.description.data(), pattern.description.size());
+        for (const auto& piece : pieces) {
+            PutU32(out, static_cast<uint32_t>(piece.values.size()));
+            PutU32(out, static_cast<uint32_t>(piece.min_gap));
+            PutU32(out, static_cast<uint32_t>(piece.max_gap));
+            PutBytes(out, piece.values.data(), piece.values.size());
+            PutBytes(out, piece.masks.data(), piece.masks.size());
+        }
+    }
+}
+
+// Bounds-checked reader over the record section
+class RecordReader {
+public:
+    RecordReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    bool Read(void* out, size_t size) {
+        if (size > size_ - offset_) {
+            return false;
+        }
+        std::memcpy(out, data_ + offset_, size);
+        offset_ += size;
+        return true;
+    }
+
+    bool ReadU32(uint32_t& value) { return Read(&value, sizeof(value)); }
+
+    bool ReadString(std::string& out, size_t size) {
+        if (size > size_ - offset_) {
+            return false;
+        }
+        out.assign(reinterpret_cast<const char*>(data_ + offset_), size);
+        offset_ += size;
+        return true;
+    }
+
+    bool ReadBytes(std::vector<uint8_t>& out, size_t size) {
+        if (size > size_ - offset_) {
+            return false;
+        }
+        out.assign(data_ + offset_, data_ + offset_ + size);
+        offset_ += size;
+        return true;
+    }
+
+    bool AtEnd() const { return offset_ == size_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t offset_ = 0;
+};
+
+bool DecodeRecord(RecordReader& reader, PatternDefinition& pattern) {
+    uint32_t name_length = 0;
+    uint32_t description_length = 0;
+    uint32_t piece_count = 0;
+    if (!reader.ReadU32(name_length) || !reader.ReadU32(description_length) || !reader.ReadU32(piece_count) ||
+        !reader.Read(&pattern.confidence_threshold, sizeof(double)) ||
+        !reader.ReadString(pattern.name, name_length) ||
+        !reader.ReadString(pattern.description, description_length)) {
+        return false;
+    }
+
+    std::vector<ByteSignature::Piece> pieces;
+    for (uint32_t p = 0; p < piece_count; ++p) {
+        uint32_t length = 0;
+        uint32_t min_gap = 0;
+        uint32_t max_gap = 0;
+        ByteSignature::Piece piece;
+        if (!reader.ReadU32(length) || !reader.ReadU32(min_gap) || !reader.ReadU32(max_gap) ||
+            !reader.ReadBytes(piece.values, length) || !reader.ReadBytes(piece.masks, length)) {
+            return false;
+        }
+        piece.min_gap = min_gap;
+        piece.max_gap = max_gap;
+        pieces.push_back(std::move(piece));
+    }
+
+    auto signature = ByteSignature::FromPieces(std::move(pieces));
+    if (!signature.IsSuccess()) {
+        return false;
+    }
+    pattern.signature = signature.TakeValue();
+    return true;
+}
+
+} // anonymous namespace
+
+uint64_t CompiledPatternDatabase::Fingerprint(const std::vector<PatternDefinition>& patterns,
+                                              const std::string& source_text) {
+    std::vector<uint8_t> records;
+    EncodeRecords(patterns, records);
+
+    // FNV-1a over the base patterns and the text; the record count separates the two
+    uint64_t hash = 0xCBF29CE484222325ull;
+    const auto mix = [&hash](const uint8_t* data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ data[i]) * 0x100000001B3ull;
+        }
+    };
+    const uint64_t count = patterns.size();
+    mix(reinterpret_cast<const uint8_t*>(&count), sizeof(count));
+    mix(records.data(), records.size());
+    mix(reinterpret_cast<const uint8_t*>(source_text.data()), source_text.size());
+    return hash;
+}
+
+Result<void> CompiledPatternDatabase::Write(const std::string& path, uint64_t fingerprint,
+                                            const std::vector<PatternDefinition>& patterns,
+                                            const MultiPatternMatcher& anchors) {
+    std::vector<uint8_t> image(sizeof(FileHeader));
+    EncodeRecords(patterns, image);
+    const uint64_t records_size = image.size() - sizeof(FileHeader);
+
+    image.resize((image.size() + 7) & ~size_t{7}, 0);
+    const uint64_t matcher_offset = image.size();
+    anchors.Serialize(image);
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byte_order = kByteOrderMark;
+    header.pattern_count = static_cast<uint32_t>(patterns.size());
+    header.fingerprint = fingerprint;
+    header.records_offset = sizeof(FileHeader);
+    header.records_size = records_size;
+    header.matcher_offset = matcher_offset;
+    header.matcher_size = image.size() - matcher_offset;
+    std::memcpy(image.data(), &header, sizeof(header));
+
+    // Written aside and renamed so a concurrent reader never maps half a cache
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return Result<void>::Error("Cannot create pattern cache: " + temp_path);
+        }
+        file.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+        if (!file.good()) {
+            std::remove(temp_path.c_str());
+            return Result<void>::Error("Failed to write pattern cache: " + temp_path);
+        }
+    }
+
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        // Windows does not replace an existing file on rename
+        std::remove(path.c_str());
+        if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+            std::remove(temp_path.c_str());
+            return Result<void>::Error("Cannot replace pattern cache: " + path);
+        }
+    }
+    return Result<void>::Success();
+}
+
+Result<CompiledPatternDatabase::Contents> CompiledPatternDatabase::Open(const std::string& path,
+                                                                        uint64_t fingerprint) {
+    auto map_result = MappedFile::Open(path);
+    if (!map_result.IsSuccess()) {
+        return Result<Contents>::Error(map_result.Error());
+    }
+    const std::shared_ptr<const MappedFile> file = map_result.TakeValue();
+    const uint8_t* data = file->GetData();
+    const size_t size = file->GetSize();
+
+    if (size < sizeof(FileHeader)) {
+        return Result<Contents>::Error("Not a pattern cache (too small): " + path);
+    }
+    FileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        return Result<Contents>::Error("Not a pattern cache (bad magic): " + path);
+    }
+    if (header.version != kVersion || header.byte_order != kByteOrderMark) {
+        return Result<Contents>::Error("Unsupported pattern cache version " + std::to_string(header.version) +
+                                       ": " + path);
+    }
+    if (header.fingerprint != fingerprint) {
+        return Result<Contents>::Error("Pattern cache is stale: " + path);
+    }
+    if (header.records_offset > size || header.records_size > size - header.records_offset ||
+        header.matcher_offset > size || header.matcher_size > size - header.matcher_offset) {
+        return Result<Contents>::Error("Truncated pattern cache: " + path);
+    }
+
+    Contents contents;
+    RecordReader reader(data + header.records_offset, static_cast<size_t>(header.records_size));
+    contents.patterns.resize(header.pattern_count);
+    for (auto& pattern : contents.patterns) {
+        if (!DecodeRecord(reader, pattern)) {
+            return Result<Contents>::Error("Corrupt pattern record in cache: " + path);
+        }
+    }
+    if (!reader.AtEnd()) {
+        return Result<Contents>::Error("Corrupt pattern record in cache: " + path);
+    }
+
+    auto anchors = MultiPatternMatcher::FromImage(data + header.matcher_offset,
+                                                  static_cast<size_t>(header.matcher_size), file);
+    if (!anchors.IsSuccess()) {
+        return Result<Contents>::Error(anchors.Error() + ": " + path);
+    }
+    contents.anchors = anchors.TakeValue();
+    return Result<Contents>::Success(std::move(contents));
+}
+
+} // namespace mcp
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "mcp/interfaces.hpp"
+#include "byte_signature.hpp"
+#include "pattern_matcher.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mcp {
+
+/**
+ * @brief One entry of the analyzer's pattern set
+ */
+struct PatternDefinition {
+    std::string name;
+    ByteSignature signature;
+    std::string description;
+    double confidence_threshold = 0.8;
+};
+
+/**
+ * @brief On-disk cache of a parsed and compiled pattern database
+ *
+ * Layout (little-endian):
+ *   - 64-byte header: magic "MCPPATDB", version, byte-order mark, pattern
+ *     count, source fingerprint, then offset and size of both sections
+ *   - pattern records: name, description, threshold and signature pieces
+ *   - anchor automaton image (MultiPatternMatcher::Serialize), 8-byte aligned
+ *
+ * The file is mapped rather than read. Pattern records are decoded, but the
+ * automaton is used in place, backed by the mapping. A cache whose
+ * fingerprint differs from the caller's is rejected as stale.
+ */
+class CompiledPatternDatabase {
+public:
+    struct Contents {
+        std::vector<PatternDefinition> patterns;
+        MultiPatternMatcher anchors;
+    };
+
+    /**
+     * @brief Identifies the inputs a cache was built from
+     * @param patterns Patterns present before the database text is added
+     */
+    static uint64_t Fingerprint(const std::vector<PatternDefinition>& patterns, const std::string& source_text);
+
+    static Result<void> Write(const std::string& path, uint64_t fingerprint,
+                              const std::vector<PatternDefinition>& patterns,
+                              const MultiPatternMatcher& anchors);
+    static Result<Contents> Open(const std::string& path, uint64_t fingerprint);
+};
+
+} // namespace mcp
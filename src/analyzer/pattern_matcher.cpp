@@ -0,0 +1,466 @@
+#include "pattern_matcher.hpp"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <string>
+
+namespace mcp {
+
+namespace {
+
+// Dense tables above this many entries fall back to sparse edges (32 MB of uint32_t)
+constexpr size_t kMaxDenseEntries = 8u * 1024u * 1024u;
+
+// Fixed part of a serialized automaton; the tables follow, each 8-byte aligned
+struct ImageHeader {
+    uint32_t node_count;
+    uint32_t edge_count;
+    uint32_t output_count;
+    uint32_t pattern_count;
+    uint32_t class_count;
+    uint32_t dense_count;
+    uint64_t max_pattern_length;
+};
+
+static_assert(sizeof(ImageHeader) == 32, "Matcher image header layout changed");
+
+void AppendAligned(std::vector<uint8_t>& out, const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    out.insert(out.end(), bytes, bytes + size);
+    out.resize((out.size() + 7) & ~size_t{7}, 0);
+}
+
+// Hands out consecutive 8-byte aligned pieces of an image
+class ImageReader {
+public:
+    ImageReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    template<typename T>
+    const T* Take(size_t count) {
+        const size_t bytes = count * sizeof(T);
+        const size_t padded = (bytes + 7) & ~size_t{7};
+        if (count > size_ / sizeof(T) || padded > size_ - offset_) {
+            return nullptr;
+        }
+        const T* items = reinterpret_cast<const T*>(data_ + offset_);
+        offset_ += padded;
+        return items;
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t offset_ = 0;
+};
+
+} // anonymous namespace
+
+MultiPatternMatcher::MultiPatternMatcher(const std::vector<std::vector<uint8_t>>& patterns) {
+    // Build the trie with ordered child maps; they are flattened afterwards
+    std::vector<std::map<uint8_t, uint32_t>> children(1);
+    std::vector<std::vector<uint32_t>> node_outputs(1);
+
+    pattern_lengths_.reserve(patterns.size());
+    for (size_t p = 0; p < patterns.size(); ++p) {
+        const auto& pattern = patterns[p];
+        pattern_lengths_.push_back(pattern.size());
+        max_pattern_length_ = std::max(max_pattern_length_, pattern.size());
+
+        // Empty patterns would match at every offset; they are never reported
+        if (pattern.empty()) {
+            continue;
+        }
+
+        uint32_t state = 0;
+        for (uint8_t byte : pattern) {
+            auto it = children[state].find(byte);
+            if (it == children[state].end()) {
+                const uint32_t next = static_cast<uint32_t>(children.size());
+                children[state].emplace(byte, next);
+                children.emplace_back();
+                node_outputs.emplace_back();
+                state = next;
+            } else {
+                state = it->second;
+            }
+        }
+        node_outputs[state].push_back(static_cast<uint32_t>(p));
+    }
+
+    // Flatten into contiguous arrays
+    auto owned = std::make_shared<OwnedTables>();
+    std::vector<Node>& nodes = owned->nodes;
+    nodes.resize(children.size());
+    for (size_t s = 0; s < children.size(); ++s) {
+        Node& node = nodes[s];
+        node.first_edge = static_cast<uint32_t>(owned->edge_bytes.size());
+        node.edge_count = static_cast<uint32_t>(children[s].size());
+        for (const auto& edge : children[s]) {
+            owned->edge_bytes.push_back(edge.first);
+            owned->edge_targets.push_back(edge.second);
+        }
+        node.first_output = static_cast<uint32_t>(owned->outputs.size());
+        node.output_count = static_cast<uint32_t>(node_outputs[s].size());
+        owned->outputs.insert(owned->outputs.end(), node_outputs[s].begin(), node_outputs[s].end());
+    }
+    nodes_ = ViewOf(nodes);
+    edge_bytes_ = ViewOf(owned->edge_bytes);
+    edge_targets_ = ViewOf(owned->edge_targets);
+    outputs_ = ViewOf(owned->outputs);
+
+    // Root transitions: missing edges loop back to the root
+    for (const auto& edge : children[0]) {
+        root_next_[edge.first] = edge.second;
+    }
+
+    // Breadth-first pass computes failure and dictionary-suffix links
+    std::vector<uint32_t> queue;
+    queue.reserve(nodes_.size());
+    for (const auto& edge : children[0]) {
+        nodes[edge.second].fail = 0;
+        queue.push_back(edge.second);
+    }
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const uint32_t state = queue[head];
+        for (const auto& edge : children[state]) {
+            const uint32_t child = edge.second;
+            const uint32_t fail = NextState(nodes[state].fail, edge.first);
+            nodes[child].fail = fail;
+            nodes[child].output_link = nodes[fail].output_count != 0 ? fail : nodes[fail].output_link;
+            queue.push_back(child);
+        }
+    }
+
+    BuildDenseTable(*owned);
+    storage_ = std::move(owned);
+}
+
+void MultiPatternMatcher::Serialize(std::vector<uint8_t>& out) const {
+    static_assert(sizeof(Node) == 24, "Matcher image node layout changed");
+
+    ImageHeader header{};
+    header.node_count = static_cast<uint32_t>(nodes_.size());
+    header.edge_count = static_cast<uint32_t>(edge_bytes_.size());
+    header.output_count = static_cast<uint32_t>(outputs_.size());
+    header.pattern_count = static_cast<uint32_t>(pattern_lengths_.size());
+    header.class_count = static_cast<uint32_t>(class_count_);
+    header.dense_count = static_cast<uint32_t>(dense_.size());
+    header.max_pattern_length = max_pattern_length_;
+
+    const std::vector<uint32_t> lengths(pattern_lengths_.begin(), pattern_lengths_.end());
+    AppendAligned(out, &header, sizeof(header));
+    AppendAligned(out, byte_class_, sizeof(byte_class_));
+    AppendAligned(out, root_next_, sizeof(root_next_));
+    AppendAligned(out, lengths.data(), lengths.size() * sizeof(uint32_t));
+    AppendAligned(out, nodes_.data(), nodes_.size() * sizeof(Node));
+    AppendAligned(out, edge_bytes_.data(), edge_bytes_.size());
+    AppendAligned(out, edge_targets_.data(), edge_targets_.size() * sizeof(uint32_t));
+    AppendAligned(out, outputs_.data(), outputs_.size() * sizeof(uint32_t));
+    AppendAligned(out, dense_.data(), dense_.size() * sizeof(uint32_t));
+}
+
+Result<MultiPatternMatcher> MultiPatternMatcher::FromImage(const uint8_t* image, size_t size,
+                                                           std::shared_ptr<const void> owner) {
+    if (reinterpret_cast<uintptr_t>(image) % alignof(uint64_t) != 0) {
+        return Result<MultiPatternMatcher>::Error("Matcher image is not aligned");
+    }
+
+    ImageReader reader(image, size);
+    const ImageHeader* header = reader.Take<ImageHeader>(1);
+    const uint8_t* byte_class = reader.Take<uint8_t>(256);
+    const uint32_t* root_next = reader.Take<uint32_t>(256);
+    if (!header || !byte_class || !root_next) {
+        return Result<MultiPatternMatcher>::Error("Truncated matcher image");
+    }
+    const uint32_t* lengths = reader.Take<uint32_t>(header->pattern_count);
+    const Node* nodes = reader.Take<Node>(header->node_count);
+    const uint8_t* edge_bytes = reader.Take<uint8_t>(header->edge_count);
+    const uint32_t* edge_targets = reader.Take<uint32_t>(header->edge_count);
+    const uint32_t* outputs = reader.Take<uint32_t>(header->output_count);
+    const uint32_t* dense = reader.Take<uint32_t>(header->dense_count);
+    if ((!lengths && header->pattern_count) || !nodes || (!edge_bytes && header->edge_count) ||
+        (!edge_targets && header->edge_count) || (!outputs && header->output_count) ||
+        (!dense && header->dense_count)) {
+        return Result<MultiPatternMatcher>::Error("Truncated matcher image");
+    }
+
+    MultiPatternMatcher matcher;
+    matcher.storage_ = std::move(owner);
+    matcher.nodes_ = {nodes, header->node_count};
+    matcher.edge_bytes_ = {edge_bytes, header->edge_count};
+    matcher.edge_targets_ = {edge_targets, header->edge_count};
+    matcher.outputs_ = {outputs, header->output_count};
+    matcher.dense_ = {dense, header->dense_count};
+    matcher.pattern_lengths_.assign(lengths, lengths + header->pattern_count);
+    matcher.max_pattern_length_ = static_cast<size_t>(header->max_pattern_length);
+    matcher.class_count_ = header->class_count;
+    std::memcpy(matcher.byte_class_, byte_class, sizeof(matcher.byte_class_));
+    std::memcpy(matcher.root_next_, root_next, sizeof(matcher.root_next_));
+
+    auto valid = matcher.ValidateImage();
+    if (!valid.IsSuccess()) {
+        return Result<MultiPatternMatcher>::Error(valid.Error());
+    }
+    return Result<MultiPatternMatcher>::Success(std::move(matcher));
+}
+
+Result<void> MultiPatternMatcher::ValidateImage() const {
+    auto corrupt = [](const std::string& what) { return Result<void>::Error("Corrupt matcher image: " + what); };
+    const size_t node_count = nodes_.size();
+    if (node_count == 0 || class_count_ == 0 || class_count_ > 256 ||
+        (!dense_.empty() && dense_.size() != node_count * class_count_)) {
+        return corrupt("table sizes");
+    }
+
+    // Edges only lead to nodes created later, so one pass in index order yields
+    // every depth; failure and output links must then lead strictly upwards,
+    // which is what makes Scan() terminate
+    std::vector<uint32_t> depth(node_count, kNone);
+    depth[0] = 0;
+    for (size_t s = 0; s < node_count; ++s) {
+        const Node& node = nodes_[s];
+        if (depth[s] == kNone || static_cast<uint64_t>(node.first_edge) + node.edge_count > edge_bytes_.size() ||
+            static_cast<uint64_t>(node.first_output) + node.output_count > outputs_.size()) {
+            return corrupt("node " + std::to_string(s));
+        }
+        for (uint32_t e = node.first_edge; e < node.first_edge + node.edge_count; ++e) {
+            const uint32_t target = edge_targets_[e];
+            if (target <= s || target >= node_count || depth[target] != kNone ||
+                (e > node.first_edge && edge_bytes_[e - 1] >= edge_bytes_[e])) {
+                return corrupt("edges of node " + std::to_string(s));
+            }
+            depth[target] = depth[s] + 1;
+        }
+    }
+    for (size_t s = 1; s < node_count; ++s) {
+        const Node& node = nodes_[s];
+        if (node.fail >= node_count || depth[node.fail] >= depth[s] ||
+            (node.output_link != kNone && (node.output_link >= node_count || depth[node.output_link] >= depth[s]))) {
+            return corrupt("links of node " + std::to_string(s));
+        }
+        for (uint32_t k = 0; k < node.output_count; ++k) {
+            const uint32_t pattern = outputs_[node.first_output + k];
+            if (pattern >= pattern_lengths_.size() || pattern_lengths_[pattern] != depth[s]) {
+                return corrupt("outputs of node " + std::to_string(s));
+            }
+        }
+    }
+    for (size_t b = 0; b < 256; ++b) {
+        if (root_next_[b] >= node_count || (!dense_.empty() && byte_class_[b] >= class_count_)) {
+            return corrupt("root transitions");
+        }
+    }
+    for (size_t i = 0; i < dense_.size(); ++i) {
+        if (dense_[i] >= node_count) {
+            return corrupt("dense table");
+        }
+    }
+    for (size_t length : pattern_lengths_) {
+        if (length > max_pattern_length_) {
+            return corrupt("pattern lengths");
+        }
+    }
+    return Result<void>::Success();
+}
+
+bool MultiPatternMatcher::IsCompiledFrom(const std::vector<std::vector<uint8_t>>& patterns) const {
+    if (nodes_.empty() || patterns.size() != pattern_lengths_.size()) {
+        return false;
+    }
+    for (size_t p = 0; p < patterns.size(); ++p) {
+        if (patterns[p].size() != pattern_lengths_[p]) {
+            return false;
+        }
+        if (patterns[p].empty()) {
+            continue;
+        }
+        uint32_t state = kInitialState;
+        for (uint8_t byte : patterns[p]) {
+            state = FindEdge(state, byte);
+            if (state == kNone) {
+                return false;
+            }
+        }
+        const Node& node = nodes_[state];
+        const uint32_t* first = outputs_.data() + node.first_output;
+        if (std::find(first, first + node.output_count, static_cast<uint32_t>(p)) == first + node.output_count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t MultiPatternMatcher::FindEdge(uint32_t state, uint8_t byte) const {
+    const Node& node = nodes_[state];
+    const uint8_t* begin = edge_bytes_.data() + node.first_edge;
+    const uint8_t* end = begin + node.edge_count;
+
+    // Most trie nodes have one or two children; a linear probe beats bisection there
+    if (node.edge_count <= 8) {
+        for (const uint8_t* it = begin; it != end; ++it) {
+            if (*it == byte) {
+                return edge_targets_[node.first_edge + static_cast<uint32_t>(it - begin)];
+            }
+        }
+        return kNone;
+    }
+
+    const uint8_t* it = std::lower_bound(begin, end, byte);
+    if (it != end && *it == byte) {
+        return edge_targets_[node.first_edge + static_cast<uint32_t>(it - begin)];
+    }
+    return kNone;
+}
+
+void MultiPatternMatcher::BuildDenseTable(OwnedTables& owned) {
+    // Bytes that never label an edge behave identically in every state
+    bool used[256] = {};
+    for (uint8_t byte : edge_bytes_) {
+        used[byte] = true;
+    }
+
+    class_count_ = 1;
+    for (size_t b = 0; b < 256; ++b) {
+        byte_class_[b] = used[b] ? static_cast<uint8_t>(class_count_++) : 0;
+    }
+
+    if (class_count_ > 256 || nodes_.size() * class_count_ > kMaxDenseEntries) {
+        // With every byte value in use the shared class no longer fits in uint8_t; stay sparse
+        class_count_ = 1;
+        return;
+    }
+
+    // Class 0 is represented by any byte that no pattern uses (one exists, see above)
+    uint8_t representative[256] = {};
+    for (size_t b = 256; b-- > 0;) {
+        representative[byte_class_[b]] = static_cast<uint8_t>(b);
+    }
+
+    std::vector<uint32_t> table(nodes_.size() * class_count_);
+    for (size_t s = 0; s < nodes_.size(); ++s) {
+        for (size_t c = 0; c < class_count_; ++c) {
+            table[s * class_count_ + c] = NextState(static_cast<State>(s), representative[c]);
+        }
+    }
+
+    owned.dense = std::move(table);
+    dense_ = ViewOf(owned.dense);
+}
+
+SignatureMatcher::SignatureMatcher(const std::vector<ByteSignature>& signatures)
+    : anchors_(CompileAnchors(signatures, signatures_, anchor_owners_, unanchored_, max_span_)) {
+}
+
+SignatureMatcher::SignatureMatcher(const std::vector<ByteSignature>& signatures, MultiPatternMatcher anchors)
+    : anchors_(std::move(anchors)) {
+    const auto patterns = CompileAnchors(signatures, signatures_, anchor_owners_, unanchored_, max_span_);
+    if (!anchors_.IsCompiledFrom(patterns)) {
+        anchors_ = MultiPatternMatcher(patterns);
+    }
+}
+
+std::vector<std::vector<uint8_t>> SignatureMatcher::CompileAnchors(const std::vector<ByteSignature>& signatures,
+                                                                   std::vector<Compiled>& compiled,
+                                                                   std::vector<size_t>& owners,
+                                                                   std::vector<size_t>& unanchored,
+                                                                   size_t& max_span) {
+    std::vector<std::vector<uint8_t>> anchors;
+    compiled.resize(signatures.size());
+
+    for (size_t index = 0; index < signatures.size(); ++index) {
+        Compiled& entry = compiled[index];
+        entry.pieces = signatures[index].GetPieces();
+        entry.exact = signatures[index].IsExact();
+        if (entry.pieces.empty()) {
+            continue; // Empty signatures never match
+        }
+        max_span = std::max(max_span, signatures[index].GetMaxLength());
+
+        // Longest run of exact bytes, earliest one on ties
+        size_t best_piece = 0;
+        size_t best_offset = 0;
+        size_t best_length = 0;
+        for (size_t p = 0; p < entry.pieces.size(); ++p) {
+            const auto& masks = entry.pieces[p].masks;
+            size_t run = 0;
+            for (size_t i = 0; i <= masks.size(); ++i) {
+                if (i < masks.size() && masks[i] == 0xFF) {
+                    ++run;
+                    continue;
+                }
+                if (run > best_length) {
+                    best_piece = p;
+                    best_offset = i - run;
+                    best_length = run;
+                }
+                run = 0;
+            }
+        }
+
+        if (best_length == 0) {
+            unanchored.push_back(index);
+            continue;
+        }
+
+        entry.anchor_length = best_length;
+        entry.min_back = best_offset;
+        entry.max_back = best_offset;
+        for (size_t p = 0; p <= best_piece; ++p) {
+            entry.min_back += entry.pieces[p].min_gap;
+            entry.max_back += entry.pieces[p].max_gap;
+            if (p < best_piece) {
+                entry.min_back += entry.pieces[p].values.size();
+                entry.max_back += entry.pieces[p].values.size();
+            }
+        }
+
+        const auto& values = entry.pieces[best_piece].values;
+        anchors.emplace_back(values.begin() + static_cast<std::ptrdiff_t>(best_offset),
+                             values.begin() + static_cast<std::ptrdiff_t>(best_offset + best_length));
+        owners.push_back(index);
+    }
+
+    return anchors;
+}
+
+size_t SignatureMatcher::MatchAt(const Compiled& signature, const uint8_t* data, size_t size, size_t offset) const {
+    if (signature.pieces.empty()) {
+        return 0;
+    }
+    const size_t end = MatchFrom(signature, 0, data, size, offset);
+    return end == 0 ? 0 : end - offset;
+}
+
+size_t SignatureMatcher::MatchFrom(const Compiled& signature, size_t piece_index,
+                                   const uint8_t* data, size_t size, size_t position) const {
+    const auto& piece = signature.pieces[piece_index];
+    const size_t length = piece.values.size();
+    if (position > size || size - position < length) {
+        return 0;
+    }
+
+    const uint8_t* bytes = data + position;
+    for (size_t i = 0; i < length; ++i) {
+        if ((bytes[i] & piece.masks[i]) != piece.values[i]) {
+            return 0;
+        }
+    }
+
+    const size_t piece_end = position + length;
+    if (piece_index + 1 == signature.pieces.size()) {
+        return piece_end;
+    }
+
+    // Try the shortest jump first; earlier jumps settle before later ones
+    const auto& next = signature.pieces[piece_index + 1];
+    for (size_t gap = next.min_gap; gap <= next.max_gap; ++gap) {
+        const size_t end = MatchFrom(signature, piece_index + 1, data, size, piece_end + gap);
+        if (end != 0) {
+            return end;
+        }
+    }
+    return 0;
+}
+
+} // namespace mcp
@@ -0,0 +1,298 @@
+#pragma once
+
+#include "byte_signature.hpp"
+#include "mcp/interfaces.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace mcp {
+
+/**
+ * @brief Aho-Corasick automaton over byte strings
+ *
+ * The pattern set is compiled once; Scan() then reports every occurrence of
+ * every pattern in a single left-to-right pass over the input. The scan state
+ * is returned to the caller so a haystack can be fed in several pieces.
+ *
+ * Small automatons are flattened into a dense transition table indexed by
+ * byte class (bytes that never occur in any pattern share one class). Large
+ * ones keep sparse edges and follow failure links at scan time, which bounds
+ * memory at the cost of a few extra branches per byte.
+ *
+ * The compiled tables can be written out with Serialize() and used in place
+ * from a mapped file through FromImage(); copies share the tables.
+ */
+class MultiPatternMatcher {
+public:
+    using State = uint32_t;
+    static constexpr State kInitialState = 0;
+
+    MultiPatternMatcher() = default;  // No patterns; never matches
+    explicit MultiPatternMatcher(const std::vector<std::vector<uint8_t>>& patterns);
+
+    /**
+     * @brief Append the compiled tables to out
+     *
+     * out.size() must be a multiple of 8 so the tables stay aligned when
+     * the buffer is written to a file at an 8-byte boundary.
+     */
+    void Serialize(std::vector<uint8_t>& out) const;
+
+    /**
+     * @brief Matcher over tables written by Serialize(), used without copying
+     *
+     * image must be 8-byte aligned; owner keeps it alive for as long as the
+     * matcher or any copy of it exists. Every index in the tables is checked,
+     * so a damaged image is rejected rather than scanned.
+     */
+    static Result<MultiPatternMatcher> FromImage(const uint8_t* image, size_t size,
+                                                 std::shared_ptr<const void> owner);
+
+    // True when patterns[i] is exactly pattern i of this automaton, for every i
+    bool IsCompiledFrom(const std::vector<std::vector<uint8_t>>& patterns) const;
+
+    size_t GetPatternCount() const { return pattern_lengths_.size(); }
+    size_t GetStateCount() const { return nodes_.size(); }
+    size_t GetPatternLength(size_t pattern_index) const { return pattern_lengths_[pattern_index]; }
+    size_t GetMaxPatternLength() const { return max_pattern_length_; }
+    bool IsDense() const { return !dense_.empty(); }
+
+    /**
+     * @brief Scan a block of bytes
+     * @param on_match Called as on_match(pattern_index, end_offset) where
+     *        end_offset is one past the last matched byte, relative to data.
+     *        Calls arrive in non-decreasing end_offset order.
+     * @return State to pass to the next call when continuing the stream
+     */
+    template<typename Callback>
+    State Scan(const uint8_t* data, size_t size, State state, Callback&& on_match) const {
+        if (nodes_.size() <= 1) {
+            return state;
+        }
+
+        if (!dense_.empty()) {
+            const uint32_t* table = dense_.data();
+            const size_t classes = class_count_;
+            for (size_t i = 0; i < size; ++i) {
+                state = table[state * classes + byte_class_[data[i]]];
+                if (nodes_[state].output_link != kNone || nodes_[state].output_count != 0) {
+                    EmitOutputs(state, i + 1, on_match);
+                }
+            }
+            return state;
+        }
+
+        for (size_t i = 0; i < size; ++i) {
+            state = NextState(state, data[i]);
+            if (nodes_[state].output_link != kNone || nodes_[state].output_count != 0) {
+                EmitOutputs(state, i + 1, on_match);
+            }
+        }
+        return state;
+    }
+
+private:
+    static constexpr uint32_t kNone = 0xFFFFFFFFu;
+
+    struct Node {
+        uint32_t fail = 0;
+        uint32_t output_link = kNone;  // Nearest proper suffix state that has outputs
+        uint32_t first_edge = 0;       // Into edge_bytes_/edge_targets_ (sorted by byte)
+        uint32_t edge_count = 0;
+        uint32_t first_output = 0;     // Into outputs_
+        uint32_t output_count = 0;
+    };
+
+    // Read-only view of one of the tables
+    template<typename T>
+    struct Table {
+        const T* items = nullptr;
+        size_t count = 0;
+
+        const T& operator[](size_t index) const { return items[index]; }
+        const T* data() const { return items; }
+        const T* begin() const { return items; }
+        const T* end() const { return items + count; }
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+    };
+
+    // Tables built by the constructor, before they are published as views
+    struct OwnedTables {
+        std::vector<Node> nodes;
+        std::vector<uint8_t> edge_bytes;
+        std::vector<uint32_t> edge_targets;
+        std::vector<uint32_t> outputs;
+        std::vector<uint32_t> dense;
+    };
+
+    std::shared_ptr<const void> storage_;  // OwnedTables, or whatever backs a mapped image
+    Table<Node> nodes_;
+    Table<uint8_t> edge_bytes_;
+    Table<uint32_t> edge_targets_;
+    Table<uint32_t> outputs_;
+    std::vector<size_t> pattern_lengths_;
+    size_t max_pattern_length_ = 0;
+
+    // Dense representation (empty when the automaton is too large)
+    uint8_t byte_class_[256] = {};
+    size_t class_count_ = 1;
+    Table<uint32_t> dense_;
+    uint32_t root_next_[256] = {};
+
+    template<typename T>
+    static Table<T> ViewOf(const std::vector<T>& items) {
+        return Table<T>{items.data(), items.size()};
+    }
+
+    uint32_t FindEdge(uint32_t state, uint8_t byte) const;
+    Result<void> ValidateImage() const;
+
+    State NextState(State state, uint8_t byte) const {
+        for (;;) {
+            if (state == kInitialState) {
+                return root_next_[byte];
+            }
+            uint32_t next = FindEdge(state, byte);
+            if (next != kNone) {
+                return next;
+            }
+            state = nodes_[state].fail;
+        }
+    }
+
+    template<typename Callback>
+    void EmitOutputs(uint32_t state, size_t end_offset, Callback& on_match) const {
+        uint32_t current = nodes_[state].output_count != 0 ? state : nodes_[state].output_link;
+        while (current != kNone) {
+            const Node& node = nodes_[current];
+            for (uint32_t k = 0; k < node.output_count; ++k) {
+                on_match(static_cast<size_t>(outputs_[node.first_output + k]), end_offset);
+            }
+            current = node.output_link;
+        }
+    }
+
+    void BuildDenseTable(OwnedTables& owned);
+};
+
+/**
+ * @brief Single-pass matcher for a set of masked signatures
+ *
+ * Each signature contributes its longest run of exact bytes (the anchor) to a
+ * MultiPatternMatcher. An anchor hit only proposes candidate start offsets;
+ * the whole signature, masked bytes and jumps included, is then verified in
+ * place. Exact signatures are their own anchor and need no verification.
+ * Signatures without a single exact byte cannot be anchored and are tried at
+ * every offset.
+ */
+class SignatureMatcher {
+public:
+    explicit SignatureMatcher(const std::vector<ByteSignature>& signatures);
+
+    // Reuses anchors when they were compiled from exactly these signatures, e.g. loaded from a file
+    SignatureMatcher(const std::vector<ByteSignature>& signatures, MultiPatternMatcher anchors);
+
+    size_t GetSignatureCount() const { return signatures_.size(); }
+    size_t GetUnanchoredCount() const { return unanchored_.size(); }
+    size_t GetStateCount() const { return anchors_.GetStateCount(); }
+    const MultiPatternMatcher& GetAnchors() const { return anchors_; }
+
+    /**
+     * @brief Longest byte range any signature can cover (jumps at their maximum)
+     */
+    size_t GetMaxSpan() const { return max_span_; }
+
+    /**
+     * @brief Report every offset in [begin, end) where a signature matches
+     *
+     * data/size is the whole haystack; verification may read up to
+     * GetMaxSpan() bytes past end. Calls on_match(signature_index, offset,
+     * length) with offsets ascending for any one signature. When several jump
+     * lengths fit at an offset, the shortest jumps win, earliest piece first.
+     */
+    template<typename Callback>
+    void FindMatches(const uint8_t* data, size_t size, size_t begin, size_t end, Callback&& on_match) const {
+        end = std::min(end, size);
+        if (begin >= end) {
+            return;
+        }
+
+        // First offset not yet verified, per signature; anchor hits arrive in order
+        std::vector<size_t> next_offset(signatures_.size(), begin);
+
+        // Anchors of matches starting in [begin, end) lie inside [begin, end + max span)
+        const size_t scan_end = size - end > max_span_ ? end + max_span_ : size;
+        anchors_.Scan(data + begin, scan_end - begin, MultiPatternMatcher::kInitialState,
+                      [&](size_t anchor_index, size_t anchor_end) {
+            const size_t index = anchor_owners_[anchor_index];
+            const Compiled& signature = signatures_[index];
+            const size_t anchor_start = begin + anchor_end - signature.anchor_length;
+
+            if (signature.exact) {
+                if (anchor_start < end) {
+                    on_match(index, anchor_start, signature.anchor_length);
+                }
+                return;
+            }
+
+            if (anchor_start < signature.min_back) {
+                return;
+            }
+            size_t first = anchor_start >= signature.max_back ? anchor_start - signature.max_back : 0;
+            const size_t last = std::min(anchor_start - signature.min_back, end - 1);
+            first = std::max(first, next_offset[index]);
+            if (first > last) {
+                return;
+            }
+
+            for (size_t offset = first; offset <= last; ++offset) {
+                const size_t length = MatchAt(signature, data, size, offset);
+                if (length != 0) {
+                    on_match(index, offset, length);
+                }
+            }
+            next_offset[index] = last + 1;
+        });
+
+        for (size_t index : unanchored_) {
+            for (size_t offset = begin; offset < end; ++offset) {
+                const size_t length = MatchAt(signatures_[index], data, size, offset);
+                if (length != 0) {
+                    on_match(index, offset, length);
+                }
+            }
+        }
+    }
+
+private:
+    struct Compiled {
+        std::vector<ByteSignature::Piece> pieces;
+        bool exact = false;
+        size_t anchor_length = 0;
+        size_t min_back = 0;  // Distance from signature start to anchor start
+        size_t max_back = 0;
+    };
+
+    std::vector<Compiled> signatures_;
+    std::vector<size_t> anchor_owners_;  // Anchor pattern index -> signature index
+    std::vector<size_t> unanchored_;
+    size_t max_span_ = 0;
+    MultiPatternMatcher anchors_;
+
+    static std::vector<std::vector<uint8_t>> CompileAnchors(const std::vector<ByteSignature>& signatures,
+                                                            std::vector<Compiled>& compiled,
+                                                            std::vector<size_t>& owners,
+                                                            std::vector<size_t>& unanchored,
+                                                            size_t& max_span);
+
+    // Length of the match at offset, 0 when the signature does not match there
+    size_t MatchAt(const Compiled& signature, const uint8_t* data, size_t size, size_t offset) const;
+    size_t MatchFrom(const Compiled& signature, size_t piece_index,
+                     const uint8_t* data, size_t size, size_t position) const;
+};
+
+} // namespace mcp
@@ -0,0 +1,304 @@
+#include "string_scanner.hpp"
+#include <algorithm>
+#include <array>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MCP_STRING_SCANNER_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MCP_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MCP_TARGET_AVX2
+#endif
+
+namespace mcp {
+
+namespace {
+
+constexpr size_t kBlockBytes = 64;
+constexpr size_t kBatchBlocks = 64; // 4 KB classified per kernel call
+
+// Same character set as the original IsValidAsciiChar: 0x20-0x7E plus \t \n \r
+constexpr std::array<uint8_t, 256> MakePrintableTable() {
+    std::array<uint8_t, 256> table{};
+    for (size_t c = 0; c < 256; ++c) {
+        table[c] = ((c >= 32 && c <= 126) || c == '\t' || c == '\n' || c == '\r') ? 1 : 0;
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> kPrintable = MakePrintableTable();
+
+inline size_t CountTrailingZeros(uint64_t value) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return index;
+#elif defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_ctzll(value));
+#else
+    size_t count = 0;
+    while ((value & 1) == 0) {
+        value >>= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+using ClassifyFn = void (*)(const uint8_t* data, size_t block_count, uint64_t* printable, uint64_t* zero);
+
+void ClassifyScalar(const uint8_t* data, size_t block_count, uint64_t* printable, uint64_t* zero) {
+    for (size_t b = 0; b < block_count; ++b) {
+        const uint8_t* block = data + b * kBlockBytes;
+        uint64_t p = 0;
+        uint64_t z = 0;
+        for (size_t i = 0; i < kBlockBytes; ++i) {
+            p |= static_cast<uint64_t>(kPrintable[block[i]]) << i;
+            z |= static_cast<uint64_t>(block[i] == 0) << i;
+        }
+        printable[b] = p;
+        zero[b] = z;
+    }
+}
+
+#ifdef MCP_STRING_SCANNER_X86
+// c in [0x20, 0x7E] <=> (int8)(c + 0x60) < -33; tab, LF and CR are added separately
+
+void ClassifySse2(const uint8_t* data, size_t block_count, uint64_t* printable, uint64_t* zero) {
+    const __m128i bias = _mm_set1_epi8(0x60);
+    const __m128i limit = _mm_set1_epi8(-33);
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i nul = _mm_setzero_si128();
+
+    for (size_t b = 0; b < block_count; ++b) {
+        const uint8_t* block = data + b * kBlockBytes;
+        uint64_t p = 0;
+        uint64_t z = 0;
+        for (size_t lane = 0; lane < 4; ++lane) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + lane * 16));
+            __m128i is_printable = _mm_cmplt_epi8(_mm_add_epi8(v, bias), limit);
+            is_printable = _mm_or_si128(is_printable, _mm_cmpeq_epi8(v, tab));
+            is_printable = _mm_or_si128(is_printable, _mm_cmpeq_epi8(v, lf));
+            is_printable = _mm_or_si128(is_printable, _mm_cmpeq_epi8(v, cr));
+            p |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(is_printable))) << (lane * 16);
+            z |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, nul)))) << (lane * 16);
+        }
+        printable[b] = p;
+        zero[b] = z;
+    }
+}
+
+MCP_TARGET_AVX2
+void ClassifyAvx2(const uint8_t* data, size_t block_count, uint64_t* printable, uint64_t* zero) {
+    const __m256i bias = _mm256_set1_epi8(0x60);
+    const __m256i limit = _mm256_set1_epi8(-33);
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i nul = _mm256_setzero_si256();
+
+    for (size_t b = 0; b < block_count; ++b) {
+        const uint8_t* block = data + b * kBlockBytes;
+        uint64_t p = 0;
+        uint64_t z = 0;
+        for (size_t lane = 0; lane < 2; ++lane) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + lane * 32));
+            __m256i is_printable = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(v, bias));
+            is_printable = _mm256_or_si256(is_printable, _mm256_cmpeq_epi8(v, tab));
+            is_printable = _mm256_or_si256(is_printable, _mm256_cmpeq_epi8(v, lf));
+            is_printable = _mm256_or_si256(is_printable, _mm256_cmpeq_epi8(v, cr));
+            p |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(is_printable))) << (lane * 32);
+            z |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nul)))) << (lane * 32);
+        }
+        printable[b] = p;
+        zero[b] = z;
+    }
+}
+
+bool CpuSupportsAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+#endif // MCP_STRING_SCANNER_X86
+
+struct Kernel {
+    ClassifyFn classify;
+    const char* name;
+};
+
+const Kernel& SelectedKernel() {
+    static const Kernel kernel = [] {
+#ifdef MCP_STRING_SCANNER_X86
+        if (CpuSupportsAvx2()) {
+            return Kernel{ClassifyAvx2, "avx2"};
+        }
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        return Kernel{ClassifySse2, "sse2"};
+#endif
+#endif
+        return Kernel{ClassifyScalar, "scalar"};
+    }();
+    return kernel;
+}
+
+} // anonymous namespace
+
+StringRunScanner::StringRunScanner(size_t min_length, bool include_ascii, bool include_wide)
+    : min_length_(std::max<size_t>(min_length, 1)),
+      include_ascii_(include_ascii),
+      include_wide_(include_wide) {
+}
+
+const char* StringRunScanner::GetKernelName() {
+    return SelectedKernel().name;
+}
+
+void StringRunScanner::Scan(const uint8_t* data, size_t size) {
+    const ClassifyFn classify = SelectedKernel().classify;
+    uint64_t printable[kBatchBlocks];
+    uint64_t zero[kBatchBlocks];
+
+    size_t done = 0;
+    while (size - done >= kBlockBytes) {
+        const size_t blocks = std::min(kBatchBlocks, (size - done) / kBlockBytes);
+        classify(data + done, blocks, printable, zero);
+        ProcessMasks(printable, zero, blocks, kBlockBytes);
+        done += blocks * kBlockBytes;
+    }
+
+    if (done < size) {
+        // Partial trailing block; bits past the end stay clear
+        const size_t tail = size - done;
+        uint64_t p = 0;
+        uint64_t z = 0;
+        for (size_t i = 0; i < tail; ++i) {
+            p |= static_cast<uint64_t>(kPrintable[data[done + i]]) << i;
+            z |= static_cast<uint64_t>(data[done + i] == 0) << i;
+        }
+        ProcessMasks(&p, &z, 1, tail);
+    }
+}
+
+void StringRunScanner::ProcessMasks(const uint64_t* printable, const uint64_t* zero,
+                                    size_t block_count, size_t bit_count) {
+    // A UTF-16LE character starts at an even bit: printable low byte, zero high byte
+    constexpr uint64_t kEvenBits = 0x5555555555555555ull;
+
+    for (size_t b = 0; b < block_count; ++b) {
+        const size_t valid_bits = (b + 1 == block_count) ? bit_count : kBlockBytes;
+
+        if (include_ascii_) {
+            ExtractRuns(printable[b], valid_bits, position_, false);
+        }
+        if (include_wide_) {
+            const uint64_t starts = printable[b] & (zero[b] >> 1) & kEvenBits;
+            ExtractRuns(starts | (starts << 1), valid_bits, position_, true);
+        }
+
+        position_ += valid_bits;
+    }
+}
+
+void StringRunScanner::ExtractRuns(uint64_t mask, size_t valid_bits, size_t block_offset, bool wide) {
+    bool& open = wide ? wide_open_ : ascii_open_;
+    size_t& start = wide ? wide_start_ : ascii_start_;
+    auto& runs = wide ? wide_runs_ : ascii_runs_;
+
+    // Common cases: a block entirely inside a run or entirely outside one
+    if (open && valid_bits == kBlockBytes && mask == ~0ull) {
+        return;
+    }
+    if (!open && mask == 0) {
+        return;
+    }
+
+    size_t bit = 0;
+    while (bit < valid_bits) {
+        if (open) {
+            const uint64_t rest = ~mask >> bit;
+            const size_t end = rest == 0 ? kBlockBytes : bit + CountTrailingZeros(rest);
+            if (end >= valid_bits) {
+                break; // Run continues into the next block
+            }
+
+            const size_t length = (block_offset + end - start) / (wide ? 2 : 1);
+            if (length >= min_length_) {
+                runs.push_back({start, length, wide});
+            }
+            open = false;
+            bit = end;
+        } else {
+            const uint64_t rest = mask >> bit;
+            if (rest == 0) {
+                break;
+            }
+            const size_t begin = bit + CountTrailingZeros(rest);
+            if (begin >= valid_bits) {
+                break;
+            }
+            open = true;
+            start = block_offset + begin;
+            bit = begin;
+        }
+    }
+}
+
+void StringRunScanner::Finish() {
+    if (ascii_open_) {
+        const size_t length = position_ - ascii_start_;
+        if (length >= min_length_) {
+            ascii_runs_.push_back({ascii_start_, length, false});
+        }
+        ascii_open_ = false;
+    }
+    if (wide_open_) {
+        const size_t length = (position_ - wide_start_) / 2;
+        if (length >= min_length_) {
+            wide_runs_.push_back({wide_start_, length, true});
+        }
+        wide_open_ = false;
+    }
+}
+
+size_t StringRunScanner::GetOpenRunStart() const {
+    size_t start = position_;
+    if (ascii_open_) {
+        start = std::min(start, ascii_start_);
+    }
+    if (wide_open_) {
+        start = std::min(start, wide_start_);
+    }
+    return start;
+}
+
+void StringRunScanner::ClearRuns() {
+    ascii_runs_.clear();
+    wide_runs_.clear();
+}
+
+} // namespace mcp
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mcp {
+
+/**
+ * @brief Printable run found by StringRunScanner
+ *
+ * offset is relative to the start of the scanned stream, length counts
+ * characters (a wide run covers 2 * length bytes).
+ */
+struct StringRun {
+    size_t offset;
+    size_t length;
+    bool is_wide;
+};
+
+/**
+ * @brief Single-pass ASCII and UTF-16LE string run detector
+ *
+ * Bytes are classified 64 at a time into "printable" and "zero" bit masks by
+ * a SIMD kernel picked at runtime (AVX2, SSE2 or a scalar table). ASCII runs
+ * and UTF-16LE runs (printable low byte, zero high byte, pairs aligned to
+ * even stream offsets) are then both read off the same masks with bit
+ * operations, so each input byte is touched once.
+ *
+ * Data may be fed in pieces; runs that straddle Scan() calls are stitched.
+ * Every piece except the last one must have an even size when wide strings
+ * are enabled, so that UTF-16 pairs stay aligned.
+ */
+class StringRunScanner {
+public:
+    StringRunScanner(size_t min_length, bool include_ascii, bool include_wide);
+
+    void Scan(const uint8_t* data, size_t size);
+
+    /**
+     * @brief Close runs still open at the end of the stream
+     */
+    void Finish();
+
+    size_t GetPosition() const { return position_; }
+    bool HasOpenRuns() const { return ascii_open_ || wide_open_; }
+
+    /**
+     * @brief Earliest start offset of a run that is still open, GetPosition() if none
+     */
+    size_t GetOpenRunStart() const;
+
+    // Completed runs, each list in offset order
+    const std::vector<StringRun>& GetAsciiRuns() const { return ascii_runs_; }
+    const std::vector<StringRun>& GetWideRuns() const { return wide_runs_; }
+    void ClearRuns();
+
+    /**
+     * @brief Name of the classification kernel selected for this CPU
+     */
+    static const char* GetKernelName();
+
+    static bool IsPrintable(uint8_t c) {
+        return (c >= 32 && c <= 126) || c == '\t' || c == '\n' || c == '\r';
+    }
+
+private:
+    size_t min_length_;
+    bool include_ascii_;
+    bool include_wide_;
+    size_t position_ = 0;
+
+    bool ascii_open_ = false;
+    size_t ascii_start_ = 0;
+    bool wide_open_ = false;
+    size_t wide_start_ = 0;
+
+    std::vector<StringRun> ascii_runs_;
+    std::vector<StringRun> wide_runs_;
+
+    void ProcessMasks(const uint64_t* printable, const uint64_t* zero, size_t block_count, size_t bit_count);
+    void ExtractRuns(uint64_t mask, size_t valid_bits, size_t block_offset, bool wide);
+};
+
+} // namespace mcp
@@ -1,4 +1,7 @@
 #include "cli_interface.hpp"
+#include "../core/core_engine.hpp"
+#include "../x64dbg/x64dbg_bridge.hpp"
+#include "../parser/sexpr_stream.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -11,6 +14,7 @@
 #include <conio.h>
 #include <io.h>
 #define STDOUT_FILENO _fileno(stdout)
+#define STDIN_FILENO _fileno(stdin)
 #define isatty _isatty
 #else
 #include <termios.h>
@@ -110,6 +114,10 @@ int CLIInterface::Run(int argc, const char* argv[]) {
 }
 
 int CLIInterface::RunInteractive() {
+    // A session will need the remaining modules; build them while the user types
+    if (auto engine = std::dynamic_pointer_cast<CoreEngine>(core_engine_)) {
+        engine->PreloadModules(false);
+    }
     if (!config_.quiet) {
         ShowBanner();
     }
@@ -121,34 +129,17 @@ int CLIInterface::RunInteractive() {
 }
 
 int CLIInterface::RunScript(const std::string& script_file) {
-    std::ifstream file(script_file);
+    std::ifstream file(script_file, std::ios::binary);
     if (!file.is_open()) {
         PrintError("Failed to open script file: " + script_file);
         return 1;
     }
     
-    std::string line;
-    int line_number = 1;
-    int error_count = 0;
-    
-    while (std::getline(file, line)) {
-        if (line.empty() || line[0] == ';') { // Skip empty lines and comments
-            line_number++;
-            continue;
-        }
-        
-        auto result = ProcessCommand(line);
-        if (result.IsSuccess()) {
-            if (!config_.quiet) {
-                PrintOutput(result.Value());
-            }
-        } else {
-            PrintError("Line " + std::to_string(line_number) + ": " + result.Error());
-            error_count++;
-        }
-        
-        line_number++;
-    }
+    // One linear pass in large chunks; forms may span lines and chunks
+    const int error_count = RunStream([&file](char* buffer, size_t size) -> size_t {
+        file.read(buffer, static_cast<std::streamsize>(size));
+        return static_cast<size_t>(file.gcount());
+    }, !config_.quiet);
     
     if (error_count > 0) {
         PrintError("Script completed with " + std::to_string(error_count) + " errors");
@@ -172,9 +163,52 @@ int CLIInterface::RunCommand(const std::string& command) {
 int CLIInterface::RunDaemon() {
     PrintInfo("Starting MCP Debugger in daemon mode...");
     
-    // TODO: Implement daemon mode with TCP/pipe server
-    // For now, just run interactive mode
-    return RunInteractive();
+    // TODO: Implement daemon mode with TCP server
+    if (isatty(STDIN_FILENO)) {
+        return RunInteractive();
+    }
+    
+    // Piped command stream: read whatever has arrived, run forms as soon as they close
+    RunStream([](char* buffer, size_t size) -> size_t {
+#ifdef _WIN32
+        const int count = _read(STDIN_FILENO, buffer, static_cast<unsigned int>(size));
+#else
+        const ssize_t count = ::read(STDIN_FILENO, buffer, size);
+#endif
+        return count > 0 ? static_cast<size_t>(count) : 0;
+    }, true);
+    return 0;
+}
+
+int CLIInterface::RunStream(const std::function<size_t(char*, size_t)>& read_chunk, bool print_results) {
+    constexpr size_t kChunkSize = 64 * 1024;
+    std::vector<char> buffer(kChunkSize);
+    SExprStreamParser stream;
+    int error_count = 0;
+    
+    const auto on_form = [&](const Result<std::string_view>& form, size_t line) {
+        if (!form.IsSuccess()) {
+            PrintError("Line " + std::to_string(line) + ": " + form.Error());
+            error_count++;
+            return;
+        }
+        auto result = ProcessCommand(std::string(form.Value()));
+        if (result.IsSuccess()) {
+            if (print_results) {
+                PrintOutput(result.Value());
+            }
+        } else {
+            PrintError("Line " + std::to_string(line) + ": " + result.Error());
+            error_count++;
+        }
+    };
+    
+    for (size_t count = read_chunk(buffer.data(), buffer.size()); count > 0;
+         count = read_chunk(buffer.data(), buffer.size())) {
+        stream.Feed(std::string_view(buffer.data(), count), on_form);
+    }
+    stream.Finish(on_form);
+    return error_count;
 }
 
 void CLIInterface::StartREPL() {
@@ -196,20 +230,22 @@ void CLIInterface::REPLLoop() {
                 continue;
             }
             
-            // Check for multiline input
-            if (IsMultilineInput(input)) {
-                input = ReadMultilineInput(input);
+            // Forms run as soon as they close; an unfinished one keeps reading lines
+            for (const auto& form : ReadMultilineInput(input)) {
+                if (!form.IsSuccess()) {
+                    PrintError(form.Error());
+                    continue;
+                }
+                auto result = ProcessCommand(form.Value());
+                if (result.IsSuccess()) {
+                    PrintOutput(result.Value());
+                } else {
+                    PrintError(result.Error());
+                }
             }
             
             AddToHistory(input);
             
-            auto result = ProcessCommand(input);
-            if (result.IsSuccess()) {
-                PrintOutput(result.Value());
-            } else {
-                PrintError(result.Error());
-            }
-            
         } catch (const std::exception& ex) {
             HandleException(ex);
         } catch (...) {
@@ -368,6 +404,26 @@ Result<std::string> CLIInterface::HandleLLMCommand(const std::vector<SExpression
     }
     
     PrintInfo("Sending request to LLM...");
+
+    if (repl_running_) {
+        // Show the answer as it is generated rather than after the last token
+        std::cout << ColorizeOutput("LLM Response:", "cyan") << std::endl;
+        auto stream_result = llm_engine->SendRequestStreaming(request, [](const std::string& chunk) {
+            std::cout << chunk;
+            std::cout.flush();
+            return true;
+        }).get();
+        std::cout << std::endl;
+        if (!stream_result.IsSuccess()) {
+            return Result<std::string>::Error("LLM request failed: " + stream_result.Error());
+        }
+
+        const LLMResponse& streamed = stream_result.Value();
+        std::ostringstream summary;
+        summary << "(" << streamed.provider << ", " << streamed.response_time.count() << "ms, "
+                << streamed.content.size() << " chars)";
+        return Result<std::string>::Success(summary.str());
+    }
     
     auto response_result = llm_engine->SendRequestSync(request);
     if (!response_result.IsSuccess()) {
@@ -477,6 +533,7 @@ void CLIInterface::RegisterBuiltinCommands() {
     builtin_commands_["status"] = [this](const std::vector<SExpression>& args) { return BuiltinStatus(args); };
     builtin_commands_["connect"] = [this](const std::vector<SExpression>& args) { return BuiltinConnect(args); };
     builtin_commands_["disconnect"] = [this](const std::vector<SExpression>& args) { return BuiltinDisconnect(args); };
+    builtin_commands_["stats"] = [this](const std::vector<SExpression>& args) { return BuiltinStats(args); };
 }
 
 Result<std::string> CLIInterface::BuiltinHelp(const std::vector<SExpression>& /* args */) {
@@ -491,7 +548,8 @@ Result<std::string> CLIInterface::BuiltinHelp(const std::vector<SExpression>& /*
     help << "  :config             - Show configuration\n";
     help << "  :status             - Show system status\n";
     help << "  :connect            - Connect to debugger\n";
-    help << "  :disconnect         - Disconnect from debugger\n\n";
+    help << "  :disconnect         - Disconnect from debugger\n";
+    help << "  :stats [json|reset] - Show bridge latency and traffic statistics\n\n";
     help << "S-Expression Commands:\n";
     help << "  (llm \"prompt\")       - Send prompt to LLM\n";
     help << "  (dbg \"command\")      - Execute debugger command\n";
@@ -537,6 +595,9 @@ Result<std::string> CLIInterface::BuiltinStatus(const std::vector<SExpression>&
     
     status << "  History Size: " << command_history_.size() << "\n";
     status << "  Session Variables: " << session_variables_.size() << "\n";
+    if (auto engine = std::dynamic_pointer_cast<CoreEngine>(core_engine_)) {
+        status << engine->GetStartupReport().ToString();
+    }
     
     return Result<std::string>::Success(status.str());
 }
@@ -678,27 +739,30 @@ Result<std::string> CLIInterface::PreprocessInput(const std::string& input) {
     return Result<std::string>::Success(processed);
 }
 
-bool CLIInterface::IsMultilineInput(const std::string& input) {
-    // Simple check for unmatched parentheses
-    int paren_count = 0;
-    for (char c : input) {
-        if (c == '(') paren_count++;
-        else if (c == ')') paren_count--;
-    }
-    return paren_count > 0;
-}
-
-std::string CLIInterface::ReadMultilineInput(const std::string& initial_input) {
-    std::string result = initial_input;
+std::vector<Result<std::string>> CLIInterface::ReadMultilineInput(std::string& input) {
+    // Each continuation line is scanned once; the scanner keeps its place between lines
+    SExprStreamParser stream;
+    std::vector<Result<std::string>> forms;
+    const auto on_form = [&forms](const Result<std::string_view>& form, size_t /* line */) {
+        forms.push_back(form.IsSuccess() ? Result<std::string>::Success(std::string(form.Value()))
+                                         : Result<std::string>::Error(form.Error()));
+    };
+    
+    stream.Feed(input, on_form);
+    stream.Feed("\n", on_form);
     std::string line;
-    
-    while (IsMultilineInput(result)) {
+    while (!stream.IsIdle() && repl_running_) {
         PrintPrompt("... ");
-        std::getline(std::cin, line);
-        result += " " + line;
+        if (!std::getline(std::cin, line)) {
+            break;
+        }
+        input += " " + line;
+        stream.Feed(line, on_form);
+        stream.Feed("\n", on_form);
     }
+    stream.Finish(on_form);
     
-    return result;
+    return forms;
 }
 
 void CLIInterface::LoadHistory() {
@@ -734,6 +798,8 @@ Result<void> CLIInterface::ParseCommandLine(int argc, const char* argv[]) {
                 config_.mode = Mode::SCRIPT;
                 config_.script_file = argv[++i];
             }
+        } else if (arg == "-d" || arg == "--daemon") {
+            config_.mode = Mode::DAEMON;
         }
     }
     
@@ -753,6 +819,7 @@ void CLIInterface::ShowUsage() {
     std::cout << "  -q, --quiet        Quiet mode\n";
     std::cout << "  -c, --command CMD  Execute single command\n";
     std::cout << "  -f, --file FILE    Execute script file\n";
+    std::cout << "  -d, --daemon       Run commands piped to stdin\n";
 }
 
 void CLIInterface::ShowVersion() {
@@ -826,7 +893,8 @@ Result<std::string> CLIInterface::HandleConfigCommand(const std::vector<SExpress
     
     if (args.empty()) {
         // Show current configuration
-        const Config& cfg = config_mgr->GetConfig();
+        const auto snapshot = config_mgr->GetSnapshot();
+        const Config& cfg = *snapshot;
         std::ostringstream config_str;
         config_str << "Current Configuration:\n";
         config_str << "  API Configs: " << cfg.api_configs.size() << " providers\n";
@@ -931,4 +999,31 @@ Result<std::string> CLIInterface::BuiltinDisconnect(const std::vector<SExpressio
     }
 }
 
-} // namespace mcp
\ No newline at end of file
+Result<std::string> CLIInterface::BuiltinStats(const std::vector<SExpression>& args) {
+    if (!core_engine_) {
+        return Result<std::string>::Error("Core engine not available");
+    }
+
+    auto bridge = std::dynamic_pointer_cast<X64DbgBridge>(core_engine_->GetDebugBridge());
+    if (!bridge) {
+        return Result<std::string>::Error("Debug bridge not available");
+    }
+
+    std::string mode;
+    if (!args.empty() && std::holds_alternative<std::string>(args[0].value)) {
+        mode = std::get<std::string>(args[0].value);
+    }
+
+    if (mode == "reset") {
+        bridge->ResetStats();
+        return Result<std::string>::Success("Bridge statistics reset");
+    }
+    if (!mode.empty() && mode != "json") {
+        return Result<std::string>::Error("Usage: :stats [json|reset]");
+    }
+
+    const auto format = mode == "json" ? X64DbgBridge::StatsFormat::JSON : X64DbgBridge::StatsFormat::TEXT;
+    return Result<std::string>::Success(X64DbgBridge::FormatStats(bridge->GetStats(), format));
+}
+
+} // namespace mcp
@@ -5,6 +5,7 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <functional>
 #include <unordered_map>
 #include <mutex>
 #include <atomic>
@@ -48,6 +49,8 @@ public:
     int RunScript(const std::string& script_file);
     int RunCommand(const std::string& command);
     int RunDaemon();
+    // Feeds read_chunk's bytes through the stream parser until it returns 0; returns the error count
+    int RunStream(const std::function<size_t(char*, size_t)>& read_chunk, bool print_results);
 
     // Configuration
     Result<void> ParseCommandLine(int argc, const char* argv[]);
@@ -95,8 +98,8 @@ private:
     
     // Input processing
     Result<std::string> PreprocessInput(const std::string& input);
-    bool IsMultilineInput(const std::string& input);
-    std::string ReadMultilineInput(const std::string& initial_input);
+    // Reads continuation lines until every form in input is closed; input gains those lines
+    std::vector<Result<std::string>> ReadMultilineInput(std::string& input);
     
     // Command routing
     Result<std::string> RouteCommand(const SExpression& expr);
@@ -118,6 +121,7 @@ private:
     Result<std::string> BuiltinStatus(const std::vector<SExpression>& args);
     Result<std::string> BuiltinConnect(const std::vector<SExpression>& args);
     Result<std::string> BuiltinDisconnect(const std::vector<SExpression>& args);
+    Result<std::string> BuiltinStats(const std::vector<SExpression>& args);
     
     // Output formatting
     void PrintOutput(const std::string& output);
@@ -1,30 +1,48 @@
 #include "config_manager.hpp"
 #include "mcp/types.hpp"
+#include <algorithm>
 #include <fstream>
 #include <string>
 #include <mutex>
 #include <exception>
+#include <system_error>
+#include <utility>
 
 namespace mcp {
 
-ConfigManager::ConfigManager() = default;
+ConfigManager::ConfigManager()
+    : snapshot_(std::make_shared<const Config>()) {
+    published_.push_back(snapshot_);
+}
+
+ConfigManager::~ConfigManager() {
+    StopWatching();
+}
 
 Result<void> ConfigManager::LoadConfig(const std::string& path) {
-    const std::lock_guard<std::mutex> lock(config_mutex_);
-    config_path_ = path;
+    const std::lock_guard<std::mutex> publish(publish_mutex_);
+    std::shared_ptr<const Config> snapshot;
+    uint32_t changed = 0;
+    {
+        const std::lock_guard<std::mutex> lock(config_mutex_);
+        config_path_ = path;
 
-    std::ifstream file(path);
-    if (!file.is_open()) {
-        return mcp::Result<void>::Error("Failed to open config file: " + path);
-    }
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            return mcp::Result<void>::Error("Failed to open config file: " + path);
+        }
 
-    try {
-        config_data_ = json::parse(file);
-        // Update config_obj_ from JSON
-        UpdateConfigFromJson();
-    } catch (const json::parse_error& e) {
-        return mcp::Result<void>::Error("Failed to parse config file: " + std::string(e.what()));
+        json parsed;
+        try {
+            parsed = json::parse(file);
+        } catch (const json::parse_error& e) {
+            return mcp::Result<void>::Error("Failed to parse config file: " + std::string(e.what()));
+        }
+        changed = ChangedSections(config_data_, parsed);
+        config_data_ = std::move(parsed);
+        snapshot = Publish();
     }
+    Notify(snapshot, changed);
 
     return mcp::Result<void>::Success();
 }
@@ -47,7 +65,9 @@ Result<void> ConfigManager::SaveConfig(const std::string& path) {
 }
 
 Result<void> ConfigManager::SetDefaults() {
-    const std::lock_guard<std::mutex> lock(config_mutex_);
+    const std::lock_guard<std::mutex> publish(publish_mutex_);
+    std::unique_lock<std::mutex> lock(config_mutex_);
+    const json previous = std::move(config_data_);
     
     // Set default configuration
     config_data_ = json{
@@ -64,18 +84,58 @@ Result<void> ConfigManager::SetDefaults() {
             }}
         }},
         {"default_provider", "openai"},
+        {"llm_config", {
+            {"response_cache", true},
+            {"cache_entries", 512},
+            {"cache_ttl_seconds", 86400},
+            {"cache_directory", ""},
+            {"cache_disk_mb", 256},
+            {"failover", false},
+            {"context_tokens", 6000},
+            {"response_tokens", 1024}
+        }},
         {"debug_config", {
             {"x64dbg_path", "C:\\x64dbg\\x64dbg.exe"},
-            {"connection_timeout_ms", 5000}
+            {"connection_timeout_ms", 5000},
+            {"tcp_host", "127.0.0.1"},
+            {"tcp_port", 27042},
+            {"memory_cache_pages", 256},
+            {"event_queue_capacity", 4096},
+            {"event_overflow_policy", "block"},
+            {"stats_export_interval_ms", 0},
+            {"stats_export_path", ""}
         }},
         {"log_config", {
             {"level", "INFO"},
             {"file_path", "mcp_debugger.log"},
-            {"max_size_mb", 10}
-        }}
+            {"max_size_mb", 10},
+            {"overflow_policy", "drop_newest"},
+            {"trace_path", ""}
+        }},
+        {"security_config", {
+            {"encryption_key_path", ""},
+            {"credential_store_path", "credentials.encrypted"},
+            {"require_api_key_validation", true},
+            {"encrypt_credentials", true},
+            {"key_rotation_days", 90},
+            {"credential_cache_seconds", 60}
+        }},
+        {"analysis_config", {
+            {"worker_threads", 0},
+            {"chunk_size_kb", 4096},
+            {"entropy_window", 4096},
+            {"entropy_step", 1024},
+            {"high_entropy_threshold", 7.2},
+            {"pattern_database", ""},
+            {"compiled_pattern_database", ""}
+        }},
+        {"hot_reload_interval_ms", 0}
     };
     
-    UpdateConfigFromJson();
+    const uint32_t changed = ChangedSections(previous, config_data_);
+    auto snapshot = Publish();
+    lock.unlock();
+    Notify(snapshot, changed);
     return mcp::Result<void>::Success();
 }
 
@@ -83,7 +143,7 @@ Result<std::string> ConfigManager::GetValue(const std::string& key) {
     const std::lock_guard<std::mutex> lock(config_mutex_);
     try {
         json::json_pointer ptr(key);
-        json value = config_data_.at(ptr);
+        const json& value = config_data_.at(ptr);
         if (value.is_string()) {
             return mcp::Result<std::string>::Success(value.get<std::string>());
         } else {
@@ -95,20 +155,169 @@ Result<std::string> ConfigManager::GetValue(const std::string& key) {
 }
 
 Result<void> ConfigManager::SetValue(const std::string& key, const std::string& value) {
-    const std::lock_guard<std::mutex> lock(config_mutex_);
-    try {
-        json::json_pointer ptr(key);
-        config_data_[ptr] = value;
-        UpdateConfigFromJson();
-        return mcp::Result<void>::Success();
-    } catch (const json::exception& e) {
-        return mcp::Result<void>::Error("Failed to set config key '" + key + "': " + e.what());
+    const std::lock_guard<std::mutex> publish(publish_mutex_);
+    std::shared_ptr<const Config> snapshot;
+    uint32_t changed = 0;
+    {
+        const std::lock_guard<std::mutex> lock(config_mutex_);
+        try {
+            json::json_pointer ptr(key);
+            json updated = config_data_;
+            updated[ptr] = value;
+            changed = ChangedSections(config_data_, updated);
+            config_data_ = std::move(updated);
+            snapshot = Publish();
+        } catch (const json::exception& e) {
+            return mcp::Result<void>::Error("Failed to set config key '" + key + "': " + e.what());
+        }
     }
+    Notify(snapshot, changed);
+    return mcp::Result<void>::Success();
 }
 
 const Config& ConfigManager::GetConfig() const {
-    const std::lock_guard<std::mutex> lock(config_mutex_);
-    return config_obj_;
+    // published_ holds the latest snapshots, so the reference outlives the next few reloads
+    return *std::atomic_load(&snapshot_);
+}
+
+std::shared_ptr<const Config> ConfigManager::GetSnapshot() const {
+    return std::atomic_load(&snapshot_);
+}
+
+size_t ConfigManager::Subscribe(Listener listener) {
+    const std::lock_guard<std::mutex> lock(listeners_mutex_);
+    const size_t id = next_listener_id_++;
+    listeners_.emplace_back(id, std::make_shared<Listener>(std::move(listener)));
+    return id;
+}
+
+void ConfigManager::Unsubscribe(size_t id) {
+    const std::lock_guard<std::mutex> publish(publish_mutex_);
+    const std::lock_guard<std::mutex> lock(listeners_mutex_);
+    listeners_.erase(std::remove_if(listeners_.begin(), listeners_.end(),
+                                    [id](const auto& entry) { return entry.first == id; }),
+                     listeners_.end());
+}
+
+Result<void> ConfigManager::WatchFile(std::chrono::milliseconds interval) {
+    StopWatching();
+    if (interval.count() <= 0) {
+        return mcp::Result<void>::Success();
+    }
+
+    std::string path;
+    {
+        const std::lock_guard<std::mutex> lock(config_mutex_);
+        path = config_path_;
+    }
+    if (path.empty()) {
+        return mcp::Result<void>::Error("No config file loaded to watch");
+    }
+    // Writers may keep the timestamp within one tick, so the size is compared too
+    auto stamp_of = [path](std::error_code& error) {
+        const auto time = std::filesystem::last_write_time(path, error);
+        const auto size = error ? std::uintmax_t(0) : std::filesystem::file_size(path, error);
+        return std::make_pair(time, size);
+    };
+    std::error_code error;
+    auto stamp = stamp_of(error);
+    if (error) {
+        return mcp::Result<void>::Error("Failed to watch config file: " + path);
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(watch_mutex_);
+        watch_stop_ = false;
+        last_reload_error_.clear();
+    }
+    watch_thread_ = std::thread([this, interval, path, stamp, stamp_of]() mutable {
+        std::unique_lock<std::mutex> lock(watch_mutex_);
+        while (!watch_condition_.wait_for(lock, interval, [this]() { return watch_stop_; })) {
+            std::error_code watch_error;
+            const auto current = stamp_of(watch_error);
+            if (watch_error || current == stamp) {
+                continue;
+            }
+            stamp = current;
+            lock.unlock();
+            // A half-written file fails to parse and is retried once it changes again
+            auto result = LoadConfig(path);
+            lock.lock();
+            last_reload_error_ = result.IsSuccess() ? std::string() : result.Error();
+        }
+    });
+    return mcp::Result<void>::Success();
+}
+
+void ConfigManager::StopWatching() {
+    {
+        const std::lock_guard<std::mutex> lock(watch_mutex_);
+        watch_stop_ = true;
+    }
+    watch_condition_.notify_all();
+    if (watch_thread_.joinable()) {
+        watch_thread_.join();
+    }
+}
+
+std::string ConfigManager::GetLastReloadError() const {
+    const std::lock_guard<std::mutex> lock(watch_mutex_);
+    return last_reload_error_;
+}
+
+std::shared_ptr<const Config> ConfigManager::Publish() {
+    auto snapshot = BuildSnapshot();
+    published_.push_back(snapshot);
+    if (published_.size() > kRetainedSnapshots) {
+        published_.pop_front();
+    }
+    std::atomic_store(&snapshot_, snapshot);
+    generation_.fetch_add(1, std::memory_order_release);
+    return snapshot;
+}
+
+void ConfigManager::Notify(const std::shared_ptr<const Config>& config, uint32_t changed_sections) {
+    if (changed_sections == 0) {
+        return;
+    }
+    std::vector<std::shared_ptr<Listener>> listeners;
+    {
+        const std::lock_guard<std::mutex> lock(listeners_mutex_);
+        for (const auto& entry : listeners_) {
+            listeners.push_back(entry.second);
+        }
+    }
+    for (const auto& listener : listeners) {
+        (*listener)(config, changed_sections);
+    }
+}
+
+uint32_t ConfigManager::ChangedSections(const json& before, const json& after) {
+    auto section_of = [](const std::string& key) -> uint32_t {
+        if (key == "api_configs" || key == "llm_providers" || key == "default_provider") return SECTION_API;
+        if (key == "llm_config") return SECTION_LLM;
+        if (key == "debug_config") return SECTION_DEBUG;
+        if (key == "log_config" || key == "log_level") return SECTION_LOG;
+        if (key == "security_config") return SECTION_SECURITY;
+        if (key == "analysis_config") return SECTION_ANALYSIS;
+        return SECTION_OTHER;
+    };
+
+    uint32_t changed = 0;
+    // Keys on either side that the other lacks or holds differently
+    auto compare = [&changed, &section_of](const json& from, const json& to) {
+        if (!from.is_object()) {
+            return;
+        }
+        for (auto it = from.begin(); it != from.end(); ++it) {
+            if (!to.is_object() || !to.contains(it.key()) || to[it.key()] != it.value()) {
+                changed |= section_of(it.key());
+            }
+        }
+    };
+    compare(before, after);
+    compare(after, before);
+    return changed;
 }
 
 const json& ConfigManager::GetConfigJson() const {
@@ -116,25 +325,96 @@ const json& ConfigManager::GetConfigJson() const {
     return config_data_;
 }
 
-void ConfigManager::UpdateConfigFromJson() {
+std::shared_ptr<const Config> ConfigManager::BuildSnapshot() const {
+    // Sections missing from the JSON keep their previous values
+    auto next = std::make_shared<Config>(*std::atomic_load(&snapshot_));
+    UpdateConfigFromJson(*next);
+    return next;
+}
+
+void ConfigManager::UpdateConfigFromJson(Config& config) const {
     // Convert JSON to Config struct
     // For now, just set basic defaults - this would be expanded as needed
+    if (config_data_.is_object()) {
+        config.hot_reload_interval_ms = config_data_.value("hot_reload_interval_ms", 0);
+    }
+
     if (config_data_.contains("debug_config")) {
         auto& debug = config_data_["debug_config"];
-        config_obj_.debug_config.x64dbg_path = debug.value("x64dbg_path", "C:\\x64dbg\\x64dbg.exe");
-        config_obj_.debug_config.connection_timeout_ms = debug.value("connection_timeout_ms", 5000);
+        config.debug_config.x64dbg_path = debug.value("x64dbg_path", "C:\\x64dbg\\x64dbg.exe");
+        config.debug_config.connection_timeout_ms = debug.value("connection_timeout_ms", 5000);
+        config.debug_config.tcp_host = debug.value("tcp_host", "127.0.0.1");
+        config.debug_config.tcp_port = debug.value("tcp_port", 27042);
+        config.debug_config.memory_cache_pages = debug.value("memory_cache_pages", static_cast<size_t>(256));
+        config.debug_config.event_queue_capacity = debug.value("event_queue_capacity", static_cast<size_t>(4096));
+        config.debug_config.event_overflow_policy = debug.value("event_overflow_policy", "block");
+        config.debug_config.stats_export_interval_ms = debug.value("stats_export_interval_ms", 0);
+        config.debug_config.stats_export_path = debug.value("stats_export_path", "");
     }
     
+    if (config_data_.contains("api_configs") && config_data_["api_configs"].is_object()) {
+        config.api_configs.clear();
+        for (const auto& [name, provider] : config_data_["api_configs"].items()) {
+            APIConfig api;
+            api.provider = name;
+            api.model = provider.value("model", "");
+            api.endpoint = provider.value("endpoint", "");
+            api.timeout_ms = provider.value("timeout_ms", 30000);
+            api.max_retries = provider.value("max_retries", 3);
+            api.validate_ssl = provider.value("validate_ssl", true);
+            api.pool_size = provider.value("pool_size", static_cast<size_t>(4));
+            api.keep_alive_ms = provider.value("keep_alive_ms", 60000);
+            api.requests_per_minute = provider.value("requests_per_minute", 0);
+            api.tokens_per_minute = provider.value("tokens_per_minute", 0);
+            config.api_configs[name] = api;
+        }
+    }
+
+    if (config_data_.contains("llm_config")) {
+        auto& llm = config_data_["llm_config"];
+        config.llm_config.response_cache = llm.value("response_cache", true);
+        config.llm_config.cache_entries = llm.value("cache_entries", static_cast<size_t>(512));
+        config.llm_config.cache_ttl_seconds = llm.value("cache_ttl_seconds", 86400);
+        config.llm_config.cache_directory = llm.value("cache_directory", "");
+        config.llm_config.cache_disk_mb = llm.value("cache_disk_mb", static_cast<size_t>(256));
+        config.llm_config.failover = llm.value("failover", false);
+        config.llm_config.context_tokens = llm.value("context_tokens", static_cast<size_t>(6000));
+        config.llm_config.response_tokens = llm.value("response_tokens", 1024);
+    }
+
     if (config_data_.contains("log_config")) {
         auto& log = config_data_["log_config"];
         std::string level_str = log.value("level", "INFO");
-        config_obj_.log_config.output_path = log.value("file_path", "mcp_debugger.log");
+        config.log_config.output_path = log.value("file_path", "mcp_debugger.log");
+        config.log_config.overflow_policy = log.value("overflow_policy", "drop_newest");
+        config.log_config.trace_path = log.value("trace_path", "");
         // Convert level string to enum if needed
-        if (level_str == "DEBUG") config_obj_.log_config.level = LogConfig::Level::DEBUG;
-        else if (level_str == "INFO") config_obj_.log_config.level = LogConfig::Level::INFO;
-        else if (level_str == "WARN") config_obj_.log_config.level = LogConfig::Level::WARN;
-        else if (level_str == "ERROR") config_obj_.log_config.level = LogConfig::Level::ERROR;
-        else if (level_str == "FATAL") config_obj_.log_config.level = LogConfig::Level::FATAL;
+        if (level_str == "DEBUG") config.log_config.level = LogConfig::Level::DEBUG;
+        else if (level_str == "INFO") config.log_config.level = LogConfig::Level::INFO;
+        else if (level_str == "WARN") config.log_config.level = LogConfig::Level::WARN;
+        else if (level_str == "ERROR") config.log_config.level = LogConfig::Level::ERROR;
+        else if (level_str == "FATAL") config.log_config.level = LogConfig::Level::FATAL;
+    }
+
+    if (config_data_.contains("security_config")) {
+        auto& security = config_data_["security_config"];
+        config.security_config.encryption_key_path = security.value("encryption_key_path", "");
+        config.security_config.credential_store_path = security.value("credential_store_path", "");
+        config.security_config.require_api_key_validation = security.value("require_api_key_validation", true);
+        config.security_config.encrypt_credentials = security.value("encrypt_credentials", true);
+        config.security_config.key_rotation_days = security.value("key_rotation_days", 90);
+        config.security_config.credential_cache_seconds = security.value("credential_cache_seconds", 60);
+    }
+
+    if (config_data_.contains("analysis_config")) {
+        auto& analysis = config_data_["analysis_config"];
+        config.analysis_config.worker_threads = analysis.value("worker_threads", 0);
+        config.analysis_config.chunk_size_kb = analysis.value("chunk_size_kb", static_cast<size_t>(4096));
+        config.analysis_config.entropy_window = analysis.value("entropy_window", static_cast<size_t>(4096));
+        config.analysis_config.entropy_step = analysis.value("entropy_step", static_cast<size_t>(1024));
+        config.analysis_config.high_entropy_threshold = analysis.value("high_entropy_threshold", 7.2);
+        config.analysis_config.pattern_database = analysis.value("pattern_database", "");
+        config.analysis_config.compiled_pattern_database = analysis.value("compiled_pattern_database", "");
     }
 }
 
@@ -3,18 +3,50 @@
 #include "mcp/interfaces.hpp"
 #include "mcp/types.hpp"
 #include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
 #include <mutex>
 #include <string>
 #include <memory>
+#include <thread>
+#include <vector>
 
 namespace mcp {
 
 using json = nlohmann::json;
 
+/**
+ * @brief JSON configuration published as immutable Config snapshots
+ *
+ * Every change (load, SetValue, defaults, a reload of the watched file)
+ * builds a new Config and swaps it in atomically, so GetSnapshot() never
+ * blocks. Subscribers then hear which sections differ from the previous
+ * snapshot, one publication at a time.
+ */
 class ConfigManager : public IConfigManager {
 public:
+    // Bits of the changed-sections mask passed to listeners
+    enum Section : uint32_t {
+        SECTION_API = 1u << 0,        // api_configs, llm_providers, default_provider
+        SECTION_LLM = 1u << 1,
+        SECTION_DEBUG = 1u << 2,
+        SECTION_LOG = 1u << 3,
+        SECTION_SECURITY = 1u << 4,
+        SECTION_ANALYSIS = 1u << 5,
+        SECTION_OTHER = 1u << 6,      // Any other top-level key
+        SECTION_ALL = (1u << 7) - 1
+    };
+
+    // Runs on the publishing thread; may read the config but must not change it
+    using Listener = std::function<void(const std::shared_ptr<const Config>& config, uint32_t changed_sections)>;
+
     ConfigManager();
-    ~ConfigManager() = default;
+    ~ConfigManager() override;
 
     // IConfigManager implementation
     Result<void> LoadConfig(const std::string& path) override;
@@ -22,21 +54,60 @@ public:
     Result<void> SetDefaults() override;
     Result<std::string> GetValue(const std::string& key) override;
     Result<void> SetValue(const std::string& key, const std::string& value) override;
+    // Deprecated, use GetSnapshot(). The reference is not updated and stays valid only
+    // until kRetainedSnapshots further publications; copy anything kept longer
     const Config& GetConfig() const override;
-    
+    std::shared_ptr<const Config> GetSnapshot() const override;
+
     // Additional methods
     const json& GetConfigJson() const;
     
     template<typename T>
     Result<T> GetValue(const std::string& key) const;
 
+    // Returns an id for Unsubscribe()
+    size_t Subscribe(Listener listener);
+    // Waits for a notification in progress, so not to be called from a listener
+    void Unsubscribe(size_t id);
+
+    // Re-reads the last loaded file whenever it changes on disk; zero stops watching
+    Result<void> WatchFile(std::chrono::milliseconds interval);
+    void StopWatching();
+    // Empty after a successful reload; a failed one keeps the previous snapshot
+    std::string GetLastReloadError() const;
+    uint64_t GetGeneration() const { return generation_.load(std::memory_order_acquire); }
+
 private:
     mutable std::mutex config_mutex_;
     json config_data_;
     std::string config_path_;
-    Config config_obj_;  // For interface compatibility
-    
-    void UpdateConfigFromJson();
+
+    std::shared_ptr<const Config> snapshot_;                 // Accessed with atomic_load/atomic_store
+    // The latest publications, so recent GetConfig() references stay alive without keeping every reload
+    static constexpr size_t kRetainedSnapshots = 8;
+    std::deque<std::shared_ptr<const Config>> published_;
+    std::atomic<uint64_t> generation_{0};
+
+    // Serializes publications so listeners see them in order
+    std::mutex publish_mutex_;
+    std::mutex listeners_mutex_;
+    std::vector<std::pair<size_t, std::shared_ptr<Listener>>> listeners_;
+    size_t next_listener_id_ = 1;
+
+    std::thread watch_thread_;
+    mutable std::mutex watch_mutex_;
+    std::condition_variable watch_condition_;
+    bool watch_stop_ = false;
+    std::string last_reload_error_;
+
+    // Caller holds config_mutex_
+    std::shared_ptr<const Config> BuildSnapshot() const;
+    void UpdateConfigFromJson(Config& config) const;
+    // Caller holds config_mutex_; returns the snapshot to announce
+    std::shared_ptr<const Config> Publish();
+    void Notify(const std::shared_ptr<const Config>& config, uint32_t changed_sections);
+
+    static uint32_t ChangedSections(const json& before, const json& after);
 };
 
-} // namespace mcp
\ No newline at end of file
+} // namespace mcp
@@ -1,11 +1,16 @@
 #include "core_engine.hpp"
+#include "task_executor.hpp"
 #include "../logger/logger.hpp"
 #include "../llm/llm_engine.hpp"
+#include "../llm/prompt_builder.hpp"
+#include "../llm/response_cache.hpp"
 #include "../x64dbg/x64dbg_bridge.hpp"
 #include "../config/config_manager.hpp"
 #include "../parser/sexpr_parser.hpp"
 #include "../analyzer/dump_analyzer.hpp"
+#include "../analyzer/binary_view.hpp"
 #include "../security/security_manager.hpp"
+#include "mcp/executor.hpp"
 
 #include <memory>
 #include <mutex>
@@ -13,11 +18,74 @@
 #include <future>
 #include <string>
 #include <exception>
+#include <algorithm>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <iomanip>
+#include <sstream>
 
 namespace mcp {
 
+namespace {
+
+// Images larger than this are indexed by extent only
+constexpr size_t kMaxSymbolImageSize = 64 * 1024 * 1024;
+
+// Export table of a module mapped in the debuggee, read through the bridge
+Result<ModuleSymbols> LoadModuleSymbols(X64DbgBridge& bridge, uintptr_t base) {
+    auto header = bridge.ReadMemoryRaw(base, PageCache::kPageSize);
+    if (!header.IsSuccess()) {
+        return Result<ModuleSymbols>::Error(header.Error());
+    }
+    MemoryView header_view{header.Value().data(), header.Value().size(), base};
+    auto pe = PeView::Parse(header_view);
+    if (!pe.IsSuccess()) {
+        return Result<ModuleSymbols>::Error(pe.Error());
+    }
+
+    ModuleSymbols symbols;
+    symbols.size = pe.Value().GetSizeOfImage();
+    if (symbols.size == 0 || symbols.size > kMaxSymbolImageSize) {
+        return Result<ModuleSymbols>::Success(std::move(symbols));
+    }
+
+    auto image = bridge.ReadMemoryRaw(base, symbols.size);
+    if (!image.IsSuccess()) {
+        return Result<ModuleSymbols>::Success(std::move(symbols));
+    }
+    auto info = BinaryModuleInfo::Build(MemoryView{image.Value().data(), image.Value().size(), base});
+    if (info.IsSuccess()) {
+        for (const BinarySymbol& export_entry : info.Value().exports) {
+            if (!export_entry.name.empty()) {
+                symbols.symbols.push_back({base + static_cast<uintptr_t>(export_entry.address), 0, export_entry.name});
+            }
+        }
+    }
+    return Result<ModuleSymbols>::Success(std::move(symbols));
+}
+
+std::string HexAddress(uintptr_t address) {
+    char text[2 + 16 + 1];
+    std::snprintf(text, sizeof(text), "0x%llx", static_cast<unsigned long long>(address));
+    return text;
+}
+
+// The LLM engine's packing budget; the default one for an injected engine
+PromptBudget PromptBudgetOf(const std::shared_ptr<ILLMEngine>& llm_engine) {
+    if (auto llm_impl = std::dynamic_pointer_cast<LLMEngine>(llm_engine)) {
+        return llm_impl->GetPromptBudget();
+    }
+    return PromptBudget();
+}
+
+} // anonymous namespace
+
 // Default constructor
-CoreEngine::CoreEngine() = default;
+CoreEngine::CoreEngine()
+    : executor_(std::make_shared<TaskExecutor>()) {
+}
 
 // Constructor for dependency injection
 CoreEngine::CoreEngine(std::shared_ptr<ILogger> logger,
@@ -25,7 +93,8 @@ CoreEngine::CoreEngine(std::shared_ptr<ILogger> logger,
                        std::shared_ptr<IX64DbgBridge> x64dbg_bridge)
     : logger_(std::move(logger)),
       llm_engine_(std::move(llm_engine)),
-      x64dbg_bridge_(std::move(x64dbg_bridge)) {
+      x64dbg_bridge_(std::move(x64dbg_bridge)),
+      executor_(std::make_shared<TaskExecutor>()) {
     if (logger_) {
         logger_->Log(ILogger::LOG_INFO, "CoreEngine created with injected dependencies.");
     }
@@ -44,51 +113,71 @@ Result<void> CoreEngine::Initialize() {
         return Result<void>::Success();
     }
     
+    const auto started = std::chrono::steady_clock::now();
+    {
+        const std::lock_guard<std::mutex> report_lock(startup_mutex_);
+        startup_report_ = StartupReport();
+    }
+    
     // Initialize in dependency order
     auto logger_result = InitializeLogger();
     if (!logger_result.IsSuccess()) {
         return logger_result;
     }
+    RecordStartupPhase("logger", started, StartupPhase::Kind::SERIAL);
     
     if (logger_) {
         logger_->Log(ILogger::LOG_INFO, "CoreEngine initializing...");
     }
     
-    auto security_result = InitializeSecurityManager();
-    if (!security_result.IsSuccess()) {
-        return security_result;
+    if (!executor_->IsRunning()) {
+        std::atomic_store(&executor_, std::make_shared<TaskExecutor>());
     }
     
+    // Key generation does not depend on the config or the parser, so it overlaps them
+    auto security_future = Submit(*executor_, [this]() {
+        const auto security_started = std::chrono::steady_clock::now();
+        auto result = InitializeSecurityManager();
+        RecordStartupPhase("security_manager", security_started, StartupPhase::Kind::PARALLEL);
+        return result;
+    });
+    
+    auto phase_started = std::chrono::steady_clock::now();
     auto config_result = InitializeConfigManager();
+    RecordStartupPhase("config_manager", phase_started, StartupPhase::Kind::SERIAL);
+    
+    phase_started = std::chrono::steady_clock::now();
+    auto parser_result = config_result.IsSuccess() ? InitializeExprParser() : Result<void>::Success();
+    RecordStartupPhase("expr_parser", phase_started, StartupPhase::Kind::SERIAL);
+    
+    // Joined before any early return, since the task writes security_manager_
+    auto security_result = security_future.get();
+    if (!security_result.IsSuccess()) {
+        return security_result;
+    }
     if (!config_result.IsSuccess()) {
         return config_result;
     }
-    
-    auto parser_result = InitializeExprParser();
     if (!parser_result.IsSuccess()) {
         return parser_result;
     }
     
-    auto analyzer_result = InitializeDumpAnalyzer();
-    if (!analyzer_result.IsSuccess()) {
-        return analyzer_result;
-    }
-    
-    auto bridge_result = InitializeDebugBridge();
-    if (!bridge_result.IsSuccess()) {
-        return bridge_result;
-    }
-    
-    // Initialize LLM engine if not injected
-    if (!llm_engine_) {
-        llm_engine_ = std::make_shared<LLMEngine>(logger_);
-    }
+    // The dump analyzer, debug bridge and LLM engine (unless injected) are built on first use
+    alive_token_ = std::make_shared<int>(0);
+    ConnectParserMemory();
+    AttachExecutor();
     
     initialized_ = true;
-    modules_immutable_.store(true, std::memory_order_release); // Modules are now immutable
+    modules_immutable_.store(true, std::memory_order_release); // Lazy modules may be built from now on
     
+    const auto total = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+    {
+        const std::lock_guard<std::mutex> report_lock(startup_mutex_);
+        startup_report_.total = total;
+    }
     if (logger_) {
-        logger_->Log(ILogger::LOG_INFO, "CoreEngine initialized successfully.");
+        logger_->LogFormatted(ILogger::LOG_INFO, "CoreEngine initialized successfully in %.2f ms.",
+                              total.count() / 1000.0);
     }
     
     return Result<void>::Success();
@@ -111,21 +200,36 @@ Result<void> CoreEngine::Shutdown() {
     return Result<void>::Success();
 }
 
-std::shared_ptr<ILLMEngine> CoreEngine::GetLLMEngine() {
-    // Fast path: no locking after initialization is complete
-    if (modules_immutable_.load(std::memory_order_acquire)) {
-        return llm_engine_;
+template<typename T, typename Factory>
+std::shared_ptr<T> CoreEngine::EnsureModule(std::shared_ptr<T>& slot, std::mutex& build_mutex, const char* name,
+                                            Factory create) {
+    // Fast path: no locking once the module exists
+    if (auto module = std::atomic_load(&slot)) {
+        return module;
     }
-    const std::lock_guard<std::mutex> lock(engine_mutex_);
-    return llm_engine_;
+    const std::lock_guard<std::mutex> lock(build_mutex);
+    if (auto module = std::atomic_load(&slot)) {
+        return module;
+    }
+    // Nothing is built before Initialize() or once shutdown has begun
+    if (!modules_immutable_.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    const auto started = std::chrono::steady_clock::now();
+    std::shared_ptr<T> module = create();
+    if (module) {
+        std::atomic_store(&slot, module);
+        RecordStartupPhase(name, started, StartupPhase::Kind::LAZY);
+    }
+    return module;
+}
+
+std::shared_ptr<ILLMEngine> CoreEngine::GetLLMEngine() {
+    return EnsureModule(llm_engine_, llm_build_mutex_, "llm_engine", [this]() { return CreateLLMEngine(); });
 }
 
 std::shared_ptr<IX64DbgBridge> CoreEngine::GetDebugBridge() {
-    if (modules_immutable_.load(std::memory_order_acquire)) {
-        return x64dbg_bridge_;
-    }
-    const std::lock_guard<std::mutex> lock(engine_mutex_);
-    return x64dbg_bridge_;
+    return EnsureModule(x64dbg_bridge_, bridge_build_mutex_, "debug_bridge", [this]() { return CreateDebugBridge(); });
 }
 
 std::shared_ptr<IExprParser> CoreEngine::GetExprParser() {
@@ -153,11 +257,8 @@ std::shared_ptr<ILogger> CoreEngine::GetLogger() {
 }
 
 std::shared_ptr<IDumpAnalyzer> CoreEngine::GetDumpAnalyzer() {
-    if (modules_immutable_.load(std::memory_order_acquire)) {
-        return dump_analyzer_;
-    }
-    const std::lock_guard<std::mutex> lock(engine_mutex_);
-    return dump_analyzer_;
+    return EnsureModule(dump_analyzer_, analyzer_build_mutex_, "dump_analyzer",
+                        [this]() { return CreateDumpAnalyzer(); });
 }
 
 std::shared_ptr<ISecurityManager> CoreEngine::GetSecurityManager() {
@@ -168,21 +269,102 @@ std::shared_ptr<ISecurityManager> CoreEngine::GetSecurityManager() {
     return security_manager_;
 }
 
+std::shared_ptr<ITaskExecutor> CoreEngine::GetTaskExecutor() const {
+    return std::atomic_load(&executor_);
+}
+
 bool CoreEngine::IsInitialized() const {
     return initialized_.load();
 }
 
+void CoreEngine::PreloadModules(bool wait) {
+    if (!modules_immutable_.load(std::memory_order_acquire)) {
+        return;
+    }
+    // Independent modules, each behind its own build lock
+    const auto executor = std::atomic_load(&executor_);
+    std::vector<std::future<void>> builds;
+    builds.push_back(Submit(*executor, [this]() { GetDumpAnalyzer(); }));
+    builds.push_back(Submit(*executor, [this]() { GetDebugBridge(); }));
+    builds.push_back(Submit(*executor, [this]() { GetLLMEngine(); }));
+    if (wait) {
+        for (auto& build : builds) {
+            build.wait();
+        }
+    }
+}
+
+StartupReport CoreEngine::GetStartupReport() const {
+    const std::lock_guard<std::mutex> lock(startup_mutex_);
+    return startup_report_;
+}
+
+void CoreEngine::RecordStartupPhase(const char* name, std::chrono::steady_clock::time_point started,
+                                    StartupPhase::Kind kind) {
+    StartupPhase phase;
+    phase.name = name;
+    phase.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+    phase.kind = kind;
+    if (logger_ && kind == StartupPhase::Kind::LAZY) {
+        logger_->LogFormatted(ILogger::LOG_DEBUG, "Built %s on first use in %.2f ms", name,
+                              phase.elapsed.count() / 1000.0);
+    }
+    const std::lock_guard<std::mutex> lock(startup_mutex_);
+    startup_report_.phases.push_back(std::move(phase));
+}
+
+std::string StartupReport::ToString() const {
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(2);
+    report << "Startup: " << total.count() / 1000.0 << " ms\n";
+    for (const StartupPhase& phase : phases) {
+        report << "  " << std::left << std::setw(18) << phase.name << std::right << std::setw(8)
+               << phase.elapsed.count() / 1000.0 << " ms";
+        if (phase.kind == StartupPhase::Kind::PARALLEL) {
+            report << "  (parallel)";
+        } else if (phase.kind == StartupPhase::Kind::LAZY) {
+            report << "  (on first use)";
+        }
+        report << "\n";
+    }
+    return report.str();
+}
+
 Result<void> CoreEngine::LoadConfiguration(const std::string& config_file) {
     if (!config_manager_) {
         return Result<void>::Error("Config manager not initialized");
     }
     
+    // Once subscribed, every published snapshot is applied by the listener
+    auto manager = std::dynamic_pointer_cast<ConfigManager>(config_manager_);
+    const bool subscribed = config_subscription_ != 0;
+    
     auto load_result = config_manager_->LoadConfig(config_file);
     if (!load_result.IsSuccess()) {
         return load_result;
     }
     
-    return InitializeFromConfig();
+    auto apply_result = subscribed ? Result<void>::Success() : InitializeFromConfig();
+    if (!apply_result.IsSuccess() || !manager) {
+        return apply_result;
+    }
+    if (!subscribed) {
+        config_subscription_ = manager->Subscribe(
+            [this](const std::shared_ptr<const Config>& config, uint32_t changed_sections) {
+                ApplyConfig(*config, changed_sections);
+                if (logger_) {
+                    logger_->LogFormatted(ILogger::LOG_INFO, "Applied configuration changes (sections 0x%02X)",
+                                          changed_sections);
+                }
+            });
+    }
+    
+    const int interval = manager->GetSnapshot()->hot_reload_interval_ms;
+    auto watch_result = manager->WatchFile(std::chrono::milliseconds(std::max(interval, 0)));
+    if (!watch_result.IsSuccess() && logger_) {
+        logger_->Log(ILogger::LOG_WARN, watch_result.Error());
+    }
+    return Result<void>::Success();
 }
 
 Result<void> CoreEngine::InitializeFromConfig() {
@@ -190,34 +372,114 @@ Result<void> CoreEngine::InitializeFromConfig() {
         return Result<void>::Error("Config manager not available");
     }
     
-    const Config& config = config_manager_->GetConfig();
-    
+    config_applied_.store(true, std::memory_order_release);
+    ApplyConfig(*config_manager_->GetSnapshot(), ConfigManager::SECTION_ALL);
+    return Result<void>::Success();
+}
+
+void CoreEngine::ApplyConfig(const Config& config, uint32_t sections) {
     // Update logger configuration
-    if (logger_) {
+    if (logger_ && (sections & ConfigManager::SECTION_LOG)) {
         auto logger_impl = std::dynamic_pointer_cast<Logger>(logger_);
         if (logger_impl) {
             logger_impl->UpdateConfig(config.log_config);
         }
     }
     
-    // Configure LLM engine with API configs - simplified for now
-    if (llm_engine_) {
-        auto llm_impl = std::dynamic_pointer_cast<LLMEngine>(llm_engine_);
-        if (llm_impl && logger_) {
-            logger_->Log(ILogger::LOG_INFO, "LLM engine configuration loaded");
+    auto security_impl = std::dynamic_pointer_cast<SecurityManager>(security_manager_);
+    if (security_impl && (sections & ConfigManager::SECTION_SECURITY)) {
+        security_impl->SetCredentialCacheTTL(
+            std::chrono::seconds(std::max(config.security_config.credential_cache_seconds, 0)));
+        if (!config.security_config.encryption_key_path.empty()) {
+            auto key_result = security_impl->LoadEncryptionKey(config.security_config.encryption_key_path);
+            if (!key_result.IsSuccess() && logger_) {
+                logger_->LogFormatted(ILogger::LOG_WARN, "Encryption key not loaded: %s",
+                                      key_result.Error().c_str());
+            }
         }
     }
     
-    // Configure debug bridge
-    if (x64dbg_bridge_) {
-        auto bridge_impl = std::dynamic_pointer_cast<X64DbgBridge>(x64dbg_bridge_);
-        if (bridge_impl) {
-            bridge_impl->SetDebuggerPath(config.debug_config.x64dbg_path);
-            bridge_impl->SetConnectionTimeout(config.debug_config.connection_timeout_ms);
+    // Lazy modules are configured under their build lock: one built meanwhile reads this snapshot itself
+    if (sections & (ConfigManager::SECTION_API | ConfigManager::SECTION_LLM)) {
+        const std::lock_guard<std::mutex> lock(llm_build_mutex_);
+        if (auto llm_impl = std::dynamic_pointer_cast<LLMEngine>(std::atomic_load(&llm_engine_))) {
+            ConfigureLLMEngine(*llm_impl, config);
         }
     }
     
-    return Result<void>::Success();
+    // Configure dump analyzer
+    if (sections & ConfigManager::SECTION_ANALYSIS) {
+        const std::lock_guard<std::mutex> lock(analyzer_build_mutex_);
+        if (auto analyzer_impl = std::dynamic_pointer_cast<DumpAnalyzer>(std::atomic_load(&dump_analyzer_))) {
+            analyzer_impl->SetAnalysisConfig(config.analysis_config);
+        }
+    }
+    
+    // Configure debug bridge
+    if (sections & ConfigManager::SECTION_DEBUG) {
+        const std::lock_guard<std::mutex> lock(bridge_build_mutex_);
+        if (auto bridge_impl = std::dynamic_pointer_cast<X64DbgBridge>(std::atomic_load(&x64dbg_bridge_))) {
+            ConfigureDebugBridge(*bridge_impl, config);
+        }
+    }
+}
+
+void CoreEngine::ConfigureLLMEngine(LLMEngine& llm, const Config& config) {
+    // Configure LLM engine with API configs - simplified for now
+    llm.ConfigureProviders(config.api_configs);
+    llm.SetFailover(config.llm_config.failover);
+    PromptBudget budget;
+    budget.context_tokens = config.llm_config.context_tokens;
+    budget.response_tokens = config.llm_config.response_tokens;
+    llm.SetPromptBudget(budget);
+    if (config.llm_config.response_cache) {
+        ResponseCacheOptions cache_options;
+        cache_options.memory_entries = config.llm_config.cache_entries;
+        cache_options.ttl = std::chrono::seconds(std::max(config.llm_config.cache_ttl_seconds, 0));
+        cache_options.disk_directory = config.llm_config.cache_directory;
+        cache_options.disk_max_bytes = static_cast<uint64_t>(config.llm_config.cache_disk_mb) << 20;
+        if (!cache_options.disk_directory.empty() && config.security_config.encryption_key_path.empty() &&
+            logger_) {
+            logger_->Log(ILogger::LOG_WARN,
+                         "LLM cache_directory set without security_config.encryption_key_path: "
+                         "disk entries will not be readable by later sessions");
+        }
+        llm.SetResponseCache(std::make_shared<LLMResponseCache>(cache_options, security_manager_, logger_));
+    } else {
+        llm.SetResponseCache(nullptr);
+    }
+    if (logger_) {
+        logger_->Log(ILogger::LOG_INFO, "LLM engine configuration loaded");
+    }
+}
+
+void CoreEngine::ConfigureDebugBridge(X64DbgBridge& bridge, const Config& config) {
+    bridge.SetDebuggerPath(config.debug_config.x64dbg_path);
+    bridge.SetConnectionTimeout(config.debug_config.connection_timeout_ms);
+    auto endpoint_result = bridge.SetTcpEndpoint(config.debug_config.tcp_host, config.debug_config.tcp_port);
+    if (!endpoint_result.IsSuccess() && logger_) {
+        logger_->Log(ILogger::LOG_WARN, endpoint_result.Error());
+    }
+    bridge.SetMemoryCacheSize(config.debug_config.memory_cache_pages);
+    auto policy = X64DbgBridge::ParseEventOverflowPolicy(config.debug_config.event_overflow_policy);
+    auto queue_result = policy.IsSuccess()
+        ? bridge.SetEventQueueOptions(config.debug_config.event_queue_capacity, policy.Value())
+        : Result<void>::Error(policy.Error());
+    if (!queue_result.IsSuccess() && logger_) {
+        logger_->Log(ILogger::LOG_WARN, queue_result.Error());
+    }
+
+    const auto& debug_config = config.debug_config;
+    if (debug_config.stats_export_interval_ms > 0 && !debug_config.stats_export_path.empty()) {
+        const std::string path = debug_config.stats_export_path;
+        bridge.SetStatsExport(std::chrono::milliseconds(debug_config.stats_export_interval_ms),
+                              [path](const std::string& json) {
+            std::ofstream out(path, std::ios::app);
+            out << json << '\n';
+        });
+    } else {
+        bridge.SetStatsExport(std::chrono::milliseconds(0), nullptr);
+    }
 }
 
 Result<void> CoreEngine::InitializeLogger() {
@@ -264,29 +526,158 @@ Result<void> CoreEngine::InitializeExprParser() {
     }
 }
 
-Result<void> CoreEngine::InitializeDumpAnalyzer() {
+std::shared_ptr<IDumpAnalyzer> CoreEngine::CreateDumpAnalyzer() {
     try {
-        dump_analyzer_ = std::make_shared<DumpAnalyzer>(logger_);
-        return Result<void>::Success();
+        auto analyzer = std::make_shared<DumpAnalyzer>(logger_);
+        if (config_manager_) {
+            const auto snapshot = config_manager_->GetSnapshot();
+            const AnalysisConfig& config = snapshot->analysis_config;
+            analyzer->SetAnalysisConfig(config);
+            if (!config.pattern_database.empty()) {
+                if (config.compiled_pattern_database.empty()) {
+                    analyzer->LoadPatternDatabase(config.pattern_database);
+                } else {
+                    analyzer->LoadPatternDatabase(config.pattern_database, config.compiled_pattern_database);
+                }
+            }
+        }
+        analyzer->SetTaskExecutor(std::atomic_load(&executor_));
+        return analyzer;
+    } catch (const std::exception& ex) {
+        if (logger_) {
+            logger_->Log(ILogger::LOG_ERROR, "Failed to initialize dump analyzer: " + std::string(ex.what()));
+        }
+        return nullptr;
+    }
+}
+
+std::shared_ptr<IX64DbgBridge> CoreEngine::CreateDebugBridge() {
+    try {
+        auto bridge_impl = std::make_shared<X64DbgBridge>(logger_);
+
+        // Loaded modules are indexed from their export tables for symbol lookups
+        std::weak_ptr<X64DbgBridge> weak_impl = bridge_impl;
+        bridge_impl->SetSymbolSource([weak_impl](const std::string&, uintptr_t base) -> Result<ModuleSymbols> {
+            auto bridge = weak_impl.lock();
+            if (!bridge) {
+                return Result<ModuleSymbols>::Error("Debug bridge not available");
+            }
+            return LoadModuleSymbols(*bridge, base);
+        });
+        if (config_applied_.load(std::memory_order_acquire) && config_manager_) {
+            ConfigureDebugBridge(*bridge_impl, *config_manager_->GetSnapshot());
+        }
+        bridge_impl->SetTaskExecutor(std::atomic_load(&executor_));
+        return bridge_impl;
     } catch (const std::exception& ex) {
-        return Result<void>::Error("Failed to initialize dump analyzer: " + std::string(ex.what()));
+        if (logger_) {
+            logger_->Log(ILogger::LOG_ERROR, "Failed to initialize debug bridge: " + std::string(ex.what()));
+        }
+        return nullptr;
     }
 }
 
-Result<void> CoreEngine::InitializeDebugBridge() {
+std::shared_ptr<ILLMEngine> CoreEngine::CreateLLMEngine() {
     try {
-        x64dbg_bridge_ = std::make_shared<X64DbgBridge>(logger_);
-        return Result<void>::Success();
+        auto llm = std::make_shared<LLMEngine>(logger_);
+        if (config_applied_.load(std::memory_order_acquire) && config_manager_) {
+            ConfigureLLMEngine(*llm, *config_manager_->GetSnapshot());
+        }
+        llm->SetTaskExecutor(std::atomic_load(&executor_));
+        return llm;
     } catch (const std::exception& ex) {
-        return Result<void>::Error("Failed to initialize debug bridge: " + std::string(ex.what()));
+        if (logger_) {
+            logger_->Log(ILogger::LOG_ERROR, "Failed to initialize LLM engine: " + std::string(ex.what()));
+        }
+        return nullptr;
+    }
+}
+
+void CoreEngine::ConnectParserMemory() {
+    // Parser memory builtins read through the bridge; the dump buffer is
+    // moved into shared ownership instead of being copied
+    auto parser_impl = std::dynamic_pointer_cast<SExprParser>(expr_parser_);
+    if (!parser_impl) {
+        return;
+    }
+    std::weak_ptr<void> alive = alive_token_;
+    auto bridge_of = [this, alive]() -> std::shared_ptr<IX64DbgBridge> {
+        return alive.lock() ? GetDebugBridge() : nullptr;
+    };
+    parser_impl->SetMemoryReader([bridge_of](uintptr_t address, size_t size) -> Result<MemoryView> {
+        auto bridge = bridge_of();
+        if (!bridge) {
+            return Result<MemoryView>::Error("Debug bridge not available");
+        }
+        auto dump_result = bridge->ReadMemory(address, size);
+        if (!dump_result.IsSuccess()) {
+            return Result<MemoryView>::Error(dump_result.Error());
+        }
+        return Result<MemoryView>::Success(
+            MemoryView::Share(std::make_shared<const MemoryDump>(dump_result.TakeValue())));
+    });
+    parser_impl->SetMemoryBatchReader([bridge_of](const std::vector<MemoryRange>& ranges)
+                                          -> Result<std::vector<MemoryView>> {
+        auto bridge = bridge_of();
+        if (!bridge) {
+            return Result<std::vector<MemoryView>>::Error("Debug bridge not available");
+        }
+        return bridge->ReadMemoryBatch(ranges);
+    });
+}
+
+void CoreEngine::AttachExecutor() {
+    // Modules built on first use attach themselves; these are the injected or eager ones
+    if (auto analyzer = std::dynamic_pointer_cast<DumpAnalyzer>(std::atomic_load(&dump_analyzer_))) {
+        analyzer->SetTaskExecutor(executor_);
+    }
+    if (auto bridge = std::dynamic_pointer_cast<X64DbgBridge>(std::atomic_load(&x64dbg_bridge_))) {
+        bridge->SetTaskExecutor(executor_);
+    }
+    if (auto llm = std::dynamic_pointer_cast<LLMEngine>(std::atomic_load(&llm_engine_))) {
+        llm->SetTaskExecutor(executor_);
+    }
+    if (auto security = std::dynamic_pointer_cast<SecurityManager>(security_manager_)) {
+        security->SetTaskExecutor(executor_);
+    }
+    if (logger_) {
+        logger_->LogFormatted(ILogger::LOG_DEBUG, "Task executor running %zu workers", executor_->GetWorkerCount());
     }
 }
 
 void CoreEngine::ShutdownModules() {
+    // No module is built from here on, and none is half built
+    modules_immutable_.store(false, std::memory_order_release);
+    {
+        const std::scoped_lock builds(llm_build_mutex_, bridge_build_mutex_, analyzer_build_mutex_);
+    }
+    alive_token_.reset();
+    config_applied_.store(false, std::memory_order_release);
+    
+    // No reload may reach the modules once they start going away
+    if (auto manager = std::dynamic_pointer_cast<ConfigManager>(config_manager_)) {
+        manager->StopWatching();
+        if (config_subscription_ != 0) {
+            manager->Unsubscribe(config_subscription_);
+            config_subscription_ = 0;
+        }
+    }
+    // Continuations read the modules, so none may still run while they go.
+    // Cancelled requests finish at once and their continuations still run.
+    if (auto llm = std::dynamic_pointer_cast<LLMEngine>(std::atomic_load(&llm_engine_))) {
+        llm->CancelAllRequests();
+    }
+    executor_->Shutdown();
+    const auto executor_stats = executor_->GetStats();
+    if (logger_ && executor_stats.dropped > 0) {
+        logger_->LogFormatted(ILogger::LOG_WARN, "Dropped %llu pending continuations at shutdown",
+                              static_cast<unsigned long long>(executor_stats.dropped));
+    }
+
     // Shutdown in reverse dependency order
-    x64dbg_bridge_.reset();
-    llm_engine_.reset();
-    dump_analyzer_.reset();
+    std::atomic_store(&x64dbg_bridge_, std::shared_ptr<IX64DbgBridge>());
+    std::atomic_store(&llm_engine_, std::shared_ptr<ILLMEngine>());
+    std::atomic_store(&dump_analyzer_, std::shared_ptr<IDumpAnalyzer>());
     expr_parser_.reset();
     config_manager_.reset();
     security_manager_.reset();
@@ -299,7 +690,9 @@ void CoreEngine::ShutdownModules() {
 }
 
 void CoreEngine::AnalyzeCurrentContext() {
-    if (!x64dbg_bridge_ || !llm_engine_) {
+    const auto x64dbg_bridge = GetDebugBridge();
+    const auto llm_engine = GetLLMEngine();
+    if (!x64dbg_bridge || !llm_engine) {
         if (logger_) {
             logger_->Log(ILogger::LOG_ERROR, "CoreEngine is not initialized correctly.");
         }
@@ -311,7 +704,7 @@ void CoreEngine::AnalyzeCurrentContext() {
     }
 
     uintptr_t current_address = 0x140001000; // Placeholder
-    auto disassembly_result = x64dbg_bridge_->GetDisassembly(current_address);
+    auto disassembly_result = x64dbg_bridge->GetDisassembly(current_address);
     
     if (!disassembly_result.IsSuccess()) {
         if (logger_) {
@@ -325,20 +718,20 @@ void CoreEngine::AnalyzeCurrentContext() {
         logger_->Log(ILogger::LOG_INFO, "Got disassembly:\n" + asm_code);
     }
 
-    // 3. Create a prompt for the LLM
-    LLMRequest request;
-    request.prompt = "Please analyze the following x86_64 assembly code... ";
+    // 3. Create a prompt for the LLM, packed to the configured budget
+    PromptBuilder builder(PromptBudgetOf(llm_engine));
+    builder.SetPrompt("Please analyze the following x86_64 assembly code and explain what it does.");
+    builder.AddDisassembly(asm_code);
+    LLMRequest request = builder.Build();
     // No need to set request.provider, LLMEngine will use the default.
 
     // 4. Send the request to the LLM engine
     if (logger_) {
         logger_->Log(ILogger::LOG_INFO, "Sending request to AI provider...");
     }
-    std::future<Result<LLMResponse>> future_response = llm_engine_->SendRequest(request);
-
-    // 5. Handle the response asynchronously with safe object lifetime
+    // 5. Handle the response on the executor once it arrives; the worker that completes it posts the handler
     auto self = shared_from_this();
-    std::thread([self, current_address, future_response = std::move(future_response)]() mutable {
+    const auto on_response = [self, current_address](std::future<Result<LLMResponse>> future_response) {
         try {
             auto result = future_response.get();
             if (result.IsSuccess()) {
@@ -347,23 +740,7 @@ void CoreEngine::AnalyzeCurrentContext() {
                     self->logger_->Log(ILogger::LOG_INFO, "AI Analysis Received: " + response.content);
                 }
 
-                // Escape the response for the command
-                std::string escaped_comment = response.content;
-                // Basic escaping: replace quotes. A real implementation would be more robust.
-                size_t pos = 0;
-                while ((pos = escaped_comment.find('"', pos)) != std::string::npos) {
-                     escaped_comment.replace(pos, 1, "\"\"");
-                     pos += 2;
-                }
-                
-                std::string command = "SetCommentAt " + std::to_string(current_address) + ", \"" + escaped_comment + "\"";
-                if (self->x64dbg_bridge_) {
-                    self->x64dbg_bridge_->ExecuteCommand(command);
-                }
-                if (self->logger_) {
-                    self->logger_->Log(ILogger::LOG_INFO, "Set comment at address " + std::to_string(current_address));
-                }
-
+                self->AnnotateAddress(current_address, response.content);
             } else {
                 if (self->logger_) {
                     self->logger_->Log(ILogger::LOG_ERROR, "AI analysis failed: " + result.Error());
@@ -375,10 +752,151 @@ void CoreEngine::AnalyzeCurrentContext() {
             }
         } catch (const std::exception& ex) {
             if (self->logger_) {
-                self->logger_->Log(ILogger::LOG_ERROR, "Exception in AI analysis thread: " + std::string(ex.what()));
+                self->logger_->Log(ILogger::LOG_ERROR, "Exception in AI analysis: " + std::string(ex.what()));
+            }
+        }
+    };
+    const auto executor = GetTaskExecutor();
+    bool scheduled = false;
+    if (auto llm_impl = std::dynamic_pointer_cast<LLMEngine>(llm_engine)) {
+        scheduled = Then(executor, llm_impl->AnalyzeAsync(request), on_response);
+    } else {
+        // Other engines only hand back a std::future, which the executor has to poll
+        scheduled = Then(*executor, llm_engine->SendRequest(request), on_response);
+    }
+    if (!scheduled && logger_) {
+        logger_->Log(ILogger::LOG_WARN, "Task executor stopped; AI analysis result will be ignored");
+    }
+}
+
+Result<BatchProgress> CoreEngine::AnalyzeFunctions(const std::vector<uintptr_t>& addresses,
+                                                   const BatchAnalysisOptions& options,
+                                                   const FunctionAnalysisCallback& on_result) {
+    const auto x64dbg_bridge = GetDebugBridge();
+    const auto llm_engine = GetLLMEngine();
+    if (!x64dbg_bridge || !llm_engine) {
+        return Result<BatchProgress>::Error("CoreEngine is not initialized correctly.");
+    }
+
+    struct InFlight {
+        FunctionAnalysis analysis;
+        std::future<Result<LLMResponse>> response;  // Invalid once analysis holds an outcome
+    };
+
+    const auto started = std::chrono::steady_clock::now();
+    const size_t max_in_flight = std::max<size_t>(options.max_in_flight, 1);
+    const size_t fetch_batch = std::max<size_t>(options.fetch_batch, 1);
+    const PromptBudget budget = PromptBudgetOf(llm_engine);
+    auto bridge_impl = std::dynamic_pointer_cast<X64DbgBridge>(x64dbg_bridge);
+
+    BatchProgress progress;
+    progress.total = addresses.size();
+    if (logger_) {
+        logger_->LogFormatted(ILogger::LOG_INFO, "Analyzing %zu functions, %zu at a time",
+                              addresses.size(), max_in_flight);
+    }
+
+    std::deque<InFlight> window;
+    std::deque<std::pair<size_t, Result<std::string>>> listings;  // Fetched, not yet sent
+    size_t next_fetch = 0;
+
+    const auto fetch_more = [&]() {
+        const size_t end = std::min(addresses.size(), next_fetch + fetch_batch);
+        const std::vector<uintptr_t> chunk(addresses.begin() + next_fetch, addresses.begin() + end);
+        std::vector<Result<std::string>> fetched;
+        if (bridge_impl) {
+            fetched = bridge_impl->GetDisassemblyBatch(chunk);
+        } else {
+            for (uintptr_t address : chunk) {
+                fetched.push_back(x64dbg_bridge->GetDisassembly(address));
             }
         }
-    }).detach();
+        for (size_t i = 0; i < fetched.size(); ++i) {
+            listings.emplace_back(next_fetch + i, std::move(fetched[i]));
+        }
+        next_fetch = end;
+    };
+
+    while (progress.completed < progress.total) {
+        // Keep the window full so the engine always has work queued
+        while (window.size() < max_in_flight && (next_fetch < addresses.size() || !listings.empty())) {
+            if (listings.empty()) {
+                fetch_more();
+            }
+            auto [index, listing] = std::move(listings.front());
+            listings.pop_front();
+
+            InFlight entry;
+            entry.analysis.index = index;
+            entry.analysis.address = addresses[index];
+            if (options.cancellation.IsCancelled()) {
+                entry.analysis.error = "Request cancelled";
+            } else if (!listing.IsSuccess()) {
+                entry.analysis.error = "Failed to get disassembly: " + listing.Error();
+            } else {
+                PromptBuilder builder(budget);
+                builder.SetPrompt(options.prompt + "\nFunction at " + HexAddress(addresses[index]) + ".");
+                builder.AddDisassembly(listing.Value());
+                LLMRequest request = builder.Build();
+                request.provider = options.provider;
+                request.cancellation = options.cancellation;
+                entry.response = llm_engine->SendRequest(request);
+            }
+            window.push_back(std::move(entry));
+        }
+
+        InFlight entry = std::move(window.front());
+        window.pop_front();
+        FunctionAnalysis& analysis = entry.analysis;
+        if (entry.response.valid()) {
+            auto result = entry.response.get();
+            if (result.IsSuccess()) {
+                analysis.success = true;
+                analysis.analysis = result.Value().content;
+                if (options.annotate) {
+                    AnnotateAddress(analysis.address, analysis.analysis);
+                }
+            } else {
+                analysis.error = result.Error();
+            }
+        }
+        analysis.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started);
+
+        ++progress.completed;
+        if (!analysis.success) {
+            ++progress.failed;
+        }
+        if (on_result) {
+            on_result(analysis, progress);
+        }
+    }
+
+    if (logger_) {
+        logger_->LogFormatted(ILogger::LOG_INFO, "Analyzed %zu functions (%zu failed) in %lld ms",
+                              progress.completed, progress.failed,
+                              static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                  std::chrono::steady_clock::now() - started).count()));
+    }
+    return Result<BatchProgress>::Success(progress);
+}
+
+void CoreEngine::AnnotateAddress(uintptr_t address, const std::string& text) {
+    // Basic escaping: replace quotes. A real implementation would be more robust.
+    std::string escaped_comment = text;
+    size_t pos = 0;
+    while ((pos = escaped_comment.find('"', pos)) != std::string::npos) {
+         escaped_comment.replace(pos, 1, "\"\"");
+         pos += 2;
+    }
+
+    std::string command = "SetCommentAt " + std::to_string(address) + ", \"" + escaped_comment + "\"";
+    if (auto x64dbg_bridge = GetDebugBridge()) {
+        x64dbg_bridge->ExecuteCommand(command);
+    }
+    if (logger_) {
+        logger_->Log(ILogger::LOG_INFO, "Set comment at address " + std::to_string(address));
+    }
 }
 
 // Factory function implementation
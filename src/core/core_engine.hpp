@@ -5,9 +5,61 @@
 #include <memory>
 #include <mutex>
 #include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
 
 namespace mcp {
 
+class TaskExecutor;
+class LLMEngine;
+class X64DbgBridge;
+class DumpAnalyzer;
+
+struct BatchAnalysisOptions {
+    std::string prompt = "Explain what this function does and suggest a descriptive name for it.";
+    std::string provider;             // Empty uses the engine's default
+    size_t max_in_flight = 8;         // LLM requests outstanding at once
+    size_t fetch_batch = 32;          // Addresses disassembled per bridge round trip
+    bool annotate = false;            // Write each answer back as a comment at its address
+    CancellationToken cancellation;   // Stops the batch; results still arrive, as errors
+};
+
+struct FunctionAnalysis {
+    size_t index = 0;                 // Position in the address list
+    uintptr_t address = 0;
+    bool success = false;
+    std::string analysis;             // The model's answer
+    std::string error;
+    std::chrono::milliseconds elapsed{0};  // Since the batch started
+};
+
+struct BatchProgress {
+    size_t total = 0;
+    size_t completed = 0;             // Delivered so far, failures included
+    size_t failed = 0;
+};
+
+struct StartupPhase {
+    enum class Kind {
+        SERIAL,       // On the Initialize() thread
+        PARALLEL,     // On the executor, overlapping the serial phases
+        LAZY          // Built by the first Get*() call, after Initialize()
+    };
+
+    std::string name;
+    std::chrono::microseconds elapsed{0};
+    Kind kind = Kind::SERIAL;
+};
+
+struct StartupReport {
+    std::vector<StartupPhase> phases;     // In completion order
+    std::chrono::microseconds total{0};   // Initialize() wall time
+
+    std::string ToString() const;
+};
+
 /**
  * @brief Core engine orchestrates all MCP Debugger modules with thread-safe initialization
  * 
@@ -16,6 +68,9 @@ namespace mcp {
  * - Thread-safe initialization with dependency injection support
  * - Lock-free access to modules after initialization (performance optimization)
  * - Safe async operations with proper object lifetime management
+ * - One work-stealing executor, shared by the modules, for background work
+ * - The dump analyzer, debug bridge and LLM engine are built on first use,
+ *   so short-lived commands only pay for the modules they touch
  */
 class CoreEngine : public ICoreEngine, public std::enable_shared_from_this<CoreEngine> {
 public:
@@ -41,10 +96,25 @@ public:
 
     /**
      * @brief Analyzes current debugging context using AI
-     * @note This method is async and uses detached threads with safe object lifetime
+     * @note Returns once the request is sent; the answer is handled by a
+     *       continuation on the task executor
      */
     void AnalyzeCurrentContext();
 
+    using FunctionAnalysisCallback = std::function<void(const FunctionAnalysis& result, const BatchProgress& progress)>;
+
+    /**
+     * @brief Analyzes many functions with bounded concurrency
+     *
+     * Disassembly is fetched fetch_batch addresses at a time and each
+     * listing goes out as its own request, with at most max_in_flight
+     * waiting on the LLM engine. Blocks until every address is done;
+     * on_result runs on the calling thread once per address, in input order.
+     */
+    Result<BatchProgress> AnalyzeFunctions(const std::vector<uintptr_t>& addresses,
+                                           const BatchAnalysisOptions& options,
+                                           const FunctionAnalysisCallback& on_result);
+
     // ICoreEngine implementation
     Result<void> Initialize() override;
     Result<void> Shutdown() override;
@@ -60,6 +130,11 @@ public:
     Result<void> LoadConfiguration(const std::string& config_file);
     Result<void> InitializeFromConfig();
     bool IsInitialized() const;
+    // Sized to the hardware; stopped by Shutdown() and restarted by Initialize()
+    std::shared_ptr<ITaskExecutor> GetTaskExecutor() const;
+    // Builds the modules that are otherwise created on first use, in parallel on the executor
+    void PreloadModules(bool wait = true);
+    StartupReport GetStartupReport() const;
 
 private:
     std::shared_ptr<ILogger> logger_;
@@ -68,24 +143,56 @@ private:
 
     mutable std::mutex engine_mutex_;
     std::atomic<bool> initialized_{false};
-    std::atomic<bool> modules_immutable_{false}; // True after successful init - no more locking needed
+    std::atomic<bool> modules_immutable_{false}; // True between a successful init and shutdown
+    std::atomic<bool> config_applied_{false};    // InitializeFromConfig() ran; lazy modules get the config too
+    
+    // Lazily built modules are read with atomic_load; each has its own build lock
+    std::mutex llm_build_mutex_;
+    std::mutex bridge_build_mutex_;
+    std::mutex analyzer_build_mutex_;
+    std::shared_ptr<void> alive_token_;         // Parser memory builtins stop reaching the engine once reset
+    
+    mutable std::mutex startup_mutex_;
+    StartupReport startup_report_;
     
     // Core modules - initialized in dependency order
     std::shared_ptr<IConfigManager> config_manager_;
     std::shared_ptr<IExprParser> expr_parser_;
     std::shared_ptr<IDumpAnalyzer> dump_analyzer_;
     std::shared_ptr<ISecurityManager> security_manager_;
+    std::shared_ptr<TaskExecutor> executor_;    // Replaced under engine_mutex_ with atomic_store; read elsewhere with atomic_load
+    size_t config_subscription_ = 0;            // ConfigManager listener applying reloads
     
     // Initialization helpers
     Result<void> InitializeLogger();
     Result<void> InitializeConfigManager();
     Result<void> InitializeExprParser();
-    Result<void> InitializeDumpAnalyzer();
     Result<void> InitializeSecurityManager();
-    Result<void> InitializeDebugBridge();
+    // Parser memory builtins read through the debug bridge, building it if needed
+    void ConnectParserMemory();
+    
+    // First-use builders; null when construction failed
+    std::shared_ptr<IDumpAnalyzer> CreateDumpAnalyzer();
+    std::shared_ptr<IX64DbgBridge> CreateDebugBridge();
+    std::shared_ptr<ILLMEngine> CreateLLMEngine();
+    template<typename T, typename Factory>
+    std::shared_ptr<T> EnsureModule(std::shared_ptr<T>& slot, std::mutex& build_mutex, const char* name,
+                                    Factory create);
+    void RecordStartupPhase(const char* name, std::chrono::steady_clock::time_point started, StartupPhase::Kind kind);
+    
+    // Pushes the given sections (ConfigManager::Section bits) of config to the modules
+    void ApplyConfig(const Config& config, uint32_t sections);
+    void ConfigureLLMEngine(LLMEngine& llm, const Config& config);
+    void ConfigureDebugBridge(X64DbgBridge& bridge, const Config& config);
+    
+    // Hands the executor to every module that can schedule work on it
+    void AttachExecutor();
     
     // Shutdown helpers
     void ShutdownModules();
+
+    // Writes text as the debugger comment at address
+    void AnnotateAddress(uintptr_t address, const std::string& text);
     
     // Configuration loading
     Result<void> LoadDefaultConfiguration();
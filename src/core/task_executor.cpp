@@ -0,0 +1,280 @@
+#include "task_executor.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <utility>
+
+namespace mcp {
+
+namespace {
+
+// Which executor, if any, the current thread works for
+thread_local const void* tls_executor_state = nullptr;
+thread_local size_t tls_worker_index = 0;
+
+constexpr std::chrono::milliseconds kMinPoll{1};
+
+} // anonymous namespace
+
+struct TaskExecutor::State {
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;  // Owner works at the back, thieves at the front
+    };
+
+    struct Watch {
+        std::function<bool()> ready;
+        Task task;
+    };
+
+    explicit State(size_t worker_count, std::chrono::milliseconds poll)
+        : queues(worker_count), max_poll(std::max(poll, kMinPoll)) {}
+
+    std::vector<Queue> queues;
+    std::mutex shared_mutex;
+    std::deque<Task> shared;     // Posted from outside the pool
+
+    std::atomic<size_t> pending{0};  // Queued anywhere, not yet taken
+    std::atomic<bool> stopping{false};
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+
+    std::mutex watch_mutex;
+    std::condition_variable watch_changed;
+    std::vector<Watch> watches;
+    std::vector<Watch> dropped;      // Left for Shutdown to destroy off the watcher
+    bool watch_added = false;
+    bool closing = false;
+    std::chrono::milliseconds max_poll;
+
+    std::atomic<uint64_t> posted{0};
+    std::atomic<uint64_t> executed{0};
+    std::atomic<uint64_t> stolen{0};
+    std::atomic<uint64_t> continuations{0};
+    std::atomic<uint64_t> dropped_count{0};
+
+    void Enqueue(Task task) {
+        if (tls_executor_state == this) {
+            Queue& own = queues[tls_worker_index];
+            const std::lock_guard<std::mutex> lock(own.mutex);
+            own.tasks.push_back(std::move(task));
+        } else {
+            const std::lock_guard<std::mutex> lock(shared_mutex);
+            shared.push_back(std::move(task));
+        }
+        ++posted;
+        ++pending;
+        // Taking the lock orders this against a worker checking pending before it sleeps
+        { const std::lock_guard<std::mutex> lock(sleep_mutex); }
+        wake.notify_one();
+    }
+
+    bool TryTake(size_t index, Task& task) {
+        {
+            Queue& own = queues[index];
+            const std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                --pending;
+                return true;
+            }
+        }
+        {
+            const std::lock_guard<std::mutex> lock(shared_mutex);
+            if (!shared.empty()) {
+                task = std::move(shared.front());
+                shared.pop_front();
+                --pending;
+                return true;
+            }
+        }
+        for (size_t step = 1; step < queues.size(); ++step) {
+            Queue& victim = queues[(index + step) % queues.size()];
+            const std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                --pending;
+                ++stolen;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+TaskExecutor::TaskExecutor(TaskExecutorOptions options) {
+    size_t worker_count = options.worker_threads;
+    if (worker_count == 0) {
+        worker_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    state_ = std::make_shared<State>(worker_count, options.max_poll);
+    workers_.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers_.emplace_back(&TaskExecutor::WorkerLoop, state_, i);
+    }
+    watcher_ = std::thread(&TaskExecutor::WatcherLoop, state_);
+}
+
+TaskExecutor::~TaskExecutor() {
+    Shutdown();
+}
+
+bool TaskExecutor::Post(Task task) {
+    if (!task || state_->stopping.load()) {
+        return false;
+    }
+    state_->Enqueue(std::move(task));
+    return true;
+}
+
+bool TaskExecutor::PostWhen(std::function<bool()> ready, Task task) {
+    if (!ready || !task) {
+        return false;
+    }
+    {
+        const std::lock_guard<std::mutex> lock(state_->watch_mutex);
+        if (state_->closing) {
+            return false;
+        }
+        state_->watches.push_back({std::move(ready), std::move(task)});
+        state_->watch_added = true;
+    }
+    state_->watch_changed.notify_one();
+    return true;
+}
+
+size_t TaskExecutor::GetWorkerCount() const {
+    return state_->queues.size();
+}
+
+void TaskExecutor::Shutdown() {
+    if (shut_down_.exchange(true)) {
+        return;
+    }
+    const auto self = std::this_thread::get_id();
+    const auto finish = [self](std::thread& thread) {
+        if (!thread.joinable()) {
+            return;
+        }
+        // Destroyed from one of our own tasks: that thread finishes by itself
+        if (thread.get_id() == self) {
+            thread.detach();
+        } else {
+            thread.join();
+        }
+    };
+
+    // The watcher's last pass still queues whatever became ready
+    {
+        const std::lock_guard<std::mutex> lock(state_->watch_mutex);
+        state_->closing = true;
+    }
+    state_->watch_changed.notify_all();
+    finish(watcher_);
+    std::vector<State::Watch> dropped;
+    {
+        const std::lock_guard<std::mutex> lock(state_->watch_mutex);
+        dropped.swap(state_->dropped);
+    }
+    dropped.clear();
+
+    {
+        const std::lock_guard<std::mutex> lock(state_->sleep_mutex);
+        state_->stopping = true;
+    }
+    state_->wake.notify_all();
+    for (auto& worker : workers_) {
+        finish(worker);
+    }
+}
+
+bool TaskExecutor::IsRunning() const {
+    return !shut_down_.load();
+}
+
+TaskExecutor::Stats TaskExecutor::GetStats() const {
+    Stats stats;
+    stats.posted = state_->posted.load();
+    stats.executed = state_->executed.load();
+    stats.stolen = state_->stolen.load();
+    stats.continuations = state_->continuations.load();
+    stats.dropped = state_->dropped_count.load();
+    stats.queued = state_->pending.load();
+    const std::lock_guard<std::mutex> lock(state_->watch_mutex);
+    stats.watching = state_->watches.size();
+    return stats;
+}
+
+void TaskExecutor::WorkerLoop(std::shared_ptr<State> state, size_t index) {
+    tls_executor_state = state.get();
+    tls_worker_index = index;
+    for (;;) {
+        Task task;
+        if (state->TryTake(index, task)) {
+            try {
+                task();
+            } catch (...) {
+                // A throwing task must not take the worker down with it
+            }
+            task = nullptr;  // Captured state goes before the count says we are done
+            ++state->executed;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(state->sleep_mutex);
+        state->wake.wait(lock, [&state]() { return state->stopping.load() || state->pending.load() > 0; });
+        if (state->stopping.load() && state->pending.load() == 0) {
+            return;  // Drained
+        }
+    }
+}
+
+void TaskExecutor::WatcherLoop(std::shared_ptr<State> state) {
+    std::unique_lock<std::mutex> lock(state->watch_mutex);
+    std::chrono::milliseconds interval = kMinPoll;
+    for (;;) {
+        if (state->watches.empty() && !state->closing) {
+            state->watch_changed.wait(lock, [&state]() { return state->closing || !state->watches.empty(); });
+            interval = kMinPoll;
+        }
+
+        std::vector<State::Watch> ready;
+        auto waiting = std::partition(state->watches.begin(), state->watches.end(),
+                                      [](const State::Watch& watch) { return !watch.ready(); });
+        std::move(waiting, state->watches.end(), std::back_inserter(ready));
+        state->watches.erase(waiting, state->watches.end());
+        state->watch_added = false;
+
+        if (state->closing) {
+            state->dropped_count += state->watches.size();
+            std::move(state->watches.begin(), state->watches.end(), std::back_inserter(state->dropped));
+            state->watches.clear();
+        }
+        const bool closing = state->closing;
+        const bool progressed = !ready.empty();
+
+        lock.unlock();
+        for (auto& watch : ready) {
+            ++state->continuations;
+            state->Enqueue(std::move(watch.task));
+        }
+        ready.clear();
+        if (closing) {
+            return;
+        }
+        lock.lock();
+
+        // Futures that are slow to finish are checked less and less often
+        interval = progressed ? kMinPoll : std::min(interval * 2, state->max_poll);
+        state->watch_changed.wait_for(lock, interval, [&state]() { return state->closing || state->watch_added; });
+        if (state->watch_added) {
+            interval = kMinPoll;
+        }
+    }
+}
+
+} // namespace mcp
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "mcp/interfaces.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace mcp {
+
+struct TaskExecutorOptions {
+    size_t worker_threads = 0;                  // 0 sizes the pool to the hardware
+    std::chrono::milliseconds max_poll{20};     // Slowest readiness check for PostWhen
+};
+
+/**
+ * @brief Work-stealing thread pool shared by the engine's modules
+ *
+ * Every worker owns a deque: tasks posted from a worker go on its own
+ * deque and it takes the newest first, while idle workers steal the
+ * oldest from the others. Tasks posted from outside wait in a shared FIFO.
+ * PostWhen continuations are watched by one extra thread that polls their
+ * readiness with a backoff, so no worker sits blocked on a future; Then()
+ * on a Future from Submit() is posted by the producer and never watched.
+ *
+ * Threads only touch state shared with them, so the executor may be
+ * destroyed from one of its own tasks: that worker is detached instead of
+ * joined and finishes the queue on its own.
+ */
+class TaskExecutor : public ITaskExecutor {
+public:
+    struct Stats {
+        uint64_t posted = 0;
+        uint64_t executed = 0;
+        uint64_t stolen = 0;          // Taken from another worker's deque
+        uint64_t continuations = 0;   // PostWhen tasks that became ready
+        uint64_t dropped = 0;         // PostWhen tasks still waiting at shutdown
+        size_t queued = 0;
+        size_t watching = 0;
+    };
+
+    explicit TaskExecutor(TaskExecutorOptions options = {});
+    ~TaskExecutor() override;
+    TaskExecutor(const TaskExecutor&) = delete;
+    TaskExecutor& operator=(const TaskExecutor&) = delete;
+
+    // ITaskExecutor implementation
+    bool Post(Task task) override;
+    bool PostWhen(std::function<bool()> ready, Task task) override;
+    size_t GetWorkerCount() const override;
+
+    /**
+     * @brief Stop accepting work and wind the threads down
+     *
+     * Continuations that are ready by now are run; the rest are dropped.
+     * Everything queued is executed before the workers exit. Only the
+     * first call does anything.
+     */
+    void Shutdown();
+    bool IsRunning() const;
+    Stats GetStats() const;
+
+private:
+    struct State;
+
+    std::shared_ptr<State> state_;
+    std::vector<std::thread> workers_;
+    std::thread watcher_;
+    std::atomic<bool> shut_down_{false};
+
+    static void WorkerLoop(std::shared_ptr<State> state, size_t index);
+    static void WatcherLoop(std::shared_ptr<State> state);
+};
+
+} // namespace mcp
@@ -6,55 +6,373 @@
 #include <memory>
 #include <utility>
 #include <unordered_map>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <map>
 
 namespace mcp {
 
 using json = nlohmann::json;
 
+namespace {
+
+constexpr size_t kMaxErrorBody = 512;  // Enough of an error body to log
+
+// The string at pointer, or empty when it is missing or not a string
+std::string StringAt(const json& value, const char* pointer) {
+    const json::json_pointer path(pointer);
+    if (!value.contains(path)) {
+        return std::string();
+    }
+    const json& field = value.at(path);
+    return field.is_string() ? field.get<std::string>() : std::string();
+}
+
+// Lower-cased so lookups do not depend on how the server spells them
+std::map<std::string, std::string> LowerCaseHeaders(const httplib::Headers& headers) {
+    std::map<std::string, std::string> lowered;
+    for (const auto& [name, value] : headers) {
+        std::string key = name;
+        std::transform(key.begin(), key.end(), key.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        lowered.emplace(std::move(key), value);
+    }
+    return lowered;
+}
+
+} // anonymous namespace
+
 // --- BaseAIProvider ---
 BaseAIProvider::BaseAIProvider(std::string name, std::string host, std::shared_ptr<ILogger> logger)
-    : name_(std::move(name)), host_(std::move(host)), logger_(std::move(logger)) {}
+    : name_(std::move(name)), host_(std::move(host)), logger_(std::move(logger)),
+      http_pool_(std::make_shared<HttpClientPool>()) {}
 
 const std::string& BaseAIProvider::GetName() const { return name_; }
 void BaseAIProvider::SetAPIKey(const std::string& api_key) { api_key_ = api_key; }
 std::unordered_map<std::string, std::string> BaseAIProvider::GetCommonHeaders() { return {}; }
 
+void BaseAIProvider::Configure(const APIConfig& config) {
+    HttpPoolOptions options = http_pool_->GetHostOptions(host_);
+    if (config.timeout_ms > 0) {
+        options.io_timeout = std::chrono::milliseconds(config.timeout_ms);
+        options.connect_timeout = std::min(options.connect_timeout, options.io_timeout);
+        options.acquire_timeout = options.io_timeout;
+    }
+    if (config.pool_size > 0) {
+        options.max_connections = config.pool_size;
+    }
+    if (config.keep_alive_ms >= 0) {
+        options.idle_timeout = std::chrono::milliseconds(config.keep_alive_ms);
+    }
+    http_pool_->SetHostOptions(host_, options);
+    max_retries_ = std::max(config.max_retries, 0);
+
+    RateLimitOptions limits;
+    limits.requests_per_minute = std::max(config.requests_per_minute, 0);
+    limits.tokens_per_minute = std::max(config.tokens_per_minute, 0);
+    rate_limiter_.SetOptions(limits);
+}
+
+void BaseAIProvider::SetHttpClientPool(std::shared_ptr<HttpClientPool> pool) {
+    if (pool) {
+        http_pool_ = std::move(pool);
+    }
+}
+
+void BaseAIProvider::SetRequestScheduler(std::weak_ptr<LLMRequestScheduler> scheduler) {
+    scheduler_ = std::move(scheduler);
+}
+
+void BaseAIProvider::SetTaskExecutor(std::weak_ptr<ITaskExecutor> executor) {
+    executor_ = std::move(executor);
+}
+
+Result<HttpReply> BaseAIProvider::PostJson(const std::string& path, const std::map<std::string, std::string>& headers,
+                                           const std::string& payload, const LLMRequest& request) {
+    httplib::Headers request_headers(headers.begin(), headers.end());
+    const int attempts = max_retries_.load() + 1;
+    const double estimated_tokens = EstimateTokens(request);
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+        if (!rate_limiter_.Acquire(estimated_tokens, request.cancellation)) {
+            return Result<HttpReply>::Error("Request cancelled");
+        }
+
+        std::optional<std::chrono::milliseconds> retry_after;
+        {
+            auto lease_result = http_pool_->Acquire(host_);
+            if (!lease_result.IsSuccess()) {
+                return Result<HttpReply>::Error(lease_result.Error());
+            }
+            HttpClientPool::Lease lease = lease_result.TakeValue();
+
+            auto res = lease->Post(path, request_headers, payload, "application/json");
+            if (res) {
+                HttpReply reply;
+                reply.status = res->status;
+                reply.body = res->body;
+                reply.headers = LowerCaseHeaders(res->headers);
+                rate_limiter_.Observe(reply.status, reply.headers);
+                if (!ProviderRateLimiter::IsRetryableStatus(reply.status) || attempt + 1 >= attempts) {
+                    return Result<HttpReply>::Success(std::move(reply));
+                }
+                retry_after = ProviderRateLimiter::RetryAfter(reply.headers);
+                if (logger_) {
+                    logger_->LogFormatted(ILogger::LOG_DEBUG, "%s: HTTP %d from %s (attempt %d of %d)",
+                                          name_.c_str(), reply.status, host_.c_str(), attempt + 1, attempts);
+                }
+            } else {
+                // Usually a keep-alive connection the server already closed
+                lease.Discard();
+                if (logger_) {
+                    logger_->LogFormatted(ILogger::LOG_DEBUG, "%s: request to %s failed (attempt %d of %d)",
+                                          name_.c_str(), host_.c_str(), attempt + 1, attempts);
+                }
+                if (attempt == 0) {
+                    continue;  // A fresh connection needs no backoff
+                }
+            }
+        }
+
+        if (attempt + 1 < attempts) {
+            rate_limiter_.RecordRetry();
+            if (!ProviderRateLimiter::SleepFor(rate_limiter_.BackoffFor(attempt, retry_after), request.cancellation)) {
+                return Result<HttpReply>::Error("Request cancelled");
+            }
+        }
+    }
+    return Result<HttpReply>::Error("HTTP request failed after " + std::to_string(attempts) + " attempts");
+}
+
+Result<LLMResponse> BaseAIProvider::StreamJson(const std::string& path, const std::map<std::string, std::string>& headers,
+                                               const std::string& payload, const DeltaExtractor& extract,
+                                               const LLMRequest& request, const LLMStreamCallback& on_chunk) {
+    const auto started = std::chrono::steady_clock::now();
+    httplib::Headers request_headers(headers.begin(), headers.end());
+    if (request_headers.find("Content-Type") == request_headers.end()) {
+        request_headers.emplace("Content-Type", "application/json");
+    }
+    request_headers.emplace("Accept", "text/event-stream");
+
+    LLMResponse response;
+    const int attempts = max_retries_.load() + 1;
+    const double estimated_tokens = EstimateTokens(request);
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+        if (!rate_limiter_.Acquire(estimated_tokens, request.cancellation)) {
+            return Result<LLMResponse>::Error("Request cancelled");
+        }
+
+        int status = 0;
+        std::map<std::string, std::string> reply_headers;
+        std::string error_body;
+        std::string stream_error;
+        bool sent = false;
+        bool done = false;
+        bool stopped = false;
+        bool cancelled = false;
+        {
+            auto lease_result = http_pool_->Acquire(host_);
+            if (!lease_result.IsSuccess()) {
+                return Result<LLMResponse>::Error(lease_result.Error());
+            }
+            HttpClientPool::Lease lease = lease_result.TakeValue();
+
+            SseParser parser;
+            const auto on_event = [&](const SseEvent& event) {
+                if (done) {
+                    return true;  // Anything after the end marker carries no text
+                }
+                std::string text;
+                const StreamStep step = extract(event, text, stream_error);
+                if (!text.empty()) {
+                    response.content += text;
+                    if (on_chunk && !on_chunk(text)) {
+                        stopped = true;
+                        return false;
+                    }
+                }
+                if (step == StreamStep::FAILED) {
+                    if (stream_error.empty()) {
+                        stream_error = "stream failed";
+                    }
+                    return false;
+                }
+                done = (step == StreamStep::DONE);
+                return true;
+            };
+
+            httplib::Request http_request;
+            http_request.method = "POST";
+            http_request.path = path;
+            http_request.headers = request_headers;
+            http_request.body = payload;
+            http_request.response_handler = [&](const httplib::Response& head) {
+                status = head.status;
+                reply_headers = LowerCaseHeaders(head.headers);
+                rate_limiter_.Observe(status, reply_headers);
+                return true;
+            };
+            http_request.content_receiver = [&](const char* data, size_t size, uint64_t, uint64_t) {
+                if (status != 200) {
+                    error_body.append(data, std::min(size, kMaxErrorBody - error_body.size()));
+                    return error_body.size() < kMaxErrorBody;
+                }
+                if (request.cancellation.IsCancelled()) {
+                    cancelled = true;
+                    return false;
+                }
+                return parser.Feed(data, size, on_event);
+            };
+
+            httplib::Response http_response;
+            httplib::Error error = httplib::Error::Success;
+            sent = lease->send(http_request, http_response, error);
+            if (sent && status == 200) {
+                parser.Finish(on_event);
+            }
+            // A stream abandoned part way leaves the connection mid-response
+            if (!sent || parser.Stopped()) {
+                lease.Discard();
+            }
+        }
+
+        if (cancelled) {
+            return Result<LLMResponse>::Error("Request cancelled");
+        }
+        if (!stream_error.empty()) {
+            return Result<LLMResponse>::Error("API Error: " + stream_error);
+        }
+
+        if (status != 0 && status != 200) {
+            const auto retry_after = ProviderRateLimiter::RetryAfter(reply_headers);
+            if (ProviderRateLimiter::IsRetryableStatus(status) && attempt + 1 < attempts) {
+                if (logger_) {
+                    logger_->LogFormatted(ILogger::LOG_DEBUG, "%s: HTTP %d from %s (attempt %d of %d)",
+                                          name_.c_str(), status, host_.c_str(), attempt + 1, attempts);
+                }
+                rate_limiter_.RecordRetry();
+                if (!ProviderRateLimiter::SleepFor(rate_limiter_.BackoffFor(attempt, retry_after), request.cancellation)) {
+                    return Result<LLMResponse>::Error("Request cancelled");
+                }
+                continue;
+            }
+            if (logger_) {
+                logger_->LogFormatted(ILogger::LOG_DEBUG, "%s: stream rejected with HTTP %d: %s",
+                                      name_.c_str(), status, error_body.c_str());
+            }
+            return Result<LLMResponse>::Error("API Error: " + std::to_string(status));
+        }
+        if (!sent && !stopped && !done) {
+            // Delivered chunks cannot be taken back, so only a stream that sent nothing is retried
+            if (!response.content.empty()) {
+                return Result<LLMResponse>::Error("Stream interrupted after " +
+                                                  std::to_string(response.content.size()) + " bytes");
+            }
+            if (logger_) {
+                logger_->LogFormatted(ILogger::LOG_DEBUG, "%s: stream to %s failed (attempt %d of %d)",
+                                      name_.c_str(), host_.c_str(), attempt + 1, attempts);
+            }
+            if (attempt > 0 && attempt + 1 < attempts) {
+                rate_limiter_.RecordRetry();
+                if (!ProviderRateLimiter::SleepFor(rate_limiter_.BackoffFor(attempt, std::nullopt), request.cancellation)) {
+                    return Result<LLMResponse>::Error("Request cancelled");
+                }
+            }
+            continue;
+        }
+
+        response.provider = name_;
+        response.success = true;
+        response.response_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started);
+        return Result<LLMResponse>::Success(std::move(response));
+    }
+    return Result<LLMResponse>::Error("HTTP request failed after " + std::to_string(attempts) + " attempts");
+}
+
+std::string BaseAIProvider::UserMessage(const LLMRequest& request) {
+    if (request.context.empty()) {
+        return request.prompt;
+    }
+    std::string message = request.prompt + "\n\nContext:";
+    for (const auto& item : request.context) {
+        message += "\n\n" + item;
+    }
+    return message;
+}
+
+double BaseAIProvider::EstimateTokens(const LLMRequest& request) {
+    // About four characters a token for English and code; the answer may use all of max_tokens
+    size_t characters = request.prompt.size() + request.system_prompt.value_or(std::string()).size();
+    for (const auto& item : request.context) {
+        characters += item.size();
+    }
+    return static_cast<double>(characters) / 4.0 + std::max(request.max_tokens, 0);
+}
+
 // --- OpenAIProvider ---
 OpenAIProvider::OpenAIProvider(std::shared_ptr<ILogger> logger)
     : BaseAIProvider("openai", "api.openai.com", std::move(logger)) {}
 
 std::future<Result<LLMResponse>> OpenAIProvider::SendRequest(const LLMRequest& request) {
-    return ExecuteAsync([this, request]() {
+    return ExecuteAsync(request, [this, request]() {
         return SendRequestImpl(request);
     });
 }
 
 Result<LLMResponse> OpenAIProvider::SendRequestImpl(const LLMRequest& request) {
-    auto cli = httplib::Client(host_);
-    
-    httplib::Headers headers;
+    std::map<std::string, std::string> headers;
     headers.emplace("Authorization", "Bearer " + api_key_);
     headers.emplace("Content-Type", "application/json");
     
     std::string payload = FormatRequest(request);
-    auto res = cli.Post("/v1/chat/completions", headers, payload, "application/json");
+    auto res = PostJson("/v1/chat/completions", headers, payload, request);
     
-    if (!res) {
-        return Result<LLMResponse>::Error("HTTP request failed");
+    if (!res.IsSuccess()) {
+        return Result<LLMResponse>::Error(res.Error());
     }
     
-    return ParseResponse(res->body, res->status);
+    return ParseResponse(res.Value().body, res.Value().status);
+}
+
+Result<LLMResponse> OpenAIProvider::SendRequestStreaming(const LLMRequest& request, const LLMStreamCallback& on_chunk) {
+    std::map<std::string, std::string> headers;
+    headers.emplace("Authorization", "Bearer " + api_key_);
+    headers.emplace("Content-Type", "application/json");
+
+    const auto extract = [](const SseEvent& event, std::string& text, std::string& error) {
+        if (event.data == "[DONE]") {
+            return StreamStep::DONE;
+        }
+        try {
+            const json chunk = json::parse(event.data);
+            if (chunk.contains("error")) {
+                error = StringAt(chunk, "/error/message");
+                return StreamStep::FAILED;
+            }
+            text = StringAt(chunk, "/choices/0/delta/content");
+        } catch (const json::exception& e) {
+            error = "malformed stream event: " + std::string(e.what());
+            return StreamStep::FAILED;
+        }
+        return StreamStep::CONTINUE;
+    };
+    return StreamJson("/v1/chat/completions", headers, FormatRequest(request, true), extract,
+                      request, on_chunk);
 }
 
-std::string OpenAIProvider::FormatRequest(const LLMRequest& r) {
+std::string OpenAIProvider::FormatRequest(const LLMRequest& r, bool stream) {
     json payload = {
         {"model", "gpt-4-turbo"},
         {"messages", {
-            {{"role", "system"}, {"content", "You are a reverse engineering assistant."}},
-            {{"role", "user"}, {"content", r.prompt}}
+            {{"role", "system"}, {"content", r.system_prompt.value_or("You are a reverse engineering assistant.")}},
+            {{"role", "user"}, {"content", UserMessage(r)}}
         }},
-        {"max_tokens", 4096}
+        {"max_tokens", r.max_tokens > 0 ? r.max_tokens : 4096}
     };
+    if (stream) {
+        payload["stream"] = true;
+    }
     return payload.dump();
 }
 
@@ -86,36 +404,66 @@ std::unordered_map<std::string, std::string> ClaudeProvider::GetCommonHeaders()
 }
 
 std::future<Result<LLMResponse>> ClaudeProvider::SendRequest(const LLMRequest& request) {
-    return ExecuteAsync([this, request]() {
+    return ExecuteAsync(request, [this, request]() {
         return SendRequestImpl(request);
     });
 }
 
 Result<LLMResponse> ClaudeProvider::SendRequestImpl(const LLMRequest& request) {
-    auto cli = httplib::Client(host_);
-    
     auto headers_map = GetCommonHeaders();
-    httplib::Headers headers;
-    for (const auto& [key, value] : headers_map) {
-        headers.emplace(key, value);
-    }
+    std::map<std::string, std::string> headers(headers_map.begin(), headers_map.end());
     
     std::string payload = FormatRequest(request);
-    auto res = cli.Post("/v1/messages", headers, payload, "application/json");
+    auto res = PostJson("/v1/messages", headers, payload, request);
     
-    if (!res) {
-        return Result<LLMResponse>::Error("HTTP request failed");
+    if (!res.IsSuccess()) {
+        return Result<LLMResponse>::Error(res.Error());
     }
     
-    return ParseResponse(res->body, res->status);
+    return ParseResponse(res.Value().body, res.Value().status);
 }
 
-std::string ClaudeProvider::FormatRequest(const LLMRequest& r) {
+Result<LLMResponse> ClaudeProvider::SendRequestStreaming(const LLMRequest& request, const LLMStreamCallback& on_chunk) {
+    auto headers_map = GetCommonHeaders();
+    std::map<std::string, std::string> headers(headers_map.begin(), headers_map.end());
+
+    // Text arrives in content_block_delta events; pings and block bookkeeping carry none
+    const auto extract = [](const SseEvent& event, std::string& text, std::string& error) {
+        try {
+            const json chunk = json::parse(event.data);
+            const std::string type = StringAt(chunk, "/type");
+            if (type == "error") {
+                error = StringAt(chunk, "/error/message");
+                return StreamStep::FAILED;
+            }
+            if (type == "message_stop") {
+                return StreamStep::DONE;
+            }
+            if (type == "content_block_delta") {
+                text = StringAt(chunk, "/delta/text");
+            }
+        } catch (const json::exception& e) {
+            error = "malformed stream event: " + std::string(e.what());
+            return StreamStep::FAILED;
+        }
+        return StreamStep::CONTINUE;
+    };
+    return StreamJson("/v1/messages", headers, FormatRequest(request, true), extract,
+                      request, on_chunk);
+}
+
+std::string ClaudeProvider::FormatRequest(const LLMRequest& r, bool stream) {
     json payload = {
         {"model", "claude-3-opus-20240229"},
-        {"max_tokens", 4096},
-        {"messages", {{{"role", "user"}, {"content", r.prompt}}}}
+        {"max_tokens", r.max_tokens > 0 ? r.max_tokens : 4096},
+        {"messages", {{{"role", "user"}, {"content", UserMessage(r)}}}}
     };
+    if (r.system_prompt) {
+        payload["system"] = *r.system_prompt;
+    }
+    if (stream) {
+        payload["stream"] = true;
+    }
     return payload.dump();
 }
 
@@ -139,29 +487,51 @@ GeminiProvider::GeminiProvider(std::shared_ptr<ILogger> logger)
     : BaseAIProvider("gemini", "generativelanguage.googleapis.com", std::move(logger)) {}
 
 std::future<Result<LLMResponse>> GeminiProvider::SendRequest(const LLMRequest& request) {
-    return ExecuteAsync([this, request]() {
+    return ExecuteAsync(request, [this, request]() {
         return SendRequestImpl(request);
     });
 }
 
 Result<LLMResponse> GeminiProvider::SendRequestImpl(const LLMRequest& request) {
-    auto cli = httplib::Client(host_);
-    
     std::string payload = FormatRequest(request);
     std::string path = "/v1beta/models/gemini-1.5-pro-latest:generateContent?key=" + api_key_;
-    auto res = cli.Post(path, payload, "application/json");
+    auto res = PostJson(path, {}, payload, request);
     
-    if (!res) {
-        return Result<LLMResponse>::Error("HTTP request failed");
+    if (!res.IsSuccess()) {
+        return Result<LLMResponse>::Error(res.Error());
     }
     
-    return ParseResponse(res->body, res->status);
+    return ParseResponse(res.Value().body, res.Value().status);
+}
+
+Result<LLMResponse> GeminiProvider::SendRequestStreaming(const LLMRequest& request, const LLMStreamCallback& on_chunk) {
+    // Each event is a complete GenerateContentResponse; the stream just ends
+    const auto extract = [](const SseEvent& event, std::string& text, std::string& error) {
+        try {
+            const json chunk = json::parse(event.data);
+            if (chunk.contains("error")) {
+                error = StringAt(chunk, "/error/message");
+                return StreamStep::FAILED;
+            }
+            text = StringAt(chunk, "/candidates/0/content/parts/0/text");
+        } catch (const json::exception& e) {
+            error = "malformed stream event: " + std::string(e.what());
+            return StreamStep::FAILED;
+        }
+        return StreamStep::CONTINUE;
+    };
+    const std::string path = "/v1beta/models/gemini-1.5-pro-latest:streamGenerateContent?alt=sse&key=" + api_key_;
+    return StreamJson(path, {}, FormatRequest(request), extract, request, on_chunk);
 }
 
 std::string GeminiProvider::FormatRequest(const LLMRequest& r) {
     json payload = {
-        {"contents", {{{"parts", {{{"text", r.prompt}}}}}}}
+        {"contents", {{{"parts", {{{"text", UserMessage(r)}}}}}}},
+        {"generationConfig", {{"maxOutputTokens", r.max_tokens > 0 ? r.max_tokens : 4096}}}
     };
+    if (r.system_prompt) {
+        payload["systemInstruction"] = {{"parts", {{{"text", *r.system_prompt}}}}};
+    }
     return payload.dump();
 }
 
@@ -2,13 +2,27 @@
 
 #include "mcp/ai_provider_interface.hpp"
 #include "mcp/interfaces.hpp"
+#include "mcp/executor.hpp"
 #include "mcp/types.hpp"
+#include "http_client_pool.hpp"
+#include "rate_limiter.hpp"
+#include "request_scheduler.hpp"
+#include "sse_parser.hpp"
+#include <atomic>
+#include <functional>
+#include <map>
 #include <memory>
 #include <unordered_map>
 #include <string>
 
 namespace mcp {
 
+struct HttpReply {
+    int status = 0;
+    std::string body;
+    std::map<std::string, std::string> headers;  // Names in lower case
+};
+
 // Base provider with common functionality
 class BaseAIProvider : public IAIProvider, public std::enable_shared_from_this<BaseAIProvider> {
 protected:
@@ -16,6 +30,11 @@ protected:
     std::string host_;
     std::string api_key_;
     std::shared_ptr<ILogger> logger_;
+    std::shared_ptr<HttpClientPool> http_pool_;
+    std::weak_ptr<LLMRequestScheduler> scheduler_;  // Owned by the engine
+    std::weak_ptr<ITaskExecutor> executor_;         // Owned by the core engine
+    std::atomic<int> max_retries_{3};
+    ProviderRateLimiter rate_limiter_;
 
 public:
     BaseAIProvider(std::string name, std::string host, std::shared_ptr<ILogger> logger);
@@ -26,11 +45,64 @@ public:
     // Helper methods for derived classes
     virtual std::unordered_map<std::string, std::string> GetCommonHeaders();
 
+    // Timeouts, retries and pool limits for this provider's host
+    void Configure(const APIConfig& config);
+    // Providers given the same pool share one set of connections per host; set before use
+    void SetHttpClientPool(std::shared_ptr<HttpClientPool> pool);
+    std::shared_ptr<HttpClientPool> GetHttpClientPool() const { return http_pool_; }
+    // Requests run on the scheduler's workers; without one on the shared
+    // executor, and without that each gets its own thread
+    void SetRequestScheduler(std::weak_ptr<LLMRequestScheduler> scheduler);
+    void SetTaskExecutor(std::weak_ptr<ITaskExecutor> executor);
+    ProviderRateLimiter& GetRateLimiter() { return rate_limiter_; }
+
+    Result<LLMResponse> SendRequestSync(const LLMRequest& request) override { return SendRequestImpl(request); }
+
 protected:
+    virtual Result<LLMResponse> SendRequestImpl(const LLMRequest& request) = 0;
+
+    /**
+     * @brief POST over a pooled keep-alive connection, paced by the rate limiter
+     *
+     * A transport failure discards the connection and retries on a fresh
+     * one; 429, 408 and 5xx are retried after a jittered backoff that honours
+     * Retry-After. Both count against max_retries. Other statuses are
+     * returned as is, as is the last retryable one.
+     */
+    Result<HttpReply> PostJson(const std::string& path, const std::map<std::string, std::string>& headers,
+                               const std::string& payload, const LLMRequest& request);
+
+    enum class StreamStep { CONTINUE, DONE, FAILED };
+    // Pulls the text out of one event; an in-stream error sets error and returns FAILED
+    using DeltaExtractor = std::function<StreamStep(const SseEvent& event, std::string& text, std::string& error)>;
+
+    /**
+     * @brief POST that reads a server-sent event stream off a pooled connection
+     *
+     * Text extracted from each event goes to on_chunk and is accumulated in
+     * the returned response. Failures before any text arrived are retried
+     * like PostJson; once text has been delivered they are errors.
+     */
+    Result<LLMResponse> StreamJson(const std::string& path, const std::map<std::string, std::string>& headers,
+                                   const std::string& payload, const DeltaExtractor& extract,
+                                   const LLMRequest& request, const LLMStreamCallback& on_chunk);
+
+    // Prompt plus the largest answer, for the tokens-per-minute budget
+    static double EstimateTokens(const LLMRequest& request);
+    // The prompt followed by the packed context items
+    static std::string UserMessage(const LLMRequest& request);
+
     // Safe async execution that prevents use-after-free
     template<typename Func>
-    std::future<Result<LLMResponse>> ExecuteAsync(Func&& func) {
+    std::future<Result<LLMResponse>> ExecuteAsync(const LLMRequest& request, Func&& func) {
         auto self = shared_from_this();
+        if (auto scheduler = scheduler_.lock()) {
+            return scheduler->Submit(name_, request.priority, request.cancellation,
+                                     [self, func = std::forward<Func>(func)]() { return func(); });
+        }
+        if (auto executor = executor_.lock()) {
+            return Submit(*executor, [self, func = std::forward<Func>(func)]() { return func(); });
+        }
         return std::async(std::launch::async, [self, func = std::forward<Func>(func)]() {
             return func();
         });
@@ -42,10 +114,11 @@ class OpenAIProvider : public BaseAIProvider {
 public:
     explicit OpenAIProvider(std::shared_ptr<ILogger> logger);
     std::future<Result<LLMResponse>> SendRequest(const LLMRequest& request) override;
+    Result<LLMResponse> SendRequestStreaming(const LLMRequest& request, const LLMStreamCallback& on_chunk) override;
 private:
-    std::string FormatRequest(const LLMRequest& request);
+    std::string FormatRequest(const LLMRequest& request, bool stream = false);
     Result<LLMResponse> ParseResponse(const std::string& response_body, int status_code);
-    Result<LLMResponse> SendRequestImpl(const LLMRequest& request);
+    Result<LLMResponse> SendRequestImpl(const LLMRequest& request) override;
 };
 
 // Claude Provider
@@ -53,11 +126,12 @@ class ClaudeProvider : public BaseAIProvider {
 public:
     explicit ClaudeProvider(std::shared_ptr<ILogger> logger);
     std::future<Result<LLMResponse>> SendRequest(const LLMRequest& request) override;
+    Result<LLMResponse> SendRequestStreaming(const LLMRequest& request, const LLMStreamCallback& on_chunk) override;
     std::unordered_map<std::string, std::string> GetCommonHeaders() override;
 private:
-    std::string FormatRequest(const LLMRequest& request);
+    std::string FormatRequest(const LLMRequest& request, bool stream = false);
     Result<LLMResponse> ParseResponse(const std::string& response_body, int status_code);
-    Result<LLMResponse> SendRequestImpl(const LLMRequest& request);
+    Result<LLMResponse> SendRequestImpl(const LLMRequest& request) override;
 };
 
 // Gemini Provider
@@ -65,10 +139,11 @@ class GeminiProvider : public BaseAIProvider {
 public:
     explicit GeminiProvider(std::shared_ptr<ILogger> logger);
     std::future<Result<LLMResponse>> SendRequest(const LLMRequest& request) override;
+    Result<LLMResponse> SendRequestStreaming(const LLMRequest& request, const LLMStreamCallback& on_chunk) override;
 private:
     std::string FormatRequest(const LLMRequest& request);
     Result<LLMResponse> ParseResponse(const std::string& response_body, int status_code);
-    Result<LLMResponse> SendRequestImpl(const LLMRequest& request);
+    Result<LLMResponse> SendRequestImpl(const LLMRequest& request) override;
 };
 
 } // namespace mcp 
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "http_client_pool.hpp"
+#include <httplib.h>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace mcp {
+
+namespace {
+
+void SplitTimeout(std::chrono::milliseconds timeout, time_t& seconds, time_t& microseconds) {
+    const auto count = std::max<int64_t>(timeout.count(), 0);
+    seconds = static_cast<time_t>(count / 1000);
+    microseconds = static_cast<time_t>((count % 1000) * 1000);
+}
+
+} // anonymous namespace
+
+HttpClientPool::Lease::Lease() = default;
+
+HttpClientPool::Lease::Lease(HttpClientPool* pool, std::string host, std::unique_ptr<httplib::Client> client)
+    : pool_(pool), host_(std::move(host)), client_(std::move(client)) {
+}
+
+HttpClientPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_), host_(std::move(other.host_)), client_(std::move(other.client_)) {
+    other.pool_ = nullptr;
+}
+
+HttpClientPool::Lease& HttpClientPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        Release();
+        pool_ = other.pool_;
+        host_ = std::move(other.host_);
+        client_ = std::move(other.client_);
+        other.pool_ = nullptr;
+    }
+    return *this;
+}
+
+HttpClientPool::Lease::~Lease() {
+    Release();
+}
+
+void HttpClientPool::Lease::Discard() {
+    if (pool_ && client_) {
+        pool_->Return(host_, std::move(client_), false);
+    }
+    pool_ = nullptr;
+}
+
+void HttpClientPool::Lease::Release() {
+    if (pool_ && client_) {
+        pool_->Return(host_, std::move(client_), true);
+    }
+    pool_ = nullptr;
+}
+
+HttpClientPool::HttpClientPool(HttpPoolOptions options, ClientFactory factory)
+    : defaults_(options), factory_(std::move(factory)) {
+}
+
+HttpClientPool::~HttpClientPool() {
+    CloseIdle();
+}
+
+void HttpClientPool::SetHostOptions(const std::string& host, const HttpPoolOptions& options) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    HostState& state = hosts_[host];
+    state.options = options;
+    state.has_options = true;
+    // A larger limit may unblock waiters
+    released_.notify_all();
+}
+
+HttpPoolOptions HttpClientPool::GetHostOptions(const std::string& host) const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    auto it = hosts_.find(host);
+    return it == hosts_.end() ? defaults_ : OptionsFor(it->second);
+}
+
+Result<HttpClientPool::Lease> HttpClientPool::Acquire(const std::string& host) {
+    std::vector<IdleClient> expired;
+    std::unique_lock<std::mutex> lock(mutex_);
+    HostState& state = hosts_[host];
+
+    const auto deadline = std::chrono::steady_clock::now() + OptionsFor(state).acquire_timeout;
+    for (;;) {
+        const auto now = std::chrono::steady_clock::now();
+        ExpireIdle(state, now, expired);
+        if (!state.idle.empty()) {
+            auto client = std::move(state.idle.back().client);
+            state.idle.pop_back();
+            ++state.leased;
+            ++stats_.reused;
+            return Result<Lease>::Success(Lease(this, host, std::move(client)));
+        }
+
+        const HttpPoolOptions options = OptionsFor(state);
+        if (state.leased < std::max<size_t>(options.max_connections, 1)) {
+            ++state.leased;  // Reserve the slot while the client is built
+            ++stats_.created;
+            lock.unlock();
+            auto client = CreateClient(host, options);
+            if (!client) {
+                lock.lock();
+                --state.leased;
+                --stats_.created;
+                released_.notify_all();
+                return Result<Lease>::Error("Failed to create HTTP client for " + host);
+            }
+            return Result<Lease>::Success(Lease(this, host, std::move(client)));
+        }
+
+        if (released_.wait_until(lock, deadline) == std::cv_status::timeout && state.idle.empty() &&
+            state.leased >= std::max<size_t>(OptionsFor(state).max_connections, 1)) {
+            return Result<Lease>::Error("HTTP connection pool exhausted for " + host);
+        }
+    }
+}
+
+void HttpClientPool::CloseIdle() {
+    std::vector<IdleClient> closed;
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& entry : hosts_) {
+            for (auto& idle : entry.second.idle) {
+                closed.push_back(std::move(idle));
+            }
+            entry.second.idle.clear();
+        }
+    }
+    // Sockets close outside the lock
+}
+
+HttpClientPool::Stats HttpClientPool::GetStats() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.idle = 0;
+    stats.leased = 0;
+    for (const auto& entry : hosts_) {
+        stats.idle += entry.second.idle.size();
+        stats.leased += entry.second.leased;
+    }
+    return stats;
+}
+
+const HttpPoolOptions& HttpClientPool::OptionsFor(const HostState& state) const {
+    return state.has_options ? state.options : defaults_;
+}
+
+void HttpClientPool::ExpireIdle(HostState& state, std::chrono::steady_clock::time_point now,
+                                std::vector<IdleClient>& closed) {
+    const auto timeout = OptionsFor(state).idle_timeout;
+    // Oldest first, so the expired clients are a prefix
+    auto keep = std::find_if(state.idle.begin(), state.idle.end(),
+                             [&](const IdleClient& idle) { return now - idle.since < timeout; });
+    stats_.expired += static_cast<uint64_t>(keep - state.idle.begin());
+    std::move(state.idle.begin(), keep, std::back_inserter(closed));
+    state.idle.erase(state.idle.begin(), keep);
+}
+
+std::unique_ptr<httplib::Client> HttpClientPool::CreateClient(const std::string& host, const HttpPoolOptions& options) {
+    std::unique_ptr<httplib::Client> client = factory_ ? factory_(host) : std::make_unique<httplib::Client>(host);
+    if (!client) {
+        return nullptr;
+    }
+
+    time_t seconds = 0;
+    time_t microseconds = 0;
+    client->set_keep_alive(true);
+    SplitTimeout(options.connect_timeout, seconds, microseconds);
+    client->set_connection_timeout(seconds, microseconds);
+    SplitTimeout(options.io_timeout, seconds, microseconds);
+    client->set_read_timeout(seconds, microseconds);
+    client->set_write_timeout(seconds, microseconds);
+    return client;
+}
+
+void HttpClientPool::Return(const std::string& host, std::unique_ptr<httplib::Client> client, bool reusable) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    HostState& state = hosts_[host];
+    --state.leased;
+    if (reusable) {
+        state.idle.push_back(IdleClient{std::move(client), std::chrono::steady_clock::now()});
+    } else {
+        ++stats_.discarded;
+    }
+    lock.unlock();
+    // Waiters for every host share the condition
+    released_.notify_all();
+    // A discarded client closes its socket here, outside the lock
+}
+
+} // namespace mcp
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "mcp/interfaces.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace httplib {
+class Client;
+}
+
+namespace mcp {
+
+struct HttpPoolOptions {
+    size_t max_connections = 4;                      // Per host, leased and idle together
+    std::chrono::milliseconds idle_timeout{60000};   // Idle clients older than this are closed
+    std::chrono::milliseconds connect_timeout{10000};
+    std::chrono::milliseconds io_timeout{30000};     // Read and write
+    std::chrono::milliseconds acquire_timeout{30000};  // Wait for a free slot when the host is full
+};
+
+/**
+ * @brief Per-host pool of keep-alive HTTP clients shared across threads
+ *
+ * A client serves one request at a time, so a lease hands it out
+ * exclusively and returns it on destruction. Reusing a client reuses its
+ * TCP (and TLS) connection; a caller whose request failed at the transport
+ * level discards the lease so the next one starts with a fresh connection.
+ * The pool must outlive its leases.
+ */
+class HttpClientPool {
+public:
+    struct Stats {
+        uint64_t created = 0;
+        uint64_t reused = 0;
+        uint64_t discarded = 0;
+        uint64_t expired = 0;   // Closed after idling past the timeout
+        size_t idle = 0;
+        size_t leased = 0;
+    };
+
+    class Lease {
+    public:
+        Lease();
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease();
+
+        httplib::Client& operator*() const { return *client_; }
+        httplib::Client* operator->() const { return client_.get(); }
+        explicit operator bool() const { return client_ != nullptr; }
+
+        // Drop the client instead of returning it, e.g. after a broken connection
+        void Discard();
+
+    private:
+        friend class HttpClientPool;
+        Lease(HttpClientPool* pool, std::string host, std::unique_ptr<httplib::Client> client);
+        void Release();
+
+        HttpClientPool* pool_ = nullptr;
+        std::string host_;
+        std::unique_ptr<httplib::Client> client_;
+    };
+
+    using ClientFactory = std::function<std::unique_ptr<httplib::Client>(const std::string& host)>;
+
+    explicit HttpClientPool(HttpPoolOptions options = {}, ClientFactory factory = nullptr);
+    ~HttpClientPool();
+    HttpClientPool(const HttpClientPool&) = delete;
+    HttpClientPool& operator=(const HttpClientPool&) = delete;
+
+    // Overrides the pool defaults for one host; applies to clients created afterwards
+    void SetHostOptions(const std::string& host, const HttpPoolOptions& options);
+    HttpPoolOptions GetHostOptions(const std::string& host) const;
+
+    Result<Lease> Acquire(const std::string& host);
+
+    // Close every idle client, e.g. before the process goes quiet for a while
+    void CloseIdle();
+    Stats GetStats() const;
+
+private:
+    struct IdleClient {
+        std::unique_ptr<httplib::Client> client;
+        std::chrono::steady_clock::time_point since;
+    };
+
+    struct HostState {
+        std::vector<IdleClient> idle;  // Most recently returned last
+        size_t leased = 0;
+        bool has_options = false;
+        HttpPoolOptions options;
+    };
+
+    HttpPoolOptions defaults_;
+    ClientFactory factory_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable released_;
+    std::unordered_map<std::string, HostState> hosts_;
+    Stats stats_;
+
+    const HttpPoolOptions& OptionsFor(const HostState& state) const;
+    void ExpireIdle(HostState& state, std::chrono::steady_clock::time_point now, std::vector<IdleClient>& closed);
+    std::unique_ptr<httplib::Client> CreateClient(const std::string& host, const HttpPoolOptions& options);
+    void Return(const std::string& host, std::unique_ptr<httplib::Client> client, bool reusable);
+};
+
+} // namespace mcp
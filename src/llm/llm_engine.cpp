@@ -1,17 +1,56 @@
 #include "llm_engine.hpp"
 #include "ai_providers.hpp"
+#include "http_client_pool.hpp"
+#include "rate_limiter.hpp"
+#include "request_scheduler.hpp"
+#include "response_cache.hpp"
 #include "mcp/types.hpp"
 #include <memory>
 #include <utility>
 #include <future>
 #include <string>
 #include <vector>
+#include <atomic>
+#include <functional>
 #include <mutex>
 
 namespace mcp {
 
+namespace {
+
+// Moves down the chain while the failure is one the next provider may not share
+Result<LLMResponse> RunWithFailover(const std::vector<std::shared_ptr<IAIProvider>>& chain,
+                                    const std::shared_ptr<ILogger>& logger,
+                                    const std::function<Result<LLMResponse>(IAIProvider&)>& send,
+                                    const std::function<bool()>& may_fail_over) {
+    Result<LLMResponse> result = Result<LLMResponse>::Error("No provider available");
+    for (size_t i = 0; i < chain.size(); ++i) {
+        result = send(*chain[i]);
+        if (result.IsSuccess() || i + 1 == chain.size() || !IsTransientLLMError(result.Error()) || !may_fail_over()) {
+            break;
+        }
+        if (logger) {
+            logger->LogFormatted(ILogger::LOG_WARN, "%s failed (%s), failing over to %s",
+                                 chain[i]->GetName().c_str(), result.Error().c_str(),
+                                 chain[i + 1]->GetName().c_str());
+        }
+    }
+    return result;
+}
+
+Future<Result<LLMResponse>> Ready(Result<LLMResponse> result) {
+    Promise<Result<LLMResponse>> promise;
+    promise.set_value(std::move(result));
+    return promise.get_future();
+}
+
+} // anonymous namespace
+
 LLMEngine::LLMEngine(std::shared_ptr<ILogger> logger) 
-    : logger_(std::move(logger)) {
+    : logger_(std::move(logger)),
+      http_pool_(std::make_shared<HttpClientPool>()),
+      scheduler_(std::make_shared<LLMRequestScheduler>()),
+      response_cache_(std::make_shared<LLMResponseCache>(ResponseCacheOptions{}, nullptr, logger_)) {
     InitializeDefaultProviders();
 }
 
@@ -27,6 +66,11 @@ void LLMEngine::InitializeDefaultProviders() {
 }
 
 std::future<Result<LLMResponse>> LLMEngine::SendRequest(const LLMRequest& request) {
+    return AnalyzeAsync(request);
+}
+
+Future<Result<LLMResponse>> LLMEngine::AnalyzeAsync(const LLMRequest& original) {
+    const LLMRequest request = FitToBudget(original);
     std::string provider_name = request.provider.empty() ? default_provider_ : request.provider;
     
     auto provider_result = GetProvider(provider_name);
@@ -35,13 +79,90 @@ std::future<Result<LLMResponse>> LLMEngine::SendRequest(const LLMRequest& reques
             logger_->Log(ILogger::LOG_WARN, "Provider not found: " + provider_name);
         }
         
-        std::promise<Result<LLMResponse>> promise;
-        promise.set_value(Result<LLMResponse>::Error(provider_result.Error()));
-        return promise.get_future();
+        return Ready(Result<LLMResponse>::Error(provider_result.Error()));
     }
     
     auto provider = provider_result.Value();
-    return provider->SendRequest(request);
+    auto chain = ProviderChain(provider);
+    LLMRequestScheduler::Task task = [chain, request, logger = logger_]() {
+        return RunWithFailover(chain, logger,
+                               [&request](IAIProvider& next) { return next.SendRequestSync(request); },
+                               [&request]() { return !request.cancellation.IsCancelled(); });
+    };
+    auto cache = GetResponseCache();
+    if (!cache) {
+        return scheduler_->Submit(provider_name, request.priority, request.cancellation, std::move(task));
+    }
+
+    const std::string key = LLMResponseCache::KeyFor(provider_name, request);
+    if (auto cached = cache->Get(key)) {
+        return Ready(Result<LLMResponse>::Success(std::move(*cached)));
+    }
+
+    Future<Result<LLMResponse>> shared;
+    if (cache->JoinInFlight(key, shared)) {
+        return shared;
+    }
+    // The completion runs on every outcome, so a rejected or cancelled leader still releases its waiters
+    return scheduler_->Submit(provider_name, request.priority, request.cancellation, std::move(task),
+                              [cache, key](const Result<LLMResponse>& result) { cache->CompleteInFlight(key, result); });
+}
+
+std::future<Result<LLMResponse>> LLMEngine::SendRequestStreaming(const LLMRequest& original,
+                                                                 LLMStreamCallback on_chunk) {
+    const LLMRequest request = FitToBudget(original);
+    std::string provider_name = request.provider.empty() ? default_provider_ : request.provider;
+
+    auto provider_result = GetProvider(provider_name);
+    if (provider_result.IsError()) {
+        if (logger_) {
+            logger_->Log(ILogger::LOG_WARN, "Provider not found: " + provider_name);
+        }
+
+        return Ready(Result<LLMResponse>::Error(provider_result.Error()));
+    }
+
+    auto provider = provider_result.Value();
+    auto cache = GetResponseCache();
+    std::string key;
+    if (cache) {
+        key = LLMResponseCache::KeyFor(provider_name, request);
+        if (auto cached = cache->Get(key)) {
+            if (on_chunk && !cached->content.empty()) {
+                on_chunk(cached->content);
+            }
+            return Ready(Result<LLMResponse>::Success(std::move(*cached)));
+        }
+    }
+
+    // A stream the caller stopped early is a partial answer and must not be cached
+    auto truncated = std::make_shared<std::atomic<bool>>(false);
+    auto delivered = std::make_shared<std::atomic<bool>>(false);
+    LLMStreamCallback forward = [on_chunk = std::move(on_chunk), truncated, delivered](const std::string& chunk) {
+        *delivered = true;
+        if (on_chunk && !on_chunk(chunk)) {
+            *truncated = true;
+            return false;
+        }
+        return true;
+    };
+    LLMRequestScheduler::Completion store;
+    if (cache) {
+        store = [cache, key, truncated](const Result<LLMResponse>& result) {
+            if (result.IsSuccess() && !*truncated) {
+                cache->Put(key, result.Value());
+            }
+        };
+    }
+    auto chain = ProviderChain(provider);
+    LLMRequestScheduler::Task task = [chain, request, forward, delivered, logger = logger_]() {
+        // Text already shown cannot be followed by another provider's answer
+        return RunWithFailover(chain, logger,
+                               [&request, &forward](IAIProvider& next) { return next.SendRequestStreaming(request, forward); },
+                               [&request, &delivered]() { return !*delivered && !request.cancellation.IsCancelled(); });
+    };
+    return scheduler_->Submit(provider_name, request.priority, request.cancellation, std::move(task),
+                              std::move(store));
 }
 
 Result<LLMResponse> LLMEngine::SendRequestSync(const LLMRequest& request) {
@@ -93,6 +214,14 @@ void LLMEngine::RegisterProvider(std::shared_ptr<IAIProvider> provider) {
     
     {
         const std::lock_guard<std::mutex> lock(providers_mutex_);
+        if (auto base = std::dynamic_pointer_cast<BaseAIProvider>(provider)) {
+            base->SetHttpClientPool(http_pool_);
+            base->SetRequestScheduler(scheduler_);
+            base->SetTaskExecutor(executor_);
+        }
+        if (providers_.find(name) == providers_.end()) {
+            provider_order_.push_back(name);
+        }
         providers_[name] = std::move(provider);
     }
     
@@ -112,6 +241,106 @@ void LLMEngine::SetDefaultProvider(const std::string& provider_name) {
     }
 }
 
+void LLMEngine::SetResponseCache(std::shared_ptr<LLMResponseCache> cache) {
+    const std::lock_guard<std::mutex> lock(providers_mutex_);
+    response_cache_ = std::move(cache);
+}
+
+std::shared_ptr<LLMResponseCache> LLMEngine::GetResponseCache() const {
+    const std::lock_guard<std::mutex> lock(providers_mutex_);
+    return response_cache_;
+}
+
+void LLMEngine::SetTaskExecutor(std::weak_ptr<ITaskExecutor> executor) {
+    const std::lock_guard<std::mutex> lock(providers_mutex_);
+    executor_ = std::move(executor);
+    for (const auto& entry : providers_) {
+        if (auto base = std::dynamic_pointer_cast<BaseAIProvider>(entry.second)) {
+            base->SetTaskExecutor(executor_);
+        }
+    }
+}
+
+void LLMEngine::SetMaxConcurrentRequests(size_t max_concurrent) {
+    scheduler_->SetMaxConcurrentPerProvider(max_concurrent);
+}
+
+void LLMEngine::CancelAllRequests() {
+    scheduler_->CancelAll();
+    if (logger_) {
+        logger_->Log(ILogger::LOG_INFO, "Cancelled all pending LLM requests");
+    }
+}
+
+size_t LLMEngine::GetActiveRequestCount() const {
+    const auto stats = scheduler_->GetStats();
+    return stats.queued + stats.running;
+}
+
+void LLMEngine::ConfigureProviders(const std::unordered_map<std::string, APIConfig>& configs) {
+    for (const auto& [name, config] : configs) {
+        auto provider_result = GetProvider(name);
+        if (provider_result.IsError()) {
+            continue;
+        }
+        if (auto base = std::dynamic_pointer_cast<BaseAIProvider>(provider_result.Value())) {
+            base->Configure(config);
+        }
+    }
+}
+
+void LLMEngine::SetPromptBudget(const PromptBudget& budget) {
+    const std::lock_guard<std::mutex> lock(providers_mutex_);
+    prompt_budget_ = budget;
+}
+
+PromptBudget LLMEngine::GetPromptBudget() const {
+    const std::lock_guard<std::mutex> lock(providers_mutex_);
+    return prompt_budget_;
+}
+
+LLMRequest LLMEngine::FitToBudget(const LLMRequest& request) const {
+    const PromptBudget budget = GetPromptBudget();
+    LLMRequest fitted = request;
+    if (fitted.max_tokens <= 0) {
+        fitted.max_tokens = budget.response_tokens;
+    }
+    if (budget.context_tokens == 0 || request.context.empty()) {
+        return fitted;
+    }
+
+    PromptBuilder builder(budget);
+    builder.SetPrompt(request.prompt);
+    for (const auto& item : request.context) {
+        builder.Add({ContextItem::Kind::TEXT, item, 1.0});
+    }
+    fitted.context = builder.Build().context;
+
+    const auto& report = builder.GetReport();
+    if (logger_ && (report.dropped > 0 || report.duplicates > 0 || report.truncated)) {
+        logger_->LogFormatted(ILogger::LOG_DEBUG,
+                              "Packed LLM context: %zu of %zu items, %zu duplicates, %zu dropped%s, ~%zu tokens",
+                              report.packed, report.offered, report.duplicates, report.dropped,
+                              report.truncated ? ", one truncated" : "", report.context_tokens);
+    }
+    return fitted;
+}
+
+std::vector<std::shared_ptr<IAIProvider>> LLMEngine::ProviderChain(const std::shared_ptr<IAIProvider>& primary) const {
+    std::vector<std::shared_ptr<IAIProvider>> chain{primary};
+    if (!failover_) {
+        return chain;
+    }
+    const std::lock_guard<std::mutex> lock(providers_mutex_);
+    for (const auto& name : provider_order_) {
+        auto it = providers_.find(name);
+        if (it != providers_.end() && it->second != primary) {
+            chain.push_back(it->second);
+        }
+    }
+    return chain;
+}
+
 Result<std::shared_ptr<IAIProvider>> LLMEngine::GetProvider(const std::string& provider_name) {
     const std::lock_guard<std::mutex> lock(providers_mutex_);
     
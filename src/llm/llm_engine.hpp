@@ -1,9 +1,13 @@
 #pragma once
 
+#include "mcp/executor.hpp"
 #include "mcp/interfaces.hpp"
 #include "mcp/ai_provider_interface.hpp"
 #include "mcp/types.hpp"
+#include "prompt_builder.hpp"
+#include <atomic>
 #include <unordered_map>
+#include <vector>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -16,6 +20,9 @@ class ISecurityManager;
 class ILogger;
 class HTTPClient;
 class IAIProvider;
+class HttpClientPool;
+class LLMRequestScheduler;
+class LLMResponseCache;
 
 class LLMEngine : public ILLMEngine {
 public:
@@ -25,28 +32,62 @@ public:
     // ILLMEngine implementation
     std::future<Result<LLMResponse>> SendRequest(const LLMRequest& request) override;
     Result<LLMResponse> SendRequestSync(const LLMRequest& request) override;
+    // Cache hits replay as one chunk; streams are never shared with identical requests
+    std::future<Result<LLMResponse>> SendRequestStreaming(const LLMRequest& request,
+                                                          LLMStreamCallback on_chunk) override;
     Result<void> SetAPIKey(const std::string& provider, const std::string& key) override;
     std::vector<std::string> GetSupportedProviders() const override;
     Result<void> ValidateConnection(const std::string& provider) override;
 
+    // SendRequest whose Future completes Then() continuations as the answer arrives, without polling
+    Future<Result<LLMResponse>> AnalyzeAsync(const LLMRequest& request);
+
     // Provider management
     void RegisterProvider(std::shared_ptr<IAIProvider> provider);
     void SetDefaultProvider(const std::string& provider_name);
+    // Applies per-provider timeouts, retries and connection pool limits, keyed by provider name
+    void ConfigureProviders(const std::unordered_map<std::string, APIConfig>& configs);
+    std::shared_ptr<HttpClientPool> GetHttpClientPool() const { return http_pool_; }
+    // When on, a quota, overload or transport failure moves on to the next
+    // registered provider; a stream only fails over before its first chunk
+    void SetFailover(bool enabled) { failover_ = enabled; }
+    bool IsFailoverEnabled() const { return failover_; }
+
+    // Every request's context is packed to this budget before it is cached or sent
+    void SetPromptBudget(const PromptBudget& budget);
+    PromptBudget GetPromptBudget() const;
+
+    // nullptr turns caching off; identical requests then always go upstream
+    void SetResponseCache(std::shared_ptr<LLMResponseCache> cache);
+    std::shared_ptr<LLMResponseCache> GetResponseCache() const;
+
+    // Handed to every provider, present and future, for work off the scheduler
+    void SetTaskExecutor(std::weak_ptr<ITaskExecutor> executor);
     
     // Request management
-    void SetMaxConcurrentRequests(size_t max_concurrent);
+    void SetMaxConcurrentRequests(size_t max_concurrent);  // Per provider
     void CancelAllRequests();
-    size_t GetActiveRequestCount() const;
+    size_t GetActiveRequestCount() const;                  // Queued and running
 
 private:
     std::shared_ptr<ILogger> logger_;
     
     mutable std::mutex providers_mutex_;
     std::unordered_map<std::string, std::shared_ptr<IAIProvider>> providers_;
+    std::vector<std::string> provider_order_;  // Registration order, for failover
+    std::atomic<bool> failover_{false};
     std::string default_provider_ = "claude";
+    std::shared_ptr<HttpClientPool> http_pool_;  // Shared by every registered provider
+    std::shared_ptr<LLMRequestScheduler> scheduler_;
+    std::shared_ptr<LLMResponseCache> response_cache_;  // Guarded by providers_mutex_
+    PromptBudget prompt_budget_;                         // Guarded by providers_mutex_
+    std::weak_ptr<ITaskExecutor> executor_;              // Guarded by providers_mutex_
     
     // Helper methods
     Result<std::shared_ptr<IAIProvider>> GetProvider(const std::string& provider_name);
+    // The requested provider, then the others when failover is on
+    std::vector<std::shared_ptr<IAIProvider>> ProviderChain(const std::shared_ptr<IAIProvider>& primary) const;
+    LLMRequest FitToBudget(const LLMRequest& request) const;
     void InitializeDefaultProviders();
 };
 
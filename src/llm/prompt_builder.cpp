@@ -0,0 +1,278 @@
+#include "prompt_builder.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace mcp {
+
+namespace {
+
+constexpr size_t kMinTruncatedTokens = 64;   // Smaller remnants are not worth sending
+constexpr size_t kMaxTermHits = 8;
+const char kTruncationMarker[] = "\n[... truncated]";
+
+bool IsWordChar(unsigned char c) {
+    return std::isalnum(c) || c == '_';
+}
+
+double KindWeight(ContextItem::Kind kind) {
+    switch (kind) {
+        case ContextItem::Kind::DISASSEMBLY: return 1.0;
+        case ContextItem::Kind::PATTERN:     return 0.9;
+        case ContextItem::Kind::TEXT:        return 0.8;
+        case ContextItem::Kind::STRINGS:     return 0.6;
+        case ContextItem::Kind::MEMORY:      return 0.4;
+    }
+    return 0.5;
+}
+
+// Lower-cased identifiers, mnemonics and hex literals of three characters or more
+template <typename Visitor>
+void ForEachTerm(std::string_view text, Visitor&& visit) {
+    std::string term;
+    for (size_t i = 0; i <= text.size(); ++i) {
+        const unsigned char c = i < text.size() ? static_cast<unsigned char>(text[i]) : ' ';
+        if (IsWordChar(c)) {
+            term.push_back(static_cast<char>(std::tolower(c)));
+            continue;
+        }
+        if (term.size() >= 3) {
+            visit(term);
+        }
+        term.clear();
+    }
+}
+
+// Collapses whitespace so re-indented or re-wrapped copies compare equal
+std::string Normalize(const std::string& text) {
+    std::string normalized;
+    normalized.reserve(text.size());
+    bool pending_space = false;
+    for (const char c : text) {
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            pending_space = !normalized.empty();
+            continue;
+        }
+        if (pending_space) {
+            normalized.push_back(' ');
+            pending_space = false;
+        }
+        normalized.push_back(c);
+    }
+    return normalized;
+}
+
+// Whole lines from the start of text that fit in max_tokens, with a marker
+std::string TruncateToTokens(const std::string& text, size_t max_tokens) {
+    const size_t marker_tokens = PromptBuilder::EstimateTokens(kTruncationMarker);
+    if (max_tokens <= marker_tokens) {
+        return std::string();
+    }
+    size_t used = marker_tokens;
+    size_t end = 0;
+    while (end < text.size()) {
+        size_t next = text.find('\n', end);
+        next = next == std::string::npos ? text.size() : next + 1;
+        const size_t line_tokens = PromptBuilder::EstimateTokens(std::string_view(text).substr(end, next - end));
+        if (used + line_tokens > max_tokens) {
+            break;
+        }
+        used += line_tokens;
+        end = next;
+    }
+    if (end == 0) {
+        return std::string();
+    }
+    std::string truncated = text.substr(0, end);
+    while (!truncated.empty() && truncated.back() == '\n') {
+        truncated.pop_back();
+    }
+    return truncated + kTruncationMarker;
+}
+
+std::string Hex(uintptr_t address) {
+    char text[2 + 16 + 1];
+    std::snprintf(text, sizeof(text), "0x%llx", static_cast<unsigned long long>(address));
+    return text;
+}
+
+} // anonymous namespace
+
+PromptBuilder::PromptBuilder(PromptBudget budget) : budget_(budget) {}
+
+size_t PromptBuilder::EstimateTokens(std::string_view text) {
+    size_t tokens = 0;
+    size_t i = 0;
+    const size_t n = text.size();
+    while (i < n) {
+        const unsigned char c = static_cast<unsigned char>(text[i]);
+        const size_t start = i;
+        if (std::isspace(c)) {
+            ++i;  // Folded into the following token
+        } else if (std::isalpha(c) || c == '_') {
+            while (i < n && (std::isalpha(static_cast<unsigned char>(text[i])) || text[i] == '_')) ++i;
+            tokens += (i - start + 3) / 4;
+        } else if (std::isdigit(c)) {
+            while (i < n && std::isdigit(static_cast<unsigned char>(text[i]))) ++i;
+            tokens += (i - start + 2) / 3;
+        } else if (c >= 0x80) {
+            while (i < n && static_cast<unsigned char>(text[i]) >= 0x80) ++i;
+            tokens += (i - start + 1) / 2;
+        } else {
+            ++i;
+            ++tokens;
+        }
+    }
+    return tokens;
+}
+
+PromptBuilder& PromptBuilder::SetPrompt(std::string prompt) {
+    prompt_ = std::move(prompt);
+    return *this;
+}
+
+PromptBuilder& PromptBuilder::SetSystemPrompt(std::string system_prompt) {
+    system_prompt_ = std::move(system_prompt);
+    return *this;
+}
+
+PromptBuilder& PromptBuilder::Add(ContextItem item) {
+    if (!item.text.empty()) {
+        items_.push_back(std::move(item));
+    }
+    return *this;
+}
+
+PromptBuilder& PromptBuilder::AddDisassembly(const std::string& listing) {
+    return Add({ContextItem::Kind::DISASSEMBLY, listing, 1.0});
+}
+
+PromptBuilder& PromptBuilder::AddPatterns(const std::vector<PatternMatch>& matches) {
+    for (const auto& match : matches) {
+        std::string text = "Pattern " + match.pattern_name + " at " + Hex(match.address) +
+                           " (" + std::to_string(match.size) + " bytes)";
+        if (!match.description.empty()) {
+            text += ": " + match.description;
+        }
+        Add({ContextItem::Kind::PATTERN, std::move(text), match.confidence});
+    }
+    return *this;
+}
+
+PromptBuilder& PromptBuilder::AddStrings(const std::vector<StringMatch>& strings) {
+    for (const auto& match : strings) {
+        Add({ContextItem::Kind::STRINGS, "String at " + Hex(match.address) + ": \"" + match.value + "\"", 1.0});
+    }
+    return *this;
+}
+
+PromptBuilder& PromptBuilder::AddAnalysis(const AnalysisResult& analysis) {
+    AddPatterns(analysis.patterns);
+    return AddStrings(analysis.strings);
+}
+
+LLMRequest PromptBuilder::Build(LLMRequest request) {
+    report_ = Report();
+    report_.offered = items_.size();
+    report_.prompt_tokens = EstimateTokens(prompt_) + (system_prompt_ ? EstimateTokens(*system_prompt_) : 0);
+
+    std::unordered_set<std::string> prompt_terms;
+    ForEachTerm(prompt_, [&prompt_terms](const std::string& term) { prompt_terms.insert(term); });
+
+    struct Candidate {
+        size_t index;
+        std::string normalized;
+        size_t tokens;
+        double score;
+    };
+    std::vector<Candidate> candidates;
+    candidates.reserve(items_.size());
+    std::unordered_map<std::string, size_t> by_text;
+    for (size_t i = 0; i < items_.size(); ++i) {
+        const ContextItem& item = items_[i];
+        std::unordered_set<std::string> hits;
+        ForEachTerm(item.text, [&](const std::string& term) {
+            if (hits.size() < kMaxTermHits && prompt_terms.count(term)) {
+                hits.insert(term);
+            }
+        });
+        const double score = KindWeight(item.kind) * std::max(item.weight, 0.05) * (1.0 + 0.5 * hits.size());
+
+        std::string normalized = Normalize(item.text);
+        auto seen = by_text.find(normalized);
+        if (seen != by_text.end()) {
+            // The copy keeps the better of the two scores
+            Candidate& first = candidates[seen->second];
+            first.score = std::max(first.score, score);
+            ++report_.duplicates;
+            continue;
+        }
+        by_text.emplace(normalized, candidates.size());
+        candidates.push_back({i, std::move(normalized), EstimateTokens(item.text), score});
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+
+    const bool unlimited = budget_.context_tokens == 0;
+    size_t remaining = budget_.context_tokens;
+    std::vector<std::pair<size_t, std::string>> packed;
+    std::vector<const std::string*> packed_text;
+    const Candidate* to_cut = nullptr;
+    for (const auto& candidate : candidates) {
+        const bool contained = std::any_of(packed_text.begin(), packed_text.end(),
+                                           [&candidate](const std::string* text) {
+                                               return text->find(candidate.normalized) != std::string::npos;
+                                           });
+        if (contained) {
+            ++report_.duplicates;
+            continue;
+        }
+
+        const std::string& text = items_[candidate.index].text;
+        if (unlimited || candidate.tokens <= remaining) {
+            packed.emplace_back(candidate.index, text);
+            packed_text.push_back(&candidate.normalized);
+            remaining -= unlimited ? 0 : candidate.tokens;
+            report_.context_tokens += candidate.tokens;
+            continue;
+        }
+        if (!to_cut) {
+            to_cut = &candidate;  // Cut once the smaller items have had their turn
+        } else {
+            ++report_.dropped;
+        }
+    }
+    if (to_cut) {
+        std::string cut = remaining >= kMinTruncatedTokens
+                              ? TruncateToTokens(items_[to_cut->index].text, remaining) : std::string();
+        if (cut.empty()) {
+            ++report_.dropped;
+        } else {
+            report_.context_tokens += EstimateTokens(cut);
+            report_.truncated = true;
+            packed.emplace_back(to_cut->index, std::move(cut));
+        }
+    }
+
+    std::sort(packed.begin(), packed.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    request.context.clear();
+    request.context.reserve(packed.size());
+    for (auto& entry : packed) {
+        request.context.push_back(std::move(entry.second));
+    }
+    report_.packed = request.context.size();
+
+    request.prompt = prompt_;
+    if (system_prompt_) {
+        request.system_prompt = system_prompt_;
+    }
+    request.max_tokens = budget_.response_tokens;
+    return request;
+}
+
+} // namespace mcp
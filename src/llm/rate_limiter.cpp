@@ -0,0 +1,279 @@
+#include "rate_limiter.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+namespace mcp {
+
+namespace {
+
+std::optional<double> NumberHeader(const std::map<std::string, std::string>& headers, const char* name) {
+    if (!name) {
+        return std::nullopt;
+    }
+    auto it = headers.find(name);
+    if (it == headers.end() || it->second.empty()) {
+        return std::nullopt;
+    }
+    char* end = nullptr;
+    const double value = std::strtod(it->second.c_str(), &end);
+    if (end == it->second.c_str()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+bool StartsWith(const std::string& text, const char* prefix) {
+    return text.rfind(prefix, 0) == 0;
+}
+
+} // anonymous namespace
+
+void ProviderRateLimiter::Bucket::Refill(Clock::time_point now, Clock::time_point last) {
+    if (capacity <= 0 || now <= last) {
+        return;
+    }
+    const double seconds = std::chrono::duration<double>(now - last).count();
+    available = std::min(capacity, available + seconds * per_second);
+}
+
+double ProviderRateLimiter::Bucket::WaitFor(double amount) const {
+    if (capacity <= 0 || per_second <= 0) {
+        return 0;
+    }
+    // A request larger than the whole bucket waits for a full one rather than forever
+    const double needed = std::min(amount, capacity);
+    return available >= needed ? 0 : (needed - available) / per_second;
+}
+
+ProviderRateLimiter::ProviderRateLimiter(RateLimitOptions options)
+    : last_refill_(Clock::now()) {
+    SetOptions(options);
+}
+
+void ProviderRateLimiter::SetOptions(const RateLimitOptions& options) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    options_ = options;
+    const auto configure = [](Bucket& bucket, double per_minute) {
+        if (per_minute > 0) {
+            // A new quota starts with a full bucket
+            if (bucket.learned || bucket.capacity != per_minute) {
+                bucket.available = per_minute;
+            }
+            bucket.capacity = per_minute;
+            bucket.per_second = per_minute / 60.0;
+            bucket.learned = false;
+        } else if (!bucket.learned) {
+            bucket = Bucket();
+        }
+    };
+    configure(requests_, options_.requests_per_minute);
+    configure(tokens_, options_.tokens_per_minute);
+    changed_.notify_all();
+}
+
+bool ProviderRateLimiter::Acquire(double estimated_tokens, const CancellationToken& cancellation) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const auto started = Clock::now();
+    bool delayed = false;
+    for (;;) {
+        if (cancellation.IsCancelled()) {
+            return false;
+        }
+
+        const auto now = Clock::now();
+        requests_.Refill(now, last_refill_);
+        tokens_.Refill(now, last_refill_);
+        last_refill_ = now;
+
+        Clock::duration wait{0};
+        if (paused_until_ > now) {
+            wait = paused_until_ - now;
+        } else {
+            const double seconds = std::max(requests_.WaitFor(1), tokens_.WaitFor(estimated_tokens));
+            if (seconds <= 0) {
+                if (requests_.capacity > 0) {
+                    requests_.available -= 1;
+                }
+                if (tokens_.capacity > 0) {
+                    tokens_.available -= std::min(estimated_tokens, tokens_.capacity);
+                }
+                ++stats_.acquired;
+                if (delayed) {
+                    ++stats_.delayed;
+                    stats_.waited += std::chrono::duration_cast<std::chrono::milliseconds>(now - started);
+                }
+                return true;
+            }
+            wait = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+        }
+
+        // Cancellation does not signal us, so long waits are sliced
+        delayed = true;
+        changed_.wait_for(lock, std::min<Clock::duration>(wait, kCancellationPoll));
+    }
+}
+
+void ProviderRateLimiter::Observe(int status, const std::map<std::string, std::string>& headers) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = Clock::now();
+    requests_.Refill(now, last_refill_);
+    tokens_.Refill(now, last_refill_);
+    last_refill_ = now;
+
+    // OpenAI, then Anthropic; both report per-minute limits
+    ApplyLimit(requests_, options_.requests_per_minute, headers, "x-ratelimit-limit-requests",
+               "x-ratelimit-remaining-requests", "x-ratelimit-reset-requests", now);
+    ApplyLimit(tokens_, options_.tokens_per_minute, headers, "x-ratelimit-limit-tokens",
+               "x-ratelimit-remaining-tokens", "x-ratelimit-reset-tokens", now);
+    ApplyLimit(requests_, options_.requests_per_minute, headers, "anthropic-ratelimit-requests-limit",
+               "anthropic-ratelimit-requests-remaining", nullptr, now);
+    ApplyLimit(tokens_, options_.tokens_per_minute, headers, "anthropic-ratelimit-tokens-limit",
+               "anthropic-ratelimit-tokens-remaining", nullptr, now);
+
+    if (status == 429) {
+        ++stats_.throttled;
+    }
+    if (status == 429 || status == 503) {
+        if (auto after = RetryAfter(headers)) {
+            paused_until_ = std::max(paused_until_, now + *after);
+        }
+    }
+    changed_.notify_all();
+}
+
+void ProviderRateLimiter::ApplyLimit(Bucket& bucket, double configured,
+                                     const std::map<std::string, std::string>& headers,
+                                     const char* limit_header, const char* remaining_header,
+                                     const char* reset_header, Clock::time_point now) {
+    const auto limit = NumberHeader(headers, limit_header);
+    if (configured <= 0 && limit && *limit > 0 && *limit != bucket.capacity) {
+        bucket.available = bucket.learned ? std::min(bucket.available, *limit) : *limit;
+        bucket.capacity = *limit;
+        bucket.per_second = *limit / 60.0;
+        bucket.learned = true;
+    }
+
+    const auto remaining = NumberHeader(headers, remaining_header);
+    if (!remaining || bucket.capacity <= 0) {
+        return;
+    }
+    bucket.available = std::min(bucket.available, std::max(*remaining, 0.0));
+    if (*remaining <= 0 && reset_header) {
+        auto reset = headers.find(reset_header);
+        if (reset != headers.end()) {
+            if (auto delay = ParseDuration(reset->second)) {
+                paused_until_ = std::max(paused_until_, now + *delay);
+            }
+        }
+    }
+}
+
+std::chrono::milliseconds ProviderRateLimiter::BackoffFor(int attempt,
+                                                          std::optional<std::chrono::milliseconds> retry_after) {
+    RateLimitOptions options;
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        options = options_;
+    }
+    const int doublings = std::clamp(attempt, 0, 20);
+    const auto ceiling = std::min<int64_t>(options.max_backoff.count(),
+                                           options.base_backoff.count() * (int64_t{1} << doublings));
+
+    // Half fixed, half random, so retries from a burst of failures spread out
+    thread_local std::mt19937_64 generator{std::random_device{}()};
+    std::uniform_int_distribution<int64_t> jitter(ceiling / 2, std::max<int64_t>(ceiling, 0));
+    const std::chrono::milliseconds delay(jitter(generator));
+    return retry_after ? std::max(delay, *retry_after) : delay;
+}
+
+void ProviderRateLimiter::RecordRetry() {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.retries;
+}
+
+ProviderRateLimiter::Stats ProviderRateLimiter::GetStats() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+bool ProviderRateLimiter::IsRetryableStatus(int status) {
+    return status == 408 || status == 429 || (status >= 500 && status <= 599);
+}
+
+std::optional<std::chrono::milliseconds> ProviderRateLimiter::RetryAfter(
+    const std::map<std::string, std::string>& headers) {
+    if (auto ms = NumberHeader(headers, "retry-after-ms")) {
+        return std::chrono::milliseconds(static_cast<int64_t>(std::max(*ms, 0.0)));
+    }
+    auto it = headers.find("retry-after");
+    if (it == headers.end()) {
+        return std::nullopt;
+    }
+    return ParseDuration(it->second);  // The HTTP-date form is not worth a date parser
+}
+
+std::optional<std::chrono::milliseconds> ProviderRateLimiter::ParseDuration(const std::string& text) {
+    const char* cursor = text.c_str();
+    double total_ms = 0;
+    bool any = false;
+    while (*cursor) {
+        char* end = nullptr;
+        const double value = std::strtod(cursor, &end);
+        if (end == cursor || value < 0) {
+            return std::nullopt;
+        }
+        cursor = end;
+
+        double scale = 1000.0;  // A bare number is seconds
+        if (StartsWith(cursor, "ms")) {
+            scale = 1.0;
+            cursor += 2;
+        } else if (*cursor == 's') {
+            ++cursor;
+        } else if (*cursor == 'm') {
+            scale = 60000.0;
+            ++cursor;
+        } else if (*cursor == 'h') {
+            scale = 3600000.0;
+            ++cursor;
+        } else if (*cursor != '\0') {
+            return std::nullopt;
+        }
+        total_ms += value * scale;
+        any = true;
+    }
+    if (!any) {
+        return std::nullopt;
+    }
+    return std::chrono::milliseconds(static_cast<int64_t>(std::ceil(total_ms)));
+}
+
+bool ProviderRateLimiter::SleepFor(std::chrono::milliseconds delay, const CancellationToken& cancellation) {
+    const auto deadline = Clock::now() + delay;
+    for (;;) {
+        if (cancellation.IsCancelled()) {
+            return false;
+        }
+        const auto now = Clock::now();
+        if (now >= deadline) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::min<Clock::duration>(deadline - now, kCancellationPoll));
+    }
+}
+
+bool IsTransientLLMError(const std::string& error) {
+    static const char kApiError[] = "API Error: ";
+    if (StartsWith(error, kApiError)) {
+        const int status = std::atoi(error.c_str() + sizeof(kApiError) - 1);
+        return ProviderRateLimiter::IsRetryableStatus(status);
+    }
+    return StartsWith(error, "HTTP request failed") || StartsWith(error, "HTTP connection pool exhausted") ||
+           StartsWith(error, "Stream interrupted");
+}
+
+} // namespace mcp
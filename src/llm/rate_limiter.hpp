@@ -0,0 +1,100 @@
+#pragma once
+
+#include "mcp/types.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace mcp {
+
+struct RateLimitOptions {
+    double requests_per_minute = 0;   // 0 until the provider reports a limit
+    double tokens_per_minute = 0;
+    std::chrono::milliseconds base_backoff{500};
+    std::chrono::milliseconds max_backoff{30000};
+};
+
+/**
+ * @brief Paces one provider's requests against its quota
+ *
+ * Two token buckets, requests and tokens per minute, both refilling
+ * continuously. Limits come from the configuration or are learned from the
+ * rate-limit headers OpenAI and Anthropic send with every response, and a
+ * Retry-After pauses every request to the provider, not just the one that
+ * was told to wait. Header names are expected in lower case.
+ */
+class ProviderRateLimiter {
+public:
+    struct Stats {
+        uint64_t acquired = 0;
+        uint64_t delayed = 0;      // Requests that had to wait for budget
+        uint64_t throttled = 0;    // 429 responses seen
+        uint64_t retries = 0;
+        std::chrono::milliseconds waited{0};
+    };
+
+    explicit ProviderRateLimiter(RateLimitOptions options = {});
+
+    void SetOptions(const RateLimitOptions& options);
+
+    /**
+     * @brief Wait until a request of about estimated_tokens fits the budget
+     * @return false if cancellation fired first; nothing is consumed then
+     */
+    bool Acquire(double estimated_tokens, const CancellationToken& cancellation);
+
+    // Learns limits and remaining budget from a response
+    void Observe(int status, const std::map<std::string, std::string>& headers);
+
+    // Jittered exponential delay before retry number attempt (0-based), at least retry_after
+    std::chrono::milliseconds BackoffFor(int attempt, std::optional<std::chrono::milliseconds> retry_after);
+    void RecordRetry();
+
+    Stats GetStats() const;
+
+    // 429, 408 and 5xx are worth retrying; other client errors are not
+    static bool IsRetryableStatus(int status);
+    // Retry-After in seconds or as a duration such as "1.5s" or "6m0s"
+    static std::optional<std::chrono::milliseconds> RetryAfter(const std::map<std::string, std::string>& headers);
+    static std::optional<std::chrono::milliseconds> ParseDuration(const std::string& text);
+    // Sleeps for delay in short slices; false if cancelled meanwhile
+    static bool SleepFor(std::chrono::milliseconds delay, const CancellationToken& cancellation);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Bucket {
+        double capacity = 0;       // 0 means unlimited
+        double available = 0;
+        double per_second = 0;
+        bool learned = false;      // Limit came from headers, not configuration
+
+        void Refill(Clock::time_point now, Clock::time_point last);
+        // Seconds until amount is available; 0 when it already is
+        double WaitFor(double amount) const;
+    };
+
+    static constexpr std::chrono::milliseconds kCancellationPoll{50};
+
+    RateLimitOptions options_;
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    Bucket requests_;
+    Bucket tokens_;
+    Clock::time_point last_refill_;
+    Clock::time_point paused_until_;
+    Stats stats_;
+
+    void ApplyLimit(Bucket& bucket, double configured, const std::map<std::string, std::string>& headers,
+                    const char* limit_header, const char* remaining_header, const char* reset_header,
+                    Clock::time_point now);
+};
+
+// Failures another provider, or a later attempt, might not hit: quota, overload, transport
+bool IsTransientLLMError(const std::string& error);
+
+} // namespace mcp
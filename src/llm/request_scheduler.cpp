@@ -0,0 +1,191 @@
+#include "request_scheduler.hpp"
+#include <algorithm>
+
+namespace mcp {
+
+LLMRequestScheduler::LLMRequestScheduler(RequestSchedulerOptions options)
+    : options_(options) {
+    options_.worker_threads = std::max<size_t>(options_.worker_threads, 1);
+    options_.max_concurrent_per_provider = std::max<size_t>(options_.max_concurrent_per_provider, 1);
+    workers_.reserve(options_.worker_threads);
+    for (size_t i = 0; i < options_.worker_threads; ++i) {
+        workers_.emplace_back(&LLMRequestScheduler::WorkerLoop, this);
+    }
+}
+
+LLMRequestScheduler::~LLMRequestScheduler() {
+    CancelAll();
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_available_.notify_all();
+    space_available_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+Future<Result<LLMResponse>> LLMRequestScheduler::Submit(const std::string& provider, int priority,
+                                                        CancellationToken cancellation, Task task,
+                                                        Completion on_complete) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const auto has_room = [this]() { return stopping_ || queue_.size() < options_.max_queued; };
+    if (!has_room() && options_.enqueue_timeout.count() > 0) {
+        space_available_.wait_for(lock, options_.enqueue_timeout, has_room);
+    }
+    if (stopping_) {
+        lock.unlock();
+        return Completed(Result<LLMResponse>::Error("LLM request scheduler is shutting down"), on_complete);
+    }
+    if (queue_.size() >= options_.max_queued) {
+        ++stats_.rejected;
+        lock.unlock();
+        return Completed(Result<LLMResponse>::Error("LLM request queue is full"), on_complete);
+    }
+
+    Pending pending;
+    pending.provider = provider;
+    pending.cancellation = std::move(cancellation);
+    pending.task = std::move(task);
+    pending.on_complete = std::move(on_complete);
+    auto future = pending.promise.get_future();
+    queue_.emplace(QueueKey{-priority, next_sequence_++}, std::move(pending));
+    ++stats_.submitted;
+    lock.unlock();
+
+    work_available_.notify_one();
+    return future;
+}
+
+void LLMRequestScheduler::SetMaxConcurrentPerProvider(size_t max_concurrent) {
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        options_.max_concurrent_per_provider = std::max<size_t>(max_concurrent, 1);
+    }
+    work_available_.notify_all();
+}
+
+void LLMRequestScheduler::CancelAll() {
+    std::map<QueueKey, Pending> cancelled;
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        cancelled.swap(queue_);
+        stats_.cancelled += cancelled.size();
+        for (const auto& token : running_tokens_) {
+            token.Cancel();
+        }
+    }
+    space_available_.notify_all();
+
+    for (auto& entry : cancelled) {
+        entry.second.cancellation.Cancel();
+        entry.second.Finish(Result<LLMResponse>::Error("Request cancelled"));
+    }
+}
+
+size_t LLMRequestScheduler::GetQueuedCount() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+size_t LLMRequestScheduler::GetRunningCount() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return running_tokens_.size();
+}
+
+LLMRequestScheduler::Stats LLMRequestScheduler::GetStats() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.queued = queue_.size();
+    stats.running = running_tokens_.size();
+    return stats;
+}
+
+void LLMRequestScheduler::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        auto next = FindRunnable();
+        while (!stopping_ && next == queue_.end()) {
+            // Tokens do not signal the queue, so blocked requests are rescanned for cancellation
+            if (queue_.empty()) {
+                work_available_.wait(lock);
+            } else {
+                work_available_.wait_for(lock, kCancellationPoll);
+            }
+            next = FindRunnable();
+        }
+        if (next == queue_.end()) {
+            return;  // Stopping with nothing runnable
+        }
+
+        Pending pending = std::move(next->second);
+        queue_.erase(next);
+        ++running_by_provider_[pending.provider];
+        running_tokens_.push_back(pending.cancellation);
+        lock.unlock();
+        space_available_.notify_one();
+
+        Result<LLMResponse> result;
+        bool cancelled = pending.cancellation.IsCancelled();
+        if (cancelled) {
+            result = Result<LLMResponse>::Error("Request cancelled");
+        } else {
+            try {
+                result = pending.task();
+            } catch (const std::exception& e) {
+                result = Result<LLMResponse>::Error(std::string("LLM request failed: ") + e.what());
+            }
+        }
+        // Captured state (often the provider itself) goes before the lock is retaken
+        pending.task = nullptr;
+        pending.Finish(std::move(result));
+        pending.on_complete = nullptr;
+
+        lock.lock();
+        --running_by_provider_[pending.provider];
+        auto token = std::find_if(running_tokens_.begin(), running_tokens_.end(),
+                                  [&pending](const CancellationToken& running) {
+                                      return running.SameAs(pending.cancellation);
+                                  });
+        if (token != running_tokens_.end()) {
+            running_tokens_.erase(token);
+        }
+        ++(cancelled ? stats_.cancelled : stats_.completed);
+        // A freed provider slot may make a queued request runnable
+        work_available_.notify_all();
+    }
+}
+
+std::map<LLMRequestScheduler::QueueKey, LLMRequestScheduler::Pending>::iterator LLMRequestScheduler::FindRunnable() {
+    for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+        // Cancelled requests only need their future completed, so they skip the cap
+        if (it->second.cancellation.IsCancelled()) {
+            return it;
+        }
+        auto running = running_by_provider_.find(it->second.provider);
+        if (running == running_by_provider_.end() || running->second < options_.max_concurrent_per_provider) {
+            return it;
+        }
+    }
+    return queue_.end();
+}
+
+void LLMRequestScheduler::Pending::Finish(Result<LLMResponse> result) {
+    if (on_complete) {
+        on_complete(result);
+    }
+    promise.set_value(std::move(result));
+}
+
+Future<Result<LLMResponse>> LLMRequestScheduler::Completed(Result<LLMResponse> result,
+                                                           const Completion& on_complete) {
+    if (on_complete) {
+        on_complete(result);
+    }
+    Promise<Result<LLMResponse>> promise;
+    promise.set_value(std::move(result));
+    return promise.get_future();
+}
+
+} // namespace mcp
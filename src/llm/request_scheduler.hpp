@@ -0,0 +1,105 @@
+#pragma once
+
+#include "mcp/executor.hpp"
+#include "mcp/interfaces.hpp"
+#include "mcp/types.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mcp {
+
+struct RequestSchedulerOptions {
+    size_t worker_threads = 8;
+    size_t max_queued = 256;                        // Submissions beyond this wait, then fail
+    size_t max_concurrent_per_provider = 4;
+    std::chrono::milliseconds enqueue_timeout{0};   // How long Submit waits for room; 0 fails at once
+};
+
+/**
+ * @brief Fixed worker pool running LLM requests by priority
+ *
+ * Requests wait in one queue ordered by priority, then arrival. A worker
+ * takes the first request whose provider is below its concurrency cap, so
+ * a slow provider cannot occupy every worker. A request cancelled while
+ * queued completes with an error without running; a running request sees
+ * its token cancelled and may stop early. The returned Future fires its
+ * Then() continuations from the worker that finished the request.
+ */
+class LLMRequestScheduler {
+public:
+    using Task = std::function<Result<LLMResponse>()>;
+    // Sees every outcome, including rejection and cancellation before the task ran
+    using Completion = std::function<void(const Result<LLMResponse>&)>;
+
+    struct Stats {
+        uint64_t submitted = 0;
+        uint64_t completed = 0;
+        uint64_t cancelled = 0;
+        uint64_t rejected = 0;   // Queue full
+        size_t queued = 0;
+        size_t running = 0;
+    };
+
+    explicit LLMRequestScheduler(RequestSchedulerOptions options = {});
+    ~LLMRequestScheduler();
+    LLMRequestScheduler(const LLMRequestScheduler&) = delete;
+    LLMRequestScheduler& operator=(const LLMRequestScheduler&) = delete;
+
+    Future<Result<LLMResponse>> Submit(const std::string& provider, int priority,
+                                       CancellationToken cancellation, Task task,
+                                       Completion on_complete = nullptr);
+
+    void SetMaxConcurrentPerProvider(size_t max_concurrent);
+    // Fails everything queued and cancels the tokens of running requests
+    void CancelAll();
+
+    size_t GetQueuedCount() const;
+    size_t GetRunningCount() const;
+    Stats GetStats() const;
+
+private:
+    struct Pending {
+        std::string provider;
+        CancellationToken cancellation;
+        Task task;
+        Completion on_complete;
+        Promise<Result<LLMResponse>> promise;
+
+        void Finish(Result<LLMResponse> result);
+    };
+
+    static constexpr std::chrono::milliseconds kCancellationPoll{50};
+
+    // Highest priority first, then first come first served
+    using QueueKey = std::pair<int, uint64_t>;  // (-priority, sequence)
+
+    RequestSchedulerOptions options_;
+    std::vector<std::thread> workers_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable space_available_;
+    std::map<QueueKey, Pending> queue_;
+    std::unordered_map<std::string, size_t> running_by_provider_;
+    std::vector<CancellationToken> running_tokens_;
+    uint64_t next_sequence_ = 0;
+    bool stopping_ = false;
+    Stats stats_;
+
+    void WorkerLoop();
+    std::map<QueueKey, Pending>::iterator FindRunnable();
+    static Future<Result<LLMResponse>> Completed(Result<LLMResponse> result, const Completion& on_complete);
+};
+
+} // namespace mcp
@@ -0,0 +1,405 @@
+#include "response_cache.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <system_error>
+#include <utility>
+
+namespace mcp {
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr int kDiskFormatVersion = 1;
+
+// Two independent 64-bit lanes over the canonical request bytes
+class KeyHasher {
+public:
+    void Add(const std::string& field) {
+        AddLength(field.size());
+        AddBytes(field.data(), field.size());
+    }
+
+    void Add(uint64_t value) {
+        AddBytes(&value, sizeof(value));
+    }
+
+    std::string Hex() const {
+        char text[33];
+        std::snprintf(text, sizeof(text), "%016llx%016llx",
+                      static_cast<unsigned long long>(Finish(fnv_)),
+                      static_cast<unsigned long long>(Finish(mix_)));
+        return text;
+    }
+
+private:
+    uint64_t fnv_ = 0xCBF29CE484222325ULL;
+    uint64_t mix_ = 0x9E3779B97F4A7C15ULL;
+
+    void AddLength(size_t length) {
+        Add(static_cast<uint64_t>(length));
+    }
+
+    void AddBytes(const void* data, size_t size) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            fnv_ = (fnv_ ^ bytes[i]) * 0x100000001B3ULL;
+            mix_ = (mix_ + bytes[i]) * 0xFF51AFD7ED558CCDULL;
+            mix_ ^= mix_ >> 29;
+        }
+    }
+
+    // splitmix64 finaliser, so nearby inputs spread over the whole key
+    static uint64_t Finish(uint64_t value) {
+        value ^= value >> 30;
+        value *= 0xBF58476D1CE4E5B9ULL;
+        value ^= value >> 27;
+        value *= 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+};
+
+int64_t ToEpochSeconds(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+} // anonymous namespace
+
+LLMResponseCache::LLMResponseCache(ResponseCacheOptions options,
+                                   std::shared_ptr<ISecurityManager> security,
+                                   std::shared_ptr<ILogger> logger)
+    : options_(std::move(options)), security_(std::move(security)), logger_(std::move(logger)) {
+    if (options_.disk_directory.empty()) {
+        return;
+    }
+    if (!security_) {
+        // Responses quote the target's code and strings; never write them in the clear
+        if (logger_) {
+            logger_->Log(ILogger::LOG_WARN, "LLM response disk cache disabled: no security manager");
+        }
+        return;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(options_.disk_directory, error);
+    disk_enabled_ = !error;
+    if (error && logger_) {
+        logger_->LogFormatted(ILogger::LOG_WARN, "LLM response disk cache disabled: %s: %s",
+                              options_.disk_directory.c_str(), error.message().c_str());
+    }
+    if (disk_enabled_) {
+        TrimDisk();
+    }
+}
+
+std::string LLMResponseCache::KeyFor(const std::string& provider, const LLMRequest& request) {
+    KeyHasher hasher;
+    hasher.Add(provider);
+    hasher.Add(request.model);
+    hasher.Add(static_cast<uint64_t>(request.system_prompt.has_value()));
+    hasher.Add(request.system_prompt.value_or(std::string()));
+    hasher.Add(request.prompt);
+    hasher.Add(static_cast<uint64_t>(request.context.size()));
+    for (const auto& item : request.context) {
+        hasher.Add(item);
+    }
+
+    uint64_t temperature_bits = 0;
+    static_assert(sizeof(temperature_bits) == sizeof(request.temperature), "temperature is a double");
+    std::memcpy(&temperature_bits, &request.temperature, sizeof(temperature_bits));
+    hasher.Add(temperature_bits);
+    hasher.Add(static_cast<uint64_t>(static_cast<int64_t>(request.max_tokens)));
+
+    // Sorted so insertion order in the hash map does not matter
+    const std::map<std::string, std::string> parameters(request.parameters.begin(), request.parameters.end());
+    hasher.Add(static_cast<uint64_t>(parameters.size()));
+    for (const auto& [name, value] : parameters) {
+        hasher.Add(name);
+        hasher.Add(value);
+    }
+    return hasher.Hex();
+}
+
+std::optional<LLMResponse> LLMResponseCache::Get(const std::string& key) {
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            if (!Expired(it->second->created)) {
+                lru_.splice(lru_.begin(), lru_, it->second);
+                ++stats_.memory_hits;
+                return it->second->response;
+            }
+            lru_.erase(it->second);
+            entries_.erase(it);
+        }
+    }
+
+    if (disk_enabled_) {
+        if (auto entry = ReadFromDisk(key)) {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            Remember(key, entry->response, entry->created);
+            ++stats_.disk_hits;
+            return entry->response;
+        }
+    }
+
+    const std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.misses;
+    return std::nullopt;
+}
+
+void LLMResponseCache::Put(const std::string& key, const LLMResponse& response) {
+    Entry entry{key, response, std::chrono::system_clock::now()};
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        Remember(key, response, entry.created);
+        ++stats_.stores;
+    }
+    if (disk_enabled_) {
+        WriteToDisk(entry);
+    }
+}
+
+bool LLMResponseCache::JoinInFlight(const std::string& key, Future<Result<LLMResponse>>& waiter) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    auto it = in_flight_.find(key);
+    if (it == in_flight_.end()) {
+        in_flight_.emplace(key, std::vector<Promise<Result<LLMResponse>>>());
+        return false;
+    }
+    it->second.emplace_back();
+    waiter = it->second.back().get_future();
+    ++stats_.deduplicated;
+    return true;
+}
+
+void LLMResponseCache::CompleteInFlight(const std::string& key, const Result<LLMResponse>& result) {
+    if (result.IsSuccess()) {
+        Put(key, result.Value());
+    }
+
+    std::vector<Promise<Result<LLMResponse>>> waiters;
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        auto it = in_flight_.find(key);
+        if (it == in_flight_.end()) {
+            return;
+        }
+        waiters = std::move(it->second);
+        in_flight_.erase(it);
+    }
+    for (auto& waiter : waiters) {
+        waiter.set_value(result);
+    }
+}
+
+void LLMResponseCache::Clear() {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    entries_.clear();
+}
+
+LLMResponseCache::Stats LLMResponseCache::GetStats() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.entries = entries_.size();
+    return stats;
+}
+
+bool LLMResponseCache::Expired(std::chrono::system_clock::time_point created) const {
+    return options_.ttl.count() > 0 && std::chrono::system_clock::now() - created > options_.ttl;
+}
+
+void LLMResponseCache::Remember(const std::string& key, const LLMResponse& response,
+                                std::chrono::system_clock::time_point created) {
+    if (options_.memory_entries == 0) {
+        return;
+    }
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        it->second->response = response;
+        it->second->created = created;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return;
+    }
+    lru_.push_front(Entry{key, response, created});
+    entries_[key] = lru_.begin();
+    while (entries_.size() > options_.memory_entries) {
+        entries_.erase(lru_.back().key);
+        lru_.pop_back();
+    }
+}
+
+std::string LLMResponseCache::PathFor(const std::string& key) const {
+    return (std::filesystem::path(options_.disk_directory) / (key + ".llmcache")).string();
+}
+
+std::optional<LLMResponseCache::Entry> LLMResponseCache::ReadFromDisk(const std::string& key) {
+    const std::string path = PathFor(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return std::nullopt;
+    }
+    const std::vector<uint8_t> encrypted((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+
+    // Written under another key, tampered with or truncated: it will never be readable, so it goes
+    std::vector<uint8_t> plain;
+    auto decrypt_result = security_->DecryptData(encrypted, plain);
+    if (!decrypt_result.IsSuccess()) {
+        RemoveFromDisk(path, decrypt_result.Error().c_str());
+        return std::nullopt;
+    }
+
+    try {
+        const json record = json::parse(plain.begin(), plain.end());
+        if (record.value("version", 0) != kDiskFormatVersion || record.value("key", "") != key) {
+            RemoveFromDisk(path, "stale record");
+            return std::nullopt;
+        }
+        Entry entry;
+        entry.key = key;
+        entry.created = std::chrono::system_clock::time_point(std::chrono::seconds(record.value("created", int64_t{0})));
+        if (Expired(entry.created)) {
+            RemoveFromDisk(path, "expired");
+            return std::nullopt;
+        }
+        entry.response.content = record.value("content", "");
+        entry.response.provider = record.value("provider", "");
+        entry.response.model = record.value("model", "");
+        entry.response.tokens_used = record.value("tokens_used", 0);
+        entry.response.success = true;
+        return entry;
+    } catch (const json::exception&) {
+        RemoveFromDisk(path, "malformed record");
+        return std::nullopt;
+    }
+}
+
+void LLMResponseCache::WriteToDisk(const Entry& entry) {
+    const json record = {
+        {"version", kDiskFormatVersion},
+        {"key", entry.key},
+        {"created", ToEpochSeconds(entry.created)},
+        {"content", entry.response.content},
+        {"provider", entry.response.provider},
+        {"model", entry.response.model},
+        {"tokens_used", entry.response.tokens_used}
+    };
+    const std::string text = record.dump();
+    std::vector<uint8_t> encrypted;
+    auto encrypt_result = security_->EncryptData(std::vector<uint8_t>(text.begin(), text.end()), encrypted);
+    if (!encrypt_result.IsSuccess()) {
+        if (logger_) {
+            logger_->LogFormatted(ILogger::LOG_WARN, "Not caching LLM response on disk: %s",
+                                  encrypt_result.Error().c_str());
+        }
+        return;
+    }
+
+    // Write then rename, so a concurrent reader never sees half a file
+    const std::string path = PathFor(entry.key);
+    static std::atomic<uint64_t> sequence{0};
+    const std::string temporary = path + ".tmp" +
+        std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "_" + std::to_string(++sequence);
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(encrypted.data()), static_cast<std::streamsize>(encrypted.size()));
+        if (!file) {
+            std::error_code ignored;
+            std::filesystem::remove(temporary, ignored);
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return;
+    }
+
+    if (options_.disk_max_bytes != 0) {
+        bool over = false;
+        {
+            const std::lock_guard<std::mutex> lock(disk_mutex_);
+            disk_bytes_ += encrypted.size();
+            over = disk_bytes_ > options_.disk_max_bytes;
+        }
+        if (over) {
+            TrimDisk();
+        }
+    }
+}
+
+void LLMResponseCache::RemoveFromDisk(const std::string& path, const char* reason) {
+    std::error_code error;
+    std::filesystem::remove(path, error);
+    if (logger_) {
+        logger_->LogFormatted(ILogger::LOG_DEBUG, "Removed LLM cache file %s: %s", path.c_str(), reason);
+    }
+}
+
+void LLMResponseCache::TrimDisk() {
+    struct CacheFile {
+        std::filesystem::file_time_type written;
+        uint64_t size;
+        std::filesystem::path path;
+    };
+
+    const std::lock_guard<std::mutex> lock(disk_mutex_);
+    std::vector<CacheFile> files;
+    uint64_t total = 0;
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(options_.disk_directory, error), end; !error && it != end;
+         it.increment(error)) {
+        if (it->path().extension() != ".llmcache") {
+            continue;
+        }
+        std::error_code ignored;
+        const uint64_t size = it->file_size(ignored);
+        const auto written = it->last_write_time(ignored);
+        if (!ignored) {
+            files.push_back({written, size, it->path()});
+            total += size;
+        }
+    }
+
+    // Down to 90% of the bound, so the next few writes do not trim again
+    uint64_t evicted = 0;
+    if (options_.disk_max_bytes != 0 && total > options_.disk_max_bytes) {
+        const uint64_t target = options_.disk_max_bytes - options_.disk_max_bytes / 10;
+        std::sort(files.begin(), files.end(),
+                  [](const CacheFile& a, const CacheFile& b) { return a.written < b.written; });
+        for (const CacheFile& file : files) {
+            if (total <= target) {
+                break;
+            }
+            std::error_code ignored;
+            if (std::filesystem::remove(file.path, ignored)) {
+                total -= file.size;
+                ++evicted;
+            }
+        }
+    }
+    disk_bytes_ = total;
+
+    if (evicted != 0) {
+        {
+            const std::lock_guard<std::mutex> stats_lock(mutex_);
+            stats_.disk_evictions += evicted;
+        }
+        if (logger_) {
+            logger_->LogFormatted(ILogger::LOG_DEBUG, "Evicted %llu LLM cache files",
+                                  static_cast<unsigned long long>(evicted));
+        }
+    }
+}
+
+} // namespace mcp
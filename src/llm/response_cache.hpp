@@ -0,0 +1,108 @@
+#pragma once
+
+#include "mcp/executor.hpp"
+#include "mcp/interfaces.hpp"
+#include "mcp/types.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mcp {
+
+struct ResponseCacheOptions {
+    size_t memory_entries = 512;            // 0 disables the memory tier
+    std::chrono::seconds ttl{24 * 3600};    // 0 keeps entries until evicted
+    std::string disk_directory;             // Empty disables the disk tier
+    uint64_t disk_max_bytes = 256ull << 20; // Oldest files are evicted above this; 0 = unbounded
+};
+
+/**
+ * @brief Content-addressed cache of LLM responses
+ *
+ * Keys hash everything that shapes an answer: provider, model, system
+ * prompt, prompt, context and sampling parameters. Hits come from an
+ * in-memory LRU first, then from files in the disk directory, which are
+ * encrypted through the security manager and shared across sessions (the
+ * security manager's key must then persist, see LoadEncryptionKey). Files
+ * that no longer decrypt are deleted, and the directory is kept under
+ * disk_max_bytes by evicting the oldest files first. An
+ * identical request arriving while the first is still upstream waits for
+ * that result instead of sending its own.
+ */
+class LLMResponseCache {
+public:
+    struct Stats {
+        uint64_t memory_hits = 0;
+        uint64_t disk_hits = 0;
+        uint64_t misses = 0;
+        uint64_t deduplicated = 0;   // Requests that shared an in-flight call
+        uint64_t stores = 0;
+        uint64_t disk_evictions = 0;  // Files removed to stay under disk_max_bytes
+        size_t entries = 0;
+    };
+
+    explicit LLMResponseCache(ResponseCacheOptions options = {},
+                              std::shared_ptr<ISecurityManager> security = nullptr,
+                              std::shared_ptr<ILogger> logger = nullptr);
+
+    // 32 hex digits; stable across runs and platforms
+    static std::string KeyFor(const std::string& provider, const LLMRequest& request);
+
+    std::optional<LLMResponse> Get(const std::string& key);
+    void Put(const std::string& key, const LLMResponse& response);
+
+    /**
+     * @brief Join an identical request already in flight
+     *
+     * Returns true and sets waiter when another caller is fetching key.
+     * Otherwise marks key in flight and returns false: the caller fetches
+     * and must report the outcome with CompleteInFlight().
+     */
+    bool JoinInFlight(const std::string& key, Future<Result<LLMResponse>>& waiter);
+    // Stores a success and hands the outcome to every waiter
+    void CompleteInFlight(const std::string& key, const Result<LLMResponse>& result);
+
+    void Clear();  // Memory tier only; files age out through the TTL
+    Stats GetStats() const;
+    bool HasDiskTier() const { return disk_enabled_; }
+
+private:
+    struct Entry {
+        std::string key;
+        LLMResponse response;
+        std::chrono::system_clock::time_point created;
+    };
+
+    ResponseCacheOptions options_;
+    std::shared_ptr<ISecurityManager> security_;
+    std::shared_ptr<ILogger> logger_;
+    bool disk_enabled_ = false;
+
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_;  // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> entries_;
+    std::unordered_map<std::string, std::vector<Promise<Result<LLMResponse>>>> in_flight_;
+    Stats stats_;
+
+    std::mutex disk_mutex_;    // Serializes trimming
+    uint64_t disk_bytes_ = 0;  // This session's estimate; trimming recounts the directory
+
+    bool Expired(std::chrono::system_clock::time_point created) const;
+    void Remember(const std::string& key, const LLMResponse& response, std::chrono::system_clock::time_point created);
+    std::string PathFor(const std::string& key) const;
+    std::optional<Entry> ReadFromDisk(const std::string& key);
+    void WriteToDisk(const Entry& entry);
+    void RemoveFromDisk(const std::string& path, const char* reason);
+    // Recounts the directory and, when over the bound, removes the oldest files
+    void TrimDisk();
+};
+
+} // namespace mcp
@@ -0,0 +1,75 @@
+#include "sse_parser.hpp"
+#include <utility>
+
+namespace mcp {
+
+bool SseParser::Feed(const char* data, size_t size, const Handler& handler) {
+    for (size_t i = 0; i < size && !stopped_; ++i) {
+        const char c = data[i];
+        if (c == '\n' && after_cr_) {
+            after_cr_ = false;
+            continue;
+        }
+        after_cr_ = (c == '\r');
+        if (c == '\r' || c == '\n') {
+            ProcessLine(handler);
+            line_.clear();
+        } else {
+            line_.push_back(c);
+        }
+    }
+    return !stopped_;
+}
+
+bool SseParser::Finish(const Handler& handler) {
+    if (!stopped_ && !line_.empty()) {
+        ProcessLine(handler);
+        line_.clear();
+    }
+    if (!stopped_) {
+        Dispatch(handler);
+    }
+    return !stopped_;
+}
+
+void SseParser::ProcessLine(const Handler& handler) {
+    if (line_.empty()) {
+        Dispatch(handler);
+        return;
+    }
+    if (line_[0] == ':') {
+        return;  // Comment, often a keep-alive ping
+    }
+
+    const size_t colon = line_.find(':');
+    const std::string field = line_.substr(0, colon);
+    std::string value;
+    if (colon != std::string::npos) {
+        size_t start = colon + 1;
+        if (start < line_.size() && line_[start] == ' ') {
+            ++start;
+        }
+        value = line_.substr(start);
+    }
+
+    if (field == "data") {
+        if (has_data_) {
+            pending_.data.push_back('\n');
+        }
+        pending_.data += value;
+        has_data_ = true;
+    } else if (field == "event") {
+        pending_.event = std::move(value);
+    }
+}
+
+void SseParser::Dispatch(const Handler& handler) {
+    // An event without data lines is dropped, as browsers do
+    if (has_data_ && handler && !handler(pending_)) {
+        stopped_ = true;
+    }
+    pending_ = SseEvent();
+    has_data_ = false;
+}
+
+} // namespace mcp
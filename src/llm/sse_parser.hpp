@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace mcp {
+
+struct SseEvent {
+    std::string event;  // Empty for the default "message" type
+    std::string data;   // Data lines joined with '\n'
+};
+
+/**
+ * @brief Incremental parser for a text/event-stream body
+ *
+ * Bytes are fed as they arrive off the socket, so a line or an event may
+ * span any number of chunks. LF, CR and CRLF line endings are accepted;
+ * comment lines, id and retry fields are ignored.
+ */
+class SseParser {
+public:
+    // Return false to stop; the parser then ignores further input
+    using Handler = std::function<bool(const SseEvent& event)>;
+
+    // False once a handler has asked to stop
+    bool Feed(const char* data, size_t size, const Handler& handler);
+    // Dispatches an event left unterminated when the stream closed
+    bool Finish(const Handler& handler);
+
+    bool Stopped() const { return stopped_; }
+
+private:
+    std::string line_;
+    SseEvent pending_;
+    bool has_data_ = false;
+    bool after_cr_ = false;  // A CRLF may be split across chunks
+    bool stopped_ = false;
+
+    void ProcessLine(const Handler& handler);
+    void Dispatch(const Handler& handler);
+};
+
+} // namespace mcp
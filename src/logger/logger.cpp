@@ -1,4 +1,5 @@
 #include "logger.hpp"
+#include "mcp/hex_codec.hpp"
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -13,6 +14,7 @@
 #include <utility>
 #include <exception>
 #include <cstdio>
+#include <cstring>
 #include <ctime>
 
 #ifdef _WIN32
@@ -21,21 +23,32 @@
 
 namespace mcp {
 
-Logger::Logger(const LogConfig& config) : config_(config) {
+Logger::Logger(const LogConfig& config)
+    : config_(config), level_(static_cast<int>(config.level)) {
+    CompileFormat();
+    auto policy = ParseOverflowPolicy(config_.overflow_policy);
+    if (policy.IsSuccess()) {
+        overflow_policy_ = policy.Value();
+    }
+
+    free_entries_ = std::make_unique<MpscRing<uint32_t>>(std::max<size_t>(config_.queue_capacity, 2));
+    queued_entries_ = std::make_unique<MpscRing<uint32_t>>(free_entries_->Capacity());
+    entry_pool_.resize(free_entries_->Capacity());
+    for (uint32_t i = 0; i < entry_pool_.size(); ++i) {
+        free_entries_->TryPush(uint32_t{i});
+    }
+    batch_.reserve(kBatchSize);
+
     InitializeLogFile();
+    InitializeTrace();
     
     if (async_enabled_) {
-        log_thread_ = std::thread(&Logger::ProcessLogQueue, this);
+        StartLogThread();
     }
 }
 
 Logger::~Logger() {
-    shutdown_requested_ = true;
-    log_condition_.notify_all();
-    
-    if (log_thread_.joinable()) {
-        log_thread_.join();
-    }
+    StopLogThread();
     
     Flush();
     
@@ -48,25 +61,13 @@ void Logger::Log(Level level, const std::string& message) {
     if (!ShouldLog(level)) {
         return;
     }
-    
-    LogEntry entry;
-    entry.level = level;
-    entry.message = message;
-    entry.timestamp = std::chrono::system_clock::now();
-    entry.thread_id = std::this_thread::get_id();
-    
-    if (async_enabled_) {
-        std::lock_guard<std::mutex> lock(log_mutex_);
-        log_queue_.push(entry);
-        log_condition_.notify_one();
-    } else {
-        WriteLogEntry(entry);
-    }
+    Enqueue(level, message.data(), message.size(), nullptr);
 }
 
 void Logger::SetLevel(Level level) {
     std::lock_guard<std::mutex> lock(log_mutex_);
     config_.level = static_cast<LogConfig::Level>(level);
+    level_ = static_cast<int>(level);
 }
 
 void Logger::SetOutput(const std::string& path) {
@@ -99,34 +100,28 @@ void Logger::LogFormatted(Level level, const char* format, ...) {
         return;
     }
     
-    // Format the string
+    // Short messages are formatted on the stack; the pooled entry copies them
+    char local[512];
+    if (static_cast<size_t>(size) < sizeof(local)) {
+        vsnprintf(local, sizeof(local), format, args);
+        va_end(args);
+        Enqueue(level, local, static_cast<size_t>(size), nullptr);
+        return;
+    }
+    
     std::string buffer(size + 1, '\0');
     vsnprintf(&buffer[0], size + 1, format, args);
     va_end(args);
     
     buffer.resize(size); // Remove null terminator
-    Log(level, buffer);
+    Enqueue(level, buffer.data(), buffer.size(), nullptr);
 }
 
 void Logger::LogWithContext(Level level, const std::string& message, const std::string& context) {
     if (!ShouldLog(level)) {
         return;
     }
-    
-    LogEntry entry;
-    entry.level = level;
-    entry.message = message;
-    entry.context = context;
-    entry.timestamp = std::chrono::system_clock::now();
-    entry.thread_id = std::this_thread::get_id();
-    
-    if (async_enabled_) {
-        std::lock_guard<std::mutex> lock(log_mutex_);
-        log_queue_.push(entry);
-        log_condition_.notify_one();
-    } else {
-        WriteLogEntry(entry);
-    }
+    Enqueue(level, message.data(), message.size(), &context);
 }
 
 
@@ -137,11 +132,27 @@ void Logger::LogException(const std::exception& exception, const std::string& co
 }
 
 void Logger::LogMemoryDump(const MemoryDump& dump) {
+    if (auto trace = std::atomic_load(&trace_sink_)) {
+        trace->WriteMemoryDump(MemoryView::Of(dump), dump.timestamp);
+        return;
+    }
+    LogMemoryDump(MemoryView::Of(dump));
+}
+
+void Logger::LogMemoryDump(const MemoryView& dump) {
+    if (auto trace = std::atomic_load(&trace_sink_)) {
+        trace->WriteMemoryDump(dump);
+        return;
+    }
     std::string serialized = SerializeMemoryDump(dump);
     LogWithContext(ILogger::LOG_DEBUG, serialized, "MEMORY_DUMP");
 }
 
 void Logger::LogDebugEvent(const DebugEvent& event) {
+    if (auto trace = std::atomic_load(&trace_sink_)) {
+        trace->WriteEvent(event);
+        return;
+    }
     std::string serialized = SerializeDebugEvent(event);
     LogWithContext(ILogger::LOG_INFO, serialized, "DEBUG_EVENT");
 }
@@ -150,33 +161,39 @@ void Logger::UpdateConfig(const LogConfig& config) {
     std::lock_guard<std::mutex> lock(log_mutex_);
     
     bool path_changed = (config_.output_path != config.output_path);
+    bool trace_changed = (config_.trace_path != config.trace_path);
     config_ = config;
+    CompileFormat();
+    level_ = static_cast<int>(config.level);
+    auto policy = ParseOverflowPolicy(config.overflow_policy);
+    if (policy.IsSuccess()) {
+        overflow_policy_ = policy.Value();
+    }
     
     if (path_changed && log_file_.is_open()) {
         log_file_.close();
         InitializeLogFile();
     }
+    if (trace_changed) {
+        InitializeTrace();
+    }
 }
 
 void Logger::Flush() {
     // Блокируем весь объект для flush операции
     std::lock_guard<std::mutex> global_lock(log_mutex_);
     
-    if (async_enabled_) {
-        // Process remaining entries in queue synchronously
-        while (!log_queue_.empty()) {
-            LogEntry entry = std::move(log_queue_.front());
-            log_queue_.pop();
-            
-            // Write entry safely under mutex protection
-            WriteLogEntryUnsafe(entry);
-        }
+    // Write out whatever is still queued, whether or not the log thread runs
+    while (WriteQueuedBatchUnsafe()) {
     }
     
     // Синхронный flush всех потоков вывода (уже под mutex)
     if (log_file_.is_open()) {
         log_file_.flush();
     }
+    if (auto trace = std::atomic_load(&trace_sink_)) {
+        trace->Flush();
+    }
     
     // БЕЗОПАСНОСТЬ: читаем config_ под mutex и фильтруем консольный вывод
     if (config_.console_output) {
@@ -187,33 +204,49 @@ void Logger::Flush() {
 }
 
 void Logger::EnableAsyncLogging(bool enable) {
-    // Simplified and safer approach to avoid complex locking
-    std::lock_guard<std::mutex> lock(log_mutex_);
-    
     if (enable == async_enabled_.load()) {
         return; // No change needed
     }
     
-    if (!enable && log_thread_.joinable()) {
-        // Graceful shutdown: signal and wait for thread completion
-        shutdown_requested_.store(true);
-        log_condition_.notify_all();
-        
-        // Release mutex temporarily to avoid deadlock during join
-        log_mutex_.unlock();
-        log_thread_.join();
-        log_mutex_.lock();
-        
-        shutdown_requested_.store(false);
-    }
-    
     async_enabled_.store(enable);
-    
-    if (enable && !log_thread_.joinable()) {
-        log_thread_ = std::thread(&Logger::ProcessLogQueue, this);
+    if (enable) {
+        StartLogThread();
+    } else {
+        // Entries queued before the switch still go out, in order
+        StopLogThread();
+        Flush();
     }
 }
 
+std::shared_ptr<TraceSink> Logger::GetTraceSink() const {
+    return std::atomic_load(&trace_sink_);
+}
+
+Logger::QueueStats Logger::GetQueueStats() const {
+    QueueStats stats;
+    stats.logged = logged_.load(std::memory_order_relaxed);
+    stats.written = written_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.batches = batches_.load(std::memory_order_relaxed);
+    stats.blocked = blocked_.load(std::memory_order_relaxed);
+    stats.capacity = entry_pool_.size();
+    stats.queued = queued_entries_->ApproximateSize();
+    return stats;
+}
+
+Result<Logger::OverflowPolicy> Logger::ParseOverflowPolicy(const std::string& name) {
+    if (name == "block") {
+        return Result<OverflowPolicy>::Success(OverflowPolicy::BLOCK);
+    }
+    if (name == "drop_oldest") {
+        return Result<OverflowPolicy>::Success(OverflowPolicy::DROP_OLDEST);
+    }
+    if (name == "drop_newest") {
+        return Result<OverflowPolicy>::Success(OverflowPolicy::DROP_NEWEST);
+    }
+    return Result<OverflowPolicy>::Error("Unknown log overflow policy: " + name);
+}
+
 void Logger::InitializeLogFile() {
     if (!config_.file_output || config_.output_path.empty()) {
         return;
@@ -237,23 +270,214 @@ void Logger::InitializeLogFile() {
     log_file_.flush();
 }
 
+void Logger::InitializeTrace() {
+    std::shared_ptr<TraceSink> trace;
+    if (!config_.trace_path.empty()) {
+        TraceOptions options;
+        options.path = config_.trace_path;
+        options.max_segment_bytes = config_.max_file_size_mb * 1024 * 1024;
+        options.max_segments = config_.max_files;
+        trace = std::make_shared<TraceSink>(options);
+        auto open_result = trace->Open();
+        if (!open_result.IsSuccess()) {
+            std::cerr << open_result.Error() << '\n';
+            trace.reset();
+        }
+    }
+    std::atomic_store(&trace_sink_, std::move(trace));
+}
+
+void Logger::StartLogThread() {
+    const std::lock_guard<std::mutex> lock(thread_mutex_);
+    if (log_thread_.joinable()) {
+        return;
+    }
+    shutdown_requested_ = false;
+    consumer_running_ = true;
+    log_thread_ = std::thread(&Logger::ProcessLogQueue, this);
+}
+
+void Logger::StopLogThread() {
+    const std::lock_guard<std::mutex> lock(thread_mutex_);
+    if (!log_thread_.joinable()) {
+        return;
+    }
+    {
+        const std::lock_guard<std::mutex> wake_lock(wake_mutex_);
+        shutdown_requested_ = true;
+    }
+    log_condition_.notify_all();
+    log_thread_.join();
+    consumer_running_ = false;
+    // Producers waiting for room under BLOCK now fall back to dropping
+    space_condition_.notify_all();
+}
+
 void Logger::ProcessLogQueue() {
-    while (!shutdown_requested_) {
-        std::unique_lock<std::mutex> lock(log_mutex_);
-        log_condition_.wait(lock, [this] { 
-            return !log_queue_.empty() || shutdown_requested_; 
-        });
-        
-        while (!log_queue_.empty()) {
-            LogEntry entry = log_queue_.front();
-            log_queue_.pop();
-            lock.unlock();
-            
-            WriteLogEntry(entry);
-            
-            lock.lock();
+    for (;;) {
+        bool wrote = false;
+        {
+            const std::lock_guard<std::mutex> lock(log_mutex_);
+            wrote = WriteQueuedBatchUnsafe();
+        }
+        if (wrote) {
+            if (blocked_producers_.load() > 0) {
+                const std::lock_guard<std::mutex> wake_lock(wake_mutex_);
+                space_condition_.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> wake_lock(wake_mutex_);
+        if (shutdown_requested_) {
+            return;  // Drained
+        }
+        // Pairs with the fence in WakeLogThread: either we see the entry or the producer sees us asleep
+        consumer_sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (queued_entries_->ApproximateSize() == 0) {
+            log_condition_.wait_for(wake_lock, std::chrono::milliseconds(100));
+        }
+        consumer_sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+void Logger::Enqueue(Level level, const char* message, size_t length, const std::string* context) {
+    if (!async_enabled_.load(std::memory_order_relaxed)) {
+        LogEntry entry;
+        entry.level = level;
+        entry.message.assign(message, length);
+        if (context) {
+            entry.context = *context;
+        }
+        entry.timestamp = std::chrono::system_clock::now();
+        entry.thread_id = std::this_thread::get_id();
+        WriteLogEntry(entry);
+        return;
+    }
+
+    uint32_t index = 0;
+    if (!ClaimEntry(index)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    LogEntry& entry = entry_pool_[index];
+    entry.level = level;
+    entry.message.assign(message, length);
+    if (context) {
+        entry.context.assign(*context);
+    } else {
+        entry.context.clear();
+    }
+    entry.timestamp = std::chrono::system_clock::now();
+    entry.thread_id = std::this_thread::get_id();
+
+    // Both rings hold the whole pool, so this push cannot fail
+    queued_entries_->TryPush(uint32_t{index});
+    logged_.fetch_add(1, std::memory_order_relaxed);
+    WakeLogThread();
+}
+
+bool Logger::ClaimEntry(uint32_t& index) {
+    if (free_entries_->TryPop(index)) {
+        return true;
+    }
+
+    switch (overflow_policy_.load(std::memory_order_relaxed)) {
+        case OverflowPolicy::DROP_NEWEST:
+            return false;
+        case OverflowPolicy::DROP_OLDEST:
+            // Whoever pops an index owns it, so racing the log thread is safe. Every
+            // entry is queued, being filled, or being formatted by the log thread,
+            // and all of those come back shortly, so the newest call always gets one
+            for (int attempt = 0;; ++attempt) {
+                if (queued_entries_->TryPop(index)) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+                if (free_entries_->TryPop(index)) {
+                    return true;
+                }
+                if (attempt < 64) {
+                    std::this_thread::yield();
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            }
+        case OverflowPolicy::BLOCK: {
+            blocked_.fetch_add(1, std::memory_order_relaxed);
+            ++blocked_producers_;
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            bool claimed = false;
+            while (!(claimed = free_entries_->TryPop(index)) && consumer_running_) {
+                space_condition_.wait_for(lock, std::chrono::milliseconds(10));
+            }
+            --blocked_producers_;
+            // Nobody is writing, so waiting would never end
+            return claimed;
+        }
+    }
+    return false;
+}
+
+void Logger::WakeLogThread() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (consumer_sleeping_.load(std::memory_order_relaxed)) {
+        const std::lock_guard<std::mutex> lock(wake_mutex_);
+        log_condition_.notify_one();
+    }
+}
+
+bool Logger::WriteQueuedBatchUnsafe() {
+    batch_.clear();
+    if (queued_entries_->PopBatch(batch_, kBatchSize) == 0) {
+        return false;
+    }
+
+    file_batch_.clear();
+    console_batch_.clear();
+    const bool to_file = config_.file_output && log_file_.is_open();
+    for (uint32_t index : batch_) {
+        LogEntry& entry = entry_pool_[index];
+        const std::string& formatted = FormatLogEntry(entry);
+        const Level level = entry.level;
+        if (entry.message.capacity() > kMaxPooledText) {
+            std::string().swap(entry.message);
+        }
+        if (entry.context.capacity() > kMaxPooledText) {
+            std::string().swap(entry.context);
+        }
+        // formatted lives in line_buffer_, so the entry can go back before the line is written
+        free_entries_->TryPush(uint32_t{index});
+
+        if (config_.console_output) {
+#ifdef _WIN32
+            WriteToConsole(formatted, level);  // Colours are set per line through the console API
+#else
+            AppendConsoleLine(console_batch_, formatted, level);
+#endif
+        }
+        if (to_file) {
+            file_batch_ += formatted;
+            file_batch_ += '\n';
+        }
+    }
+
+    if (!console_batch_.empty()) {
+        std::cout.write(console_batch_.data(), static_cast<std::streamsize>(console_batch_.size()));
+        std::cout.flush();
+    }
+    if (!file_batch_.empty()) {
+        log_file_.write(file_batch_.data(), static_cast<std::streamsize>(file_batch_.size()));
+        log_file_.flush();
+        current_file_size_ += file_batch_.size();
+        if (current_file_size_ >= config_.max_file_size_mb * 1024 * 1024) {
+            RotateLogFile();
         }
     }
+    written_.fetch_add(batch_.size(), std::memory_order_relaxed);
+    batches_.fetch_add(1, std::memory_order_relaxed);
+    return true;
 }
 
 void Logger::WriteLogEntry(const LogEntry& entry) {
@@ -262,7 +486,7 @@ void Logger::WriteLogEntry(const LogEntry& entry) {
 }
 
 void Logger::WriteLogEntryUnsafe(const LogEntry& entry) {
-    std::string formatted = FormatLogEntry(entry);
+    const std::string& formatted = FormatLogEntry(entry);
     
     if (config_.console_output) {
         WriteToConsole(formatted, entry.level);
@@ -299,49 +523,111 @@ void Logger::RotateLogFile() {
     InitializeLogFile();
 }
 
-std::string Logger::FormatLogEntry(const LogEntry& entry) const {
-    std::ostringstream oss;
-    
-    // Replace format placeholders
-    std::string format = config_.format;
-    
-    // Timestamp
-    size_t pos = format.find("{timestamp}");
-    if (pos != std::string::npos) {
-        format.replace(pos, 11, GetTimestamp(entry.timestamp));
+void Logger::CompileFormat() {
+    static const struct {
+        const char* name;
+        FormatSegment::Kind kind;
+    } kPlaceholders[] = {
+        {"{timestamp}", FormatSegment::TIMESTAMP},
+        {"{level}", FormatSegment::LEVEL},
+        {"{thread}", FormatSegment::THREAD},
+        {"{context}", FormatSegment::CONTEXT},
+        {"{message}", FormatSegment::MESSAGE},
+    };
+
+    format_segments_.clear();
+    const std::string& format = config_.format;
+    std::string literal;
+    size_t pos = 0;
+    while (pos < format.size()) {
+        bool matched = false;
+        if (format[pos] == '{') {
+            for (const auto& placeholder : kPlaceholders) {
+                const size_t length = std::strlen(placeholder.name);
+                if (format.compare(pos, length, placeholder.name) == 0) {
+                    if (!literal.empty()) {
+                        format_segments_.push_back({FormatSegment::LITERAL, std::move(literal)});
+                        literal.clear();
+                    }
+                    format_segments_.push_back({placeholder.kind, std::string()});
+                    pos += length;
+                    matched = true;
+                    break;
+                }
+            }
+        }
+        if (!matched) {
+            literal += format[pos++];  // Unknown placeholders stay as written
+        }
     }
-    
-    // Level
-    pos = format.find("{level}");
-    if (pos != std::string::npos) {
-        format.replace(pos, 7, LevelToString(entry.level));
+    if (!literal.empty()) {
+        format_segments_.push_back({FormatSegment::LITERAL, std::move(literal)});
     }
-    
-    // Thread ID
-    pos = format.find("{thread}");
-    if (pos != std::string::npos) {
-        std::ostringstream thread_oss;
-        thread_oss << entry.thread_id;
-        format.replace(pos, 8, thread_oss.str());
+}
+
+const std::string& Logger::FormatLogEntry(const LogEntry& entry) {
+    std::string& out = line_buffer_;
+    out.clear();
+    for (const auto& segment : format_segments_) {
+        switch (segment.kind) {
+            case FormatSegment::LITERAL:
+                out += segment.literal;
+                break;
+            case FormatSegment::TIMESTAMP:
+                AppendTimestamp(entry.timestamp, out);
+                break;
+            case FormatSegment::LEVEL:
+                out += LevelName(entry.level);
+                break;
+            case FormatSegment::THREAD:
+                out += ThreadName(entry.thread_id);
+                break;
+            case FormatSegment::CONTEXT:
+                if (!entry.context.empty()) {
+                    out += '[';
+                    out += entry.context;
+                    out += "] ";
+                }
+                break;
+            case FormatSegment::MESSAGE:
+                out += entry.message;
+                break;
+        }
     }
-    
-    // Context
-    pos = format.find("{context}");
-    if (pos != std::string::npos) {
-        std::string context_str = entry.context.empty() ? "" : "[" + entry.context + "] ";
-        format.replace(pos, 9, context_str);
+    return out;
+}
+
+void Logger::AppendTimestamp(const std::chrono::system_clock::time_point& time, std::string& out) {
+    const auto since_epoch = time.time_since_epoch();
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+    // Whole seconds change rarely compared to the entry rate; only they need the calendar
+    if (timestamp_second_ != seconds.count() || timestamp_text_.empty()) {
+        timestamp_second_ = seconds.count();
+        timestamp_text_ = GetTimestamp(std::chrono::system_clock::time_point(seconds));
+        timestamp_text_.resize(timestamp_text_.size() - 3);  // Keep "...:SS." and drop the zero millis
+    }
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(since_epoch - seconds).count();
+    out += timestamp_text_;
+    out += static_cast<char>('0' + ms / 100);
+    out += static_cast<char>('0' + ms / 10 % 10);
+    out += static_cast<char>('0' + ms % 10);
+}
+
+const std::string& Logger::ThreadName(std::thread::id id) {
+    auto it = thread_names_.find(id);
+    if (it != thread_names_.end()) {
+        return it->second;
     }
-    
-    // Message
-    pos = format.find("{message}");
-    if (pos != std::string::npos) {
-        format.replace(pos, 9, entry.message);
+    // Bounded so a process that churns through threads does not grow it forever
+    if (thread_names_.size() >= kMaxThreadNames) {
+        thread_names_.clear();
     }
-    
-    return format;
+    std::ostringstream thread_oss;
+    thread_oss << id;
+    return thread_names_.emplace(id, thread_oss.str()).first->second;
 }
 
-std::string Logger::LevelToString(Level level) const {
+const char* Logger::LevelName(Level level) {
     switch (level) {
         case ILogger::LOG_DEBUG: return "DEBUG";
         case ILogger::LOG_INFO:  return "INFO ";
@@ -352,6 +638,10 @@ std::string Logger::LevelToString(Level level) const {
     }
 }
 
+std::string Logger::LevelToString(Level level) const {
+    return LevelName(level);
+}
+
 std::string Logger::GetTimestamp(const std::chrono::system_clock::time_point& time) const {
     auto time_t = std::chrono::system_clock::to_time_t(time);
     auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -363,7 +653,9 @@ std::string Logger::GetTimestamp(const std::chrono::system_clock::time_point& ti
     localtime_s(&local_time, &time_t);
     oss << std::put_time(&local_time, "%Y-%m-%d %H:%M:%S");
 #else
-    oss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
+    struct tm local_time;
+    localtime_r(&time_t, &local_time);
+    oss << std::put_time(&local_time, "%Y-%m-%d %H:%M:%S");
 #endif
     oss << '.' << std::setfill('0') << std::setw(3) << ms.count();
     
@@ -371,7 +663,7 @@ std::string Logger::GetTimestamp(const std::chrono::system_clock::time_point& ti
 }
 
 bool Logger::ShouldLog(Level level) const {
-    return static_cast<LogConfig::Level>(level) >= config_.level;
+    return static_cast<int>(level) >= level_.load(std::memory_order_relaxed);
 }
 
 void Logger::WriteToConsole(const std::string& formatted_message, Level level) {
@@ -392,6 +684,14 @@ void Logger::WriteToConsole(const std::string& formatted_message, Level level) {
     std::cout << formatted_message << '\n';
     SetConsoleTextAttribute(console, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
 #else
+    std::string line;
+    AppendConsoleLine(line, formatted_message, level);
+    std::cout << line;
+#endif
+}
+
+#ifndef _WIN32
+void Logger::AppendConsoleLine(std::string& out, const std::string& formatted_message, Level level) {
     const char* color_code = "\033[0m"; // Reset
     
     switch (level) {
@@ -402,9 +702,11 @@ void Logger::WriteToConsole(const std::string& formatted_message, Level level) {
         case ILogger::LOG_FATAL: color_code = "\033[35m"; break; // Magenta
     }
     
-    std::cout << color_code << formatted_message << "\033[0m\n";
-#endif
+    out += color_code;
+    out += formatted_message;
+    out += "\033[0m\n";
 }
+#endif
 
 void Logger::WriteToFile(const std::string& formatted_message) {
     log_file_ << formatted_message << '\n';
@@ -415,7 +717,7 @@ void Logger::WriteToFile(const std::string& formatted_message) {
     }
 }
 
-std::string Logger::SerializeMemoryDump(const MemoryDump& dump) const {
+std::string Logger::SerializeMemoryDump(const MemoryView& dump) const {
     std::ostringstream oss;
     oss << "MemoryDump{";
     oss << "base=0x" << std::hex << dump.base_address;
@@ -424,15 +726,12 @@ std::string Logger::SerializeMemoryDump(const MemoryDump& dump) const {
     oss << ", data_preview=";
     
     // Show first 32 bytes
-    const size_t max_preview = 32;
-    size_t preview_size = (dump.data.size() < max_preview) ? dump.data.size() : max_preview;
-    for (size_t i = 0; i < preview_size; ++i) {
-        oss << std::hex << std::setw(2) << std::setfill('0') 
-            << static_cast<int>(dump.data[i]);
-        if (i < preview_size - 1) oss << " ";
-    }
+    constexpr size_t max_preview = 32;
+    size_t preview_size = (dump.size < max_preview) ? dump.size : max_preview;
+    char preview[HexEncodedSize(max_preview, ' ')];
+    oss.write(preview, static_cast<std::streamsize>(HexEncode(dump.data, preview_size, preview, {false, ' '})));
     
-    if (dump.data.size() > 32) {
+    if (dump.size > 32) {
         oss << "...";
     }
     
@@ -1,19 +1,52 @@
 #pragma once
 
 #include "mcp/interfaces.hpp"
+#include "mcp/memory_view.hpp"
+#include "mcp/mpsc_ring.hpp"
 #include "mcp/types.hpp"
+#include "trace_sink.hpp"
 #include <memory>
 #include <mutex>
 #include <fstream>
-#include <queue>
 #include <thread>
 #include <condition_variable>
 #include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace mcp {
 
+/**
+ * @brief Asynchronous logger that never takes a lock on the logging path
+ *
+ * Entries live in a pool allocated up front. A logging thread claims a
+ * free entry from a lock-free ring, fills it in place (its strings keep
+ * their capacity between uses) and hands its index to the log thread
+ * through a second ring. The log thread drains up to kBatchSize entries
+ * at a time and writes each batch to the console and the file in one call.
+ * The log thread is only woken when it sleeps.
+ */
 class Logger : public ILogger {
 public:
+    // What a logging call does when every pooled entry is queued
+    enum class OverflowPolicy {
+        BLOCK,         // Wait for the log thread to write some out
+        DROP_OLDEST,   // Overwrite the oldest queued entry; only waits for the log thread to hand one back
+        DROP_NEWEST    // Discard the entry being logged
+    };
+
+    struct QueueStats {
+        uint64_t logged = 0;     // Accepted into the queue
+        uint64_t written = 0;
+        uint64_t dropped = 0;
+        uint64_t batches = 0;
+        uint64_t blocked = 0;    // Calls that waited for room under BLOCK
+        size_t capacity = 0;
+        size_t queued = 0;
+    };
+
     explicit Logger(const LogConfig& config = LogConfig{});
     ~Logger() override;
 
@@ -27,12 +60,18 @@ public:
     void LogWithContext(Level level, const std::string& message, const std::string& context);
     void LogException(const std::exception& exception, const std::string& context = "") override;
     void LogMemoryDump(const MemoryDump& dump);
+    void LogMemoryDump(const MemoryView& dump);
     void LogDebugEvent(const DebugEvent& event);
     
     // Configuration
     void UpdateConfig(const LogConfig& config);
     void Flush();
     void EnableAsyncLogging(bool enable);
+    void SetOverflowPolicy(OverflowPolicy policy) { overflow_policy_ = policy; }
+    QueueStats GetQueueStats() const;
+    // Where LogMemoryDump and LogDebugEvent go instead of the text log; null while tracing is off
+    std::shared_ptr<TraceSink> GetTraceSink() const;
+    static Result<OverflowPolicy> ParseOverflowPolicy(const std::string& name);
 
 private:
     struct LogEntry {
@@ -43,37 +82,93 @@ private:
         std::string context;
     };
 
+    // config_.format split once into literal text and fields
+    struct FormatSegment {
+        enum Kind { LITERAL, TIMESTAMP, LEVEL, THREAD, CONTEXT, MESSAGE };
+        Kind kind;
+        std::string literal;
+    };
+
+    static constexpr size_t kBatchSize = 256;
+    static constexpr size_t kMaxThreadNames = 1024;
+    static constexpr size_t kMaxPooledText = 4096;  // Longer strings are released after use
+
     LogConfig config_;
-    mutable std::mutex log_mutex_;
+    mutable std::mutex log_mutex_;   // Config and outputs; never taken by a logging call in async mode
     std::ofstream log_file_;
+    std::atomic<int> level_;
+    std::atomic<OverflowPolicy> overflow_policy_{OverflowPolicy::DROP_NEWEST};
+    std::shared_ptr<TraceSink> trace_sink_;  // Swapped atomically; read on every dump and event
     
     // Async logging
-    std::queue<LogEntry> log_queue_;
+    std::vector<LogEntry> entry_pool_;
+    std::unique_ptr<MpscRing<uint32_t>> free_entries_;    // Pool indices ready to be filled
+    std::unique_ptr<MpscRing<uint32_t>> queued_entries_;  // Filled, oldest first
+    std::vector<uint32_t> batch_;                         // Log thread only, under log_mutex_
+    std::string file_batch_;
+    std::string console_batch_;
+    
+    // Formatting state, under log_mutex_
+    std::vector<FormatSegment> format_segments_;
+    std::string line_buffer_;
+    int64_t timestamp_second_ = 0;
+    std::string timestamp_text_;     // Up to and including the '.' before the milliseconds
+    std::unordered_map<std::thread::id, std::string> thread_names_;
     std::thread log_thread_;
+    std::mutex thread_mutex_;        // Starting and stopping the log thread
+    std::mutex wake_mutex_;
     std::condition_variable log_condition_;
+    std::condition_variable space_condition_;
+    std::atomic<bool> consumer_sleeping_{false};
+    std::atomic<bool> consumer_running_{false};
+    std::atomic<int> blocked_producers_{0};
     std::atomic<bool> shutdown_requested_{false};
     std::atomic<bool> async_enabled_{true};
+
+    std::atomic<uint64_t> logged_{0};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> blocked_{0};
     
     // File rotation
     size_t current_file_size_ = 0;
     int current_file_index_ = 0;
     
     void InitializeLogFile();
+    void InitializeTrace();
+    void StartLogThread();
+    void StopLogThread();
     void ProcessLogQueue();
+    // Queues the entry, or writes it at once when async logging is off
+    void Enqueue(Level level, const char* message, size_t length, const std::string* context);
+    bool ClaimEntry(uint32_t& index);
+    void WakeLogThread();
+    // Drains queued entries under log_mutex_; false when there were none
+    bool WriteQueuedBatchUnsafe();
     void WriteLogEntry(const LogEntry& entry);
     void WriteLogEntryUnsafe(const LogEntry& entry); // Thread-unsafe version for internal use
     void RotateLogFile();
     
-    std::string FormatLogEntry(const LogEntry& entry) const;
+    // Rendered into line_buffer_; valid until the next call, under log_mutex_
+    const std::string& FormatLogEntry(const LogEntry& entry);
+    void CompileFormat();
+    void AppendTimestamp(const std::chrono::system_clock::time_point& time, std::string& out);
+    const std::string& ThreadName(std::thread::id id);
+    static const char* LevelName(Level level);
     std::string LevelToString(Level level) const;
     std::string GetTimestamp(const std::chrono::system_clock::time_point& time) const;
     bool ShouldLog(Level level) const;
     
     void WriteToConsole(const std::string& formatted_message, Level level);
+#ifndef _WIN32
+    // The line with its ANSI colour, ready to be written with others in one call
+    static void AppendConsoleLine(std::string& out, const std::string& formatted_message, Level level);
+#endif
     void WriteToFile(const std::string& formatted_message);
     
     // Helper methods for structured data
-    std::string SerializeMemoryDump(const MemoryDump& dump) const;
+    std::string SerializeMemoryDump(const MemoryView& dump) const;
     std::string SerializeDebugEvent(const DebugEvent& event) const;
 };
 
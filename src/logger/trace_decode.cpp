@@ -0,0 +1,55 @@
+#include "trace_sink.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// mcp-trace-decode [--hex N] <segment>...
+// Prints every record of each trace segment as one text line.
+int main(int argc, const char* argv[]) {
+    size_t hex_bytes = 32;
+    int files = 0;
+    int status = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--hex" && i + 1 < argc) {
+            hex_bytes = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+            continue;
+        }
+        if (arg == "-h" || arg == "--help") {
+            std::cout << "Usage: " << argv[0] << " [--hex N] <trace segment>..." << std::endl;
+            return 0;
+        }
+
+        ++files;
+        mcp::TraceReader reader;
+        auto open_result = reader.Open(arg);
+        if (!open_result.IsSuccess()) {
+            std::cerr << open_result.Error() << std::endl;
+            status = 1;
+            continue;
+        }
+
+        mcp::TraceRecord record;
+        for (;;) {
+            auto next = reader.Next(record);
+            if (!next.IsSuccess()) {
+                // A torn tail is expected when the debugger died mid-write
+                std::cerr << arg << ": " << next.Error() << std::endl;
+                status = 1;
+                break;
+            }
+            if (!next.Value()) {
+                break;
+            }
+            std::cout << mcp::TraceReader::Format(record, hex_bytes) << '\n';
+        }
+    }
+
+    if (files == 0) {
+        std::cerr << "Usage: " << argv[0] << " [--hex N] <trace segment>..." << std::endl;
+        return 2;
+    }
+    std::cout.flush();
+    return status;
+}
@@ -0,0 +1,401 @@
+#include "trace_sink.hpp"
+#include "mcp/hex_codec.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <system_error>
+
+namespace mcp {
+
+namespace {
+
+constexpr char kTraceMagic[8] = {'M', 'C', 'P', 'T', 'R', 'A', 'C', 'E'};
+constexpr uint16_t kTraceVersion = 1;
+constexpr uint32_t kMaxRecordPayload = 256u * 1024 * 1024;  // Anything larger is corruption
+
+void PutU16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void PutU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+void PutU64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int shift = 0; shift < 64; shift += 8) {
+        out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+void PutString(std::vector<uint8_t>& out, const std::string& text) {
+    PutU32(out, static_cast<uint32_t>(text.size()));
+    out.insert(out.end(), text.begin(), text.end());
+}
+
+uint64_t GetLittleEndian(const uint8_t* data, size_t size) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; ++i) {
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+    return value;
+}
+
+// Bounds-checked walk over a record payload
+class PayloadCursor {
+public:
+    PayloadCursor(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    bool U32(uint32_t& value) {
+        if (size_ - position_ < 4) {
+            return false;
+        }
+        value = static_cast<uint32_t>(GetLittleEndian(data_ + position_, 4));
+        position_ += 4;
+        return true;
+    }
+
+    bool String(std::string& text) {
+        uint32_t length = 0;
+        if (!U32(length) || size_ - position_ < length) {
+            return false;
+        }
+        text.assign(reinterpret_cast<const char*>(data_ + position_), length);
+        position_ += length;
+        return true;
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t position_ = 0;
+};
+
+int64_t ToNanoseconds(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+const char* EventTypeName(uint32_t type) {
+    switch (static_cast<DebugEvent::Type>(type)) {
+        case DebugEvent::Type::BREAKPOINT_HIT: return "BREAKPOINT_HIT";
+        case DebugEvent::Type::EXCEPTION: return "EXCEPTION";
+        case DebugEvent::Type::PROCESS_CREATED: return "PROCESS_CREATED";
+        case DebugEvent::Type::PROCESS_TERMINATED: return "PROCESS_TERMINATED";
+        case DebugEvent::Type::MODULE_LOADED: return "MODULE_LOADED";
+        case DebugEvent::Type::MODULE_UNLOADED: return "MODULE_UNLOADED";
+        case DebugEvent::Type::THREAD_CREATED: return "THREAD_CREATED";
+        case DebugEvent::Type::THREAD_TERMINATED: return "THREAD_TERMINATED";
+    }
+    return "UNKNOWN";
+}
+
+std::string FormatTime(std::chrono::system_clock::time_point time) {
+    const auto since_epoch = time.time_since_epoch();
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(since_epoch - seconds).count();
+    const std::time_t time_t = static_cast<std::time_t>(seconds.count());
+    struct tm local_time;
+#ifdef _WIN32
+    localtime_s(&local_time, &time_t);
+#else
+    localtime_r(&time_t, &local_time);
+#endif
+    char text[32];
+    const size_t length = std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &local_time);
+    std::snprintf(text + length, sizeof(text) - length, ".%03d", static_cast<int>(ms));
+    return text;
+}
+
+} // anonymous namespace
+
+TraceSink::TraceSink(TraceOptions options) : options_(std::move(options)) {
+    options_.max_segments = std::max(options_.max_segments, 1);
+}
+
+TraceSink::~TraceSink() {
+    Flush();
+}
+
+Result<void> TraceSink::Open() {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (file_.is_open()) {
+        return Result<void>::Success();
+    }
+    if (options_.path.empty()) {
+        return Result<void>::Error("Trace path is empty");
+    }
+    std::error_code error;
+    const std::filesystem::path path(options_.path);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), error);
+    }
+    return OpenSegmentUnsafe();
+}
+
+bool TraceSink::IsOpen() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return file_.is_open();
+}
+
+void TraceSink::WriteEvent(const DebugEvent& event) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open()) {
+        return;
+    }
+
+    payload_.clear();
+    PutU32(payload_, event.process_id);
+    PutU32(payload_, event.thread_id);
+    PutString(payload_, event.description);
+    PutU32(payload_, static_cast<uint32_t>(event.metadata.size()));
+    for (const auto& [key, value] : event.metadata) {
+        PutString(payload_, key);
+        PutString(payload_, value);
+    }
+
+    const int64_t timestamp = ToNanoseconds(event.timestamp);
+    const uint32_t module_id = InternUnsafe(event.module_name, timestamp, payload_.size());
+    WriteRecordUnsafe(TraceRecordType::DEBUG_EVENT, 0, timestamp, event.address, module_id,
+                      static_cast<uint32_t>(event.type), payload_.data(), payload_.size());
+    ++stats_.events;
+}
+
+void TraceSink::WriteMemoryDump(const MemoryView& dump, std::chrono::system_clock::time_point timestamp) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open()) {
+        return;
+    }
+
+    const size_t kept = std::min(dump.size, options_.max_dump_bytes);
+    const uint16_t flags = kept < dump.size ? kTraceFlagTruncated : 0;
+    const int64_t nanoseconds = ToNanoseconds(timestamp);
+    const uint32_t module_id = InternUnsafe(dump.module_name, nanoseconds, kept);
+    const uint32_t full_size = static_cast<uint32_t>(std::min<size_t>(dump.size, UINT32_MAX));
+    WriteRecordUnsafe(TraceRecordType::MEMORY_DUMP, flags, nanoseconds, dump.base_address, module_id,
+                      full_size, dump.data, kept);
+    ++stats_.dumps;
+}
+
+void TraceSink::Flush() {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (file_.is_open()) {
+        file_.flush();
+    }
+}
+
+TraceSink::Stats TraceSink::GetStats() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+Result<void> TraceSink::OpenSegmentUnsafe() {
+    module_ids_.clear();
+    file_.open(options_.path, std::ios::binary | std::ios::app);
+    if (!file_.is_open()) {
+        return Result<void>::Error("Cannot open trace file: " + options_.path);
+    }
+
+    // Appending to an earlier run's segment keeps its header
+    std::error_code error;
+    segment_bytes_ = static_cast<size_t>(std::filesystem::file_size(options_.path, error));
+    if (error || segment_bytes_ == 0) {
+        std::vector<uint8_t> header(kTraceMagic, kTraceMagic + sizeof(kTraceMagic));
+        PutU16(header, kTraceVersion);
+        PutU16(header, static_cast<uint16_t>(kTraceRecordHeaderSize));
+        PutU32(header, 0);
+        file_.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        segment_bytes_ = header.size();
+        stats_.bytes += header.size();
+    }
+    return Result<void>::Success();
+}
+
+void TraceSink::RotateUnsafe() {
+    file_.close();
+
+    // Same naming and retention as the text log's rotation
+    std::error_code error;
+    const std::string rotated_name = options_.path + "." + std::to_string(segment_index_);
+    std::filesystem::rename(options_.path, rotated_name, error);
+    ++segment_index_;
+    if (segment_index_ >= options_.max_segments) {
+        std::filesystem::remove(options_.path + "." + std::to_string(segment_index_ - options_.max_segments), error);
+    }
+    ++stats_.rotations;
+    OpenSegmentUnsafe();
+}
+
+uint32_t TraceSink::InternUnsafe(const std::string& name, int64_t timestamp, size_t record_payload) {
+    if (name.empty()) {
+        return 0;
+    }
+    // Rotate before defining a name, so the definition lands in the segment that uses it
+    const size_t needed = 2 * kTraceRecordHeaderSize + name.size() + record_payload;
+    if (segment_bytes_ > kTraceFileHeaderSize && segment_bytes_ + needed > options_.max_segment_bytes) {
+        RotateUnsafe();
+    }
+    auto it = module_ids_.find(name);
+    if (it != module_ids_.end()) {
+        return it->second;
+    }
+    const uint32_t id = static_cast<uint32_t>(module_ids_.size() + 1);
+    module_ids_.emplace(name, id);
+    WriteRecordUnsafe(TraceRecordType::STRING, 0, timestamp, 0, id, 0,
+                      reinterpret_cast<const uint8_t*>(name.data()), name.size());
+    return id;
+}
+
+void TraceSink::WriteRecordUnsafe(TraceRecordType type, uint16_t flags, int64_t timestamp, uint64_t address,
+                                  uint32_t module_id, uint32_t detail, const uint8_t* payload, size_t size) {
+    const size_t record_size = kTraceRecordHeaderSize + size;
+    // Records that reference a module were already placed by InternUnsafe
+    if (module_id == 0 && segment_bytes_ > kTraceFileHeaderSize &&
+        segment_bytes_ + record_size > options_.max_segment_bytes) {
+        RotateUnsafe();
+    }
+    if (!file_.is_open()) {
+        return;
+    }
+
+    header_.clear();
+    PutU16(header_, static_cast<uint16_t>(type));
+    PutU16(header_, flags);
+    PutU32(header_, static_cast<uint32_t>(size));
+    PutU64(header_, static_cast<uint64_t>(timestamp));
+    PutU64(header_, address);
+    PutU32(header_, module_id);
+    PutU32(header_, detail);
+
+    file_.write(reinterpret_cast<const char*>(header_.data()), static_cast<std::streamsize>(header_.size()));
+    if (size > 0) {
+        file_.write(reinterpret_cast<const char*>(payload), static_cast<std::streamsize>(size));
+    }
+    segment_bytes_ += record_size;
+    stats_.bytes += record_size;
+}
+
+Result<void> TraceReader::Open(const std::string& path) {
+    file_.close();
+    modules_.clear();
+    file_.open(path, std::ios::binary);
+    if (!file_.is_open()) {
+        return Result<void>::Error("Cannot open trace file: " + path);
+    }
+
+    uint8_t header[kTraceFileHeaderSize];
+    if (!file_.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        std::memcmp(header, kTraceMagic, sizeof(kTraceMagic)) != 0) {
+        return Result<void>::Error("Not a trace file: " + path);
+    }
+    const auto version = static_cast<uint16_t>(GetLittleEndian(header + 8, 2));
+    const auto record_header_size = static_cast<uint16_t>(GetLittleEndian(header + 10, 2));
+    if (version != kTraceVersion || record_header_size != kTraceRecordHeaderSize) {
+        return Result<void>::Error("Unsupported trace version " + std::to_string(version));
+    }
+    return Result<void>::Success();
+}
+
+Result<bool> TraceReader::Next(TraceRecord& record) {
+    for (;;) {
+        uint8_t header[kTraceRecordHeaderSize];
+        file_.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (file_.gcount() == 0) {
+            return Result<bool>::Success(false);
+        }
+        if (static_cast<size_t>(file_.gcount()) != sizeof(header)) {
+            return Result<bool>::Error("Truncated trace record header");
+        }
+
+        const auto type = static_cast<TraceRecordType>(GetLittleEndian(header, 2));
+        const auto payload_size = static_cast<uint32_t>(GetLittleEndian(header + 4, 4));
+        if (payload_size > kMaxRecordPayload) {
+            return Result<bool>::Error("Corrupt trace record: payload of " + std::to_string(payload_size) + " bytes");
+        }
+        payload_.resize(payload_size);
+        if (payload_size > 0 &&
+            !file_.read(reinterpret_cast<char*>(payload_.data()), static_cast<std::streamsize>(payload_size))) {
+            return Result<bool>::Error("Truncated trace record payload");
+        }
+
+        const auto module_id = static_cast<uint32_t>(GetLittleEndian(header + 24, 4));
+        if (type == TraceRecordType::STRING) {
+            modules_[module_id].assign(payload_.begin(), payload_.end());
+            continue;
+        }
+
+        record = TraceRecord();
+        record.type = type;
+        record.flags = static_cast<uint16_t>(GetLittleEndian(header + 2, 2));
+        record.timestamp = std::chrono::system_clock::time_point(std::chrono::duration_cast<
+            std::chrono::system_clock::duration>(std::chrono::nanoseconds(
+                static_cast<int64_t>(GetLittleEndian(header + 8, 8)))));
+        record.address = GetLittleEndian(header + 16, 8);
+        record.detail = static_cast<uint32_t>(GetLittleEndian(header + 28, 4));
+        if (module_id != 0) {
+            auto it = modules_.find(module_id);
+            record.module_name = it != modules_.end() ? it->second : "#" + std::to_string(module_id);
+        }
+
+        if (type == TraceRecordType::MEMORY_DUMP) {
+            record.data = payload_;
+            return Result<bool>::Success(true);
+        }
+        if (type == TraceRecordType::DEBUG_EVENT) {
+            PayloadCursor cursor(payload_.data(), payload_.size());
+            uint32_t count = 0;
+            bool ok = cursor.U32(record.process_id) && cursor.U32(record.thread_id) &&
+                      cursor.String(record.description) && cursor.U32(count);
+            for (uint32_t i = 0; ok && i < count; ++i) {
+                std::pair<std::string, std::string> entry;
+                ok = cursor.String(entry.first) && cursor.String(entry.second);
+                record.metadata.push_back(std::move(entry));
+            }
+            if (!ok) {
+                return Result<bool>::Error("Corrupt debug event record");
+            }
+            return Result<bool>::Success(true);
+        }
+        // Unknown record types from a newer writer are skipped
+    }
+}
+
+std::string TraceReader::Format(const TraceRecord& record, size_t hex_bytes) {
+    char address[2 + 16 + 1];
+    std::snprintf(address, sizeof(address), "0x%llx", static_cast<unsigned long long>(record.address));
+
+    std::string text = "[" + FormatTime(record.timestamp) + "] ";
+    if (record.type == TraceRecordType::DEBUG_EVENT) {
+        text += "DebugEvent{type=";
+        text += EventTypeName(record.detail);
+        text += ", addr=";
+        text += address;
+        text += ", pid=" + std::to_string(record.process_id);
+        text += ", tid=" + std::to_string(record.thread_id);
+        text += ", module=" + record.module_name;
+        text += ", desc=" + record.description;
+        for (const auto& [key, value] : record.metadata) {
+            text += ", " + key + "=" + value;
+        }
+        text += "}";
+        return text;
+    }
+
+    text += "MemoryDump{base=";
+    text += address;
+    text += ", size=" + std::to_string(record.detail);
+    text += ", module=" + record.module_name;
+    text += ", data=";
+    const size_t shown = std::min(hex_bytes, record.data.size());
+    text += HexEncode(record.data.data(), shown, {false, ' '});
+    if (shown < record.detail) {
+        text += "...";
+    }
+    text += "}";
+    return text;
+}
+
+} // namespace mcp
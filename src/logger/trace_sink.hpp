@@ -0,0 +1,139 @@
+#pragma once
+
+#include "mcp/interfaces.hpp"
+#include "mcp/memory_view.hpp"
+#include "mcp/types.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mcp {
+
+/*
+ * Trace segment layout, all integers little-endian:
+ *
+ *   file header   "MCPTRACE" | u16 version | u16 record header size | u32 reserved
+ *   record        32-byte header | payload_size bytes
+ *
+ *   record header u16 type | u16 flags | u32 payload_size | i64 timestamp (ns since epoch)
+ *                 u64 address | u32 module id | u32 detail
+ *
+ * STRING records define a module id (in module id) for the rest of the
+ * segment, so every segment decodes on its own. DEBUG_EVENT carries the
+ * event type in detail and u32 pid | u32 tid | u32 length, description |
+ * u32 count, (u32 length, key | u32 length, value) pairs as payload.
+ * MEMORY_DUMP carries the dump's full size in detail and its bytes, cut to
+ * max_dump_bytes, as payload.
+ */
+enum class TraceRecordType : uint16_t {
+    STRING = 1,
+    DEBUG_EVENT = 2,
+    MEMORY_DUMP = 3
+};
+
+constexpr uint16_t kTraceFlagTruncated = 1;   // Payload shorter than the dump it came from
+constexpr size_t kTraceFileHeaderSize = 16;
+constexpr size_t kTraceRecordHeaderSize = 32;
+
+struct TraceOptions {
+    std::string path;                             // Rotated segments become path.0, path.1, ...
+    size_t max_segment_bytes = 64 * 1024 * 1024;
+    int max_segments = 10;                        // Older rotated segments are removed
+    size_t max_dump_bytes = 64 * 1024;
+};
+
+/**
+ * @brief Append-only binary trace of debug events and memory dumps
+ *
+ * Records are written as they come, without any text formatting; module
+ * names are interned once per segment. Segments rotate the way the text
+ * log does. Safe to call from any thread.
+ */
+class TraceSink {
+public:
+    struct Stats {
+        uint64_t events = 0;
+        uint64_t dumps = 0;
+        uint64_t bytes = 0;       // Across every segment, headers included
+        uint64_t rotations = 0;
+    };
+
+    explicit TraceSink(TraceOptions options);
+    ~TraceSink();
+    TraceSink(const TraceSink&) = delete;
+    TraceSink& operator=(const TraceSink&) = delete;
+
+    Result<void> Open();
+    bool IsOpen() const;
+
+    void WriteEvent(const DebugEvent& event);
+    void WriteMemoryDump(const MemoryView& dump,
+                         std::chrono::system_clock::time_point timestamp = std::chrono::system_clock::now());
+    void Flush();
+
+    const std::string& GetPath() const { return options_.path; }
+    Stats GetStats() const;
+
+private:
+    TraceOptions options_;
+    mutable std::mutex mutex_;
+    std::ofstream file_;
+    size_t segment_bytes_ = 0;
+    int segment_index_ = 0;
+    std::unordered_map<std::string, uint32_t> module_ids_;  // This segment's dictionary
+    std::vector<uint8_t> payload_;                          // Reused between records
+    std::vector<uint8_t> header_;
+    Stats stats_;
+
+    Result<void> OpenSegmentUnsafe();
+    void RotateUnsafe();
+    // Also rotates first when the name's definition and the record would not fit
+    uint32_t InternUnsafe(const std::string& name, int64_t timestamp, size_t record_payload);
+    void WriteRecordUnsafe(TraceRecordType type, uint16_t flags, int64_t timestamp, uint64_t address,
+                           uint32_t module_id, uint32_t detail, const uint8_t* payload, size_t size);
+};
+
+// One decoded record with its module id already resolved
+struct TraceRecord {
+    TraceRecordType type = TraceRecordType::STRING;
+    uint16_t flags = 0;
+    std::chrono::system_clock::time_point timestamp;
+    uint64_t address = 0;
+    std::string module_name;
+    uint32_t detail = 0;
+
+    // DEBUG_EVENT
+    uint32_t process_id = 0;
+    uint32_t thread_id = 0;
+    std::string description;
+    std::vector<std::pair<std::string, std::string>> metadata;
+
+    // MEMORY_DUMP
+    std::vector<uint8_t> data;
+};
+
+/**
+ * @brief Reads one trace segment back, for the offline decoder and tests
+ */
+class TraceReader {
+public:
+    Result<void> Open(const std::string& path);
+    // False at a clean end of segment; an error for a torn or corrupt record
+    Result<bool> Next(TraceRecord& record);
+
+    // One line per record, in the text log's style; at most hex_bytes of a dump are shown
+    static std::string Format(const TraceRecord& record, size_t hex_bytes = 32);
+
+private:
+    std::ifstream file_;
+    std::unordered_map<uint32_t, std::string> modules_;
+    std::vector<uint8_t> payload_;
+};
+
+} // namespace mcp
@@ -0,0 +1,360 @@
+#include "sexpr_arena.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+
+namespace mcp {
+
+namespace {
+
+// Same limits as SExprParser::Parse
+constexpr size_t MAX_EXPRESSION_SIZE = 1024 * 1024;
+constexpr size_t MAX_RECURSION_DEPTH = 100;
+constexpr size_t MAX_LIST_ELEMENTS = 10000;
+constexpr size_t MAX_STRING_LENGTH = 64 * 1024;
+
+bool IsWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool IsDigit(char c) {
+    return std::isdigit(static_cast<unsigned char>(c)) != 0;
+}
+
+bool IsSymbolChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' || c == '+' || c == '*' ||
+           c == '/' || c == '=' || c == '<' || c == '>' || c == '?' || c == '!';
+}
+
+} // anonymous namespace
+
+BumpArena::BumpArena(size_t block_size) : block_size_(std::max<size_t>(block_size, 256)) {}
+
+void* BumpArena::Allocate(size_t size, size_t alignment) {
+    size = std::max<size_t>(size, 1);
+    auto aligned = [alignment](char* pointer) {
+        const auto address = reinterpret_cast<uintptr_t>(pointer);
+        return reinterpret_cast<char*>((address + alignment - 1) & ~(uintptr_t(alignment) - 1));
+    };
+
+    char* start = cursor_ ? aligned(cursor_) : nullptr;
+    if (!start || start + size > limit_) {
+        const size_t needed = size + alignment;
+        if (needed > block_size_ / 2) {
+            // Oversized requests get their own block and leave the current one open
+            Block block{std::make_unique<char[]>(needed), needed};
+            char* own = aligned(block.data.get());
+            blocks_.insert(blocks_.empty() ? blocks_.end() : blocks_.end() - 1, std::move(block));
+            used_ += size;
+            return own;
+        }
+        blocks_.push_back({std::make_unique<char[]>(block_size_), block_size_});
+        cursor_ = blocks_.back().data.get();
+        limit_ = cursor_ + block_size_;
+        start = aligned(cursor_);
+    }
+    cursor_ = start + size;
+    used_ += size;
+    return start;
+}
+
+std::string_view BumpArena::CopyString(std::string_view text) {
+    if (text.empty()) {
+        return {};
+    }
+    char* copy = static_cast<char*>(Allocate(text.size(), 1));
+    std::memcpy(copy, text.data(), text.size());
+    return std::string_view(copy, text.size());
+}
+
+void BumpArena::Reset() {
+    // Oversized blocks sit in front of the current one, so keep a regular block if there is one
+    auto regular = std::find_if(blocks_.begin(), blocks_.end(),
+                                [this](const Block& block) { return block.size == block_size_; });
+    if (regular == blocks_.end()) {
+        blocks_.clear();
+        cursor_ = limit_ = nullptr;
+    } else {
+        Block keep = std::move(*regular);
+        blocks_.clear();
+        blocks_.push_back(std::move(keep));
+        cursor_ = blocks_.back().data.get();
+        limit_ = cursor_ + block_size_;
+    }
+    used_ = 0;
+}
+
+uint32_t SymbolTable::Intern(std::string_view name) {
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    const auto id = static_cast<uint32_t>(names_.size());
+    names_.emplace_back(name);
+    ids_.emplace(names_.back(), id);
+    return id;
+}
+
+const uint32_t* SymbolTable::Find(std::string_view name) const {
+    auto it = ids_.find(name);
+    return it == ids_.end() ? nullptr : &it->second;
+}
+
+SExpression AstDocument::ToSExpression() const {
+    return root_ ? mcp::ToSExpression(*root_) : SExpression{};
+}
+
+SExpression ToSExpression(const AstNode& node) {
+    SExpression expr;
+    switch (node.kind) {
+        case AstNode::Kind::SYMBOL:
+        case AstNode::Kind::STRING:
+            expr.value = std::string(node.text);
+            break;
+        case AstNode::Kind::INTEGER:
+            expr.value = node.integer;
+            break;
+        case AstNode::Kind::FLOAT:
+            expr.value = node.number;
+            break;
+        case AstNode::Kind::BOOLEAN:
+            expr.value = node.boolean;
+            break;
+        case AstNode::Kind::LIST: {
+            std::vector<SExpression> items;
+            items.reserve(node.count);
+            for (const AstNode& item : node) {
+                items.push_back(ToSExpression(item));
+            }
+            expr.value = std::move(items);
+            break;
+        }
+    }
+    return expr;
+}
+
+Result<AstDocument> AstBuilder::Parse(std::string_view source) {
+    if (source.size() > MAX_EXPRESSION_SIZE) {
+        return Result<AstDocument>::Error("Expression too large (max 1MB)");
+    }
+
+    AstDocument document;
+    // One copy of the source backs every atom, however many there are
+    document.source_ = document.arena_.CopyString(source);
+    document_ = &document;
+    input_ = document.source_;
+    pos_ = 0;
+    depth_ = 0;
+    stack_.clear();
+
+    SkipWhitespace();
+    if (IsEnd()) {
+        return Result<AstDocument>::Error("Empty expression");
+    }
+    auto result = ParseExpression();
+    document_ = nullptr;
+    if (!result.IsSuccess()) {
+        return Result<AstDocument>::Error(result.Error());
+    }
+
+    AstNode* root = document.arena_.AllocateArray<AstNode>(1);
+    *root = stack_.back();
+    stack_.clear();
+    document.root_ = root;
+    return Result<AstDocument>::Success(std::move(document));
+}
+
+Result<void> AstBuilder::ParseExpression() {
+    if (++depth_ > MAX_RECURSION_DEPTH) {
+        --depth_;
+        return Result<void>::Error("Maximum recursion depth exceeded (100 levels)");
+    }
+    SkipWhitespace();
+    Result<void> result = IsEnd() ? Result<void>::Error("Unexpected end of input")
+                        : CurrentChar() == '(' ? ParseList() : ParseAtom();
+    --depth_;
+    if (result.IsSuccess()) {
+        ++document_->node_count_;
+    }
+    return result;
+}
+
+Result<void> AstBuilder::ParseList() {
+    ++pos_;  // Skip '('
+    SkipWhitespace();
+
+    const size_t first = stack_.size();
+    while (!IsEnd() && CurrentChar() != ')') {
+        if (stack_.size() - first >= MAX_LIST_ELEMENTS) {
+            return Result<void>::Error("List too large (max 10000 elements)");
+        }
+        auto element = ParseExpression();
+        if (!element.IsSuccess()) {
+            return element;
+        }
+        SkipWhitespace();
+    }
+    if (IsEnd()) {
+        return Result<void>::Error("Missing closing ')'");
+    }
+    ++pos_;  // Skip ')'
+
+    // Children are final now, so they move into the arena side by side
+    AstNode list;
+    list.kind = AstNode::Kind::LIST;
+    list.count = static_cast<uint32_t>(stack_.size() - first);
+    list.items = nullptr;
+    if (list.count > 0) {
+        AstNode* items = document_->arena_.AllocateArray<AstNode>(list.count);
+        std::copy(stack_.begin() + static_cast<std::ptrdiff_t>(first), stack_.end(), items);
+        list.items = items;
+    }
+    stack_.resize(first);
+    stack_.push_back(list);
+    return Result<void>::Success();
+}
+
+Result<void> AstBuilder::ParseAtom() {
+    const char c = CurrentChar();
+    if (c == '"') {
+        return ParseString();
+    }
+
+    AstNode atom;
+    if (IsDigit(c) || c == '-' || c == '+') {
+        const size_t start = pos_;
+        if (c == '-' || c == '+') {
+            ++pos_;
+        }
+        bool has_dot = false;
+        while (!IsEnd() && (IsDigit(CurrentChar()) || CurrentChar() == '.')) {
+            if (CurrentChar() == '.') {
+                if (has_dot) break;
+                has_dot = true;
+            }
+            ++pos_;
+        }
+
+        std::string_view number = input_.substr(start, pos_ - start);
+        if (number == "-" || number == "+") {
+            pos_ = start;  // A lone sign is a symbol such as + or -foo
+        } else if (has_dot) {
+            try {
+                atom.kind = AstNode::Kind::FLOAT;
+                atom.number = std::stod(std::string(number));
+            } catch (...) {
+                return Result<void>::Error("Invalid float: " + std::string(number));
+            }
+            stack_.push_back(atom);
+            return Result<void>::Success();
+        } else {
+            if (number.size() > 18) {
+                return Result<void>::Error("Integer too large: " + std::string(number));
+            }
+            std::string_view digits = number.front() == '+' ? number.substr(1) : number;
+            int64_t value = 0;
+            auto parsed = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+            if (parsed.ec != std::errc() || parsed.ptr != digits.data() + digits.size()) {
+                return Result<void>::Error("Invalid integer: " + std::string(number));
+            }
+            atom.kind = AstNode::Kind::INTEGER;
+            atom.integer = value;
+            stack_.push_back(atom);
+            return Result<void>::Success();
+        }
+    }
+
+    std::string_view symbol = ScanSymbol();
+    if (symbol.empty()) {
+        return Result<void>::Error("Empty symbol");
+    }
+    if (symbol == "true" || symbol == "#t" || symbol == "false" || symbol == "#f") {
+        atom.kind = AstNode::Kind::BOOLEAN;
+        atom.boolean = symbol == "true" || symbol == "#t";
+    } else {
+        atom.kind = AstNode::Kind::SYMBOL;
+        atom.symbol = symbols_.Intern(symbol);
+        atom.text = symbol;
+    }
+    stack_.push_back(atom);
+    return Result<void>::Success();
+}
+
+Result<void> AstBuilder::ParseString() {
+    ++pos_;  // Skip opening quote
+    const size_t start = pos_;
+    bool escaped_any = false;
+    scratch_.clear();
+
+    while (!IsEnd() && CurrentChar() != '"') {
+        if (pos_ - start >= MAX_STRING_LENGTH) {
+            return Result<void>::Error("String too long (max 64KB)");
+        }
+        const char c = CurrentChar();
+        if (c < 32 && c != '\t' && c != '\n' && c != '\r') {
+            return Result<void>::Error("Invalid control character in string");
+        }
+        if (c != '\\') {
+            if (escaped_any) {
+                scratch_ += c;
+            }
+            ++pos_;
+            continue;
+        }
+
+        if (!escaped_any) {
+            scratch_.assign(input_.substr(start, pos_ - start));
+            escaped_any = true;
+        }
+        ++pos_;
+        if (IsEnd()) {
+            return Result<void>::Error("Unterminated string escape");
+        }
+        const char escaped = CurrentChar();
+        switch (escaped) {
+            case 'n': scratch_ += '\n'; break;
+            case 't': scratch_ += '\t'; break;
+            case 'r': scratch_ += '\r'; break;
+            case '\\': scratch_ += '\\'; break;
+            case '"': scratch_ += '"'; break;
+            case '0': scratch_ += '\0'; break;
+            default:
+                if (escaped >= 32 && escaped <= 126) {
+                    scratch_ += '\\';
+                    scratch_ += escaped;
+                } else {
+                    return Result<void>::Error("Invalid escape sequence");
+                }
+                break;
+        }
+        ++pos_;
+    }
+    if (IsEnd()) {
+        return Result<void>::Error("Unterminated string");
+    }
+
+    AstNode atom;
+    atom.kind = AstNode::Kind::STRING;
+    // Plain strings view the source; only escaped ones need arena space
+    atom.text = escaped_any ? document_->arena_.CopyString(scratch_) : input_.substr(start, pos_ - start);
+    ++pos_;  // Skip closing quote
+    stack_.push_back(atom);
+    return Result<void>::Success();
+}
+
+std::string_view AstBuilder::ScanSymbol() {
+    const size_t start = pos_;
+    while (!IsEnd() && IsSymbolChar(CurrentChar())) {
+        ++pos_;
+    }
+    return input_.substr(start, pos_ - start);
+}
+
+void AstBuilder::SkipWhitespace() {
+    while (!IsEnd() && IsWhitespace(CurrentChar())) {
+        ++pos_;
+    }
+}
+
+} // namespace mcp
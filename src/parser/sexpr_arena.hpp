@@ -0,0 +1,171 @@
+#pragma once
+
+#include "mcp/interfaces.hpp"
+#include "mcp/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace mcp {
+
+/**
+ * @brief Bump allocator that frees everything it handed out at once
+ *
+ * Allocations are carved from blocks of block_size bytes; larger requests
+ * get a block of their own. Nothing is destroyed individually, so only
+ * trivially destructible objects may live here.
+ */
+class BumpArena {
+public:
+    explicit BumpArena(size_t block_size = 64 * 1024);
+    BumpArena(BumpArena&&) noexcept = default;
+    BumpArena& operator=(BumpArena&&) noexcept = default;
+    BumpArena(const BumpArena&) = delete;
+    BumpArena& operator=(const BumpArena&) = delete;
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template<typename T>
+    T* AllocateArray(size_t count) {
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    std::string_view CopyString(std::string_view text);
+
+    // Keeps the first block for reuse and drops the rest
+    void Reset();
+
+    size_t GetBytesUsed() const { return used_; }
+    size_t GetBlockCount() const { return blocks_.size(); }
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size = 0;
+    };
+
+    std::vector<Block> blocks_;
+    char* cursor_ = nullptr;
+    char* limit_ = nullptr;
+    size_t block_size_;
+    size_t used_ = 0;
+};
+
+/**
+ * @brief Symbol names interned to dense integer ids
+ *
+ * Ids stay valid for the lifetime of the table, so documents parsed at
+ * different times agree on them.
+ */
+class SymbolTable {
+public:
+    uint32_t Intern(std::string_view name);
+    // Null when the name was never interned
+    const uint32_t* Find(std::string_view name) const;
+    const std::string& Name(uint32_t id) const { return names_[id]; }
+    size_t Size() const { return names_.size(); }
+
+private:
+    std::deque<std::string> names_;                         // Stable addresses back the map's keys
+    std::unordered_map<std::string_view, uint32_t> ids_;
+};
+
+/**
+ * @brief One node of an arena-backed syntax tree
+ *
+ * Trivially copyable; a list's children sit next to each other in the
+ * arena. Symbol and string text views the document's copy of the source,
+ * or the arena when a string had escapes to undo.
+ */
+struct AstNode {
+    enum class Kind : uint8_t {
+        SYMBOL,
+        STRING,
+        INTEGER,
+        FLOAT,
+        BOOLEAN,
+        LIST
+    };
+
+    Kind kind = Kind::LIST;
+    uint32_t symbol = 0;       // SYMBOL
+    uint32_t count = 0;        // LIST
+    union {
+        int64_t integer = 0;
+        double number;
+        bool boolean;
+        const AstNode* items;  // LIST
+    };
+    std::string_view text;     // SYMBOL and STRING
+
+    bool IsList() const { return kind == Kind::LIST; }
+    const AstNode* begin() const { return kind == Kind::LIST ? items : nullptr; }
+    const AstNode* end() const { return kind == Kind::LIST ? items + count : nullptr; }
+    const AstNode& operator[](size_t index) const { return items[index]; }
+};
+
+/**
+ * @brief Parsed expression whose nodes and source live in one arena
+ *
+ * Moving the document keeps every node where it is; destroying (or
+ * re-parsing into) it releases the whole tree in one step.
+ */
+class AstDocument {
+public:
+    AstDocument() = default;
+    AstDocument(AstDocument&&) noexcept = default;
+    AstDocument& operator=(AstDocument&&) noexcept = default;
+
+    const AstNode* Root() const { return root_; }
+    std::string_view Source() const { return source_; }
+    size_t GetNodeCount() const { return node_count_; }
+    size_t GetBytesUsed() const { return arena_.GetBytesUsed(); }
+
+    // Owning copy for code that still takes SExpression
+    SExpression ToSExpression() const;
+
+private:
+    friend class AstBuilder;
+
+    BumpArena arena_;
+    const AstNode* root_ = nullptr;
+    std::string_view source_;
+    size_t node_count_ = 0;
+};
+
+SExpression ToSExpression(const AstNode& node);
+
+/**
+ * @brief Parses into an AstDocument with the same grammar and limits as SExprParser::Parse
+ */
+class AstBuilder {
+public:
+    explicit AstBuilder(SymbolTable& symbols) : symbols_(symbols) {}
+
+    Result<AstDocument> Parse(std::string_view source);
+
+private:
+    SymbolTable& symbols_;
+    AstDocument* document_ = nullptr;
+    std::string_view input_;
+    size_t pos_ = 0;
+    size_t depth_ = 0;
+    std::vector<AstNode> stack_;     // Children of the lists still open
+    std::string scratch_;            // Unescaped string contents
+
+    Result<void> ParseExpression();
+    Result<void> ParseList();
+    Result<void> ParseAtom();
+    Result<void> ParseString();
+    std::string_view ScanSymbol();
+    void SkipWhitespace();
+    bool IsEnd() const { return pos_ >= input_.size(); }
+    char CurrentChar() const { return IsEnd() ? '\0' : input_[pos_]; }
+};
+
+} // namespace mcp
@@ -0,0 +1,108 @@
+#include "sexpr_compiler.hpp"
+#include <algorithm>
+
+namespace mcp {
+
+void BytecodeCompiler::Compile(CompiledExpression& program) {
+    program_ = &program;
+    symbol_slots_.clear();
+    if (program.document.Root()) {
+        CompileNode(*program.document.Root());
+    }
+
+    // Measured on the final code, since folding removed pushes
+    size_t depth = 0;
+    program.max_stack = 0;
+    for (const Instruction& instruction : program.code) {
+        switch (instruction.op) {
+            case Instruction::Op::PUSH_CONST:
+            case Instruction::Op::LOAD:
+                ++depth;
+                break;
+            case Instruction::Op::CALL:
+                depth = depth - instruction.b + 1;
+                break;
+            case Instruction::Op::CALL_VALUE:
+                depth -= instruction.b;  // Arguments and head make way for the result
+                break;
+        }
+        program.max_stack = std::max(program.max_stack, depth);
+    }
+    program.bindings.assign(program.slot_symbols.size(), {});
+    program_ = nullptr;
+}
+
+bool BytecodeCompiler::CompileNode(const AstNode& node) {
+    CompiledExpression& program = *program_;
+    if (node.kind == AstNode::Kind::SYMBOL) {
+        program.code.push_back({Instruction::Op::LOAD, SlotFor(node.symbol)});
+        return false;
+    }
+    if (node.kind != AstNode::Kind::LIST || node.count == 0) {
+        program.code.push_back({Instruction::Op::PUSH_CONST, AddConstant(ToSExpression(node))});
+        return true;
+    }
+
+    const AstNode& head = node[0];
+    const bool symbol_head = head.kind == AstNode::Kind::SYMBOL;
+    if (!symbol_head) {
+        CompileNode(head);
+    }
+
+    const size_t code_mark = program.code.size();
+    const size_t constant_mark = program.constants.size();
+    bool constant_args = true;
+    for (size_t i = 1; i < node.count; ++i) {
+        constant_args = CompileNode(node[i]) && constant_args;
+    }
+    const uint32_t argc = node.count - 1;
+
+    const ExprFunction* pure = symbol_head && constant_args ? pure_(head.symbol) : nullptr;
+    if (pure) {
+        std::vector<SExpression> args;
+        args.reserve(argc);
+        for (size_t i = code_mark; i < program.code.size(); ++i) {
+            args.push_back(program.constants[program.code[i].a]);
+        }
+        auto folded = (*pure)(args);
+        if (folded.IsSuccess()) {
+            // The argument constants were only used by the instructions being replaced
+            program.code.resize(code_mark);
+            program.constants.resize(constant_mark);
+            if (std::find(program.folded_heads.begin(), program.folded_heads.end(), head.symbol) ==
+                program.folded_heads.end()) {
+                program.folded_heads.push_back(head.symbol);
+            }
+            program.code.push_back({Instruction::Op::PUSH_CONST, AddConstant(folded.TakeValue())});
+            return true;
+        }
+    }
+
+    if (symbol_head) {
+        program.code.push_back({Instruction::Op::CALL, SlotFor(head.symbol), argc});
+    } else {
+        program.code.push_back({Instruction::Op::CALL_VALUE, 0, argc});
+    }
+    return false;
+}
+
+uint32_t BytecodeCompiler::AddConstant(SExpression value) {
+    program_->constants.push_back(std::move(value));
+    return static_cast<uint32_t>(program_->constants.size() - 1);
+}
+
+uint32_t BytecodeCompiler::SlotFor(uint32_t symbol) {
+    if (symbol >= symbol_slots_.size()) {
+        symbol_slots_.resize(symbol + 1, 0);
+    }
+    if (symbol_slots_[symbol] == 0) {
+        SExpression name;
+        name.value = symbols_.Name(symbol);
+        program_->slot_names.push_back(AddConstant(std::move(name)));
+        program_->slot_symbols.push_back(symbol);
+        symbol_slots_[symbol] = static_cast<uint32_t>(program_->slot_symbols.size());
+    }
+    return symbol_slots_[symbol] - 1;
+}
+
+} // namespace mcp
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "mcp/interfaces.hpp"
+#include "mcp/types.hpp"
+#include "sexpr_arena.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace mcp {
+
+using ExprFunction = std::function<Result<SExpression>(const std::vector<SExpression>&)>;
+
+struct Instruction {
+    enum class Op : uint8_t {
+        PUSH_CONST,   // a = constant
+        LOAD,         // a = slot; pushes the variable, or the symbol's name when it is not one
+        CALL,         // a = slot of the head symbol, b = argument count
+        CALL_VALUE    // b = argument count; the head was evaluated below the arguments
+    };
+
+    Op op;
+    uint32_t a = 0;
+    uint32_t b = 0;
+};
+
+/**
+ * @brief Bytecode for one expression, plus the bindings it was last linked against
+ *
+ * Every symbol the code refers to gets a slot. Linking resolves slots to
+ * the parser's variables and functions once; it is redone only after they
+ * change, so running the code again performs no name lookups at all.
+ */
+struct CompiledExpression {
+    struct Binding {
+        const SExpression* variable = nullptr;
+        const ExprFunction* function = nullptr;
+    };
+
+    std::string source;
+    AstDocument document;                 // Evaluated directly when the folding no longer holds
+    std::vector<Instruction> code;
+    std::vector<SExpression> constants;
+    std::vector<uint32_t> slot_symbols;
+    std::vector<uint32_t> slot_names;     // Constant holding each slot's name
+    std::vector<uint32_t> folded_heads;   // Symbols whose calls were evaluated at compile time
+    size_t max_stack = 0;
+    uint64_t functions_generation = 0;    // Functions the folding was done with
+
+    mutable std::vector<Binding> bindings;
+    mutable const void* linked_by = nullptr;
+    mutable uint64_t linked_generation = 0;
+    mutable bool use_tree = false;        // A folded name became a variable
+};
+
+/**
+ * @brief Translates an AstDocument into CompiledExpression bytecode
+ *
+ * Calls to pure functions whose arguments are all constants are folded
+ * into a single constant; the call is kept when folding fails, so its
+ * error still surfaces when the code runs.
+ */
+class BytecodeCompiler {
+public:
+    // Null when the symbol does not name a pure function that may be folded
+    using PureLookup = std::function<const ExprFunction*(uint32_t symbol)>;
+
+    BytecodeCompiler(const SymbolTable& symbols, PureLookup pure) : symbols_(symbols), pure_(std::move(pure)) {}
+
+    void Compile(CompiledExpression& program);
+
+private:
+    const SymbolTable& symbols_;
+    PureLookup pure_;
+    CompiledExpression* program_ = nullptr;
+    std::vector<uint32_t> symbol_slots_;  // Symbol id -> slot + 1
+
+    // Returns true when node compiled to a single PUSH_CONST
+    bool CompileNode(const AstNode& node);
+    uint32_t AddConstant(SExpression value);
+    uint32_t SlotFor(uint32_t symbol);
+};
+
+} // namespace mcp
@@ -1,12 +1,33 @@
 #include "sexpr_parser.hpp"
+#include "mcp/hex_codec.hpp"
 #include <cctype>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
 #include <limits>
+#include <iterator>
 
 namespace mcp {
 
+namespace {
+
+constexpr size_t MAX_COMPILED_EXPRESSIONS = 256;
+
+uint64_t HashSource(std::string_view source) {
+    uint64_t hash = 14695981039346656037ull;  // FNV-1a
+    for (unsigned char c : source) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    return hash;
+}
+
+const std::unordered_map<std::string, SExpression>& NoContext() {
+    static const std::unordered_map<std::string, SExpression> empty;
+    return empty;
+}
+
+} // anonymous namespace
+
 SExprParser::SExprParser() {
     RegisterBuiltinFunctions();
 }
@@ -34,7 +55,7 @@ Result<std::string> SExprParser::Serialize(const SExpression& expr) {
     if (expr.IsAtom()) {
         return Result<std::string>::Success(SerializeAtom(expr));
     } else {
-        std::vector<SExpression> list = std::get<std::vector<SExpression>>(expr.value);
+        const auto& list = std::get<std::vector<SExpression>>(expr.value);
         return Result<std::string>::Success(SerializeList(list));
     }
 }
@@ -43,8 +64,7 @@ Result<SExpression> SExprParser::Evaluate(const SExpression& expr) {
     if (expr.IsAtom()) {
         // Check if it's a variable reference
         if (std::holds_alternative<std::string>(expr.value)) {
-            std::string symbol = std::get<std::string>(expr.value);
-            auto var_result = LookupVariable(symbol);
+            auto var_result = LookupVariable(std::get<std::string>(expr.value));
             if (var_result.IsSuccess()) {
                 return var_result;
             }
@@ -54,17 +74,38 @@ Result<SExpression> SExprParser::Evaluate(const SExpression& expr) {
     }
     
     // Evaluate list
-    std::vector<SExpression> list = std::get<std::vector<SExpression>>(expr.value);
-    return EvaluateList(list);
+    return EvaluateList(std::get<std::vector<SExpression>>(expr.value));
+}
+
+Result<AstDocument> SExprParser::ParseDocument(std::string_view expr) {
+    return AstBuilder(symbols_).Parse(expr);
+}
+
+Result<SExpression> SExprParser::Evaluate(const AstNode& node) {
+    if (node.kind == AstNode::Kind::LIST) {
+        return EvaluateList(node);
+    }
+    if (node.kind == AstNode::Kind::SYMBOL) {
+        // Interned names are looked up without building a key string
+        auto it = variables_.find(symbols_.Name(node.symbol));
+        if (it != variables_.end()) {
+            return Result<SExpression>::Success(it->second);
+        }
+    }
+    return Result<SExpression>::Success(ToSExpression(node));
 }
 
 void SExprParser::RegisterFunction(const std::string& name, 
                                   std::function<Result<SExpression>(const std::vector<SExpression>&)> func) {
     functions_[name] = func;
+    pure_functions_.erase(name);  // Replacements are not assumed to be pure
+    ++functions_generation_;
+    ++bindings_generation_;
 }
 
 void SExprParser::RegisterVariable(const std::string& name, const SExpression& value) {
     variables_[name] = value;
+    ++bindings_generation_;
 }
 
 Result<SExpression> SExprParser::EvaluateInContext(const SExpression& expr, 
@@ -74,11 +115,13 @@ Result<SExpression> SExprParser::EvaluateInContext(const SExpression& expr,
     for (const auto& [name, value] : context) {
         variables_[name] = value;
     }
+    ++bindings_generation_;
     
     auto result = Evaluate(expr);
     
     // Restore original variables
     variables_ = old_variables;
+    ++bindings_generation_;
     
     return result;
 }
@@ -92,6 +135,14 @@ Result<SExpression> SExprParser::ParseMemoryExpression(const std::string& expr,
     return Parse(expr);
 }
 
+void SExprParser::SetMemoryReader(MemoryReader reader) {
+    memory_reader_ = std::move(reader);
+}
+
+void SExprParser::SetMemoryBatchReader(MemoryBatchReader reader) {
+    memory_batch_reader_ = std::move(reader);
+}
+
 Result<std::string> SExprParser::FormatDebugOutput(const SExpression& expr) {
     std::ostringstream oss;
     
@@ -179,8 +230,9 @@ Result<SExpression> SExprParser::ParseAtom() {
         
         if (num_str.empty() || num_str == "-" || num_str == "+") {
             pos_ = start_pos;
-            return ParseSymbol().IsSuccess() ? 
-                Result<SExpression>::Success(SExpression{{ParseSymbol().Value()}}) :
+            auto sign_symbol = ParseSymbol();
+            return sign_symbol.IsSuccess() ?
+                Result<SExpression>::Success(SExpression{{sign_symbol.TakeValue()}}) :
                 Result<SExpression>::Error("Invalid symbol");
         }
         
@@ -377,21 +429,271 @@ Result<SExpression> SExprParser::EvaluateList(const std::vector<SExpression>& li
         return Result<SExpression>::Error("First element of list must be a function name");
     }
     
-    std::string func_name = std::get<std::string>(func_result.Value().value);
+    const std::string& func_name = std::get<std::string>(func_result.Value().value);
     
     // Evaluate arguments
     std::vector<SExpression> args;
+    args.reserve(list.size() - 1);
     for (size_t i = 1; i < list.size(); ++i) {
         auto arg_result = Evaluate(list[i]);
         if (!arg_result.IsSuccess()) {
             return arg_result;
         }
-        args.push_back(arg_result.Value());
+        args.push_back(arg_result.TakeValue());
     }
     
     return ApplyFunction(func_name, args);
 }
 
+Result<SExpression> SExprParser::EvaluateList(const AstNode& list) {
+    if (list.count == 0) {
+        SExpression expr;
+        expr.value = std::vector<SExpression>{};
+        return Result<SExpression>::Success(expr);
+    }
+
+    // Same rules as the SExpression path: a variable may name the function
+    const AstNode& head = list[0];
+    auto function = functions_.end();
+    if (head.kind == AstNode::Kind::SYMBOL && variables_.find(symbols_.Name(head.symbol)) == variables_.end()) {
+        function = functions_.find(symbols_.Name(head.symbol));
+        if (function == functions_.end()) {
+            return Result<SExpression>::Error("Unknown function: " + symbols_.Name(head.symbol));
+        }
+    } else {
+        auto func_result = Evaluate(head);
+        if (!func_result.IsSuccess()) {
+            return func_result;
+        }
+        if (!std::holds_alternative<std::string>(func_result.Value().value)) {
+            return Result<SExpression>::Error("First element of list must be a function name");
+        }
+        const std::string& func_name = std::get<std::string>(func_result.Value().value);
+        function = functions_.find(func_name);
+        if (function == functions_.end()) {
+            return Result<SExpression>::Error("Unknown function: " + func_name);
+        }
+    }
+
+    std::vector<SExpression> args;
+    args.reserve(list.count - 1);
+    for (size_t i = 1; i < list.count; ++i) {
+        auto arg_result = Evaluate(list[i]);
+        if (!arg_result.IsSuccess()) {
+            return arg_result;
+        }
+        args.push_back(arg_result.TakeValue());
+    }
+    return function->second(args);
+}
+
+Result<std::shared_ptr<const CompiledExpression>> SExprParser::Compile(std::string_view source) {
+    auto document = ParseDocument(source);
+    if (!document.IsSuccess()) {
+        return Result<std::shared_ptr<const CompiledExpression>>::Error(document.Error());
+    }
+
+    auto program = std::make_shared<CompiledExpression>();
+    program->source = std::string(source);
+    program->document = document.TakeValue();
+    program->functions_generation = functions_generation_;
+    BytecodeCompiler compiler(symbols_, [this](uint32_t symbol) -> const ExprFunction* {
+        const std::string& name = symbols_.Name(symbol);
+        if (pure_functions_.count(name) == 0 || variables_.count(name) != 0) {
+            return nullptr;
+        }
+        auto it = functions_.find(name);
+        return it == functions_.end() ? nullptr : &it->second;
+    });
+    compiler.Compile(*program);
+    return Result<std::shared_ptr<const CompiledExpression>>::Success(std::move(program));
+}
+
+Result<SExpression> SExprParser::EvaluateCompiled(std::string_view source) {
+    return EvaluateCompiled(source, NoContext());
+}
+
+Result<SExpression> SExprParser::EvaluateCompiled(std::string_view source,
+                                                  const std::unordered_map<std::string, SExpression>& context) {
+    const uint64_t hash = HashSource(source);
+    auto it = compiled_.find(hash);
+    if (it != compiled_.end() && it->second->source == source &&
+        it->second->functions_generation == functions_generation_) {
+        ++compile_stats_.hits;
+        return Run(*it->second, context);
+    }
+
+    ++compile_stats_.misses;
+    auto compiled = Compile(source);
+    if (!compiled.IsSuccess()) {
+        return Result<SExpression>::Error(compiled.Error());
+    }
+    auto program = std::const_pointer_cast<CompiledExpression>(compiled.TakeValue());
+    if (it != compiled_.end()) {
+        it->second = program;  // Stale or colliding entry keeps its place in the order
+    } else {
+        if (compiled_.size() >= MAX_COMPILED_EXPRESSIONS) {
+            compiled_.erase(compiled_order_.front());
+            compiled_order_.pop_front();
+        }
+        compiled_.emplace(hash, program);
+        compiled_order_.push_back(hash);
+    }
+    return Run(*program, context);
+}
+
+SExprParser::CompileStats SExprParser::GetCompileStats() const {
+    CompileStats stats = compile_stats_;
+    stats.entries = compiled_.size();
+    return stats;
+}
+
+void SExprParser::Link(const CompiledExpression& program) {
+    for (size_t slot = 0; slot < program.slot_symbols.size(); ++slot) {
+        const std::string& name = symbols_.Name(program.slot_symbols[slot]);
+        auto variable = variables_.find(name);
+        auto function = functions_.find(name);
+        program.bindings[slot].variable = variable == variables_.end() ? nullptr : &variable->second;
+        program.bindings[slot].function = function == functions_.end() ? nullptr : &function->second;
+    }
+    program.use_tree = std::any_of(program.folded_heads.begin(), program.folded_heads.end(),
+                                   [this](uint32_t symbol) { return variables_.count(symbols_.Name(symbol)) != 0; });
+    program.linked_by = this;
+    program.linked_generation = bindings_generation_;
+    ++compile_stats_.relinks;
+}
+
+Result<SExpression> SExprParser::EvaluateTree(const CompiledExpression& program,
+                                              const std::unordered_map<std::string, SExpression>& context) {
+    if (!program.document.Root()) {
+        return Result<SExpression>::Error("Empty expression");
+    }
+    if (context.empty()) {
+        return Evaluate(*program.document.Root());
+    }
+    auto old_variables = variables_;
+    for (const auto& [name, value] : context) {
+        variables_[name] = value;
+    }
+    ++bindings_generation_;
+    auto result = Evaluate(*program.document.Root());
+    variables_ = std::move(old_variables);
+    ++bindings_generation_;
+    return result;
+}
+
+Result<SExpression> SExprParser::Run(const CompiledExpression& program) {
+    return Run(program, NoContext());
+}
+
+Result<SExpression> SExprParser::Run(const CompiledExpression& program,
+                                     const std::unordered_map<std::string, SExpression>& context) {
+    if (program.functions_generation != functions_generation_) {
+        return EvaluateTree(program, context);  // Folded with functions that have since been replaced
+    }
+    if (program.linked_by != this || program.linked_generation != bindings_generation_) {
+        Link(program);
+    }
+    if (program.use_tree || program.code.empty()) {
+        return EvaluateTree(program, context);
+    }
+
+    // Nested runs (a registered function evaluating again) stack above this one
+    const size_t base = vm_stack_.size();
+    struct StackGuard {
+        std::vector<SExpression>& stack;
+        size_t base;
+        ~StackGuard() { stack.resize(base); }
+    } guard{vm_stack_, base};
+    vm_stack_.reserve(base + program.max_stack);
+
+    const bool has_context = !context.empty();
+    const auto find_variable = [&](uint32_t slot) -> const SExpression* {
+        if (has_context) {
+            auto it = context.find(std::get<std::string>(program.constants[program.slot_names[slot]].value));
+            if (it != context.end()) {
+                return &it->second;
+            }
+        }
+        return program.bindings[slot].variable;
+    };
+    const auto call = [&](const ExprFunction& function, size_t argc) -> Result<SExpression> {
+        if (vm_depth_ == vm_args_.size()) {
+            vm_args_.emplace_back();
+        }
+        std::vector<SExpression>& args = vm_args_[vm_depth_];
+        args.clear();
+        const size_t first = vm_stack_.size() - argc;
+        std::move(vm_stack_.begin() + static_cast<std::ptrdiff_t>(first), vm_stack_.end(), std::back_inserter(args));
+        vm_stack_.resize(first);
+        ++vm_depth_;
+        auto result = function(args);
+        --vm_depth_;
+        return result;
+    };
+    const auto call_by_name = [&](const SExpression& head, size_t argc) -> Result<SExpression> {
+        if (!std::holds_alternative<std::string>(head.value)) {
+            return Result<SExpression>::Error("First element of list must be a function name");
+        }
+        const std::string& name = std::get<std::string>(head.value);
+        auto function = functions_.find(name);
+        if (function == functions_.end()) {
+            return Result<SExpression>::Error("Unknown function: " + name);
+        }
+        return call(function->second, argc);
+    };
+    // A call can change the parser's bindings (EvaluateInContext, RegisterFunction), leaving
+    // the slots pointing at replaced entries; resolve them again before the next instruction
+    const auto relink_after_call = [&]() {
+        if (program.linked_generation != bindings_generation_ || program.linked_by != this) {
+            Link(program);
+        }
+    };
+
+    for (const Instruction& instruction : program.code) {
+        switch (instruction.op) {
+            case Instruction::Op::PUSH_CONST:
+                vm_stack_.push_back(program.constants[instruction.a]);
+                break;
+            case Instruction::Op::LOAD: {
+                const SExpression* variable = find_variable(instruction.a);
+                vm_stack_.push_back(variable ? *variable : program.constants[program.slot_names[instruction.a]]);
+                break;
+            }
+            case Instruction::Op::CALL: {
+                Result<SExpression> result;
+                if (const SExpression* variable = find_variable(instruction.a)) {
+                    const SExpression head = *variable;  // The call may rebind it
+                    result = call_by_name(head, instruction.b);
+                } else if (const ExprFunction* function = program.bindings[instruction.a].function) {
+                    result = call(*function, instruction.b);
+                } else {
+                    return Result<SExpression>::Error(
+                        "Unknown function: " + std::get<std::string>(program.constants[program.slot_names[instruction.a]].value));
+                }
+                if (!result.IsSuccess()) {
+                    return result;
+                }
+                vm_stack_.push_back(result.TakeValue());
+                relink_after_call();
+                break;
+            }
+            case Instruction::Op::CALL_VALUE: {
+                const size_t head_index = vm_stack_.size() - instruction.b - 1;
+                const SExpression head = std::move(vm_stack_[head_index]);
+                auto result = call_by_name(head, instruction.b);
+                if (!result.IsSuccess()) {
+                    return result;
+                }
+                vm_stack_.back() = result.TakeValue();  // The head's slot
+                relink_after_call();
+                break;
+            }
+        }
+    }
+    return Result<SExpression>::Success(std::move(vm_stack_.back()));
+}
+
 Result<SExpression> SExprParser::ApplyFunction(const std::string& func_name, 
                                               const std::vector<SExpression>& args) {
     auto it = functions_.find(func_name);
@@ -500,8 +802,12 @@ void SExprParser::RegisterBuiltinFunctions() {
     
     // Debugging specific functions
     functions_["read-memory"] = [this](const std::vector<SExpression>& args) { return BuiltinReadMemory(args); };
+    functions_["read-memory-batch"] = [this](const std::vector<SExpression>& args) { return BuiltinReadMemoryBatch(args); };
     functions_["format-hex"] = [this](const std::vector<SExpression>& args) { return BuiltinFormatHex(args); };
     functions_["parse-pattern"] = [this](const std::vector<SExpression>& args) { return BuiltinParsePattern(args); };
+
+    // Depend on nothing but their arguments, so constant calls are folded by Compile
+    pure_functions_ = {"+", "-", "*", "/", "="};
 }
 
 Result<SExpression> SExprParser::BuiltinAdd(const std::vector<SExpression>& args) {
@@ -591,8 +897,85 @@ Result<SExpression> SExprParser::BuiltinCons(const std::vector<SExpression>& /*
     return Result<SExpression>::Error("Cons not implemented");
 }
 
-Result<SExpression> SExprParser::BuiltinReadMemory(const std::vector<SExpression>& /* args */) {
-    return Result<SExpression>::Error("ReadMemory not implemented");
+Result<SExpression> SExprParser::BuiltinReadMemory(const std::vector<SExpression>& args) {
+    // (read-memory address size) -> "4d 5a 90 ..."
+    if (args.size() != 2 || !std::holds_alternative<int64_t>(args[0].value) ||
+        !std::holds_alternative<int64_t>(args[1].value)) {
+        return Result<SExpression>::Error("read-memory requires integer address and size");
+    }
+    if (!memory_reader_) {
+        return Result<SExpression>::Error("read-memory: no memory source attached");
+    }
+
+    const int64_t size = std::get<int64_t>(args[1].value);
+    if (size < 0 || size > 4096) {
+        return Result<SExpression>::Error("read-memory size must be between 0 and 4096");
+    }
+
+    auto view_result = memory_reader_(static_cast<uintptr_t>(std::get<int64_t>(args[0].value)),
+                                      static_cast<size_t>(size));
+    if (!view_result.IsSuccess()) {
+        return Result<SExpression>::Error(view_result.Error());
+    }
+
+    const MemoryView& view = view_result.Value();
+    SExpression result;
+    result.value = HexEncode(view.data, view.size, {false, ' '});
+    result.type_hint = "memory";
+    return Result<SExpression>::Success(result);
+}
+
+Result<SExpression> SExprParser::BuiltinReadMemoryBatch(const std::vector<SExpression>& args) {
+    // (read-memory-batch addr1 size1 addr2 size2 ...) -> ("4d 5a ..." "50 45 ...")
+    if (args.empty() || args.size() % 2 != 0) {
+        return Result<SExpression>::Error("read-memory-batch requires address/size pairs");
+    }
+    if (!memory_batch_reader_ && !memory_reader_) {
+        return Result<SExpression>::Error("read-memory-batch: no memory source attached");
+    }
+
+    std::vector<MemoryRange> ranges;
+    ranges.reserve(args.size() / 2);
+    for (size_t i = 0; i < args.size(); i += 2) {
+        if (!std::holds_alternative<int64_t>(args[i].value) || !std::holds_alternative<int64_t>(args[i + 1].value)) {
+            return Result<SExpression>::Error("read-memory-batch requires integer addresses and sizes");
+        }
+        const int64_t size = std::get<int64_t>(args[i + 1].value);
+        if (size < 0 || size > 4096) {
+            return Result<SExpression>::Error("read-memory-batch sizes must be between 0 and 4096");
+        }
+        ranges.push_back({static_cast<uintptr_t>(std::get<int64_t>(args[i].value)), static_cast<size_t>(size)});
+    }
+
+    std::vector<MemoryView> views;
+    if (memory_batch_reader_) {
+        auto views_result = memory_batch_reader_(ranges);
+        if (!views_result.IsSuccess()) {
+            return Result<SExpression>::Error(views_result.Error());
+        }
+        views = views_result.TakeValue();
+    } else {
+        for (const MemoryRange& range : ranges) {
+            auto view_result = memory_reader_(range.address, range.size);
+            if (!view_result.IsSuccess()) {
+                return Result<SExpression>::Error(view_result.Error());
+            }
+            views.push_back(view_result.TakeValue());
+        }
+    }
+
+    std::vector<SExpression> items;
+    items.reserve(views.size());
+    for (const MemoryView& view : views) {
+        SExpression item;
+        item.value = HexEncode(view.data, view.size, {false, ' '});
+        item.type_hint = "memory";
+        items.push_back(std::move(item));
+    }
+
+    SExpression result;
+    result.value = std::move(items);
+    return Result<SExpression>::Success(result);
 }
 
 Result<SExpression> SExprParser::BuiltinFormatHex(const std::vector<SExpression>& /* args */) {
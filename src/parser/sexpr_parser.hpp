@@ -1,8 +1,15 @@
 #pragma once
 
 #include "mcp/interfaces.hpp"
+#include "mcp/memory_view.hpp"
 #include "mcp/types.hpp"
+#include "sexpr_arena.hpp"
+#include "sexpr_compiler.hpp"
+#include <deque>
+#include <memory>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <functional>
 
 namespace mcp {
@@ -26,12 +33,73 @@ public:
     Result<SExpression> EvaluateInContext(const SExpression& expr, 
                                          const std::unordered_map<std::string, SExpression>& context);
 
+    /**
+     * @brief Arena mode: parse into nodes that share one allocation pool
+     *
+     * Atoms view the document's single copy of the source and symbols are
+     * interned into this parser's table, so evaluating the document skips
+     * the per-node strings and vectors Parse builds.
+     */
+    Result<AstDocument> ParseDocument(std::string_view expr);
+    Result<SExpression> Evaluate(const AstNode& node);
+    const SymbolTable& GetSymbols() const { return symbols_; }
+
+    /**
+     * @brief Compiled mode: bytecode with call targets resolved ahead of time
+     *
+     * EvaluateCompiled caches the compiled form by a hash of the source, so
+     * a condition that runs on every breakpoint hit is parsed and compiled
+     * once. context is consulted before the registered variables, as in
+     * EvaluateInContext, but without copying them.
+     */
+    Result<std::shared_ptr<const CompiledExpression>> Compile(std::string_view source);
+    Result<SExpression> Run(const CompiledExpression& program);
+    Result<SExpression> Run(const CompiledExpression& program,
+                            const std::unordered_map<std::string, SExpression>& context);
+    Result<SExpression> EvaluateCompiled(std::string_view source);
+    Result<SExpression> EvaluateCompiled(std::string_view source,
+                                         const std::unordered_map<std::string, SExpression>& context);
+
+    struct CompileStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t relinks = 0;     // Bindings re-resolved after variables or functions changed
+        size_t entries = 0;
+    };
+    CompileStats GetCompileStats() const;
+
     // Utility functions for debugging
     Result<SExpression> ParseMemoryExpression(const std::string& expr, uintptr_t base_address);
 
+    // Source for the memory builtins; views are read in place, not copied into the parser
+    using MemoryReader = std::function<Result<MemoryView>(uintptr_t address, size_t size)>;
+    void SetMemoryReader(MemoryReader reader);
+
+    // Optional; read-memory-batch falls back to one memory reader call per range without it
+    using MemoryBatchReader = std::function<Result<std::vector<MemoryView>>(const std::vector<MemoryRange>& ranges)>;
+    void SetMemoryBatchReader(MemoryBatchReader reader);
+
 private:
     std::unordered_map<std::string, std::function<Result<SExpression>(const std::vector<SExpression>&)>> functions_;
     std::unordered_map<std::string, SExpression> variables_;
+    MemoryReader memory_reader_;
+    MemoryBatchReader memory_batch_reader_;
+    SymbolTable symbols_;
+
+    // Compiled mode state
+    std::unordered_set<std::string> pure_functions_;   // Builtins calls to which may be folded
+    std::unordered_map<uint64_t, std::shared_ptr<CompiledExpression>> compiled_;
+    std::deque<uint64_t> compiled_order_;               // Oldest entry is evicted first
+    uint64_t bindings_generation_ = 1;                  // Bumped whenever variables or functions change
+    uint64_t functions_generation_ = 1;
+    std::vector<SExpression> vm_stack_;                 // Shared by nested runs, each above the last
+    std::deque<std::vector<SExpression>> vm_args_;      // One argument buffer per nesting level
+    size_t vm_depth_ = 0;
+    CompileStats compile_stats_;
+
+    void Link(const CompiledExpression& program);
+    Result<SExpression> EvaluateTree(const CompiledExpression& program,
+                                     const std::unordered_map<std::string, SExpression>& context);
 
     // Parser state
     size_t pos_ = 0;
@@ -50,6 +118,7 @@ private:
 
     // Evaluation methods
     Result<SExpression> EvaluateList(const std::vector<SExpression>& list);
+    Result<SExpression> EvaluateList(const AstNode& list);
     Result<SExpression> ApplyFunction(const std::string& func_name, 
                                      const std::vector<SExpression>& args);
     Result<SExpression> LookupVariable(const std::string& name);
@@ -83,6 +152,7 @@ private:
 
     // Memory/debugging specific functions
     Result<SExpression> BuiltinReadMemory(const std::vector<SExpression>& args);
+    Result<SExpression> BuiltinReadMemoryBatch(const std::vector<SExpression>& args);
     Result<SExpression> BuiltinFormatHex(const std::vector<SExpression>& args);
     Result<SExpression> BuiltinParsePattern(const std::vector<SExpression>& args);
 
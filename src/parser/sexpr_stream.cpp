@@ -0,0 +1,210 @@
+#include "sexpr_stream.hpp"
+#include <string>
+
+namespace mcp {
+
+namespace {
+
+bool IsWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool IsDelimiter(char c) {
+    return IsWhitespace(c) || c == '(' || c == ')' || c == ';' || c == '"';
+}
+
+} // anonymous namespace
+
+SExprStreamParser::SExprStreamParser(size_t max_form_size) : max_form_size_(max_form_size) {}
+
+size_t SExprStreamParser::Feed(std::string_view chunk, const FormHandler& on_form) {
+    size_t forms = 0;
+    size_t start = std::string_view::npos;  // First byte of the form not yet copied into pending_
+    if (state_ == State::LIST || state_ == State::ATOM || state_ == State::COMMAND) {
+        start = in_comment_ || oversized_ ? std::string_view::npos : 0;
+    }
+
+    const auto copy_until = [&](size_t end) {
+        if (start != std::string_view::npos) {
+            pending_.append(chunk.data() + start, end - start);
+            start = std::string_view::npos;
+        }
+    };
+    const auto emit = [&](size_t end) {
+        std::string_view tail;
+        if (start != std::string_view::npos) {
+            tail = chunk.substr(start, end - start);
+        }
+        start = std::string_view::npos;
+        EmitForm(tail, on_form);
+        state_ = State::IDLE;
+        ++forms;
+    };
+    const auto take_byte = [&]() {
+        if (++form_size_ > max_form_size_ && !oversized_) {
+            // Keep scanning so the stream resyncs at the form's end, but stop buffering it
+            oversized_ = true;
+            start = std::string_view::npos;
+            pending_.clear();
+            pending_.shrink_to_fit();
+        }
+    };
+
+    for (size_t i = 0; i < chunk.size(); ++i) {
+        const char c = chunk[i];
+        switch (state_) {
+            case State::IDLE:
+                if (IsWhitespace(c)) {
+                    break;
+                }
+                if (c == ';') {
+                    state_ = State::COMMENT;
+                    break;
+                }
+                if (c == ')') {
+                    on_form(Result<std::string_view>::Error("Unexpected ')'"), line_);
+                    break;
+                }
+                form_line_ = line_;
+                form_size_ = 0;
+                oversized_ = false;
+                pending_.clear();
+                start = i;
+                take_byte();
+                if (c == '(') {
+                    state_ = State::LIST;
+                    depth_ = 1;
+                } else if (c == ':') {
+                    state_ = State::COMMAND;
+                } else {
+                    state_ = State::ATOM;
+                    in_string_ = c == '"';
+                }
+                break;
+
+            case State::COMMENT:
+                if (c == '\n') {
+                    state_ = State::IDLE;
+                }
+                break;
+
+            case State::LIST:
+                take_byte();
+                if (in_comment_) {
+                    if (c == '\n') {
+                        in_comment_ = false;
+                        if (!oversized_) {
+                            start = i;
+                        }
+                    }
+                } else if (in_string_) {
+                    if (escaped_) {
+                        escaped_ = false;
+                    } else if (c == '\\') {
+                        escaped_ = true;
+                    } else if (c == '"') {
+                        in_string_ = false;
+                    }
+                } else if (c == '"') {
+                    in_string_ = true;
+                } else if (c == ';') {
+                    copy_until(i);
+                    if (!oversized_) {
+                        pending_ += ' ';
+                    }
+                    in_comment_ = true;
+                } else if (c == '(') {
+                    ++depth_;
+                } else if (c == ')' && --depth_ == 0) {
+                    emit(i + 1);
+                }
+                break;
+
+            case State::ATOM:
+                if (in_string_) {
+                    take_byte();
+                    if (escaped_) {
+                        escaped_ = false;
+                    } else if (c == '\\') {
+                        escaped_ = true;
+                    } else if (c == '"') {
+                        in_string_ = false;
+                        emit(i + 1);
+                    }
+                } else if (IsDelimiter(c)) {
+                    emit(i);
+                    --i;  // The delimiter may open the next form
+                    continue;
+                } else {
+                    take_byte();
+                }
+                break;
+
+            case State::COMMAND:
+                if (c == '\n') {
+                    emit(i);
+                } else {
+                    take_byte();
+                }
+                break;
+        }
+        if (c == '\n') {
+            ++line_;
+        }
+    }
+
+    // Whatever is left belongs to a form that continues in the next chunk
+    copy_until(chunk.size());
+    return forms;
+}
+
+size_t SExprStreamParser::Finish(const FormHandler& on_form) {
+    size_t forms = 0;
+    if (state_ == State::LIST || (state_ == State::ATOM && in_string_)) {
+        on_form(Result<std::string_view>::Error(state_ == State::LIST ? "Missing closing ')'" : "Unterminated string"),
+                form_line_);
+    } else if (state_ == State::ATOM || state_ == State::COMMAND) {
+        EmitForm({}, on_form);
+        ++forms;
+    }
+    Reset();
+    return forms;
+}
+
+void SExprStreamParser::Reset() {
+    state_ = State::IDLE;
+    depth_ = 0;
+    in_string_ = false;
+    escaped_ = false;
+    in_comment_ = false;
+    oversized_ = false;
+    line_ = 1;
+    form_size_ = 0;
+    pending_.clear();
+}
+
+void SExprStreamParser::EmitForm(std::string_view tail, const FormHandler& on_form) {
+    if (oversized_) {
+        on_form(Result<std::string_view>::Error("Form too large (max " + std::to_string(max_form_size_) + " bytes)"),
+                form_line_);
+    } else {
+        // Forms that fit in one chunk are handed out without a copy
+        std::string_view form = tail;
+        if (!pending_.empty()) {
+            pending_.append(tail.data(), tail.size());
+            form = pending_;
+        }
+        while (!form.empty() && form.back() == '\r') {
+            form.remove_suffix(1);
+        }
+        on_form(Result<std::string_view>::Success(form), form_line_);
+    }
+    pending_.clear();
+    oversized_ = false;
+    in_string_ = false;
+    escaped_ = false;
+    in_comment_ = false;
+    depth_ = 0;
+}
+
+} // namespace mcp
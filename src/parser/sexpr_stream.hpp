@@ -0,0 +1,67 @@
+#pragma once
+
+#include "mcp/interfaces.hpp"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace mcp {
+
+/**
+ * @brief Resumable scanner that splits a byte stream into top-level forms
+ *
+ * Chunks may end anywhere, even inside a string or an escape; each byte is
+ * scanned once, and the state carries over to the next Feed(). A form is
+ * handed out as soon as it closes:
+ *   - a list, once its parentheses balance
+ *   - a top-level atom, at the next delimiter (or Finish())
+ *   - a line starting with ':' (a built-in CLI command), at the newline
+ * Comments (';' to end of line) outside strings are blanked out of the
+ * form, so every form can go straight to SExprParser.
+ */
+class SExprStreamParser {
+public:
+    // A form or a scan error, and the line the form started on; the view is only valid during the call
+    using FormHandler = std::function<void(const Result<std::string_view>& form, size_t line)>;
+
+    explicit SExprStreamParser(size_t max_form_size = 1024 * 1024);
+
+    // Returns the number of forms handed out
+    size_t Feed(std::string_view chunk, const FormHandler& on_form);
+    // End of input: flushes a trailing atom and reports an unterminated form
+    size_t Finish(const FormHandler& on_form);
+    // Back to the start of a new stream, line numbers included
+    void Reset();
+
+    // True when no form is partially read, e.g. to pick the REPL prompt
+    bool IsIdle() const { return state_ == State::IDLE || state_ == State::COMMENT; }
+    size_t GetDepth() const { return depth_; }
+    size_t GetLine() const { return line_; }
+
+private:
+    enum class State {
+        IDLE,       // Between forms
+        COMMENT,    // Top-level comment
+        LIST,
+        ATOM,       // Top-level atom
+        COMMAND     // ':' line
+    };
+
+    size_t max_form_size_;
+    State state_ = State::IDLE;
+    size_t depth_ = 0;
+    bool in_string_ = false;
+    bool escaped_ = false;
+    bool in_comment_ = false;      // Comment inside a list
+    bool oversized_ = false;       // Form is skipped to its end and reported once
+    size_t line_ = 1;
+    size_t form_line_ = 1;
+    size_t form_size_ = 0;
+    std::string pending_;          // Current form, once it spans chunks or had a comment blanked
+
+    // tail is the part of the form not yet copied into pending_
+    void EmitForm(std::string_view tail, const FormHandler& on_form);
+};
+
+} // namespace mcp
@@ -0,0 +1,278 @@
+#include "aes_gcm_stream.hpp"
+#include "secure_buffer.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <bcrypt.h>
+#pragma comment(lib, "bcrypt.lib")
+#elif defined(HAVE_OPENSSL)
+#include <openssl/evp.h>
+#endif
+
+namespace mcp {
+
+#ifdef _WIN32
+
+struct AesGcmStream::Impl {
+    static constexpr size_t kBlock = 16;
+
+    BCRYPT_ALG_HANDLE algorithm = nullptr;
+    BCRYPT_KEY_HANDLE key = nullptr;
+    BCRYPT_AUTHENTICATED_CIPHER_MODE_INFO info;
+    uint8_t nonce[kIvSize] = {};
+    uint8_t tag[kTagSize] = {};
+    uint8_t chain_iv[kBlock] = {};      // Carried between chained calls
+    std::vector<uint8_t> mac_context;
+    uint8_t pending[kBlock] = {};       // Chained calls take whole blocks only
+    size_t pending_size = 0;
+
+    ~Impl() {
+        if (key) {
+            BCryptDestroyKey(key);
+        }
+        if (algorithm) {
+            BCryptCloseAlgorithmProvider(algorithm, 0);
+        }
+        SecureZeroMemory(pending, sizeof(pending));
+    }
+
+    Result<void> Init(const uint8_t* key_bytes, const uint8_t* iv) {
+        if (!BCRYPT_SUCCESS(BCryptOpenAlgorithmProvider(&algorithm, BCRYPT_AES_ALGORITHM, nullptr, 0))) {
+            return Result<void>::Error("Failed to open AES algorithm provider");
+        }
+        if (!BCRYPT_SUCCESS(BCryptSetProperty(algorithm, BCRYPT_CHAINING_MODE, (PUCHAR)BCRYPT_CHAIN_MODE_GCM,
+                                              sizeof(BCRYPT_CHAIN_MODE_GCM), 0))) {
+            return Result<void>::Error("Failed to set GCM mode");
+        }
+        BCRYPT_AUTH_TAG_LENGTHS_STRUCT tag_lengths;
+        ULONG written = 0;
+        if (!BCRYPT_SUCCESS(BCryptGetProperty(algorithm, BCRYPT_AUTH_TAG_LENGTH, (PUCHAR)&tag_lengths,
+                                              sizeof(tag_lengths), &written, 0))) {
+            return Result<void>::Error("Failed to query GCM tag length");
+        }
+        if (!BCRYPT_SUCCESS(BCryptGenerateSymmetricKey(algorithm, &key, nullptr, 0, const_cast<PUCHAR>(key_bytes),
+                                                       static_cast<ULONG>(kKeySize), 0))) {
+            return Result<void>::Error("Failed to generate symmetric key");
+        }
+
+        std::memcpy(nonce, iv, kIvSize);
+        mac_context.assign(tag_lengths.dwMaxLength, 0);
+        BCRYPT_INIT_AUTH_MODE_INFO(info);
+        info.pbNonce = nonce;
+        info.cbNonce = static_cast<ULONG>(kIvSize);
+        info.pbTag = tag;
+        info.cbTag = static_cast<ULONG>(kTagSize);
+        info.pbMacContext = mac_context.data();
+        info.cbMacContext = static_cast<ULONG>(mac_context.size());
+        info.dwFlags = BCRYPT_AUTH_MODE_CHAIN_CALLS_FLAG;
+        return Result<void>::Success();
+    }
+
+    Result<void> Crypt(Direction direction, const uint8_t* input, size_t size, uint8_t* output) {
+        ULONG written = 0;
+        const NTSTATUS status = direction == Direction::ENCRYPT
+            ? BCryptEncrypt(key, const_cast<PUCHAR>(input), static_cast<ULONG>(size), &info, chain_iv,
+                            static_cast<ULONG>(sizeof(chain_iv)), output, static_cast<ULONG>(size), &written, 0)
+            : BCryptDecrypt(key, const_cast<PUCHAR>(input), static_cast<ULONG>(size), &info, chain_iv,
+                            static_cast<ULONG>(sizeof(chain_iv)), output, static_cast<ULONG>(size), &written, 0);
+        if (!BCRYPT_SUCCESS(status)) {
+            return Result<void>::Error(info.dwFlags & BCRYPT_AUTH_MODE_CHAIN_CALLS_FLAG
+                                           ? "Streaming cipher update failed"
+                                           : "Decryption failed - authentication tag mismatch or corruption");
+        }
+        return Result<void>::Success();
+    }
+
+    Result<void> Update(Direction direction, const uint8_t* input, size_t size, std::vector<uint8_t>& output) {
+        if (pending_size > 0) {
+            const size_t take = std::min(size, kBlock - pending_size);
+            std::memcpy(pending + pending_size, input, take);
+            pending_size += take;
+            input += take;
+            size -= take;
+            if (pending_size < kBlock) {
+                return Result<void>::Success();
+            }
+            const size_t offset = output.size();
+            output.resize(offset + kBlock);
+            auto result = Crypt(direction, pending, kBlock, output.data() + offset);
+            pending_size = 0;
+            if (!result.IsSuccess()) {
+                return result;
+            }
+        }
+        // ULONG sizes: whole blocks in pieces well below 4 GB
+        constexpr size_t kMaxCall = size_t(1) << 30;
+        while (size >= kBlock) {
+            const size_t blocks = std::min(size, kMaxCall) / kBlock * kBlock;
+            const size_t offset = output.size();
+            output.resize(offset + blocks);
+            auto result = Crypt(direction, input, blocks, output.data() + offset);
+            if (!result.IsSuccess()) {
+                return result;
+            }
+            input += blocks;
+            size -= blocks;
+        }
+        std::memcpy(pending, input, size);
+        pending_size = size;
+        return Result<void>::Success();
+    }
+
+    Result<void> Finish(Direction direction, std::vector<uint8_t>& output, uint8_t* tag_out, const uint8_t* tag_in) {
+        if (tag_in) {
+            std::memcpy(tag, tag_in, kTagSize);
+        }
+        info.dwFlags &= ~BCRYPT_AUTH_MODE_CHAIN_CALLS_FLAG;
+        const size_t offset = output.size();
+        output.resize(offset + pending_size);
+        auto result = Crypt(direction, pending, pending_size, output.data() + offset);
+        pending_size = 0;
+        if (!result.IsSuccess()) {
+            SecureZeroMemory(output.data() + offset, output.size() - offset);
+            return result;
+        }
+        if (tag_out) {
+            std::memcpy(tag_out, tag, kTagSize);
+        }
+        return Result<void>::Success();
+    }
+};
+
+#elif defined(HAVE_OPENSSL)
+
+struct AesGcmStream::Impl {
+    EVP_CIPHER_CTX* context = nullptr;
+
+    ~Impl() {
+        if (context) {
+            EVP_CIPHER_CTX_free(context);
+        }
+    }
+
+    Result<void> Init(Direction direction, const uint8_t* key, const uint8_t* iv) {
+        context = EVP_CIPHER_CTX_new();
+        if (!context) {
+            return Result<void>::Error("Failed to create cipher context");
+        }
+        const int encrypt = direction == Direction::ENCRYPT ? 1 : 0;
+        if (EVP_CipherInit_ex(context, EVP_aes_256_gcm(), nullptr, nullptr, nullptr, encrypt) != 1 ||
+            EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_GCM_SET_IVLEN, static_cast<int>(kIvSize), nullptr) != 1 ||
+            EVP_CipherInit_ex(context, nullptr, nullptr, key, iv, encrypt) != 1) {
+            return Result<void>::Error("Failed to initialize AES-256-GCM");
+        }
+        return Result<void>::Success();
+    }
+
+    Result<void> Update(Direction /* direction */, const uint8_t* input, size_t size, std::vector<uint8_t>& output) {
+        // GCM is a stream mode: output matches input byte for byte
+        const size_t offset = output.size();
+        output.resize(offset + size);
+        uint8_t* out = output.data() + offset;
+        while (size > 0) {
+            const int piece = static_cast<int>(std::min<size_t>(size, INT_MAX / 2));
+            int written = 0;
+            if (EVP_CipherUpdate(context, out, &written, input, piece) != 1) {
+                return Result<void>::Error("Streaming cipher update failed");
+            }
+            input += piece;
+            out += written;
+            size -= static_cast<size_t>(piece);
+        }
+        return Result<void>::Success();
+    }
+
+    Result<void> Finish(Direction direction, std::vector<uint8_t>& output, uint8_t* tag_out, const uint8_t* tag_in) {
+        if (direction == Direction::DECRYPT &&
+            EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_GCM_SET_TAG, static_cast<int>(kTagSize),
+                                const_cast<uint8_t*>(tag_in)) != 1) {
+            return Result<void>::Error("Failed to set authentication tag");
+        }
+        uint8_t tail[16];
+        int written = 0;
+        if (EVP_CipherFinal_ex(context, tail, &written) != 1) {
+            return Result<void>::Error(direction == Direction::DECRYPT
+                                           ? "Decryption failed - authentication tag mismatch"
+                                           : "Encryption finalization failed");
+        }
+        output.insert(output.end(), tail, tail + written);
+        if (direction == Direction::ENCRYPT &&
+            EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_GCM_GET_TAG, static_cast<int>(kTagSize), tag_out) != 1) {
+            return Result<void>::Error("Failed to get authentication tag");
+        }
+        return Result<void>::Success();
+    }
+};
+
+#else
+
+struct AesGcmStream::Impl {
+    Result<void> Init(Direction, const uint8_t*, const uint8_t*) {
+        return Result<void>::Error("OpenSSL not available - cannot stream encrypted data");
+    }
+    Result<void> Update(Direction, const uint8_t*, size_t, std::vector<uint8_t>&) {
+        return Result<void>::Error("OpenSSL not available");
+    }
+    Result<void> Finish(Direction, std::vector<uint8_t>&, uint8_t*, const uint8_t*) {
+        return Result<void>::Error("OpenSSL not available");
+    }
+};
+
+#endif
+
+Result<std::unique_ptr<AesGcmStream>> AesGcmStream::Create(Direction direction, const uint8_t* key, const uint8_t* iv) {
+    if (!key || !iv) {
+        return Result<std::unique_ptr<AesGcmStream>>::Error("Streaming cipher needs a key and an IV");
+    }
+    auto impl = std::make_unique<Impl>();
+#ifdef _WIN32
+    auto init = impl->Init(key, iv);
+#else
+    auto init = impl->Init(direction, key, iv);
+#endif
+    if (!init.IsSuccess()) {
+        return Result<std::unique_ptr<AesGcmStream>>::Error(init.Error());
+    }
+    return Result<std::unique_ptr<AesGcmStream>>::Success(
+        std::unique_ptr<AesGcmStream>(new AesGcmStream(direction, std::move(impl))));
+}
+
+AesGcmStream::AesGcmStream(Direction direction, std::unique_ptr<Impl> impl)
+    : direction_(direction), impl_(std::move(impl)) {}
+
+AesGcmStream::~AesGcmStream() = default;
+
+Result<void> AesGcmStream::Update(const uint8_t* input, size_t size, std::vector<uint8_t>& output) {
+    if (finished_) {
+        return Result<void>::Error("Streaming cipher already finished");
+    }
+    if (size > kMaxMessageBytes - processed_) {
+        return Result<void>::Error("Message too long for one AES-GCM IV");
+    }
+    processed_ += size;
+    return size == 0 ? Result<void>::Success() : impl_->Update(direction_, input, size, output);
+}
+
+Result<void> AesGcmStream::FinishEncrypt(std::vector<uint8_t>& output, uint8_t* tag) {
+    if (finished_ || direction_ != Direction::ENCRYPT || !tag) {
+        return Result<void>::Error("Streaming cipher cannot finish encryption here");
+    }
+    finished_ = true;
+    return impl_->Finish(direction_, output, tag, nullptr);
+}
+
+Result<void> AesGcmStream::FinishDecrypt(std::vector<uint8_t>& output, const uint8_t* tag) {
+    if (finished_ || direction_ != Direction::DECRYPT || !tag) {
+        return Result<void>::Error("Streaming cipher cannot finish decryption here");
+    }
+    finished_ = true;
+    return impl_->Finish(direction_, output, nullptr, tag);
+}
+
+} // namespace mcp
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "mcp/interfaces.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace mcp {
+
+/**
+ * @brief Incremental AES-256-GCM over OpenSSL EVP or Windows BCrypt
+ *
+ * One cipher context is kept for the whole message, so every Update() runs
+ * at the library's AES-NI/PCLMUL speed instead of paying for setup per
+ * chunk. Output is appended and may lag the input by less than one block
+ * (BCrypt chains whole blocks only); Finish*() emits the rest.
+ */
+class AesGcmStream {
+public:
+    enum class Direction {
+        ENCRYPT,
+        DECRYPT
+    };
+
+    static constexpr size_t kKeySize = 32;
+    static constexpr size_t kIvSize = 12;
+    static constexpr size_t kTagSize = 16;
+    // GCM allows 2^39 - 256 bits of plaintext per (key, IV)
+    static constexpr uint64_t kMaxMessageBytes = (uint64_t(1) << 36) - 32;
+
+    static Result<std::unique_ptr<AesGcmStream>> Create(Direction direction, const uint8_t* key, const uint8_t* iv);
+    ~AesGcmStream();
+    AesGcmStream(const AesGcmStream&) = delete;
+    AesGcmStream& operator=(const AesGcmStream&) = delete;
+
+    Result<void> Update(const uint8_t* input, size_t size, std::vector<uint8_t>& output);
+    Result<void> FinishEncrypt(std::vector<uint8_t>& output, uint8_t* tag);
+    // Fails when tag does not authenticate everything passed to Update()
+    Result<void> FinishDecrypt(std::vector<uint8_t>& output, const uint8_t* tag);
+
+    Direction GetDirection() const { return direction_; }
+    uint64_t GetProcessedBytes() const { return processed_; }
+
+private:
+    struct Impl;
+
+    AesGcmStream(Direction direction, std::unique_ptr<Impl> impl);
+
+    Direction direction_;
+    std::unique_ptr<Impl> impl_;
+    uint64_t processed_ = 0;
+    bool finished_ = false;
+};
+
+} // namespace mcp
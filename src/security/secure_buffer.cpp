@@ -0,0 +1,128 @@
+#include "secure_buffer.hpp"
+#include <cstring>
+#include <new>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace mcp {
+
+namespace {
+
+size_t PageSize() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<size_t>(info.dwPageSize);
+#else
+    const long page = sysconf(_SC_PAGESIZE);
+    return page > 0 ? static_cast<size_t>(page) : 4096;
+#endif
+}
+
+} // anonymous namespace
+
+SecureBuffer::SecureBuffer(size_t size) {
+    if (size == 0) {
+        return;
+    }
+    const size_t page = PageSize();
+    capacity_ = (size + page - 1) / page * page;
+
+#ifdef _WIN32
+    void* memory = VirtualAlloc(nullptr, capacity_, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    locked_ = VirtualLock(memory, capacity_) != 0;
+#else
+    void* memory = mmap(nullptr, capacity_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    locked_ = mlock(memory, capacity_) == 0;
+#ifdef MADV_DONTDUMP
+    madvise(memory, capacity_, MADV_DONTDUMP);
+#endif
+#endif
+
+    data_ = static_cast<uint8_t*>(memory);
+    size_ = size;
+}
+
+SecureBuffer::~SecureBuffer() {
+    Release();
+}
+
+SecureBuffer::SecureBuffer(SecureBuffer&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      capacity_(std::exchange(other.capacity_, 0)),
+      locked_(std::exchange(other.locked_, false)) {}
+
+SecureBuffer& SecureBuffer::operator=(SecureBuffer&& other) noexcept {
+    if (this != &other) {
+        Release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        capacity_ = std::exchange(other.capacity_, 0);
+        locked_ = std::exchange(other.locked_, false);
+    }
+    return *this;
+}
+
+SecureBuffer SecureBuffer::FromString(const std::string& text) {
+    SecureBuffer buffer(text.size());
+    if (!text.empty()) {
+        std::memcpy(buffer.data_, text.data(), text.size());
+    }
+    return buffer;
+}
+
+std::string SecureBuffer::ToString() const {
+    return std::string(reinterpret_cast<const char*>(data_), size_);
+}
+
+void SecureBuffer::Release() {
+    if (!data_) {
+        return;
+    }
+    Wipe(data_, capacity_);
+#ifdef _WIN32
+    if (locked_) {
+        VirtualUnlock(data_, capacity_);
+    }
+    VirtualFree(data_, 0, MEM_RELEASE);
+#else
+    if (locked_) {
+        munlock(data_, capacity_);
+    }
+    munmap(data_, capacity_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    capacity_ = 0;
+    locked_ = false;
+}
+
+void SecureBuffer::Wipe(void* data, size_t size) {
+#ifdef _WIN32
+    SecureZeroMemory(data, size);
+#else
+    // Volatile stores cannot be dropped as dead by the optimizer
+    volatile uint8_t* bytes = static_cast<volatile uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        bytes[i] = 0;
+    }
+#endif
+}
+
+} // namespace mcp
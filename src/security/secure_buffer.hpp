@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mcp {
+
+/**
+ * @brief Heap-external buffer for secrets: page-locked, excluded from core dumps, wiped on release
+ *
+ * Memory comes straight from the OS in whole pages so that locking never
+ * pins unrelated heap data. Locking is best effort (RLIMIT_MEMLOCK or the
+ * working set quota may refuse it); IsLocked() tells which one happened.
+ */
+class SecureBuffer {
+public:
+    SecureBuffer() = default;
+    explicit SecureBuffer(size_t size);
+    ~SecureBuffer();
+
+    SecureBuffer(SecureBuffer&& other) noexcept;
+    SecureBuffer& operator=(SecureBuffer&& other) noexcept;
+    SecureBuffer(const SecureBuffer&) = delete;
+    SecureBuffer& operator=(const SecureBuffer&) = delete;
+
+    static SecureBuffer FromString(const std::string& text);
+
+    uint8_t* Data() { return data_; }
+    const uint8_t* Data() const { return data_; }
+    size_t Size() const { return size_; }
+    bool IsLocked() const { return locked_; }
+    bool Empty() const { return size_ == 0; }
+
+    std::string ToString() const;
+    // Zeroes the bytes and gives the pages back
+    void Release();
+
+    static void Wipe(void* data, size_t size);
+
+private:
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;     // Whole pages as mapped
+    bool locked_ = false;
+};
+
+} // namespace mcp
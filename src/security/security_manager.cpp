@@ -1,6 +1,14 @@
 #include "security_manager.hpp"
+#include "secure_buffer.hpp"
+#include "mcp/hex_codec.hpp"
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <fstream>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <random>
 #include <regex>
 #include <functional>
 #include <string>
@@ -19,6 +27,9 @@
 #pragma comment(lib, "bcrypt.lib")
 #pragma comment(lib, "advapi32.lib")
 #else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <openssl/evp.h>
 #include <openssl/rand.h>
 #include <openssl/sha.h>
@@ -26,8 +37,68 @@
 
 namespace mcp {
 
+namespace {
+
+constexpr size_t STREAM_CHUNK_SIZE = 1024 * 1024;
+
+} // anonymous namespace
+
+struct SecurityManager::CredentialCache {
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        SecureBuffer value;
+        Clock::time_point expires;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    std::chrono::milliseconds ttl{60000};
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t generation = 0;   // Bumped whenever stored values change; a miss caches only within one
+    bool expiry_scheduled = false;
+    std::weak_ptr<ITaskExecutor> executor;
+
+    // Callers hold mutex
+    void PurgeExpired(Clock::time_point now) {
+        for (auto it = entries.begin(); it != entries.end();) {
+            it = it->second.expires <= now ? entries.erase(it) : std::next(it);
+        }
+    }
+
+    // Callers hold mutex; one task at a time waits for the earliest deadline
+    static void ScheduleExpiry(const std::shared_ptr<CredentialCache>& cache) {
+        if (cache->expiry_scheduled || cache->entries.empty()) {
+            return;
+        }
+        auto executor = cache->executor.lock();
+        if (!executor) {
+            return;
+        }
+        Clock::time_point deadline = Clock::time_point::max();
+        for (const auto& entry : cache->entries) {
+            deadline = std::min(deadline, entry.second.expires);
+        }
+
+        std::weak_ptr<CredentialCache> weak = cache;
+        cache->expiry_scheduled = executor->PostWhen(
+            [weak, deadline]() { return weak.expired() || Clock::now() >= deadline; },
+            [weak]() {
+                auto owner = weak.lock();
+                if (!owner) {
+                    return;
+                }
+                const std::lock_guard<std::mutex> lock(owner->mutex);
+                owner->expiry_scheduled = false;
+                owner->PurgeExpired(Clock::now());
+                ScheduleExpiry(owner);
+            });
+    }
+};
+
 SecurityManager::SecurityManager(std::shared_ptr<ILogger> logger) 
-    : logger_(std::move(logger)) {
+    : logger_(std::move(logger)), credential_cache_(std::make_shared<CredentialCache>()) {
     
     // Generate default encryption key from system entropy
     auto key_result = GenerateRandomBytes(32); // 256-bit key
@@ -76,9 +147,10 @@ Result<void> SecurityManager::StoreCredential(const std::string& key, const std:
     // Convert value to bytes
     std::vector<uint8_t> value_bytes(value.begin(), value.end());
     
-    // Encrypt the value
+    // Encrypt the value; the key may not change before it is stored
+    const std::shared_lock<std::shared_mutex> key_lock(key_mutex_);
     std::vector<uint8_t> encrypted_value;
-    auto encrypt_result = EncryptData(value_bytes, encrypted_value);
+    auto encrypt_result = EncryptDataInternal(value_bytes, encrypted_value);
     if (!encrypt_result.IsSuccess()) {
         return encrypt_result;
     }
@@ -88,6 +160,11 @@ Result<void> SecurityManager::StoreCredential(const std::string& key, const std:
         const std::lock_guard<std::mutex> lock(credentials_mutex_);
         encrypted_credentials_[key] = encrypted_value;
     }
+    {
+        const std::lock_guard<std::mutex> lock(credential_cache_->mutex);
+        credential_cache_->entries.erase(key);
+        ++credential_cache_->generation;
+    }
     
     if (logger_) {
         // БЕЗОПАСНОСТЬ: НЕ логируем ключи учетных данных!
@@ -108,27 +185,58 @@ Result<std::string> SecurityManager::RetrieveCredential(const std::string& key)
         return Result<std::string>::Error("Encryption not initialized");
     }
     
-    std::vector<uint8_t> encrypted_value;
-    
-    // Retrieve encrypted credential
+    // Providers ask for their key on every request; skip the decryption while the value is fresh
+    bool cache_enabled = false;
+    uint64_t generation = 0;
     {
-        const std::lock_guard<std::mutex> lock(credentials_mutex_);
-        auto it = encrypted_credentials_.find(key);
-        if (it == encrypted_credentials_.end()) {
-            return Result<std::string>::Error("Credential not found: " + key);
+        const std::lock_guard<std::mutex> lock(credential_cache_->mutex);
+        cache_enabled = credential_cache_->ttl.count() > 0;
+        generation = credential_cache_->generation;
+        auto it = credential_cache_->entries.find(key);
+        if (it != credential_cache_->entries.end()) {
+            if (it->second.expires > CredentialCache::Clock::now()) {
+                ++credential_cache_->hits;
+                return Result<std::string>::Success(it->second.value.ToString());
+            }
+            credential_cache_->entries.erase(it);
         }
-        encrypted_value = it->second;
+        ++credential_cache_->misses;
     }
     
-    // Decrypt the value
+    std::vector<uint8_t> encrypted_value;
     std::vector<uint8_t> decrypted_value;
-    auto decrypt_result = DecryptData(encrypted_value, decrypted_value);
-    if (!decrypt_result.IsSuccess()) {
-        return Result<std::string>::Error(decrypt_result.Error());
+    {
+        // Retrieve and decrypt under one key
+        const std::shared_lock<std::shared_mutex> key_lock(key_mutex_);
+        {
+            const std::lock_guard<std::mutex> lock(credentials_mutex_);
+            auto it = encrypted_credentials_.find(key);
+            if (it == encrypted_credentials_.end()) {
+                return Result<std::string>::Error("Credential not found: " + key);
+            }
+            encrypted_value = it->second;
+        }
+        
+        auto decrypt_result = DecryptDataInternal(encrypted_value, decrypted_value);
+        if (!decrypt_result.IsSuccess()) {
+            return Result<std::string>::Error(decrypt_result.Error());
+        }
     }
     
     // Convert back to string
     std::string value(decrypted_value.begin(), decrypted_value.end());
+    SecureBuffer::Wipe(decrypted_value.data(), decrypted_value.size());
+    
+    if (cache_enabled) {
+        SecureBuffer cached = SecureBuffer::FromString(value);
+        const std::lock_guard<std::mutex> lock(credential_cache_->mutex);
+        // A store or clear since the miss may have replaced what was decrypted; the next lookup caches it
+        if (credential_cache_->generation == generation && credential_cache_->ttl.count() > 0) {
+            const auto expires = CredentialCache::Clock::now() + credential_cache_->ttl;
+            credential_cache_->entries[key] = CredentialCache::Entry{std::move(cached), expires};
+            CredentialCache::ScheduleExpiry(credential_cache_);
+        }
+    }
     
     if (logger_) {
         // БЕЗОПАСНОСТЬ: НЕ логируем ключи учетных данных!
@@ -148,6 +256,7 @@ Result<void> SecurityManager::EncryptData(const std::vector<uint8_t>& data, std:
         return Result<void>::Error("Cannot encrypt empty data");
     }
     
+    const std::shared_lock<std::shared_mutex> key_lock(key_mutex_);
     return EncryptDataInternal(data, encrypted);
 }
 
@@ -160,6 +269,7 @@ Result<void> SecurityManager::DecryptData(const std::vector<uint8_t>& encrypted,
         return Result<void>::Error("Cannot decrypt empty data");
     }
     
+    const std::shared_lock<std::shared_mutex> key_lock(key_mutex_);
     return DecryptDataInternal(encrypted, data);
 }
 
@@ -235,6 +345,120 @@ Result<void> SecurityManager::SaveCredentialsToFile(const std::string& filename)
     return Result<void>::Success();
 }
 
+Result<void> SecurityManager::InitializeEncryption(const std::string& master_key) {
+    std::vector<uint8_t> key(AesGcmStream::kKeySize);
+    auto decoded = HexDecode(master_key, key.data(), key.size());
+    if (!decoded.IsSuccess() || decoded.Value() != key.size()) {
+        SecureBuffer::Wipe(key.data(), key.size());
+        return Result<void>::Error("Master key must be 64 hex digits");
+    }
+
+    const std::unique_lock<std::shared_mutex> key_lock(key_mutex_);
+    const std::lock_guard<std::mutex> lock(credentials_mutex_);
+
+    // Decrypt everything first, so a failure leaves the old key and credentials in place
+    std::vector<std::pair<std::string, std::vector<uint8_t>>> plain;
+    const auto wipe_plain = [&plain]() {
+        for (auto& entry : plain) {
+            SecureBuffer::Wipe(entry.second.data(), entry.second.size());
+        }
+    };
+    for (const auto& credential : encrypted_credentials_) {
+        plain.emplace_back(credential.first, std::vector<uint8_t>());
+        auto result = DecryptDataInternal(credential.second, plain.back().second);
+        if (!result.IsSuccess()) {
+            wipe_plain();
+            SecureBuffer::Wipe(key.data(), key.size());
+            return result;
+        }
+    }
+
+    SecureBuffer::Wipe(encryption_key_.data(), encryption_key_.size());
+    encryption_key_ = std::move(key);
+    encryption_initialized_ = true;
+
+    Result<void> status = Result<void>::Success();
+    for (const auto& entry : plain) {
+        std::vector<uint8_t> encrypted;
+        auto result = EncryptDataInternal(entry.second, encrypted);
+        if (!result.IsSuccess()) {
+            // Unreadable under the new key, so it cannot be kept
+            encrypted_credentials_.erase(entry.first);
+            status = result;
+            continue;
+        }
+        encrypted_credentials_[entry.first] = std::move(encrypted);
+    }
+    wipe_plain();
+    return status;
+}
+
+Result<void> SecurityManager::LoadEncryptionKey(const std::string& key_path) {
+    const std::lock_guard<std::mutex> file_lock(key_file_mutex_);
+    if (key_path == key_path_) {
+        return Result<void>::Success();
+    }
+
+    const auto use_existing = [this, &key_path](std::ifstream& file) {
+        std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+        const auto begin = text.find_first_not_of(" \t\r\n");
+        const auto end = text.find_last_not_of(" \t\r\n");
+        auto result = InitializeEncryption(begin == std::string::npos ? std::string()
+                                                                       : text.substr(begin, end - begin + 1));
+        SecureBuffer::Wipe(&text[0], text.size());
+        if (!result.IsSuccess()) {
+            return Result<void>::Error("Invalid encryption key file " + key_path + ": " + result.Error());
+        }
+        key_path_ = key_path;
+        return result;
+    };
+
+    std::ifstream existing(key_path);
+    if (existing.is_open()) {
+        return use_existing(existing);
+    }
+
+    // First use: keep the current key, so nothing encrypted so far needs redoing
+    std::string hex;
+    {
+        const std::shared_lock<std::shared_mutex> key_lock(key_mutex_);
+        if (encryption_key_.size() != AesGcmStream::kKeySize) {
+            return Result<void>::Error("Invalid key size for AES-256");
+        }
+        hex = HexEncode(encryption_key_) + "\n";
+    }
+    bool written = false;
+#ifdef _WIN32
+    {
+        std::ofstream out(key_path, std::ios::trunc);
+        out << hex;
+        written = out.good();
+    }
+#else
+    // Exclusive create, readable by the owner only
+    const int fd = ::open(key_path.c_str(), O_WRONLY | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (fd >= 0) {
+        written = ::write(fd, hex.data(), hex.size()) == static_cast<ssize_t>(hex.size());
+        written = ::close(fd) == 0 && written;
+    }
+#endif
+    SecureBuffer::Wipe(&hex[0], hex.size());
+    if (!written) {
+        // Another session may have created it in the meantime
+        std::ifstream raced(key_path);
+        if (raced.is_open()) {
+            return use_existing(raced);
+        }
+        return Result<void>::Error("Cannot create encryption key file: " + key_path);
+    }
+    key_path_ = key_path;
+    if (logger_) {
+        logger_->Log(ILogger::Level::INFO, "Created encryption key file");
+    }
+    return Result<void>::Success();
+}
+
 void SecurityManager::ClearCredentials() {
     const std::lock_guard<std::mutex> lock(credentials_mutex_);
     
@@ -245,11 +469,167 @@ void SecurityManager::ClearCredentials() {
     
     encrypted_credentials_.clear();
     
+    {
+        // SecureBuffer wipes each value as it goes
+        const std::lock_guard<std::mutex> cache_lock(credential_cache_->mutex);
+        credential_cache_->entries.clear();
+        ++credential_cache_->generation;
+    }
+    
     if (logger_) {
         logger_->Log(ILogger::Level::INFO, "Cleared all credentials");
     }
 }
 
+void SecurityManager::SetCredentialCacheTTL(std::chrono::milliseconds ttl) {
+    const std::lock_guard<std::mutex> lock(credential_cache_->mutex);
+    credential_cache_->ttl = std::max(ttl, std::chrono::milliseconds(0));
+    if (credential_cache_->ttl.count() == 0) {
+        credential_cache_->entries.clear();
+        ++credential_cache_->generation;
+        return;
+    }
+    // Values cached under a longer ttl must not outlive the new one
+    const auto latest = CredentialCache::Clock::now() + credential_cache_->ttl;
+    for (auto& entry : credential_cache_->entries) {
+        entry.second.expires = std::min(entry.second.expires, latest);
+    }
+}
+
+void SecurityManager::SetTaskExecutor(std::weak_ptr<ITaskExecutor> executor) {
+    const std::lock_guard<std::mutex> lock(credential_cache_->mutex);
+    credential_cache_->executor = std::move(executor);
+    CredentialCache::ScheduleExpiry(credential_cache_);
+}
+
+SecurityManager::CredentialCacheStats SecurityManager::GetCredentialCacheStats() const {
+    const std::lock_guard<std::mutex> lock(credential_cache_->mutex);
+    CredentialCacheStats stats;
+    stats.hits = credential_cache_->hits;
+    stats.misses = credential_cache_->misses;
+    for (const auto& entry : credential_cache_->entries) {
+        if (entry.second.expires > CredentialCache::Clock::now()) {
+            ++stats.entries;
+            stats.locked += entry.second.value.IsLocked() ? 1 : 0;
+        }
+    }
+    return stats;
+}
+
+Result<std::unique_ptr<AesGcmStream>> SecurityManager::CreateCipherStream(AesGcmStream::Direction direction,
+                                                                          const uint8_t* iv) {
+    if (!encryption_initialized_) {
+        return Result<std::unique_ptr<AesGcmStream>>::Error("Encryption not initialized");
+    }
+    const std::shared_lock<std::shared_mutex> key_lock(key_mutex_);
+    if (encryption_key_.size() != AesGcmStream::kKeySize) {
+        return Result<std::unique_ptr<AesGcmStream>>::Error("Invalid key size for AES-256");
+    }
+    return AesGcmStream::Create(direction, encryption_key_.data(), iv);
+}
+
+Result<uint64_t> SecurityManager::EncryptStream(std::istream& input, std::ostream& output) {
+    auto iv_result = GenerateRandomBytes(AesGcmStream::kIvSize);
+    if (!iv_result.IsSuccess()) {
+        return Result<uint64_t>::Error("Failed to generate IV");
+    }
+    const std::vector<uint8_t> iv = iv_result.TakeValue();
+    auto cipher_result = CreateCipherStream(AesGcmStream::Direction::ENCRYPT, iv.data());
+    if (!cipher_result.IsSuccess()) {
+        return Result<uint64_t>::Error(cipher_result.Error());
+    }
+    auto cipher = cipher_result.TakeValue();
+
+    output.write(reinterpret_cast<const char*>(iv.data()), static_cast<std::streamsize>(iv.size()));
+    std::vector<uint8_t> chunk(STREAM_CHUNK_SIZE);
+    std::vector<uint8_t> ciphertext;
+    ciphertext.reserve(STREAM_CHUNK_SIZE + 16);
+    Result<void> status = Result<void>::Success();
+    while (status.IsSuccess() && input && output) {
+        input.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+        const auto got = static_cast<size_t>(input.gcount());
+        if (got == 0) {
+            break;
+        }
+        ciphertext.clear();
+        status = cipher->Update(chunk.data(), got, ciphertext);
+        output.write(reinterpret_cast<const char*>(ciphertext.data()), static_cast<std::streamsize>(ciphertext.size()));
+    }
+    SecureBuffer::Wipe(chunk.data(), chunk.size());
+    if (!status.IsSuccess()) {
+        return Result<uint64_t>::Error(status.Error());
+    }
+    if (input.bad()) {
+        return Result<uint64_t>::Error("Failed to read plaintext stream");
+    }
+
+    uint8_t tag[AesGcmStream::kTagSize];
+    ciphertext.clear();
+    status = cipher->FinishEncrypt(ciphertext, tag);
+    if (!status.IsSuccess()) {
+        return Result<uint64_t>::Error(status.Error());
+    }
+    output.write(reinterpret_cast<const char*>(ciphertext.data()), static_cast<std::streamsize>(ciphertext.size()));
+    output.write(reinterpret_cast<const char*>(tag), static_cast<std::streamsize>(sizeof(tag)));
+    if (!output) {
+        return Result<uint64_t>::Error("Failed to write encrypted stream");
+    }
+    return Result<uint64_t>::Success(cipher->GetProcessedBytes());
+}
+
+Result<uint64_t> SecurityManager::DecryptStream(std::istream& input, std::ostream& output) {
+    uint8_t iv[AesGcmStream::kIvSize];
+    input.read(reinterpret_cast<char*>(iv), static_cast<std::streamsize>(sizeof(iv)));
+    if (static_cast<size_t>(input.gcount()) != sizeof(iv)) {
+        return Result<uint64_t>::Error("Encrypted stream too small");
+    }
+    auto cipher_result = CreateCipherStream(AesGcmStream::Direction::DECRYPT, iv);
+    if (!cipher_result.IsSuccess()) {
+        return Result<uint64_t>::Error(cipher_result.Error());
+    }
+    auto cipher = cipher_result.TakeValue();
+
+    // The tag is the last 16 bytes, so that much is always held back from the cipher
+    constexpr size_t kTag = AesGcmStream::kTagSize;
+    std::vector<uint8_t> chunk(kTag + STREAM_CHUNK_SIZE);
+    std::vector<uint8_t> plaintext;
+    plaintext.reserve(STREAM_CHUNK_SIZE + 16);
+    size_t held = 0;
+    Result<void> status = Result<void>::Success();
+    while (status.IsSuccess() && input && output) {
+        input.read(reinterpret_cast<char*>(chunk.data() + held), static_cast<std::streamsize>(chunk.size() - held));
+        held += static_cast<size_t>(input.gcount());
+        if (held <= kTag) {
+            continue;
+        }
+        const size_t ready = held - kTag;
+        plaintext.clear();
+        status = cipher->Update(chunk.data(), ready, plaintext);
+        output.write(reinterpret_cast<const char*>(plaintext.data()), static_cast<std::streamsize>(plaintext.size()));
+        std::memmove(chunk.data(), chunk.data() + ready, kTag);
+        held = kTag;
+    }
+    SecureBuffer::Wipe(plaintext.data(), plaintext.size());
+    if (!status.IsSuccess()) {
+        return Result<uint64_t>::Error(status.Error());
+    }
+    if (input.bad() || held < kTag) {
+        return Result<uint64_t>::Error("Encrypted stream truncated");
+    }
+
+    plaintext.clear();
+    status = cipher->FinishDecrypt(plaintext, chunk.data());
+    if (!status.IsSuccess()) {
+        return Result<uint64_t>::Error(status.Error());
+    }
+    output.write(reinterpret_cast<const char*>(plaintext.data()), static_cast<std::streamsize>(plaintext.size()));
+    SecureBuffer::Wipe(plaintext.data(), plaintext.size());
+    if (!output) {
+        return Result<uint64_t>::Error("Failed to write decrypted stream");
+    }
+    return Result<uint64_t>::Success(cipher->GetProcessedBytes());
+}
+
 Result<void> SecurityManager::ValidateCredentialKey(const std::string& key) const {
     if (key.empty()) {
         return Result<void>::Error("Credential key cannot be empty");
@@ -297,8 +677,12 @@ Result<std::vector<uint8_t>> SecurityManager::GenerateRandomBytes(size_t count)
     
     CryptReleaseContext(hCryptProv, 0);
 #else
-    // Use standard random number generator (not cryptographically secure)
-    // In production, would use /dev/urandom or OpenSSL
+#ifdef HAVE_OPENSSL
+    if (count == 0 || RAND_bytes(bytes.data(), static_cast<int>(count)) == 1) {
+        return Result<std::vector<uint8_t>>::Success(bytes);
+    }
+#endif
+    // Fallback when OpenSSL is missing (not cryptographically secure)
     std::random_device rd;
     std::mt19937 gen(rd());
     std::uniform_int_distribution<> dis(0, 255);
@@ -2,8 +2,15 @@
 
 #include "mcp/interfaces.hpp"
 #include "mcp/types.hpp"
+#include "aes_gcm_stream.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <string>
 #include <unordered_map>
 
 namespace mcp {
@@ -12,6 +19,13 @@ class ILogger;
 
 class SecurityManager : public ISecurityManager {
 public:
+    struct CredentialCacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t entries = 0;
+        size_t locked = 0;      // Entries whose pages were locked in RAM
+    };
+
     explicit SecurityManager(std::shared_ptr<ILogger> logger);
     ~SecurityManager() override;
 
@@ -25,18 +39,42 @@ public:
     // Extended functionality
     Result<void> LoadCredentialsFromFile(const std::string& filename);
     Result<void> SaveCredentialsToFile(const std::string& filename);
+    // master_key is 64 hex digits; credentials stored so far are re-encrypted under it
     Result<void> InitializeEncryption(const std::string& master_key);
+    // Uses the key kept in key_path, writing this session's key there (owner-only) when there is none yet
+    Result<void> LoadEncryptionKey(const std::string& key_path);
     void ClearCredentials();
 
+    // Decrypted values are reused for ttl after a retrieval; zero disables the cache
+    void SetCredentialCacheTTL(std::chrono::milliseconds ttl);
+    // Expired values are wiped on the executor; without one they go on the next lookup
+    void SetTaskExecutor(std::weak_ptr<ITaskExecutor> executor);
+    CredentialCacheStats GetCredentialCacheStats() const;
+
+    // Streams of any size in 1 MB chunks; format: IV (12) + CIPHERTEXT + TAG (16).
+    // Both return the number of plaintext bytes.
+    Result<uint64_t> EncryptStream(std::istream& input, std::ostream& output);
+    // Plaintext is written before the tag is checked: discard the output unless this succeeds
+    Result<uint64_t> DecryptStream(std::istream& input, std::ostream& output);
+    // Low-level access for callers that frame their own messages; never reuse an IV
+    Result<std::unique_ptr<AesGcmStream>> CreateCipherStream(AesGcmStream::Direction direction, const uint8_t* iv);
+
 private:
+    struct CredentialCache;
+
     std::shared_ptr<ILogger> logger_;
     mutable std::mutex credentials_mutex_;
     
     // In-memory credential storage (encrypted)
     std::unordered_map<std::string, std::vector<uint8_t>> encrypted_credentials_;
+    // Shared with the expiry tasks, which only hold it weakly
+    std::shared_ptr<CredentialCache> credential_cache_;
     
-    // Encryption state
-    bool encryption_initialized_ = false;
+    // Encryption state; key_mutex_ is shared while the key is in use and exclusive to replace it
+    mutable std::shared_mutex key_mutex_;
+    std::mutex key_file_mutex_;
+    std::string key_path_;  // Loaded by LoadEncryptionKey
+    std::atomic<bool> encryption_initialized_{false};
     std::vector<uint8_t> encryption_key_;
     std::vector<uint8_t> encryption_iv_;
     
@@ -0,0 +1,162 @@
+#include "bridge_protocol.hpp"
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+namespace mcp {
+
+namespace {
+
+template<typename T>
+void PutLE(std::vector<uint8_t>& out, T value) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * i)));
+    }
+}
+
+template<typename T>
+T GetLE(const uint8_t* data) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+    return static_cast<T>(value);
+}
+
+void PutString(std::vector<uint8_t>& out, const std::string& text) {
+    const size_t length = std::min<size_t>(text.size(), UINT16_MAX);
+    PutLE<uint16_t>(out, static_cast<uint16_t>(length));
+    out.insert(out.end(), text.begin(), text.begin() + static_cast<std::ptrdiff_t>(length));
+}
+
+bool GetString(const std::vector<uint8_t>& data, size_t& offset, std::string& text) {
+    if (data.size() - offset < 2) {
+        return false;
+    }
+    const size_t length = GetLE<uint16_t>(data.data() + offset);
+    offset += 2;
+    if (data.size() - offset < length) {
+        return false;
+    }
+    text.assign(reinterpret_cast<const char*>(data.data() + offset), length);
+    offset += length;
+    return true;
+}
+
+} // anonymous namespace
+
+void EncodeFrame(const FrameHeader& header, const uint8_t* payload, std::vector<uint8_t>& out) {
+    out.reserve(out.size() + FrameHeader::kSize + header.payload_size);
+    PutLE<uint32_t>(out, FrameHeader::kMagic);
+    out.push_back(FrameHeader::kVersion);
+    out.push_back(static_cast<uint8_t>(header.type));
+    PutLE<uint16_t>(out, header.flags);
+    PutLE<uint32_t>(out, header.request_id);
+    PutLE<uint32_t>(out, header.payload_size);
+    PutLE<uint64_t>(out, header.address);
+    if (header.payload_size != 0) {
+        out.insert(out.end(), payload, payload + header.payload_size);
+    }
+}
+
+void EncodeEventPayload(const DebugEvent& event, std::vector<uint8_t>& out) {
+    out.push_back(static_cast<uint8_t>(event.type));
+    PutLE<uint32_t>(out, event.process_id);
+    PutLE<uint32_t>(out, event.thread_id);
+    PutString(out, event.module_name);
+    PutString(out, event.description);
+    const size_t count = std::min<size_t>(event.metadata.size(), UINT16_MAX);
+    PutLE<uint16_t>(out, static_cast<uint16_t>(count));
+    size_t written = 0;
+    for (auto it = event.metadata.begin(); written < count; ++it, ++written) {
+        PutString(out, it->first);
+        PutString(out, it->second);
+    }
+}
+
+bool DecodeEventPayload(const Frame& frame, DebugEvent& event) {
+    const std::vector<uint8_t>& data = frame.payload;
+    if (frame.header.type != FrameType::kEvent || data.size() < 9) {
+        return false;
+    }
+    if (data[0] > static_cast<uint8_t>(DebugEvent::Type::THREAD_TERMINATED)) {
+        return false;
+    }
+    event = DebugEvent();
+    event.type = static_cast<DebugEvent::Type>(data[0]);
+    event.address = static_cast<uintptr_t>(frame.header.address);
+    event.process_id = GetLE<uint32_t>(data.data() + 1);
+    event.thread_id = GetLE<uint32_t>(data.data() + 5);
+    event.timestamp = std::chrono::system_clock::now();
+
+    size_t offset = 9;
+    if (!GetString(data, offset, event.module_name) || !GetString(data, offset, event.description) ||
+        data.size() - offset < 2) {
+        return false;
+    }
+    const size_t count = GetLE<uint16_t>(data.data() + offset);
+    offset += 2;
+    for (size_t i = 0; i < count; ++i) {
+        std::string key;
+        std::string value;
+        if (!GetString(data, offset, key) || !GetString(data, offset, value)) {
+            return false;
+        }
+        event.metadata[std::move(key)] = std::move(value);
+    }
+    return offset == data.size();
+}
+
+void FrameDecoder::Feed(const uint8_t* data, size_t size) {
+    // Drop consumed bytes before growing so the buffer stays about one frame long
+    if (consumed_ != 0 && consumed_ == buffer_.size()) {
+        buffer_.clear();
+        consumed_ = 0;
+    } else if (consumed_ > kMaxChunkSize) {
+        buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(consumed_));
+        consumed_ = 0;
+    }
+    buffer_.insert(buffer_.end(), data, data + size);
+}
+
+bool FrameDecoder::Next(Frame& frame, std::string& error) {
+    const size_t available = buffer_.size() - consumed_;
+    if (available < FrameHeader::kSize) {
+        return false;
+    }
+
+    const uint8_t* head = buffer_.data() + consumed_;
+    if (GetLE<uint32_t>(head) != FrameHeader::kMagic || head[4] != FrameHeader::kVersion) {
+        error = "Bad frame header";
+        return false;
+    }
+    const uint8_t type = head[5];
+    if (type < static_cast<uint8_t>(FrameType::kReadMemory) || type > static_cast<uint8_t>(FrameType::kEvent)) {
+        error = "Unknown frame type " + std::to_string(type);
+        return false;
+    }
+    const uint32_t payload_size = GetLE<uint32_t>(head + 12);
+    if (payload_size > kMaxFramePayload) {
+        error = "Frame payload too large: " + std::to_string(payload_size);
+        return false;
+    }
+    if (available < FrameHeader::kSize + payload_size) {
+        return false;
+    }
+
+    frame.header.type = static_cast<FrameType>(type);
+    frame.header.flags = GetLE<uint16_t>(head + 6);
+    frame.header.request_id = GetLE<uint32_t>(head + 8);
+    frame.header.payload_size = payload_size;
+    frame.header.address = GetLE<uint64_t>(head + 16);
+    frame.payload.assign(head + FrameHeader::kSize, head + FrameHeader::kSize + payload_size);
+    consumed_ += FrameHeader::kSize + payload_size;
+    return true;
+}
+
+void FrameDecoder::Reset() {
+    buffer_.clear();
+    consumed_ = 0;
+}
+
+} // namespace mcp
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "mcp/interfaces.hpp"
+#include "mcp/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mcp {
+
+/**
+ * @brief Length-prefixed binary frames for memory transfer over PIPE and TCP
+ *
+ * Every frame is a fixed 24-byte little-endian header followed by
+ * payload_size bytes:
+ *
+ *   0  uint32  magic "MCPB"
+ *   4  uint8   version
+ *   5  uint8   type (FrameType)
+ *   6  uint16  flags
+ *   8  uint32  request_id
+ *  12  uint32  payload_size
+ *  16  uint64  address
+ *
+ * A read request carries the byte count as a uint64 payload. The reply is
+ * streamed as kReadReply frames with consecutive addresses, the last one
+ * flagged kFlagFinal. A kReadBatch request carries (uint64 address,
+ * uint64 size) pairs and is answered the same way for each range in turn,
+ * every range ending with its own kFlagFinal chunk; a short range means
+ * its tail is unreadable. Writes are sent as kWriteMemory frames of at most
+ * kMaxChunkSize bytes, each acknowledged by an empty kWriteReply. Debugger
+ * commands travel as kCommand frames holding the command text and are
+ * answered by one kCommandReply with its output. Either side may answer
+ * with kError, whose payload is a UTF-8 message. The debugger reports
+ * debug events as unsolicited kEvent frames (request_id 0, address = event
+ * address) whose payload is written by EncodeEventPayload().
+ *
+ * Replies carry the request_id of the request they answer and may arrive
+ * in any order relative to other requests, so several can be in flight.
+ */
+enum class FrameType : uint8_t {
+    kReadMemory = 1,
+    kReadReply = 2,
+    kWriteMemory = 3,
+    kWriteReply = 4,
+    kError = 5,
+    kReadBatch = 6,
+    kCommand = 7,
+    kCommandReply = 8,
+    kEvent = 9
+};
+
+struct FrameHeader {
+    static constexpr uint32_t kMagic = 0x4250434D;   // "MCPB"
+    static constexpr uint8_t kVersion = 1;
+    static constexpr size_t kSize = 24;
+    static constexpr uint16_t kFlagFinal = 0x0001;
+
+    FrameType type = FrameType::kError;
+    uint16_t flags = 0;
+    uint32_t request_id = 0;
+    uint32_t payload_size = 0;
+    uint64_t address = 0;
+};
+
+struct Frame {
+    FrameHeader header;
+    std::vector<uint8_t> payload;
+};
+
+// Largest payload the sender puts in one frame; replies for bigger reads are streamed
+constexpr size_t kMaxChunkSize = 64 * 1024;
+
+// Frames announcing more than this are treated as a corrupt stream
+constexpr size_t kMaxFramePayload = 16 * 1024 * 1024;
+
+void EncodeFrame(const FrameHeader& header, const uint8_t* payload, std::vector<uint8_t>& out);
+
+// kEvent payload: type, process and thread IDs, then length-prefixed module, description and metadata strings
+void EncodeEventPayload(const DebugEvent& event, std::vector<uint8_t>& out);
+bool DecodeEventPayload(const Frame& frame, DebugEvent& event);
+
+/**
+ * @brief Reassembles frames from a byte stream delivered in arbitrary pieces
+ */
+class FrameDecoder {
+public:
+    void Feed(const uint8_t* data, size_t size);
+
+    /**
+     * @brief Pop the next complete frame
+     *
+     * Returns false when more bytes are needed; sets error on a bad header,
+     * after which the stream cannot be resynchronized.
+     */
+    bool Next(Frame& frame, std::string& error);
+
+    void Reset();
+    size_t GetBufferedSize() const { return buffer_.size() - consumed_; }
+
+private:
+    std::vector<uint8_t> buffer_;
+    size_t consumed_ = 0;
+};
+
+} // namespace mcp
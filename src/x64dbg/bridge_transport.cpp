@@ -0,0 +1,250 @@
+#include "bridge_transport.hpp"
+#include <algorithm>
+#include <string>
+
+#ifdef _WIN32
+#include <ws2tcpip.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace mcp {
+
+#ifdef _WIN32
+Result<void> PipeTransport::Send(const uint8_t* data, size_t size) {
+    while (size > 0) {
+        const DWORD request = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+        DWORD written = 0;
+        if (!WriteFile(pipe_, data, request, &written, nullptr)) {
+            return Result<void>::Error("Pipe write failed: " + std::to_string(GetLastError()));
+        }
+        data += written;
+        size -= written;
+    }
+    return Result<void>::Success();
+}
+
+Result<size_t> PipeTransport::Receive(uint8_t* buffer, size_t capacity) {
+    DWORD read = 0;
+    const DWORD request = static_cast<DWORD>(std::min<size_t>(capacity, 1u << 30));
+    if (!ReadFile(pipe_, buffer, request, &read, nullptr)) {
+        const DWORD error = GetLastError();
+        if (error == ERROR_BROKEN_PIPE) {
+            return Result<size_t>::Success(0);
+        }
+        if (error != ERROR_MORE_DATA) { // Message-mode pipes report partial messages this way
+            return Result<size_t>::Error("Pipe read failed: " + std::to_string(error));
+        }
+    }
+    return Result<size_t>::Success(read);
+}
+
+void PipeTransport::Close() {
+    if (pipe_ != INVALID_HANDLE_VALUE) {
+        CancelIoEx(pipe_, nullptr); // Wake a ReadFile blocked on another thread
+        pipe_ = INVALID_HANDLE_VALUE;
+    }
+}
+#endif
+
+namespace {
+
+using NativeSocket = SocketTransport::NativeSocket;
+
+#ifdef _WIN32
+constexpr NativeSocket kNoSocket = INVALID_SOCKET;
+constexpr int kTimedOut = WSAETIMEDOUT;
+constexpr int kSendFlags = 0;
+
+int LastSocketError() {
+    return WSAGetLastError();
+}
+
+bool Interrupted(int error) {
+    return error == WSAEINTR;
+}
+
+void CloseSocket(NativeSocket socket) {
+    closesocket(socket);
+}
+#else
+constexpr NativeSocket kNoSocket = -1;
+constexpr int kTimedOut = ETIMEDOUT;
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL; // A peer that hung up is an error, not SIGPIPE
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+int LastSocketError() {
+    return errno;
+}
+
+bool Interrupted(int error) {
+    return error == EINTR;
+}
+
+void CloseSocket(NativeSocket socket) {
+    ::close(socket);
+}
+#endif
+
+bool SetBlocking(NativeSocket socket, bool blocking) {
+#ifdef _WIN32
+    u_long non_blocking = blocking ? 0 : 1;
+    return ioctlsocket(socket, FIONBIO, &non_blocking) == 0;
+#else
+    const int flags = fcntl(socket, F_GETFL, 0);
+    return flags >= 0 && fcntl(socket, F_SETFL, blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK) == 0;
+#endif
+}
+
+// Returns 0 once socket is connected to address, or the socket error
+int ConnectWithin(NativeSocket socket, const sockaddr* address, socklen_t length, int timeout_ms) {
+    if (!SetBlocking(socket, false)) {
+        return LastSocketError();
+    }
+    if (::connect(socket, address, length) != 0) {
+        const int error = LastSocketError();
+#ifdef _WIN32
+        if (error != WSAEWOULDBLOCK) {
+            return error;
+        }
+        fd_set writable;
+        fd_set failed; // Winsock reports a refused connect here rather than as writable
+        FD_ZERO(&writable);
+        FD_ZERO(&failed);
+        FD_SET(socket, &writable);
+        FD_SET(socket, &failed);
+        timeval timeout{timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+        const int ready = select(0, nullptr, &writable, &failed, &timeout);
+#else
+        if (error != EINPROGRESS) {
+            return error;
+        }
+        pollfd entry{socket, POLLOUT, 0};
+        int ready;
+        do {
+            ready = ::poll(&entry, 1, timeout_ms);
+        } while (ready < 0 && Interrupted(LastSocketError()));
+#endif
+        if (ready == 0) {
+            return kTimedOut;
+        }
+        if (ready < 0) {
+            return LastSocketError();
+        }
+        int connect_error = 0;
+        socklen_t size = sizeof(connect_error);
+        if (getsockopt(socket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&connect_error), &size) != 0) {
+            return LastSocketError();
+        }
+        if (connect_error != 0) {
+            return connect_error;
+        }
+    }
+    return SetBlocking(socket, true) ? 0 : LastSocketError();
+}
+
+} // anonymous namespace
+
+SocketTransport::~SocketTransport() {
+    Close();
+    CloseSocket(socket_);
+}
+
+Result<std::unique_ptr<SocketTransport>> SocketTransport::Connect(const std::string& host, uint16_t port,
+                                                                  int timeout_ms) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+    addrinfo* addresses = nullptr;
+    const std::string service = std::to_string(port);
+    const int resolved = getaddrinfo(host.c_str(), service.c_str(), &hints, &addresses);
+    if (resolved != 0) {
+        return Result<std::unique_ptr<SocketTransport>>::Error("Cannot resolve " + host + ": " +
+                                                               std::to_string(resolved));
+    }
+
+    int error = 0;
+    for (const addrinfo* address = addresses; address; address = address->ai_next) {
+        const NativeSocket socket = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (socket == kNoSocket) {
+            error = LastSocketError();
+            continue;
+        }
+        error = ConnectWithin(socket, address->ai_addr, static_cast<socklen_t>(address->ai_addrlen),
+                              std::max(timeout_ms, 0));
+        if (error != 0) {
+            CloseSocket(socket);
+            continue;
+        }
+
+        // Requests are small and each one waits on its reply
+        const int no_delay = 1;
+        setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&no_delay), sizeof(no_delay));
+#ifdef SO_NOSIGPIPE
+        setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &no_delay, sizeof(no_delay));
+#endif
+        freeaddrinfo(addresses);
+        return Result<std::unique_ptr<SocketTransport>>::Success(std::make_unique<SocketTransport>(socket));
+    }
+    freeaddrinfo(addresses);
+    return Result<std::unique_ptr<SocketTransport>>::Error("Failed to connect to " + host + ":" + service + ": " +
+                                                           std::to_string(error));
+}
+
+Result<void> SocketTransport::Send(const uint8_t* data, size_t size) {
+    while (size > 0) {
+        const int request = static_cast<int>(std::min<size_t>(size, 1u << 30));
+        const auto sent = ::send(socket_, reinterpret_cast<const char*>(data), request, kSendFlags);
+        if (sent < 0) {
+            const int error = LastSocketError();
+            if (Interrupted(error)) {
+                continue;
+            }
+            return Result<void>::Error("Socket send failed: " + std::to_string(error));
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return Result<void>::Success();
+}
+
+Result<size_t> SocketTransport::Receive(uint8_t* buffer, size_t capacity) {
+    const int request = static_cast<int>(std::min<size_t>(capacity, 1u << 30));
+    for (;;) {
+        const auto received = ::recv(socket_, reinterpret_cast<char*>(buffer), request, 0);
+        if (received >= 0) {
+            return Result<size_t>::Success(static_cast<size_t>(received));
+        }
+        const int error = LastSocketError();
+        if (Interrupted(error)) {
+            continue;
+        }
+        if (closed_.load()) {
+            return Result<size_t>::Success(0); // Some stacks fail the read instead of reporting EOF after shutdown
+        }
+        return Result<size_t>::Error("Socket receive failed: " + std::to_string(error));
+    }
+}
+
+void SocketTransport::Close() {
+    if (!closed_.exchange(true)) {
+#ifdef _WIN32
+        ::shutdown(socket_, SD_BOTH);
+#else
+        ::shutdown(socket_, SHUT_RDWR);
+#endif
+    }
+}
+
+} // namespace mcp
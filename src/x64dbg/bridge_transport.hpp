@@ -0,0 +1,87 @@
+#pragma once
+
+#include "mcp/interfaces.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <windows.h>
+#undef WIN32_LEAN_AND_MEAN
+#endif
+
+namespace mcp {
+
+/**
+ * @brief Byte stream to the debugger side of the bridge
+ *
+ * Send() writes the whole buffer or fails; Receive() blocks until at least
+ * one byte is available and returns how many were read (0 = closed).
+ * Close() may be called from another thread and must make a blocked
+ * Receive() return.
+ */
+class IBridgeTransport {
+public:
+    virtual ~IBridgeTransport() = default;
+
+    virtual Result<void> Send(const uint8_t* data, size_t size) = 0;
+    virtual Result<size_t> Receive(uint8_t* buffer, size_t capacity) = 0;
+    virtual void Close() = 0;
+};
+
+#ifdef _WIN32
+/**
+ * @brief Transport over a connected named pipe; the handle stays owned by the bridge
+ */
+class PipeTransport : public IBridgeTransport {
+public:
+    explicit PipeTransport(HANDLE pipe) : pipe_(pipe) {}
+
+    Result<void> Send(const uint8_t* data, size_t size) override;
+    Result<size_t> Receive(uint8_t* buffer, size_t capacity) override;
+    void Close() override;
+
+private:
+    HANDLE pipe_;
+};
+#endif
+
+/**
+ * @brief Transport over a connected TCP stream; owns the socket
+ *
+ * Close() shuts the stream down, so a Receive() blocked on another thread
+ * returns 0; the socket itself is released on destruction. On Windows the
+ * caller must have initialized Winsock.
+ */
+class SocketTransport : public IBridgeTransport {
+public:
+#ifdef _WIN32
+    using NativeSocket = SOCKET;
+#else
+    using NativeSocket = int;
+#endif
+
+    static constexpr uint16_t kDefaultPort = 27042;
+
+    explicit SocketTransport(NativeSocket socket) : socket_(socket) {}
+    ~SocketTransport() override;
+    SocketTransport(const SocketTransport&) = delete;
+    SocketTransport& operator=(const SocketTransport&) = delete;
+
+    // Tries each address host resolves to, giving each at most timeout_ms to accept
+    static Result<std::unique_ptr<SocketTransport>> Connect(const std::string& host, uint16_t port, int timeout_ms);
+
+    Result<void> Send(const uint8_t* data, size_t size) override;
+    Result<size_t> Receive(uint8_t* buffer, size_t capacity) override;
+    void Close() override;
+
+private:
+    NativeSocket socket_;
+    std::atomic<bool> closed_{false};
+};
+
+} // namespace mcp
@@ -0,0 +1,135 @@
+#include "compact_event.hpp"
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+
+namespace mcp {
+
+EventStringTable::EventStringTable() {
+    strings_.emplace_back();
+    ids_.emplace(std::string_view(strings_.front()), 0);
+}
+
+uint32_t EventStringTable::Intern(std::string_view text) {
+    if (text.empty()) {
+        return 0;
+    }
+    {
+        const std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(text);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+    }
+
+    const std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(text); // Another thread may have added it in between
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    if (strings_.size() >= kMaxStrings) {
+        return 0;
+    }
+    const uint32_t id = static_cast<uint32_t>(strings_.size());
+    strings_.emplace_back(text);
+    ids_.emplace(std::string_view(strings_.back()), id);
+    return id;
+}
+
+std::string_view EventStringTable::Lookup(uint32_t id) const {
+    const std::shared_lock<std::shared_mutex> lock(mutex_);
+    return id < strings_.size() ? std::string_view(strings_[id]) : std::string_view();
+}
+
+size_t EventStringTable::Size() const {
+    const std::shared_lock<std::shared_mutex> lock(mutex_);
+    return strings_.size();
+}
+
+int64_t CompactDebugEvent::Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool CompactDebugEvent::AddMetadata(uint32_t key, uint64_t value, bool is_string) {
+    if (metadata_count == kMaxMetadata) {
+        return false;
+    }
+    Metadata& entry = metadata[metadata_count++];
+    entry.key = key;
+    entry.is_string = is_string;
+    entry.value = value;
+    return true;
+}
+
+bool CompactEvent(const DebugEvent& event, EventStringTable& strings, CompactDebugEvent& compact) {
+    compact = CompactDebugEvent();
+    compact.type = event.type;
+    compact.process_id = event.process_id;
+    compact.thread_id = event.thread_id;
+    compact.module_id = strings.Intern(event.module_name);
+    compact.description_id = strings.Intern(event.description);
+    compact.address = event.address;
+
+    // Rebase the wall-clock time onto the steady clock used by compact records
+    const auto age = std::chrono::system_clock::now() - event.timestamp;
+    compact.timestamp_ns = CompactDebugEvent::Now() -
+                           std::chrono::duration_cast<std::chrono::nanoseconds>(age).count();
+
+    if (event.metadata.size() > CompactDebugEvent::kMaxMetadata) {
+        return false;
+    }
+    for (const auto& entry : event.metadata) {
+        compact.AddMetadata(strings.Intern(entry.first), strings.Intern(entry.second), true);
+    }
+    return true;
+}
+
+DebugEvent ExpandEvent(const CompactDebugEvent& compact, const EventStringTable& strings) {
+    DebugEvent event;
+    event.type = compact.type;
+    event.address = compact.address;
+    event.process_id = compact.process_id;
+    event.thread_id = compact.thread_id;
+    event.module_name = std::string(strings.Lookup(compact.module_id));
+    event.description = std::string(strings.Lookup(compact.description_id));
+
+    const auto age = std::chrono::nanoseconds(CompactDebugEvent::Now() - compact.timestamp_ns);
+    event.timestamp = std::chrono::system_clock::now() -
+                      std::chrono::duration_cast<std::chrono::system_clock::duration>(age);
+
+    for (uint8_t i = 0; i < compact.metadata_count; ++i) {
+        const CompactDebugEvent::Metadata& entry = compact.metadata[i];
+        std::string key(strings.Lookup(entry.key));
+        if (entry.is_string) {
+            event.metadata[key] = std::string(strings.Lookup(static_cast<uint32_t>(entry.value)));
+        } else {
+            char number[24];
+            std::snprintf(number, sizeof(number), "0x%llx", static_cast<unsigned long long>(entry.value));
+            event.metadata[key] = number;
+        }
+    }
+    if (compact.repeat_count > 1) {
+        event.metadata["coalesced_count"] = std::to_string(compact.repeat_count);
+    }
+    return event;
+}
+
+bool IsRepeatOf(const CompactDebugEvent& event, const CompactDebugEvent& previous) {
+    if (event.type != previous.type || event.address != previous.address ||
+        event.thread_id != previous.thread_id || event.process_id != previous.process_id ||
+        event.module_id != previous.module_id || event.description_id != previous.description_id ||
+        event.metadata_count != previous.metadata_count) {
+        return false;
+    }
+    for (uint8_t i = 0; i < event.metadata_count; ++i) {
+        const auto& a = event.metadata[i];
+        const auto& b = previous.metadata[i];
+        if (a.key != b.key || a.is_string != b.is_string || a.value != b.value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace mcp
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "mcp/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+namespace mcp {
+
+/**
+ * @brief Append-only table mapping event strings to small integer IDs
+ *
+ * Module names, descriptions and metadata keys repeat endlessly across
+ * events, so each is stored once and events carry its ID. ID 0 is the
+ * empty string. Strings are never removed, which keeps Lookup() results
+ * valid for the lifetime of the table; once kMaxStrings are stored, new
+ * strings map to 0.
+ */
+class EventStringTable {
+public:
+    static constexpr size_t kMaxStrings = 65536;
+
+    EventStringTable();
+
+    uint32_t Intern(std::string_view text);
+    std::string_view Lookup(uint32_t id) const;
+    size_t Size() const;
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::deque<std::string> strings_;  // Stable addresses for the views in ids_
+    std::unordered_map<std::string_view, uint32_t> ids_;
+};
+
+/**
+ * @brief Allocation-free record of one debug event
+ *
+ * Trivially copyable, so posting one costs a copy into the event ring.
+ * Metadata values are either integers or interned strings. repeat_count
+ * is above 1 when the record stands for several identical events.
+ */
+struct CompactDebugEvent {
+    static constexpr size_t kMaxMetadata = 4;
+
+    struct Metadata {
+        uint32_t key = 0;         // Interned
+        bool is_string = false;   // value is an interned string ID rather than a number
+        uint64_t value = 0;
+    };
+
+    DebugEvent::Type type = DebugEvent::Type::BREAKPOINT_HIT;
+    uint32_t process_id = 0;
+    uint32_t thread_id = 0;
+    uint32_t module_id = 0;
+    uint32_t description_id = 0;
+    uint32_t repeat_count = 1;
+    uintptr_t address = 0;
+    int64_t timestamp_ns = 0;     // steady_clock
+    uint8_t metadata_count = 0;
+    Metadata metadata[kMaxMetadata];
+
+    // Steady-clock timestamp for events built on the hot path
+    static int64_t Now();
+
+    bool AddMetadata(uint32_t key, uint64_t value, bool is_string = false);
+};
+
+static_assert(std::is_trivially_copyable<CompactDebugEvent>::value,
+              "CompactDebugEvent must stay cheap to copy through the event ring");
+
+/**
+ * @brief Compact form of event; false if its metadata does not fit inline
+ */
+bool CompactEvent(const DebugEvent& event, EventStringTable& strings, CompactDebugEvent& compact);
+
+/**
+ * @brief Rich event for handlers that want one, with "coalesced_count" set for repeats
+ */
+DebugEvent ExpandEvent(const CompactDebugEvent& compact, const EventStringTable& strings);
+
+// Same kind of event at the same place on the same thread; repeat_count and timestamps are ignored
+bool IsRepeatOf(const CompactDebugEvent& event, const CompactDebugEvent& previous);
+
+} // namespace mcp
@@ -0,0 +1,166 @@
+#include "page_cache.hpp"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace mcp {
+
+PageCache::PageCache(size_t capacity_pages)
+    : capacity_(capacity_pages) {
+}
+
+void PageCache::SetCapacity(size_t capacity_pages) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity_pages;
+    EvictToCapacity();
+}
+
+size_t PageCache::GetCapacity() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+}
+
+Result<std::vector<uint8_t>> PageCache::Read(uintptr_t address, size_t size, const Fetcher& fetch) {
+    if (size == 0 || address + size < address) {
+        return fetch(address, size);
+    }
+
+    const uintptr_t first_page = address & ~static_cast<uintptr_t>(kPageSize - 1);
+    const uintptr_t last_page = (address + size - 1) & ~static_cast<uintptr_t>(kPageSize - 1);
+    const size_t page_count = (last_page - first_page) / kPageSize + 1;
+
+    std::vector<std::pair<uintptr_t, size_t>> missing; // Page runs: base, page count
+    std::vector<uint8_t> result;
+    uint64_t generation = 0;
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        if (page_count > capacity_) {
+            // A read the cache cannot hold would only flush it
+            if (capacity_ != 0) {
+                ++stats_.bypassed;
+            }
+        } else {
+            result.resize(size);
+            for (uintptr_t page = first_page;; page += kPageSize) {
+                auto it = pages_.find(page);
+                if (it != pages_.end()) {
+                    lru_.splice(lru_.begin(), lru_, it->second);
+                    CopyOverlap(result, address, page, it->second->data.data(), kPageSize);
+                    ++stats_.hits;
+                } else {
+                    if (!missing.empty() && missing.back().first + missing.back().second * kPageSize == page) {
+                        ++missing.back().second;
+                    } else {
+                        missing.emplace_back(page, 1);
+                    }
+                    ++stats_.misses;
+                }
+                if (page == last_page) {
+                    break;
+                }
+            }
+            generation = generation_;
+        }
+    }
+    if (result.empty()) {
+        return fetch(address, size);
+    }
+
+    for (const auto& run : missing) {
+        const size_t run_size = run.second * kPageSize;
+        auto fetched = fetch(run.first, run_size);
+        if (!fetched.IsSuccess() && run.first <= address) {
+            return fetched;
+        }
+        const size_t got = fetched.IsSuccess() ? std::min(fetched.Value().size(), run_size) : 0;
+        if (got != 0) {
+            CopyOverlap(result, address, run.first, fetched.Value().data(), got);
+            StorePages(run.first, fetched.Value().data(), got / kPageSize, generation);
+        }
+
+        if (got < run_size) {
+            // The target's memory ends inside this run; everything before that was read
+            const uintptr_t readable_end = run.first + got;
+            if (readable_end < address + size) {
+                result.resize(readable_end > address ? readable_end - address : 0);
+            }
+            break;
+        }
+    }
+
+    return Result<std::vector<uint8_t>>::Success(std::move(result));
+}
+
+void PageCache::CopyOverlap(std::vector<uint8_t>& result, uintptr_t address, uintptr_t source_base,
+                            const uint8_t* source, size_t length) {
+    const uintptr_t begin = std::max(address, source_base);
+    const uintptr_t end = std::min(address + result.size(), source_base + length);
+    if (begin < end) {
+        std::memcpy(result.data() + (begin - address), source + (begin - source_base), end - begin);
+    }
+}
+
+void PageCache::StorePages(uintptr_t base, const uint8_t* data, size_t count, uint64_t generation) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (generation != generation_ || capacity_ == 0) {
+        return;
+    }
+    for (size_t p = 0; p < count; ++p) {
+        const uintptr_t page = base + p * kPageSize;
+        if (pages_.count(page) != 0) {
+            continue; // Filled by a concurrent read
+        }
+        const uint8_t* page_data = data + p * kPageSize;
+        lru_.push_front(Page{page, std::vector<uint8_t>(page_data, page_data + kPageSize)});
+        pages_[page] = lru_.begin();
+    }
+    EvictToCapacity();
+}
+
+void PageCache::Invalidate() {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    ++generation_;
+    ++stats_.invalidations;
+    lru_.clear();
+    pages_.clear();
+}
+
+void PageCache::Invalidate(uintptr_t address, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    const std::lock_guard<std::mutex> lock(mutex_);
+    ++generation_;
+    ++stats_.invalidations;
+
+    const uintptr_t first_page = address & ~static_cast<uintptr_t>(kPageSize - 1);
+    const uintptr_t end = address + size < address ? UINTPTR_MAX : address + size - 1;
+    for (uintptr_t page = first_page; page <= end; page += kPageSize) {
+        auto it = pages_.find(page);
+        if (it != pages_.end()) {
+            lru_.erase(it->second);
+            pages_.erase(it);
+        }
+        if (page > UINTPTR_MAX - kPageSize) {
+            break;
+        }
+    }
+}
+
+PageCache::Stats PageCache::GetStats() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.cached_pages = pages_.size();
+    stats.capacity_pages = capacity_;
+    return stats;
+}
+
+void PageCache::EvictToCapacity() {
+    while (pages_.size() > capacity_) {
+        pages_.erase(lru_.back().base);
+        lru_.pop_back();
+        ++stats_.evictions;
+    }
+}
+
+} // namespace mcp
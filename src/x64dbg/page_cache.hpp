@@ -0,0 +1,74 @@
+#pragma once
+
+#include "mcp/interfaces.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace mcp {
+
+/**
+ * @brief LRU cache of debuggee memory in 4 KB pages
+ *
+ * Only whole pages that were read completely are stored, so a cached read
+ * returns exactly what the fetcher would have. Reads that miss fetch each
+ * run of missing pages with one call; a short fetch ends the read there.
+ * Reads spanning more pages than the cache holds go straight to the fetcher. Invalidate() bumps a generation
+ * counter; pages fetched across an invalidation are returned to the caller
+ * but not cached, since the target may have run in the meantime.
+ */
+class PageCache {
+public:
+    static constexpr size_t kPageSize = 4096;
+
+    using Fetcher = std::function<Result<std::vector<uint8_t>>(uintptr_t address, size_t size)>;
+
+    struct Stats {
+        uint64_t hits = 0;       // Pages served from the cache
+        uint64_t misses = 0;     // Pages that had to be fetched
+        uint64_t evictions = 0;
+        uint64_t invalidations = 0;
+        uint64_t bypassed = 0;   // Reads spanning more pages than the cache holds, fetched directly
+        size_t cached_pages = 0;
+        size_t capacity_pages = 0;
+    };
+
+    explicit PageCache(size_t capacity_pages);
+
+    // 0 disables caching; shrinking evicts the least recently used pages
+    void SetCapacity(size_t capacity_pages);
+    size_t GetCapacity() const;
+
+    Result<std::vector<uint8_t>> Read(uintptr_t address, size_t size, const Fetcher& fetch);
+
+    void Invalidate();
+    void Invalidate(uintptr_t address, size_t size);
+
+    Stats GetStats() const;
+
+private:
+    struct Page {
+        uintptr_t base;
+        std::vector<uint8_t> data;
+    };
+
+    mutable std::mutex mutex_;
+    size_t capacity_;
+    std::list<Page> lru_;  // Most recently used first
+    std::unordered_map<uintptr_t, std::list<Page>::iterator> pages_;
+    uint64_t generation_ = 0;
+    Stats stats_;
+
+    void EvictToCapacity();
+    // Copy the overlap of length bytes at source_base into result, which holds the bytes at address
+    static void CopyOverlap(std::vector<uint8_t>& result, uintptr_t address, uintptr_t source_base,
+                            const uint8_t* source, size_t length);
+    // Caches count whole pages unless the cache was invalidated since generation was taken
+    void StorePages(uintptr_t base, const uint8_t* data, size_t count, uint64_t generation);
+};
+
+} // namespace mcp
@@ -0,0 +1,391 @@
+#include "shared_memory_transport.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MCP_SPIN_PAUSE() _mm_pause()
+#else
+#define MCP_SPIN_PAUSE() ((void)0)
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mcp {
+
+SpscByteRing::SpscByteRing(void* memory, size_t capacity, bool initialize)
+    : control_(static_cast<Control*>(memory)),
+      data_(static_cast<uint8_t*>(memory) + kControlSize),
+      capacity_(capacity) {
+    if (initialize) {
+        new (control_) Control();
+        control_->head.store(0, std::memory_order_relaxed);
+        control_->tail.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t SpscByteRing::Readable() const {
+    const uint64_t head = control_->head.load(std::memory_order_acquire);
+    const uint64_t tail = control_->tail.load(std::memory_order_relaxed);
+    return static_cast<size_t>(head - tail);
+}
+
+size_t SpscByteRing::Writable() const {
+    const uint64_t head = control_->head.load(std::memory_order_relaxed);
+    const uint64_t tail = control_->tail.load(std::memory_order_acquire);
+    return capacity_ - static_cast<size_t>(head - tail);
+}
+
+size_t SpscByteRing::Write(const uint8_t* data, size_t size) {
+    const uint64_t head = control_->head.load(std::memory_order_relaxed);
+    const size_t count = std::min(size, Writable());
+    const size_t offset = static_cast<size_t>(head & (capacity_ - 1));
+    const size_t first = std::min(count, capacity_ - offset);
+    std::memcpy(data_ + offset, data, first);
+    std::memcpy(data_, data + first, count - first);
+    control_->head.store(head + count, std::memory_order_release);
+    return count;
+}
+
+size_t SpscByteRing::Read(uint8_t* buffer, size_t capacity) {
+    const uint64_t tail = control_->tail.load(std::memory_order_relaxed);
+    const size_t count = std::min(capacity, Readable());
+    const size_t offset = static_cast<size_t>(tail & (capacity_ - 1));
+    const size_t first = std::min(count, capacity_ - offset);
+    std::memcpy(buffer, data_ + offset, first);
+    std::memcpy(buffer + first, data_, count - first);
+    control_->tail.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+size_t SpscByteRing::Reserve(uint8_t*& span, size_t wanted) {
+    const uint64_t head = control_->head.load(std::memory_order_relaxed);
+    const size_t offset = static_cast<size_t>(head & (capacity_ - 1));
+    span = data_ + offset;
+    return std::min({wanted, Writable(), capacity_ - offset});
+}
+
+void SpscByteRing::Commit(size_t count) {
+    const uint64_t head = control_->head.load(std::memory_order_relaxed);
+    control_->head.store(head + count, std::memory_order_release);
+}
+
+struct SharedMemoryRegion::Header {
+    static constexpr uint32_t kMagic = 0x5350434D;  // "MCPS"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kSize = 64;
+
+    uint32_t magic;
+    uint32_t version;
+    uint64_t ring_capacity;
+    uint64_t event_capacity;
+    std::atomic<uint32_t> closed;
+};
+
+namespace {
+
+bool IsPowerOfTwo(size_t value) {
+    return value >= 64 && (value & (value - 1)) == 0;
+}
+
+#ifdef _WIN32
+std::string SectionName(const std::string& name) {
+    return "Local\\" + name;
+}
+#else
+std::string SectionName(const std::string& name) {
+    return "/" + name;
+}
+#endif
+
+// Spin, then yield, then nap; returns once ready() holds or the session is closed
+template<typename Ready>
+bool WaitUntil(const SharedMemoryRegion& region, Ready ready) {
+    for (unsigned attempt = 0;; ++attempt) {
+        if (ready()) {
+            return true;
+        }
+        if (region.IsClosed()) {
+            return ready();
+        }
+        if (attempt < 2048) {
+            MCP_SPIN_PAUSE();
+        } else if (attempt < 4096) {
+            std::this_thread::yield();
+        } else {
+            // An idle peer costs a thousand wake-ups a second rather than a core
+            std::this_thread::sleep_for(std::chrono::microseconds(attempt < 8192 ? 50 : 1000));
+        }
+    }
+}
+
+} // anonymous namespace
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+    if (local_) {
+        return;
+    }
+#ifdef _WIN32
+    if (memory_) {
+        UnmapViewOfFile(memory_);
+    }
+    if (mapping_) {
+        CloseHandle(mapping_);
+    }
+#else
+    if (memory_) {
+        munmap(memory_, size_);
+    }
+    if (owner_ && !posix_name_.empty()) {
+        shm_unlink(posix_name_.c_str());
+    }
+#endif
+}
+
+size_t SharedMemoryRegion::LayoutSize(size_t ring_capacity, size_t event_capacity) {
+    return Header::kSize + 2 * SpscByteRing::RequiredSize(ring_capacity) +
+           SpscByteRing::RequiredSize(event_capacity);
+}
+
+bool SharedMemoryRegion::Attach(bool initialize, size_t ring_capacity, size_t event_capacity) {
+    static_assert(sizeof(Header) <= Header::kSize, "shared header outgrew its slot");
+    header_ = reinterpret_cast<Header*>(memory_);
+    if (initialize) {
+        new (header_) Header();
+        header_->magic = Header::kMagic;
+        header_->version = Header::kVersion;
+        header_->ring_capacity = ring_capacity;
+        header_->event_capacity = event_capacity;
+        header_->closed.store(0, std::memory_order_relaxed);
+    } else {
+        if (header_->magic != Header::kMagic || header_->version != Header::kVersion) {
+            return false;
+        }
+        ring_capacity = static_cast<size_t>(header_->ring_capacity);
+        event_capacity = static_cast<size_t>(header_->event_capacity);
+        if (!IsPowerOfTwo(ring_capacity) || !IsPowerOfTwo(event_capacity) ||
+            LayoutSize(ring_capacity, event_capacity) > size_) {
+            return false;
+        }
+    }
+
+    uint8_t* next = memory_ + Header::kSize;
+    rings_[0] = SpscByteRing(next, ring_capacity, initialize);
+    next += SpscByteRing::RequiredSize(ring_capacity);
+    rings_[1] = SpscByteRing(next, ring_capacity, initialize);
+    next += SpscByteRing::RequiredSize(ring_capacity);
+    rings_[2] = SpscByteRing(next, event_capacity, initialize);
+    return true;
+}
+
+Result<std::shared_ptr<SharedMemoryRegion>> SharedMemoryRegion::Create(const std::string& name,
+                                                                       size_t ring_capacity,
+                                                                       size_t event_capacity) {
+    using RegionResult = Result<std::shared_ptr<SharedMemoryRegion>>;
+    if (!IsPowerOfTwo(ring_capacity) || !IsPowerOfTwo(event_capacity)) {
+        return RegionResult::Error("Ring capacities must be powers of two");
+    }
+
+    std::shared_ptr<SharedMemoryRegion> region(new SharedMemoryRegion());
+    region->size_ = LayoutSize(ring_capacity, event_capacity);
+    const std::string section = SectionName(name);
+#ifdef _WIN32
+    const uint64_t size = region->size_;
+    region->mapping_ = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                          static_cast<DWORD>(size >> 32), static_cast<DWORD>(size),
+                                          section.c_str());
+    if (!region->mapping_) {
+        return RegionResult::Error("CreateFileMapping failed: " + std::to_string(GetLastError()));
+    }
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        return RegionResult::Error("Shared memory section already exists: " + name);
+    }
+    region->memory_ = static_cast<uint8_t*>(MapViewOfFile(region->mapping_, FILE_MAP_ALL_ACCESS, 0, 0, region->size_));
+    if (!region->memory_) {
+        return RegionResult::Error("MapViewOfFile failed: " + std::to_string(GetLastError()));
+    }
+#else
+    const int fd = shm_open(section.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        return RegionResult::Error("shm_open failed for " + name);
+    }
+    region->posix_name_ = section;
+    region->owner_ = true;
+    if (ftruncate(fd, static_cast<off_t>(region->size_)) != 0) {
+        close(fd);
+        return RegionResult::Error("Failed to size shared memory section");
+    }
+    void* memory = mmap(nullptr, region->size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        return RegionResult::Error("mmap failed for " + name);
+    }
+    region->memory_ = static_cast<uint8_t*>(memory);
+#endif
+
+    region->Attach(true, ring_capacity, event_capacity);
+    return RegionResult::Success(std::move(region));
+}
+
+Result<std::shared_ptr<SharedMemoryRegion>> SharedMemoryRegion::Open(const std::string& name) {
+    using RegionResult = Result<std::shared_ptr<SharedMemoryRegion>>;
+    std::shared_ptr<SharedMemoryRegion> region(new SharedMemoryRegion());
+    const std::string section = SectionName(name);
+#ifdef _WIN32
+    region->mapping_ = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, section.c_str());
+    if (!region->mapping_) {
+        return RegionResult::Error("OpenFileMapping failed: " + std::to_string(GetLastError()));
+    }
+    region->memory_ = static_cast<uint8_t*>(MapViewOfFile(region->mapping_, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+    if (!region->memory_) {
+        return RegionResult::Error("MapViewOfFile failed: " + std::to_string(GetLastError()));
+    }
+    MEMORY_BASIC_INFORMATION info;
+    if (VirtualQuery(region->memory_, &info, sizeof(info)) == 0) {
+        return RegionResult::Error("VirtualQuery failed: " + std::to_string(GetLastError()));
+    }
+    region->size_ = info.RegionSize;
+#else
+    const int fd = shm_open(section.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        return RegionResult::Error("No shared memory section named " + name);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < Header::kSize) {
+        close(fd);
+        return RegionResult::Error("Shared memory section is truncated");
+    }
+    region->size_ = static_cast<size_t>(info.st_size);
+    void* memory = mmap(nullptr, region->size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        return RegionResult::Error("mmap failed for " + name);
+    }
+    region->memory_ = static_cast<uint8_t*>(memory);
+#endif
+
+    if (region->size_ < Header::kSize || !region->Attach(false, 0, 0)) {
+        return RegionResult::Error("Shared memory section has an incompatible layout");
+    }
+    return RegionResult::Success(std::move(region));
+}
+
+bool SharedMemoryRegion::Exists(const std::string& name) {
+    const std::string section = SectionName(name);
+#ifdef _WIN32
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, section.c_str());
+    if (!mapping) {
+        return false;
+    }
+    CloseHandle(mapping);
+    return true;
+#else
+    const int fd = shm_open(section.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    close(fd);
+    return true;
+#endif
+}
+
+std::shared_ptr<SharedMemoryRegion> SharedMemoryRegion::CreateLocal(size_t ring_capacity, size_t event_capacity) {
+    std::shared_ptr<SharedMemoryRegion> region(new SharedMemoryRegion());
+    region->size_ = LayoutSize(ring_capacity, event_capacity);
+    // Over-allocate so the header and rings land on cache-line boundaries
+    region->local_.reset(new uint8_t[region->size_ + 64]);
+    const uintptr_t raw = reinterpret_cast<uintptr_t>(region->local_.get());
+    region->memory_ = region->local_.get() + ((64 - raw % 64) % 64);
+    region->Attach(true, ring_capacity, event_capacity);
+    return region;
+}
+
+void SharedMemoryRegion::MarkClosed() {
+    header_->closed.store(1, std::memory_order_release);
+}
+
+bool SharedMemoryRegion::IsClosed() const {
+    return header_->closed.load(std::memory_order_acquire) != 0;
+}
+
+SharedMemoryTransport::SharedMemoryTransport(std::shared_ptr<SharedMemoryRegion> region, Side side)
+    : region_(std::move(region)),
+      outbound_(region_->GetRing(side == Side::ENGINE ? SharedMemoryRegion::Ring::REQUEST
+                                                      : SharedMemoryRegion::Ring::RESPONSE)),
+      inbound_(region_->GetRing(side == Side::ENGINE ? SharedMemoryRegion::Ring::RESPONSE
+                                                     : SharedMemoryRegion::Ring::REQUEST)) {
+}
+
+Result<std::unique_ptr<SharedMemoryTransport>> SharedMemoryTransport::Open(const std::string& name) {
+    auto region = SharedMemoryRegion::Open(name);
+    if (!region.IsSuccess()) {
+        return Result<std::unique_ptr<SharedMemoryTransport>>::Error(region.Error());
+    }
+    return Result<std::unique_ptr<SharedMemoryTransport>>::Success(
+        std::make_unique<SharedMemoryTransport>(region.TakeValue(), Side::ENGINE));
+}
+
+Result<void> SharedMemoryTransport::Send(const uint8_t* data, size_t size) {
+    return WriteAll(outbound_, data, size);
+}
+
+Result<size_t> SharedMemoryTransport::Receive(uint8_t* buffer, size_t capacity) {
+    return ReadSome(inbound_, buffer, capacity);
+}
+
+void SharedMemoryTransport::Close() {
+    region_->MarkClosed();
+}
+
+Result<void> SharedMemoryTransport::SendInPlace(size_t size,
+                                                const std::function<void(uint8_t* span, size_t count)>& fill) {
+    while (size > 0) {
+        uint8_t* span = nullptr;
+        size_t count = 0;
+        WaitUntil(*region_, [&] { return (count = outbound_.Reserve(span, size)) != 0; });
+        if (count == 0 || region_->IsClosed()) {
+            return Result<void>::Error("Shared memory transport closed");
+        }
+        fill(span, count);
+        outbound_.Commit(count);
+        size -= count;
+    }
+    return Result<void>::Success();
+}
+
+Result<void> SharedMemoryTransport::SendEvent(const uint8_t* data, size_t size) {
+    return WriteAll(region_->GetRing(SharedMemoryRegion::Ring::EVENT), data, size);
+}
+
+Result<size_t> SharedMemoryTransport::ReceiveEvent(uint8_t* buffer, size_t capacity) {
+    return ReadSome(region_->GetRing(SharedMemoryRegion::Ring::EVENT), buffer, capacity);
+}
+
+Result<void> SharedMemoryTransport::WriteAll(SpscByteRing& ring, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        if (!WaitUntil(*region_, [&ring] { return ring.Writable() != 0; }) || region_->IsClosed()) {
+            return Result<void>::Error("Shared memory transport closed");
+        }
+        const size_t written = ring.Write(data, size);
+        data += written;
+        size -= written;
+    }
+    return Result<void>::Success();
+}
+
+Result<size_t> SharedMemoryTransport::ReadSome(SpscByteRing& ring, uint8_t* buffer, size_t capacity) {
+    if (!WaitUntil(*region_, [&ring] { return ring.Readable() != 0; })) {
+        return Result<size_t>::Success(0); // Closed and drained
+    }
+    return Result<size_t>::Success(ring.Read(buffer, capacity));
+}
+
+} // namespace mcp
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "bridge_transport.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace mcp {
+
+/**
+ * @brief Single-producer single-consumer byte ring laid out in memory it does not own
+ *
+ * Positions are free-running 64-bit counters in a control block at the
+ * start of the memory, so the same ring can be attached from two processes
+ * mapping one section. Capacity must be a power of two.
+ */
+class SpscByteRing {
+public:
+    static constexpr size_t kControlSize = 128;
+
+    static size_t RequiredSize(size_t capacity) { return kControlSize + capacity; }
+
+    SpscByteRing() = default;
+    // initialize resets the positions; only the creator of the memory does that
+    SpscByteRing(void* memory, size_t capacity, bool initialize);
+
+    size_t Capacity() const { return capacity_; }
+    size_t Readable() const;
+    size_t Writable() const;
+
+    // Copy as much as fits / is available; return the byte count
+    size_t Write(const uint8_t* data, size_t size);
+    size_t Read(uint8_t* buffer, size_t capacity);
+
+    /**
+     * @brief Contiguous free space for the producer to fill in place
+     *
+     * Returns up to wanted bytes at the write position (less at the wrap);
+     * nothing is visible to the consumer until Commit().
+     */
+    size_t Reserve(uint8_t*& span, size_t wanted);
+    void Commit(size_t count);
+
+private:
+    struct Control {
+        alignas(64) std::atomic<uint64_t> head;  // Written by the producer
+        alignas(64) std::atomic<uint64_t> tail;  // Written by the consumer
+    };
+    static_assert(sizeof(Control) <= kControlSize, "ring control block outgrew its slot");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                  "shared rings need address-free atomics");
+
+    Control* control_ = nullptr;
+    uint8_t* data_ = nullptr;
+    size_t capacity_ = 0;
+};
+
+/**
+ * @brief Mapped section shared by the x64dbg plugin and the engine
+ *
+ * Holds a small header and three rings: requests (engine to debugger),
+ * responses and events (debugger to engine). The debugger side creates
+ * the section and the engine opens it by name.
+ */
+class SharedMemoryRegion {
+public:
+    enum class Ring { REQUEST, RESPONSE, EVENT };
+
+    static constexpr size_t kDefaultRingCapacity = 4 * 1024 * 1024;
+    static constexpr size_t kDefaultEventCapacity = 256 * 1024;
+
+    ~SharedMemoryRegion();
+    SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+    SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+    static Result<std::shared_ptr<SharedMemoryRegion>> Create(const std::string& name,
+                                                              size_t ring_capacity = kDefaultRingCapacity,
+                                                              size_t event_capacity = kDefaultEventCapacity);
+    static Result<std::shared_ptr<SharedMemoryRegion>> Open(const std::string& name);
+    static bool Exists(const std::string& name);
+
+    // Both ends in this process, e.g. for a debugger simulated on a thread
+    static std::shared_ptr<SharedMemoryRegion> CreateLocal(size_t ring_capacity = kDefaultRingCapacity,
+                                                           size_t event_capacity = kDefaultEventCapacity);
+
+    SpscByteRing& GetRing(Ring ring) { return rings_[static_cast<size_t>(ring)]; }
+
+    // Either side closing ends the session for both
+    void MarkClosed();
+    bool IsClosed() const;
+
+private:
+    struct Header;
+
+    SharedMemoryRegion() = default;
+    bool Attach(bool initialize, size_t ring_capacity, size_t event_capacity);
+    static size_t LayoutSize(size_t ring_capacity, size_t event_capacity);
+
+    uint8_t* memory_ = nullptr;
+    size_t size_ = 0;
+    std::unique_ptr<uint8_t[]> local_;
+    std::string posix_name_;  // Unlinked by the creator on destruction
+    bool owner_ = false;
+    Header* header_ = nullptr;
+    SpscByteRing rings_[3];
+#ifdef _WIN32
+    HANDLE mapping_ = nullptr;
+#endif
+
+    friend class SharedMemoryTransport;
+};
+
+/**
+ * @brief IBridgeTransport over a SharedMemoryRegion
+ *
+ * Frames go through the rings with no system call: waiters spin briefly,
+ * then yield, then sleep in short steps, so a busy session sees about a
+ * microsecond per hop. The debugger side writes large read replies straight
+ * into the response ring with SendInPlace(), and reports events through a
+ * separate ring so they never queue behind bulk data.
+ */
+class SharedMemoryTransport : public IBridgeTransport {
+public:
+    enum class Side { ENGINE, DEBUGGER };
+
+    static constexpr const char* kDefaultName = "mcp_debugger_bridge";
+
+    SharedMemoryTransport(std::shared_ptr<SharedMemoryRegion> region, Side side);
+
+    // Engine side of a section published by the plugin
+    static Result<std::unique_ptr<SharedMemoryTransport>> Open(const std::string& name);
+
+    Result<void> Send(const uint8_t* data, size_t size) override;
+    Result<size_t> Receive(uint8_t* buffer, size_t capacity) override;
+    void Close() override;
+
+    /**
+     * @brief Send size bytes produced by fill directly in the outbound ring
+     *
+     * fill is called with successive contiguous pieces of the ring that add
+     * up to size and must fill each completely.
+     */
+    Result<void> SendInPlace(size_t size, const std::function<void(uint8_t* span, size_t count)>& fill);
+
+    // Event channel, debugger to engine
+    Result<void> SendEvent(const uint8_t* data, size_t size);
+    Result<size_t> ReceiveEvent(uint8_t* buffer, size_t capacity);
+
+private:
+    std::shared_ptr<SharedMemoryRegion> region_;
+    SpscByteRing& outbound_;
+    SpscByteRing& inbound_;
+
+    Result<void> WriteAll(SpscByteRing& ring, const uint8_t* data, size_t size);
+    Result<size_t> ReadSome(SpscByteRing& ring, uint8_t* buffer, size_t capacity);
+};
+
+} // namespace mcp
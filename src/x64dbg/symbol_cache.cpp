@@ -0,0 +1,208 @@
+#include "symbol_cache.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+namespace mcp {
+
+namespace {
+
+std::string ToLower(std::string_view text) {
+    std::string lower(text);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return lower;
+}
+
+std::string FormatOffset(const std::string& base_name, uintptr_t offset) {
+    if (offset == 0) {
+        return base_name;
+    }
+    char suffix[24];
+    std::snprintf(suffix, sizeof(suffix), "+0x%llx", static_cast<unsigned long long>(offset));
+    return base_name + suffix;
+}
+
+} // anonymous namespace
+
+void SymbolIndex::AddModule(const std::string& module, uintptr_t base, ModuleSymbols symbols) {
+    Module entry;
+    entry.name = module;
+    entry.base = base;
+    entry.size = symbols.size;
+    entry.symbols = std::move(symbols.symbols);
+    std::sort(entry.symbols.begin(), entry.symbols.end(),
+              [](const ModuleSymbol& a, const ModuleSymbol& b) { return a.address < b.address; });
+
+    const std::unique_lock<std::shared_mutex> lock(mutex_);
+    // A reload at the same base replaces the old image
+    modules_[base] = std::move(entry);
+    RebuildNames();
+}
+
+bool SymbolIndex::RemoveModule(uintptr_t base) {
+    const std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (modules_.erase(base) == 0) {
+        return false;
+    }
+    RebuildNames();
+    return true;
+}
+
+bool SymbolIndex::RemoveModule(const std::string& module) {
+    const std::string lower = ToLower(module);
+    const std::unique_lock<std::shared_mutex> lock(mutex_);
+    for (auto it = modules_.begin(); it != modules_.end(); ++it) {
+        if (ToLower(it->second.name) == lower) {
+            modules_.erase(it);
+            RebuildNames();
+            return true;
+        }
+    }
+    return false;
+}
+
+void SymbolIndex::Clear() {
+    const std::unique_lock<std::shared_mutex> lock(mutex_);
+    modules_.clear();
+    by_name_.clear();
+    by_qualified_.clear();
+    symbol_count_ = 0;
+}
+
+std::optional<std::string> SymbolIndex::Describe(uintptr_t address) const {
+    const std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    auto module_it = modules_.upper_bound(address);
+    if (module_it == modules_.begin()) {
+        return std::nullopt;
+    }
+    --module_it;
+    const Module& module = module_it->second;
+    if (address - module.base >= module.size) {
+        return std::nullopt;
+    }
+
+    auto symbol_it = std::upper_bound(module.symbols.begin(), module.symbols.end(), address,
+                                      [](uintptr_t value, const ModuleSymbol& symbol) { return value < symbol.address; });
+    if (symbol_it != module.symbols.begin()) {
+        const ModuleSymbol& symbol = *(symbol_it - 1);
+        if (symbol.size == 0 || address - symbol.address < symbol.size) {
+            return FormatOffset(module.name + "!" + symbol.name, address - symbol.address);
+        }
+    }
+    return FormatOffset(module.name, address - module.base);
+}
+
+std::optional<uintptr_t> SymbolIndex::Resolve(std::string_view name) const {
+    const std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    const size_t bang = name.find('!');
+    std::string key;
+    if (bang != std::string_view::npos) {
+        key = ToLower(name.substr(0, bang));
+        key += name.substr(bang);
+    } else {
+        auto it = by_name_.find(std::string(name));
+        if (it != by_name_.end()) {
+            return it->second;
+        }
+        key = ToLower(name); // Module name
+    }
+
+    auto it = by_qualified_.find(key);
+    if (it != by_qualified_.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+size_t SymbolIndex::GetModuleCount() const {
+    const std::shared_lock<std::shared_mutex> lock(mutex_);
+    return modules_.size();
+}
+
+size_t SymbolIndex::GetSymbolCount() const {
+    const std::shared_lock<std::shared_mutex> lock(mutex_);
+    return symbol_count_;
+}
+
+void SymbolIndex::RebuildNames() {
+    // Module loads are rare next to lookups; a full rebuild keeps the tie-breaking order simple
+    by_name_.clear();
+    by_qualified_.clear();
+    symbol_count_ = 0;
+    for (const auto& entry : modules_) {
+        const Module& module = entry.second;
+        const std::string prefix = ToLower(module.name) + "!";
+        by_qualified_.emplace(ToLower(module.name), module.base);
+        for (const ModuleSymbol& symbol : module.symbols) {
+            by_name_.emplace(symbol.name, symbol.address);
+            by_qualified_.emplace(prefix + symbol.name, symbol.address);
+        }
+        symbol_count_ += module.symbols.size();
+    }
+}
+
+DisassemblyCache::DisassemblyCache(size_t capacity)
+    : capacity_(capacity) {
+}
+
+bool DisassemblyCache::Get(uintptr_t address, uint64_t page_hash, std::string& text) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(Key{address, page_hash});
+    if (it == entries_.end()) {
+        ++stats_.misses;
+        return false;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    text = it->second->text;
+    ++stats_.hits;
+    return true;
+}
+
+void DisassemblyCache::Put(uintptr_t address, uint64_t page_hash, std::string text) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0) {
+        return;
+    }
+
+    const Key key{address, page_hash};
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        it->second->text = std::move(text);
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return;
+    }
+
+    lru_.push_front(Entry{address, page_hash, std::move(text)});
+    entries_[key] = lru_.begin();
+    while (entries_.size() > capacity_) {
+        entries_.erase(Key{lru_.back().address, lru_.back().page_hash});
+        lru_.pop_back();
+    }
+}
+
+void DisassemblyCache::Clear() {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    entries_.clear();
+}
+
+DisassemblyCache::Stats DisassemblyCache::GetStats() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.entries = entries_.size();
+    return stats;
+}
+
+uint64_t DisassemblyCache::HashPage(const uint8_t* data, size_t size) {
+    uint64_t hash = 0xCBF29CE484222325ULL; // FNV-1a
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+} // namespace mcp
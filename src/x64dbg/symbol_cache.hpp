@@ -0,0 +1,121 @@
+#pragma once
+
+#include "mcp/interfaces.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace mcp {
+
+struct ModuleSymbol {
+    uintptr_t address = 0;  // Absolute
+    size_t size = 0;        // 0 when unknown: the symbol then extends to the next one
+    std::string name;
+};
+
+struct ModuleSymbols {
+    size_t size = 0;  // Bytes covered by the module image
+    std::vector<ModuleSymbol> symbols;
+};
+
+/**
+ * @brief Address-to-symbol interval index with a reverse name hash
+ *
+ * Modules are kept in a map keyed by base address and their symbols sorted
+ * by address, so a lookup is two binary searches. Names resolve bare
+ * ("CreateFileW", lowest-based module wins), qualified
+ * ("kernel32.dll!CreateFileW") or as a module name for its base; module
+ * names compare case-insensitively.
+ */
+class SymbolIndex {
+public:
+    void AddModule(const std::string& module, uintptr_t base, ModuleSymbols symbols);
+    bool RemoveModule(uintptr_t base);
+    bool RemoveModule(const std::string& module);  // Case-insensitive
+    void Clear();
+
+    // "module!symbol+0x10", "module+0x1234" outside any symbol, nothing outside every module
+    std::optional<std::string> Describe(uintptr_t address) const;
+    std::optional<uintptr_t> Resolve(std::string_view name) const;
+
+    size_t GetModuleCount() const;
+    size_t GetSymbolCount() const;
+
+private:
+    struct Module {
+        std::string name;
+        uintptr_t base = 0;
+        size_t size = 0;
+        std::vector<ModuleSymbol> symbols;  // Sorted by address
+    };
+
+    mutable std::shared_mutex mutex_;
+    std::map<uintptr_t, Module> modules_;
+    std::unordered_map<std::string, uintptr_t> by_name_;        // Bare names
+    std::unordered_map<std::string, uintptr_t> by_qualified_;   // lower(module) + "!" + name, and lower(module)
+    size_t symbol_count_ = 0;
+
+    void RebuildNames();
+};
+
+/**
+ * @brief LRU cache of disassembly text keyed by address and code-page hash
+ *
+ * The hash of the page holding the address is part of the key, so patched
+ * or unpacked code misses without any explicit invalidation; entries for
+ * the old bytes simply age out.
+ */
+class DisassemblyCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t entries = 0;
+    };
+
+    explicit DisassemblyCache(size_t capacity);
+
+    bool Get(uintptr_t address, uint64_t page_hash, std::string& text);
+    void Put(uintptr_t address, uint64_t page_hash, std::string text);
+    void Clear();
+    Stats GetStats() const;
+
+    static uint64_t HashPage(const uint8_t* data, size_t size);
+
+private:
+    struct Entry {
+        uintptr_t address;
+        uint64_t page_hash;
+        std::string text;
+    };
+
+    struct Key {
+        uintptr_t address;
+        uint64_t page_hash;
+        bool operator==(const Key& other) const {
+            return address == other.address && page_hash == other.page_hash;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return std::hash<uint64_t>()(static_cast<uint64_t>(key.address) * 0x9E3779B97F4A7C15ULL ^ key.page_hash);
+        }
+    };
+
+    mutable std::mutex mutex_;
+    size_t capacity_;
+    std::list<Entry> lru_;  // Most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entries_;
+    Stats stats_;
+};
+
+} // namespace mcp
@@ -1,4 +1,5 @@
 #include "x64dbg_bridge.hpp"
+#include "mcp/hex_codec.hpp"
 #include <iostream>
 #include <sstream>
 #include <regex>
@@ -14,6 +15,9 @@
 #include <atomic>
 #include <vector>
 #include <chrono>
+#include <cstring>
+#include <numeric>
+#include <optional>
 
 namespace mcp {
 
@@ -22,8 +26,37 @@ bool X64DbgBridge::plugin_initialized_ = false;
 X64DbgBridge* X64DbgBridge::plugin_instance_ = nullptr;
 #endif
 
+namespace {
+
+// The target stopped after running, or its address space changed; thread start and exit
+// are reported while it keeps running, and the next stop invalidates anyway
+bool MayChangeDebuggeeMemory(DebugEvent::Type type) {
+    return type != DebugEvent::Type::THREAD_CREATED && type != DebugEvent::Type::THREAD_TERMINATED;
+}
+
+Result<std::string> CommandReplyText(const Result<Frame>& frame_result) {
+    if (!frame_result.IsSuccess()) {
+        return Result<std::string>::Error(frame_result.Error());
+    }
+
+    const Frame& frame = frame_result.Value();
+    std::string text(frame.payload.begin(), frame.payload.end());
+    if (frame.header.type == FrameType::kError) {
+        return Result<std::string>::Error(text);
+    }
+    if (frame.header.type != FrameType::kCommandReply) {
+        return Result<std::string>::Error("Malformed command reply");
+    }
+    return Result<std::string>::Success(std::move(text));
+}
+
+} // anonymous namespace
+
 X64DbgBridge::X64DbgBridge(std::shared_ptr<ILogger> logger) 
-    : logger_(std::move(logger)) {
+    : logger_(std::move(logger)),
+      event_handlers_(std::make_shared<const std::vector<EventHandlerEntry>>()),
+      compact_handlers_(std::make_shared<const std::vector<CompactHandlerEntry>>()),
+      event_queue_(std::make_unique<MpscRing<QueuedEvent>>(4096)) {
     
     if (logger_) {
         logger_->Log(ILogger::LOG_INFO, "X64DbgBridge initialized");
@@ -35,25 +68,26 @@ X64DbgBridge::X64DbgBridge(std::shared_ptr<ILogger> logger)
 }
 
 X64DbgBridge::~X64DbgBridge() {
+    StopStatsExport();
+
     // Avoid virtual call in destructor - call DisconnectInternal directly
     if (connected_.load()) {
-        event_thread_running_ = false;
-        event_condition_.notify_all();
-        
-        if (event_thread_.joinable()) {
-            event_thread_.join();
-        }
-        
+        StopEventThread();
         DisconnectInternal();
         connected_ = false;
     }
     
     if (event_thread_running_) {
-        event_thread_running_ = false;
-        event_condition_.notify_all();
-        if (event_thread_.joinable()) {
-            event_thread_.join();
+        StopEventThread();
+    }
+
+    // Callback workers use this bridge; with the transport gone they finish promptly
+    {
+        const std::lock_guard<std::mutex> lock(async_tasks_mutex_);
+        for (auto& task : async_tasks_) {
+            task.wait();
         }
+        async_tasks_.clear();
     }
     
 #ifdef _WIN32
@@ -91,6 +125,9 @@ Result<void> X64DbgBridge::Connect() {
         case ConnectionMode::TCP:
             connect_result = ConnectTCP();
             break;
+        case ConnectionMode::SHARED_MEMORY:
+            connect_result = ConnectSharedMemory();
+            break;
         default:
             return Result<void>::Error("Invalid connection mode");
     }
@@ -101,6 +138,22 @@ Result<void> X64DbgBridge::Connect() {
         // Start event processing thread
         event_thread_running_ = true;
         event_thread_ = std::thread(&X64DbgBridge::EventProcessingLoop, this);
+
+        // Replies and stream events are read by one thread for the whole connection
+        if (UsesFramedTransport()) {
+            {
+                const std::lock_guard<std::mutex> reply_lock(reply_mutex_);
+                receiver_running_ = true;
+            }
+            receive_thread_ = std::thread(&X64DbgBridge::ReceiveLoop, this);
+        }
+
+        // The shared section carries events on a ring of their own
+        auto* shared = connection_mode_ == ConnectionMode::SHARED_MEMORY
+                           ? dynamic_cast<SharedMemoryTransport*>(transport_.get()) : nullptr;
+        if (shared) {
+            transport_event_thread_ = std::thread(&X64DbgBridge::TransportEventLoop, this, shared);
+        }
         
         if (logger_) {
             logger_->Log(ILogger::LOG_INFO, "Connected to x64dbg");
@@ -118,13 +171,7 @@ Result<void> X64DbgBridge::Disconnect() {
     }
     
     // Stop event processing
-    event_thread_running_ = false;
-    event_condition_.notify_all();
-    
-    if (event_thread_.joinable()) {
-        event_thread_.join();
-    }
-    
+    StopEventThread();
     DisconnectInternal();
     connected_ = false;
     
@@ -136,12 +183,9 @@ Result<void> X64DbgBridge::Disconnect() {
 }
 
 Result<std::string> X64DbgBridge::ExecuteCommand(const std::string& command) {
-    if (!connected_) {
-        return Result<std::string>::Error("Not connected to debugger");
-    }
-    
-    if (command.empty()) {
-        return Result<std::string>::Error("Command cannot be empty");
+    auto prepare_result = PrepareCommand(command);
+    if (!prepare_result.IsSuccess()) {
+        return Result<std::string>::Error(prepare_result.Error());
     }
     
     auto send_result = SendCommand(command);
@@ -161,6 +205,117 @@ Result<std::string> X64DbgBridge::ExecuteCommand(const std::string& command) {
     return parse_result;
 }
 
+std::future<Result<std::string>> X64DbgBridge::ExecuteCommandAsync(const std::string& command) {
+    auto promise = std::make_shared<std::promise<Result<std::string>>>();
+    auto future = promise->get_future();
+    StartCommandAsync(command, [promise](Result<std::string> result) { promise->set_value(std::move(result)); });
+    return future;
+}
+
+void X64DbgBridge::ExecuteCommandAsync(const std::string& command, CommandCallback on_complete) {
+    StartCommandAsync(command, [this, on_complete = std::move(on_complete)](Result<std::string> result) {
+        if (!on_complete) {
+            return;
+        }
+        // Off the receive thread, so the callback may issue commands of its own
+        Dispatch([this, on_complete, result = std::move(result)]() {
+            try {
+                on_complete(result);
+            } catch (...) {
+                if (logger_) {
+                    logger_->Log(ILogger::LOG_ERROR, "Exception in async command callback");
+                }
+            }
+        });
+    });
+}
+
+void X64DbgBridge::SetTaskExecutor(std::weak_ptr<ITaskExecutor> executor) {
+    executor_ = std::move(executor);
+}
+
+void X64DbgBridge::Dispatch(std::function<void()> work) {
+    auto task = std::make_shared<std::packaged_task<void()>>(std::move(work));
+    std::future<void> done = task->get_future();
+    auto executor = executor_.lock();
+    if (!executor || !executor->Post([task]() { (*task)(); })) {
+        done = std::async(std::launch::async, [task]() { (*task)(); });
+    }
+
+    const std::lock_guard<std::mutex> lock(async_tasks_mutex_);
+    async_tasks_.erase(std::remove_if(async_tasks_.begin(), async_tasks_.end(), [](const std::future<void>& task) {
+                           return task.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                       }),
+                       async_tasks_.end());
+    async_tasks_.push_back(std::move(done));
+}
+
+Result<void> X64DbgBridge::PrepareCommand(const std::string& command) {
+    if (!connected_) {
+        return Result<void>::Error("Not connected to debugger");
+    }
+    
+    if (command.empty()) {
+        return Result<void>::Error("Command cannot be empty");
+    }
+
+    // Arbitrary commands may resume the target or patch memory
+    if (!IsReadOnlyCommand(command)) {
+        memory_cache_.Invalidate();
+    }
+    return Result<void>::Success();
+}
+
+std::function<Result<std::string>()> X64DbgBridge::StartCommand(const std::string& command) {
+    if (!UsesFramedTransport()) {
+        return [this, command]() { return ExecuteCommand(command); };
+    }
+
+    // Put the request on the wire now so that later commands queue up behind it
+    auto prepare_result = PrepareCommand(command);
+    if (!prepare_result.IsSuccess()) {
+        return [error = prepare_result.Error()]() { return Result<std::string>::Error(error); };
+    }
+    auto send_result = SendCommandFrame(command);
+    if (!send_result.IsSuccess()) {
+        return [error = send_result.Error()]() { return Result<std::string>::Error(error); };
+    }
+
+    const uint32_t request_id = send_result.Value();
+    const auto started = std::chrono::steady_clock::now();
+    return [this, request_id, started]() {
+        auto reply = AwaitCommandReply(request_id);
+        Latency(BridgeOperation::COMMAND).Record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count()));
+        if (!reply.IsSuccess()) {
+            return reply;
+        }
+        return ParseCommandResponse(reply.Value());
+    };
+}
+
+void X64DbgBridge::StartCommandAsync(const std::string& command, CommandCallback on_reply) {
+    if (!UsesFramedTransport()) {
+        Dispatch([this, command, on_reply = std::move(on_reply)]() { on_reply(ExecuteCommand(command)); });
+        return;
+    }
+
+    auto prepare_result = PrepareCommand(command);
+    if (!prepare_result.IsSuccess()) {
+        on_reply(Result<std::string>::Error(prepare_result.Error()));
+        return;
+    }
+
+    // A failed send has already been reported through the callback
+    const auto started = std::chrono::steady_clock::now();
+    SendCommandFrame(command, [this, started, on_reply = std::move(on_reply)](Result<Frame> frame_result) {
+        Latency(BridgeOperation::COMMAND).Record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count()));
+        auto reply = CommandReplyText(frame_result);
+        on_reply(reply.IsSuccess() ? ParseCommandResponse(reply.Value()) : std::move(reply));
+    });
+}
+
 Result<MemoryDump> X64DbgBridge::ReadMemory(uintptr_t address, size_t size) {
     if (!connected_) {
         return Result<MemoryDump>::Error("Not connected to debugger");
@@ -178,8 +333,8 @@ Result<MemoryDump> X64DbgBridge::ReadMemory(uintptr_t address, size_t size) {
     
     MemoryDump dump;
     dump.base_address = address;
-    dump.data = data_result.Value();
-    dump.size = size;
+    dump.data = data_result.TakeValue();
+    dump.size = dump.data.size(); // Short when the tail of the range is unreadable
     dump.timestamp = std::chrono::system_clock::now();
     
     // Try to identify the module
@@ -188,7 +343,121 @@ Result<MemoryDump> X64DbgBridge::ReadMemory(uintptr_t address, size_t size) {
         dump.module_name = symbol_result.Value();
     }
     
-    return Result<MemoryDump>::Success(dump);
+    return Result<MemoryDump>::Success(std::move(dump));
+}
+
+Result<std::vector<MemoryView>> X64DbgBridge::ReadMemoryBatch(const std::vector<MemoryRange>& ranges) {
+    if (!connected_) {
+        return Result<std::vector<MemoryView>>::Error("Not connected to debugger");
+    }
+
+    ScopedLatency timer(Latency(BridgeOperation::READ_BATCH));
+    constexpr size_t MAX_BATCH_RANGES = 4096;
+    if (ranges.size() > MAX_BATCH_RANGES) {
+        return Result<std::vector<MemoryView>>::Error("Too many ranges in batch (max 4096)");
+    }
+    // Framed reads have no per-read limit, so the batch buffer is bounded here
+    constexpr size_t MAX_BATCH_RANGE_SIZE = 16 * 1024 * 1024;
+    constexpr size_t MAX_BATCH_TOTAL_SIZE = 64 * 1024 * 1024;
+
+    // Walk the ranges in address order and coalesce those that overlap or touch
+    constexpr size_t NO_SPAN = static_cast<size_t>(-1);
+    std::vector<size_t> order(ranges.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::sort(order.begin(), order.end(), [&ranges](size_t a, size_t b) {
+        return ranges[a].address < ranges[b].address;
+    });
+
+    std::vector<MemoryRange> spans;
+    std::vector<size_t> span_of(ranges.size(), NO_SPAN);
+    for (size_t index : order) {
+        const MemoryRange& range = ranges[index];
+        if (range.size == 0) {
+            continue;
+        }
+        if (range.address + range.size < range.address) {
+            return Result<std::vector<MemoryView>>::Error("Memory range wraps around the address space");
+        }
+        if (range.size > MAX_BATCH_RANGE_SIZE) {
+            return Result<std::vector<MemoryView>>::Error("Range too large in batch (max 16MB)");
+        }
+        if (!spans.empty() && range.address <= spans.back().address + spans.back().size) {
+            MemoryRange& span = spans.back();
+            span.size = std::max(span.size, static_cast<size_t>(range.address + range.size - span.address));
+        } else {
+            spans.push_back(range);
+        }
+        span_of[index] = spans.size() - 1;
+    }
+
+    std::vector<size_t> span_offsets;
+    span_offsets.reserve(spans.size());
+    size_t total_size = 0;
+    for (const MemoryRange& span : spans) {
+        auto validate_result = ValidateMemoryAccess(span.address, span.size);
+        if (!validate_result.IsSuccess()) {
+            return Result<std::vector<MemoryView>>::Error(validate_result.Error());
+        }
+        span_offsets.push_back(total_size);
+        total_size += span.size;
+        if (total_size > MAX_BATCH_TOTAL_SIZE) {
+            return Result<std::vector<MemoryView>>::Error("Batch reads too much memory (max 64MB)");
+        }
+    }
+
+    if (logger_) {
+        logger_->LogFormatted(ILogger::LOG_DEBUG, "ReadMemoryBatch: %zu ranges in %zu spans, %zu bytes",
+                              ranges.size(), spans.size(), total_size);
+    }
+
+    auto buffer = std::make_shared<std::vector<uint8_t>>(total_size);
+    std::vector<size_t> lengths;  // Bytes actually read per span
+    if (UsesFramedTransport()) {
+        if (!spans.empty()) {
+            auto read_result = ReadMemoryBatchFramed(spans, buffer->data(), lengths);
+            if (!read_result.IsSuccess()) {
+                return Result<std::vector<MemoryView>>::Error(read_result.Error());
+            }
+            // The other path is counted by ReadMemoryRaw
+            bytes_read_.fetch_add(std::accumulate(lengths.begin(), lengths.end(), size_t{0}),
+                                  std::memory_order_relaxed);
+        }
+    } else {
+        for (size_t i = 0; i < spans.size(); ++i) {
+            auto data_result = ReadMemoryRaw(spans[i].address, spans[i].size);
+            if (!data_result.IsSuccess()) {
+                return Result<std::vector<MemoryView>>::Error(data_result.Error());
+            }
+            const size_t length = std::min(data_result.Value().size(), spans[i].size);
+            std::memcpy(buffer->data() + span_offsets[i], data_result.Value().data(), length);
+            lengths.push_back(length);
+        }
+    }
+
+    std::vector<std::string> modules(spans.size());
+    for (size_t i = 0; i < spans.size(); ++i) {
+        auto symbol_result = GetSymbolAt(spans[i].address);
+        if (symbol_result.IsSuccess()) {
+            modules[i] = symbol_result.TakeValue();
+        }
+    }
+
+    std::shared_ptr<const void> owner = buffer;
+    std::vector<MemoryView> views;
+    views.reserve(ranges.size());
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        const size_t span = span_of[i];
+        if (span == NO_SPAN) {
+            views.emplace_back(buffer->data(), 0, ranges[i].address, "", owner);
+            continue;
+        }
+        const size_t offset = static_cast<size_t>(ranges[i].address - spans[span].address);
+        const size_t readable = lengths[span] > offset ? lengths[span] - offset : 0;
+        views.emplace_back(buffer->data() + span_offsets[span] + offset, std::min(ranges[i].size, readable),
+                           ranges[i].address, modules[span], owner);
+    }
+
+    return Result<std::vector<MemoryView>>::Success(std::move(views));
 }
 
 Result<void> X64DbgBridge::SetBreakpoint(uintptr_t address) {
@@ -214,9 +483,12 @@ void X64DbgBridge::RegisterEventHandler(std::function<void(const DebugEvent&)> h
     
     EventHandlerEntry entry;
     entry.id = next_handler_id_++;
-    entry.handler = handler;
+    entry.handler = std::move(handler);
     
-    event_handlers_.push_back(entry);
+    // Dispatch keeps using the old list until it takes its next snapshot
+    auto handlers = std::make_shared<std::vector<EventHandlerEntry>>(*std::atomic_load(&event_handlers_));
+    handlers->push_back(entry);
+    std::atomic_store(&event_handlers_, std::shared_ptr<const std::vector<EventHandlerEntry>>(std::move(handlers)));
     
     if (logger_) {
         logger_->LogFormatted(ILogger::LOG_DEBUG, "Registered event handler with ID %u", entry.id);
@@ -250,22 +522,95 @@ Result<void> X64DbgBridge::SetConnectionTimeout(int timeout_ms) {
     return Result<void>::Success();
 }
 
+Result<void> X64DbgBridge::SetSharedMemoryName(const std::string& name) {
+    const std::lock_guard<std::mutex> lock(connection_mutex_);
+    if (name.empty() || name.find_first_of("/\\") != std::string::npos) {
+        return Result<void>::Error("Invalid shared memory name");
+    }
+    shared_memory_name_ = name;
+    return Result<void>::Success();
+}
+
+Result<void> X64DbgBridge::SetTcpEndpoint(const std::string& host, int port) {
+    const std::lock_guard<std::mutex> lock(connection_mutex_);
+    if (host.empty() || port <= 0 || port > 65535) {
+        return Result<void>::Error("Invalid TCP endpoint");
+    }
+    tcp_host_ = host;
+    tcp_port_ = static_cast<uint16_t>(port);
+    return Result<void>::Success();
+}
+
+Result<void> X64DbgBridge::SetTransport(std::unique_ptr<IBridgeTransport> transport) {
+    const std::lock_guard<std::mutex> lock(connection_mutex_);
+
+    if (connected_) {
+        return Result<void>::Error("Cannot change transport while connected");
+    }
+
+    transport_ = std::move(transport);
+    return Result<void>::Success();
+}
+
 Result<std::string> X64DbgBridge::GetSymbolAt(uintptr_t address) {
     if (!connected_) {
         return Result<std::string>::Error("Not connected to debugger");
     }
     
+    auto symbol = symbol_index_.Describe(address);
+    if (symbol) {
+        return Result<std::string>::Success(std::move(*symbol));
+    }
+
     // Mock implementation - return generic symbol info
     std::ostringstream oss;
     oss << "symbol_at_" << std::hex << address;
     return Result<std::string>::Success(oss.str());
 }
 
+Result<uintptr_t> X64DbgBridge::ResolveSymbol(const std::string& symbol) {
+    if (!connected_) {
+        return Result<uintptr_t>::Error("Not connected to debugger");
+    }
+
+    auto address = symbol_index_.Resolve(symbol);
+    if (!address) {
+        return Result<uintptr_t>::Error("Unknown symbol: " + symbol);
+    }
+    return Result<uintptr_t>::Success(*address);
+}
+
+void X64DbgBridge::SetSymbolSource(SymbolSource source) {
+    const std::lock_guard<std::mutex> lock(symbol_source_mutex_);
+    symbol_source_ = std::move(source);
+}
+
+DisassemblyCache::Stats X64DbgBridge::GetDisassemblyCacheStats() const {
+    return disassembly_cache_.GetStats();
+}
+
 Result<std::vector<uint8_t>> X64DbgBridge::ReadMemoryRaw(uintptr_t address, size_t size) {
     if (!connected_) {
         return Result<std::vector<uint8_t>>::Error("Not connected to debugger");
     }
-    
+
+    ScopedLatency timer(Latency(BridgeOperation::READ_MEMORY));
+    // While the target is paused repeated reads of a page cost a copy instead of a round trip
+    auto result = memory_cache_.Read(address, size, [this](uintptr_t page_address, size_t page_size) {
+        return FetchMemory(page_address, page_size);
+    });
+    if (result.IsSuccess()) {
+        bytes_read_.fetch_add(result.Value().size(), std::memory_order_relaxed);
+    }
+    return result;
+}
+
+Result<std::vector<uint8_t>> X64DbgBridge::FetchMemory(uintptr_t address, size_t size) {
+    ScopedLatency timer(Latency(BridgeOperation::FETCH_MEMORY));
+    if (UsesFramedTransport()) {
+        return ReadMemoryFramed(address, size);
+    }
+
 #ifdef _WIN32
     if (connection_mode_ == ConnectionMode::EXTERNAL && process_handle_ != INVALID_HANDLE_VALUE) {
         return ReadProcessMemoryWin(address, size);
@@ -281,13 +626,21 @@ Result<std::vector<uint8_t>> X64DbgBridge::ReadMemoryRaw(uintptr_t address, size
     }
     
     auto data = ParseHexData(result.Value());
-    return Result<std::vector<uint8_t>>::Success(data);
+    return Result<std::vector<uint8_t>>::Success(std::move(data));
 }
 
 Result<void> X64DbgBridge::WriteMemory(uintptr_t address, const std::vector<uint8_t>& data) {
     if (!connected_) {
         return Result<void>::Error("Not connected to debugger");
     }
+
+    ScopedLatency timer(Latency(BridgeOperation::WRITE_MEMORY));
+    memory_cache_.Invalidate(address, data.size());
+    bytes_written_.fetch_add(data.size(), std::memory_order_relaxed);
+
+    if (UsesFramedTransport()) {
+        return WriteMemoryFramed(address, data);
+    }
     
 #ifdef _WIN32
     if (connection_mode_ == ConnectionMode::EXTERNAL && process_handle_ != INVALID_HANDLE_VALUE) {
@@ -295,13 +648,7 @@ Result<void> X64DbgBridge::WriteMemory(uintptr_t address, const std::vector<uint
     }
 #endif
     
-    // Convert data to hex string
-    std::ostringstream hex_stream;
-    for (uint8_t byte : data) {
-        hex_stream << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
-    }
-    
-    std::string command = "fill " + AddressToString(address) + " " + hex_stream.str();
+    std::string command = "fill " + AddressToString(address) + " " + HexEncode(data);
     auto result = ExecuteCommand(command);
     
     if (result.IsSuccess()) {
@@ -311,6 +658,385 @@ Result<void> X64DbgBridge::WriteMemory(uintptr_t address, const std::vector<uint
     }
 }
 
+bool X64DbgBridge::UsesFramedTransport() const {
+    return transport_ && (connection_mode_ == ConnectionMode::PIPE || connection_mode_ == ConnectionMode::TCP ||
+                          connection_mode_ == ConnectionMode::SHARED_MEMORY);
+}
+
+Result<std::vector<uint8_t>> X64DbgBridge::ReadMemoryFramed(uintptr_t address, size_t size) {
+    const RequestScope scope(*this);
+
+    FrameHeader request;
+    request.type = FrameType::kReadMemory;
+    request.flags = FrameHeader::kFlagFinal;
+    request.request_id = scope.id();
+    request.payload_size = sizeof(uint64_t);
+    request.address = address;
+    uint8_t count[sizeof(uint64_t)];
+    for (size_t i = 0; i < sizeof(count); ++i) {
+        count[i] = static_cast<uint8_t>(static_cast<uint64_t>(size) >> (8 * i));
+    }
+
+    auto send_result = SendFrame(request, count);
+    if (!send_result.IsSuccess()) {
+        return Result<std::vector<uint8_t>>::Error(send_result.Error());
+    }
+
+    // The reply arrives as consecutive chunks; a short final chunk means the rest is unreadable
+    std::vector<uint8_t> data;
+    data.reserve(size);
+    for (;;) {
+        auto frame_result = NextReplyFrame(request.request_id);
+        if (!frame_result.IsSuccess()) {
+            return Result<std::vector<uint8_t>>::Error(frame_result.Error());
+        }
+        const Frame& frame = frame_result.Value();
+        if (frame.header.type == FrameType::kError) {
+            return Result<std::vector<uint8_t>>::Error(std::string(frame.payload.begin(), frame.payload.end()));
+        }
+        if (frame.header.type != FrameType::kReadReply || frame.header.address != address + data.size() ||
+            data.size() + frame.payload.size() > size) {
+            return Result<std::vector<uint8_t>>::Error("Malformed memory read reply");
+        }
+        data.insert(data.end(), frame.payload.begin(), frame.payload.end());
+        if (frame.header.flags & FrameHeader::kFlagFinal) {
+            break;
+        }
+    }
+
+    return Result<std::vector<uint8_t>>::Success(std::move(data));
+}
+
+Result<void> X64DbgBridge::WriteMemoryFramed(uintptr_t address, const std::vector<uint8_t>& data) {
+    size_t offset = 0;
+    do {
+        const RequestScope scope(*this);
+        const size_t chunk = std::min(kMaxChunkSize, data.size() - offset);
+        FrameHeader request;
+        request.type = FrameType::kWriteMemory;
+        request.flags = offset + chunk == data.size() ? FrameHeader::kFlagFinal : 0;
+        request.request_id = scope.id();
+        request.payload_size = static_cast<uint32_t>(chunk);
+        request.address = address + offset;
+
+        auto send_result = SendFrame(request, data.data() + offset);
+        if (!send_result.IsSuccess()) {
+            return send_result;
+        }
+
+        auto frame_result = NextReplyFrame(request.request_id);
+        if (!frame_result.IsSuccess()) {
+            return Result<void>::Error(frame_result.Error());
+        }
+        const Frame& frame = frame_result.Value();
+        if (frame.header.type == FrameType::kError) {
+            return Result<void>::Error("Failed to write memory: " +
+                                       std::string(frame.payload.begin(), frame.payload.end()));
+        }
+        if (frame.header.type != FrameType::kWriteReply) {
+            return Result<void>::Error("Malformed memory write reply");
+        }
+        offset += chunk;
+    } while (offset < data.size());
+
+    return Result<void>::Success();
+}
+
+Result<void> X64DbgBridge::ReadMemoryBatchFramed(const std::vector<MemoryRange>& spans, uint8_t* buffer,
+                                                 std::vector<size_t>& lengths) {
+    const RequestScope scope(*this);
+
+    FrameHeader request;
+    request.type = FrameType::kReadBatch;
+    request.flags = FrameHeader::kFlagFinal;
+    request.request_id = scope.id();
+    request.payload_size = static_cast<uint32_t>(spans.size() * 2 * sizeof(uint64_t));
+    std::vector<uint8_t> payload;
+    payload.reserve(request.payload_size);
+    for (const MemoryRange& span : spans) {
+        for (uint64_t value : {static_cast<uint64_t>(span.address), static_cast<uint64_t>(span.size)}) {
+            for (size_t i = 0; i < sizeof(value); ++i) {
+                payload.push_back(static_cast<uint8_t>(value >> (8 * i)));
+            }
+        }
+    }
+
+    auto send_result = SendFrame(request, payload.data());
+    if (!send_result.IsSuccess()) {
+        return send_result;
+    }
+
+    // Each span is answered like a single read, one after another, each ending in its own final chunk
+    lengths.clear();
+    uint8_t* cursor = buffer;
+    for (const MemoryRange& span : spans) {
+        size_t received = 0;
+        for (;;) {
+            auto frame_result = NextReplyFrame(request.request_id);
+            if (!frame_result.IsSuccess()) {
+                return Result<void>::Error(frame_result.Error());
+            }
+            const Frame& frame = frame_result.Value();
+            if (frame.header.type == FrameType::kError) {
+                return Result<void>::Error(std::string(frame.payload.begin(), frame.payload.end()));
+            }
+            if (frame.header.type != FrameType::kReadReply || frame.header.address != span.address + received ||
+                received + frame.payload.size() > span.size) {
+                return Result<void>::Error("Malformed batch read reply");
+            }
+            if (!frame.payload.empty()) {
+                std::memcpy(cursor + received, frame.payload.data(), frame.payload.size());
+            }
+            received += frame.payload.size();
+            if (frame.header.flags & FrameHeader::kFlagFinal) {
+                break;
+            }
+        }
+        lengths.push_back(received);
+        cursor += span.size;
+    }
+
+    return Result<void>::Success();
+}
+
+void X64DbgBridge::ReceiveLoop() {
+    std::vector<uint8_t> buffer(FrameHeader::kSize + kMaxChunkSize);
+    for (;;) {
+        Frame frame;
+        std::string error;
+        while (frame_decoder_.Next(frame, error)) {
+            RouteFrame(std::move(frame));
+            frame = Frame();
+        }
+        if (!error.empty()) {
+            // Framing is lost; what is in flight fails and later requests start from a clean buffer
+            frame_decoder_.Reset();
+            FailPendingReplies(error, false);
+        }
+
+        auto received = transport_->Receive(buffer.data(), buffer.size());
+        if (!received.IsSuccess() || received.Value() == 0) {
+            FailPendingReplies(received.IsSuccess() ? "Transport closed" : received.Error(), true);
+            return;
+        }
+        bytes_received_.fetch_add(received.Value(), std::memory_order_relaxed);
+        frame_decoder_.Feed(buffer.data(), received.Value());
+    }
+}
+
+void X64DbgBridge::RouteFrame(Frame frame) {
+    if (frame.header.type == FrameType::kEvent) {
+        // Stream transports interleave events with replies
+        PostFramedEvent(frame);
+        return;
+    }
+
+    ReplyCallback on_reply;
+    {
+        const std::lock_guard<std::mutex> lock(reply_mutex_);
+        auto pending = pending_replies_.find(frame.header.request_id);
+        if (pending != pending_replies_.end() && !pending->second.on_reply) {
+            pending->second.frames.push_back(std::move(frame));
+            reply_condition_.notify_all();
+            return;
+        }
+        if (pending != pending_replies_.end()) {
+            on_reply = std::move(pending->second.on_reply);
+            pending_replies_.erase(pending);
+        }
+    }
+
+    if (!on_reply) {
+        if (logger_) {
+            logger_->LogFormatted(ILogger::LOG_WARN, "Dropping reply for unknown request %u",
+                                  frame.header.request_id);
+        }
+        return;
+    }
+    on_reply(Result<Frame>::Success(std::move(frame)));
+}
+
+void X64DbgBridge::FailPendingReplies(const std::string& error, bool closed) {
+    std::vector<ReplyCallback> callbacks;
+    {
+        const std::lock_guard<std::mutex> lock(reply_mutex_);
+        if (closed) {
+            receiver_running_ = false;
+        }
+        for (auto pending = pending_replies_.begin(); pending != pending_replies_.end();) {
+            if (pending->second.on_reply) {
+                callbacks.push_back(std::move(pending->second.on_reply));
+                pending = pending_replies_.erase(pending);
+                continue;
+            }
+            if (pending->second.error.empty()) {
+                pending->second.error = error;
+            }
+            ++pending;
+        }
+        reply_condition_.notify_all();
+    }
+    for (auto& on_reply : callbacks) {
+        on_reply(Result<Frame>::Error(error));
+    }
+}
+
+uint32_t X64DbgBridge::BeginRequest(ReplyCallback on_reply) {
+    const std::lock_guard<std::mutex> lock(reply_mutex_);
+    if (!receiver_running_) {
+        return 0;
+    }
+    if (next_request_id_ == 0) {
+        ++next_request_id_;
+    }
+    const uint32_t request_id = next_request_id_++;
+    pending_replies_[request_id].on_reply = std::move(on_reply);
+    return request_id;
+}
+
+void X64DbgBridge::EndRequest(uint32_t request_id) {
+    const std::lock_guard<std::mutex> lock(reply_mutex_);
+    pending_replies_.erase(request_id);
+}
+
+Result<Frame> X64DbgBridge::NextReplyFrame(uint32_t request_id) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(connection_timeout_ms_);
+    std::unique_lock<std::mutex> lock(reply_mutex_);
+    for (;;) {
+        auto pending = pending_replies_.find(request_id);
+        if (pending == pending_replies_.end()) {
+            return Result<Frame>::Error("Transport closed");
+        }
+        if (!pending->second.frames.empty()) {
+            Frame frame = std::move(pending->second.frames.front());
+            pending->second.frames.pop_front();
+            return Result<Frame>::Success(std::move(frame));
+        }
+        if (!pending->second.error.empty()) {
+            return Result<Frame>::Error(pending->second.error);
+        }
+        if (reply_condition_.wait_until(lock, deadline) == std::cv_status::timeout) {
+            return Result<Frame>::Error("Timed out waiting for reply");
+        }
+    }
+}
+
+Result<void> X64DbgBridge::SendFrame(const FrameHeader& header, const uint8_t* payload) {
+    std::vector<uint8_t> out;
+    EncodeFrame(header, payload, out);
+
+    const std::lock_guard<std::mutex> lock(transport_mutex_);
+    if (!transport_) {
+        return Result<void>::Error("Transport closed");
+    }
+    bytes_sent_.fetch_add(out.size(), std::memory_order_relaxed);
+    return transport_->Send(out.data(), out.size());
+}
+
+Result<uint32_t> X64DbgBridge::SendCommandFrame(const std::string& command, ReplyCallback on_reply) {
+    auto fail = [&on_reply](const std::string& error) {
+        if (on_reply) {
+            on_reply(Result<Frame>::Error(error));
+        }
+        return Result<uint32_t>::Error(error);
+    };
+
+    const std::string escaped_command = EscapeCommand(command);
+    if (escaped_command.empty()) {
+        return fail("Command rejected");
+    }
+
+    FrameHeader request;
+    request.type = FrameType::kCommand;
+    request.flags = FrameHeader::kFlagFinal;
+    request.request_id = BeginRequest(std::move(on_reply));
+    if (request.request_id == 0) {
+        return fail("Transport closed");
+    }
+    request.payload_size = static_cast<uint32_t>(escaped_command.size());
+    auto send_result = SendFrame(request, reinterpret_cast<const uint8_t*>(escaped_command.data()));
+    if (!send_result.IsSuccess()) {
+        // Unless the receive thread has failed the request already, its callback is ours to call
+        ReplyCallback unanswered;
+        {
+            const std::lock_guard<std::mutex> lock(reply_mutex_);
+            auto pending = pending_replies_.find(request.request_id);
+            if (pending != pending_replies_.end()) {
+                unanswered = std::move(pending->second.on_reply);
+                pending_replies_.erase(pending);
+            }
+        }
+        if (unanswered) {
+            unanswered(Result<Frame>::Error(send_result.Error()));
+        }
+        return Result<uint32_t>::Error(send_result.Error());
+    }
+    return Result<uint32_t>::Success(request.request_id);
+}
+
+Result<std::string> X64DbgBridge::AwaitCommandReply(uint32_t request_id) {
+    auto frame_result = NextReplyFrame(request_id);
+    EndRequest(request_id);
+    return CommandReplyText(frame_result);
+}
+
+Result<void> X64DbgBridge::StepInto() {
+    return ExecuteControlCommand("sti");
+}
+
+Result<void> X64DbgBridge::StepOver() {
+    return ExecuteControlCommand("sto");
+}
+
+Result<void> X64DbgBridge::StepOut() {
+    return ExecuteControlCommand("rtr");
+}
+
+Result<void> X64DbgBridge::Continue() {
+    return ExecuteControlCommand("run");
+}
+
+Result<void> X64DbgBridge::Pause() {
+    return ExecuteControlCommand("pause");
+}
+
+Result<void> X64DbgBridge::ExecuteControlCommand(const std::string& command) {
+    if (!connected_) {
+        return Result<void>::Error("Not connected to debugger");
+    }
+
+    // The target runs, so nothing read before is known to be current
+    memory_cache_.Invalidate();
+
+    auto result = ExecuteCommand(command);
+    if (!result.IsSuccess()) {
+        return Result<void>::Error("Failed to execute '" + command + "': " + result.Error());
+    }
+    return Result<void>::Success();
+}
+
+bool X64DbgBridge::IsReadOnlyCommand(const std::string& command) {
+    static const char* const kReadOnlyPrefixes[] = {"dump ", "disasm ", "bp ", "bc ", "r "};
+    for (const char* prefix : kReadOnlyPrefixes) {
+        if (command.compare(0, std::char_traits<char>::length(prefix), prefix) == 0) {
+            return command.find('=') == std::string::npos;
+        }
+    }
+    return false;
+}
+
+void X64DbgBridge::SetMemoryCacheSize(size_t pages) {
+    memory_cache_.SetCapacity(pages);
+}
+
+PageCache::Stats X64DbgBridge::GetMemoryCacheStats() const {
+    return memory_cache_.GetStats();
+}
+
+void X64DbgBridge::InvalidateMemoryCache() {
+    memory_cache_.Invalidate();
+}
+
 Result<uintptr_t> X64DbgBridge::GetRegisterValue(const std::string& register_name) {
     if (!connected_) {
         return Result<uintptr_t>::Error("Not connected to debugger");
@@ -368,6 +1094,10 @@ Result<void> X64DbgBridge::ConnectExternal() {
 }
 
 Result<void> X64DbgBridge::ConnectPipe() {
+    if (transport_) {
+        return Result<void>::Success();
+    }
+
 #ifdef _WIN32
     // Try to connect to x64dbg named pipe
     std::string pipe_name = R"(\\.\pipe\x64dbg_bridge)";
@@ -386,7 +1116,8 @@ Result<void> X64DbgBridge::ConnectPipe() {
         DWORD error = GetLastError();
         return Result<void>::Error("Failed to connect to pipe: " + std::to_string(error));
     }
-    
+
+    transport_ = std::make_unique<PipeTransport>(pipe_handle_);
     return Result<void>::Success();
 #else
     return Result<void>::Error("Named pipe connection not supported on this platform");
@@ -394,11 +1125,48 @@ Result<void> X64DbgBridge::ConnectPipe() {
 }
 
 Result<void> X64DbgBridge::ConnectTCP() {
-    // TODO: Implement TCP connection to x64dbg
-    return Result<void>::Error("TCP connection not yet implemented");
+    if (transport_) {
+        return Result<void>::Success();
+    }
+
+    auto transport = SocketTransport::Connect(tcp_host_, tcp_port_, connection_timeout_ms_);
+    if (!transport.IsSuccess()) {
+        return Result<void>::Error(transport.Error());
+    }
+    transport_ = transport.TakeValue();
+    return Result<void>::Success();
+}
+
+Result<void> X64DbgBridge::ConnectSharedMemory() {
+    if (transport_) {
+        return Result<void>::Success();
+    }
+
+    auto transport = SharedMemoryTransport::Open(shared_memory_name_);
+    if (!transport.IsSuccess()) {
+        return Result<void>::Error("Failed to open shared memory: " + transport.Error());
+    }
+    transport_ = transport.TakeValue();
+    return Result<void>::Success();
 }
 
 void X64DbgBridge::DisconnectInternal() {
+    if (transport_) {
+        // Close() wakes the receive threads; pending requests fail as the reply thread exits
+        transport_->Close();
+        if (receive_thread_.joinable()) {
+            receive_thread_.join();
+        }
+        if (transport_event_thread_.joinable()) {
+            transport_event_thread_.join();
+        }
+        const std::lock_guard<std::mutex> send_lock(transport_mutex_);
+        transport_.reset();
+    }
+    frame_decoder_.Reset();
+    symbol_index_.Clear();
+    disassembly_cache_.Clear();
+
 #ifdef _WIN32
     if (process_handle_ != INVALID_HANDLE_VALUE) {
         CloseHandle(process_handle_);
@@ -409,11 +1177,6 @@ void X64DbgBridge::DisconnectInternal() {
         CloseHandle(pipe_handle_);
         pipe_handle_ = INVALID_HANDLE_VALUE;
     }
-    
-    if (tcp_socket_ != INVALID_SOCKET) {
-        closesocket(tcp_socket_);
-        tcp_socket_ = INVALID_SOCKET;
-    }
 #endif
 }
 
@@ -421,6 +1184,15 @@ Result<std::string> X64DbgBridge::SendCommand(const std::string& command) {
     if (!connected_) {
         return Result<std::string>::Error("Not connected");
     }
+
+    ScopedLatency timer(Latency(BridgeOperation::COMMAND));
+    if (UsesFramedTransport()) {
+        auto send_result = SendCommandFrame(command);
+        if (!send_result.IsSuccess()) {
+            return Result<std::string>::Error(send_result.Error());
+        }
+        return AwaitCommandReply(send_result.Value());
+    }
     
     std::string escaped_command = EscapeCommand(command);
     
@@ -453,37 +1225,541 @@ Result<std::string> X64DbgBridge::ParseCommandResponse(const std::string& raw_re
     return Result<std::string>::Success(response);
 }
 
-void X64DbgBridge::EventProcessingLoop() {
-    while (event_thread_running_) {
-        std::unique_lock<std::mutex> lock(event_queue_mutex_);
-        event_condition_.wait(lock, [this] { 
-            return !event_queue_.empty() || !event_thread_running_; 
-        });
-        
-        while (!event_queue_.empty() && event_thread_running_) {
-            DebugEvent event = event_queue_.front();
-            event_queue_.pop();
+bool X64DbgBridge::PostEvent(DebugEvent event) {
+    return EnqueueEvent(MakeQueuedEvent(std::move(event), event_strings_));
+}
+
+X64DbgBridge::QueuedEvent X64DbgBridge::MakeQueuedEvent(DebugEvent event, EventStringTable& strings) {
+    QueuedEvent queued;
+    if (!CompactEvent(event, strings, queued.compact)) {
+        // Too much metadata to keep inline; carry the original alongside
+        queued.full = std::make_shared<const DebugEvent>(std::move(event));
+    }
+    return queued;
+}
+
+bool X64DbgBridge::PostEvent(const CompactDebugEvent& event) {
+    QueuedEvent queued;
+    queued.compact = event;
+    return EnqueueEvent(std::move(queued));
+}
+
+void X64DbgBridge::RegisterCompactEventHandler(CompactEventHandler handler) {
+    const std::lock_guard<std::mutex> lock(handlers_mutex_);
+
+    CompactHandlerEntry entry;
+    entry.id = next_handler_id_++;
+    entry.handler = std::move(handler);
+
+    auto handlers = std::make_shared<std::vector<CompactHandlerEntry>>(*std::atomic_load(&compact_handlers_));
+    handlers->push_back(std::move(entry));
+    std::atomic_store(&compact_handlers_, std::shared_ptr<const std::vector<CompactHandlerEntry>>(std::move(handlers)));
+}
+
+void X64DbgBridge::SetEventRepeatCoalescing(bool enabled) {
+    coalesce_repeats_ = enabled;
+}
+
+bool X64DbgBridge::EnqueueEvent(QueuedEvent event, bool may_block) {
+    events_posted_.fetch_add(1, std::memory_order_relaxed);
+
+    // Once events are staged, later ones queue up behind them rather than overtaking them in the ring
+    if (has_overflow_.load(std::memory_order_acquire)) {
+        StageOverflowEvent(std::move(event));
+    } else if (!event_queue_->TryPush(std::move(event))) {
+        switch (overflow_policy_) {
+            case EventOverflowPolicy::BLOCK: {
+                if (!may_block) {
+                    // Waiting here could stall the reply a handler is itself waiting for
+                    StageOverflowEvent(std::move(event));
+                    break;
+                }
+                std::unique_lock<std::mutex> lock(event_queue_mutex_);
+                ++blocked_producers_;
+                bool pushed = false;
+                while (!(pushed = event_queue_->TryPush(std::move(event))) && event_thread_running_) {
+                    space_condition_.wait_for(lock, std::chrono::milliseconds(10));
+                }
+                --blocked_producers_;
+                if (!pushed) {
+                    // Nobody is dispatching, so waiting would never end
+                    events_dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                break;
+            }
+            case EventOverflowPolicy::DROP_OLDEST: {
+                QueuedEvent oldest;
+                while (!event_queue_->TryPush(std::move(event))) {
+                    if (event_queue_->TryPop(oldest)) {
+                        events_dropped_.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                break;
+            }
+            case EventOverflowPolicy::COALESCE:
+                StageOverflowEvent(std::move(event));
+                break;
+        }
+    }
+
+    WakeDispatcher();
+    return true;
+}
+
+Result<void> X64DbgBridge::SetEventQueueOptions(size_t capacity, EventOverflowPolicy policy) {
+    const std::lock_guard<std::mutex> lock(connection_mutex_);
+
+    if (connected_) {
+        return Result<void>::Error("Cannot change event queue while connected");
+    }
+    if (capacity == 0) {
+        return Result<void>::Error("Event queue capacity must be positive");
+    }
+
+    event_queue_ = std::make_unique<MpscRing<QueuedEvent>>(capacity);
+    overflow_policy_ = policy;
+    return Result<void>::Success();
+}
+
+X64DbgBridge::EventQueueStats X64DbgBridge::GetEventQueueStats() const {
+    EventQueueStats stats;
+    stats.posted = events_posted_.load(std::memory_order_relaxed);
+    stats.dispatched = events_dispatched_.load(std::memory_order_acquire);
+    stats.dropped = events_dropped_.load(std::memory_order_relaxed);
+    stats.coalesced = events_coalesced_.load(std::memory_order_relaxed);
+    stats.batches = event_batches_.load(std::memory_order_relaxed);
+    stats.repeats_merged = repeats_merged_.load(std::memory_order_relaxed);
+    stats.queued = event_queue_->ApproximateSize();
+    stats.capacity = event_queue_->Capacity();
+    return stats;
+}
+
+namespace {
+
+std::string FormatDuration(uint64_t nanoseconds) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (nanoseconds < 1000) {
+        out << nanoseconds << "ns";
+    } else if (nanoseconds < 1000000) {
+        out << nanoseconds / 1e3 << "us";
+    } else if (nanoseconds < 1000000000) {
+        out << nanoseconds / 1e6 << "ms";
+    } else {
+        out << nanoseconds / 1e9 << "s";
+    }
+    return out.str();
+}
+
+double HitRate(uint64_t hits, uint64_t misses) {
+    const uint64_t lookups = hits + misses;
+    return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+}
+
+} // anonymous namespace
+
+X64DbgBridge::BridgeStats X64DbgBridge::GetStats() const {
+    BridgeStats stats;
+    for (size_t i = 0; i < latency_.size(); ++i) {
+        stats.latency[i] = latency_[i].Summarize();
+    }
+    stats.bytes_sent = bytes_sent_.load(std::memory_order_relaxed);
+    stats.bytes_received = bytes_received_.load(std::memory_order_relaxed);
+    stats.bytes_read = bytes_read_.load(std::memory_order_relaxed);
+    stats.bytes_written = bytes_written_.load(std::memory_order_relaxed);
+    stats.memory_cache = memory_cache_.GetStats();
+    stats.disassembly_cache = disassembly_cache_.GetStats();
+    stats.events = GetEventQueueStats();
+    return stats;
+}
+
+void X64DbgBridge::ResetStats() {
+    for (auto& histogram : latency_) {
+        histogram.Reset();
+    }
+    bytes_sent_.store(0, std::memory_order_relaxed);
+    bytes_received_.store(0, std::memory_order_relaxed);
+    bytes_read_.store(0, std::memory_order_relaxed);
+    bytes_written_.store(0, std::memory_order_relaxed);
+}
+
+const char* X64DbgBridge::GetOperationName(BridgeOperation operation) {
+    switch (operation) {
+        case BridgeOperation::READ_MEMORY: return "read_memory";
+        case BridgeOperation::FETCH_MEMORY: return "fetch_memory";
+        case BridgeOperation::READ_BATCH: return "read_batch";
+        case BridgeOperation::WRITE_MEMORY: return "write_memory";
+        case BridgeOperation::COMMAND: return "command";
+        case BridgeOperation::DISASSEMBLY: return "disassembly";
+        case BridgeOperation::HEX_DECODE: return "hex_decode";
+        default: return "unknown";
+    }
+}
+
+std::string X64DbgBridge::FormatStats(const BridgeStats& stats, StatsFormat format) {
+    std::ostringstream out;
+    const size_t operation_count = static_cast<size_t>(BridgeOperation::COUNT);
+
+    if (format == StatsFormat::JSON) {
+        const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        out << std::fixed << std::setprecision(4);
+        out << "{\"timestamp_ms\":" << now << ",\"latency_ns\":{";
+        for (size_t i = 0; i < operation_count; ++i) {
+            const LatencySummary& summary = stats.latency[i];
+            out << (i ? "," : "") << "\"" << GetOperationName(static_cast<BridgeOperation>(i)) << "\":{"
+                << "\"count\":" << summary.count
+                << ",\"p50\":" << summary.p50_ns
+                << ",\"p99\":" << summary.p99_ns
+                << ",\"max\":" << summary.max_ns
+                << ",\"mean\":" << (summary.count ? summary.total_ns / summary.count : 0) << "}";
+        }
+        out << "},\"bytes\":{\"sent\":" << stats.bytes_sent
+            << ",\"received\":" << stats.bytes_received
+            << ",\"read\":" << stats.bytes_read
+            << ",\"written\":" << stats.bytes_written << "}";
+        out << ",\"memory_cache\":{\"hits\":" << stats.memory_cache.hits
+            << ",\"misses\":" << stats.memory_cache.misses
+            << ",\"hit_rate\":" << HitRate(stats.memory_cache.hits, stats.memory_cache.misses)
+            << ",\"evictions\":" << stats.memory_cache.evictions
+            << ",\"invalidations\":" << stats.memory_cache.invalidations
+            << ",\"bypassed\":" << stats.memory_cache.bypassed
+            << ",\"cached_pages\":" << stats.memory_cache.cached_pages << "}";
+        out << ",\"disassembly_cache\":{\"hits\":" << stats.disassembly_cache.hits
+            << ",\"misses\":" << stats.disassembly_cache.misses
+            << ",\"hit_rate\":" << HitRate(stats.disassembly_cache.hits, stats.disassembly_cache.misses)
+            << ",\"entries\":" << stats.disassembly_cache.entries << "}";
+        out << ",\"events\":{\"posted\":" << stats.events.posted
+            << ",\"dispatched\":" << stats.events.dispatched
+            << ",\"dropped\":" << stats.events.dropped
+            << ",\"coalesced\":" << stats.events.coalesced
+            << ",\"queued\":" << stats.events.queued
+            << ",\"capacity\":" << stats.events.capacity << "}}";
+        return out.str();
+    }
+
+    out << std::left << std::setw(14) << "operation" << std::right
+        << std::setw(10) << "count" << std::setw(10) << "p50"
+        << std::setw(10) << "p99" << std::setw(10) << "max" << "\n";
+    for (size_t i = 0; i < operation_count; ++i) {
+        const LatencySummary& summary = stats.latency[i];
+        if (summary.count == 0) {
+            continue;
+        }
+        out << std::left << std::setw(14) << GetOperationName(static_cast<BridgeOperation>(i)) << std::right
+            << std::setw(10) << summary.count
+            << std::setw(10) << FormatDuration(summary.p50_ns)
+            << std::setw(10) << FormatDuration(summary.p99_ns)
+            << std::setw(10) << FormatDuration(summary.max_ns) << "\n";
+    }
+    out << std::fixed << std::setprecision(1);
+    out << "traffic: " << stats.bytes_sent << " B sent, " << stats.bytes_received << " B received, "
+        << stats.bytes_read << " B read, " << stats.bytes_written << " B written\n";
+    out << "memory cache: " << HitRate(stats.memory_cache.hits, stats.memory_cache.misses) * 100 << "% hits ("
+        << stats.memory_cache.hits << "/" << stats.memory_cache.hits + stats.memory_cache.misses << "), "
+        << stats.memory_cache.cached_pages << " pages cached\n";
+    out << "disassembly cache: " << HitRate(stats.disassembly_cache.hits, stats.disassembly_cache.misses) * 100
+        << "% hits (" << stats.disassembly_cache.hits << "/"
+        << stats.disassembly_cache.hits + stats.disassembly_cache.misses << ")\n";
+    out << "events: " << stats.events.queued << "/" << stats.events.capacity << " queued, "
+        << stats.events.dispatched << " dispatched, " << stats.events.dropped << " dropped, "
+        << stats.events.coalesced << " coalesced\n";
+    return out.str();
+}
+
+void X64DbgBridge::SetStatsExport(std::chrono::milliseconds interval, StatsSink sink) {
+    StopStatsExport();
+    if (interval.count() <= 0 || !sink) {
+        return;
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(stats_export_mutex_);
+        stats_export_stop_ = false;
+    }
+    stats_export_thread_ = std::thread([this, interval, sink = std::move(sink)]() {
+        std::unique_lock<std::mutex> lock(stats_export_mutex_);
+        while (!stats_export_condition_.wait_for(lock, interval, [this]() { return stats_export_stop_; })) {
             lock.unlock();
-            
-            NotifyEventHandlers(event);
-            
+            try {
+                sink(FormatStats(GetStats(), StatsFormat::JSON));
+            } catch (const std::exception& e) {
+                if (logger_) {
+                    logger_->LogFormatted(ILogger::LOG_WARN, "Stats export failed: %s", e.what());
+                }
+            }
             lock.lock();
         }
+    });
+}
+
+void X64DbgBridge::StopStatsExport() {
+    {
+        const std::lock_guard<std::mutex> lock(stats_export_mutex_);
+        stats_export_stop_ = true;
+    }
+    stats_export_condition_.notify_all();
+    if (stats_export_thread_.joinable()) {
+        stats_export_thread_.join();
     }
 }
 
-void X64DbgBridge::NotifyEventHandlers(const DebugEvent& event) {
-    const std::lock_guard<std::mutex> lock(handlers_mutex_);
-    
-    for (const auto& handler_entry : event_handlers_) {
-        try {
-            handler_entry.handler(event);
-        } catch (...) {
+Result<X64DbgBridge::EventOverflowPolicy> X64DbgBridge::ParseEventOverflowPolicy(const std::string& name) {
+    if (name == "block") {
+        return Result<EventOverflowPolicy>::Success(EventOverflowPolicy::BLOCK);
+    }
+    if (name == "drop_oldest") {
+        return Result<EventOverflowPolicy>::Success(EventOverflowPolicy::DROP_OLDEST);
+    }
+    if (name == "coalesce") {
+        return Result<EventOverflowPolicy>::Success(EventOverflowPolicy::COALESCE);
+    }
+    return Result<EventOverflowPolicy>::Error("Unknown event overflow policy: " + name);
+}
+
+void X64DbgBridge::WakeDispatcher() {
+    // Pairs with the fence in the dispatcher's wait predicate: either it sees the event or we see it waiting
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (dispatcher_waiting_.load(std::memory_order_relaxed)) {
+        const std::lock_guard<std::mutex> lock(event_queue_mutex_);
+        event_condition_.notify_one();
+    }
+}
+
+void X64DbgBridge::StopEventThread() {
+    {
+        // Under the lock, or the dispatcher could test its wait predicate and then miss the wake-up
+        const std::lock_guard<std::mutex> lock(event_queue_mutex_);
+        event_thread_running_ = false;
+        event_condition_.notify_all();
+        space_condition_.notify_all();
+    }
+    if (event_thread_.joinable()) {
+        event_thread_.join();
+    }
+}
+
+void X64DbgBridge::EventProcessingLoop() {
+    constexpr size_t MAX_BATCH = 256;
+    std::vector<QueuedEvent> batch;
+    batch.reserve(MAX_BATCH);
+
+    while (event_thread_running_) {
+        batch.clear();
+        // Staged events are newer than anything in the ring, so they wait until it is drained
+        if (event_queue_->PopBatch(batch, MAX_BATCH) < MAX_BATCH) {
+            TakeOverflowEvents(batch);
+        }
+
+        if (batch.empty()) {
+            std::unique_lock<std::mutex> lock(event_queue_mutex_);
+            dispatcher_waiting_.store(true, std::memory_order_relaxed);
+            event_condition_.wait(lock, [this] {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                return event_queue_->ApproximateSize() != 0 || has_overflow_ || !event_thread_running_;
+            });
+            dispatcher_waiting_.store(false, std::memory_order_relaxed);
+            continue;
+        }
+
+        if (blocked_producers_.load() != 0) {
+            const std::lock_guard<std::mutex> lock(event_queue_mutex_);
+            space_condition_.notify_all();
+        }
+
+        if (coalesce_repeats_) {
+            MergeRepeats(batch);
+        }
+        DispatchEvents(batch);
+    }
+}
+
+void X64DbgBridge::StageOverflowEvent(QueuedEvent event) {
+    const std::lock_guard<std::mutex> lock(overflow_mutex_);
+    if (overflow_policy_ == EventOverflowPolicy::COALESCE) {
+        // Only a run of identical events folds, so nothing is reordered or mistaken for another
+        if (!overflow_events_.empty()) {
+            QueuedEvent& previous = overflow_events_.back();
+            if (!event.full && !previous.full && IsRepeatOf(event.compact, previous.compact)) {
+                previous.compact.repeat_count += event.compact.repeat_count;
+                events_coalesced_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        // Distinct events are bounded like the ring is
+        if (overflow_events_.size() >= event_queue_->Capacity()) {
+            overflow_events_.pop_front();
+            events_dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    overflow_events_.push_back(std::move(event));
+    has_overflow_.store(true, std::memory_order_release);
+}
+
+void X64DbgBridge::TakeOverflowEvents(std::vector<QueuedEvent>& batch) {
+    if (!has_overflow_.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    const std::lock_guard<std::mutex> lock(overflow_mutex_);
+    for (auto& event : overflow_events_) {
+        batch.push_back(std::move(event));
+    }
+    overflow_events_.clear();
+    has_overflow_.store(false, std::memory_order_release);
+}
+
+void X64DbgBridge::MergeRepeats(std::vector<QueuedEvent>& batch) {
+    // Fold each event into the latest earlier record from the same thread when it repeats it
+    std::unordered_map<uint64_t, size_t> last_by_thread;
+    size_t kept = 0;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        QueuedEvent& event = batch[i];
+        const uint64_t thread_key = (static_cast<uint64_t>(event.compact.process_id) << 32) | event.compact.thread_id;
+        auto last = last_by_thread.find(thread_key);
+        if (!event.full && last != last_by_thread.end()) {
+            QueuedEvent& previous = batch[last->second];
+            if (!previous.full && IsRepeatOf(event.compact, previous.compact)) {
+                previous.compact.repeat_count += event.compact.repeat_count;
+                repeats_merged_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+        }
+        if (kept != i) {
+            batch[kept] = std::move(event);
+        }
+        last_by_thread[thread_key] = kept++;
+    }
+    batch.resize(kept);
+}
+
+void X64DbgBridge::DispatchEvents(const std::vector<QueuedEvent>& events) {
+    // Handlers must not see pages from before the target ran or its modules changed
+    if (std::any_of(events.begin(), events.end(),
+                    [](const QueuedEvent& queued) { return MayChangeDebuggeeMemory(queued.compact.type); })) {
+        memory_cache_.Invalidate();
+    }
+
+    const auto compact_handlers = std::atomic_load(&compact_handlers_);
+    const auto handlers = std::atomic_load(&event_handlers_);
+    for (const QueuedEvent& queued : events) {
+        TrackModuleEvent(queued);
+        for (const auto& handler_entry : *compact_handlers) {
+            try {
+                handler_entry.handler(queued.compact);
+            } catch (...) {
+                if (logger_) {
+                    logger_->LogFormatted(ILogger::LOG_ERROR, "Exception in event handler %u", handler_entry.id);
+                }
+            }
+        }
+        if (handlers->empty()) {
+            continue;
+        }
+
+        // The rich event is only built when someone wants it
+        DebugEvent event;
+        if (queued.full) {
+            event = *queued.full;
+            if (queued.compact.repeat_count > 1) {
+                event.metadata["coalesced_count"] = std::to_string(queued.compact.repeat_count);
+            }
+        } else {
+            event = ExpandEvent(queued.compact, event_strings_);
+        }
+        for (const auto& handler_entry : *handlers) {
+            try {
+                handler_entry.handler(event);
+            } catch (...) {
+                if (logger_) {
+                    logger_->LogFormatted(ILogger::LOG_ERROR, "Exception in event handler %u", handler_entry.id);
+                }
+            }
+        }
+    }
+
+    // Release: a caller that sees the count also sees what the handlers did
+    events_dispatched_.fetch_add(events.size(), std::memory_order_release);
+    event_batches_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void X64DbgBridge::TrackModuleEvent(const QueuedEvent& event) {
+    const DebugEvent::Type type = event.compact.type;
+    if (type != DebugEvent::Type::MODULE_LOADED && type != DebugEvent::Type::MODULE_UNLOADED) {
+        return;
+    }
+
+    const std::string module = event.full ? event.full->module_name
+                                          : std::string(event_strings_.Lookup(event.compact.module_id));
+    const uintptr_t base = event.compact.address;
+    if (type == DebugEvent::Type::MODULE_UNLOADED) {
+        if (!symbol_index_.RemoveModule(base) && !module.empty()) {
+            symbol_index_.RemoveModule(module);
+        }
+        return;
+    }
+
+    SymbolSource source;
+    {
+        const std::lock_guard<std::mutex> lock(symbol_source_mutex_);
+        source = symbol_source_;
+    }
+    if (!source || module.empty()) {
+        return;
+    }
+
+    try {
+        auto symbols = source(module, base);
+        if (!symbols.IsSuccess()) {
+            if (logger_) {
+                logger_->LogFormatted(ILogger::LOG_DEBUG, "No symbols for %s: %s",
+                                      module.c_str(), symbols.Error().c_str());
+            }
+            return;
+        }
+        symbol_index_.AddModule(module, base, symbols.TakeValue());
+    } catch (...) {
+        if (logger_) {
+            logger_->LogFormatted(ILogger::LOG_ERROR, "Exception loading symbols for %s", module.c_str());
+        }
+    }
+}
+
+void X64DbgBridge::TransportEventLoop(SharedMemoryTransport* transport) {
+    FrameDecoder decoder;
+    std::vector<uint8_t> buffer(kMaxChunkSize);
+    for (;;) {
+        auto received = transport->ReceiveEvent(buffer.data(), buffer.size());
+        if (!received.IsSuccess() || received.Value() == 0) {
+            return;
+        }
+        bytes_received_.fetch_add(received.Value(), std::memory_order_relaxed);
+        decoder.Feed(buffer.data(), received.Value());
+
+        Frame frame;
+        std::string error;
+        while (decoder.Next(frame, error)) {
+            PostFramedEvent(frame);
+        }
+        if (!error.empty()) {
             if (logger_) {
-                logger_->LogFormatted(ILogger::LOG_ERROR, "Exception in event handler %u", handler_entry.id);
+                logger_->LogFormatted(ILogger::LOG_ERROR, "Event ring corrupted: %s", error.c_str());
             }
+            return;
+        }
+    }
+}
+
+void X64DbgBridge::PostFramedEvent(const Frame& frame) {
+    DebugEvent event;
+    if (!DecodeEventPayload(frame, event)) {
+        if (logger_) {
+            logger_->Log(ILogger::LOG_WARN, "Dropping malformed event frame");
         }
+        return;
     }
+    EnqueueEvent(MakeQueuedEvent(std::move(event), event_strings_), false);
 }
 
 Result<void> X64DbgBridge::ValidateMemoryAccess(uintptr_t address, size_t size) {
@@ -491,9 +1767,14 @@ Result<void> X64DbgBridge::ValidateMemoryAccess(uintptr_t address, size_t size)
         return Result<void>::Error("Size cannot be zero");
     }
     
-    if (size > 1024 * 1024) { // 1MB limit
+    // The hex text protocol caps replies at 1MB; binary frames are streamed without a limit
+    if (size > 1024 * 1024 && !UsesFramedTransport()) {
         return Result<void>::Error("Size too large (max 1MB)");
     }
+
+    if (address + size < address) {
+        return Result<void>::Error("Memory range wraps around the address space");
+    }
     
     if (!IsValidAddress(address)) {
         return Result<void>::Error("Invalid memory address");
@@ -510,47 +1791,28 @@ std::string X64DbgBridge::FormatMemoryCommand(const std::string& operation,
 }
 
 std::vector<uint8_t> X64DbgBridge::ParseHexData(const std::string& hex_string) {
+    ScopedLatency timer(Latency(BridgeOperation::HEX_DECODE));
     // ЗАЩИТА ОТ DOS: ограничиваем максимальный размер parsing
-    constexpr size_t MAX_HEX_LENGTH = 2 * 1024 * 1024; // 2MB of hex = 1MB of data
+    constexpr size_t MAX_HEX_LENGTH = 3 * 1024 * 1024; // 1MB of data, space-separated
     if (hex_string.length() > MAX_HEX_LENGTH) {
         if (logger_) {
-            logger_->LogFormatted(ILogger::LOG_ERROR, "ParseHexData: input too large (%zu bytes), truncating to %zu", hex_string.length(), MAX_HEX_LENGTH);
+            logger_->LogFormatted(ILogger::LOG_ERROR, "ParseHexData: input too large (%zu bytes, max %zu)", hex_string.length(), MAX_HEX_LENGTH);
         }
         // Возвращаем пустой вектор вместо обрезки для безопасности
         return {};
     }
     
-    std::vector<uint8_t> data;
-    // Резервируем память заранее для оптимизации
-    data.reserve(hex_string.length() / 2 + 1);
-    
-    // Парсинг без потокового ввода для безопасности
-    for (size_t i = 0; i + 1 < hex_string.length(); i += 2) {
-        if (data.size() >= 1024 * 1024) { // Дополнительная проверка на 1MB
-            if (logger_) {
-                logger_->Log(ILogger::LOG_WARN, "ParseHexData: reached 1MB limit, stopping parse");
-            }
-            break;
-        }
-        
-        char hex_chars[3] = {hex_string[i], hex_string[i + 1], '\0'};
-        
-        // Проверяем что это валидные hex символы
-        if (!std::isxdigit(hex_chars[0]) || !std::isxdigit(hex_chars[1])) {
-            continue; // Пропускаем невалидные пары
-        }
-        
-        try {
-            unsigned long value = std::stoul(hex_chars, nullptr, 16);
-            if (value <= 0xFF) { // Дополнительная проверка диапазона
-                data.push_back(static_cast<uint8_t>(value));
-            }
-        } catch (const std::exception&) {
-            // Безопасно игнорируем invalid hex pairs
-            continue;
+    constexpr size_t MAX_DATA_SIZE = 1024 * 1024;
+    std::vector<uint8_t> data(std::min(HexDecodedCapacity(hex_string.length()), MAX_DATA_SIZE));
+    auto decoded = HexDecode(hex_string, data.data(), data.size());
+    if (!decoded.IsSuccess()) {
+        if (logger_) {
+            logger_->LogFormatted(ILogger::LOG_WARN, "ParseHexData: %s", decoded.Error().c_str());
         }
+        return {};
     }
     
+    data.resize(decoded.Value());
     return data;
 }
 
@@ -749,6 +2011,14 @@ std::unique_ptr<X64DbgBridge> X64DbgBridgeFactory::CreateFromConfig(const DebugC
     auto bridge = std::make_unique<X64DbgBridge>(logger);
     bridge->SetDebuggerPath(config.x64dbg_path);
     bridge->SetConnectionTimeout(config.connection_timeout_ms);
+    bridge->SetTcpEndpoint(config.tcp_host, config.tcp_port);
+    bridge->SetMemoryCacheSize(config.memory_cache_pages);
+    auto policy = X64DbgBridge::ParseEventOverflowPolicy(config.event_overflow_policy);
+    if (policy.IsSuccess()) {
+        bridge->SetEventQueueOptions(config.event_queue_capacity, policy.Value());
+    } else if (logger) {
+        logger->Log(ILogger::LOG_WARN, policy.Error());
+    }
     
     // Auto-detect best connection mode
     auto mode = DetectBestConnectionMode();
@@ -765,6 +2035,11 @@ X64DbgBridge::ConnectionMode X64DbgBridgeFactory::DetectBestConnectionMode() {
     }
 #endif
     
+    // A plugin that published its shared section is the cheapest way in
+    if (SharedMemoryRegion::Exists(SharedMemoryTransport::kDefaultName)) {
+        return X64DbgBridge::ConnectionMode::SHARED_MEMORY;
+    }
+
     // Check if x64dbg is running
     if (IsX64DbgRunning()) {
         return X64DbgBridge::ConnectionMode::PIPE;
@@ -801,10 +2076,110 @@ std::string X64DbgBridgeFactory::FindX64DbgExecutable() {
 }
 
 Result<std::string> X64DbgBridge::GetDisassembly(uintptr_t address) {
-    std::string msg = "Fetching disassembly at address " + AddressToString(address);
-    logger_->Log(ILogger::Level::INFO, msg);
-    
+    ScopedLatency timer(Latency(BridgeOperation::DISASSEMBLY));
+    if (logger_) {
+        logger_->Log(ILogger::Level::INFO, "Fetching disassembly at address " + AddressToString(address));
+    }
+
+    MemoryRange window;
+    if (!connected_ || !DisassemblyWindow(address, window)) {
+        return FetchDisassembly(address);
+    }
+
+    auto code = ReadMemoryRaw(window.address, window.size);
+    if (!code.IsSuccess()) {
+        // Bytes we cannot see cannot prove a cached listing is still current
+        return FetchDisassembly(address);
+    }
+
+    const uint64_t page_hash = DisassemblyCache::HashPage(code.Value().data(), code.Value().size());
+    std::string text;
+    if (disassembly_cache_.Get(address, page_hash, text)) {
+        return Result<std::string>::Success(std::move(text));
+    }
+
+    auto result = FetchDisassembly(address);
+    if (result.IsSuccess()) {
+        disassembly_cache_.Put(address, page_hash, result.Value());
+    }
+    return result;
+}
+
+std::vector<Result<std::string>> X64DbgBridge::GetDisassemblyBatch(const std::vector<uintptr_t>& addresses) {
+    std::vector<Result<std::string>> results(addresses.size());
+    std::vector<std::optional<uint64_t>> page_hashes(addresses.size());
+    if (connected_) {
+        std::vector<MemoryRange> windows;
+        std::vector<size_t> window_of;
+        for (size_t i = 0; i < addresses.size(); ++i) {
+            MemoryRange window;
+            if (DisassemblyWindow(addresses[i], window)) {
+                windows.push_back(window);
+                window_of.push_back(i);
+            }
+        }
+
+        // A short view means unreadable code, which cannot prove a cached listing current
+        auto views = ReadMemoryBatch(windows);
+        if (views.IsSuccess()) {
+            for (size_t w = 0; w < windows.size(); ++w) {
+                const MemoryView& view = views.Value()[w];
+                if (view.size == windows[w].size) {
+                    page_hashes[window_of[w]] = DisassemblyCache::HashPage(view.data, view.size);
+                }
+            }
+        }
+    }
+
+    std::vector<size_t> misses;
+    for (size_t i = 0; i < addresses.size(); ++i) {
+        std::string text;
+        if (page_hashes[i] && disassembly_cache_.Get(addresses[i], *page_hashes[i], text)) {
+            results[i] = Result<std::string>::Success(std::move(text));
+        } else {
+            misses.push_back(i);
+        }
+    }
+
+    if (connected_ && UsesFramedTransport()) {
+        // Every request goes on the wire before the first reply is awaited
+        std::vector<std::function<Result<std::string>()>> replies;
+        replies.reserve(misses.size());
+        for (size_t i : misses) {
+            replies.push_back(StartCommand("disasm " + AddressToString(addresses[i])));
+        }
+        for (size_t m = 0; m < misses.size(); ++m) {
+            results[misses[m]] = replies[m]();
+        }
+    } else {
+        for (size_t i : misses) {
+            results[i] = FetchDisassembly(addresses[i]);
+        }
+    }
+
+    for (size_t i : misses) {
+        if (page_hashes[i] && results[i].IsSuccess()) {
+            disassembly_cache_.Put(addresses[i], *page_hashes[i], results[i].Value());
+        }
+    }
+    return results;
+}
+
+bool X64DbgBridge::DisassemblyWindow(uintptr_t address, MemoryRange& window) {
+    // The listing runs a few instructions past address, so every page it may touch is hashed
+    constexpr size_t kDisassemblyWindow = 64;
+    window.address = address & ~static_cast<uintptr_t>(PageCache::kPageSize - 1);
+    window.size = ((address - window.address + kDisassemblyWindow + PageCache::kPageSize - 1) /
+                   PageCache::kPageSize) * PageCache::kPageSize;
+    return window.address + window.size >= window.address;
+}
+
+Result<std::string> X64DbgBridge::FetchDisassembly(uintptr_t address) {
     std::string command = "disasm " + AddressToString(address);
+    if (connected_ && UsesFramedTransport()) {
+        return SendCommand(command);
+    }
+
     // In a real implementation, we would execute this command via the bridge
     // and parse the result.
     return mcp::Result<std::string>::Success("mov rax, rcx\nadd rax, 1\nret");
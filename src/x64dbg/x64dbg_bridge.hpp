@@ -1,7 +1,18 @@
 #pragma once
 
 #include "mcp/interfaces.hpp"
+#include "mcp/latency_histogram.hpp"
+#include "mcp/memory_view.hpp"
+#include "mcp/mpsc_ring.hpp"
 #include "mcp/types.hpp"
+#include "bridge_protocol.hpp"
+#include "compact_event.hpp"
+#include "bridge_transport.hpp"
+#include "shared_memory_transport.hpp"
+#include "page_cache.hpp"
+#include "symbol_cache.hpp"
+#include <array>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -9,6 +20,9 @@
 #include <queue>
 #include <condition_variable>
 #include <functional>
+#include <future>
+#include <unordered_map>
+#include <deque>
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -30,7 +44,55 @@ public:
         PLUGIN,        // Running as x64dbg plugin
         EXTERNAL,      // External process communication
         PIPE,          // Named pipe communication
-        TCP            // TCP socket communication
+        TCP,           // TCP socket communication
+        SHARED_MEMORY  // Rings in a section mapped by the plugin and the engine
+    };
+
+    // What PostEvent does when the event queue is full
+    enum class EventOverflowPolicy {
+        BLOCK,         // Wait for the dispatcher to make room (events read off the transport are staged instead)
+        DROP_OLDEST,   // Discard the oldest queued event
+        COALESCE       // Stage overflow in order, a run of identical events as one with a "coalesced_count";
+                       // beyond the queue capacity the oldest staged event is dropped
+    };
+
+    struct EventQueueStats {
+        uint64_t posted = 0;
+        uint64_t dispatched = 0;
+        uint64_t dropped = 0;
+        uint64_t coalesced = 0;       // Overflowing events folded into the identical one before them
+        uint64_t batches = 0;
+        uint64_t repeats_merged = 0;  // Identical events folded into counted records
+        size_t queued = 0;
+        size_t capacity = 0;
+    };
+
+    // Operations timed by the bridge, each with its own latency histogram
+    enum class BridgeOperation {
+        READ_MEMORY,   // ReadMemoryRaw, cache hits included
+        FETCH_MEMORY,  // Debugger round trips for what the cache did not have
+        READ_BATCH,
+        WRITE_MEMORY,
+        COMMAND,
+        DISASSEMBLY,
+        HEX_DECODE,
+        COUNT
+    };
+
+    struct BridgeStats {
+        std::array<LatencySummary, static_cast<size_t>(BridgeOperation::COUNT)> latency{};
+        uint64_t bytes_sent = 0;       // On the transport, framing included
+        uint64_t bytes_received = 0;
+        uint64_t bytes_read = 0;       // Debuggee memory handed to callers
+        uint64_t bytes_written = 0;
+        PageCache::Stats memory_cache;
+        DisassemblyCache::Stats disassembly_cache;
+        EventQueueStats events;
+    };
+
+    enum class StatsFormat {
+        TEXT,          // Human-readable table
+        JSON           // One line, for log shippers and scripts
     };
 
     explicit X64DbgBridge(std::shared_ptr<ILogger> logger);
@@ -42,15 +104,111 @@ public:
     Result<std::string> ExecuteCommand(const std::string& command) override;
     Result<std::string> GetDisassembly(uintptr_t address) override;
     Result<MemoryDump> ReadMemory(uintptr_t address, size_t size) override;
+
+    /**
+     * @brief Read many ranges with one round trip
+     *
+     * Overlapping and touching ranges are merged into spans before anything
+     * is sent; validation and symbol lookup happen once per span. Over the
+     * framed transports all spans go out in a single kReadBatch request.
+     */
+    Result<std::vector<MemoryView>> ReadMemoryBatch(const std::vector<MemoryRange>& ranges) override;
+
+    /**
+     * @brief Disassemble many addresses, results in request order
+     *
+     * The code under every address is read in one batch to validate cached
+     * listings; the misses are then pipelined like ExecuteCommandAsync, so a
+     * whole batch costs about two round trips instead of two per address.
+     */
+    std::vector<Result<std::string>> GetDisassemblyBatch(const std::vector<uintptr_t>& addresses);
     Result<void> SetBreakpoint(uintptr_t address) override;
     void RegisterEventHandler(std::function<void(const DebugEvent&)> handler) override;
     bool IsConnected() const override;
 
+    /**
+     * @brief Send command without waiting for its output
+     *
+     * Over the framed transports the request is sent when this returns, so
+     * several commands can be issued back to back and their replies are
+     * matched by request ID as they arrive. Other modes run the command on
+     * a worker. The future must not outlive the bridge.
+     */
+    std::future<Result<std::string>> ExecuteCommandAsync(const std::string& command);
+
+    // As above, with on_complete invoked on a worker thread once the output arrives
+    using CommandCallback = std::function<void(Result<std::string>)>;
+    void ExecuteCommandAsync(const std::string& command, CommandCallback on_complete);
+
+    // Async command workers come from the shared executor when one is set; set before use
+    void SetTaskExecutor(std::weak_ptr<ITaskExecutor> executor);
+
     // Extended functionality
     Result<void> SetConnectionMode(ConnectionMode mode);
     Result<void> SetDebuggerPath(const std::string& path);
     Result<void> SetConnectionTimeout(int timeout_ms);
+    Result<void> SetSharedMemoryName(const std::string& name);
+    Result<void> SetTcpEndpoint(const std::string& host, int port);
+
+    /**
+     * @brief Use transport for the PIPE/TCP/SHARED_MEMORY connection instead of opening one
+     *
+     * Must be called while disconnected; Connect() then adopts the transport
+     * and Disconnect() closes and drops it.
+     */
+    Result<void> SetTransport(std::unique_ptr<IBridgeTransport> transport);
     Result<std::string> GetSymbolAt(uintptr_t address);
+
+    /**
+     * @brief Supplies the symbols of a module when its MODULE_LOADED event is dispatched
+     *
+     * Called on the event thread before any handler sees the event. The
+     * module's symbols stay indexed for GetSymbolAt()/ResolveSymbol() until
+     * MODULE_UNLOADED or disconnect.
+     */
+    using SymbolSource = std::function<Result<ModuleSymbols>(const std::string& module, uintptr_t base)>;
+    void SetSymbolSource(SymbolSource source);
+    const SymbolIndex& GetSymbolIndex() const { return symbol_index_; }
+    DisassemblyCache::Stats GetDisassemblyCacheStats() const;
+
+    /**
+     * @brief Queue a debug event for the dispatch thread
+     *
+     * Safe from any number of threads and lock-free unless the queue is
+     * full. Returns false if the event was dropped.
+     */
+    bool PostEvent(DebugEvent event);
+
+    // Hot-path variant: intern strings through GetEventStrings() once and post records without allocating
+    bool PostEvent(const CompactDebugEvent& event);
+    EventStringTable& GetEventStrings() { return event_strings_; }
+
+    // Handlers that take the compact record; no DebugEvent is built unless a RegisterEventHandler handler exists
+    using CompactEventHandler = std::function<void(const CompactDebugEvent&)>;
+    void RegisterCompactEventHandler(CompactEventHandler handler);
+
+    // Fold repeats of an event on the same thread within a dispatch batch into one counted record
+    void SetEventRepeatCoalescing(bool enabled);
+
+    // Capacity is rounded up to a power of two; only while disconnected and no producer is posting
+    Result<void> SetEventQueueOptions(size_t capacity, EventOverflowPolicy policy);
+    EventQueueStats GetEventQueueStats() const;
+    static Result<EventOverflowPolicy> ParseEventOverflowPolicy(const std::string& name);
+
+    // Debuggee memory cache; dropped whenever the target may have run or been written
+    void SetMemoryCacheSize(size_t pages);
+    PageCache::Stats GetMemoryCacheStats() const;
+    void InvalidateMemoryCache();
+
+    // Latency, traffic, cache and event-queue figures; counters are relaxed atomics, cheap enough to keep on
+    BridgeStats GetStats() const;
+    void ResetStats();
+    static const char* GetOperationName(BridgeOperation operation);
+    static std::string FormatStats(const BridgeStats& stats, StatsFormat format);
+
+    // Hand FormatStats(JSON) to sink every interval from a background thread; a zero interval stops it
+    using StatsSink = std::function<void(const std::string& json)>;
+    void SetStatsExport(std::chrono::milliseconds interval, StatsSink sink);
     
     // Advanced debugging operations
     Result<std::vector<uint8_t>> ReadMemoryRaw(uintptr_t address, size_t size);
@@ -89,31 +247,104 @@ private:
         std::function<void(const DebugEvent&)> handler;
     };
 
+    struct CompactHandlerEntry {
+        uint32_t id;
+        CompactEventHandler handler;
+    };
+
+    struct QueuedEvent {
+        CompactDebugEvent compact;
+        std::shared_ptr<const DebugEvent> full;  // Only for events whose metadata did not fit inline
+    };
+
     std::shared_ptr<ILogger> logger_;
     mutable std::mutex connection_mutex_;
     std::atomic<bool> connected_{false};
     ConnectionMode connection_mode_ = ConnectionMode::EXTERNAL;
     std::string debugger_path_;
-    int connection_timeout_ms_ = 5000;
+    std::atomic<int> connection_timeout_ms_{5000};
+    std::string shared_memory_name_ = SharedMemoryTransport::kDefaultName;
+    std::string tcp_host_ = "127.0.0.1";
+    uint16_t tcp_port_ = SocketTransport::kDefaultPort;
+    PageCache memory_cache_{256};
 
-    // Event handling
-    mutable std::mutex handlers_mutex_;
-    std::vector<EventHandlerEntry> event_handlers_;
+    // Symbols of loaded modules, and disassembly keyed by the bytes it came from
+    SymbolIndex symbol_index_;
+    DisassemblyCache disassembly_cache_{1024};
+    std::mutex symbol_source_mutex_;
+    SymbolSource symbol_source_;
+
+    // Instrumentation
+    std::array<LatencyHistogram, static_cast<size_t>(BridgeOperation::COUNT)> latency_;
+    std::atomic<uint64_t> bytes_sent_{0};
+    std::atomic<uint64_t> bytes_received_{0};
+    std::atomic<uint64_t> bytes_read_{0};
+    std::atomic<uint64_t> bytes_written_{0};
+    std::thread stats_export_thread_;
+    std::mutex stats_export_mutex_;
+    std::condition_variable stats_export_condition_;
+    bool stats_export_stop_ = false;
+
+    // Binary framing for PIPE/TCP. transport_mutex_ serializes sends only;
+    // one receive thread per connection routes replies to their pending
+    // requests and events to the event ring, so requests from several
+    // threads overlap and events arrive with nothing in flight.
+    using ReplyCallback = std::function<void(Result<Frame>)>;
+    struct PendingReply {
+        std::deque<Frame> frames;   // Taken by a thread waiting in NextReplyFrame
+        std::string error;          // Set once no further reply can arrive
+        ReplyCallback on_reply;     // Takes the single reply on the receive thread instead
+    };
+    std::unique_ptr<IBridgeTransport> transport_;
+    std::mutex transport_mutex_;
+    FrameDecoder frame_decoder_;  // Receive thread only
+    uint32_t next_request_id_ = 1;
+    std::mutex reply_mutex_;
+    std::condition_variable reply_condition_;
+    std::unordered_map<uint32_t, PendingReply> pending_replies_;
+    bool receiver_running_ = false;
+    std::thread receive_thread_;
+    std::thread transport_event_thread_;  // Drains the shared-memory event ring
+
+    // Workers running ExecuteCommandAsync callbacks; waited for on destruction
+    std::mutex async_tasks_mutex_;
+    std::vector<std::future<void>> async_tasks_;
+    std::weak_ptr<ITaskExecutor> executor_;  // Owned by the core engine
+
+    // Event handling: handlers are copied on write and swapped in atomically,
+    // so dispatch reads a snapshot and never waits on RegisterEventHandler
+    mutable std::mutex handlers_mutex_;  // Serializes writers only
+    std::shared_ptr<const std::vector<EventHandlerEntry>> event_handlers_;
+    std::shared_ptr<const std::vector<CompactHandlerEntry>> compact_handlers_;
+    EventStringTable event_strings_;
     std::atomic<uint32_t> next_handler_id_{1};
     
-    // Event processing thread
+    // Event processing thread, fed through a bounded MPSC ring
     std::thread event_thread_;
     std::atomic<bool> event_thread_running_{false};
-    std::queue<DebugEvent> event_queue_;
-    std::mutex event_queue_mutex_;
-    std::condition_variable event_condition_;
+    std::unique_ptr<MpscRing<QueuedEvent>> event_queue_;
+    EventOverflowPolicy overflow_policy_ = EventOverflowPolicy::BLOCK;
+    std::mutex event_queue_mutex_;              // Only for sleeping and waking, never on the fast path
+    std::condition_variable event_condition_;   // Dispatcher waits for events
+    std::condition_variable space_condition_;   // BLOCK producers wait for room
+    std::atomic<bool> dispatcher_waiting_{false};
+    std::atomic<size_t> blocked_producers_{0};
+    std::mutex overflow_mutex_;
+    std::deque<QueuedEvent> overflow_events_;   // Staged in order behind a full ring; never waited on
+    std::atomic<bool> has_overflow_{false};
+    std::atomic<bool> coalesce_repeats_{false};
+    std::atomic<uint64_t> repeats_merged_{0};
+    std::atomic<uint64_t> events_posted_{0};
+    std::atomic<uint64_t> events_dispatched_{0};
+    std::atomic<uint64_t> events_dropped_{0};
+    std::atomic<uint64_t> events_coalesced_{0};
+    std::atomic<uint64_t> event_batches_{0};
 
     // Platform-specific implementation
 #ifdef _WIN32
     // Windows-specific handles and communication
     HANDLE process_handle_ = INVALID_HANDLE_VALUE;
     HANDLE pipe_handle_ = INVALID_HANDLE_VALUE;
-    SOCKET tcp_socket_ = INVALID_SOCKET;
     bool winsock_initialized_ = false; // БЕЗОПАСНОСТЬ: отслеживаем WSAStartup
 #endif
 
@@ -122,20 +353,80 @@ private:
     Result<void> ConnectExternal();
     Result<void> ConnectPipe();
     Result<void> ConnectTCP();
+    Result<void> ConnectSharedMemory();
     
     void DisconnectInternal();
     
     // Command execution
     Result<std::string> SendCommand(const std::string& command);
+    Result<void> ExecuteControlCommand(const std::string& command);
+    static bool IsReadOnlyCommand(const std::string& command);
     Result<std::string> ParseCommandResponse(const std::string& raw_response);
     
     // Event processing
     void EventProcessingLoop();
-    void ProcessEventQueue();
+    void StopEventThread();
+    void StopStatsExport();
+    LatencyHistogram& Latency(BridgeOperation operation) {
+        return latency_[static_cast<size_t>(operation)];
+    }
     DebugEvent CreateDebugEvent(const std::string& event_data);
-    void NotifyEventHandlers(const DebugEvent& event);
+    void WakeDispatcher();
+    static QueuedEvent MakeQueuedEvent(DebugEvent event, EventStringTable& strings);
+    // may_block is false on threads that must keep going, such as the one routing replies
+    bool EnqueueEvent(QueuedEvent event, bool may_block = true);
+    void StageOverflowEvent(QueuedEvent event);
+    void TakeOverflowEvents(std::vector<QueuedEvent>& batch);
+    void MergeRepeats(std::vector<QueuedEvent>& batch);
+    void DispatchEvents(const std::vector<QueuedEvent>& events);
+    void TransportEventLoop(SharedMemoryTransport* transport);
+    void PostFramedEvent(const Frame& frame);
+    void TrackModuleEvent(const QueuedEvent& event);
+    Result<std::string> FetchDisassembly(uintptr_t address);
+    // The pages a listing at address may touch; false if they wrap the address space
+    static bool DisassemblyWindow(uintptr_t address, MemoryRange& window);
     
     // Memory operations helpers
+    Result<std::vector<uint8_t>> FetchMemory(uintptr_t address, size_t size);
+    bool UsesFramedTransport() const;
+    Result<std::vector<uint8_t>> ReadMemoryFramed(uintptr_t address, size_t size);
+    Result<void> WriteMemoryFramed(uintptr_t address, const std::vector<uint8_t>& data);
+    Result<void> ReadMemoryBatchFramed(const std::vector<MemoryRange>& spans, uint8_t* buffer,
+                                       std::vector<size_t>& lengths);
+    void ReceiveLoop();
+    void RouteFrame(Frame frame);
+    // Ends every pending request with error; closed also refuses new ones
+    void FailPendingReplies(const std::string& error, bool closed);
+
+    // Request IDs stay registered until their last reply frame has been taken,
+    // or until on_reply has been called; 0 means the transport is gone
+    uint32_t BeginRequest(ReplyCallback on_reply = nullptr);
+    void EndRequest(uint32_t request_id);
+    Result<Frame> NextReplyFrame(uint32_t request_id);
+    Result<void> SendFrame(const FrameHeader& header, const uint8_t* payload);
+    // Once registered, on_reply is called exactly once, with the reply or the error that ended the request
+    Result<uint32_t> SendCommandFrame(const std::string& command, ReplyCallback on_reply = nullptr);
+    Result<std::string> AwaitCommandReply(uint32_t request_id);
+    Result<void> PrepareCommand(const std::string& command);
+    std::function<Result<std::string>()> StartCommand(const std::string& command);
+    // Completes from the receive thread; nothing waits on the executor for the reply
+    void StartCommandAsync(const std::string& command, CommandCallback on_reply);
+    // Runs work on the executor, or a thread of its own, and tracks it for the destructor
+    void Dispatch(std::function<void()> work);
+
+    // Registers a request ID for the lifetime of one synchronous exchange
+    class RequestScope {
+    public:
+        explicit RequestScope(X64DbgBridge& bridge) : bridge_(bridge), id_(bridge.BeginRequest()) {}
+        ~RequestScope() { bridge_.EndRequest(id_); }
+        RequestScope(const RequestScope&) = delete;
+        RequestScope& operator=(const RequestScope&) = delete;
+        uint32_t id() const { return id_; }
+
+    private:
+        X64DbgBridge& bridge_;
+        uint32_t id_;
+    };
     Result<void> ValidateMemoryAccess(uintptr_t address, size_t size);
     std::string FormatMemoryCommand(const std::string& operation, uintptr_t address, size_t size);
     std::vector<uint8_t> ParseHexData(const std::string& hex_string);
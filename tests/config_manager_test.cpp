@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/config/config_manager.hpp"
+
+using namespace mcp;
+
+/**
+ * @brief Test listeners see immutable snapshots and a watched file reloads only when valid
+ */
+TEST(ConfigManagerTest, PublishesSnapshotsAndReloadsWatchedFile) {
+    ConfigManager manager;
+    ASSERT_TRUE(manager.SetDefaults().IsSuccess());
+    std::mutex changes_mutex;
+    std::vector<uint32_t> changes;
+    const size_t id = manager.Subscribe([&](const std::shared_ptr<const Config>& config, uint32_t changed) {
+        ASSERT_TRUE(config != nullptr);
+        const std::lock_guard<std::mutex> lock(changes_mutex);
+        changes.push_back(changed);
+    });
+    auto last_change = [&]() {
+        const std::lock_guard<std::mutex> lock(changes_mutex);
+        return changes.empty() ? 0u : changes.back();
+    };
+
+    // Readers keep the snapshot they took; only the touched section is announced
+    auto before = manager.GetSnapshot();
+    ASSERT_TRUE(manager.SetValue("/debug_config/x64dbg_path", "D:\\dbg\\x64dbg.exe").IsSuccess());
+    auto after = manager.GetSnapshot();
+    EXPECT_EQ("C:\\x64dbg\\x64dbg.exe", before->debug_config.x64dbg_path);
+    EXPECT_EQ("D:\\dbg\\x64dbg.exe", after->debug_config.x64dbg_path);
+    EXPECT_EQ(uint32_t(ConfigManager::SECTION_DEBUG), last_change());
+    ASSERT_TRUE(manager.SetValue("/debug_config/x64dbg_path", "D:\\dbg\\x64dbg.exe").IsSuccess());
+    EXPECT_EQ(1u, changes.size());
+
+    // Only recent snapshots are retained for GetConfig(); older ones go once nobody holds them
+    before.reset();
+    after.reset();
+    std::weak_ptr<const Config> retired = manager.GetSnapshot();
+    const Config& referenced = manager.GetConfig();
+    EXPECT_EQ("D:\\dbg\\x64dbg.exe", referenced.debug_config.x64dbg_path);
+    for (int i = 0; i < 16; ++i) {
+        ASSERT_TRUE(manager.SetValue("/debug_config/tcp_host", "10.0.0." + std::to_string(i)).IsSuccess());
+    }
+    EXPECT_TRUE(retired.expired());
+
+    const auto path = std::filesystem::temp_directory_path() /
+                      ("mcp_config_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".json");
+    auto write_config = [&path](const std::string& text) {
+        std::ofstream out(path, std::ios::trunc);
+        out << text;
+    };
+    write_config(R"({"debug_config": {"connection_timeout_ms": 1000}, "llm_config": {"cache_entries": 64}})");
+    ASSERT_TRUE(manager.LoadConfig(path.string()).IsSuccess());
+    EXPECT_EQ(1000, manager.GetSnapshot()->debug_config.connection_timeout_ms);
+    EXPECT_TRUE(last_change() & ConfigManager::SECTION_LOG);  // Absent from the file now
+
+    std::atomic<bool> reading{true};
+    std::thread reader([&]() {
+        while (reading.load()) {
+            auto snapshot = manager.GetSnapshot();
+            const int timeout = snapshot->debug_config.connection_timeout_ms;
+            EXPECT_TRUE(timeout == 1000 || timeout == 2500);
+        }
+    });
+    ASSERT_TRUE(manager.WatchFile(std::chrono::milliseconds(10)).IsSuccess());
+    const uint64_t generation = manager.GetGeneration();
+    write_config(R"({"debug_config": {"connection_timeout_ms": 2500}, "llm_config": {"cache_entries": 64}})");
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (manager.GetGeneration() == generation && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    reading = false;
+    reader.join();
+    EXPECT_EQ(2500, manager.GetSnapshot()->debug_config.connection_timeout_ms);
+    EXPECT_EQ(64u, manager.GetSnapshot()->llm_config.cache_entries);
+    EXPECT_EQ(uint32_t(ConfigManager::SECTION_DEBUG), last_change());
+
+    // A broken file is reported and the last good snapshot stays
+    write_config("{\"debug_config\": ");
+    const auto error_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (manager.GetLastReloadError().empty() && std::chrono::steady_clock::now() < error_deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_FALSE(manager.GetLastReloadError().empty());
+    EXPECT_EQ(2500, manager.GetSnapshot()->debug_config.connection_timeout_ms);
+
+    manager.StopWatching();
+    manager.Unsubscribe(id);
+    const size_t notified = changes.size();
+    ASSERT_TRUE(manager.SetValue("/debug_config/x64dbg_path", "E:\\x64dbg.exe").IsSuccess());
+    EXPECT_EQ(notified, changes.size());
+    std::filesystem::remove(path);
+}
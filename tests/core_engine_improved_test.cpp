@@ -1,6 +1,17 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 #include "../src/core/core_engine.hpp"
+#include "../src/core/task_executor.hpp"
+#include "mcp/executor.hpp"
+#include "mcp/memory_view.hpp"
 
 using namespace mcp;
 
@@ -71,4 +82,283 @@ TEST_F(CoreEngineImprovedTest, SharedFromThisWorks) {
         EXPECT_NE(nullptr, self);
         EXPECT_EQ(engine_, self);
     });
-} 
\ No newline at end of file
+} 
+namespace {
+
+// Hands out a listing per address and records the comments written back
+class FakeBridge : public IX64DbgBridge {
+public:
+    Result<void> Connect() override { return Result<void>::Success(); }
+    Result<void> Disconnect() override { return Result<void>::Success(); }
+    Result<std::string> ExecuteCommand(const std::string& command) override {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        commands.push_back(command);
+        return Result<std::string>::Success("");
+    }
+    Result<std::string> GetDisassembly(uintptr_t address) override {
+        if (address == kUnreadable) {
+            return Result<std::string>::Error("unreadable");
+        }
+        return Result<std::string>::Success("listing:" + std::to_string(address));
+    }
+    Result<MemoryDump> ReadMemory(uintptr_t, size_t) override { return Result<MemoryDump>::Error("unused"); }
+    Result<std::vector<MemoryView>> ReadMemoryBatch(const std::vector<MemoryRange>&) override {
+        return Result<std::vector<MemoryView>>::Error("unused");
+    }
+    Result<void> SetBreakpoint(uintptr_t) override { return Result<void>::Success(); }
+    void RegisterEventHandler(std::function<void(const DebugEvent&)>) override {}
+    bool IsConnected() const override { return true; }
+
+    size_t CommandCount() {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        return commands.size();
+    }
+
+    static constexpr uintptr_t kUnreadable = 0xDEAD;
+    std::vector<std::string> commands;
+
+private:
+    std::mutex mutex_;
+};
+
+// Answers out of order, later requests first, and tracks how many are outstanding
+class FakeLLMEngine : public ILLMEngine {
+public:
+    std::future<Result<LLMResponse>> SendRequest(const LLMRequest& request) override {
+        const int outstanding = ++outstanding_;
+        int seen = max_outstanding.load();
+        while (outstanding > seen && !max_outstanding.compare_exchange_weak(seen, outstanding)) {
+        }
+        const int delay_ms = 40 - 4 * (requests++ % 8);
+        return std::async(std::launch::async, [this, request, delay_ms]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+            LLMResponse response;
+            response.content = "analysis of " + request.context.at(0);
+            response.success = true;
+            --outstanding_;
+            return Result<LLMResponse>::Success(response);
+        });
+    }
+    Result<LLMResponse> SendRequestSync(const LLMRequest& request) override { return SendRequest(request).get(); }
+    std::future<Result<LLMResponse>> SendRequestStreaming(const LLMRequest& request, LLMStreamCallback) override {
+        return SendRequest(request);
+    }
+    Result<void> SetAPIKey(const std::string&, const std::string&) override { return Result<void>::Success(); }
+    std::vector<std::string> GetSupportedProviders() const override { return {"fake"}; }
+    Result<void> ValidateConnection(const std::string&) override { return Result<void>::Success(); }
+
+    std::atomic<int> max_outstanding{0};
+    std::atomic<int> requests{0};
+
+private:
+    std::atomic<int> outstanding_{0};
+};
+
+} // namespace
+
+/**
+ * @brief Test batched analysis delivers ordered results with bounded concurrency
+ */
+TEST(CoreEngineBatchTest, AnalyzesFunctionsInOrderWithBoundedConcurrency) {
+    auto bridge = std::make_shared<FakeBridge>();
+    auto llm = std::make_shared<FakeLLMEngine>();
+    auto engine = std::make_shared<CoreEngine>(nullptr, llm, bridge);
+
+    std::vector<uintptr_t> addresses;
+    for (uintptr_t address = 0x401000; address < 0x401000 + 20 * 0x10; address += 0x10) {
+        addresses.push_back(address);
+    }
+    addresses.insert(addresses.begin() + 5, FakeBridge::kUnreadable);
+
+    BatchAnalysisOptions options;
+    options.max_in_flight = 4;
+    options.fetch_batch = 6;
+    options.annotate = true;
+
+    std::vector<FunctionAnalysis> results;
+    std::vector<size_t> completed;
+    auto batch = engine->AnalyzeFunctions(addresses, options,
+                                          [&](const FunctionAnalysis& result, const BatchProgress& progress) {
+                                              results.push_back(result);
+                                              completed.push_back(progress.completed);
+                                          });
+    ASSERT_TRUE(batch.IsSuccess()) << batch.Error();
+    EXPECT_EQ(addresses.size(), batch.Value().total);
+    EXPECT_EQ(addresses.size(), batch.Value().completed);
+    EXPECT_EQ(1u, batch.Value().failed);
+
+    ASSERT_EQ(addresses.size(), results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(i, results[i].index);
+        EXPECT_EQ(addresses[i], results[i].address);
+        EXPECT_EQ(i + 1, completed[i]);
+        if (addresses[i] == FakeBridge::kUnreadable) {
+            EXPECT_FALSE(results[i].success);
+            EXPECT_NE(std::string::npos, results[i].error.find("unreadable"));
+        } else {
+            ASSERT_TRUE(results[i].success) << results[i].error;
+            EXPECT_EQ("analysis of listing:" + std::to_string(addresses[i]), results[i].analysis);
+        }
+    }
+
+    EXPECT_EQ(20, llm->requests.load());
+    EXPECT_LE(llm->max_outstanding.load(), 4);
+    EXPECT_GE(llm->max_outstanding.load(), 2);
+    EXPECT_EQ(20u, bridge->commands.size());
+}
+
+/**
+ * @brief Test the executor runs continuations without blocking and winds down cleanly
+ */
+TEST(TaskExecutorTest, RunsContinuationsAndFanOutOnSharedWorkers) {
+    TaskExecutorOptions options;
+    options.worker_threads = 4;
+    auto executor = std::make_shared<TaskExecutor>(options);
+    EXPECT_EQ(4u, executor->GetWorkerCount());
+
+    // A continuation waits for its future without holding a worker
+    std::promise<int> producer;
+    std::promise<int> continued;
+    ASSERT_TRUE(Then(*executor, producer.get_future(), [&continued](std::future<int> ready) {
+        continued.set_value(ready.get() * 2);
+    }));
+    auto doubled = continued.get_future();
+    EXPECT_EQ(42, Submit(*executor, []() { return 42; }).get());
+    producer.set_value(21);
+    ASSERT_EQ(std::future_status::ready, doubled.wait_for(std::chrono::seconds(5)));
+    EXPECT_EQ(42, doubled.get());
+
+    // Futures from Submit are continued by the worker that finished them; nothing is watched
+    std::promise<void> release;
+    auto gate = release.get_future().share();
+    auto slow = Submit(*executor, [gate]() {
+        gate.wait();
+        return 5;
+    });
+    std::promise<std::thread::id> continued_on;
+    ASSERT_TRUE(Then(executor, std::move(slow), [&continued_on](std::future<int> ready) {
+        EXPECT_EQ(5, ready.get());
+        continued_on.set_value(std::this_thread::get_id());
+    }));
+    EXPECT_EQ(0u, executor->GetStats().watching);
+    release.set_value();
+    auto continued_future = continued_on.get_future();
+    ASSERT_EQ(std::future_status::ready, continued_future.wait_for(std::chrono::seconds(5)));
+
+    // An abandoned Promise still completes its continuation, with broken_promise
+    std::promise<bool> saw_broken;
+    {
+        Promise<int> abandoned;
+        ASSERT_TRUE(Then(executor, abandoned.get_future(),
+                         [&saw_broken](std::future<int> ready) {
+            try {
+                ready.get();
+                saw_broken.set_value(false);
+            } catch (const std::future_error& error) {
+                saw_broken.set_value(error.code() == std::future_errc::broken_promise);
+            }
+        }));
+    }
+    EXPECT_TRUE(saw_broken.get_future().get());
+
+    // A deferred future never becomes ready on its own, so it is refused up front
+    EXPECT_FALSE(Then(*executor, std::async(std::launch::deferred, []() { return 1; }),
+                      [](std::future<int>) { FAIL(); }));
+
+    // Nested fan-out from a worker lands on its own deque and is stolen by the others
+    std::vector<std::atomic<int>> visits(64);
+    Submit(*executor, [&]() {
+        ParallelFor(*executor, visits.size(), 4, [&](size_t index) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            ++visits[index];
+        });
+    }).get();
+    for (const auto& count : visits) {
+        EXPECT_EQ(1, count.load());
+    }
+    EXPECT_GT(executor->GetStats().stolen, 0u);
+
+    // The engine hands the analysis answer to the executor instead of a detached thread
+    auto bridge = std::make_shared<FakeBridge>();
+    auto engine = std::make_shared<CoreEngine>(nullptr, std::make_shared<FakeLLMEngine>(), bridge);
+    engine->AnalyzeCurrentContext();
+    for (int i = 0; i < 500 && bridge->CommandCount() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(1u, bridge->CommandCount());
+    EXPECT_EQ(0u, bridge->commands[0].find("SetCommentAt "));
+
+    // Shutdown drains queued work, drops unready continuations and refuses more
+    std::atomic<int> drained{0};
+    for (int i = 0; i < 16; ++i) {
+        executor->Post([&drained]() { ++drained; });
+    }
+    std::promise<void> never;
+    ASSERT_TRUE(Then(*executor, never.get_future(), [](std::future<void>) { FAIL(); }));
+    executor->Shutdown();
+    EXPECT_EQ(16, drained.load());
+    EXPECT_EQ(1u, executor->GetStats().dropped);
+    EXPECT_FALSE(executor->IsRunning());
+    EXPECT_FALSE(executor->Post([]() {}));
+    EXPECT_EQ(7, Submit(*executor, []() { return 7; }).get());  // Refused work runs inline
+}
+
+TEST_F(CoreEngineImprovedTest, BuildsModulesOnFirstUseAndReportsStartup) {
+    ASSERT_TRUE(engine_->Initialize().IsSuccess());
+    auto has_phase = [this](const std::string& name, StartupPhase::Kind kind) {
+        const auto report = engine_->GetStartupReport();
+        return std::any_of(report.phases.begin(), report.phases.end(), [&](const StartupPhase& phase) {
+            return phase.name == name && phase.kind == kind;
+        });
+    };
+    EXPECT_TRUE(has_phase("logger", StartupPhase::Kind::SERIAL));
+    EXPECT_TRUE(has_phase("security_manager", StartupPhase::Kind::PARALLEL));
+    EXPECT_TRUE(has_phase("config_manager", StartupPhase::Kind::SERIAL));
+    EXPECT_NE(nullptr, engine_->GetSecurityManager());
+    EXPECT_GT(engine_->GetStartupReport().total.count(), 0);
+
+    // Nothing heavy is built until somebody asks for it
+    EXPECT_FALSE(has_phase("dump_analyzer", StartupPhase::Kind::LAZY));
+    EXPECT_FALSE(has_phase("llm_engine", StartupPhase::Kind::LAZY));
+    auto analyzer = engine_->GetDumpAnalyzer();
+    ASSERT_NE(nullptr, analyzer);
+    EXPECT_EQ(analyzer, engine_->GetDumpAnalyzer());
+    EXPECT_TRUE(has_phase("dump_analyzer", StartupPhase::Kind::LAZY));
+
+    // Racing first uses agree on one instance
+    std::vector<std::shared_ptr<ILLMEngine>> seen(4);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < seen.size(); ++i) {
+        threads.emplace_back([this, &seen, i]() { seen[i] = engine_->GetLLMEngine(); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_NE(nullptr, seen[0]);
+    for (const auto& llm : seen) {
+        EXPECT_EQ(seen[0], llm);
+    }
+
+    engine_->PreloadModules();
+    EXPECT_TRUE(has_phase("debug_bridge", StartupPhase::Kind::LAZY));
+    const auto report = engine_->GetStartupReport();
+    EXPECT_EQ(1, std::count_if(report.phases.begin(), report.phases.end(),
+                               [](const StartupPhase& phase) { return phase.name == "llm_engine"; }));
+    EXPECT_NE(std::string::npos, report.ToString().find("(on first use)"));
+
+    // Preloading may race a restart, which replaces the executor
+    std::atomic<bool> restarting{true};
+    std::thread preloader([this, &restarting]() {
+        while (restarting.load()) {
+            engine_->PreloadModules(false);
+        }
+    });
+    EXPECT_TRUE(engine_->Shutdown().IsSuccess());
+    EXPECT_TRUE(engine_->Initialize().IsSuccess());
+    restarting = false;
+    preloader.join();
+    EXPECT_NE(nullptr, engine_->GetTaskExecutor());
+
+    ASSERT_TRUE(engine_->Shutdown().IsSuccess());
+    EXPECT_EQ(nullptr, engine_->GetDebugBridge());
+}
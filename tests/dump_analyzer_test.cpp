@@ -0,0 +1,955 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <set>
+#include <tuple>
+#include "../src/analyzer/dump_analyzer.hpp"
+#include "../src/analyzer/dump_file.hpp"
+
+using namespace mcp;
+
+namespace {
+
+MemoryDump MakeDump(std::vector<uint8_t> data, uintptr_t base = 0x400000) {
+    MemoryDump dump;
+    dump.base_address = base;
+    dump.size = data.size();
+    dump.data = std::move(data);
+    dump.module_name = "test.bin";
+    return dump;
+}
+
+std::vector<uint8_t> RandomBytes(size_t size, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::vector<uint8_t> data(size);
+    for (auto& b : data) {
+        b = static_cast<uint8_t>(byte(rng));
+    }
+    return data;
+}
+
+void Plant(std::vector<uint8_t>& data, size_t offset, const std::vector<uint8_t>& bytes) {
+    std::copy(bytes.begin(), bytes.end(), data.begin() + static_cast<std::ptrdiff_t>(offset));
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Test fixture for DumpAnalyzer
+ */
+class DumpAnalyzerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        analyzer_ = std::make_unique<DumpAnalyzer>(nullptr);
+    }
+
+    std::unique_ptr<DumpAnalyzer> analyzer_;
+};
+
+/**
+ * @brief Matcher reports every occurrence, including overlapping and nested ones
+ */
+TEST(MultiPatternMatcherTest, ReportsAllOccurrences) {
+    const std::vector<std::vector<uint8_t>> patterns = {
+        {'h', 'e'}, {'s', 'h', 'e'}, {'h', 'i', 's'}, {'h', 'e', 'r', 's'}};
+    MultiPatternMatcher matcher(patterns);
+
+    const std::string text = "ushers";
+    std::vector<std::pair<size_t, size_t>> found;
+    matcher.Scan(reinterpret_cast<const uint8_t*>(text.data()), text.size(),
+                 MultiPatternMatcher::kInitialState,
+                 [&](size_t index, size_t end) { found.emplace_back(index, end); });
+
+    const std::vector<std::pair<size_t, size_t>> expected = {{1, 4}, {0, 4}, {3, 6}};
+    EXPECT_EQ(expected, found);
+}
+
+/**
+ * @brief Scan state carries matches across block boundaries
+ */
+TEST(MultiPatternMatcherTest, ResumesAcrossBlocks) {
+    MultiPatternMatcher matcher({{0xDE, 0xAD, 0xBE, 0xEF}});
+    const std::vector<uint8_t> first = {0x00, 0xDE, 0xAD};
+    const std::vector<uint8_t> second = {0xBE, 0xEF, 0x00};
+
+    size_t hits = 0;
+    auto state = matcher.Scan(first.data(), first.size(), MultiPatternMatcher::kInitialState,
+                              [&](size_t, size_t) { ++hits; });
+    matcher.Scan(second.data(), second.size(), state, [&](size_t, size_t end) {
+        ++hits;
+        EXPECT_EQ(2u, end);
+    });
+    EXPECT_EQ(1u, hits);
+}
+
+/**
+ * @brief A serialized automaton scans like the original and corrupt images are refused
+ */
+TEST(MultiPatternMatcherTest, RoundTripsThroughImage) {
+    const std::vector<std::vector<uint8_t>> patterns = {
+        {'h', 'e'}, {'s', 'h', 'e'}, {'h', 'i', 's'}, {'h', 'e', 'r', 's'}};
+    MultiPatternMatcher original(patterns);
+    auto image = std::make_shared<std::vector<uint8_t>>();
+    original.Serialize(*image);
+
+    auto loaded = MultiPatternMatcher::FromImage(image->data(), image->size(), image);
+    ASSERT_TRUE(loaded.IsSuccess()) << loaded.Error();
+    EXPECT_TRUE(loaded.Value().IsCompiledFrom(patterns));
+    EXPECT_FALSE(loaded.Value().IsCompiledFrom({{'h', 'e'}}));
+
+    const std::string text = "ushers his hershe";
+    const auto scan = [&text](const MultiPatternMatcher& matcher) {
+        std::vector<std::pair<size_t, size_t>> found;
+        matcher.Scan(reinterpret_cast<const uint8_t*>(text.data()), text.size(),
+                     MultiPatternMatcher::kInitialState,
+                     [&](size_t index, size_t end) { found.emplace_back(index, end); });
+        return found;
+    };
+    EXPECT_EQ(scan(original), scan(loaded.Value()));
+
+    EXPECT_TRUE(MultiPatternMatcher::FromImage(image->data(), image->size() - 8, image).IsError());
+    auto corrupt = std::make_shared<std::vector<uint8_t>>(*image);
+    // Header, byte classes, root row and pattern lengths precede the 24-byte nodes
+    const size_t first_node = 32 + 256 + 256 * sizeof(uint32_t) + patterns.size() * sizeof(uint32_t);
+    const uint32_t deeper = 5;  // "she"; node 1 is "h"
+    std::memcpy(corrupt->data() + first_node + 24, &deeper, sizeof(deeper));
+    EXPECT_TRUE(MultiPatternMatcher::FromImage(corrupt->data(), corrupt->size(), corrupt).IsError());
+}
+
+/**
+ * @brief Custom patterns are found at every planted, non-overlapping location
+ */
+TEST_F(DumpAnalyzerTest, FindsCustomPatternsInAddressOrder) {
+    const std::vector<uint8_t> sig_a = {0x55, 0x8B, 0xEC, 0x83, 0xE4, 0xF8, 0x81, 0xEC, 0x34};
+    const std::vector<uint8_t> sig_b = {0x48, 0x89, 0x5C, 0x24, 0x08, 0x57, 0x48, 0x83, 0xEC};
+    analyzer_->AddCustomPattern("sig_a", sig_a, "A");
+    analyzer_->AddCustomPattern("sig_b", sig_b, "B");
+
+    auto data = RandomBytes(64 * 1024, 1);
+    Plant(data, 100, sig_b);
+    Plant(data, 5000, sig_a);
+    Plant(data, 5009, sig_a);
+    const auto dump = MakeDump(std::move(data));
+
+    auto result = analyzer_->FindMalwareSignatures(dump);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_TRUE(result.Value().empty()); // Names carry no malware marker
+
+    auto analysis = analyzer_->PerformFullAnalysis(dump);
+    ASSERT_TRUE(analysis.IsSuccess());
+    const auto& patterns = analysis.Value().patterns;
+    ASSERT_EQ(4u, patterns.size());
+    EXPECT_EQ("high_entropy_region", patterns[0].pattern_name); // Random filler
+    EXPECT_EQ(dump.base_address, patterns[0].address);
+    EXPECT_EQ(dump.data.size(), patterns[0].size);
+    EXPECT_EQ("sig_b", patterns[1].pattern_name);
+    EXPECT_EQ(dump.base_address + 100, patterns[1].address);
+    EXPECT_EQ(dump.base_address + 5000, patterns[2].address);
+    EXPECT_EQ(dump.base_address + 5009, patterns[3].address);
+    EXPECT_EQ(sig_a.size(), patterns[2].size);
+}
+
+/**
+ * @brief Patterns loaded from a database file are matched after the reload
+ */
+TEST_F(DumpAnalyzerTest, LoadsPatternDatabase) {
+    const std::string path = "dump_analyzer_test_patterns.txt";
+    {
+        std::ofstream file(path);
+        file << "# test database\n"
+             << "malware_test_stub | 4D 5A 50 45 4C 01 02 03 04 | Test stub\n"
+             << "broken|zz|ignored\n";
+    }
+
+    const size_t before = analyzer_->GetPatternCount();
+    analyzer_->LoadPatternDatabase(path);
+    std::remove(path.c_str());
+    EXPECT_EQ(before + 1, analyzer_->GetPatternCount());
+
+    auto data = RandomBytes(4096, 2);
+    Plant(data, 1024, {0x4D, 0x5A, 0x50, 0x45, 0x4C, 0x01, 0x02, 0x03, 0x04});
+    auto result = analyzer_->FindMalwareSignatures(MakeDump(std::move(data)));
+    ASSERT_TRUE(result.IsSuccess());
+    ASSERT_EQ(1u, result.Value().size());
+    EXPECT_EQ("malware_test_stub", result.Value()[0].pattern_name);
+    EXPECT_EQ("Test stub", result.Value()[0].description);
+}
+
+/**
+ * @brief The compiled cache is written on first load, mapped on the next and rebuilt when stale
+ */
+TEST_F(DumpAnalyzerTest, LoadsPatternDatabaseThroughCompiledCache) {
+    const std::string path = "dump_analyzer_test_cached_patterns.txt";
+    const std::string cache_path = "dump_analyzer_test_cached_patterns.bin";
+    const auto write_database = [&path](const std::string& description) {
+        std::ofstream file(path);
+        file << "malware_test_stub | 4D 5A 50 45 4C 01 02 03 04 | " << description << "\n";
+    };
+    const auto find_stub = [](DumpAnalyzer& analyzer) {
+        auto data = RandomBytes(4096, 3);
+        Plant(data, 1024, {0x4D, 0x5A, 0x50, 0x45, 0x4C, 0x01, 0x02, 0x03, 0x04});
+        auto result = analyzer.FindMalwareSignatures(MakeDump(std::move(data)));
+        EXPECT_TRUE(result.IsSuccess());
+        return result.IsSuccess() && result.Value().size() == 1 ? result.Value()[0].description : "";
+    };
+    std::remove(cache_path.c_str());
+
+    write_database("Test stub");
+    const size_t before = analyzer_->GetPatternCount();
+    analyzer_->LoadPatternDatabase(path, cache_path);
+    EXPECT_EQ(before + 1, analyzer_->GetPatternCount());
+    EXPECT_EQ("Test stub", find_stub(*analyzer_));
+    ASSERT_TRUE(std::ifstream(cache_path).good());
+
+    // Edit the cached description in place: a second load must take it from the cache
+    std::vector<char> cache;
+    {
+        std::ifstream file(cache_path, std::ios::binary);
+        cache.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    const std::string original = "Test stub";
+    auto it = std::search(cache.begin(), cache.end(), original.begin(), original.end());
+    ASSERT_NE(cache.end(), it);
+    std::memcpy(&*it, "Cache hit", original.size());
+    std::ofstream(cache_path, std::ios::binary | std::ios::trunc).write(cache.data(), cache.size());
+
+    DumpAnalyzer cached(nullptr);
+    cached.LoadPatternDatabase(path, cache_path);
+    EXPECT_EQ(before + 1, cached.GetPatternCount());
+    EXPECT_EQ("Cache hit", find_stub(cached));
+
+    // A changed database invalidates the cache
+    write_database("New stub");
+    DumpAnalyzer rebuilt(nullptr);
+    rebuilt.LoadPatternDatabase(path, cache_path);
+    EXPECT_EQ("New stub", find_stub(rebuilt));
+
+    // A truncated cache falls back to the text
+    cache.resize(cache.size() / 2);
+    std::ofstream(cache_path, std::ios::binary | std::ios::trunc).write(cache.data(), cache.size());
+    DumpAnalyzer recovered(nullptr);
+    recovered.LoadPatternDatabase(path, cache_path);
+    EXPECT_EQ(before + 1, recovered.GetPatternCount());
+    EXPECT_EQ("New stub", find_stub(recovered));
+
+    std::remove(path.c_str());
+    std::remove(cache_path.c_str());
+}
+
+/**
+ * @brief Dumps shorter than every pattern are handled without scanning past the end
+ */
+TEST_F(DumpAnalyzerTest, HandlesTinyDumps) {
+    auto result = analyzer_->FindMalwareSignatures(MakeDump({0x90}));
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_TRUE(result.Value().empty());
+}
+
+/**
+ * @brief Signature text form round-trips and rejects malformed input
+ */
+TEST(ByteSignatureTest, ParsesMaskedBytesAndJumps) {
+    auto signature = ByteSignature::Parse("6A 04 68 ?? 1? ?0 [2-6] E8 [3] C3");
+    ASSERT_TRUE(signature.IsSuccess());
+    EXPECT_EQ("6A 04 68 ?? 1? ?0 [2-6] E8 [3] C3", signature.Value().ToString());
+    EXPECT_EQ(3u, signature.Value().GetPieces().size());
+    EXPECT_EQ(8u, signature.Value().GetElementCount());
+    EXPECT_EQ(13u, signature.Value().GetMinLength());
+    EXPECT_EQ(17u, signature.Value().GetMaxLength());
+    EXPECT_FALSE(signature.Value().IsExact());
+
+    EXPECT_TRUE(ByteSignature::Parse("4d5a").Value().IsExact());
+    EXPECT_TRUE(ByteSignature::Parse("").IsError());
+    EXPECT_TRUE(ByteSignature::Parse("[2] 90").IsError());
+    EXPECT_TRUE(ByteSignature::Parse("90 [2]").IsError());
+    EXPECT_TRUE(ByteSignature::Parse("90 [5-2] 90").IsError());
+    EXPECT_TRUE(ByteSignature::Parse("9G").IsError());
+    EXPECT_TRUE(ByteSignature::Parse("909").IsError());
+}
+
+/**
+ * @brief Anchored masked matching agrees with a brute-force scan at every offset
+ */
+TEST(SignatureMatcherTest, MatchesBruteForce) {
+    const std::vector<std::string> texts = {
+        "55 8B EC ?? ?? 83 E4 [2-5] F8 81 EC",
+        "?? 3? 4? [0-2] 41",
+        "E8 [1-3] 58 [0-1] 5? C3",
+        "?? ??",
+    };
+    std::vector<ByteSignature> signatures;
+    for (const auto& text : texts) {
+        signatures.push_back(ByteSignature::Parse(text).Value());
+    }
+    SignatureMatcher matcher(signatures);
+    EXPECT_EQ(1u, matcher.GetUnanchoredCount());
+
+    // Skewed alphabet so that partial and full matches are frequent
+    std::mt19937 rng(7);
+    const uint8_t alphabet[] = {0x55, 0x8B, 0xEC, 0x83, 0xE4, 0xF8, 0x81, 0x30, 0x41,
+                                0x4F, 0xE8, 0x58, 0x50, 0xC3, 0x00};
+    std::vector<uint8_t> data(8192);
+    for (auto& b : data) {
+        b = alphabet[rng() % sizeof(alphabet)];
+    }
+
+    // Reference: recursive match with the same shortest-jump-first order
+    std::function<size_t(const ByteSignature&, size_t, size_t)> match_from =
+        [&](const ByteSignature& sig, size_t piece, size_t pos) -> size_t {
+            const auto& p = sig.GetPieces()[piece];
+            if (pos + p.values.size() > data.size()) return 0;
+            for (size_t i = 0; i < p.values.size(); ++i) {
+                if ((data[pos + i] & p.masks[i]) != p.values[i]) return 0;
+            }
+            if (piece + 1 == sig.GetPieces().size()) return pos + p.values.size();
+            const auto& next = sig.GetPieces()[piece + 1];
+            for (size_t gap = next.min_gap; gap <= next.max_gap; ++gap) {
+                size_t end = match_from(sig, piece + 1, pos + p.values.size() + gap);
+                if (end) return end;
+            }
+            return 0;
+        };
+
+    std::set<std::tuple<size_t, size_t, size_t>> expected;
+    for (size_t s = 0; s < signatures.size(); ++s) {
+        for (size_t offset = 0; offset < data.size(); ++offset) {
+            size_t end = match_from(signatures[s], 0, offset);
+            if (end) expected.emplace(s, offset, end - offset);
+        }
+    }
+
+    std::set<std::tuple<size_t, size_t, size_t>> found;
+    std::vector<size_t> last_offset(signatures.size(), 0);
+    matcher.FindMatches(data.data(), data.size(), 0, data.size(),
+                        [&](size_t index, size_t offset, size_t length) {
+                            EXPECT_GE(offset, last_offset[index]);
+                            last_offset[index] = offset;
+                            found.emplace(index, offset, length);
+                        });
+
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(expected, found);
+}
+
+/**
+ * @brief Wildcard patterns from a database are reported with their actual span
+ */
+TEST_F(DumpAnalyzerTest, MatchesWildcardSignatures) {
+    analyzer_->AddCustomPattern("malware_masked",
+                                ByteSignature::Parse("55 8B EC ?? ?? 83 E4 [2-5] F8 81 EC").Value(),
+                                "masked");
+
+    auto data = RandomBytes(16 * 1024, 3);
+    Plant(data, 300, {0x55, 0x8B, 0xEC, 0x12, 0x34, 0x83, 0xE4, 0xAA, 0xBB, 0xF8, 0x81, 0xEC});
+    Plant(data, 9000, {0x55, 0x8B, 0xEC, 0x00, 0x00, 0x83, 0xE4, 1, 2, 3, 4, 0xF8, 0x81, 0xEC});
+
+    auto result = analyzer_->FindMalwareSignatures(MakeDump(std::move(data), 0x1000));
+    ASSERT_TRUE(result.IsSuccess());
+    ASSERT_EQ(2u, result.Value().size());
+    EXPECT_EQ(0x1000u + 300, result.Value()[0].address);
+    EXPECT_EQ(12u, result.Value()[0].size);
+    EXPECT_EQ(0x1000u + 9000, result.Value()[1].address);
+    EXPECT_EQ(14u, result.Value()[1].size);
+}
+
+namespace {
+
+// Byte-at-a-time reference for both string encodings
+std::vector<StringRun> ReferenceRuns(const std::vector<uint8_t>& data, bool wide, size_t min_length) {
+    auto printable = [](uint8_t c) { return (c >= 32 && c <= 126) || c == '\t' || c == '\n' || c == '\r'; };
+    std::vector<StringRun> runs;
+    const size_t step = wide ? 2 : 1;
+    size_t start = 0;
+    size_t length = 0;
+    for (size_t i = 0; i + step <= data.size(); i += step) {
+        const bool valid = wide ? (printable(data[i]) && data[i + 1] == 0) : printable(data[i]);
+        if (valid) {
+            if (length++ == 0) start = i;
+        } else {
+            if (length >= min_length) runs.push_back({start, length, wide});
+            length = 0;
+        }
+    }
+    if (length >= min_length) runs.push_back({start, length, wide});
+    return runs;
+}
+
+std::vector<uint8_t> TextHeavyBytes(size_t size, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size;) {
+        const size_t run = rng() % 40;
+        const uint32_t kind = rng() % 3;
+        for (size_t j = 0; j < run && i < size; ++j, ++i) {
+            if (kind == 0) data[i] = static_cast<uint8_t>('a' + rng() % 26);
+            else if (kind == 1) data[i] = (i % 2 == 0) ? static_cast<uint8_t>('A' + rng() % 26) : 0;
+            else data[i] = static_cast<uint8_t>(rng());
+        }
+    }
+    return data;
+}
+
+bool SameRuns(const std::vector<StringRun>& a, const std::vector<StringRun>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].offset != b[i].offset || a[i].length != b[i].length || a[i].is_wide != b[i].is_wide) return false;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Fused kernel agrees with a byte-at-a-time scan, whole and fed in pieces
+ */
+TEST(StringRunScannerTest, MatchesReferenceScan) {
+    for (size_t size : {0u, 1u, 63u, 64u, 65u, 4095u, 4096u, 20001u}) {
+        const auto data = TextHeavyBytes(size, static_cast<uint32_t>(size));
+        const auto ascii = ReferenceRuns(data, false, 4);
+        const auto wide = ReferenceRuns(data, true, 4);
+
+        StringRunScanner whole(4, true, true);
+        whole.Scan(data.data(), data.size());
+        whole.Finish();
+        EXPECT_TRUE(SameRuns(ascii, whole.GetAsciiRuns())) << "size " << size << " " << StringRunScanner::GetKernelName();
+        EXPECT_TRUE(SameRuns(wide, whole.GetWideRuns())) << "size " << size;
+
+        StringRunScanner pieces(4, true, true);
+        for (size_t offset = 0; offset < data.size(); offset += 1000) {
+            pieces.Scan(data.data() + offset, std::min<size_t>(1000, data.size() - offset));
+        }
+        pieces.Finish();
+        EXPECT_TRUE(SameRuns(ascii, pieces.GetAsciiRuns())) << "size " << size;
+        EXPECT_TRUE(SameRuns(wide, pieces.GetWideRuns())) << "size " << size;
+    }
+}
+
+/**
+ * @brief Extracted strings carry their text, encoding and address
+ */
+TEST_F(DumpAnalyzerTest, ExtractsAsciiAndWideStrings) {
+    std::vector<uint8_t> data(128, 0xCC);
+    const std::string ascii = "kernel32.dll";
+    std::copy(ascii.begin(), ascii.end(), data.begin() + 10);
+    const std::string wide = "Hello";
+    for (size_t i = 0; i < wide.size(); ++i) {
+        data[40 + i * 2] = static_cast<uint8_t>(wide[i]);
+        data[40 + i * 2 + 1] = 0;
+    }
+
+    auto result = analyzer_->ExtractStrings(MakeDump(std::move(data), 0x2000));
+    ASSERT_TRUE(result.IsSuccess());
+    ASSERT_EQ(2u, result.Value().size());
+    EXPECT_EQ("kernel32.dll", result.Value()[0].value);
+    EXPECT_EQ("ASCII", result.Value()[0].encoding);
+    EXPECT_EQ(0x2000u + 10, result.Value()[0].address);
+    EXPECT_EQ("Hello", result.Value()[1].value);
+    EXPECT_EQ("Unicode", result.Value()[1].encoding);
+    EXPECT_TRUE(result.Value()[1].is_wide);
+    EXPECT_EQ(10u, result.Value()[1].length);
+}
+
+/**
+ * @brief Chunked parallel analysis reports exactly what the serial scan does
+ */
+TEST_F(DumpAnalyzerTest, ParallelAnalysisMatchesSerial) {
+    const std::vector<uint8_t> sig = {0x55, 0x8B, 0xEC, 0x83, 0xE4, 0xF8, 0x81, 0xEC, 0x34};
+    const auto wild = ByteSignature::Parse("48 89 5C 24 ?? 57 [1-8] 48 83 EC 20");
+    ASSERT_TRUE(wild.IsSuccess());
+
+    auto data = TextHeavyBytes(10 * 64 * 1024 + 777, 7);
+    Plant(data, 64 * 1024 - 4, sig);                     // Straddles the first chunk boundary
+    Plant(data, 3 * 64 * 1024 - 6, {0x48, 0x89, 0x5C, 0x24, 0x00, 0x57, 1, 2, 3, 0x48, 0x83, 0xEC, 0x20});
+    std::fill(data.begin() + 4 * 64 * 1024 - 10, data.begin() + 6 * 64 * 1024 + 3, 'x'); // Spans two chunks
+    const auto dump = MakeDump(std::move(data));
+
+    AnalysisConfig config;
+    config.worker_threads = 1;
+    config.chunk_size_kb = 64;
+
+    analyzer_->AddCustomPattern("sig", sig, "S");
+    analyzer_->AddCustomPattern("wild", wild.Value(), "W");
+    analyzer_->SetAnalysisConfig(config);
+    auto serial = analyzer_->PerformFullAnalysis(dump);
+
+    config.worker_threads = 4;
+    analyzer_->SetAnalysisConfig(config);
+    auto parallel = analyzer_->PerformFullAnalysis(dump);
+
+    ASSERT_TRUE(serial.IsSuccess());
+    ASSERT_TRUE(parallel.IsSuccess());
+    const auto& a = serial.Value();
+    const auto& b = parallel.Value();
+
+    ASSERT_EQ(2u, a.patterns.size());
+    ASSERT_EQ(a.patterns.size(), b.patterns.size());
+    for (size_t i = 0; i < a.patterns.size(); ++i) {
+        EXPECT_EQ(a.patterns[i].address, b.patterns[i].address);
+        EXPECT_EQ(a.patterns[i].size, b.patterns[i].size);
+        EXPECT_EQ(a.patterns[i].pattern_name, b.patterns[i].pattern_name);
+    }
+
+    ASSERT_EQ(a.strings.size(), b.strings.size());
+    for (size_t i = 0; i < a.strings.size(); ++i) {
+        EXPECT_EQ(a.strings[i].address, b.strings[i].address) << i;
+        EXPECT_EQ(a.strings[i].length, b.strings[i].length) << i;
+        EXPECT_EQ(a.strings[i].is_wide, b.strings[i].is_wide) << i;
+    }
+
+    EXPECT_EQ(a.metadata, b.metadata);
+}
+
+namespace {
+
+// Hands out the dump in short, odd-sized reads like a socket would
+class TricklingSource : public IDumpChunkSource {
+public:
+    explicit TricklingSource(const MemoryDump& dump) : dump_(dump) {}
+
+    Result<size_t> Read(uint8_t* buffer, size_t capacity) override {
+        const size_t count = std::min({capacity, dump_.data.size() - position_, 777 + (position_ % 5000)});
+        std::copy(dump_.data.begin() + static_cast<std::ptrdiff_t>(position_),
+                  dump_.data.begin() + static_cast<std::ptrdiff_t>(position_ + count), buffer);
+        position_ += count;
+        return Result<size_t>::Success(count);
+    }
+    uintptr_t GetBaseAddress() const override { return dump_.base_address; }
+    std::string GetName() const override { return dump_.module_name; }
+
+private:
+    const MemoryDump& dump_;
+    size_t position_ = 0;
+};
+
+} // anonymous namespace
+
+/**
+ * @brief Streaming analysis reports the same matches, in the same order, as the in-memory scan
+ */
+TEST_F(DumpAnalyzerTest, StreamingMatchesFullAnalysis) {
+    const std::vector<uint8_t> sig = {0x55, 0x8B, 0xEC, 0x83, 0xE4, 0xF8, 0x81, 0xEC, 0x34};
+    const auto wild = ByteSignature::Parse("48 89 5C 24 ?? 57 [1-8] 48 83 EC 20");
+    ASSERT_TRUE(wild.IsSuccess());
+    analyzer_->AddCustomPattern("sig", sig, "S");
+    analyzer_->AddCustomPattern("wild", wild.Value(), "W");
+
+    AnalysisConfig config;
+    config.worker_threads = 1;
+    config.chunk_size_kb = 64;
+    analyzer_->SetAnalysisConfig(config);
+
+    auto data = TextHeavyBytes(5 * 64 * 1024 + 333, 11);
+    data[0] = 'M';
+    data[1] = 'Z';
+    for (size_t offset : {1000u, 70000u, 200000u, 262140u}) {
+        Plant(data, offset, sig);
+    }
+    Plant(data, 64 * 1024 - 3, {0x48, 0x89, 0x5C, 0x24, 0x00, 0x57, 1, 2, 3, 4, 5, 0x48, 0x83, 0xEC, 0x20});
+    std::fill(data.begin() + 100000, data.begin() + 250000, 'y'); // Longer than a chunk
+    const auto dump = MakeDump(std::move(data));
+
+    auto full = analyzer_->PerformFullAnalysis(dump);
+    ASSERT_TRUE(full.IsSuccess());
+
+    std::vector<PatternMatch> patterns;
+    std::vector<StringMatch> strings;
+    DumpAnalyzer::StreamCallbacks callbacks;
+    callbacks.on_pattern = [&](const PatternMatch& match) { patterns.push_back(match); };
+    callbacks.on_string = [&](const StringMatch& match) { strings.push_back(match); };
+
+    TricklingSource source(dump);
+    auto summary = analyzer_->AnalyzeStream(source, callbacks);
+    ASSERT_TRUE(summary.IsSuccess());
+    EXPECT_EQ(dump.data.size(), summary.Value().bytes_processed);
+    EXPECT_EQ(full.Value().metadata, summary.Value().metadata);
+
+    const auto& expected_patterns = full.Value().patterns;
+    ASSERT_EQ(4u, expected_patterns.size()); // 200000 lies inside the 'y' run
+    ASSERT_EQ(expected_patterns.size(), patterns.size());
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        EXPECT_EQ(expected_patterns[i].address, patterns[i].address);
+        EXPECT_EQ(expected_patterns[i].pattern_name, patterns[i].pattern_name);
+    }
+
+    const auto& expected_strings = full.Value().strings;
+    ASSERT_EQ(expected_strings.size(), strings.size());
+    for (size_t i = 0; i < strings.size(); ++i) {
+        EXPECT_EQ(expected_strings[i].address, strings[i].address) << i;
+        EXPECT_EQ(expected_strings[i].value, strings[i].value) << i;
+        EXPECT_EQ(expected_strings[i].is_wide, strings[i].is_wide) << i;
+    }
+}
+
+/**
+ * @brief Regions written to a dump file map back with their index and are analyzed in place
+ */
+TEST_F(DumpAnalyzerTest, AnalyzesMappedDumpFile) {
+    const std::string path = "dump_analyzer_test.mcpdump";
+    const std::vector<uint8_t> sig = {0x55, 0x8B, 0xEC, 0x83, 0xE4, 0xF8, 0x81, 0xEC, 0x34};
+    analyzer_->AddCustomPattern("sig", sig, "S");
+
+    auto code = RandomBytes(10000, 5);
+    Plant(code, 4321, sig);
+    const auto first = MakeDump(RandomBytes(5000, 4), 0x10000);
+    const auto second = MakeDump(std::move(code), 0x7FF000000000);
+
+    DumpFileWriter writer;
+    writer.AddRegion(MemoryView::Of(first), 0x04);
+    writer.AddRegion(MemoryView::Of(second), 0x20);
+    ASSERT_TRUE(writer.Write(path).IsSuccess());
+
+    MemoryView view;
+    {
+        auto file = MappedDumpFile::Open(path);
+        ASSERT_TRUE(file.IsSuccess()) << file.Error();
+        const auto& regions = file.Value()->GetRegions();
+        ASSERT_EQ(2u, regions.size());
+        EXPECT_EQ(0x10000u, regions[0].base_address);
+        EXPECT_EQ(5000u, regions[0].size);
+        EXPECT_EQ(0x20u, regions[1].protection);
+        EXPECT_EQ("test.bin", regions[1].module_name);
+        EXPECT_FALSE(file.Value()->FindRegion(0x10000 + 5000).IsSuccess());
+
+        auto region = file.Value()->FindRegion(0x7FF000000000 + 9999);
+        ASSERT_TRUE(region.IsSuccess());
+        view = region.Value();
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(view.data) % 4096); // Page-aligned payload
+    }
+
+    // The view keeps the mapping alive after the file object is gone
+    ASSERT_TRUE(std::equal(view.begin(), view.end(), second.data.begin(), second.data.end()));
+    auto analysis = analyzer_->PerformFullAnalysis(view);
+    ASSERT_TRUE(analysis.IsSuccess());
+    ASSERT_EQ(2u, analysis.Value().patterns.size());
+    EXPECT_EQ("sig", analysis.Value().patterns[1].pattern_name);
+    EXPECT_EQ(second.base_address + 4321, analysis.Value().patterns[1].address);
+
+    view = MemoryView();
+    std::remove(path.c_str());
+
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << std::string(200, 'x');
+    }
+    EXPECT_FALSE(MappedDumpFile::Open(path).IsSuccess());
+    std::remove(path.c_str());
+}
+
+/**
+ * @brief Shared views keep their dump alive and moved-out results are not copied
+ */
+TEST(MemoryViewTest, SharesOwnershipAndMovesOutOfResult) {
+    auto result = Result<MemoryDump>::Success(MakeDump(RandomBytes(4096, 9), 0x5000));
+    const uint8_t* payload = result.Value().data.data();
+
+    MemoryView view = MemoryView::Share(std::make_shared<const MemoryDump>(result.TakeValue()));
+    EXPECT_EQ(payload, view.data); // Buffer moved through Result and into the view
+    EXPECT_EQ(4096u, view.size);
+    EXPECT_EQ(0x5000u, view.base_address);
+
+    const MemoryView tail = view.Subview(4000, 1000);
+    view = MemoryView();
+    EXPECT_EQ(96u, tail.size);
+    EXPECT_EQ(0x5000u + 4000, tail.base_address);
+    EXPECT_EQ(payload + 4000, tail.data);
+
+    DumpAnalyzer analyzer(nullptr);
+    IDumpAnalyzer& base = analyzer;
+    auto metadata = base.ExtractMetadata(tail);
+    ASSERT_TRUE(metadata.IsSuccess());
+    EXPECT_EQ("96", metadata.Value().at("size"));
+}
+
+/**
+ * @brief Incremental entropy windows agree with a direct computation and flag random regions
+ */
+TEST(EntropyMapTest, MatchesDirectComputation) {
+    std::vector<uint8_t> data = TextHeavyBytes(40000, 21);
+    const auto noise = RandomBytes(12288, 22);
+    Plant(data, 16384, noise);
+
+    EntropyMap whole(4096, 512, 7.2);
+    whole.Feed(data.data(), data.size());
+    whole.Finish();
+
+    EntropyMap pieces(4096, 512, 7.2);
+    for (size_t offset = 0; offset < data.size(); offset += 777) {
+        pieces.Feed(data.data() + offset, std::min<size_t>(777, data.size() - offset));
+    }
+    pieces.Finish();
+
+    const auto& profile = whole.GetProfile();
+    ASSERT_EQ((data.size() - 4096) / 512 + 1, profile.values.size());
+    EXPECT_EQ(profile.values, pieces.GetProfile().values);
+    for (size_t i = 0; i < profile.values.size(); ++i) {
+        std::array<size_t, 256> counts{};
+        for (size_t j = i * 512; j < i * 512 + 4096; ++j) {
+            counts[data[j]]++;
+        }
+        double expected = 0.0;
+        for (size_t count : counts) {
+            if (count != 0) {
+                const double p = count / 4096.0;
+                expected -= p * std::log2(p);
+            }
+        }
+        EXPECT_NEAR(expected, profile.EntropyAt(i), 0.5 / EntropyProfile::kScale) << i;
+    }
+
+    // Only windows that mostly cover the noise clear the threshold
+    ASSERT_EQ(1u, whole.GetRegions().size());
+    EXPECT_GT(whole.GetRegions()[0].offset, 16384u - 4096);
+    EXPECT_LT(whole.GetRegions()[0].offset + whole.GetRegions()[0].length, 16384u + 12288 + 4096);
+    EXPECT_GT(whole.GetRegions()[0].peak_entropy, 7.8);
+}
+
+namespace {
+
+template<typename T>
+void Put(std::vector<uint8_t>& data, size_t offset, T value) {
+    std::memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+void PutString(std::vector<uint8_t>& data, size_t offset, const std::string& text) {
+    std::copy(text.begin(), text.end(), data.begin() + static_cast<std::ptrdiff_t>(offset));
+}
+
+// PE32+ image with .text/.rdata, one import module (named + ordinal) and two exports
+std::vector<uint8_t> MinimalPeImage() {
+    std::vector<uint8_t> image(0x3000, 0);
+    PutString(image, 0, "MZ");
+    Put<uint32_t>(image, 0x3C, 0x80);
+    PutString(image, 0x80, std::string("PE\0\0", 4));
+    Put<uint16_t>(image, 0x84, 0x8664);
+    Put<uint16_t>(image, 0x86, 2);
+    Put<uint16_t>(image, 0x94, 0xF0);
+
+    const size_t opt = 0x98;
+    Put<uint16_t>(image, opt, 0x20B);
+    Put<uint32_t>(image, opt + 16, 0x1010);
+    Put<uint64_t>(image, opt + 24, 0x140000000ull);
+    Put<uint32_t>(image, opt + 56, 0x3000);
+    Put<uint32_t>(image, opt + 108, 16);
+    Put<uint32_t>(image, opt + 112, 0x2000); // Export directory
+    Put<uint32_t>(image, opt + 116, 40);
+    Put<uint32_t>(image, opt + 120, 0x2100); // Import directory
+    Put<uint32_t>(image, opt + 124, 40);
+
+    const size_t sections = opt + 0xF0;
+    PutString(image, sections, ".text");
+    Put<uint32_t>(image, sections + 8, 0x1000);
+    Put<uint32_t>(image, sections + 12, 0x1000);
+    PutString(image, sections + 40, ".rdata");
+    Put<uint32_t>(image, sections + 48, 0x1000);
+    Put<uint32_t>(image, sections + 52, 0x2000);
+
+    Put<uint32_t>(image, 0x2000 + 12, 0x2080);
+    Put<uint32_t>(image, 0x2000 + 16, 1);      // Ordinal base
+    Put<uint32_t>(image, 0x2000 + 20, 2);
+    Put<uint32_t>(image, 0x2000 + 24, 1);
+    Put<uint32_t>(image, 0x2000 + 28, 0x2040);
+    Put<uint32_t>(image, 0x2000 + 32, 0x2050);
+    Put<uint32_t>(image, 0x2000 + 36, 0x2060);
+    Put<uint32_t>(image, 0x2040, 0x1010);
+    Put<uint32_t>(image, 0x2044, 0x1020);
+    Put<uint32_t>(image, 0x2050, 0x2090);
+    Put<uint16_t>(image, 0x2060, 1);
+    PutString(image, 0x2080, "test.dll");
+    PutString(image, 0x2090, "Run");
+
+    Put<uint32_t>(image, 0x2100, 0x2140);
+    Put<uint32_t>(image, 0x2100 + 12, 0x2180);
+    Put<uint32_t>(image, 0x2100 + 16, 0x2160);
+    Put<uint64_t>(image, 0x2140, 0x21A0);
+    Put<uint64_t>(image, 0x2148, (1ull << 63) | 0x10);
+    PutString(image, 0x2180, "kernel32.dll");
+    Put<uint16_t>(image, 0x21A0, 5);
+    PutString(image, 0x21A2, "ExitProcess");
+    return image;
+}
+
+// ELF64 executable with a symbol table holding one defined and one undefined symbol
+std::vector<uint8_t> MinimalElf() {
+    std::vector<uint8_t> elf(0x400, 0);
+    PutString(elf, 0, "\x7f" "ELF");
+    elf[4] = 2;
+    elf[5] = 1;
+    elf[6] = 1;
+    Put<uint16_t>(elf, 16, 2);
+    Put<uint16_t>(elf, 18, 0x3E);
+    Put<uint64_t>(elf, 24, 0x401000);
+    Put<uint64_t>(elf, 40, 0x100);
+    Put<uint16_t>(elf, 58, 64);
+    Put<uint16_t>(elf, 60, 4);
+    Put<uint16_t>(elf, 62, 1);
+
+    const std::string names("\0.shstrtab\0.symtab\0.strtab\0", 27);
+    const std::string symbols("\0main\0puts\0", 11);
+    PutString(elf, 0x200, names);
+    PutString(elf, 0x300, symbols);
+
+    auto section = [&](size_t index, uint32_t name, uint32_t type, uint64_t offset, uint64_t size, uint32_t link) {
+        const size_t at = 0x100 + index * 64;
+        Put<uint32_t>(elf, at, name);
+        Put<uint32_t>(elf, at + 4, type);
+        Put<uint64_t>(elf, at + 24, offset);
+        Put<uint64_t>(elf, at + 32, size);
+        Put<uint32_t>(elf, at + 40, link);
+    };
+    section(1, 1, 3, 0x200, names.size(), 0);
+    section(2, 11, ElfView::kSymbolTable, 0x280, 3 * 24, 3);
+    section(3, 19, 3, 0x300, symbols.size(), 0);
+
+    Put<uint32_t>(elf, 0x280 + 24, 1);       // main
+    Put<uint16_t>(elf, 0x280 + 24 + 6, 1);
+    Put<uint64_t>(elf, 0x280 + 24 + 8, 0x401000);
+    Put<uint32_t>(elf, 0x280 + 48, 6);       // puts, undefined
+    return elf;
+}
+
+} // anonymous namespace
+
+/**
+ * @brief PE and ELF tables are parsed in place and cached per module and base
+ */
+TEST_F(DumpAnalyzerTest, ParsesBinaryHeadersAndCachesModuleInfo) {
+    const auto pe_dump = MakeDump(MinimalPeImage(), 0x140000000);
+    auto pe = PeView::Parse(MemoryView::Of(pe_dump));
+    ASSERT_TRUE(pe.IsSuccess()) << pe.Error();
+    EXPECT_TRUE(pe.Value().Is64());
+    EXPECT_EQ(0x140000000ull, pe.Value().GetImageBase());
+    ASSERT_EQ(2u, pe.Value().GetSectionCount());
+    EXPECT_EQ(".rdata", pe.Value().GetSection(1).name);
+
+    auto info = analyzer_->GetModuleInfo(MemoryView::Of(pe_dump));
+    ASSERT_TRUE(info.IsSuccess()) << info.Error();
+    const auto& imports = info.Value()->imports;
+    ASSERT_EQ(2u, imports.size());
+    EXPECT_EQ("kernel32.dll", imports[0].module);
+    EXPECT_EQ("ExitProcess", imports[0].name);
+    EXPECT_EQ(0x2160u, imports[0].address);
+    EXPECT_EQ(0x10u, imports[1].ordinal);
+    EXPECT_EQ(0x2168u, imports[1].address);
+    const auto& exports = info.Value()->exports;
+    ASSERT_EQ(2u, exports.size());
+    EXPECT_EQ("Run", exports[0].name);
+    EXPECT_EQ(2u, exports[0].ordinal);
+    EXPECT_EQ(0x1020u, exports[0].address);
+    EXPECT_EQ(1u, exports[1].ordinal);
+
+    // Same module and contents hit the cache; ExtractMetadata goes through it too
+    EXPECT_EQ(info.Value().get(), analyzer_->GetModuleInfo(MemoryView::Of(pe_dump)).Value().get());
+    auto metadata = analyzer_->ExtractMetadata(pe_dump);
+    ASSERT_TRUE(metadata.IsSuccess());
+    EXPECT_EQ("PE32+", metadata.Value().at("pe_type"));
+    EXPECT_EQ("0x8664", metadata.Value().at("pe_machine"));
+    EXPECT_EQ("0x1010", metadata.Value().at("pe_entry_point"));
+    EXPECT_EQ("2", metadata.Value().at("pe_imports"));
+    analyzer_->ClearModuleCache();
+    EXPECT_NE(info.Value().get(), analyzer_->GetModuleInfo(MemoryView::Of(pe_dump)).Value().get());
+
+    // Truncated tables are skipped, not read past the end
+    const MemoryView headers = MemoryView::Of(pe_dump).Subview(0, 0x2000);
+    auto partial = BinaryModuleInfo::Build(headers);
+    ASSERT_TRUE(partial.IsSuccess());
+    EXPECT_TRUE(partial.Value().imports.empty());
+    EXPECT_TRUE(partial.Value().exports.empty());
+
+    const auto elf_dump = MakeDump(MinimalElf(), 0x400000);
+    auto elf = analyzer_->GetModuleInfo(MemoryView::Of(elf_dump));
+    ASSERT_TRUE(elf.IsSuccess()) << elf.Error();
+    EXPECT_EQ("ELF", elf.Value()->format);
+    EXPECT_EQ(0x3Eu, elf.Value()->machine);
+    EXPECT_EQ(0x401000u, elf.Value()->entry_point);
+    ASSERT_EQ(4u, elf.Value()->sections.size());
+    EXPECT_EQ(".symtab", elf.Value()->sections[2].name);
+    ASSERT_EQ(1u, elf.Value()->exports.size());
+    EXPECT_EQ("main", elf.Value()->exports[0].name);
+    ASSERT_EQ(1u, elf.Value()->imports.size());
+    EXPECT_EQ("puts", elf.Value()->imports[0].name);
+}
+
+/**
+ * @brief Re-analysis of a changed snapshot rescans only dirty pages and matches a full analysis
+ */
+TEST_F(DumpAnalyzerTest, IncrementalAnalysisMatchesFullAnalysis) {
+    const std::vector<uint8_t> sig = {0x55, 0x8B, 0xEC, 0x83, 0xE4, 0xF8, 0x81, 0xEC, 0x34};
+    analyzer_->AddCustomPattern("sig", sig, "S");
+
+    auto data = TextHeavyBytes(64 * 4096, 31);
+    Plant(data, 40000, RandomBytes(12288, 32));
+    Plant(data, 100000, sig);
+    std::fill(data.begin() + 150000, data.begin() + 170000, 'y');
+    auto dump = MakeDump(data);
+
+    auto first = analyzer_->AnalyzeIncremental(MemoryView::Of(dump));
+    ASSERT_TRUE(first.IsSuccess());
+    EXPECT_TRUE(first.Value().full_rescan);
+
+    Plant(dump.data, 20 * 4096 - 4, sig);                  // Straddles pages 19 and 20
+    dump.data[160000] = 0;                                 // Splits the long string
+    std::fill(dump.data.begin() + 10 * 4096, dump.data.begin() + 11 * 4096, 0); // Cuts the noise
+
+    auto second = analyzer_->AnalyzeIncremental(MemoryView::Of(dump));
+    ASSERT_TRUE(second.IsSuccess());
+    const auto& diff = second.Value();
+    EXPECT_FALSE(diff.full_rescan);
+    EXPECT_EQ(64u, diff.pages_total);
+    EXPECT_EQ(4u, diff.pages_changed);
+    EXPECT_LT(diff.bytes_rescanned, dump.size / 2);
+    ASSERT_EQ(3u, diff.changed_ranges.size());
+    EXPECT_EQ(dump.base_address + 19 * 4096, diff.changed_ranges[1].first);
+    EXPECT_EQ(2u * 4096, diff.changed_ranges[1].second);
+
+    auto full = analyzer_->PerformFullAnalysis(dump);
+    ASSERT_TRUE(full.IsSuccess());
+    const auto& expected = full.Value();
+    ASSERT_EQ(expected.patterns.size(), diff.result.patterns.size());
+    for (size_t i = 0; i < expected.patterns.size(); ++i) {
+        EXPECT_EQ(expected.patterns[i].pattern_name, diff.result.patterns[i].pattern_name) << i;
+        EXPECT_EQ(expected.patterns[i].address, diff.result.patterns[i].address) << i;
+        EXPECT_EQ(expected.patterns[i].size, diff.result.patterns[i].size) << i;
+    }
+    ASSERT_EQ(expected.strings.size(), diff.result.strings.size());
+    for (size_t i = 0; i < expected.strings.size(); ++i) {
+        EXPECT_EQ(expected.strings[i].address, diff.result.strings[i].address) << i;
+        EXPECT_EQ(expected.strings[i].value, diff.result.strings[i].value) << i;
+    }
+    ASSERT_EQ(expected.entropy.values.size(), diff.result.entropy.values.size());
+    for (size_t i = 0; i < expected.entropy.values.size(); ++i) {
+        EXPECT_NEAR(expected.entropy.values[i], diff.result.entropy.values[i], 1) << i;
+    }
+
+    auto is_new_sig = [&](const PatternMatch& match) {
+        return match.pattern_name == "sig" && match.address == dump.base_address + 20 * 4096 - 4;
+    };
+    EXPECT_EQ(1, std::count_if(diff.added_patterns.begin(), diff.added_patterns.end(), is_new_sig));
+    EXPECT_TRUE(std::any_of(diff.removed_patterns.begin(), diff.removed_patterns.end(), [](const PatternMatch& m) {
+        return m.pattern_name == "high_entropy_region";
+    }));
+    ASSERT_FALSE(diff.removed_strings.empty());
+    EXPECT_TRUE(std::any_of(diff.removed_strings.begin(), diff.removed_strings.end(), [&](const StringMatch& s) {
+        return s.value.size() >= 170000 - 150000;
+    }));
+    EXPECT_EQ(2, std::count_if(diff.added_strings.begin(), diff.added_strings.end(), [&](const StringMatch& s) {
+        return s.value.find("yyyyyyyy") != std::string::npos;
+    }));
+
+    // Unchanged snapshot: nothing is rescanned
+    auto third = analyzer_->AnalyzeIncremental(MemoryView::Of(dump));
+    ASSERT_TRUE(third.IsSuccess());
+    EXPECT_EQ(0u, third.Value().pages_changed);
+    EXPECT_EQ(0u, third.Value().bytes_rescanned);
+    EXPECT_TRUE(third.Value().added_patterns.empty());
+    EXPECT_TRUE(third.Value().removed_strings.empty());
+    EXPECT_EQ(diff.result.strings.size(), third.Value().result.strings.size());
+}
@@ -0,0 +1,748 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include "../src/core/task_executor.hpp"
+#include "../src/llm/http_client_pool.hpp"
+#include "../src/llm/prompt_builder.hpp"
+#include "../src/llm/llm_engine.hpp"
+#include "../src/llm/rate_limiter.hpp"
+#include "../src/llm/request_scheduler.hpp"
+#include "../src/llm/response_cache.hpp"
+#include "../src/llm/sse_parser.hpp"
+
+using namespace mcp;
+
+TEST(HttpClientPoolTest, ReusesKeepAliveClientsPerHost) {
+    HttpPoolOptions options;
+    options.max_connections = 2;
+    options.acquire_timeout = std::chrono::milliseconds(50);
+    HttpClientPool pool(options);
+
+    {
+        auto first = pool.Acquire("api.example.com");
+        auto second = pool.Acquire("api.example.com");
+        ASSERT_TRUE(first.IsSuccess()) << first.Error();
+        ASSERT_TRUE(second.IsSuccess()) << second.Error();
+        EXPECT_EQ(2u, pool.GetStats().leased);
+
+        // The host is full; another host is not
+        EXPECT_FALSE(pool.Acquire("api.example.com").IsSuccess());
+        EXPECT_TRUE(pool.Acquire("other.example.com").IsSuccess());
+    }
+    auto stats = pool.GetStats();
+    EXPECT_EQ(3u, stats.created);
+    EXPECT_EQ(3u, stats.idle);
+    EXPECT_EQ(0u, stats.leased);
+
+    {
+        auto lease_result = pool.Acquire("api.example.com");
+        ASSERT_TRUE(lease_result.IsSuccess());
+        HttpClientPool::Lease lease = lease_result.TakeValue();
+        EXPECT_TRUE(static_cast<bool>(lease));
+        lease.Discard();  // As after a broken connection
+    }
+    stats = pool.GetStats();
+    EXPECT_EQ(1u, stats.reused);
+    EXPECT_EQ(1u, stats.discarded);
+    EXPECT_EQ(2u, stats.idle);
+
+    // A waiter gets the slot as soon as a lease is returned
+    HttpPoolOptions single = options;
+    single.max_connections = 1;
+    single.acquire_timeout = std::chrono::seconds(5);
+    pool.SetHostOptions("slow.example.com", single);
+    auto held = pool.Acquire("slow.example.com");
+    ASSERT_TRUE(held.IsSuccess());
+    std::thread releaser([&held]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        held = Result<HttpClientPool::Lease>::Error("released");
+    });
+    EXPECT_TRUE(pool.Acquire("slow.example.com").IsSuccess());
+    releaser.join();
+
+    // Idle clients past the keep-alive window are closed rather than reused
+    HttpPoolOptions short_lived = options;
+    short_lived.idle_timeout = std::chrono::milliseconds(0);
+    pool.SetHostOptions("api.example.com", short_lived);
+    const uint64_t created = pool.GetStats().created;
+    EXPECT_TRUE(pool.Acquire("api.example.com").IsSuccess());
+    stats = pool.GetStats();
+    EXPECT_EQ(created + 1, stats.created);
+    EXPECT_EQ(1u, stats.expired);
+}
+
+namespace {
+
+// Holds tasks until released, recording the order they started in
+class Gate {
+public:
+    LLMRequestScheduler::Task Task(const std::string& name) {
+        return [this, name]() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            started_.push_back(name);
+            changed_.notify_all();
+            changed_.wait(lock, [this]() { return open_; });
+            LLMResponse response;
+            response.content = name;
+            return Result<LLMResponse>::Success(response);
+        };
+    }
+
+    void Open() {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        open_ = true;
+        changed_.notify_all();
+    }
+
+    bool WaitForStarted(size_t count) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return changed_.wait_for(lock, std::chrono::seconds(5), [&]() { return started_.size() >= count; });
+    }
+
+    std::vector<std::string> Started() {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        return started_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::vector<std::string> started_;
+    bool open_ = false;
+};
+
+} // namespace
+
+TEST(LLMRequestSchedulerTest, CapsProvidersAndRunsByPriority) {
+    RequestSchedulerOptions options;
+    options.worker_threads = 3;
+    options.max_concurrent_per_provider = 1;
+    options.max_queued = 4;
+    LLMRequestScheduler scheduler(options);
+    Gate gate;
+
+    // One claude request runs; the second waits for the cap even with idle workers
+    auto first = scheduler.Submit("claude", 0, CancellationToken(), gate.Task("claude-1"));
+    ASSERT_TRUE(gate.WaitForStarted(1));
+    auto low = scheduler.Submit("claude", 0, CancellationToken(), gate.Task("claude-low"));
+    auto high = scheduler.Submit("claude", 5, CancellationToken(), gate.Task("claude-high"));
+    CancellationToken dropped;
+    auto cancelled = scheduler.Submit("claude", 9, dropped, gate.Task("claude-cancelled"));
+    auto other = scheduler.Submit("openai", 0, CancellationToken(), gate.Task("openai-1"));
+    ASSERT_TRUE(gate.WaitForStarted(2));
+    EXPECT_EQ("openai-1", gate.Started()[1]);
+    EXPECT_EQ(3u, scheduler.GetQueuedCount());
+    EXPECT_EQ(2u, scheduler.GetRunningCount());
+
+    dropped.Cancel();
+    auto cancelled_result = cancelled.get();
+    ASSERT_FALSE(cancelled_result.IsSuccess());
+    EXPECT_EQ("Request cancelled", cancelled_result.Error());
+
+    // Backpressure: with every worker busy the queue holds four requests at most
+    std::vector<std::future<Result<LLMResponse>>> filler;
+    for (int i = 0; i < 2; ++i) {
+        filler.push_back(scheduler.Submit("gemini", 0, CancellationToken(), gate.Task("gemini")));
+    }
+    ASSERT_TRUE(gate.WaitForStarted(3));
+    filler.push_back(scheduler.Submit("gemini", 0, CancellationToken(), gate.Task("gemini")));
+    EXPECT_EQ(4u, scheduler.GetQueuedCount());
+    auto rejected = scheduler.Submit("gemini", 0, CancellationToken(), gate.Task("gemini"));
+    EXPECT_FALSE(rejected.get().IsSuccess());
+    EXPECT_EQ(1u, scheduler.GetStats().rejected);
+
+    gate.Open();
+    EXPECT_EQ("claude-1", first.get().Value().content);
+    EXPECT_EQ("claude-high", high.get().Value().content);
+    EXPECT_EQ("claude-low", low.get().Value().content);
+    EXPECT_EQ("openai-1", other.get().Value().content);
+    for (auto& future : filler) {
+        EXPECT_TRUE(future.get().IsSuccess());
+    }
+    const auto started = gate.Started();
+    const auto high_at = std::find(started.begin(), started.end(), "claude-high");
+    const auto low_at = std::find(started.begin(), started.end(), "claude-low");
+    EXPECT_LT(high_at, low_at);
+    EXPECT_EQ(started.end(), std::find(started.begin(), started.end(), "claude-cancelled"));
+
+    // Cancelling everything fails what is still queued
+    Gate blocked;
+    auto running = scheduler.Submit("claude", 0, CancellationToken(), blocked.Task("running"));
+    ASSERT_TRUE(blocked.WaitForStarted(1));
+    auto queued = scheduler.Submit("claude", 0, CancellationToken(), blocked.Task("queued"));
+    scheduler.CancelAll();
+    EXPECT_FALSE(queued.get().IsSuccess());
+    blocked.Open();
+    EXPECT_TRUE(running.get().IsSuccess());
+}
+
+namespace {
+
+// Answers "echo:<prompt>" once released, counting upstream calls
+class CountingProvider : public IAIProvider {
+public:
+    const std::string& GetName() const override { return name_; }
+    void SetAPIKey(const std::string&) override {}
+
+    std::future<Result<LLMResponse>> SendRequest(const LLMRequest& request) override {
+        return std::async(std::launch::async, [this, request]() { return SendRequestSync(request); });
+    }
+
+    Result<LLMResponse> SendRequestSync(const LLMRequest& request) override {
+        ++calls;
+        std::unique_lock<std::mutex> lock(mutex_);
+        released_.wait(lock, [this]() { return open_; });
+        LLMResponse response;
+        response.content = "echo:" + request.prompt;
+        response.provider = name_;
+        response.success = true;
+        return Result<LLMResponse>::Success(response);
+    }
+
+    void Release() {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        open_ = true;
+        released_.notify_all();
+    }
+
+    std::atomic<int> calls{0};
+
+private:
+    std::string name_ = "counting";
+    std::mutex mutex_;
+    std::condition_variable released_;
+    bool open_ = false;
+};
+
+// Stands in for SecurityManager so the disk tier can be checked without real keys
+class XorSecurity : public ISecurityManager {
+public:
+    Result<void> StoreCredential(const std::string&, const std::string&) override { return Result<void>::Success(); }
+    Result<std::string> RetrieveCredential(const std::string&) override { return Result<std::string>::Error("none"); }
+    Result<void> EncryptData(const std::vector<uint8_t>& data, std::vector<uint8_t>& encrypted) override {
+        encrypted = data;
+        for (auto& byte : encrypted) byte ^= 0x5A;
+        return Result<void>::Success();
+    }
+    Result<void> DecryptData(const std::vector<uint8_t>& encrypted, std::vector<uint8_t>& data) override {
+        return EncryptData(encrypted, data);
+    }
+    bool ValidateAPIKey(const std::string&) const override { return true; }
+};
+
+// Streams its prompt back one word at a time
+class WordStreamProvider : public IAIProvider {
+public:
+    const std::string& GetName() const override { return name_; }
+    void SetAPIKey(const std::string&) override {}
+
+    std::future<Result<LLMResponse>> SendRequest(const LLMRequest& request) override {
+        return std::async(std::launch::async, [this, request]() {
+            return SendRequestStreaming(request, [](const std::string&) { return true; });
+        });
+    }
+
+    Result<LLMResponse> SendRequestStreaming(const LLMRequest& request, const LLMStreamCallback& on_chunk) override {
+        ++streams;
+        LLMResponse response;
+        response.provider = name_;
+        response.success = true;
+        size_t start = 0;
+        while (start < request.prompt.size()) {
+            const size_t end = std::min(request.prompt.find(' ', start), request.prompt.size() - 1) + 1;
+            const std::string word = request.prompt.substr(start, end - start);
+            response.content += word;
+            if (!on_chunk(word)) {
+                break;
+            }
+            start = end;
+        }
+        return Result<LLMResponse>::Success(response);
+    }
+
+    std::atomic<int> streams{0};
+
+private:
+    std::string name_ = "words";
+};
+
+// Fails with a fixed error, or answers with its own name
+class ScriptedProvider : public IAIProvider {
+public:
+    ScriptedProvider(std::string name, std::string error) : name_(std::move(name)), error_(std::move(error)) {}
+
+    const std::string& GetName() const override { return name_; }
+    void SetAPIKey(const std::string&) override {}
+
+    std::future<Result<LLMResponse>> SendRequest(const LLMRequest& request) override {
+        return std::async(std::launch::async, [this, request]() { return SendRequestSync(request); });
+    }
+
+    Result<LLMResponse> SendRequestSync(const LLMRequest&) override {
+        ++calls;
+        if (!error_.empty()) {
+            return Result<LLMResponse>::Error(error_);
+        }
+        LLMResponse response;
+        response.content = "from:" + name_;
+        response.provider = name_;
+        response.success = true;
+        return Result<LLMResponse>::Success(response);
+    }
+
+    std::atomic<int> calls{0};
+
+private:
+    std::string name_;
+    std::string error_;
+};
+
+} // namespace
+
+TEST(LLMResponseCacheTest, DeduplicatesAndServesRepeatedRequests) {
+    LLMEngine engine(nullptr);
+    auto provider = std::make_shared<CountingProvider>();
+    engine.RegisterProvider(provider);
+
+    LLMRequest request;
+    request.provider = "counting";
+    request.prompt = "explain 0x401000";
+    request.context = {"push ebp", "mov ebp, esp"};
+
+    // Three identical requests while the first is upstream: one call
+    std::vector<std::future<Result<LLMResponse>>> futures;
+    for (int i = 0; i < 3; ++i) {
+        futures.push_back(engine.SendRequest(request));
+    }
+    provider->Release();
+    for (auto& future : futures) {
+        auto result = future.get();
+        ASSERT_TRUE(result.IsSuccess()) << result.Error();
+        EXPECT_EQ("echo:explain 0x401000", result.Value().content);
+    }
+    EXPECT_EQ(1, provider->calls.load());
+
+    ASSERT_TRUE(engine.SendRequestSync(request).IsSuccess());
+    EXPECT_EQ(1, provider->calls.load());
+
+    // Anything that shapes the answer is part of the key
+    LLMRequest warmer = request;
+    warmer.temperature = 0.9;
+    LLMRequest more_context = request;
+    more_context.context.push_back("sub esp, 0x10");
+    EXPECT_NE(LLMResponseCache::KeyFor("counting", request), LLMResponseCache::KeyFor("counting", warmer));
+    EXPECT_NE(LLMResponseCache::KeyFor("counting", request), LLMResponseCache::KeyFor("counting", more_context));
+    EXPECT_NE(LLMResponseCache::KeyFor("counting", request), LLMResponseCache::KeyFor("claude", request));
+    ASSERT_TRUE(engine.SendRequestSync(warmer).IsSuccess());
+    EXPECT_EQ(2, provider->calls.load());
+
+    const auto stats = engine.GetResponseCache()->GetStats();
+    EXPECT_EQ(2u, stats.deduplicated);
+    EXPECT_EQ(1u, stats.memory_hits);
+
+    engine.SetResponseCache(nullptr);
+    ASSERT_TRUE(engine.SendRequestSync(request).IsSuccess());
+    EXPECT_EQ(3, provider->calls.load());
+}
+
+/**
+ * @brief Test AnalyzeAsync continuations are posted by the completing worker, not polled for
+ */
+TEST(LLMEngineAsyncTest, ContinuesAnalysisWithoutPolling) {
+    LLMEngine engine(nullptr);
+    auto provider = std::make_shared<CountingProvider>();
+    engine.RegisterProvider(provider);
+    TaskExecutorOptions options;
+    options.worker_threads = 2;
+    auto executor = std::make_shared<TaskExecutor>(options);
+
+    LLMRequest request;
+    request.provider = "counting";
+    request.prompt = "explain 0x402000";
+
+    // The second request joins the first in flight; both continue from one completion
+    std::mutex mutex;
+    std::condition_variable done;
+    std::vector<std::string> answers;
+    const auto record = [&](std::future<Result<LLMResponse>> future) {
+        auto result = future.get();
+        const std::lock_guard<std::mutex> lock(mutex);
+        answers.push_back(result.IsSuccess() ? result.Value().content : result.Error());
+        done.notify_all();
+    };
+    ASSERT_TRUE(Then(std::shared_ptr<ITaskExecutor>(executor), engine.AnalyzeAsync(request), record));
+    ASSERT_TRUE(Then(std::shared_ptr<ITaskExecutor>(executor), engine.AnalyzeAsync(request), record));
+    provider->Release();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(done.wait_for(lock, std::chrono::seconds(5), [&answers]() { return answers.size() == 2; }));
+    }
+    EXPECT_EQ(std::vector<std::string>(2, "echo:explain 0x402000"), answers);
+    EXPECT_EQ(1, provider->calls.load());
+
+    // Cache hits are already complete and continue at once
+    ASSERT_TRUE(Then(std::shared_ptr<ITaskExecutor>(executor), engine.AnalyzeAsync(request), record));
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(done.wait_for(lock, std::chrono::seconds(5), [&answers]() { return answers.size() == 3; }));
+    }
+    const auto stats = executor->GetStats();
+    EXPECT_EQ(0u, stats.continuations);
+    EXPECT_EQ(0u, stats.watching);
+    executor->Shutdown();
+}
+
+TEST(LLMResponseCacheTest, PersistsEncryptedResponsesOnDisk) {
+    const auto directory = std::filesystem::temp_directory_path() / "mcp_llm_cache_test";
+    std::filesystem::remove_all(directory);
+    auto security = std::make_shared<XorSecurity>();
+
+    ResponseCacheOptions options;
+    options.disk_directory = directory.string();
+    LLMRequest request;
+    request.prompt = "what does this decryptor do";
+    const std::string key = LLMResponseCache::KeyFor("claude", request);
+    EXPECT_EQ(32u, key.size());
+    {
+        LLMResponseCache cache(options, security);
+        ASSERT_TRUE(cache.HasDiskTier());
+        LLMResponse response;
+        response.content = "It XORs the payload with a rolling key";
+        response.provider = "claude";
+        cache.Put(key, response);
+    }
+
+    // Nothing readable on disk
+    size_t files = 0;
+    for (const auto& file : std::filesystem::directory_iterator(directory)) {
+        ++files;
+        std::ifstream in(file.path(), std::ios::binary);
+        const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        EXPECT_EQ(std::string::npos, bytes.find("rolling key"));
+    }
+    EXPECT_EQ(1u, files);
+
+    // A fresh session finds it; without a security manager there is no disk tier
+    LLMResponseCache next_session(options, security);
+    auto hit = next_session.Get(key);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ("It XORs the payload with a rolling key", hit->content);
+    EXPECT_EQ(1u, next_session.GetStats().disk_hits);
+    EXPECT_FALSE(LLMResponseCache(options, nullptr).HasDiskTier());
+
+    std::filesystem::remove_all(directory);
+}
+
+// A key that no longer opens what earlier sessions wrote
+class RejectingSecurity : public XorSecurity {
+public:
+    Result<void> DecryptData(const std::vector<uint8_t>&, std::vector<uint8_t>&) override {
+        return Result<void>::Error("authentication failed");
+    }
+};
+
+/**
+ * @brief Test unreadable files are deleted and the disk tier evicts its oldest files first
+ */
+TEST(LLMResponseCacheTest, DeletesUnreadableFilesAndBoundsDiskTier) {
+    const auto directory = std::filesystem::temp_directory_path() / "mcp_llm_cache_bound_test";
+    std::filesystem::remove_all(directory);
+    auto security = std::make_shared<XorSecurity>();
+
+    ResponseCacheOptions options;
+    options.disk_directory = directory.string();
+    std::vector<std::string> keys;
+    {
+        LLMResponseCache cache(options, security);
+        for (int i = 0; i < 5; ++i) {
+            LLMRequest request;
+            request.prompt = "prompt " + std::to_string(i);
+            keys.push_back(LLMResponseCache::KeyFor("claude", request));
+            LLMResponse response;
+            response.content = "answer " + std::to_string(i);
+            cache.Put(keys.back(), response);
+        }
+    }
+    const auto path_of = [&directory](const std::string& key) { return directory / (key + ".llmcache"); };
+
+    // Older files get older timestamps, so eviction order does not depend on clock resolution
+    const auto now = std::filesystem::file_time_type::clock::now();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        std::filesystem::last_write_time(path_of(keys[i]), now - std::chrono::hours(keys.size() - i));
+    }
+
+    // Room for three: trimming leaves the two newest
+    options.disk_max_bytes = 3 * std::filesystem::file_size(path_of(keys[0]));
+    {
+        LLMResponseCache bounded(options, security);
+        EXPECT_EQ(3u, bounded.GetStats().disk_evictions);
+        for (size_t i = 0; i < 3; ++i) {
+            EXPECT_FALSE(std::filesystem::exists(path_of(keys[i])));
+            EXPECT_FALSE(bounded.Get(keys[i]).has_value());
+        }
+        EXPECT_EQ("answer 4", bounded.Get(keys[4])->content);
+    }
+
+    // Under another key the newest file cannot be opened, so it is removed rather than retried
+    {
+        LLMResponseCache rekeyed(options, std::make_shared<RejectingSecurity>());
+        EXPECT_FALSE(rekeyed.Get(keys[3]).has_value());
+    }
+    EXPECT_FALSE(std::filesystem::exists(path_of(keys[3])));
+
+    // So is a file that decrypts to garbage
+    {
+        std::ofstream garbage(path_of(keys[0]), std::ios::binary);
+        garbage << "not a cache record";
+    }
+    EXPECT_FALSE(LLMResponseCache(options, security).Get(keys[0]).has_value());
+    EXPECT_FALSE(std::filesystem::exists(path_of(keys[0])));
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST(SseParserTest, ParsesEventsSplitAcrossChunks) {
+    const std::string stream =
+        ": keep-alive\r\n"
+        "event: content_block_delta\r\n"
+        "data: {\"text\":\"Hel\"}\r\n"
+        "\r\n"
+        "data:first\n"
+        "data: second\n"
+        "id: 7\n"
+        "\n"
+        "event: ignored-without-data\n"
+        "\n"
+        "data: [DONE]";
+
+    // Every split point must give the same events, including inside a CRLF
+    for (size_t split = 0; split <= stream.size(); ++split) {
+        SseParser parser;
+        std::vector<SseEvent> events;
+        const auto collect = [&events](const SseEvent& event) {
+            events.push_back(event);
+            return true;
+        };
+        EXPECT_TRUE(parser.Feed(stream.data(), split, collect));
+        EXPECT_TRUE(parser.Feed(stream.data() + split, stream.size() - split, collect));
+        EXPECT_TRUE(parser.Finish(collect));
+
+        ASSERT_EQ(3u, events.size()) << "split at " << split;
+        EXPECT_EQ("content_block_delta", events[0].event);
+        EXPECT_EQ("{\"text\":\"Hel\"}", events[0].data);
+        EXPECT_EQ("", events[1].event);
+        EXPECT_EQ("first\nsecond", events[1].data);
+        EXPECT_EQ("[DONE]", events[2].data);
+    }
+
+    // A handler returning false stops the parser for good
+    SseParser parser;
+    int seen = 0;
+    const auto stop = [&seen](const SseEvent&) { ++seen; return false; };
+    EXPECT_FALSE(parser.Feed(stream.data(), stream.size(), stop));
+    EXPECT_FALSE(parser.Finish(stop));
+    EXPECT_EQ(1, seen);
+}
+
+TEST(LLMEngineStreamingTest, DeliversChunksAndCachesCompleteStreams) {
+    LLMEngine engine(nullptr);
+    auto provider = std::make_shared<WordStreamProvider>();
+    engine.RegisterProvider(provider);
+
+    LLMRequest request;
+    request.provider = "words";
+    request.prompt = "this function decrypts the config";
+
+    std::vector<std::string> chunks;
+    auto result = engine.SendRequestStreaming(request, [&chunks](const std::string& chunk) {
+        chunks.push_back(chunk);
+        return true;
+    }).get();
+    ASSERT_TRUE(result.IsSuccess()) << result.Error();
+    EXPECT_EQ(request.prompt, result.Value().content);
+    ASSERT_EQ(5u, chunks.size());
+    EXPECT_EQ("this ", chunks[0]);
+    EXPECT_EQ("config", chunks[4]);
+
+    // A finished stream serves repeats from the cache, as one chunk
+    chunks.clear();
+    result = engine.SendRequestStreaming(request, [&chunks](const std::string& chunk) {
+        chunks.push_back(chunk);
+        return true;
+    }).get();
+    ASSERT_TRUE(result.IsSuccess()) << result.Error();
+    EXPECT_EQ(1, provider->streams.load());
+    ASSERT_EQ(1u, chunks.size());
+    EXPECT_EQ(request.prompt, chunks[0]);
+    EXPECT_EQ(request.prompt, engine.SendRequestSync(request).Value().content);
+
+    // A stream stopped early is partial and is not cached
+    LLMRequest other = request;
+    other.prompt = "stop after two words please";
+    int received = 0;
+    result = engine.SendRequestStreaming(other, [&received](const std::string&) { return ++received < 2; }).get();
+    ASSERT_TRUE(result.IsSuccess()) << result.Error();
+    EXPECT_EQ("stop after ", result.Value().content);
+    received = -100;
+    result = engine.SendRequestStreaming(other, [&received](const std::string&) { return ++received < 2; }).get();
+    EXPECT_EQ(3, provider->streams.load());
+    EXPECT_EQ(other.prompt, result.Value().content);
+}
+
+TEST(ProviderRateLimiterTest, PacesRequestsFromLearnedQuota) {
+    using std::chrono::milliseconds;
+    const auto elapsed_since = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration_cast<milliseconds>(std::chrono::steady_clock::now() - start);
+    };
+
+    ProviderRateLimiter limiter;
+    CancellationToken token;
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(limiter.Acquire(5000, token));  // No quota known yet
+    EXPECT_LT(elapsed_since(start), milliseconds(50));
+
+    // 600 a minute with none left: the next slot opens in about 100ms
+    limiter.Observe(200, {{"x-ratelimit-limit-requests", "600"}, {"x-ratelimit-remaining-requests", "0"}});
+    start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(limiter.Acquire(1, token));
+    EXPECT_GE(elapsed_since(start), milliseconds(80));
+
+    // Retry-After holds back every request to the provider
+    limiter.Observe(429, {{"retry-after", "0.3"}});
+    start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(limiter.Acquire(1, token));
+    EXPECT_GE(elapsed_since(start), milliseconds(280));
+
+    const auto stats = limiter.GetStats();
+    EXPECT_EQ(3u, stats.acquired);
+    EXPECT_EQ(2u, stats.delayed);
+    EXPECT_EQ(1u, stats.throttled);
+
+    // A configured quota wins over headers, and a waiting request can be cancelled
+    RateLimitOptions options;
+    options.requests_per_minute = 1;
+    limiter.SetOptions(options);
+    limiter.Observe(200, {{"x-ratelimit-limit-requests", "10000"}});
+    EXPECT_TRUE(limiter.Acquire(1, token));
+    CancellationToken cancelled;
+    std::thread canceller([&cancelled]() {
+        std::this_thread::sleep_for(milliseconds(100));
+        cancelled.Cancel();
+    });
+    EXPECT_FALSE(limiter.Acquire(1, cancelled));
+    canceller.join();
+
+    EXPECT_EQ(milliseconds(360000), ProviderRateLimiter::ParseDuration("6m0s").value());
+    EXPECT_EQ(milliseconds(20), ProviderRateLimiter::ParseDuration("20ms").value());
+    EXPECT_EQ(milliseconds(1500), ProviderRateLimiter::ParseDuration("1.5").value());
+    EXPECT_FALSE(ProviderRateLimiter::ParseDuration("Wed, 21 Oct 2015 07:28:00 GMT").has_value());
+
+    const auto first = limiter.BackoffFor(0, std::nullopt);
+    EXPECT_GE(first, milliseconds(250));
+    EXPECT_LE(first, milliseconds(500));
+    EXPECT_LE(limiter.BackoffFor(12, std::nullopt), milliseconds(30000));
+    EXPECT_GE(limiter.BackoffFor(0, milliseconds(2000)), milliseconds(2000));
+
+    EXPECT_TRUE(IsTransientLLMError("API Error: 429"));
+    EXPECT_TRUE(IsTransientLLMError("API Error: 503"));
+    EXPECT_TRUE(IsTransientLLMError("HTTP request failed after 4 attempts"));
+    EXPECT_FALSE(IsTransientLLMError("API Error: 401"));
+}
+
+TEST(LLMEngineFailoverTest, MovesToNextProviderOnQuotaErrors) {
+    // Stand-ins replace the built-in providers, keeping their registration order
+    LLMEngine engine(nullptr);
+    engine.SetResponseCache(nullptr);
+    auto claude = std::make_shared<ScriptedProvider>("claude", "API Error: 429");
+    auto openai = std::make_shared<ScriptedProvider>("openai", "");
+    engine.RegisterProvider(claude);
+    engine.RegisterProvider(openai);
+
+    LLMRequest request;
+    request.provider = "claude";
+    request.prompt = "name this function";
+
+    auto result = engine.SendRequestSync(request);
+    ASSERT_FALSE(result.IsSuccess());
+    EXPECT_EQ("API Error: 429", result.Error());
+    EXPECT_EQ(0, openai->calls.load());
+
+    engine.SetFailover(true);
+    result = engine.SendRequestSync(request);
+    ASSERT_TRUE(result.IsSuccess()) << result.Error();
+    EXPECT_EQ("from:openai", result.Value().content);
+    EXPECT_EQ(2, claude->calls.load());
+
+    // A failure every provider would share is returned as is
+    engine.RegisterProvider(std::make_shared<ScriptedProvider>("claude", "API Error: 400"));
+    result = engine.SendRequestSync(request);
+    ASSERT_FALSE(result.IsSuccess());
+    EXPECT_EQ("API Error: 400", result.Error());
+    EXPECT_EQ(1, openai->calls.load());
+}
+
+TEST(PromptBuilderTest, PacksRankedContextWithinBudget) {
+    EXPECT_EQ(0u, PromptBuilder::EstimateTokens(""));
+    EXPECT_EQ(4u, PromptBuilder::EstimateTokens("mov eax, ebx"));
+    const std::string listing(4000, 'a');
+    EXPECT_EQ(1000u, PromptBuilder::EstimateTokens(listing));
+
+    std::string big_listing;
+    for (int i = 0; i < 400; ++i) {
+        big_listing += "0x" + std::to_string(401000 + i * 4) + "  xor ecx, ecx\n";
+    }
+
+    PromptBudget budget;
+    budget.context_tokens = 300;
+    budget.response_tokens = 512;
+    PromptBuilder builder(budget);
+    builder.SetPrompt("Does the function call CreateRemoteThread or use an RC4 key schedule?");
+
+    PatternMatch rc4{0x401200, 256, "RC4_KSA", "RC4 key schedule loop", 0.95, {}};
+    PatternMatch crc{0x402000, 1024, "CRC32_TABLE", "CRC32 lookup table", 0.4, {}};
+    builder.AddPatterns({rc4, crc});
+    builder.AddStrings({{0x403000, "CreateRemoteThread", "ascii", 18, false},
+                        {0x403020, "kernel32.dll", "ascii", 12, false}});
+    builder.Add({ContextItem::Kind::TEXT, "String at 0x403000:   \"CreateRemoteThread\"", 1.0});
+    builder.AddDisassembly(big_listing);
+
+    LLMRequest request = builder.Build();
+    const auto& report = builder.GetReport();
+    EXPECT_EQ(6u, report.offered);
+    EXPECT_EQ(1u, report.duplicates);  // Same string, different spacing
+    EXPECT_TRUE(report.truncated);
+    EXPECT_LE(report.context_tokens, budget.context_tokens);
+    EXPECT_EQ(512, request.max_tokens);
+
+    // Everything that fits, in the order it was added; the listing cut to the rest
+    ASSERT_EQ(5u, request.context.size());
+    EXPECT_NE(std::string::npos, request.context[0].find("RC4_KSA"));
+    EXPECT_NE(std::string::npos, request.context[2].find("CreateRemoteThread"));
+    EXPECT_NE(std::string::npos, request.context[4].find("[... truncated]"));
+    EXPECT_LT(request.context[4].size(), big_listing.size());
+
+    // A tighter budget keeps the items that mention the prompt's terms
+    budget.context_tokens = 40;
+    PromptBuilder tight(budget);
+    tight.SetPrompt("Does the function call CreateRemoteThread or use an RC4 key schedule?");
+    tight.AddPatterns({crc, rc4});
+    tight.AddStrings({{0x403020, "kernel32.dll", "ascii", 12, false},
+                      {0x403000, "CreateRemoteThread", "ascii", 18, false}});
+    request = tight.Build();
+    ASSERT_EQ(2u, request.context.size());
+    EXPECT_NE(std::string::npos, request.context[0].find("RC4_KSA"));
+    EXPECT_NE(std::string::npos, request.context[1].find("CreateRemoteThread"));
+    EXPECT_EQ(2u, tight.GetReport().dropped);
+}
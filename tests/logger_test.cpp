@@ -0,0 +1,286 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/logger/logger.hpp"
+#include "../src/logger/trace_sink.hpp"
+#include "mcp/memory_view.hpp"
+
+using namespace mcp;
+
+/**
+ * @brief Test the logger queues through its entry pool and accounts for every line
+ */
+TEST(LoggerQueueTest, BatchesEntriesAndAppliesOverflowPolicy) {
+    const auto path = (std::filesystem::temp_directory_path() / "mcp_logger_queue_test.log").string();
+    const auto count_lines = [&path]() {
+        std::ifstream file(path);
+        size_t lines = 0;
+        for (std::string line; std::getline(file, line);) {
+            lines += line.find("worker ") != std::string::npos;
+        }
+        return lines;
+    };
+    const auto log_burst = [](Logger& logger, int threads, int per_thread) {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&logger, t, per_thread]() {
+                for (int i = 0; i < per_thread; ++i) {
+                    logger.LogFormatted(ILogger::LOG_INFO, "worker %d line %d", t, i);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    };
+
+    LogConfig config;
+    config.output_path = path;
+    config.console_output = false;
+    config.queue_capacity = 16;
+    config.overflow_policy = "block";
+    std::remove(path.c_str());
+    {
+        Logger logger(config);
+        log_burst(logger, 4, 500);
+        logger.Flush();
+        const auto stats = logger.GetQueueStats();
+        EXPECT_EQ(16u, stats.capacity);
+        EXPECT_EQ(2000u, stats.logged);
+        EXPECT_EQ(0u, stats.dropped);
+        EXPECT_EQ(2000u, stats.written);
+        EXPECT_LE(stats.batches, stats.written);
+    }
+    EXPECT_EQ(2000u, count_lines());
+
+    // Dropping keeps the books balanced: every call is either written or counted as dropped
+    config.overflow_policy = "drop_newest";
+    std::remove(path.c_str());
+    uint64_t logged = 0;
+    {
+        Logger logger(config);
+        log_burst(logger, 4, 500);
+        logger.Flush();
+        const auto stats = logger.GetQueueStats();
+        EXPECT_EQ(2000u, stats.logged + stats.dropped);
+        EXPECT_EQ(stats.logged, stats.written);
+        logged = stats.logged;
+
+        // Synchronous mode bypasses the queue
+        logger.EnableAsyncLogging(false);
+        logger.Log(ILogger::LOG_INFO, "worker sync");
+        EXPECT_EQ(stats.logged, logger.GetQueueStats().logged);
+    }
+    EXPECT_EQ(logged + 1, count_lines());
+    std::remove(path.c_str());
+
+    EXPECT_TRUE(Logger::ParseOverflowPolicy("drop_oldest").IsSuccess());
+    EXPECT_FALSE(Logger::ParseOverflowPolicy("spill").IsSuccess());
+}
+
+/**
+ * @brief Test a saturated pool under DROP_OLDEST drops queued lines, never the one being logged
+ */
+TEST(LoggerQueueTest, DropOldestKeepsNewestWhenPoolIsSaturated) {
+    const auto path = (std::filesystem::temp_directory_path() / "mcp_logger_drop_oldest_test.log").string();
+    std::remove(path.c_str());
+
+    LogConfig config;
+    config.output_path = path;
+    config.console_output = false;
+    config.queue_capacity = 2;
+    config.overflow_policy = "drop_oldest";
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 500;
+    // Long lines keep the log thread busy formatting the entries it holds
+    const std::string padding(64 * 1024, 'x');
+    std::string contents;
+    {
+        Logger logger(config);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < kThreads; ++t) {
+            workers.emplace_back([&logger, &padding, t]() {
+                for (int i = 0; i < kPerThread; ++i) {
+                    logger.Log(ILogger::LOG_INFO, "worker " + std::to_string(t) + " " + padding);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        logger.Log(ILogger::LOG_INFO, "final line");
+        logger.Flush();
+
+        // Every call got an entry; lines are only lost by being overwritten while queued
+        const auto stats = logger.GetQueueStats();
+        EXPECT_EQ(static_cast<uint64_t>(kThreads * kPerThread + 1), stats.logged);
+        EXPECT_EQ(stats.logged, stats.written + stats.dropped);
+        EXPECT_GT(stats.written, 0u);
+    }
+    std::ifstream file(path);
+    contents.assign((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_NE(std::string::npos, contents.find("final line"));
+    std::remove(path.c_str());
+}
+
+/**
+ * @brief Test the compiled format renders every field, including repeats and unknown names
+ */
+TEST(LoggerQueueTest, RendersCompiledFormat) {
+    const auto path = (std::filesystem::temp_directory_path() / "mcp_logger_format_test.log").string();
+    std::remove(path.c_str());
+
+    LogConfig config;
+    config.output_path = path;
+    config.console_output = false;
+    config.format = "{level}|{context}{message}|{unknown}|{timestamp}|{message}";
+    {
+        Logger logger(config);
+        logger.LogWithContext(ILogger::LOG_WARN, "hello", "ctx");
+        logger.Log(ILogger::LOG_INFO, "{level} stays literal");
+        logger.Flush();
+
+        config.format = "{thread}:{message}";
+        logger.UpdateConfig(config);
+        logger.Log(ILogger::LOG_INFO, "after");
+    }
+
+    std::ifstream file(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(file, line);) {
+        if (line.rfind("===", 0) != 0) {
+            lines.push_back(line);
+        }
+    }
+    std::remove(path.c_str());
+    ASSERT_EQ(3u, lines.size());
+
+    const std::string prefix = "WARN |[ctx] hello|{unknown}|";
+    ASSERT_EQ(0u, lines[0].find(prefix));
+    const std::string timestamp = lines[0].substr(prefix.size(), 23);  // YYYY-mm-dd HH:MM:SS.mmm
+    EXPECT_EQ('.', timestamp[19]);
+    EXPECT_EQ(':', timestamp[16]);
+    EXPECT_EQ(lines[0].size(), prefix.size() + 23 + std::string("|hello").size());
+    EXPECT_EQ(0u, lines[1].find("INFO |{level} stays literal|{unknown}|"));
+
+    std::ostringstream thread_id;
+    thread_id << std::this_thread::get_id();
+    EXPECT_EQ(thread_id.str() + ":after", lines[2]);
+}
+
+/**
+ * @brief Test trace records survive rotation and each segment decodes with its own dictionary
+ */
+TEST(TraceSinkTest, RoundTripsEventsAndDumpsAcrossSegments) {
+    const auto dir = std::filesystem::temp_directory_path() / "mcp_trace_sink_test";
+    std::filesystem::remove_all(dir);
+    const std::string path = (dir / "trace.bin").string();
+
+    const auto now = std::chrono::system_clock::now();
+    {
+        TraceOptions options;
+        options.path = path;
+        options.max_segment_bytes = 512;
+        options.max_dump_bytes = 64;
+        TraceSink sink(options);
+        ASSERT_TRUE(sink.Open().IsSuccess());
+
+        DebugEvent event;
+        event.type = DebugEvent::Type::BREAKPOINT_HIT;
+        event.address = 0x401000;
+        event.process_id = 42;
+        event.thread_id = 7;
+        event.module_name = "kernel32.dll";
+        event.description = "bp";
+        event.timestamp = now;
+        event.metadata["hits"] = "3";
+        for (int i = 0; i < 6; ++i) {
+            sink.WriteEvent(event);
+        }
+
+        MemoryDump dump;
+        dump.base_address = 0x10000;
+        dump.data.assign(200, 0xAB);
+        dump.size = dump.data.size();
+        dump.module_name = "ntdll.dll";
+        dump.timestamp = now;
+        sink.WriteMemoryDump(MemoryView::Of(dump), dump.timestamp);
+
+        const auto stats = sink.GetStats();
+        EXPECT_EQ(6u, stats.events);
+        EXPECT_EQ(1u, stats.dumps);
+        EXPECT_GE(stats.rotations, 1u);
+    }
+
+    std::vector<std::string> segments;
+    for (int i = 0; std::filesystem::exists(path + "." + std::to_string(i)); ++i) {
+        segments.push_back(path + "." + std::to_string(i));
+    }
+    ASSERT_FALSE(segments.empty());
+    segments.push_back(path);
+
+    size_t events = 0;
+    size_t dumps = 0;
+    for (const auto& segment : segments) {
+        EXPECT_LE(std::filesystem::file_size(segment), 512u);
+        TraceReader reader;
+        ASSERT_TRUE(reader.Open(segment).IsSuccess());
+        TraceRecord record;
+        for (;;) {
+            auto next = reader.Next(record);
+            ASSERT_TRUE(next.IsSuccess()) << segment;
+            if (!next.Value()) {
+                break;
+            }
+            if (record.type == TraceRecordType::DEBUG_EVENT) {
+                ++events;
+                EXPECT_EQ("kernel32.dll", record.module_name);
+                EXPECT_EQ(0x401000u, record.address);
+                EXPECT_EQ(42u, record.process_id);
+                EXPECT_EQ("bp", record.description);
+                ASSERT_EQ(1u, record.metadata.size());
+                EXPECT_EQ("hits", record.metadata[0].first);
+                EXPECT_EQ(std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()),
+                          std::chrono::duration_cast<std::chrono::nanoseconds>(record.timestamp.time_since_epoch()));
+                EXPECT_NE(std::string::npos, TraceReader::Format(record).find("type=BREAKPOINT_HIT, addr=0x401000"));
+            } else if (record.type == TraceRecordType::MEMORY_DUMP) {
+                ++dumps;
+                EXPECT_EQ("ntdll.dll", record.module_name);
+                EXPECT_EQ(kTraceFlagTruncated, record.flags);
+                EXPECT_EQ(200u, record.detail);
+                EXPECT_EQ(64u, record.data.size());
+                EXPECT_NE(std::string::npos, TraceReader::Format(record, 2).find("data=ab ab...}"));
+            }
+        }
+    }
+    EXPECT_EQ(6u, events);
+    EXPECT_EQ(1u, dumps);
+
+    // The logger sends dumps and events to the trace instead of the text log
+    std::filesystem::remove_all(dir);
+    LogConfig config;
+    config.output_path = (dir / "text.log").string();
+    config.console_output = false;
+    config.trace_path = path;
+    {
+        Logger logger(config);
+        ASSERT_NE(nullptr, logger.GetTraceSink());
+        DebugEvent event;
+        event.type = DebugEvent::Type::EXCEPTION;
+        event.module_name = "app.exe";
+        logger.LogDebugEvent(event);
+        logger.Flush();
+        EXPECT_EQ(1u, logger.GetTraceSink()->GetStats().events);
+    }
+    std::ifstream text(config.output_path);
+    const std::string contents((std::istreambuf_iterator<char>(text)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(std::string::npos, contents.find("DEBUG_EVENT"));
+    std::filesystem::remove_all(dir);
+}
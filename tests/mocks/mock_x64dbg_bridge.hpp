@@ -2,6 +2,7 @@
 
 #include <gmock/gmock.h>
 #include "mcp/interfaces.hpp"
+#include "mcp/memory_view.hpp"
 
 class MockX64DbgBridge : public mcp::IX64DbgBridge {
 public:
@@ -10,6 +11,7 @@ public:
     MOCK_METHOD(mcp::Result<std::string>, ExecuteCommand, (const std::string& command), (override));
     MOCK_METHOD(mcp::Result<std::string>, GetDisassembly, (uintptr_t address), (override));
     MOCK_METHOD(mcp::Result<mcp::MemoryDump>, ReadMemory, (uintptr_t address, size_t size), (override));
+    MOCK_METHOD(mcp::Result<std::vector<mcp::MemoryView>>, ReadMemoryBatch, (const std::vector<mcp::MemoryRange>& ranges), (override));
     MOCK_METHOD(mcp::Result<void>, SetBreakpoint, (uintptr_t address), (override));
     MOCK_METHOD(void, RegisterEventHandler, (std::function<void(const mcp::DebugEvent&)> handler), (override));
     MOCK_METHOD(bool, IsConnected, (), (const, override));
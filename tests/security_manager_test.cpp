@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "../src/core/task_executor.hpp"
+#include "../src/security/secure_buffer.hpp"
+#include "../src/security/security_manager.hpp"
+
+using namespace mcp;
+
+/**
+ * @brief Test credentials are decrypted once per TTL and streams round-trip through AES-GCM
+ */
+TEST(SecurityManagerTest, CachesCredentialsAndStreamsAesGcm) {
+    SecurityManager security(nullptr);
+    ASSERT_TRUE(security.StoreCredential("openai_key", "sk-test-value").IsSuccess());
+
+    // Only the first retrieval decrypts
+    for (int i = 0; i < 3; ++i) {
+        auto value = security.RetrieveCredential("openai_key");
+        ASSERT_TRUE(value.IsSuccess());
+        EXPECT_EQ("sk-test-value", value.Value());
+    }
+    auto stats = security.GetCredentialCacheStats();
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_EQ(2u, stats.hits);
+    EXPECT_EQ(1u, stats.entries);
+
+    // Storing a new value drops the cached one
+    ASSERT_TRUE(security.StoreCredential("openai_key", "sk-rotated").IsSuccess());
+    EXPECT_EQ("sk-rotated", security.RetrieveCredential("openai_key").Value());
+    EXPECT_EQ(2u, security.GetCredentialCacheStats().misses);
+
+    // Expired values are wiped by the executor without another lookup
+    TaskExecutorOptions options;
+    options.worker_threads = 1;
+    auto executor = std::make_shared<TaskExecutor>(options);
+    security.SetTaskExecutor(executor);
+    security.SetCredentialCacheTTL(std::chrono::milliseconds(30));
+    ASSERT_TRUE(security.StoreCredential("claude_key", "sk-short-lived").IsSuccess());
+    ASSERT_TRUE(security.RetrieveCredential("claude_key").IsSuccess());
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (security.GetCredentialCacheStats().entries > 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(0u, security.GetCredentialCacheStats().entries);
+
+    security.SetCredentialCacheTTL(std::chrono::seconds(60));
+    ASSERT_TRUE(security.RetrieveCredential("claude_key").IsSuccess());
+    EXPECT_EQ(1u, security.GetCredentialCacheStats().entries);
+    security.ClearCredentials();
+    EXPECT_EQ(0u, security.GetCredentialCacheStats().entries);
+    EXPECT_FALSE(security.RetrieveCredential("claude_key").IsSuccess());
+    executor->Shutdown();
+
+    // Several chunks plus a partial one, so held-back tag bytes cross chunk boundaries
+    std::string plaintext(3 * 1024 * 1024 + 12345, '\0');
+    for (size_t i = 0; i < plaintext.size(); ++i) {
+        plaintext[i] = static_cast<char>((i * 131) ^ (i >> 7));
+    }
+    std::istringstream plain_in(plaintext);
+    std::ostringstream sealed_out;
+    auto encrypted = security.EncryptStream(plain_in, sealed_out);
+    ASSERT_TRUE(encrypted.IsSuccess()) << encrypted.Error();
+    EXPECT_EQ(plaintext.size(), encrypted.Value());
+    const std::string sealed = sealed_out.str();
+    ASSERT_EQ(plaintext.size() + AesGcmStream::kIvSize + AesGcmStream::kTagSize, sealed.size());
+
+    std::istringstream sealed_in(sealed);
+    std::ostringstream opened_out;
+    auto decrypted = security.DecryptStream(sealed_in, opened_out);
+    ASSERT_TRUE(decrypted.IsSuccess()) << decrypted.Error();
+    EXPECT_EQ(plaintext.size(), decrypted.Value());
+    EXPECT_TRUE(opened_out.str() == plaintext);
+
+    std::string tampered = sealed;
+    tampered[tampered.size() / 2] ^= 0x01;
+    std::istringstream tampered_in(tampered);
+    std::ostringstream rejected_out;
+    EXPECT_FALSE(security.DecryptStream(tampered_in, rejected_out).IsSuccess());
+    std::istringstream truncated_in(sealed.substr(0, 20));
+    EXPECT_FALSE(security.DecryptStream(truncated_in, rejected_out).IsSuccess());
+
+    // Empty input still produces an authenticated stream
+    std::istringstream empty_in;
+    std::ostringstream empty_sealed;
+    ASSERT_TRUE(security.EncryptStream(empty_in, empty_sealed).IsSuccess());
+    std::istringstream empty_open(empty_sealed.str());
+    std::ostringstream empty_out;
+    auto empty = security.DecryptStream(empty_open, empty_out);
+    ASSERT_TRUE(empty.IsSuccess()) << empty.Error();
+    EXPECT_EQ(0u, empty.Value());
+
+    SecureBuffer buffer = SecureBuffer::FromString("secret");
+    EXPECT_EQ("secret", buffer.ToString());
+    buffer.Release();
+    EXPECT_TRUE(buffer.Empty());
+    EXPECT_EQ(nullptr, buffer.Data());
+}
+
+/**
+ * @brief Test a key file carries the data key across sessions and rekeying keeps credentials
+ */
+TEST(SecurityManagerTest, LoadsEncryptionKeyAcrossSessions) {
+    const auto key_path = (std::filesystem::temp_directory_path() / "mcp_security_test.key").string();
+    std::remove(key_path.c_str());
+
+    const std::vector<uint8_t> plain = {'c', 'a', 'c', 'h', 'e', 'd'};
+    std::vector<uint8_t> sealed;
+    {
+        SecurityManager first(nullptr);
+        ASSERT_TRUE(first.LoadEncryptionKey(key_path).IsSuccess());
+        ASSERT_TRUE(std::filesystem::exists(key_path));
+#ifndef _WIN32
+        const auto permissions = std::filesystem::status(key_path).permissions();
+        EXPECT_EQ(std::filesystem::perms::none,
+                  permissions & (std::filesystem::perms::group_all | std::filesystem::perms::others_all));
+#endif
+        ASSERT_TRUE(first.EncryptData(plain, sealed).IsSuccess());
+    }
+
+    // Another session's random key cannot open it
+    std::vector<uint8_t> opened;
+    SecurityManager stranger(nullptr);
+    EXPECT_FALSE(stranger.DecryptData(sealed, opened).IsSuccess());
+
+    // A credential stored before the key is loaded is re-encrypted under it
+    SecurityManager second(nullptr);
+    ASSERT_TRUE(second.StoreCredential("openai_key", "sk-before-load").IsSuccess());
+    ASSERT_TRUE(second.LoadEncryptionKey(key_path).IsSuccess());
+    ASSERT_TRUE(second.DecryptData(sealed, opened).IsSuccess());
+    EXPECT_EQ(plain, opened);
+    EXPECT_EQ("sk-before-load", second.RetrieveCredential("openai_key").Value());
+
+    // A key file that is not 32 bytes of hex is refused
+    {
+        std::ofstream bad(key_path, std::ios::trunc);
+        bad << "not-a-key";
+    }
+    SecurityManager refused(nullptr);
+    EXPECT_FALSE(refused.LoadEncryptionKey(key_path).IsSuccess());
+
+    std::remove(key_path.c_str());
+}
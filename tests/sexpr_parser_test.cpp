@@ -0,0 +1,265 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "../src/parser/sexpr_parser.hpp"
+#include "../src/parser/sexpr_stream.hpp"
+
+using namespace mcp;
+
+/**
+ * @brief Test arena documents parse like Parse, view their source and evaluate the same way
+ */
+TEST(SExprArenaTest, ParsesIntoArenaAndEvaluatesLikeSExpressions) {
+    SExprParser parser;
+    const std::string source = "(+ x 2 (+ 0.5 0.5) \"a\\\"b\" \"plain\" true -y)";
+
+    auto document_result = parser.ParseDocument(source);
+    ASSERT_TRUE(document_result.IsSuccess()) << document_result.Error();
+    const AstDocument& document = document_result.Value();
+    const AstNode& root = *document.Root();
+    ASSERT_TRUE(root.IsList());
+    ASSERT_EQ(8u, root.count);
+    EXPECT_EQ(12u, document.GetNodeCount());
+
+    // Symbols and plain strings point into the document's copy of the source
+    const auto in_source = [&document](std::string_view text) {
+        return text.data() >= document.Source().data() &&
+               text.data() + text.size() <= document.Source().data() + document.Source().size();
+    };
+    EXPECT_EQ(AstNode::Kind::SYMBOL, root[0].kind);
+    EXPECT_TRUE(in_source(root[0].text));
+    EXPECT_EQ("a\"b", root[4].text);
+    EXPECT_FALSE(in_source(root[4].text));
+    EXPECT_EQ("plain", root[5].text);
+    EXPECT_TRUE(in_source(root[5].text));
+    EXPECT_EQ(AstNode::Kind::BOOLEAN, root[6].kind);
+    EXPECT_EQ("-y", root[7].text);
+
+    // Ids are shared by every document the parser produces
+    auto again = parser.ParseDocument("(x +)");
+    ASSERT_TRUE(again.IsSuccess());
+    EXPECT_EQ(root[1].symbol, (*again.Value().Root())[0].symbol);
+    EXPECT_EQ(root[0].symbol, (*again.Value().Root())[1].symbol);
+    EXPECT_EQ("x", parser.GetSymbols().Name(root[1].symbol));
+
+    // Same tree as the owning parser builds
+    auto owned = parser.Parse(source);
+    ASSERT_TRUE(owned.IsSuccess());
+    EXPECT_EQ(parser.Serialize(owned.Value()).Value(), parser.Serialize(document.ToSExpression()).Value());
+
+    SExpression forty;
+    forty.value = static_cast<int64_t>(40);
+    parser.RegisterVariable("x", forty);
+    auto sum = parser.ParseDocument("(+ x 2 (+ 0.5 0.5))");
+    ASSERT_TRUE(sum.IsSuccess());
+    auto value = parser.Evaluate(*sum.Value().Root());
+    ASSERT_TRUE(value.IsSuccess()) << value.Error();
+    EXPECT_DOUBLE_EQ(43.0, std::get<double>(value.Value().value));
+
+    auto unknown = parser.ParseDocument("(nope 1)");
+    ASSERT_TRUE(unknown.IsSuccess());
+    EXPECT_EQ("Unknown function: nope", parser.Evaluate(*unknown.Value().Root()).Error());
+
+    for (const std::string& bad : std::vector<std::string>{"", "(1 2", "\"open", std::string(101, '(') + std::string(101, ')')}) {
+        auto arena_result = parser.ParseDocument(bad);
+        auto owned_result = parser.Parse(bad);
+        ASSERT_FALSE(arena_result.IsSuccess()) << bad;
+        ASSERT_FALSE(owned_result.IsSuccess()) << bad;
+        EXPECT_EQ(owned_result.Error(), arena_result.Error());
+    }
+}
+
+/**
+ * @brief Test the bump arena keeps alignment, isolates oversized blocks and resets to one block
+ */
+TEST(SExprArenaTest, BumpArenaAllocatesAlignedAndResets) {
+    BumpArena arena(1024);
+    auto* small = static_cast<char*>(arena.Allocate(3, 1));
+    auto* aligned = arena.AllocateArray<int64_t>(4);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(aligned) % alignof(int64_t));
+    auto* big = static_cast<char*>(arena.Allocate(4096, 8));
+    auto* next = static_cast<char*>(arena.Allocate(1, 1));
+    EXPECT_EQ(2u, arena.GetBlockCount());
+    EXPECT_TRUE(next > small && next < small + 1024);  // The oversized block did not close the current one
+    std::memset(big, 0xCC, 4096);
+
+    arena.Reset();
+    EXPECT_EQ(1u, arena.GetBlockCount());
+    EXPECT_EQ(0u, arena.GetBytesUsed());
+    EXPECT_EQ(small, static_cast<char*>(arena.Allocate(3, 1)));
+}
+
+/**
+ * @brief Test compiled expressions fold constants, are cached by source and follow rebinding
+ */
+TEST(SExprCompilerTest, CompilesFoldsAndCachesExpressions) {
+    SExprParser parser;
+    const auto integer = [](int64_t value) {
+        SExpression expr;
+        expr.value = value;
+        return expr;
+    };
+    parser.RegisterVariable("x", integer(40));
+
+    auto program = parser.Compile("(+ x (+ 1 1) (+ 0 0))");
+    ASSERT_TRUE(program.IsSuccess()) << program.Error();
+    // Both inner calls became constants: LOAD x, PUSH_CONST 2, PUSH_CONST 0, CALL +
+    ASSERT_EQ(4u, program.Value()->code.size());
+    EXPECT_EQ(Instruction::Op::CALL, program.Value()->code.back().op);
+    EXPECT_EQ(3u, program.Value()->max_stack);
+
+    for (int i = 0; i < 100; ++i) {
+        auto result = parser.EvaluateCompiled("(+ x (+ 1 1) (+ 0 0))");
+        ASSERT_TRUE(result.IsSuccess()) << result.Error();
+        EXPECT_EQ(42, std::get<int64_t>(result.Value().value));
+    }
+    auto stats = parser.GetCompileStats();
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_EQ(99u, stats.hits);
+    EXPECT_EQ(1u, stats.relinks);
+    EXPECT_EQ(1u, stats.entries);
+
+    // Rebinding relinks without recompiling; context shadows variables without copying them
+    parser.RegisterVariable("x", integer(1));
+    EXPECT_EQ(3, std::get<int64_t>(parser.EvaluateCompiled("(+ x (+ 1 1) (+ 0 0))").Value().value));
+    std::unordered_map<std::string, SExpression> context{{"x", integer(10)}};
+    EXPECT_EQ(12, std::get<int64_t>(parser.EvaluateCompiled("(+ x (+ 1 1) (+ 0 0))", context).Value().value));
+    EXPECT_EQ(1u, parser.GetCompileStats().misses);
+    EXPECT_EQ(2u, parser.GetCompileStats().relinks);
+
+    // Functions registered after compiling are found, and replacing a folded one recompiles
+    auto late = parser.Compile("(twice x)");
+    ASSERT_TRUE(late.IsSuccess());
+    EXPECT_EQ("Unknown function: twice", parser.Run(*late.Value()).Error());
+    parser.RegisterFunction("twice", [](const std::vector<SExpression>& args) {
+        SExpression result;
+        result.value = std::get<int64_t>(args.at(0).value) * 2;
+        return Result<SExpression>::Success(result);
+    });
+    EXPECT_EQ(2, std::get<int64_t>(parser.Run(*late.Value()).Value().value));
+
+    auto folded = parser.Compile("(+ 2 3)");
+    ASSERT_TRUE(folded.IsSuccess());
+    ASSERT_EQ(1u, folded.Value()->code.size());
+    parser.RegisterFunction("+", [](const std::vector<SExpression>&) {
+        SExpression result;
+        result.value = static_cast<int64_t>(-1);
+        return Result<SExpression>::Success(result);
+    });
+    EXPECT_EQ(-1, std::get<int64_t>(parser.Run(*folded.Value()).Value().value));
+    EXPECT_EQ(-1, std::get<int64_t>(parser.EvaluateCompiled("(+ x (+ 1 1) (+ 0 0))").Value().value));
+    EXPECT_EQ(2u, parser.GetCompileStats().misses);
+
+    // Failed folds keep the call so the error still comes from running it
+    auto failing = parser.Compile("(* 2 3)");
+    ASSERT_TRUE(failing.IsSuccess());
+    EXPECT_EQ("Multiply not implemented", parser.Run(*failing.Value()).Error());
+    EXPECT_FALSE(parser.EvaluateCompiled("(1 2").IsSuccess());
+
+    // A head evaluated at run time, and a variable naming the function
+    SExpression name;
+    name.value = std::string("twice");
+    parser.RegisterVariable("f", name);
+    EXPECT_EQ(2, std::get<int64_t>(parser.EvaluateCompiled("(f x)").Value().value));
+    EXPECT_EQ(2, std::get<int64_t>(parser.EvaluateCompiled("(\"twice\" x)").Value().value));
+}
+
+/**
+ * @brief Test functions that change the bindings mid-program leave later instructions correct
+ */
+TEST(SExprCompilerTest, RelinksAfterCallsThatChangeBindings) {
+    SExprParser parser;
+    const auto integer = [](int64_t value) {
+        SExpression expr;
+        expr.value = value;
+        return expr;
+    };
+    parser.RegisterVariable("x", integer(40));
+
+    // EvaluateInContext restores the variables by replacing the whole map
+    auto inner = parser.Parse("(+ y 1)");
+    ASSERT_TRUE(inner.IsSuccess());
+    const SExpression inner_expr = inner.Value();
+    parser.RegisterFunction("peek", [&parser, &inner_expr, &integer](const std::vector<SExpression>&) {
+        return parser.EvaluateInContext(inner_expr, {{"y", integer(1)}});
+    });
+    EXPECT_EQ(82, std::get<int64_t>(parser.EvaluateCompiled("(+ (peek) x x)").Value().value));
+    EXPECT_EQ(82, std::get<int64_t>(parser.EvaluateCompiled("(+ (peek) x x)").Value().value));
+
+    // A function registered by an earlier call is found by a later one in the same program
+    parser.RegisterFunction("define-late", [&parser, &integer](const std::vector<SExpression>&) {
+        parser.RegisterFunction("late", [](const std::vector<SExpression>& args) {
+            return Result<SExpression>::Success(args.at(0));
+        });
+        return Result<SExpression>::Success(integer(0));
+    });
+    auto result = parser.EvaluateCompiled("(+ (define-late) (late x))");
+    ASSERT_TRUE(result.IsSuccess()) << result.Error();
+    EXPECT_EQ(40, std::get<int64_t>(result.Value().value));
+}
+
+/**
+ * @brief Test the stream parser yields the same forms however the input is chunked
+ */
+TEST(SExprStreamTest, SplitsChunkedInputIntoTopLevelForms) {
+    const std::string script =
+        "; setup\n"
+        "(+ 1 2)  (list \"a ) ; b\" ; trailing comment\n"
+        "  (car x))\n"
+        ":status verbose\r\n"
+        "symbol \"quoted \\\" atom\")\n"
+        "(unclosed";
+    const std::vector<std::string> expected = {
+        "(+ 1 2)", "(list \"a ) ; b\"  \n  (car x))", ":status verbose", "symbol", "\"quoted \\\" atom\""};
+
+    for (size_t chunk = 1; chunk <= script.size(); ++chunk) {
+        SExprStreamParser stream;
+        std::vector<std::string> forms;
+        std::vector<std::pair<std::string, size_t>> errors;
+        std::vector<size_t> lines;
+        const auto on_form = [&](const Result<std::string_view>& form, size_t line) {
+            if (form.IsSuccess()) {
+                forms.emplace_back(form.Value());
+                lines.push_back(line);
+            } else {
+                errors.emplace_back(form.Error(), line);
+            }
+        };
+        for (size_t offset = 0; offset < script.size(); offset += chunk) {
+            stream.Feed(std::string_view(script).substr(offset, chunk), on_form);
+        }
+        EXPECT_FALSE(stream.IsIdle());
+        stream.Finish(on_form);
+
+        ASSERT_EQ(expected, forms) << "chunk size " << chunk;
+        EXPECT_EQ((std::vector<size_t>{2, 2, 4, 5, 5}), lines);
+        ASSERT_EQ(2u, errors.size());
+        EXPECT_EQ(std::make_pair(std::string("Unexpected ')'"), size_t(5)), errors[0]);
+        EXPECT_EQ(std::make_pair(std::string("Missing closing ')'"), size_t(6)), errors[1]);
+        EXPECT_TRUE(stream.IsIdle());
+    }
+
+    // Every list form is ready for the parser as handed out
+    SExprParser parser;
+    EXPECT_TRUE(parser.Parse("(list \"a ) ; b\"  \n  (car x))").IsSuccess());
+
+    // Oversized forms are skipped to their end and the stream carries on
+    SExprStreamParser small(8);
+    std::vector<std::string> forms;
+    size_t errors = 0;
+    small.Feed("(1 2 3 4 5 6) (a)", [&](const Result<std::string_view>& form, size_t) {
+        if (form.IsSuccess()) {
+            forms.emplace_back(form.Value());
+        } else {
+            ++errors;
+        }
+    });
+    EXPECT_EQ(1u, errors);
+    EXPECT_EQ(std::vector<std::string>{"(a)"}, forms);
+}
@@ -0,0 +1,1183 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include "mcp/executor.hpp"
+#include "mcp/hex_codec.hpp"
+#include "mcp/latency_histogram.hpp"
+#include "mcp/mpsc_ring.hpp"
+#include "../src/core/task_executor.hpp"
+#include "../src/x64dbg/compact_event.hpp"
+#include "../src/x64dbg/page_cache.hpp"
+#include "../src/x64dbg/shared_memory_transport.hpp"
+#include "../src/x64dbg/symbol_cache.hpp"
+#include "../src/x64dbg/x64dbg_bridge.hpp"
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace mcp;
+
+namespace {
+
+// Debuggee memory where byte i of the address space is (i & 0xFF) ^ salt
+class FakeMemory {
+public:
+    Result<std::vector<uint8_t>> Read(uintptr_t address, size_t size) {
+        ++calls;
+        std::vector<uint8_t> data;
+        for (size_t i = 0; i < size && address + i < readable_end; ++i) {
+            data.push_back(static_cast<uint8_t>(((address + i) & 0xFF) ^ salt));
+        }
+        return Result<std::vector<uint8_t>>::Success(std::move(data));
+    }
+
+    PageCache::Fetcher Fetcher() {
+        return [this](uintptr_t address, size_t size) { return Read(address, size); };
+    }
+
+    size_t calls = 0;
+    uint8_t salt = 0;
+    uintptr_t readable_end = UINTPTR_MAX;
+};
+
+// Debugger end of the binary protocol over a flat memory image
+class FakeFramedDebugger : public IBridgeTransport {
+public:
+    FakeFramedDebugger(uintptr_t base, size_t size) : base(base), memory(size) {
+        for (size_t i = 0; i < size; ++i) {
+            memory[i] = static_cast<uint8_t>(i * 7 + (i >> 12));
+        }
+    }
+
+    Result<void> Send(const uint8_t* data, size_t size) override {
+        const std::lock_guard<std::mutex> lock(mutex);
+        decoder.Feed(data, size);
+        Frame frame;
+        std::string error;
+        while (decoder.Next(frame, error)) {
+            Handle(frame);
+        }
+        ready.notify_all();
+        return error.empty() ? Result<void>::Success() : Result<void>::Error(error);
+    }
+
+    // Hands out replies in odd-sized pieces so frames arrive split
+    Result<size_t> Receive(uint8_t* buffer, size_t capacity) override {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [this] { return !outbox.empty() || closed; });
+        const size_t count = std::min({capacity, outbox.size(), size_t{7001}});
+        std::copy(outbox.begin(), outbox.begin() + static_cast<std::ptrdiff_t>(count), buffer);
+        outbox.erase(outbox.begin(), outbox.begin() + static_cast<std::ptrdiff_t>(count));
+        return Result<size_t>::Success(count);
+    }
+
+    void Close() override {
+        const std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        ready.notify_all();
+    }
+
+    // Sends an event unprompted, as the debugger does between replies
+    void PushEvent(const DebugEvent& event) {
+        const std::lock_guard<std::mutex> lock(mutex);
+        std::vector<uint8_t> payload;
+        EncodeEventPayload(event, payload);
+        Reply(FrameType::kEvent, 0, event.address, FrameHeader::kFlagFinal, payload.data(), payload.size());
+        ready.notify_all();
+    }
+
+    uintptr_t base;
+    std::vector<uint8_t> memory;
+    size_t read_requests = 0;
+    size_t batch_requests = 0;
+    size_t write_frames = 0;
+    size_t commands = 0;
+    size_t hold_commands = 0;  // Answer commands only once this many are pending, newest first
+
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    bool closed = false;
+    FrameDecoder decoder;
+    std::deque<uint8_t> outbox;
+    std::vector<std::pair<uint32_t, std::string>> held;
+
+    void Reply(FrameType type, uint32_t id, uint64_t address, uint16_t flags, const uint8_t* payload, size_t size) {
+        FrameHeader header;
+        header.type = type;
+        header.flags = flags;
+        header.request_id = id;
+        header.payload_size = static_cast<uint32_t>(size);
+        header.address = address;
+        std::vector<uint8_t> out;
+        EncodeFrame(header, payload, out);
+        outbox.insert(outbox.end(), out.begin(), out.end());
+    }
+
+    void Handle(const Frame& frame) {
+        const uint32_t id = frame.header.request_id;
+        const uint64_t address = frame.header.address;
+        if (frame.header.type == FrameType::kReadMemory) {
+            ++read_requests;
+            uint64_t size = 0;
+            for (size_t i = 0; i < sizeof(size); ++i) {
+                size |= static_cast<uint64_t>(frame.payload[i]) << (8 * i);
+            }
+            if (address < base || address + size > base + memory.size()) {
+                const std::string message = "Access violation";
+                Reply(FrameType::kError, id, address, FrameHeader::kFlagFinal,
+                      reinterpret_cast<const uint8_t*>(message.data()), message.size());
+                return;
+            }
+            for (uint64_t offset = 0; offset < size; offset += kMaxChunkSize) {
+                const size_t chunk = static_cast<size_t>(std::min<uint64_t>(kMaxChunkSize, size - offset));
+                Reply(FrameType::kReadReply, id, address + offset,
+                      offset + chunk == size ? FrameHeader::kFlagFinal : 0,
+                      memory.data() + (address - base) + offset, chunk);
+            }
+        } else if (frame.header.type == FrameType::kReadBatch) {
+            ++batch_requests;
+            for (size_t entry = 0; entry + 16 <= frame.payload.size(); entry += 16) {
+                uint64_t range_address = 0;
+                uint64_t range_size = 0;
+                for (size_t i = 0; i < 8; ++i) {
+                    range_address |= static_cast<uint64_t>(frame.payload[entry + i]) << (8 * i);
+                    range_size |= static_cast<uint64_t>(frame.payload[entry + 8 + i]) << (8 * i);
+                }
+                // Only the part inside the fake address space is readable
+                const uint64_t end = std::min<uint64_t>(range_address + range_size, base + memory.size());
+                const size_t readable = range_address >= base && end > range_address
+                                            ? static_cast<size_t>(end - range_address) : 0;
+                Reply(FrameType::kReadReply, id, range_address, FrameHeader::kFlagFinal,
+                      memory.data() + (readable ? range_address - base : 0), readable);
+            }
+        } else if (frame.header.type == FrameType::kCommand) {
+            ++commands;
+            held.emplace_back(id, "ok:" + std::string(frame.payload.begin(), frame.payload.end()));
+            if (held.size() >= hold_commands) {
+                for (auto it = held.rbegin(); it != held.rend(); ++it) {
+                    Reply(FrameType::kCommandReply, it->first, 0, FrameHeader::kFlagFinal,
+                          reinterpret_cast<const uint8_t*>(it->second.data()), it->second.size());
+                }
+                held.clear();
+            }
+        } else if (frame.header.type == FrameType::kWriteMemory) {
+            ++write_frames;
+            std::copy(frame.payload.begin(), frame.payload.end(), memory.begin() + static_cast<std::ptrdiff_t>(address - base));
+            Reply(FrameType::kWriteReply, id, address, FrameHeader::kFlagFinal, nullptr, 0);
+        }
+    }
+};
+
+} // anonymous namespace
+
+/**
+ * @brief Repeated reads are served from cached pages until the cache is invalidated
+ */
+TEST(PageCacheTest, ServesRepeatedReadsFromCache) {
+    FakeMemory memory;
+    PageCache cache(4);
+
+    auto first = cache.Read(0x10FF0, 0x30, memory.Fetcher()); // Straddles two pages
+    ASSERT_TRUE(first.IsSuccess());
+    EXPECT_EQ(1u, memory.calls);                               // One fetch for the run of missing pages
+    EXPECT_EQ(0xF0, first.Value()[0]);
+    EXPECT_EQ(0x1F, first.Value()[0x2F]);
+
+    auto second = cache.Read(0x11000, 16, memory.Fetcher());
+    ASSERT_TRUE(second.IsSuccess());
+    EXPECT_EQ(1u, memory.calls);
+    EXPECT_EQ(0x00, second.Value()[0]);
+
+    auto stats = cache.GetStats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(2u, stats.misses);
+    EXPECT_EQ(2u, stats.cached_pages);
+
+    // The target ran: the same read goes back to the debugger and sees new bytes
+    memory.salt = 0xFF;
+    cache.Invalidate();
+    auto third = cache.Read(0x11000, 16, memory.Fetcher());
+    ASSERT_TRUE(third.IsSuccess());
+    EXPECT_EQ(2u, memory.calls);
+    EXPECT_EQ(0xFF, third.Value()[0]);
+
+    // LRU bound: a fifth page evicts the least recently used one
+    for (uintptr_t page = 0x20000; page < 0x20000 + 4 * PageCache::kPageSize; page += PageCache::kPageSize) {
+        ASSERT_TRUE(cache.Read(page, 1, memory.Fetcher()).IsSuccess());
+    }
+    stats = cache.GetStats();
+    EXPECT_EQ(4u, stats.cached_pages);
+    EXPECT_EQ(1u, stats.evictions);
+    const size_t calls = memory.calls;
+    ASSERT_TRUE(cache.Read(0x11000, 1, memory.Fetcher()).IsSuccess());
+    EXPECT_EQ(calls + 1, memory.calls);
+
+    // Partly unreadable pages are returned as the debugger reports them, never cached
+    memory.readable_end = 0x30800;
+    auto partial = cache.Read(0x30000, 0x1000, memory.Fetcher());
+    ASSERT_TRUE(partial.IsSuccess());
+    EXPECT_EQ(0x800u, partial.Value().size());
+    ASSERT_TRUE(cache.Read(0x30000, 16, memory.Fetcher()).IsSuccess());
+    EXPECT_EQ(calls + 3, memory.calls);  // One fetch each: the short result is the answer
+}
+
+/**
+ * @brief Reads larger than the cache bypass it, and short fetches are not repeated
+ */
+TEST(PageCacheTest, BypassesOversizedReadsAndKeepsShortFetches) {
+    FakeMemory memory;
+    PageCache cache(4);
+    ASSERT_TRUE(cache.Read(0x10000, 16, memory.Fetcher()).IsSuccess());
+
+    // Eight pages cannot fit in four: fetched as asked, and the cached page survives
+    auto large = cache.Read(0x10000, 8 * PageCache::kPageSize, memory.Fetcher());
+    ASSERT_TRUE(large.IsSuccess());
+    EXPECT_EQ(8 * PageCache::kPageSize, large.Value().size());
+    EXPECT_EQ(0x10u, large.Value()[0x10]);
+    auto stats = cache.GetStats();
+    EXPECT_EQ(1u, stats.bypassed);
+    EXPECT_EQ(1u, stats.cached_pages);
+    EXPECT_EQ(0u, stats.evictions);
+    ASSERT_TRUE(cache.Read(0x10000, 16, memory.Fetcher()).IsSuccess());
+    EXPECT_EQ(2u, memory.calls);
+
+    // Memory ends a third of the way into the last page: one fetch, the whole pages before it are kept
+    memory.readable_end = 0x42400;
+    auto tail = cache.Read(0x40010, 3 * PageCache::kPageSize, memory.Fetcher());
+    ASSERT_TRUE(tail.IsSuccess());
+    EXPECT_EQ(0x42400u - 0x40010u, tail.Value().size());
+    EXPECT_EQ(0xFFu, tail.Value()[0x42400 - 0x40010 - 1]);
+    EXPECT_EQ(3u, memory.calls);
+    ASSERT_TRUE(cache.Read(0x41000, PageCache::kPageSize, memory.Fetcher()).IsSuccess());
+    EXPECT_EQ(3u, memory.calls);
+
+    // A run that fails outright after cached bytes ends the read at the run
+    auto failing = [&memory](uintptr_t address, size_t size) -> Result<std::vector<uint8_t>> {
+        if (address >= 0x42000) {
+            return Result<std::vector<uint8_t>>::Error("unreadable");
+        }
+        return memory.Read(address, size);
+    };
+    auto cut = cache.Read(0x41800, PageCache::kPageSize, failing);
+    ASSERT_TRUE(cut.IsSuccess());
+    EXPECT_EQ(0x800u, cut.Value().size());
+    EXPECT_FALSE(cache.Read(0x42000, 16, failing).IsSuccess());
+}
+
+/**
+ * @brief PIPE/TCP memory traffic uses binary frames, streamed past the old 1 MB hex limit
+ */
+TEST(X64DbgBridgeTest, TransfersMemoryInBinaryFrames) {
+    const uintptr_t base = 0x10000000;
+    auto transport = std::make_unique<FakeFramedDebugger>(base, 3 * 1024 * 1024);
+    FakeFramedDebugger* debugger = transport.get();
+
+    X64DbgBridge bridge(nullptr);
+    ASSERT_TRUE(bridge.SetConnectionMode(X64DbgBridge::ConnectionMode::TCP).IsSuccess());
+    ASSERT_TRUE(bridge.SetTransport(std::move(transport)).IsSuccess());
+    ASSERT_TRUE(bridge.Connect().IsSuccess());
+
+    auto dump = bridge.ReadMemory(base, debugger->memory.size());
+    ASSERT_TRUE(dump.IsSuccess()) << dump.Error();
+    EXPECT_EQ(debugger->memory.size(), dump.Value().size);
+    EXPECT_TRUE(dump.Value().data == debugger->memory);
+    EXPECT_EQ(1u, debugger->read_requests);
+
+    std::vector<uint8_t> patch(200 * 1024);
+    std::iota(patch.begin(), patch.end(), uint8_t{1});
+    ASSERT_TRUE(bridge.WriteMemory(base + 100, patch).IsSuccess());
+    EXPECT_EQ((patch.size() + kMaxChunkSize - 1) / kMaxChunkSize, debugger->write_frames);
+
+    // The write dropped the cached pages, so the new bytes are read back
+    auto after = bridge.ReadMemoryRaw(base + 100, patch.size());
+    ASSERT_TRUE(after.IsSuccess());
+    EXPECT_TRUE(after.Value() == patch);
+
+    auto outside = bridge.ReadMemoryRaw(base + debugger->memory.size() - 16, 64);
+    ASSERT_FALSE(outside.IsSuccess());
+    EXPECT_EQ("Access violation", outside.Error());
+    EXPECT_TRUE(bridge.Disconnect().IsSuccess());
+}
+
+/**
+ * @brief Scattered reads are merged into spans and answered by a single batch request
+ */
+TEST(X64DbgBridgeTest, BatchesScatteredReads) {
+    const uintptr_t base = 0x400000;
+    auto transport = std::make_unique<FakeFramedDebugger>(base, 0x2000);
+    FakeFramedDebugger* debugger = transport.get();
+    std::iota(debugger->memory.begin(), debugger->memory.end(), uint8_t{0});
+
+    X64DbgBridge bridge(nullptr);
+    ASSERT_TRUE(bridge.SetConnectionMode(X64DbgBridge::ConnectionMode::PIPE).IsSuccess());
+    ASSERT_TRUE(bridge.SetTransport(std::move(transport)).IsSuccess());
+    ASSERT_TRUE(bridge.Connect().IsSuccess());
+
+    const std::vector<MemoryRange> ranges = {
+        {base + 0x1000, 8},            // Vtable slot
+        {base + 0x10, 16},             // Overlaps the next range
+        {base + 0x18, 16},
+        {base + 0x28, 8},              // Touches the one before
+        {base + 0x1FF8, 16},           // Runs off the end of readable memory
+        {base + 0x500, 0},
+    };
+    auto views = bridge.ReadMemoryBatch(ranges);
+    ASSERT_TRUE(views.IsSuccess()) << views.Error();
+    ASSERT_EQ(ranges.size(), views.Value().size());
+    EXPECT_EQ(1u, debugger->batch_requests);
+    EXPECT_EQ(0u, debugger->read_requests);
+
+    for (size_t i = 0; i < 4; ++i) {
+        const MemoryView& view = views.Value()[i];
+        EXPECT_EQ(ranges[i].address, view.base_address);
+        ASSERT_EQ(ranges[i].size, view.size);
+        for (size_t offset = 0; offset < view.size; ++offset) {
+            EXPECT_EQ(static_cast<uint8_t>(ranges[i].address - base + offset), view[offset]);
+        }
+    }
+    EXPECT_EQ(8u, views.Value()[4].size);
+    EXPECT_EQ(0xF8, views.Value()[4][0]);
+    EXPECT_TRUE(views.Value()[5].empty());
+
+    // Overlapping ranges point into the same bytes of the shared buffer
+    EXPECT_EQ(views.Value()[1].data + 8, views.Value()[2].data);
+    EXPECT_EQ(views.Value()[0].owner, views.Value()[3].owner);
+
+    // Oversized batches fail before anything is allocated or sent
+    const size_t mb = 1024 * 1024;
+    EXPECT_EQ("Range too large in batch (max 16MB)", bridge.ReadMemoryBatch({{base, 16 * mb + 1}}).Error());
+    std::vector<MemoryRange> wide;
+    for (uintptr_t i = 0; i < 5; ++i) {
+        wide.push_back({base + i * 16 * mb, 16 * mb});
+    }
+    EXPECT_EQ("Batch reads too much memory (max 64MB)", bridge.ReadMemoryBatch(wide).Error());
+    EXPECT_EQ(1u, debugger->batch_requests);
+    // Overlapping ranges only count once
+    const std::vector<MemoryRange> repeated(8, MemoryRange{base, 16 * mb});
+    EXPECT_TRUE(bridge.ReadMemoryBatch(repeated).IsSuccess());
+    EXPECT_TRUE(bridge.Disconnect().IsSuccess());
+}
+
+/**
+ * @brief Async commands are all on the wire before any reply and are matched back by request ID
+ */
+TEST(X64DbgBridgeTest, PipelinesTaggedCommands) {
+    const uintptr_t base = 0x400000;
+    auto transport = std::make_unique<FakeFramedDebugger>(base, 0x1000);
+    FakeFramedDebugger* debugger = transport.get();
+    debugger->hold_commands = 3;
+
+    X64DbgBridge bridge(nullptr);
+    ASSERT_TRUE(bridge.SetConnectionMode(X64DbgBridge::ConnectionMode::TCP).IsSuccess());
+    ASSERT_TRUE(bridge.SetTransport(std::move(transport)).IsSuccess());
+    ASSERT_TRUE(bridge.Connect().IsSuccess());
+
+    // The debugger answers only after the third request, in reverse order
+    auto registers = bridge.ExecuteCommandAsync("r rax");
+    auto modules = bridge.ExecuteCommandAsync("modlist");
+    auto disassembly = bridge.ExecuteCommandAsync("disasm 401000");
+    auto disassembly_result = disassembly.get();
+    auto modules_result = modules.get();
+    auto registers_result = registers.get();
+    ASSERT_TRUE(registers_result.IsSuccess()) << registers_result.Error();
+    EXPECT_EQ("ok:r rax", registers_result.Value());
+    EXPECT_EQ("ok:modlist", modules_result.Value());
+    EXPECT_EQ("ok:disasm 401000", disassembly_result.Value());
+    EXPECT_EQ(3u, debugger->commands);
+
+    // Memory traffic shares the stream with commands in flight
+    debugger->hold_commands = 2;
+    std::promise<Result<std::string>> callback_result;
+    bridge.ExecuteCommandAsync("bp 401000", [&callback_result](Result<std::string> result) {
+        callback_result.set_value(std::move(result));
+    });
+    auto dump = bridge.ReadMemory(base + 0x10, 32);
+    ASSERT_TRUE(dump.IsSuccess()) << dump.Error();
+    EXPECT_EQ(debugger->memory[0x10], dump.Value().data[0]);
+    auto sync_result = bridge.ExecuteCommand("bpl");
+    ASSERT_TRUE(sync_result.IsSuccess()) << sync_result.Error();
+    EXPECT_EQ("ok:bpl", sync_result.Value());
+    auto callback = callback_result.get_future().get();
+    ASSERT_TRUE(callback.IsSuccess());
+    EXPECT_EQ("ok:bp 401000", callback.Value());
+    EXPECT_TRUE(bridge.Disconnect().IsSuccess());
+
+    auto disconnected = bridge.ExecuteCommandAsync("r rip");
+    EXPECT_FALSE(disconnected.get().IsSuccess());
+}
+
+namespace {
+
+// Bridge with a live dispatch thread and no debugger behind it
+std::unique_ptr<X64DbgBridge> MakeEventBridge() {
+    auto bridge = std::make_unique<X64DbgBridge>(nullptr);
+    bridge->SetConnectionMode(X64DbgBridge::ConnectionMode::TCP);
+    bridge->SetTransport(std::make_unique<FakeFramedDebugger>(0x1000, 16));
+    return bridge;
+}
+
+bool WaitForDispatched(const X64DbgBridge& bridge, uint64_t count) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (bridge.GetEventQueueStats().dispatched < count) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+DebugEvent MakeEvent(uint32_t producer, uintptr_t sequence) {
+    DebugEvent event;
+    event.type = DebugEvent::Type::BREAKPOINT_HIT;
+    event.thread_id = producer;
+    event.address = sequence;
+    return event;
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Stream events are read with no command in flight, and pending commands leave executor workers free
+ */
+TEST(X64DbgBridgeTest, ReceivesRepliesAndEventsOnItsOwnThread) {
+    auto transport = std::make_unique<FakeFramedDebugger>(0x400000, 0x1000);
+    FakeFramedDebugger* debugger = transport.get();
+    debugger->hold_commands = 3;
+
+    TaskExecutorOptions options;
+    options.worker_threads = 1;
+    auto executor = std::make_shared<TaskExecutor>(options);
+    X64DbgBridge bridge(nullptr);
+    bridge.SetTaskExecutor(executor);
+    std::atomic<int> modules{0};
+    bridge.RegisterEventHandler([&modules](const DebugEvent& event) {
+        if (event.type == DebugEvent::Type::MODULE_LOADED && event.module_name == "lib.dll") {
+            ++modules;
+        }
+    });
+    ASSERT_TRUE(bridge.SetConnectionMode(X64DbgBridge::ConnectionMode::TCP).IsSuccess());
+    ASSERT_TRUE(bridge.SetTransport(std::move(transport)).IsSuccess());
+    ASSERT_TRUE(bridge.Connect().IsSuccess());
+
+    DebugEvent loaded;
+    loaded.type = DebugEvent::Type::MODULE_LOADED;
+    loaded.module_name = "lib.dll";
+    debugger->PushEvent(loaded);
+    ASSERT_TRUE(WaitForDispatched(bridge, 1));
+    EXPECT_EQ(1, modules.load());
+
+    // Two commands are held by the debugger; the only worker stays free meanwhile
+    auto first = bridge.ExecuteCommandAsync("r rax");
+    std::promise<Result<std::string>> second;
+    bridge.ExecuteCommandAsync("r rbx", [&second](Result<std::string> result) {
+        second.set_value(std::move(result));
+    });
+    auto worker = Submit(*executor, [] { return 42; });
+    ASSERT_EQ(std::future_status::ready, worker.wait_for(std::chrono::seconds(10)));
+    EXPECT_EQ(42, worker.get());
+    EXPECT_EQ(std::future_status::timeout, first.wait_for(std::chrono::seconds(0)));
+
+    auto third = bridge.ExecuteCommandAsync("r rcx");
+    EXPECT_EQ("ok:r rax", first.get().Value());
+    EXPECT_EQ("ok:r rbx", second.get_future().get().Value());
+    EXPECT_EQ("ok:r rcx", third.get().Value());
+
+    // A request still pending when the connection goes fails instead of hanging
+    auto orphan = bridge.ExecuteCommandAsync("r rdx");
+    EXPECT_TRUE(bridge.Disconnect().IsSuccess());
+    EXPECT_FALSE(orphan.get().IsSuccess());
+}
+
+/**
+ * @brief A handler waiting on a command reply does not stall the receive thread behind a full queue
+ */
+TEST(X64DbgBridgeTest, RoutesRepliesWhileEventQueueIsFull) {
+    auto transport = std::make_unique<FakeFramedDebugger>(0x400000, 0x1000);
+    FakeFramedDebugger* debugger = transport.get();
+
+    X64DbgBridge bridge(nullptr);
+    ASSERT_TRUE(bridge.SetEventQueueOptions(2, X64DbgBridge::EventOverflowPolicy::BLOCK).IsSuccess());
+    std::vector<uintptr_t> seen;
+    Result<std::string> reply = Result<std::string>::Error("no command");
+    bridge.RegisterEventHandler([&](const DebugEvent& event) {
+        if (seen.empty()) {
+            // Every other event is already on the wire ahead of this reply
+            reply = bridge.ExecuteCommand("r rax");
+        }
+        seen.push_back(event.address);
+    });
+    ASSERT_TRUE(bridge.SetConnectionMode(X64DbgBridge::ConnectionMode::TCP).IsSuccess());
+    ASSERT_TRUE(bridge.SetTransport(std::move(transport)).IsSuccess());
+    ASSERT_TRUE(bridge.Connect().IsSuccess());
+
+    constexpr uintptr_t kEvents = 20;
+    for (uintptr_t i = 0; i < kEvents; ++i) {
+        debugger->PushEvent(MakeEvent(1, i));
+    }
+    ASSERT_TRUE(WaitForDispatched(bridge, kEvents));
+    ASSERT_TRUE(reply.IsSuccess()) << reply.Error();
+    EXPECT_EQ("ok:r rax", reply.Value());
+
+    std::vector<uintptr_t> expected(kEvents);
+    std::iota(expected.begin(), expected.end(), uintptr_t{0});
+    EXPECT_EQ(expected, seen);
+    EXPECT_EQ(0u, bridge.GetEventQueueStats().dropped);
+    EXPECT_TRUE(bridge.Disconnect().IsSuccess());
+}
+
+TEST(MpscRingTest, KeepsPerProducerOrderUnderContention) {
+    MpscRing<uint64_t> ring(64);
+    EXPECT_EQ(64u, ring.Capacity());
+    constexpr uint64_t kProducers = 4;
+    constexpr uint64_t kPerProducer = 20000;
+
+    std::vector<std::thread> producers;
+    for (uint64_t p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&ring, p]() {
+            for (uint64_t i = 0; i < kPerProducer; ++i) {
+                uint64_t value = (p << 32) | i;
+                while (!ring.TryPush(std::move(value))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<uint64_t> next(kProducers, 0);
+    std::vector<uint64_t> batch;
+    uint64_t received = 0;
+    while (received < kProducers * kPerProducer) {
+        batch.clear();
+        if (ring.PopBatch(batch, 32) == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (uint64_t value : batch) {
+            const uint64_t producer = value >> 32;
+            ASSERT_LT(producer, kProducers);
+            ASSERT_EQ(next[producer], value & 0xFFFFFFFF);
+            ++next[producer];
+        }
+        received += batch.size();
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    uint64_t leftover = 0;
+    EXPECT_FALSE(ring.TryPop(leftover));
+}
+
+/**
+ * @brief Events from several threads reach every handler in order, including handlers added mid-stream
+ */
+TEST(X64DbgBridgeTest, DispatchesPostedEventsInBatches) {
+    auto bridge = MakeEventBridge();
+    ASSERT_TRUE(bridge->SetEventQueueOptions(64, X64DbgBridge::EventOverflowPolicy::BLOCK).IsSuccess());
+
+    constexpr uint32_t kProducers = 4;
+    constexpr uintptr_t kPerProducer = 5000;
+    std::vector<uintptr_t> next(kProducers, 0);
+    bool in_order = true;
+    bridge->RegisterEventHandler([&next, &in_order](const DebugEvent& event) {
+        in_order = in_order && next[event.thread_id] == event.address;
+        next[event.thread_id] = event.address + 1;
+    });
+    ASSERT_TRUE(bridge->Connect().IsSuccess());
+
+    std::atomic<uint64_t> late_calls{0};
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&bridge, p]() {
+            for (uintptr_t i = 0; i < kPerProducer; ++i) {
+                EXPECT_TRUE(bridge->PostEvent(MakeEvent(p, i)));
+            }
+        });
+    }
+    bridge->RegisterEventHandler([&late_calls](const DebugEvent&) { ++late_calls; });
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    ASSERT_TRUE(WaitForDispatched(*bridge, kProducers * kPerProducer));
+    EXPECT_TRUE(in_order);
+    EXPECT_GT(late_calls.load(), 0u);
+    auto stats = bridge->GetEventQueueStats();
+    EXPECT_EQ(kProducers * kPerProducer, stats.posted);
+    EXPECT_EQ(0u, stats.dropped);
+    EXPECT_LE(stats.batches, stats.dispatched);
+    EXPECT_TRUE(bridge->Disconnect().IsSuccess());
+}
+
+/**
+ * @brief A full queue drops its oldest events or folds runs of identical overflow, in order
+ */
+TEST(X64DbgBridgeTest, AppliesEventOverflowPolicy) {
+    // Nothing dispatches until Connect(), so the queue fills up deterministically
+    auto dropping = MakeEventBridge();
+    ASSERT_TRUE(dropping->SetEventQueueOptions(4, X64DbgBridge::EventOverflowPolicy::DROP_OLDEST).IsSuccess());
+    std::vector<uintptr_t> delivered;
+    dropping->RegisterEventHandler([&delivered](const DebugEvent& event) { delivered.push_back(event.address); });
+    for (uintptr_t i = 0; i < 10; ++i) {
+        EXPECT_TRUE(dropping->PostEvent(MakeEvent(0, i)));
+    }
+    EXPECT_EQ(6u, dropping->GetEventQueueStats().dropped);
+    ASSERT_TRUE(dropping->Connect().IsSuccess());
+    ASSERT_TRUE(WaitForDispatched(*dropping, 4));
+    EXPECT_EQ((std::vector<uintptr_t>{6, 7, 8, 9}), delivered);
+    EXPECT_TRUE(dropping->Disconnect().IsSuccess());
+
+    auto coalescing = MakeEventBridge();
+    ASSERT_TRUE(coalescing->SetEventQueueOptions(4, X64DbgBridge::EventOverflowPolicy::COALESCE).IsSuccess());
+    std::vector<DebugEvent> events;
+    coalescing->RegisterEventHandler([&events](const DebugEvent& event) { events.push_back(event); });
+    // Overflow: a run of five at 0x10, one at 0x20, two at 0x10 again, then one on another thread
+    const std::vector<std::pair<uint32_t, uintptr_t>> overflow = {
+        {0, 0x10}, {0, 0x10}, {0, 0x10}, {0, 0x10}, {0, 0x10}, {0, 0x20}, {0, 0x10}, {0, 0x10}, {1, 0x10}};
+    for (uintptr_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(coalescing->PostEvent(MakeEvent(0, i)));
+    }
+    for (const auto& event : overflow) {
+        EXPECT_TRUE(coalescing->PostEvent(MakeEvent(event.first, event.second)));
+    }
+    ASSERT_TRUE(coalescing->Connect().IsSuccess());
+    ASSERT_TRUE(WaitForDispatched(*coalescing, 8));
+    ASSERT_EQ(8u, events.size());
+    EXPECT_EQ(3u, events[3].address);
+    EXPECT_EQ(0x10u, events[4].address);
+    EXPECT_EQ("5", events[4].metadata["coalesced_count"]);
+    EXPECT_EQ(0x20u, events[5].address);  // Not folded into either run around it
+    EXPECT_EQ(0u, events[5].metadata.count("coalesced_count"));
+    EXPECT_EQ("2", events[6].metadata["coalesced_count"]);
+    EXPECT_EQ(1u, events[7].thread_id);
+    EXPECT_EQ(0u, events[7].metadata.count("coalesced_count"));
+    EXPECT_EQ(5u, coalescing->GetEventQueueStats().coalesced);
+    EXPECT_TRUE(coalescing->Disconnect().IsSuccess());
+
+    // Distinct overflow is capped at the queue capacity, dropping the oldest staged events
+    auto capped = MakeEventBridge();
+    ASSERT_TRUE(capped->SetEventQueueOptions(4, X64DbgBridge::EventOverflowPolicy::COALESCE).IsSuccess());
+    std::vector<uintptr_t> capped_delivered;
+    capped->RegisterEventHandler([&capped_delivered](const DebugEvent& event) {
+        capped_delivered.push_back(event.address);
+    });
+    for (uintptr_t i = 0; i < 10; ++i) {
+        EXPECT_TRUE(capped->PostEvent(MakeEvent(0, i)));
+    }
+    EXPECT_EQ(2u, capped->GetEventQueueStats().dropped);
+    ASSERT_TRUE(capped->Connect().IsSuccess());
+    ASSERT_TRUE(WaitForDispatched(*capped, 8));
+    EXPECT_EQ((std::vector<uintptr_t>{0, 1, 2, 3, 6, 7, 8, 9}), capped_delivered);
+    EXPECT_TRUE(capped->Disconnect().IsSuccess());
+
+    EXPECT_FALSE(X64DbgBridge::ParseEventOverflowPolicy("newest").IsSuccess());
+}
+
+TEST(CompactDebugEventTest, RoundTripsThroughInternedStrings) {
+    EventStringTable strings;
+    EXPECT_EQ(0u, strings.Intern(""));
+    const uint32_t kernel32 = strings.Intern("kernel32.dll");
+    EXPECT_EQ(kernel32, strings.Intern(std::string("kernel32.dll")));
+    EXPECT_EQ("kernel32.dll", strings.Lookup(kernel32));
+
+    DebugEvent event;
+    event.type = DebugEvent::Type::EXCEPTION;
+    event.address = 0x7FF812340000;
+    event.process_id = 42;
+    event.thread_id = 7;
+    event.module_name = "kernel32.dll";
+    event.description = "Access violation";
+    event.timestamp = std::chrono::system_clock::now();
+    event.metadata["code"] = "0xC0000005";
+
+    CompactDebugEvent compact;
+    ASSERT_TRUE(CompactEvent(event, strings, compact));
+    EXPECT_EQ(kernel32, compact.module_id);
+    EXPECT_TRUE(compact.AddMetadata(strings.Intern("first_chance"), 1));
+
+    const DebugEvent expanded = ExpandEvent(compact, strings);
+    EXPECT_EQ(event.address, expanded.address);
+    EXPECT_EQ(event.module_name, expanded.module_name);
+    EXPECT_EQ(event.description, expanded.description);
+    EXPECT_EQ("0xC0000005", expanded.metadata.at("code"));
+    EXPECT_EQ("0x1", expanded.metadata.at("first_chance"));
+    EXPECT_LT(std::chrono::abs(expanded.timestamp - event.timestamp), std::chrono::milliseconds(100));
+
+    CompactDebugEvent repeat = compact;
+    repeat.timestamp_ns += 1000;
+    EXPECT_TRUE(IsRepeatOf(repeat, compact));
+    repeat.thread_id = 8;
+    EXPECT_FALSE(IsRepeatOf(repeat, compact));
+}
+
+/**
+ * @brief Repeats on one thread fold into counted records; other threads and rich events pass through
+ */
+TEST(X64DbgBridgeTest, CoalescesRepeatedEvents) {
+    auto bridge = MakeEventBridge();
+    bridge->SetEventRepeatCoalescing(true);
+    std::vector<CompactDebugEvent> records;
+    std::vector<DebugEvent> rich;
+    bridge->RegisterCompactEventHandler([&records](const CompactDebugEvent& event) { records.push_back(event); });
+    bridge->RegisterEventHandler([&rich](const DebugEvent& event) { rich.push_back(event); });
+
+    // A tracing breakpoint in a loop on thread 1, interleaved with thread 2
+    CompactDebugEvent hit;
+    hit.type = DebugEvent::Type::BREAKPOINT_HIT;
+    hit.thread_id = 1;
+    hit.address = 0x401000;
+    hit.module_id = bridge->GetEventStrings().Intern("target.exe");
+    for (int i = 0; i < 100; ++i) {
+        hit.timestamp_ns = CompactDebugEvent::Now();
+        EXPECT_TRUE(bridge->PostEvent(hit));
+        if (i % 10 == 0) {
+            EXPECT_TRUE(bridge->PostEvent(MakeEvent(2, static_cast<uintptr_t>(i))));
+        }
+    }
+    DebugEvent detailed = MakeEvent(1, 0x401000);
+    for (int i = 0; i < 6; ++i) {
+        detailed.metadata["r" + std::to_string(i)] = std::to_string(i);
+    }
+    EXPECT_TRUE(bridge->PostEvent(detailed));
+
+    ASSERT_TRUE(bridge->Connect().IsSuccess());
+    ASSERT_TRUE(WaitForDispatched(*bridge, 12));
+    ASSERT_EQ(12u, records.size());
+    EXPECT_EQ(100u, records[0].repeat_count);
+    EXPECT_EQ(2u, records[1].thread_id);
+    EXPECT_EQ(99u, bridge->GetEventQueueStats().repeats_merged);
+
+    ASSERT_EQ(12u, rich.size());
+    EXPECT_EQ("target.exe", rich[0].module_name);
+    EXPECT_EQ("100", rich[0].metadata["coalesced_count"]);
+    EXPECT_EQ(6u, rich[11].metadata.size());  // Passed through whole, not truncated to the inline slots
+    EXPECT_TRUE(bridge->Disconnect().IsSuccess());
+}
+
+/**
+ * @brief Module events maintain the symbol index; disassembly is reused until its code bytes change
+ */
+TEST(X64DbgBridgeTest, IndexesModuleSymbolsAndCachesDisassembly) {
+    const uintptr_t base = 0x400000;
+    auto bridge = std::make_unique<X64DbgBridge>(nullptr);
+    auto transport = std::make_unique<FakeFramedDebugger>(base, 0x4000);
+    FakeFramedDebugger* debugger = transport.get();
+    ASSERT_TRUE(bridge->SetConnectionMode(X64DbgBridge::ConnectionMode::TCP).IsSuccess());
+    ASSERT_TRUE(bridge->SetTransport(std::move(transport)).IsSuccess());
+
+    std::atomic<int> loads{0};
+    bridge->SetSymbolSource([&loads](const std::string& module, uintptr_t module_base) -> Result<ModuleSymbols> {
+        ++loads;
+        ModuleSymbols symbols;
+        symbols.size = 0x4000;
+        symbols.symbols.push_back({module_base + 0x2000, 0, "Helper"});
+        symbols.symbols.push_back({module_base + 0x1000, 0x100, "Start"});
+        EXPECT_EQ("target.exe", module);
+        return Result<ModuleSymbols>::Success(std::move(symbols));
+    });
+    ASSERT_TRUE(bridge->Connect().IsSuccess());
+
+    DebugEvent loaded;
+    loaded.type = DebugEvent::Type::MODULE_LOADED;
+    loaded.module_name = "target.exe";
+    loaded.address = base;
+    ASSERT_TRUE(bridge->PostEvent(loaded));
+    ASSERT_TRUE(WaitForDispatched(*bridge, 1));
+    EXPECT_EQ(1, loads.load());
+
+    EXPECT_EQ("target.exe!Start+0x10", bridge->GetSymbolAt(base + 0x1010).Value());
+    EXPECT_EQ("target.exe+0x1200", bridge->GetSymbolAt(base + 0x1200).Value());  // Past Start's extent
+    EXPECT_EQ("target.exe!Helper+0x1000", bridge->GetSymbolAt(base + 0x3000).Value());
+    EXPECT_EQ("symbol_at_404000", bridge->GetSymbolAt(base + 0x4000).Value());
+    EXPECT_EQ(base + 0x2000, bridge->ResolveSymbol("TARGET.EXE!Helper").Value());
+    EXPECT_EQ(base + 0x1000, bridge->ResolveSymbol("Start").Value());
+    EXPECT_EQ(base, bridge->ResolveSymbol("target.exe").Value());
+    EXPECT_FALSE(bridge->ResolveSymbol("Missing").IsSuccess());
+
+    auto first = bridge->GetDisassembly(base + 0x1000);
+    ASSERT_TRUE(first.IsSuccess()) << first.Error();
+    EXPECT_EQ("ok:disasm 0x401000", first.Value());
+    EXPECT_EQ(first.Value(), bridge->GetDisassembly(base + 0x1000).Value());
+    EXPECT_EQ(1u, debugger->commands);
+    EXPECT_EQ(1u, bridge->GetDisassemblyCacheStats().hits);
+
+    // Patched code hashes differently and is disassembled again
+    ASSERT_TRUE(bridge->WriteMemory(base + 0x1004, {0x90, 0x90}).IsSuccess());
+    EXPECT_TRUE(bridge->GetDisassembly(base + 0x1000).IsSuccess());
+    EXPECT_EQ(2u, debugger->commands);
+
+    // A batch checks every listing with one read and sends only the misses
+    auto batch = bridge->GetDisassemblyBatch({base + 0x1000, base + 0x1100, base + 0x2000});
+    ASSERT_EQ(3u, batch.size());
+    EXPECT_EQ(first.Value(), batch[0].Value());
+    EXPECT_EQ("ok:disasm 0x401100", batch[1].Value());
+    EXPECT_EQ("ok:disasm 0x402000", batch[2].Value());
+    EXPECT_EQ(4u, debugger->commands);
+    EXPECT_EQ(batch[2].Value(), bridge->GetDisassembly(base + 0x2000).Value());
+    EXPECT_EQ(4u, debugger->commands);
+
+    DebugEvent unloaded = loaded;
+    unloaded.type = DebugEvent::Type::MODULE_UNLOADED;
+    ASSERT_TRUE(bridge->PostEvent(unloaded));
+    ASSERT_TRUE(WaitForDispatched(*bridge, 2));
+    EXPECT_EQ("symbol_at_401010", bridge->GetSymbolAt(base + 0x1010).Value());
+    EXPECT_FALSE(bridge->ResolveSymbol("Start").IsSuccess());
+    EXPECT_TRUE(bridge->Disconnect().IsSuccess());
+}
+
+/**
+ * @brief Requests, in-place replies and events cross a shared section between engine and debugger
+ */
+TEST(X64DbgBridgeTest, TalksToDebuggerOverSharedMemory) {
+    const uintptr_t base = 0x20000000;
+    // Rings much smaller than the dump, so replies wrap and wait for room
+    auto region = SharedMemoryRegion::CreateLocal(64 * 1024, 4096);
+    auto engine = std::make_unique<SharedMemoryTransport>(region, SharedMemoryTransport::Side::ENGINE);
+    SharedMemoryTransport debugger_end(region, SharedMemoryTransport::Side::DEBUGGER);
+    FakeFramedDebugger debugger(base, 1024 * 1024);
+
+    // Relay between the rings and the fake debugger, as the plugin would
+    std::thread requests([&] {
+        std::vector<uint8_t> buffer(4096);
+        for (;;) {
+            auto received = debugger_end.Receive(buffer.data(), buffer.size());
+            if (!received.IsSuccess() || received.Value() == 0) {
+                break;
+            }
+            debugger.Send(buffer.data(), received.Value());
+        }
+        debugger.Close();
+    });
+    std::thread replies([&] {
+        std::vector<uint8_t> buffer(kMaxChunkSize);
+        for (;;) {
+            auto produced = debugger.Receive(buffer.data(), buffer.size());
+            if (!produced.IsSuccess() || produced.Value() == 0) {
+                break;
+            }
+            const uint8_t* source = buffer.data();
+            auto sent = debugger_end.SendInPlace(produced.Value(), [&source](uint8_t* span, size_t count) {
+                std::memcpy(span, source, count);
+                source += count;
+            });
+            if (!sent.IsSuccess()) {
+                break;
+            }
+        }
+    });
+
+    X64DbgBridge bridge(nullptr);
+    std::mutex events_mutex;
+    std::vector<DebugEvent> events;
+    bridge.RegisterEventHandler([&](const DebugEvent& event) {
+        const std::lock_guard<std::mutex> lock(events_mutex);
+        events.push_back(event);
+    });
+    ASSERT_TRUE(bridge.SetConnectionMode(X64DbgBridge::ConnectionMode::SHARED_MEMORY).IsSuccess());
+    ASSERT_TRUE(bridge.SetTransport(std::move(engine)).IsSuccess());
+    ASSERT_TRUE(bridge.Connect().IsSuccess());
+
+    auto dump = bridge.ReadMemory(base, debugger.memory.size());
+    ASSERT_TRUE(dump.IsSuccess()) << dump.Error();
+    EXPECT_TRUE(dump.Value().data == debugger.memory);
+    auto command = bridge.ExecuteCommand("r rax");
+    ASSERT_TRUE(command.IsSuccess()) << command.Error();
+    EXPECT_EQ("ok:r rax", command.Value());
+
+    DebugEvent loaded;
+    loaded.type = DebugEvent::Type::MODULE_LOADED;
+    loaded.module_name = "lib.dll";
+    loaded.thread_id = 7;
+    loaded.metadata["path"] = "C:\\lib.dll";
+    std::vector<uint8_t> payload;
+    EncodeEventPayload(loaded, payload);
+    FrameHeader header;
+    header.type = FrameType::kEvent;
+    header.flags = FrameHeader::kFlagFinal;
+    header.payload_size = static_cast<uint32_t>(payload.size());
+    header.address = 0x7FF800000000;
+    std::vector<uint8_t> frame;
+    EncodeFrame(header, payload.data(), frame);
+    ASSERT_TRUE(debugger_end.SendEvent(frame.data(), frame.size()).IsSuccess());
+    ASSERT_TRUE(WaitForDispatched(bridge, 1));
+    {
+        const std::lock_guard<std::mutex> lock(events_mutex);
+        ASSERT_EQ(1u, events.size());
+        EXPECT_EQ(DebugEvent::Type::MODULE_LOADED, events[0].type);
+        EXPECT_EQ(0x7FF800000000u, events[0].address);
+        EXPECT_EQ("lib.dll", events[0].module_name);
+        EXPECT_EQ(7u, events[0].thread_id);
+        EXPECT_EQ("C:\\lib.dll", events[0].metadata["path"]);
+    }
+
+    // Closing either end tears the session down for the relay threads too
+    EXPECT_TRUE(bridge.Disconnect().IsSuccess());
+    requests.join();
+    replies.join();
+}
+
+#ifndef _WIN32
+/**
+ * @brief Reads, commands and unprompted events travel over a loopback TCP connection
+ */
+TEST(X64DbgBridgeTest, TalksToDebuggerOverTcp) {
+    const int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(listener, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    ASSERT_EQ(0, ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+    ASSERT_EQ(0, ::listen(listener, 1));
+    ASSERT_EQ(0, ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length));
+    const int port = ntohs(address.sin_port);
+
+    X64DbgBridge bridge(nullptr);
+    std::atomic<int> modules{0};
+    bridge.RegisterEventHandler([&modules](const DebugEvent& event) {
+        if (event.type == DebugEvent::Type::MODULE_LOADED && event.module_name == "lib.dll") {
+            ++modules;
+        }
+    });
+    ASSERT_TRUE(bridge.SetConnectionMode(X64DbgBridge::ConnectionMode::TCP).IsSuccess());
+    EXPECT_FALSE(bridge.SetTcpEndpoint("127.0.0.1", 70000).IsSuccess());
+    ASSERT_TRUE(bridge.SetTcpEndpoint("127.0.0.1", port).IsSuccess());
+    ASSERT_TRUE(bridge.Connect().IsSuccess());
+
+    // The handshake completed in the backlog; relay the accepted stream to the fake debugger
+    const int peer = ::accept(listener, nullptr, nullptr);
+    ::close(listener);
+    ASSERT_GE(peer, 0);
+    SocketTransport debugger_end(peer);
+    const uintptr_t base = 0x10000000;
+    FakeFramedDebugger debugger(base, 256 * 1024);
+    std::thread requests([&] {
+        std::vector<uint8_t> buffer(4096);
+        for (;;) {
+            auto received = debugger_end.Receive(buffer.data(), buffer.size());
+            if (!received.IsSuccess() || received.Value() == 0) {
+                break;
+            }
+            debugger.Send(buffer.data(), received.Value());
+        }
+        debugger.Close();
+    });
+    std::thread replies([&] {
+        std::vector<uint8_t> buffer(kMaxChunkSize);
+        for (;;) {
+            auto produced = debugger.Receive(buffer.data(), buffer.size());
+            if (!produced.IsSuccess() || produced.Value() == 0 ||
+                !debugger_end.Send(buffer.data(), produced.Value()).IsSuccess()) {
+                break;
+            }
+        }
+    });
+
+    auto dump = bridge.ReadMemory(base, debugger.memory.size());
+    ASSERT_TRUE(dump.IsSuccess()) << dump.Error();
+    EXPECT_TRUE(dump.Value().data == debugger.memory);
+    auto command = bridge.ExecuteCommand("r rax");
+    ASSERT_TRUE(command.IsSuccess()) << command.Error();
+    EXPECT_EQ("ok:r rax", command.Value());
+
+    DebugEvent loaded;
+    loaded.type = DebugEvent::Type::MODULE_LOADED;
+    loaded.module_name = "lib.dll";
+    debugger.PushEvent(loaded);
+    ASSERT_TRUE(WaitForDispatched(bridge, 1));
+    EXPECT_EQ(1, modules.load());
+
+    // Shutting the stream down ends the relay, and nothing is listening any more
+    EXPECT_TRUE(bridge.Disconnect().IsSuccess());
+    requests.join();
+    replies.join();
+    EXPECT_FALSE(bridge.Connect().IsSuccess());
+}
+#endif
+
+/**
+ * @brief A named section created by the debugger side is found and opened by the engine
+ */
+TEST(SharedMemoryTransportTest, OpensSectionByName) {
+    const std::string name = "mcp_test_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    {
+        auto created = SharedMemoryRegion::Create(name, 4096, 4096);
+        ASSERT_TRUE(created.IsSuccess()) << created.Error();
+        EXPECT_TRUE(SharedMemoryRegion::Exists(name));
+        EXPECT_FALSE(SharedMemoryRegion::Create(name, 4096, 4096).IsSuccess());
+
+        auto engine = SharedMemoryTransport::Open(name);
+        ASSERT_TRUE(engine.IsSuccess()) << engine.Error();
+        SharedMemoryTransport debugger_end(created.Value(), SharedMemoryTransport::Side::DEBUGGER);
+
+        const std::string request = "hello";
+        ASSERT_TRUE(engine.Value()->Send(reinterpret_cast<const uint8_t*>(request.data()), request.size()).IsSuccess());
+        uint8_t buffer[16];
+        auto received = debugger_end.Receive(buffer, sizeof(buffer));
+        ASSERT_TRUE(received.IsSuccess());
+        EXPECT_EQ(request, std::string(reinterpret_cast<const char*>(buffer), received.Value()));
+
+        engine.Value()->Close();
+        EXPECT_EQ(0u, debugger_end.Receive(buffer, sizeof(buffer)).Value());
+        EXPECT_FALSE(debugger_end.Send(buffer, 1).IsSuccess());
+    }
+#ifndef _WIN32
+    EXPECT_FALSE(SharedMemoryRegion::Exists(name));  // The creator removes the name
+#endif
+}
+
+TEST(X64DbgBridgeTest, ReportsLatencyAndTrafficStats) {
+    LatencyHistogram histogram;
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        histogram.Record(i * 1000);
+    }
+    const LatencySummary summary = histogram.Summarize();
+    EXPECT_EQ(1000u, summary.count);
+    EXPECT_EQ(1000000u, summary.max_ns);
+    // Buckets are an eighth of an octave wide
+    EXPECT_GE(summary.p50_ns, 500000u);
+    EXPECT_LE(summary.p50_ns, 500000u * 9 / 8);
+    EXPECT_GE(summary.p99_ns, 990000u);
+    EXPECT_LE(summary.p99_ns, summary.max_ns);
+
+    const uintptr_t base = 0x400000;
+    X64DbgBridge bridge(nullptr);
+    ASSERT_TRUE(bridge.SetConnectionMode(X64DbgBridge::ConnectionMode::TCP).IsSuccess());
+    ASSERT_TRUE(bridge.SetTransport(std::make_unique<FakeFramedDebugger>(base, 0x4000)).IsSuccess());
+    ASSERT_TRUE(bridge.Connect().IsSuccess());
+
+    ASSERT_TRUE(bridge.ReadMemory(base + 0x100, 64).IsSuccess());
+    ASSERT_TRUE(bridge.ReadMemory(base + 0x200, 64).IsSuccess());  // Same page, from the cache
+    ASSERT_TRUE(bridge.ExecuteCommand("r rax").IsSuccess());
+    ASSERT_TRUE(bridge.WriteMemory(base + 0x2000, std::vector<uint8_t>(16, 0x90)).IsSuccess());
+
+    auto stats = bridge.GetStats();
+    auto count = [&stats](X64DbgBridge::BridgeOperation operation) {
+        return stats.latency[static_cast<size_t>(operation)].count;
+    };
+    EXPECT_EQ(2u, count(X64DbgBridge::BridgeOperation::READ_MEMORY));
+    EXPECT_EQ(1u, count(X64DbgBridge::BridgeOperation::FETCH_MEMORY));
+    EXPECT_EQ(1u, count(X64DbgBridge::BridgeOperation::COMMAND));
+    EXPECT_EQ(1u, count(X64DbgBridge::BridgeOperation::WRITE_MEMORY));
+    EXPECT_EQ(128u, stats.bytes_read);
+    EXPECT_EQ(16u, stats.bytes_written);
+    EXPECT_GT(stats.bytes_sent, 0u);
+    EXPECT_GT(stats.bytes_received, PageCache::kPageSize);
+    EXPECT_EQ(1u, stats.memory_cache.hits);
+
+    const std::string json = X64DbgBridge::FormatStats(stats, X64DbgBridge::StatsFormat::JSON);
+    EXPECT_NE(std::string::npos, json.find("\"read_memory\":{\"count\":2"));
+    EXPECT_NE(std::string::npos, json.find("\"written\":16"));
+    EXPECT_NE(std::string::npos, json.find("\"hit_rate\":0.5000"));
+    EXPECT_EQ(std::string::npos, json.find('\n'));
+    const std::string text = X64DbgBridge::FormatStats(stats, X64DbgBridge::StatsFormat::TEXT);
+    EXPECT_NE(std::string::npos, text.find("read_memory"));
+    EXPECT_EQ(std::string::npos, text.find("hex_decode"));  // Idle operations are left out
+
+    std::mutex exported_mutex;
+    std::condition_variable exported_condition;
+    std::vector<std::string> exported;
+    bridge.SetStatsExport(std::chrono::milliseconds(5), [&](const std::string& line) {
+        const std::lock_guard<std::mutex> lock(exported_mutex);
+        exported.push_back(line);
+        exported_condition.notify_all();
+    });
+    {
+        std::unique_lock<std::mutex> lock(exported_mutex);
+        ASSERT_TRUE(exported_condition.wait_for(lock, std::chrono::seconds(5), [&] { return exported.size() >= 2; }));
+        EXPECT_EQ('{', exported.front().front());
+    }
+    bridge.SetStatsExport(std::chrono::milliseconds(0), nullptr);
+
+    bridge.ResetStats();
+    stats = bridge.GetStats();
+    EXPECT_EQ(0u, count(X64DbgBridge::BridgeOperation::READ_MEMORY));
+    EXPECT_EQ(0u, stats.bytes_sent);
+    EXPECT_TRUE(bridge.Disconnect().IsSuccess());
+}
+
+/**
+ * @brief Cached pages survive thread events and are dropped when the target stops again
+ */
+TEST(X64DbgBridgeTest, InvalidatesMemoryCacheOnStoppingEvents) {
+    const uintptr_t base = 0x400000;
+    X64DbgBridge bridge(nullptr);
+    ASSERT_TRUE(bridge.SetConnectionMode(X64DbgBridge::ConnectionMode::TCP).IsSuccess());
+    ASSERT_TRUE(bridge.SetTransport(std::make_unique<FakeFramedDebugger>(base, 0x4000)).IsSuccess());
+    ASSERT_TRUE(bridge.Connect().IsSuccess());
+    ASSERT_TRUE(bridge.ReadMemory(base + 0x100, 64).IsSuccess());
+
+    DebugEvent thread_event = MakeEvent(7, 0);
+    thread_event.type = DebugEvent::Type::THREAD_CREATED;
+    ASSERT_TRUE(bridge.PostEvent(thread_event));
+    ASSERT_TRUE(WaitForDispatched(bridge, 1));
+    ASSERT_TRUE(bridge.ReadMemory(base + 0x100, 64).IsSuccess());
+    EXPECT_EQ(1u, bridge.GetMemoryCacheStats().hits);
+    EXPECT_EQ(0u, bridge.GetMemoryCacheStats().invalidations);
+
+    ASSERT_TRUE(bridge.PostEvent(MakeEvent(7, base + 0x100)));
+    ASSERT_TRUE(WaitForDispatched(bridge, 2));
+    ASSERT_TRUE(bridge.ReadMemory(base + 0x100, 64).IsSuccess());
+    EXPECT_EQ(1u, bridge.GetMemoryCacheStats().hits);
+    EXPECT_EQ(2u, bridge.GetMemoryCacheStats().misses);
+    EXPECT_TRUE(bridge.Disconnect().IsSuccess());
+}
+
+TEST(HexCodecTest, RoundTripsAndRejectsMalformedInput) {
+    // Sizes on both sides of the 16-byte block boundaries
+    for (size_t size : {0u, 1u, 15u, 16u, 17u, 31u, 32u, 33u, 100u}) {
+        std::vector<uint8_t> bytes(size);
+        for (size_t i = 0; i < size; ++i) {
+            bytes[i] = static_cast<uint8_t>(i * 37 + 11);
+        }
+
+        std::string reference;
+        char pair[3];
+        for (uint8_t byte : bytes) {
+            std::snprintf(pair, sizeof(pair), "%02X", byte);
+            reference += pair;
+        }
+        EXPECT_EQ(HexEncode(bytes, {true, '\0'}), reference) << size;
+
+        for (const HexFormat& format : {HexFormat{}, HexFormat{true, '\0'}, HexFormat{false, ' '}}) {
+            auto decoded = HexDecode(HexEncode(bytes, format));
+            ASSERT_TRUE(decoded.IsSuccess()) << size;
+            EXPECT_EQ(decoded.Value(), bytes) << size;
+        }
+    }
+
+    EXPECT_EQ(HexEncode(std::vector<uint8_t>{0x48, 0x89, 0xE5}, {false, ' '}), "48 89 e5");
+    auto spaced = HexDecode("48 89 E5\n\t90");
+    ASSERT_TRUE(spaced.IsSuccess());
+    EXPECT_EQ(spaced.Value(), (std::vector<uint8_t>{0x48, 0x89, 0xE5, 0x90}));
+
+    EXPECT_FALSE(HexDecode("489").IsSuccess());
+    EXPECT_FALSE(HexDecode("4 8").IsSuccess());
+    // A bad character late in an otherwise vectorizable run
+    std::string long_text(64, 'a');
+    long_text[40] = 'g';
+    auto invalid = HexDecode(long_text);
+    ASSERT_FALSE(invalid.IsSuccess());
+    EXPECT_NE(invalid.Error().find("offset 40"), std::string::npos);
+
+    uint8_t small[2];
+    EXPECT_FALSE(HexDecode("010203", small, sizeof(small)).IsSuccess());
+    auto fits = HexDecode("0102", small, sizeof(small));
+    ASSERT_TRUE(fits.IsSuccess());
+    EXPECT_EQ(fits.Value(), 2u);
+}